@@ -1,7 +1,15 @@
 #include "EString.h"
 
+#include <system_error>
+
 #ifdef _WIN32
 #include <Windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 static void decode_data_from_console(std::string const& buffer, EString& out_str);
@@ -66,6 +74,18 @@ size_type AnsiEncodingTraits::to_utf32(const encoded_char_type* encoded_string,
   throw encoding_failed(AnsiEncodingTraits::encoding_name, "Ansi not implimented.");
 }
 
+size_type AnsiEncodingTraits::utf32_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) {
+  throw encoding_failed(AnsiEncodingTraits::encoding_name, "Ansi not implimented.");
+}
+
+size_type AnsiEncodingTraits::encoded_length(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars) {
+  throw encoding_failed(AnsiEncodingTraits::encoding_name, "Ansi not implimented.");
+}
+
+size_type AnsiEncodingTraits::complete_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) {
+  throw encoding_failed(AnsiEncodingTraits::encoding_name, "Ansi not implimented.");
+}
+
 size_type AnsiEncodingTraits::char_length(const encoded_char_type* encoded_char) {
   throw encoding_failed(AnsiEncodingTraits::encoding_name, "Ansi not implimented.");
 }
@@ -75,3 +95,140 @@ size_type AnsiEncodingTraits::str_length(const encoded_char_type* string) {
 }
 
 #endif
+
+// Memory-mapped files
+#ifdef _WIN32
+
+EMappedFile::EMappedFile(const char* path) {
+  HANDLE file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if (file_handle == INVALID_HANDLE_VALUE)
+    throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Failed to open file");
+
+  LARGE_INTEGER file_size;
+
+  if (!GetFileSizeEx(file_handle, &file_size)) {
+    DWORD error = GetLastError();
+    CloseHandle(file_handle);
+    throw std::system_error(static_cast<int>(error), std::system_category(), "Failed to get file size");
+  }
+
+  m_file_handle = file_handle;
+  m_size = static_cast<size_type>(file_size.QuadPart);
+  m_is_open = true;
+
+  // Empty files can't be mapped.
+  if (m_size == 0)
+    return;
+
+  m_mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (m_mapping_handle == nullptr) {
+    DWORD error = GetLastError();
+    close();
+    throw std::system_error(static_cast<int>(error), std::system_category(), "Failed to map file");
+  }
+
+  m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+
+  if (m_data == nullptr) {
+    DWORD error = GetLastError();
+    close();
+    throw std::system_error(static_cast<int>(error), std::system_category(), "Failed to map file");
+  }
+}
+
+void EMappedFile::close() noexcept {
+  if (m_data)
+    UnmapViewOfFile(m_data);
+
+  if (m_mapping_handle)
+    CloseHandle(m_mapping_handle);
+
+  if (m_file_handle)
+    CloseHandle(m_file_handle);
+
+  m_data = nullptr;
+  m_mapping_handle = nullptr;
+  m_file_handle = nullptr;
+  m_size = 0;
+  m_is_open = false;
+}
+
+// File is opened with 'FILE_FLAG_SEQUENTIAL_SCAN' already.
+void EMappedFile::advise_sequential() const noexcept {}
+
+void EMappedFile::advise_will_need(size_type offset, size_type size) const noexcept {
+  (void)offset;
+  (void)size;
+}
+
+#else
+
+EMappedFile::EMappedFile(const char* path) {
+  int file_descriptor = open(path, O_RDONLY);
+
+  if (file_descriptor < 0)
+    throw std::system_error(errno, std::generic_category(), "Failed to open file");
+
+  struct stat file_status;
+
+  if (fstat(file_descriptor, &file_status) != 0) {
+    int error = errno;
+    ::close(file_descriptor);
+    throw std::system_error(error, std::generic_category(), "Failed to get file size");
+  }
+
+  m_size = static_cast<size_type>(file_status.st_size);
+  m_is_open = true;
+
+  // Empty files can't be mapped. Mapping stays valid after descriptor is closed.
+  if (m_size != 0) {
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+    if (data == MAP_FAILED) {
+      int error = errno;
+      ::close(file_descriptor);
+      m_size = 0;
+      m_is_open = false;
+      throw std::system_error(error, std::generic_category(), "Failed to map file");
+    }
+
+    m_data = static_cast<const unsigned char*>(data);
+  }
+
+  ::close(file_descriptor);
+}
+
+void EMappedFile::close() noexcept {
+  if (m_data)
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+
+  m_data = nullptr;
+  m_size = 0;
+  m_is_open = false;
+}
+
+void EMappedFile::advise_sequential() const noexcept {
+  if (m_data)
+    madvise(const_cast<unsigned char*>(m_data), m_size, MADV_SEQUENTIAL);
+}
+
+void EMappedFile::advise_will_need(size_type offset, size_type size) const noexcept {
+  if (!m_data || offset >= m_size)
+    return;
+
+  if (size > m_size - offset)
+    size = m_size - offset;
+
+  // Range must start at page boundary.
+  size_type page_size = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+  size_type page_offset = offset - offset % page_size;
+
+  madvise(const_cast<unsigned char*>(m_data) + page_offset, size + (offset - page_offset), MADV_WILLNEED);
+}
+
+#endif
+
+// Unicode tables, generated from Unicode Character Database.
+#include "EStringUnicodeData.inl"
@@ -5,56 +5,115 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <atomic>
+#include <compare>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <istream>
+#include <type_traits>
 #include <vector>
 
 #include "EStringEncodings.h"
-
-class EString {
+#include "EStringFile.h"
+#include "EStringFormat.h"
+#include "EStringHash.h"
+#include "EStringUnicode.h"
+#include "EStringView.h"
+
+// String of utf32 characters, which memory is allocated by 'Allocator'.
+// Use 'EString' alias for strings allocated with 'new', or 'PmrEString' for 'std::pmr' memory resources.
+template <typename Allocator = std::allocator<char32_t>>
+class BasicEString {
 public:
   using size_type = size_t;
+  using allocator_type = Allocator;
+
+  static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, char32_t>, "Allocator must allocate char32_t.");
+
+  // Number of characters (including null-terminating char) stored inside the object itself.
+  // Strings that fit there don't allocate heap memory at all.
+  static constexpr size_type inline_capacity = 8;
+
+  // Returned by search functions when nothing is found.
+  static constexpr size_type npos = EStringView::npos;
+
+private:
+  using allocator_traits = std::allocator_traits<Allocator>;
 
 public:
-  constexpr EString() = default;
+  constexpr BasicEString() noexcept(noexcept(Allocator())) = default;
 
-  constexpr EString(const char32_t* utf32_string) : EString() {
+  constexpr explicit BasicEString(Allocator const& allocator) noexcept : m_allocator(allocator) {}
+
+  constexpr BasicEString(const char32_t* utf32_string, Allocator const& allocator = Allocator()) : BasicEString(allocator) {
     size_type string_size = Utf32EncodingTraits::str_length(utf32_string);
 
     _construct_with_string_and_size(utf32_string, string_size);
   }
 
-  constexpr EString(const char32_t* utf32_string, size_type string_size_in_chars) : EString() {
+  constexpr BasicEString(const char32_t* utf32_string, size_type string_size_in_chars, Allocator const& allocator = Allocator()) : BasicEString(allocator) {
     _construct_with_string_and_size(utf32_string, string_size_in_chars);
   }
 
-  template <typename CharType>
-  constexpr EString(const CharType* encoded_string, size_type encoded_string_length_in_chars) : EString() {
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  constexpr BasicEString(const CharType* encoded_string, size_type encoded_string_length_in_chars, Allocator const& allocator = Allocator()) : BasicEString(allocator) {
     decode(encoded_string, encoded_string_length_in_chars);
   }
 
-  constexpr EString(size_type count, char32_t character = 0) : EString() {
+  constexpr BasicEString(size_type count, char32_t character = 0, Allocator const& allocator = Allocator()) : BasicEString(allocator) {
     _need_allocated(count);
 
     for (size_type i = 0; i < count; ++i)
       m_buffer[i] = character;
   }
 
-  template <typename CharType>
-  constexpr EString(const CharType* encoded_string) : EString(encoded_string, EncodingTraits<CharType>::str_length(encoded_string)) {}
+  constexpr explicit BasicEString(EStringView string, Allocator const& allocator = Allocator()) : BasicEString(allocator) {
+    _construct_with_string_and_size(string.data(), string.length());
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  constexpr BasicEString(const CharType* encoded_string, Allocator const& allocator = Allocator())
+    : BasicEString(encoded_string, EncodingTraits<CharType>::str_length(encoded_string), allocator) {}
 
   template <typename CharType>
-  constexpr EString(std::basic_string<CharType, std::char_traits<CharType>> const& encoded_string) : EString(encoded_string.c_str(), encoded_string.length()) {}
+  constexpr BasicEString(std::basic_string<CharType, std::char_traits<CharType>> const& encoded_string, Allocator const& allocator = Allocator())
+    : BasicEString(encoded_string.c_str(), encoded_string.length(), allocator) {}
+
+  constexpr BasicEString(BasicEString const& other)
+    : BasicEString(allocator_traits::select_on_container_copy_construction(other.m_allocator))
+  {
+    _construct_with_string_and_size(other.m_buffer, other.m_length);
+  }
+
+  constexpr BasicEString(BasicEString const& other, Allocator const& allocator) : BasicEString(allocator) {
+    _construct_with_string_and_size(other.m_buffer, other.m_length);
+  }
 
-  constexpr EString(EString const& other) : EString() {
-    operator=(other);
+  constexpr BasicEString(BasicEString&& other) noexcept : m_allocator(std::move(other.m_allocator)) {
+    _take_buffer(other);
   }
 
-  constexpr EString(EString&& other) noexcept {
-    operator=(std::move(other));
+  constexpr BasicEString(BasicEString&& other, Allocator const& allocator) : BasicEString(allocator) {
+    if (m_allocator == other.m_allocator)
+      _take_buffer(other);
+    else
+      _construct_with_string_and_size(other.m_buffer, other.m_length);
   }
 
-  constexpr EString& operator=(EString const& other) {
+  constexpr BasicEString& operator=(BasicEString const& other) {
+    if (this == &other)
+      return *this;
+
+    if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+      if (m_allocator != other.m_allocator) {
+        _free_buffer();
+        m_allocator = other.m_allocator;
+      }
+    }
+
     _need_allocated(other.m_length + 1);
     m_length = other.m_length;
 
@@ -63,23 +122,37 @@ public:
 
     m_buffer[m_length] = 0;
 
+#if defined(ESTRING_CACHE_HASH)
+    if (!std::is_constant_evaluated())
+      m_hash.store(other.m_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+
     return *this;
   }
 
-  constexpr EString& operator=(EString&& other) noexcept {
-    m_buffer = other.m_buffer;
-    m_length = other.m_length;
-    m_allocated = other.m_allocated;
-    other.m_buffer = nullptr;
-    other.m_length = 0;
-    other.m_allocated = 0;
+  constexpr BasicEString& operator=(BasicEString&& other) noexcept(
+    allocator_traits::propagate_on_container_move_assignment::value ||
+    allocator_traits::is_always_equal::value
+  ) {
+    if (this == &other)
+      return *this;
+
+    if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+      _free_buffer();
+      m_allocator = std::move(other.m_allocator);
+    }
+    else if (m_allocator != other.m_allocator) {
+      // Buffer of 'other' can't be freed by our allocator, so copy it.
+      return operator=(static_cast<BasicEString const&>(other));
+    }
+
+    _take_buffer(other);
 
     return *this;
   }
 
-  constexpr ~EString() {
-    m_length = 0;
-    _reallocate(0);
+  constexpr ~BasicEString() {
+    _free_buffer();
   }
 
 public:
@@ -97,24 +170,59 @@ public:
       return string_type();
 
     string_type encoded_string;
-    encoded_string.resize((m_length * encoding_traits::max_encoded_size) + 1);
+    encoded_string.resize(_encoded_length<CharType>(m_buffer, m_length));
+
+    encoding_traits::from_utf32(m_buffer, m_length, encoded_string.data());
 
-    size_type encoded_length = encoding_traits::from_utf32(m_buffer, m_length, encoded_string.data());
-    encoded_string.resize(encoded_length);
+    return encoded_string;
+  }
 
-    return std::move(encoded_string);
+  // Get number of 'CharType' that 'encode()' would produce.
+  template <typename CharType>
+  constexpr size_type encoded_size() const {
+    return _encoded_length<CharType>(m_buffer, m_length);
+  }
+
+  // Encode characters starting at 'index' to caller-provided buffer, e.g. I/O buffer, without allocating.
+  // If buffer is too small, only whole characters that fit are written, and encoding can be continued
+  //  from 'index + progress.read' into next buffer.
+  template <typename CharType>
+  constexpr ECodingProgress encode_into(std::span<CharType> dest, size_type index = 0) const {
+    return EStringView(m_buffer, m_length).encode_into(dest, index);
   }
 
   template <typename CharType>
   constexpr void decode(const CharType* encoded_string, size_type encoded_string_length_in_chars) {
     using encoding_traits = EncodingTraits<CharType>;
 
-    _need_allocated(encoded_string_length_in_chars + 1);
+    size_type decoded_length = _utf32_length<CharType>(encoded_string, encoded_string_length_in_chars);
+
+    _invalidate_hash();
+
+    _need_allocated(decoded_length + 1);
 
     m_length = encoding_traits::to_utf32(encoded_string, encoded_string_length_in_chars, m_buffer);
     m_buffer[m_length] = 0;
   }
 
+  // Append whole characters of caller-provided buffer, that may end with incomplete character (e.g. chunk of socket read).
+  // Characters after 'progress.read' should be passed again, together with next chunk.
+  // Doesn't allocate, if string has enough capacity.
+  template <typename CharType>
+  constexpr ECodingProgress decode_from(const CharType* encoded_string, size_type encoded_string_length_in_chars) {
+    size_type complete_length = _complete_length<CharType>(encoded_string, encoded_string_length_in_chars);
+    size_type old_length = m_length;
+
+    append(encoded_string, complete_length);
+
+    return { complete_length, m_length - old_length, complete_length == encoded_string_length_in_chars };
+  }
+
+  template <typename CharType>
+  constexpr ECodingProgress decode_from(std::basic_string_view<CharType> encoded_string) {
+    return decode_from(encoded_string.data(), encoded_string.length());
+  }
+
   template <typename CharType>
   constexpr void decode(const CharType* encoded_string) {
     decode(encoded_string, EncodingTraits<CharType>::str_length(encoded_string));
@@ -125,8 +233,34 @@ public:
     decode(encoded_string.c_str(), encoded_string.length());
   }
 
+  // Decode whole file. Encoding is detected by byte order mark, files without it are UTF-8.
+  // File is mapped to memory and decoded straight from mapping, without intermediate copy.
+  static BasicEString from_file(const char* path, Allocator const& allocator = Allocator()) {
+    EMappedFile file(path);
+    file.advise_sequential();
+
+    BasicEString string(allocator);
+
+    file.visit_content([&string](auto* content, size_type content_length_in_chars) {
+      string.decode(content, content_length_in_chars);
+    });
+
+    return string;
+  }
+
+  // Format arguments by format string, that is checked at compile time. See 'EStringFormat.h' for syntax.
+  // Result is allocated once, size is computed before writing.
+  template <typename... Args>
+  static BasicEString format(EFormatString<std::type_identity_t<Args>...> format_string, Args const&... args) {
+    BasicEString string;
+    format_to(string, format_string, args...);
+
+    return string;
+  }
+
 public:
   constexpr char32_t& front() noexcept {
+    _invalidate_hash();
     return m_buffer[0];
   }
 
@@ -135,6 +269,7 @@ public:
   }
 
   constexpr char32_t& back() noexcept {
+    _invalidate_hash();
     return m_buffer[m_length - 1];
   }
 
@@ -147,6 +282,7 @@ public:
   }
 
   constexpr char32_t* data() noexcept {
+    _invalidate_hash();
     return m_buffer;
   }
 
@@ -155,6 +291,7 @@ public:
   }
 
   constexpr char32_t* begin() noexcept {
+    _invalidate_hash();
     return m_buffer;
   }
 
@@ -167,15 +304,16 @@ public:
   }
 
   constexpr char32_t* end() noexcept {
-    return m_buffer;
+    _invalidate_hash();
+    return m_buffer + m_length;
   }
 
   constexpr const char32_t* end() const noexcept {
-    return m_buffer;
+    return m_buffer + m_length;
   }
 
   constexpr const char32_t* cend() const noexcept {
-    return m_buffer;
+    return m_buffer + m_length;
   }
 
   constexpr bool is_empty() const noexcept {
@@ -202,18 +340,44 @@ public:
     return m_allocated;
   }
 
+  // Resize to 'count' characters and let 'operation(char32_t* buffer, size_type count)' write them.
+  // First 'min(length(), count)' characters are kept. Operation returns new length, not greater than 'count'.
+  template <typename Operation>
+  constexpr void resize_and_overwrite(size_type count, Operation operation) {
+    _invalidate_hash();
+    _need_allocated(count + 1);
+
+    try {
+      m_length = operation(m_buffer, count);
+    }
+    catch (...) {
+      m_buffer[m_length] = 0;
+      throw;
+    }
+
+    m_buffer[m_length] = 0;
+  }
+
   constexpr void shrink_to_fit() {
-    if (m_allocated > (m_length + 1)) {
+    if (!_is_inline() && m_allocated > (m_length + 1)) {
       _reallocate(m_length + 1);
     }
   }
 
+  // Copy 'count' characters starting at 'index' to new string.
+  // Range is clamped to the end of string. Use 'EStringView::substr()' to avoid copying.
+  constexpr BasicEString substr(size_type index, size_type count = EStringView::npos) const {
+    return BasicEString(EStringView(*this).substr(index, count), m_allocator);
+  }
+
   constexpr void clear() noexcept {
+    _invalidate_hash();
     m_buffer[0] = 0;
     m_length = 0;
   }
 
-  constexpr EString& insert(size_type index, size_type count, char32_t character) {
+  constexpr BasicEString& insert(size_type index, size_type count, char32_t character) {
+    _invalidate_hash();
     _need_allocated(m_length + count + 1);
     _move_right(index, m_length - index, count);
 
@@ -226,11 +390,12 @@ public:
     return *this;
   }
 
-  constexpr EString& insert(size_type index, char32_t character) {
+  constexpr BasicEString& insert(size_type index, char32_t character) {
     return insert(index, 1, character);
   }
 
-  constexpr EString& insert(size_type index, const char32_t* string, size_type string_length_in_characters) {
+  constexpr BasicEString& insert(size_type index, const char32_t* string, size_type string_length_in_characters) {
+    _invalidate_hash();
     _need_allocated(m_length + string_length_in_characters + 1);
     _move_right(index, m_length - index, string_length_in_characters);
 
@@ -243,36 +408,49 @@ public:
     return *this;
   }
 
-  constexpr EString& insert(size_type index, const char32_t* string) {
+  constexpr BasicEString& insert(size_type index, const char32_t* string) {
     return insert(index, string, Utf32EncodingTraits::str_length(string));
   }
 
-  constexpr EString& insert(size_type index, EString const& string) {
+  constexpr BasicEString& insert(size_type index, BasicEString const& string) {
     return insert(index, string.m_buffer, string.m_length);
   }
 
+  // Decode straight to the gap in buffer, without temporary copy.
   template <typename CharType>
-  constexpr EString& insert(size_type index, const CharType* string, size_type string_length_in_characters) {
+  constexpr BasicEString& insert(size_type index, const CharType* string, size_type string_length_in_characters) {
     using encoding_traits = EncodingTraits<CharType>;
 
-    char32_t* buffer = new char32_t[string_length_in_characters];
-    size_type buffer_size = encoding_traits::to_utf32(string, string_length_in_characters, buffer);
+    size_type decoded_length = _utf32_length<CharType>(string, string_length_in_characters);
 
-    insert(index, buffer, buffer_size);
+    _invalidate_hash();
+    _need_allocated(m_length + decoded_length + 1);
+    _move_right(index, m_length - index, decoded_length);
+
+    try {
+      encoding_traits::to_utf32(string, string_length_in_characters, m_buffer + index);
+    }
+    catch (...) {
+      // Invalid string doesn't change this one.
+      _move_left(index + decoded_length, m_length - index, decoded_length);
+      m_buffer[m_length] = 0;
+      throw;
+    }
 
-    delete[] buffer;
+    m_length += decoded_length;
+    m_buffer[m_length] = 0;
 
     return *this;
   }
 
   template <typename CharType>
-  constexpr EString& insert(size_type index, const CharType* string) {
+  constexpr BasicEString& insert(size_type index, const CharType* string) {
     using encoding_traits = EncodingTraits<CharType>;
 
     return insert(index, string, encoding_traits::str_length(string));
   }
 
-  constexpr EString& erase(size_type index, size_type count) noexcept {
+  constexpr BasicEString& erase(size_type index, size_type count) noexcept {
     if (index >= m_length) {
       return *this;
     }
@@ -281,6 +459,8 @@ public:
       return *this;
     }
 
+    _invalidate_hash();
+
     _move_left(index + count, m_length - (index + count), count);
 
     m_length -= count;
@@ -289,7 +469,8 @@ public:
     return *this;
   }
 
-  constexpr EString& append(size_type count, char32_t character) {
+  constexpr BasicEString& append(size_type count, char32_t character) {
+    _invalidate_hash();
     _need_allocated(m_length + count + 1);
 
     for (size_type counter = 0, index = m_length; counter < count; ++counter, ++index)
@@ -301,11 +482,12 @@ public:
     return *this;
   }
 
-  constexpr EString& append(char32_t character) {
+  constexpr BasicEString& append(char32_t character) {
     return append(1, character);
   }
 
-  constexpr EString& append(const char32_t* string, size_type string_length_in_characters) {
+  constexpr BasicEString& append(const char32_t* string, size_type string_length_in_characters) {
+    _invalidate_hash();
     _need_allocated(m_length + string_length_in_characters + 1);
 
     for (size_type i = 0, index = m_length; i < string_length_in_characters; ++i, ++index)
@@ -317,36 +499,47 @@ public:
     return *this;
   }
 
-  constexpr EString& append(const char32_t* string) {
+  constexpr BasicEString& append(const char32_t* string) {
     return append(string, Utf32EncodingTraits::str_length(string));
   }
 
-  constexpr EString& append(EString const& string) {
+  constexpr BasicEString& append(BasicEString const& string) {
     return append(string.m_buffer, string.m_length);
   }
 
+  // Decode straight to the end of buffer, without temporary copy.
   template <typename CharType>
-  constexpr EString& append(const CharType* string, size_type string_length_in_characters) {
+  constexpr BasicEString& append(const CharType* string, size_type string_length_in_characters) {
     using encoding_traits = EncodingTraits<CharType>;
 
-    char32_t* buffer = new char32_t[string_length_in_characters];
-    size_type buffer_size = encoding_traits::to_utf32(string, string_length_in_characters, buffer);
+    size_type decoded_length = _utf32_length<CharType>(string, string_length_in_characters);
+
+    _invalidate_hash();
+    _need_allocated(m_length + decoded_length + 1);
 
-    append(buffer, buffer_size);
+    try {
+      m_length += encoding_traits::to_utf32(string, string_length_in_characters, m_buffer + m_length);
+    }
+    catch (...) {
+      // Invalid string doesn't change this one.
+      m_buffer[m_length] = 0;
+      throw;
+    }
 
-    delete[] buffer;
+    m_buffer[m_length] = 0;
 
     return *this;
   }
 
   template <typename CharType>
-  constexpr EString& append(const CharType* string) {
+  constexpr BasicEString& append(const CharType* string) {
     using encoding_traits = EncodingTraits<CharType>;
 
     return append(string, encoding_traits::str_length(string));
   }
 
   constexpr void push_back(char32_t character) noexcept {
+    _invalidate_hash();
     _need_allocated(m_length + 1 + 1);
 
     m_buffer[m_length] = character;
@@ -371,12 +564,89 @@ public:
     if (m_length == 0)
       return 0;
 
+    _invalidate_hash();
+
     char32_t character = m_buffer[--m_length];
     m_buffer[m_length] = 0;
 
     return character;
   }
 
+  // Convert to lowercase by full Unicode case mapping, e.g. 'İ' becomes "i̇". Final capital sigma becomes 'ς'.
+  // Mappings don't depend on locale. See 'EStringUnicode.h'.
+  BasicEString& to_lower() {
+    _convert_case(_ECaseMapping::lower);
+    return *this;
+  }
+
+  // Convert to uppercase by full Unicode case mapping, e.g. 'ß' becomes "SS".
+  BasicEString& to_upper() {
+    _convert_case(_ECaseMapping::upper);
+    return *this;
+  }
+
+  // Apply full Unicode case folding, for caseless comparison, e.g. "Straße" and "STRASSE" both become "strasse".
+  BasicEString& casefold() {
+    _convert_case(_ECaseMapping::fold);
+    return *this;
+  }
+
+  BasicEString lowered() const {
+    return BasicEString(*this).to_lower();
+  }
+
+  BasicEString uppered() const {
+    return BasicEString(*this).to_upper();
+  }
+
+  BasicEString casefolded() const {
+    return BasicEString(*this).casefold();
+  }
+
+  // Normalize to Unicode normalization form, so canonically equivalent strings become equal.
+  // String, that is confirmed to be normalized by quick check, isn't changed. Otherwise it's normalized from the
+  //  last stable character before the first unsure one, to new buffer allocated once.
+  BasicEString& normalize(ENormalizationForm form = ENormalizationForm::nfc) {
+    size_type unsure_index;
+
+    if (_unicode_quick_check(m_buffer, m_length, form, unsure_index, true) == _EQuickCheckResult::yes)
+      return *this;
+
+    size_type start_index = _unicode_normalization_start(m_buffer, unsure_index);
+    size_type decomposed_length = _unicode_decomposed_length(m_buffer + start_index, m_length - start_index, form);
+
+    BasicEString normalized_string(m_allocator);
+
+    normalized_string.resize_and_overwrite(start_index + decomposed_length, [this, form, start_index](char32_t* buffer, size_type) {
+      memcpy(buffer, m_buffer, start_index * sizeof(char32_t));
+
+      size_type length = _unicode_decompose(m_buffer + start_index, m_length - start_index, form, buffer + start_index);
+
+      if (_unicode_is_composing_form(form))
+        length = _unicode_compose(buffer + start_index, length);
+
+      return start_index + length;
+    });
+
+    return *this = std::move(normalized_string);
+  }
+
+  BasicEString normalized(ENormalizationForm form = ENormalizationForm::nfc) const {
+    return BasicEString(*this).normalize(form);
+  }
+
+  // Check is string in normalization form. Most strings are checked by quick check properties in one pass,
+  //  only strings with 'Maybe' characters are normalized to compare.
+  bool is_normalized(ENormalizationForm form = ENormalizationForm::nfc) const {
+    size_type unsure_index;
+    _EQuickCheckResult result = _unicode_quick_check(m_buffer, m_length, form, unsure_index);
+
+    if (result != _EQuickCheckResult::maybe)
+      return result == _EQuickCheckResult::yes;
+
+    return normalized(form) == *this;
+  }
+
   constexpr bool startswith(const char32_t* string, size_type string_length) const noexcept {
     if (string_length > m_length)
       return false;
@@ -388,31 +658,18 @@ public:
     return startswith(string, Utf32EncodingTraits::str_length(string));
   }
 
-  constexpr bool startswith(const EString& string) const noexcept {
+  constexpr bool startswith(const BasicEString& string) const noexcept {
     return startswith(string.m_buffer, string.m_length);
   }
 
+  constexpr bool startswith(EStringView string) const noexcept {
+    return startswith(string.data(), string.length());
+  }
+
+  // Encoded string is decoded on the fly, until first mismatch.
   template <typename CharType>
   constexpr bool startswith(const CharType* string, size_type string_size_in_chars) const {
-    using encoding_traits = EncodingTraits<CharType>;
-
-    char32_t* buffer = new char32_t[string_size_in_chars];
-    size_type buffer_size = encoding_traits::to_utf32(string, string_size_in_chars, buffer);
-
-    if (buffer_size > m_length) {
-      delete[] buffer;
-      return false;
-    } else if (buffer_size == m_length) {
-      bool is_equal = _is_str_equal(buffer, buffer_size);
-
-      delete[] buffer;
-      return is_equal;
-    }
-
-    bool is_endswith = _is_substr_equal(0, buffer, buffer_size);
-
-    delete[] buffer;
-    return is_endswith;
+    return _match_encoded_prefix(m_buffer, m_length, string, string_size_in_chars) != npos;
   }
 
   template <typename CharType>
@@ -438,32 +695,27 @@ public:
     return endswith(string, Utf32EncodingTraits::str_length(string));
   }
 
-  constexpr bool endswith(const EString& string) const noexcept {
+  constexpr bool endswith(const BasicEString& string) const noexcept {
     return endswith(string.m_buffer, string.m_length);
   }
 
+  constexpr bool endswith(EStringView string) const noexcept {
+    return endswith(string.data(), string.length());
+  }
+
+  // Encoded string is decoded on the fly, until first mismatch.
+  // Invalid strings aren't suffixes of anything.
   template <typename CharType>
   constexpr bool endswith(const CharType* string, size_type string_size_in_chars) const {
-    using encoding_traits = EncodingTraits<CharType>;
-
-    char32_t* buffer = new char32_t[string_size_in_chars];
-    size_type buffer_size = encoding_traits::to_utf32(string, string_size_in_chars, buffer);
-
-    if (buffer_size > m_length) {
-      delete[] buffer;
+    if (!validate(string, string_size_in_chars).is_valid)
       return false;
-    }
-    else if (buffer_size == m_length) {
-      bool is_equal = _is_str_equal(buffer, buffer_size);
 
-      delete[] buffer;
-      return is_equal;
-    }
+    size_type decoded_length = _utf32_length<CharType>(string, string_size_in_chars);
 
-    bool is_endswith = _is_substr_equal(m_length - buffer_size, buffer, buffer_size);
+    if (decoded_length > m_length)
+      return false;
 
-    delete[] buffer;
-    return is_endswith;
+    return _match_encoded_prefix(m_buffer + m_length - decoded_length, decoded_length, string, string_size_in_chars) == decoded_length;
   }
 
   template <typename CharType>
@@ -479,43 +731,106 @@ public:
   }
 
   constexpr bool contains(const char32_t* string, size_type string_length_in_utf32_chars) const noexcept {
-    if (string_length_in_utf32_chars == m_length)
-      return _is_str_equal(string, string_length_in_utf32_chars);
-    else if (string_length_in_utf32_chars > m_length)
-      return false;
-
-    for (size_type search_end = m_length - string_length_in_utf32_chars, base_index = 0; base_index < search_end; ++base_index) {
-      if (_is_substr_equal(base_index, string, string_length_in_utf32_chars)) {
-        return true;
-      }
-    }
-
-    return false;
+    return find(EStringView(string, string_length_in_utf32_chars)) != npos;
   }
 
   constexpr bool contains(const char32_t* string) const noexcept {
     return contains(string, Utf32EncodingTraits::str_length(string));
   }
 
-  constexpr bool contains(EString const& string) const noexcept {
+  constexpr bool contains(BasicEString const& string) const noexcept {
     return contains(string.m_buffer, string.m_length);
   }
+
+  constexpr bool contains(EStringView string) const noexcept {
+    return contains(string.data(), string.length());
+  }
   
+  // Short strings are decoded to stack buffer and searched as utf32 ones.
+  // Longer strings are compared on the fly at every occurrence of their first character.
+  // Invalid strings aren't contained in anything, like they aren't equal to anything.
   template <typename CharType>
   constexpr bool contains(const CharType* string, size_type string_length_in_chars) const {
     using encoding_traits = EncodingTraits<CharType>;
 
-    char32_t* buffer = new char32_t[string_length_in_chars];
-    size_type buffer_size = encoding_traits::to_utf32(string, string_length_in_chars, buffer);
+    if (!validate(string, string_length_in_chars).is_valid)
+      return false;
+
+    size_type decoded_length = _utf32_length<CharType>(string, string_length_in_chars);
+
+    if (decoded_length > m_length)
+      return false;
+
+    if (decoded_length <= _contains_buffer_length) {
+      char32_t buffer[_contains_buffer_length];
+      size_type buffer_size = encoding_traits::to_utf32(string, string_length_in_chars, buffer);
+
+      return contains(buffer, buffer_size);
+    }
+
+    char32_t first_character = encoding_traits::char_to_utf32(string);
+    size_type first_character_length = encoding_traits::char_length(string);
+
+    for (size_type index = find(first_character); index != npos && index + decoded_length <= m_length; index = find(first_character, index + 1)) {
+      size_type matched_length = _match_encoded_prefix(
+        m_buffer + index + 1, m_length - index - 1,
+        string + first_character_length, string_length_in_chars - first_character_length
+      );
+
+      if (matched_length != npos)
+        return true;
+    }
+
+    return false;
+  }
+
+  template <typename CharType>
+  constexpr bool contains(const CharType* string) const {
+    using encoding_traits = EncodingTraits<CharType>;
+
+    return contains(string, encoding_traits::str_length(string));
+  }
+
+  template <typename CharType>
+  constexpr bool contains(std::basic_string<CharType, std::char_traits<CharType>> const& string) const {
+    return contains(string.c_str(), string.length());
+  }
 
-    bool is_contains = contains(buffer, buffer_size);
+  constexpr bool contains(char32_t character) const noexcept {
+    return find(character) != npos;
+  }
 
-    delete[] buffer;
-    return is_contains;
+  // Search functions are same as EStringView ones.
+  constexpr size_type find(EStringView string, size_type index = 0) const noexcept {
+    return EStringView(*this).find(string, index);
+  }
+
+  constexpr size_type find(char32_t character, size_type index = 0) const noexcept {
+    return EStringView(*this).find(character, index);
+  }
+
+  constexpr size_type rfind(EStringView string, size_type index = npos) const noexcept {
+    return EStringView(*this).rfind(string, index);
+  }
+
+  constexpr size_type rfind(char32_t character, size_type index = npos) const noexcept {
+    return EStringView(*this).rfind(character, index);
+  }
+
+  std::vector<size_type> find_all(EStringView string) const {
+    return EStringView(*this).find_all(string);
+  }
+
+  constexpr size_type count(EStringView string) const noexcept {
+    return EStringView(*this).count(string);
+  }
+
+  constexpr size_type count(char32_t character) const noexcept {
+    return EStringView(*this).count(character);
   }
 
 public:
-  constexpr bool operator==(EString const& string) const noexcept {
+  constexpr bool operator==(BasicEString const& string) const noexcept {
     return _is_str_equal(string.m_buffer, string.m_length);
   }
 
@@ -525,6 +840,10 @@ public:
     return _is_str_equal(string, string_length);
   }
 
+  constexpr bool operator==(EStringView string) const noexcept {
+    return _is_str_equal(string.data(), string.length());
+  }
+
   template <typename CharType>
   constexpr bool operator==(const CharType* string) const {
     using encoding_traits = EncodingTraits<CharType>;
@@ -537,7 +856,7 @@ public:
     return _is_str_equal_encoded(string.c_str(), string.length());
   }
 
-  constexpr bool operator!=(EString const& string) const noexcept {
+  constexpr bool operator!=(BasicEString const& string) const noexcept {
     return !operator==(string);
   }
 
@@ -545,6 +864,10 @@ public:
     return !operator==(string);
   }
 
+  constexpr bool operator!=(EStringView string) const noexcept {
+    return !operator==(string);
+  }
+
   template <typename CharType>
   constexpr bool operator!=(const CharType* string) const {
     return !operator==(string);
@@ -555,19 +878,37 @@ public:
     return !operator==(string);
   }
 
+  // Order by code points. Shorter string is less than string it's prefix of.
+  constexpr std::strong_ordering operator<=>(BasicEString const& string) const noexcept {
+    return EStringView(*this) <=> EStringView(string);
+  }
+
+  constexpr std::strong_ordering operator<=>(const char32_t* string) const noexcept {
+    return EStringView(*this) <=> EStringView(string);
+  }
+
+  constexpr std::strong_ordering operator<=>(EStringView string) const noexcept {
+    return EStringView(*this) <=> string;
+  }
+
+  constexpr int compare(EStringView string) const noexcept {
+    return EStringView(*this).compare(string);
+  }
+
   template <typename CharType>
-  constexpr EString& operator=(const CharType* encoded_string) {
+  constexpr BasicEString& operator=(const CharType* encoded_string) {
     decode(encoded_string);
     return *this;
   }
 
   template <typename CharType>
-  constexpr EString& operator=(std::basic_string<CharType, std::char_traits<CharType>> const& encoded_string) {
+  constexpr BasicEString& operator=(std::basic_string<CharType, std::char_traits<CharType>> const& encoded_string) {
     decode(encoded_string);
     return *this;
   }
 
   constexpr char32_t& operator[](size_type index) noexcept {
+    _invalidate_hash();
     return m_buffer[index];
   }
 
@@ -575,6 +916,33 @@ public:
     return m_buffer[index];
   }
 
+  // Get hash of characters, equal to 'std::hash<EStringView>' of this string.
+  // When 'ESTRING_CACHE_HASH' is defined, it's computed once and cached until string is modified by its functions.
+  //  Cache isn't updated by writes through pointers and references (from 'data()', 'begin()', 'operator[]'...)
+  //  taken before 'hash()' was called, so take them again after calling it.
+  size_t hash() const noexcept {
+#if defined(ESTRING_CACHE_HASH)
+    size_t hash = m_hash.load(std::memory_order_relaxed);
+
+    if (hash == 0) {
+      hash = _EStringHasher::hash(m_buffer, m_length);
+      m_hash.store(hash, std::memory_order_relaxed);
+    }
+
+    return hash;
+#else
+    return _EStringHasher::hash(m_buffer, m_length);
+#endif
+  }
+
+  constexpr Allocator get_allocator() const noexcept {
+    return m_allocator;
+  }
+
+  constexpr operator EStringView() const noexcept {
+    return EStringView(m_buffer, m_length);
+  }
+
   // Cast to STL string.
   template <typename CharType>
   constexpr operator std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>>() {
@@ -590,6 +958,92 @@ private:
     return true;
   }
 
+  // Convert case in place. ASCII blocks are converted by SIMD, other characters by tables,
+  //  until the first character that expands to several ones.
+  void _convert_case(_ECaseMapping mapping) {
+    _invalidate_hash();
+
+    char32_t ascii_first = mapping == _ECaseMapping::upper ? U'a' : U'A';
+    int ascii_delta = mapping == _ECaseMapping::upper ? -32 : 32;
+
+    size_type index = 0;
+
+    while (index < m_length) {
+      index += _simd_ascii_convert_case(m_buffer + index, m_length - index, ascii_first, ascii_first + 25, ascii_delta);
+
+      size_type block_end = index + 8 < m_length ? index + 8 : m_length;
+
+      for (; index < block_end; ++index) {
+        char32_t character = m_buffer[index];
+        char32_t mapped_character;
+
+        if (_unicode_map_case(character, mapping, mapped_character)) {
+          _convert_case_expanding(index, mapping);
+          return;
+        }
+
+        if (mapping == _ECaseMapping::lower && character == U'\u03A3' &&
+            _unicode_is_final_sigma(m_buffer, m_buffer + index, m_buffer + index + 1, m_buffer + m_length))
+          mapped_character = U'\u03C2';
+
+        m_buffer[index] = mapped_character;
+      }
+    }
+  }
+
+  // Convert case of characters starting at 'index', where some of them expand to several characters.
+  // Buffer is grown once: tail is moved to the end of new length and converted from there to the front.
+  void _convert_case_expanding(size_type index, _ECaseMapping mapping) {
+    size_type added_length = 0;
+
+    for (size_type source_index = index; source_index < m_length; ++source_index)
+      added_length += _unicode_case_mapping_length(m_buffer[source_index], mapping) - 1;
+
+    size_type source_end = m_length + added_length;
+
+    _need_allocated(source_end + 1);
+    _move_right(index, m_length - index, added_length);
+
+    // Every mapped character fits before the next source one, so unconverted characters are never overwritten.
+    for (size_type source_index = index + added_length; source_index < source_end; ++source_index) {
+      char32_t character = m_buffer[source_index];
+      char32_t mapped_character;
+
+      if (const char32_t* expansion = _unicode_map_case(character, mapping, mapped_character)) {
+        for (char32_t expansion_index = 1; expansion_index <= expansion[0]; ++expansion_index)
+          m_buffer[index++] = expansion[expansion_index];
+
+        continue;
+      }
+
+      if (mapping == _ECaseMapping::lower && character == U'\u03A3' &&
+          _unicode_is_final_sigma(m_buffer, m_buffer + index, m_buffer + source_index + 1, m_buffer + source_end))
+        mapped_character = U'\u03C2';
+
+      m_buffer[index++] = mapped_character;
+    }
+
+    m_length = index;
+    m_buffer[m_length] = 0;
+  }
+
+  // Encoded strings up to this length are decoded to stack buffer by 'contains()'.
+  static constexpr size_type _contains_buffer_length = 64;
+
+  // Forget cached hash. Called by every function that can modify characters.
+  // Atomic isn't usable in constant evaluation, where 'hash()' can't be called anyway.
+  constexpr void _invalidate_hash() noexcept {
+#if defined(ESTRING_CACHE_HASH)
+    if (!std::is_constant_evaluated())
+      m_hash.store(0, std::memory_order_relaxed);
+#endif
+  }
+
+  // Check is 'm_buffer' pointing at 'm_inline_buffer'.
+  constexpr bool _is_inline() const noexcept {
+    return m_buffer == m_inline_buffer;
+  }
+
   // Assert that 'm_buffer' can store 'size' characters.
   // If not, reallocate buffer.
   constexpr void _need_allocated(size_type size) {
@@ -609,29 +1063,74 @@ private:
   }
 
   // Reallocate 'm_buffer' with size 'new_size' and copy data from old buffer to new one.
+  // Sizes up to 'inline_capacity' use 'm_inline_buffer' instead of heap.
   constexpr void _reallocate(size_type new_size) {
     char32_t* prev_buffer = m_buffer;
     size_type prev_allocated = m_allocated;
+    bool was_inline = _is_inline();
+
+    if (new_size <= inline_capacity) {
+      if (was_inline)
+        return;
 
-    m_allocated = new_size;
-    m_buffer = nullptr;
+      m_buffer = m_inline_buffer;
+      m_allocated = inline_capacity;
+    }
+    else {
+      m_buffer = allocator_traits::allocate(m_allocator, new_size);
+      m_allocated = new_size;
+    }
 
-    if (new_size > 0) {
-      m_buffer = new char32_t[new_size];
-      memset(m_buffer, 0, m_allocated * sizeof(char32_t));
+    // Only characters and null-terminating char are copied, the rest of buffer isn't initialized.
+    size_type copy_size = m_length + 1 < m_allocated ? m_length + 1 : m_allocated;
 
-      if (prev_buffer) {
-        memcpy(m_buffer, prev_buffer, prev_allocated * sizeof(char32_t));
-      }
+    memcpy(m_buffer, prev_buffer, copy_size * sizeof(char32_t));
+
+    if (!was_inline) {
+      allocator_traits::deallocate(m_allocator, prev_buffer, prev_allocated);
     }
+  }
+
+  // Return heap buffer to allocator and switch to empty inline buffer.
+  constexpr void _free_buffer() noexcept {
+    _invalidate_hash();
+    if (!_is_inline())
+      allocator_traits::deallocate(m_allocator, m_buffer, m_allocated);
+
+    m_buffer = m_inline_buffer;
+    m_buffer[0] = 0;
+    m_length = 0;
+    m_allocated = inline_capacity;
+  }
 
-    if (prev_buffer) {
-      delete[] prev_buffer;
+  // Take buffer of 'other', leaving it empty.
+  // Allocators of both strings must be equal.
+  constexpr void _take_buffer(BasicEString& other) noexcept {
+    _invalidate_hash();
+    if (other._is_inline()) {
+      // Inline buffer can't be stolen, but it always fits in our buffer.
+      for (size_type i = 0; i <= other.m_length; ++i)
+        m_buffer[i] = other.m_buffer[i];
+
+      m_length = other.m_length;
     }
+    else {
+      _free_buffer();
+
+      m_buffer = other.m_buffer;
+      m_length = other.m_length;
+      m_allocated = other.m_allocated;
+    }
+
+    other.m_buffer = other.m_inline_buffer;
+    other.m_buffer[0] = 0;
+    other.m_length = 0;
+    other.m_allocated = inline_capacity;
   }
 
-  // Initialize EString using utf32 string and size of this string.
+  // Initialize string using utf32 string and size of this string.
   constexpr void _construct_with_string_and_size(const char32_t* utf32_string, size_type string_size_in_chars) {
+    _invalidate_hash();
     _need_allocated(string_size_in_chars + 1);
 
     for (size_type index = 0; index < string_size_in_chars; ++index)
@@ -643,101 +1142,706 @@ private:
 
   // Move all characters in range [index, index + count) by 'amount' characters to right.
   constexpr void _move_right(size_type index, size_type count, size_type amount) noexcept {
-    char32_t* rbegin = m_buffer + index + count - 1;
-    char32_t* rend = m_buffer + index - 1;
+    if (!std::is_constant_evaluated()) {
+      memmove(m_buffer + index + amount, m_buffer + index, count * sizeof(char32_t));
+      return;
+    }
 
-    for (char32_t* it = rbegin; it != rend; --it) {
-      it[amount] = it[0];
+    for (size_type offset = count; offset > 0; --offset) {
+      m_buffer[index + offset - 1 + amount] = m_buffer[index + offset - 1];
     }
   }
 
   // Move all characters in range [index, index + count) by 'amount' characters to left.
-  constexpr void _move_left(size_type index, size_type count, int amount) noexcept {
+  constexpr void _move_left(size_type index, size_type count, size_type amount) noexcept {
+    if (!std::is_constant_evaluated()) {
+      memmove(m_buffer + index - amount, m_buffer + index, count * sizeof(char32_t));
+      return;
+    }
+
     char32_t* begin = m_buffer + index;
     char32_t* end = m_buffer + index + count;
 
     for (char32_t* it = begin; it != end; ++it) {
-      it[-amount] = it[0];
+      *(it - amount) = *it;
     }
   }
 
   // Check is data in 'm_buffer' equal to data in 'string'.
   constexpr bool _is_str_equal(const char32_t* string, size_type string_size_in_utf32_chars) const noexcept {
-    if (m_buffer == string)
-      return true;
-
     if (string_size_in_utf32_chars != m_length)
       return false;
 
-    for (size_type index = 0; index < string_size_in_utf32_chars; ++index)
-      if (string[index] != m_buffer[index])
-        return false;
+    if (m_buffer == string)
+      return true;
 
-    return true;
+    return EStringView(m_buffer, m_length) == EStringView(string, string_size_in_utf32_chars);
   }
 
   // Check is data in 'm_buffer' equal to data in 'string'.
+  // Utf32 strings are compared as is, so any code points (e.g. lone surrogates) match themselves.
   template <typename CharType>
   constexpr bool _is_str_equal_encoded(const CharType* string, size_type string_size_in_chars) const {
-    using encoding_traits = EncodingTraits<CharType>;
-
-    char32_t* buffer = new char32_t[string_size_in_chars];
-    size_type buffer_size = encoding_traits::to_utf32(string, string_size_in_chars, buffer);
-
-    if (buffer_size != m_length) {
-      delete[] buffer;
-      return false;
-    }
-
-    bool is_equal = _is_str_equal(buffer, buffer_size);
-
-    delete[] buffer;
-
-    return is_equal;
+    if constexpr (std::is_same_v<CharType, char32_t>)
+      return EStringView(m_buffer, m_length) == EStringView(string, string_size_in_chars);
+    else
+      return _match_encoded_prefix(m_buffer, m_length, string, string_size_in_chars) == m_length;
   }
 
 private:
+  // Allocator of heap buffers. Takes no space when it's stateless.
+  [[no_unique_address]] Allocator m_allocator = Allocator();
   // Length of string in char32_t, not including null-terminating char.
   size_type m_length = 0;
   // Size of allocated space in char32_t 'm_buffer' pointing at.
-  size_type m_allocated = 0;
-  // Buffer for string value.
-  char32_t* m_buffer = nullptr;
+  size_type m_allocated = inline_capacity;
+#if defined(ESTRING_CACHE_HASH)
+  // Cached result of 'hash()', or 0 if it's not computed yet.
+  mutable std::atomic<size_t> m_hash = 0;
+#endif
+  // Buffer for string value. Points either at 'm_inline_buffer' or at heap memory.
+  char32_t* m_buffer = m_inline_buffer;
+  // Storage for short strings.
+  char32_t m_inline_buffer[inline_capacity] = {};
 };
 
-constexpr EString& operator+=(EString& string, EString const& other) {
+using EString = BasicEString<>;
+
+using PmrEString = BasicEString<std::pmr::polymorphic_allocator<char32_t>>;
+
+template <typename Allocator>
+constexpr BasicEString<Allocator>& operator+=(BasicEString<Allocator>& string, BasicEString<Allocator> const& other) {
   string.append(other);
   return string;
 }
 
-constexpr EString& operator+=(EString& string, const char32_t* other) {
+template <typename Allocator>
+constexpr BasicEString<Allocator>& operator+=(BasicEString<Allocator>& string, const char32_t* other) {
   string.append(other);
   return string;
 }
 
-template <typename CharType>
-constexpr EString& operator+=(EString& string, const CharType* other) {
+template <typename Allocator, typename CharType>
+constexpr BasicEString<Allocator>& operator+=(BasicEString<Allocator>& string, const CharType* other) {
   string.append(other);
   return string;
 }
 
-constexpr EString operator+(EString const& left, EString const& right) {
-  EString result = left;
-  result += right;
-  return result;
+// Lazy concatenation.
+// 'a + b + c' doesn't build intermediate strings, it builds 'EStringConcat' that refers to all operands.
+// When concatenation is converted to string, total length is computed, and all operands are written to
+//  one buffer of exactly that size. If leftmost operand is rvalue string, its buffer is reused,
+//  unless other operands refer to it.
+// Rvalue strings are moved into concatenation, so it may be stored in 'auto' variable. Other operands are referred to,
+//  and concatenation must be converted before they're destroyed.
+
+// Check do characters ['begin', 'end') overlap with buffer ['buffer_begin', 'buffer_end').
+inline bool _concat_is_overlapping(const void* begin, const void* end, const void* buffer_begin, const void* buffer_end) noexcept {
+  std::less<const void*> less;
+  return less(begin, buffer_end) && less(buffer_begin, end);
+}
+
+// String compared with concatenation. Operands are matched with its beginning one by one, from left to right.
+template <typename CharType>
+struct _EStringConcatMatcher {
+  const CharType* string;
+  size_t string_length_in_chars;
+
+  // Check does string begin with utf32 'characters', and skip them.
+  constexpr bool skip_prefix(const char32_t* characters, size_t count) {
+    size_t prefix_length = count;
+
+    if constexpr (std::is_same_v<CharType, char32_t>) {
+      if (count > string_length_in_chars || EStringView(string, count) != EStringView(characters, count))
+        return false;
+    }
+    else {
+      prefix_length = _match_decoded_prefix(string, string_length_in_chars, characters, count);
+
+      if (prefix_length == static_cast<size_t>(-1))
+        return false;
+    }
+
+    skip(prefix_length);
+    return true;
+  }
+
+  constexpr void skip(size_t length) noexcept {
+    string += length;
+    string_length_in_chars -= length;
+  }
+};
+
+template <typename Allocator>
+constexpr _EStringConcatMatcher<char32_t> _concat_matcher(BasicEString<Allocator> const& string) noexcept {
+  return { string.data(), string.length() };
+}
+
+constexpr _EStringConcatMatcher<char32_t> _concat_matcher(EStringView string) noexcept {
+  return { string.data(), string.length() };
+}
+
+constexpr _EStringConcatMatcher<char32_t> _concat_matcher(const char32_t* string) noexcept {
+  return { string, Utf32EncodingTraits::str_length(string) };
 }
 
-constexpr EString operator+(EString const& left, const char32_t* right) {
-  EString result = left;
-  result += right;
-  return result;
+template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType> && !std::is_same_v<CharType, char32_t>>>
+constexpr _EStringConcatMatcher<CharType> _concat_matcher(const CharType* string) noexcept {
+  return { string, EncodingTraits<CharType>::str_length(string) };
 }
 
+template <typename CharType, typename Traits, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+constexpr _EStringConcatMatcher<CharType> _concat_matcher(std::basic_string_view<CharType, Traits> string) noexcept {
+  return { string.data(), string.size() };
+}
+
+template <typename CharType, typename Traits, typename StringAllocator, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+constexpr _EStringConcatMatcher<CharType> _concat_matcher(std::basic_string<CharType, Traits, StringAllocator> const& string) noexcept {
+  return { string.data(), string.size() };
+}
+
+// Operand of utf32 characters.
+struct _EStringConcatView {
+  EStringView string;
+
+  constexpr size_t length() const noexcept {
+    return string.length();
+  }
+
+  bool is_overlapping(const void* buffer_begin, const void* buffer_end) const noexcept {
+    return _concat_is_overlapping(string.data(), string.data() + string.length(), buffer_begin, buffer_end);
+  }
+
+  constexpr char32_t* write(char32_t* dest) const noexcept {
+    if (!std::is_constant_evaluated()) {
+      if (!string.is_empty())
+        memcpy(dest, string.data(), string.length() * sizeof(char32_t));
+
+      return dest + string.length();
+    }
+
+    for (char32_t character : string)
+      *dest++ = character;
+
+    return dest;
+  }
+
+  template <typename OtherCharType>
+  constexpr bool match(_EStringConcatMatcher<OtherCharType>& matcher) const {
+    return matcher.skip_prefix(string.data(), string.length());
+  }
+};
+
+// Operand of encoded characters, decoded while writing.
 template <typename CharType>
-constexpr EString operator+(EString const& left, const CharType* right) {
-  EString result = left;
-  result += right;
-  return result;
+struct _EStringConcatEncoded {
+  const CharType* string;
+  size_t string_length_in_chars;
+
+  constexpr size_t length() const {
+    return _utf32_length<CharType>(string, string_length_in_chars);
+  }
+
+  bool is_overlapping(const void* buffer_begin, const void* buffer_end) const noexcept {
+    return _concat_is_overlapping(string, string + string_length_in_chars, buffer_begin, buffer_end);
+  }
+
+  constexpr char32_t* write(char32_t* dest) const {
+    return dest + EncodingTraits<CharType>::to_utf32(string, string_length_in_chars, dest);
+  }
+
+  // Invalid characters don't match anything, as they can't be decoded.
+  template <typename OtherCharType>
+  constexpr bool match(_EStringConcatMatcher<OtherCharType>& matcher) const {
+    if constexpr (std::is_same_v<OtherCharType, char32_t>) {
+      size_t length = _match_encoded_prefix(matcher.string, matcher.string_length_in_chars, string, string_length_in_chars);
+
+      if (length == static_cast<size_t>(-1))
+        return false;
+
+      matcher.skip(length);
+      return true;
+    }
+    else {
+      // Both strings are encoded. Characters are decoded to chunks, and matched chunk by chunk.
+      const CharType* current = string;
+      const CharType* end = string + string_length_in_chars;
+      char32_t chunk[_chunk_length];
+
+      while (current != end) {
+        size_t count = 0;
+
+        for (; current != end && count < _chunk_length; ++count) {
+          EEncodingError error = EEncodingError::none;
+          size_t char_length = _decode_encoded_char_checked(current, static_cast<size_t>(end - current), chunk[count], error);
+
+          if (char_length == 0)
+            return false;
+
+          current += char_length;
+        }
+
+        if (!matcher.skip_prefix(chunk, count))
+          return false;
+      }
+
+      return true;
+    }
+  }
+
+  static constexpr size_t _chunk_length = 64;
+};
+
+// Rvalue string, moved into concatenation. Its buffer is reused when concatenation is converted to string.
+template <typename Allocator>
+struct _EStringConcatOwned {
+  BasicEString<Allocator> string;
+
+  constexpr size_t length() const noexcept {
+    return string.length();
+  }
+
+  bool is_overlapping(const void* buffer_begin, const void* buffer_end) const noexcept {
+    return _EStringConcatView{ string }.is_overlapping(buffer_begin, buffer_end);
+  }
+
+  constexpr char32_t* write(char32_t* dest) const noexcept {
+    return _EStringConcatView{ string }.write(dest);
+  }
+
+  template <typename OtherCharType>
+  constexpr bool match(_EStringConcatMatcher<OtherCharType>& matcher) const {
+    return _EStringConcatView{ string }.match(matcher);
+  }
+};
+
+// Rvalue STL string, moved into concatenation like rvalue EString.
+template <typename CharType, typename Traits, typename StringAllocator>
+struct _EStringConcatStlString {
+  std::basic_string<CharType, Traits, StringAllocator> string;
+
+  constexpr size_t length() const {
+    return _operand().length();
+  }
+
+  bool is_overlapping(const void* buffer_begin, const void* buffer_end) const noexcept {
+    return _operand().is_overlapping(buffer_begin, buffer_end);
+  }
+
+  constexpr char32_t* write(char32_t* dest) const {
+    return _operand().write(dest);
+  }
+
+  template <typename OtherCharType>
+  constexpr bool match(_EStringConcatMatcher<OtherCharType>& matcher) const {
+    return _operand().match(matcher);
+  }
+
+  constexpr auto _operand() const noexcept {
+    if constexpr (std::is_same_v<CharType, char32_t>)
+      return _EStringConcatView{ EStringView(string.data(), string.size()) };
+    else
+      return _EStringConcatEncoded<CharType>{ string.data(), string.size() };
+  }
+};
+
+template <typename Left, typename Right>
+class [[nodiscard]] EStringConcat {
+public:
+  using size_type = size_t;
+
+public:
+  constexpr EStringConcat(Left left, Right right) : m_left(std::move(left)), m_right(std::move(right)) {}
+
+public:
+  // Total length of concatenation in utf32 characters.
+  constexpr size_type length() const {
+    return m_left.length() + m_right.length();
+  }
+
+  // Check do any operands refer to characters in buffer ['buffer_begin', 'buffer_end').
+  bool is_overlapping(const void* buffer_begin, const void* buffer_end) const noexcept {
+    return m_left.is_overlapping(buffer_begin, buffer_end) || m_right.is_overlapping(buffer_begin, buffer_end);
+  }
+
+  // Write all operands to 'dest', return end of written characters.
+  constexpr char32_t* write(char32_t* dest) const {
+    return m_right.write(m_left.write(dest));
+  }
+
+  // Match all operands with beginning of compared string.
+  template <typename CharType>
+  constexpr bool match(_EStringConcatMatcher<CharType>& matcher) const {
+    return m_left.match(matcher) && m_right.match(matcher);
+  }
+
+  template <typename Allocator>
+  constexpr BasicEString<Allocator> materialize(Allocator const& allocator = Allocator()) && {
+    if constexpr (std::is_same_v<_leftmost_type, _EStringConcatOwned<Allocator>>) {
+      BasicEString<Allocator>& leftmost = _leftmost().string;
+
+      // Growing leftmost buffer in place would free characters, that other operands refer to.
+      // Result is built in new buffer then, like 'operator+=' does.
+      if (std::is_constant_evaluated() || _is_overlapping_after_leftmost(leftmost.data(), leftmost.data() + leftmost.capacity()))
+        return _materialize_to_new_buffer(leftmost.get_allocator());
+
+      BasicEString<Allocator> string = std::move(leftmost);
+      size_type prefix_length = string.length();
+      size_type total_length = prefix_length + _length_after_leftmost();
+
+      string.resize_and_overwrite(total_length, [this, prefix_length](char32_t* buffer, size_type count) {
+        _write_after_leftmost(buffer + prefix_length);
+        return count;
+      });
+
+      return string;
+    }
+    else {
+      return _materialize_to_new_buffer(allocator);
+    }
+  }
+
+  template <typename Allocator>
+  constexpr operator BasicEString<Allocator>() && {
+    return std::move(*this).template materialize<Allocator>();
+  }
+
+  // Doesn't take buffer of rvalue operand, so concatenation can be converted again.
+  template <typename Allocator>
+  constexpr operator BasicEString<Allocator>() const& {
+    return _materialize_to_new_buffer(Allocator());
+  }
+
+  constexpr EString to_estring() && {
+    return std::move(*this).template materialize<std::allocator<char32_t>>();
+  }
+
+  template <typename CharType>
+  constexpr std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encode() const {
+    return EString(*this).template encode<CharType>();
+  }
+
+  // Compare operand by operand, without converting concatenation to string.
+  template <typename Other>
+  constexpr bool operator==(Other const& other) const {
+    if constexpr (_is_concat<Other>::value) {
+      // Other concatenation is converted to string, to be compared with.
+      return operator==(EString(other));
+    }
+    else {
+      auto matcher = _concat_matcher(other);
+      return match(matcher) && matcher.string_length_in_chars == 0;
+    }
+  }
+
+  template <typename Other>
+  constexpr bool operator!=(Other const& other) const {
+    return !operator==(other);
+  }
+
+private:
+  template <typename, typename>
+  friend class EStringConcat;
+
+  template <typename Operand>
+  struct _leftmost_of {
+    using type = Operand;
+  };
+
+  template <typename OperandLeft, typename OperandRight>
+  struct _leftmost_of<EStringConcat<OperandLeft, OperandRight>> {
+    using type = typename EStringConcat<OperandLeft, OperandRight>::_leftmost_type;
+  };
+
+  using _leftmost_type = typename _leftmost_of<Left>::type;
+
+  template <typename Other>
+  struct _is_concat : std::false_type {};
+
+  template <typename OtherLeft, typename OtherRight>
+  struct _is_concat<EStringConcat<OtherLeft, OtherRight>> : std::true_type {};
+
+  constexpr _leftmost_type& _leftmost() noexcept {
+    if constexpr (std::is_same_v<Left, _leftmost_type>)
+      return m_left;
+    else
+      return m_left._leftmost();
+  }
+
+  constexpr size_type _length_after_leftmost() const {
+    if constexpr (std::is_same_v<Left, _leftmost_type>)
+      return m_right.length();
+    else
+      return m_left._length_after_leftmost() + m_right.length();
+  }
+
+  constexpr char32_t* _write_after_leftmost(char32_t* dest) const {
+    if constexpr (std::is_same_v<Left, _leftmost_type>)
+      return m_right.write(dest);
+    else
+      return m_right.write(m_left._write_after_leftmost(dest));
+  }
+
+  bool _is_overlapping_after_leftmost(const void* buffer_begin, const void* buffer_end) const noexcept {
+    if constexpr (std::is_same_v<Left, _leftmost_type>)
+      return m_right.is_overlapping(buffer_begin, buffer_end);
+    else
+      return m_left._is_overlapping_after_leftmost(buffer_begin, buffer_end) || m_right.is_overlapping(buffer_begin, buffer_end);
+  }
+
+  template <typename Allocator>
+  constexpr BasicEString<Allocator> _materialize_to_new_buffer(Allocator const& allocator) const {
+    BasicEString<Allocator> string(allocator);
+
+    string.resize_and_overwrite(length(), [this](char32_t* buffer, size_type count) {
+      write(buffer);
+      return count;
+    });
+
+    return string;
+  }
+
+private:
+  Left m_left;
+  Right m_right;
+};
+
+template <typename Allocator>
+constexpr _EStringConcatView _concat_operand(BasicEString<Allocator> const& string) noexcept {
+  return { string };
 }
 
+template <typename Allocator>
+constexpr _EStringConcatOwned<Allocator> _concat_operand(BasicEString<Allocator>&& string) noexcept {
+  return { std::move(string) };
+}
+
+constexpr _EStringConcatView _concat_operand(EStringView string) noexcept {
+  return { string };
+}
+
+constexpr _EStringConcatView _concat_operand(const char32_t* string) noexcept {
+  return { EStringView(string) };
+}
+
+template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType> && !std::is_same_v<CharType, char32_t>>>
+constexpr _EStringConcatEncoded<CharType> _concat_operand(const CharType* string) noexcept {
+  return { string, EncodingTraits<CharType>::str_length(string) };
+}
+
+template <typename CharType, typename Traits, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+constexpr auto _concat_operand(std::basic_string_view<CharType, Traits> string) noexcept {
+  if constexpr (std::is_same_v<CharType, char32_t>)
+    return _EStringConcatView{ EStringView(string.data(), string.size()) };
+  else
+    return _EStringConcatEncoded<CharType>{ string.data(), string.size() };
+}
+
+template <typename CharType, typename Traits, typename StringAllocator, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+constexpr auto _concat_operand(std::basic_string<CharType, Traits, StringAllocator> const& string) noexcept {
+  return _concat_operand(std::basic_string_view<CharType, Traits>(string));
+}
+
+template <typename CharType, typename Traits, typename StringAllocator, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+constexpr _EStringConcatStlString<CharType, Traits, StringAllocator> _concat_operand(std::basic_string<CharType, Traits, StringAllocator>&& string) noexcept {
+  return { std::move(string) };
+}
+
+template <typename Left, typename Right>
+constexpr EStringConcat<Left, Right> _concat_operand(EStringConcat<Left, Right>&& concat) noexcept {
+  return std::move(concat);
+}
+
+template <typename Left, typename Right>
+constexpr EStringConcat<Left, Right> _concat_operand(EStringConcat<Left, Right> const& concat) {
+  return concat;
+}
+
+template <typename Left, typename Right>
+using _EStringConcatOf = EStringConcat<
+  decltype(_concat_operand(std::declval<Left>())),
+  decltype(_concat_operand(std::declval<Right>()))
+>;
+
+template <typename Allocator, typename Right>
+constexpr auto operator+(BasicEString<Allocator> const& left, Right&& right) -> _EStringConcatOf<BasicEString<Allocator> const&, Right&&> {
+  return { _concat_operand(left), _concat_operand(std::forward<Right>(right)) };
+}
+
+template <typename Allocator, typename Right>
+constexpr auto operator+(BasicEString<Allocator>&& left, Right&& right) -> _EStringConcatOf<BasicEString<Allocator>&&, Right&&> {
+  auto right_operand = _concat_operand(std::forward<Right>(right));
+
+  // Right operand refers to 'left' (e.g. 'std::move(s) + s'), and moving 'left' would empty it.
+  // 'left' is copied then.
+  if (std::is_constant_evaluated() || right_operand.is_overlapping(left.data(), left.data() + left.capacity()))
+    return { _EStringConcatOwned<Allocator>{ left }, std::move(right_operand) };
+
+  return { _concat_operand(std::move(left)), std::move(right_operand) };
+}
+
+template <typename Left, typename Right, typename Operand>
+constexpr auto operator+(EStringConcat<Left, Right>&& left, Operand&& right) -> _EStringConcatOf<EStringConcat<Left, Right>&&, Operand&&> {
+  return { std::move(left), _concat_operand(std::forward<Operand>(right)) };
+}
+
+// Strings and views on the left side of string.
+template <typename Allocator>
+constexpr auto operator+(const char32_t* left, BasicEString<Allocator> const& right) -> EStringConcat<_EStringConcatView, _EStringConcatView> {
+  return { _concat_operand(left), _concat_operand(right) };
+}
+
+template <typename Allocator>
+constexpr auto operator+(EStringView left, BasicEString<Allocator> const& right) -> EStringConcat<_EStringConcatView, _EStringConcatView> {
+  return { _concat_operand(left), _concat_operand(right) };
+}
+
+template <typename CharType, typename Allocator, typename = std::enable_if_t<has_encoding_traits_v<CharType> && !std::is_same_v<CharType, char32_t>>>
+constexpr auto operator+(const CharType* left, BasicEString<Allocator> const& right) -> EStringConcat<_EStringConcatEncoded<CharType>, _EStringConcatView> {
+  return { _concat_operand(left), _concat_operand(right) };
+}
+
+template <typename Allocator, typename Left, typename Right>
+constexpr BasicEString<Allocator>& operator+=(BasicEString<Allocator>& string, EStringConcat<Left, Right> const& concat) {
+  typename BasicEString<Allocator>::size_type prefix_length = string.length();
+
+  // Operands refer to the string itself (e.g. 's += s + t'), and reallocation would free them before they're written.
+  // Result is built in new buffer then.
+  if (std::is_constant_evaluated() || concat.is_overlapping(string.data(), string.data() + string.capacity())) {
+    BasicEString<Allocator> result(string.get_allocator());
+
+    result.resize_and_overwrite(prefix_length + concat.length(), [&string, &concat](char32_t* buffer, size_t count) {
+      concat.write(_EStringConcatView{ string }.write(buffer));
+      return count;
+    });
+
+    string = std::move(result);
+
+    return string;
+  }
+
+  string.resize_and_overwrite(prefix_length + concat.length(), [&concat, prefix_length](char32_t* buffer, size_t count) {
+    concat.write(buffer + prefix_length);
+    return count;
+  });
+
+  return string;
+}
+
+// Append formatted arguments to string. Arguments are written straight to its buffer.
+template <typename Allocator, typename... Args>
+BasicEString<Allocator>& format_to(BasicEString<Allocator>& string, EFormatString<std::type_identity_t<Args>...> format_string, Args const&... args) {
+  const _EFormatArg format_args[sizeof...(Args) + 1] = { _make_format_arg(args)..., _EFormatArg() };
+
+  // Arguments refer to the string itself, and reallocation would free them before they're written.
+  // Arguments are formatted to copy of string then.
+  for (_EFormatArg const& format_arg : format_args) {
+    if (format_arg.is_overlapping(string.data(), string.data() + string.capacity())) {
+      BasicEString<Allocator> result(string);
+      format_to(result, format_string, args...);
+      string = std::move(result);
+
+      return string;
+    }
+  }
+
+  typename BasicEString<Allocator>::size_type prefix_length = string.length();
+  size_t size_bound = _EFormatter::size_bound(format_string.get(), format_args);
+
+  string.resize_and_overwrite(prefix_length + size_bound, [&](char32_t* buffer, size_t) {
+    return static_cast<size_t>(_EFormatter::write(format_string.get(), format_args, buffer + prefix_length) - buffer);
+  });
+
+  return string;
+}
+
+template <typename Allocator>
+struct std::hash<BasicEString<Allocator>> {
+  size_t operator()(BasicEString<Allocator> const& string) const noexcept {
+    return string.hash();
+  }
+};
+
+// Transparent hash for unordered containers keyed by EString.
+// Allows to look up keys by EStringView, utf32 and encoded strings without building EString,
+//  when used together with 'EStringEqual'.
+// Malformed encoded keys are hashed without throwing, and then don't match any key.
+struct EStringHash {
+  using is_transparent = void;
+
+  template <typename Allocator>
+  size_t operator()(BasicEString<Allocator> const& string) const noexcept {
+    return string.hash();
+  }
+
+  size_t operator()(EStringView string) const noexcept {
+    return _EStringHasher::hash(string.data(), string.length());
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  size_t operator()(const CharType* string) const {
+    return _EStringHasher::hash_encoded(string, EncodingTraits<CharType>::str_length(string));
+  }
+
+  template <typename CharType>
+  size_t operator()(std::basic_string_view<CharType, std::char_traits<CharType>> string) const {
+    return _EStringHasher::hash_encoded(string.data(), string.length());
+  }
+
+  template <typename CharType>
+  size_t operator()(std::basic_string<CharType, std::char_traits<CharType>> const& string) const {
+    return _EStringHasher::hash_encoded(string.data(), string.length());
+  }
+};
+
+// Transparent equality for unordered containers keyed by EString. See 'EStringHash'.
+struct EStringEqual {
+  using is_transparent = void;
+
+  bool operator()(EStringView left, EStringView right) const noexcept {
+    return left == right;
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  bool operator()(EStringView left, const CharType* right) const {
+    return _is_equal_encoded(left, right, EncodingTraits<CharType>::str_length(right));
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  bool operator()(const CharType* left, EStringView right) const {
+    return _is_equal_encoded(right, left, EncodingTraits<CharType>::str_length(left));
+  }
+
+  template <typename CharType>
+  bool operator()(EStringView left, std::basic_string_view<CharType, std::char_traits<CharType>> right) const {
+    return _is_equal_encoded(left, right.data(), right.length());
+  }
+
+  template <typename CharType>
+  bool operator()(std::basic_string_view<CharType, std::char_traits<CharType>> left, EStringView right) const {
+    return _is_equal_encoded(right, left.data(), left.length());
+  }
+
+  template <typename CharType>
+  bool operator()(EStringView left, std::basic_string<CharType, std::char_traits<CharType>> const& right) const {
+    return _is_equal_encoded(left, right.data(), right.length());
+  }
+
+  template <typename CharType>
+  bool operator()(std::basic_string<CharType, std::char_traits<CharType>> const& left, EStringView right) const {
+    return _is_equal_encoded(right, left.data(), left.length());
+  }
+
+private:
+  // Compare utf32 string with encoded one, decoding it on the fly and stopping on first mismatch.
+  // Utf32 strings are compared as is, like 'EStringHash' hashes them.
+  template <typename CharType>
+  static bool _is_equal_encoded(EStringView string, const CharType* encoded_string, size_t encoded_string_length_in_chars) {
+    if constexpr (std::is_same_v<CharType, char32_t>)
+      return string == EStringView(encoded_string, encoded_string_length_in_chars);
+    else
+      return _match_encoded_prefix(string.data(), string.length(), encoded_string, encoded_string_length_in_chars) == string.length();
+  }
+};
+
 std::basic_istream<char, std::char_traits<char>>& operator>>(std::basic_istream<char, std::char_traits<char>>& stream, EString& out_str);
@@ -0,0 +1,205 @@
+#pragma once
+#define EString_EStringBuilder_h_
+
+#include <stddef.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EString.h"
+
+// Accumulates string of unknown length, without reallocating and copying what is already appended.
+// Characters are appended to list of fixed-size chunks, and are copied only once,
+//  when result is built by 'to_estring()' or encoded by 'encode()'.
+// Encoded strings are decoded straight to chunks.
+class EStringBuilder {
+public:
+  using size_type = size_t;
+
+  // Characters in one chunk. Strings longer than chunk get chunk of their own size.
+  static constexpr size_type default_chunk_size = 4096;
+
+public:
+  explicit EStringBuilder(size_type chunk_size = default_chunk_size) noexcept
+    : m_chunk_size(chunk_size ? chunk_size : 1) {}
+
+public:
+  EStringBuilder& append(EStringView string) {
+    const char32_t* source = string.data();
+    size_type remaining_length = string.length();
+
+    while (remaining_length != 0) {
+      _Chunk& chunk = _chunk_with_space(remaining_length);
+      size_type length = std::min(remaining_length, chunk.capacity - chunk.length);
+
+      memcpy(chunk.data.get() + chunk.length, source, length * sizeof(char32_t));
+
+      chunk.length += length;
+      m_length += length;
+      source += length;
+      remaining_length -= length;
+    }
+
+    return *this;
+  }
+
+  EStringBuilder& append(const char32_t* string) {
+    return append(EStringView(string));
+  }
+
+  template <typename Allocator>
+  EStringBuilder& append(BasicEString<Allocator> const& string) {
+    return append(EStringView(string));
+  }
+
+  EStringBuilder& append(char32_t character) {
+    return append(EStringView(&character, 1));
+  }
+
+  // Decode string to free space of chunks, splitting it at character boundaries.
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType> && !std::is_same_v<CharType, char32_t>>>
+  EStringBuilder& append(const CharType* encoded_string, size_type encoded_string_length_in_chars) {
+    using encoding_traits = EncodingTraits<CharType>;
+
+    while (encoded_string_length_in_chars != 0) {
+      _Chunk& chunk = _chunk_with_space(encoded_string_length_in_chars);
+
+      // Every character takes at least one 'CharType', so decoded part fits into free space.
+      size_type free_length = chunk.capacity - chunk.length;
+      size_type part_length = encoded_string_length_in_chars;
+
+      if (part_length > free_length) {
+        part_length = _complete_length<CharType>(encoded_string, free_length);
+
+        // Character doesn't fit to the end of chunk, continue in new one.
+        if (part_length == 0) {
+          _add_chunk(encoded_string_length_in_chars);
+          continue;
+        }
+      }
+
+      size_type decoded_length = encoding_traits::to_utf32(encoded_string, part_length, chunk.data.get() + chunk.length);
+
+      chunk.length += decoded_length;
+      m_length += decoded_length;
+      encoded_string += part_length;
+      encoded_string_length_in_chars -= part_length;
+    }
+
+    return *this;
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType> && !std::is_same_v<CharType, char32_t>>>
+  EStringBuilder& append(const CharType* encoded_string) {
+    return append(encoded_string, EncodingTraits<CharType>::str_length(encoded_string));
+  }
+
+  template <typename CharType>
+  EStringBuilder& append(std::basic_string<CharType, std::char_traits<CharType>> const& encoded_string) {
+    if constexpr (std::is_same_v<CharType, char32_t>)
+      return append(EStringView(encoded_string.data(), encoded_string.length()));
+    else
+      return append(encoded_string.data(), encoded_string.length());
+  }
+
+  template <typename String>
+  EStringBuilder& operator+=(String const& string) {
+    return append(string);
+  }
+
+public:
+  size_type length() const noexcept {
+    return m_length;
+  }
+
+  size_type size() const noexcept {
+    return m_length;
+  }
+
+  bool is_empty() const noexcept {
+    return m_length == 0;
+  }
+
+  // Remove all characters and free chunks.
+  void clear() noexcept {
+    m_chunks.clear();
+    m_length = 0;
+  }
+
+  // Call 'callback(EStringView)' for every chunk, from first to last.
+  template <typename Callback>
+  void for_each_chunk(Callback&& callback) const {
+    for (_Chunk const& chunk : m_chunks)
+      callback(EStringView(chunk.data.get(), chunk.length));
+  }
+
+  // Copy all characters to string with exactly allocated buffer.
+  template <typename Allocator = std::allocator<char32_t>>
+  BasicEString<Allocator> to_estring(Allocator const& allocator = Allocator()) const {
+    BasicEString<Allocator> string(allocator);
+
+    string.resize_and_overwrite(m_length, [this](char32_t* buffer, size_type count) {
+      for_each_chunk([&buffer](EStringView chunk) {
+        memcpy(buffer, chunk.data(), chunk.length() * sizeof(char32_t));
+        buffer += chunk.length();
+      });
+
+      return count;
+    });
+
+    return string;
+  }
+
+  // Encode chunks straight to result, without building EString.
+  template <typename CharType>
+  std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encode() const {
+    using encoding_traits = EncodingTraits<CharType>;
+
+    size_type encoded_length = 0;
+
+    for_each_chunk([&encoded_length](EStringView chunk) {
+      encoded_length += _encoded_length<CharType>(chunk.data(), chunk.length());
+    });
+
+    std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encoded_string;
+    encoded_string.resize(encoded_length);
+
+    CharType* dest = encoded_string.data();
+
+    for_each_chunk([&dest](EStringView chunk) {
+      dest += encoding_traits::from_utf32(chunk.data(), chunk.length(), dest);
+    });
+
+    return encoded_string;
+  }
+
+private:
+  struct _Chunk {
+    // Not initialized beyond 'length'.
+    std::unique_ptr<char32_t[]> data;
+    size_type length;
+    size_type capacity;
+  };
+
+  void _add_chunk(size_type min_capacity) {
+    size_type capacity = std::max(m_chunk_size, min_capacity);
+
+    m_chunks.push_back(_Chunk{ std::make_unique_for_overwrite<char32_t[]>(capacity), 0, capacity });
+  }
+
+  // Get last chunk, adding new one if it's full.
+  _Chunk& _chunk_with_space(size_type wanted_length) {
+    if (m_chunks.empty() || m_chunks.back().length == m_chunks.back().capacity)
+      _add_chunk(wanted_length);
+
+    return m_chunks.back();
+  }
+
+private:
+  size_type m_chunk_size;
+  std::vector<_Chunk> m_chunks;
+  size_type m_length = 0;
+};
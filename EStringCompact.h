@@ -0,0 +1,723 @@
+#pragma once
+#define EString_EStringCompact_h_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <utility>
+
+#include "EString.h"
+
+// String that stores each character in 1, 2 or 4 bytes (Latin-1, UCS-2 or UTF-32),
+//  depending on the largest character in it, like CPython's flexible string representation.
+// Storage is widened when a character that doesn't fit is added, and narrowed back
+//  only by 'shrink_to_fit()'.
+// Characters are returned by value, because narrow storage has no 'char32_t' to reference,
+//  so use 'set()' instead of assigning through 'operator[]'.
+class ECompactString {
+public:
+  using size_type = size_t;
+
+  // Returned by 'find()' when nothing is found.
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+public:
+  ECompactString() = default;
+
+  ECompactString(const char32_t* utf32_string) : ECompactString() {
+    append(utf32_string);
+  }
+
+  ECompactString(const char32_t* utf32_string, size_type string_size_in_chars) : ECompactString() {
+    append(utf32_string, string_size_in_chars);
+  }
+
+  ECompactString(EString const& string) : ECompactString() {
+    append(string);
+  }
+
+  template <typename CharType>
+  ECompactString(const CharType* encoded_string, size_type encoded_string_length_in_chars) : ECompactString() {
+    decode(encoded_string, encoded_string_length_in_chars);
+  }
+
+  template <typename CharType>
+  ECompactString(const CharType* encoded_string) : ECompactString(encoded_string, EncodingTraits<CharType>::str_length(encoded_string)) {}
+
+  template <typename CharType>
+  ECompactString(std::basic_string<CharType, std::char_traits<CharType>> const& encoded_string) : ECompactString(encoded_string.c_str(), encoded_string.length()) {}
+
+  ECompactString(ECompactString const& other) : ECompactString() {
+    operator=(other);
+  }
+
+  ECompactString(ECompactString&& other) noexcept {
+    operator=(std::move(other));
+  }
+
+  ECompactString& operator=(ECompactString const& other) {
+    if (this == &other)
+      return *this;
+
+    m_length = 0;
+
+    // Storage takes width of other string, so its characters are copied as is.
+    if (m_width != other.m_width)
+      _reallocate(other.m_width, other.m_length);
+    else
+      _need_allocated(other.m_width, other.m_length);
+
+    if (other.m_length > 0)
+      memcpy(m_buffer, other.m_buffer, other.m_length * other.m_width);
+
+    m_length = other.m_length;
+
+    return *this;
+  }
+
+  ECompactString& operator=(ECompactString&& other) noexcept {
+    if (this == &other)
+      return *this;
+
+    _free(m_buffer, m_width);
+
+    m_buffer = other.m_buffer;
+    m_length = other.m_length;
+    m_allocated = other.m_allocated;
+    m_width = other.m_width;
+    other.m_buffer = nullptr;
+    other.m_length = 0;
+    other.m_allocated = 0;
+    other.m_width = 1;
+
+    return *this;
+  }
+
+  ~ECompactString() {
+    _free(m_buffer, m_width);
+  }
+
+public:
+  template <typename CharType>
+  std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encode() const {
+    using encoding_traits = EncodingTraits<CharType>;
+    using string_type = std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>>;
+
+    string_type encoded_string;
+
+    if (m_width == 4) {
+      const char32_t* characters = static_cast<const char32_t*>(m_buffer);
+
+      encoded_string.resize(_encoded_length<CharType>(characters, m_length));
+      encoding_traits::from_utf32(characters, m_length, encoded_string.data());
+
+      return encoded_string;
+    }
+
+    // Narrow storage is widened in chunks, so encoding needs no full-size utf32 copy.
+    char32_t chunk[chunk_size];
+    size_type encoded_length = 0;
+
+    for (size_type index = 0; index < m_length; index += chunk_size) {
+      size_type count = _widen_chunk(index, chunk);
+      encoded_length += _encoded_length<CharType>(chunk, count);
+    }
+
+    encoded_string.resize(encoded_length);
+
+    CharType* dest = encoded_string.data();
+
+    for (size_type index = 0; index < m_length; index += chunk_size) {
+      size_type count = _widen_chunk(index, chunk);
+      dest += encoding_traits::from_utf32(chunk, count, dest);
+    }
+
+    return encoded_string;
+  }
+
+  // Throws 'encoding_failed' on invalid character, leaving string unchanged.
+  template <typename CharType>
+  void decode(const CharType* encoded_string, size_type encoded_string_length_in_chars) {
+    // Decoded into separate string, so invalid character in the middle doesn't leave this one partly decoded.
+    ECompactString string;
+    string._need_allocated(1, _utf32_length<CharType>(encoded_string, encoded_string_length_in_chars));
+    string.append(encoded_string, encoded_string_length_in_chars);
+
+    operator=(std::move(string));
+  }
+
+  template <typename CharType>
+  void decode(const CharType* encoded_string) {
+    decode(encoded_string, EncodingTraits<CharType>::str_length(encoded_string));
+  }
+
+  // Convert to EString, widening characters to utf32.
+  EString to_estring() const {
+    EString string;
+    string.reserve(m_length + 1);
+
+    char32_t chunk[chunk_size];
+
+    for (size_type index = 0; index < m_length; index += chunk_size)
+      string.append(chunk, _widen_chunk(index, chunk));
+
+    return string;
+  }
+
+public:
+  // Number of bytes used to store each character: 1, 2 or 4.
+  size_type width() const noexcept {
+    return m_width;
+  }
+
+  bool is_empty() const noexcept {
+    return m_length == 0;
+  }
+
+  size_type length() const noexcept {
+    return m_length;
+  }
+
+  size_type size() const noexcept {
+    return m_length;
+  }
+
+  size_type capacity() const noexcept {
+    return m_allocated;
+  }
+
+  void reserve(size_type count) {
+    _need_allocated(m_width, count);
+  }
+
+  // Release unused space and narrow storage to the smallest width that fits all characters.
+  void shrink_to_fit() {
+    size_type width = 1;
+
+    for (size_type index = 0; index < m_length && width < 4; ++index) {
+      size_type character_width = _width_for(_get(index));
+
+      if (character_width > width)
+        width = character_width;
+    }
+
+    if (width != m_width || m_allocated != m_length)
+      _reallocate(width, m_length);
+  }
+
+  void clear() noexcept {
+    m_length = 0;
+  }
+
+  char32_t front() const noexcept {
+    return _get(0);
+  }
+
+  char32_t back() const noexcept {
+    return _get(m_length - 1);
+  }
+
+  char32_t operator[](size_type index) const noexcept {
+    return _get(index);
+  }
+
+  // Replace character at 'index', widening storage if needed.
+  void set(size_type index, char32_t character) {
+    _need_allocated(_width_for(character), m_length);
+    _set(index, character);
+  }
+
+  ECompactString& insert(size_type index, const char32_t* string, size_type string_length_in_characters) {
+    if (string_length_in_characters == 0)
+      return *this;
+
+    _need_allocated(_max_width(string, string_length_in_characters), m_length + string_length_in_characters);
+
+    char* bytes = static_cast<char*>(m_buffer);
+    memmove(bytes + (index + string_length_in_characters) * m_width, bytes + index * m_width, (m_length - index) * m_width);
+
+    for (size_type i = 0; i < string_length_in_characters; ++i)
+      _set(index + i, string[i]);
+
+    m_length += string_length_in_characters;
+
+    return *this;
+  }
+
+  ECompactString& insert(size_type index, char32_t character) {
+    return insert(index, &character, 1);
+  }
+
+  ECompactString& insert(size_type index, const char32_t* string) {
+    return insert(index, string, Utf32EncodingTraits::str_length(string));
+  }
+
+  ECompactString& insert(size_type index, EString const& string) {
+    return insert(index, string.data(), string.length());
+  }
+
+  ECompactString& erase(size_type index, size_type count) noexcept {
+    if (index >= m_length || index + count > m_length)
+      return *this;
+
+    char* bytes = static_cast<char*>(m_buffer);
+    memmove(bytes + index * m_width, bytes + (index + count) * m_width, (m_length - index - count) * m_width);
+
+    m_length -= count;
+
+    return *this;
+  }
+
+  ECompactString& append(const char32_t* string, size_type string_length_in_characters) {
+    return insert(m_length, string, string_length_in_characters);
+  }
+
+  ECompactString& append(const char32_t* string) {
+    return append(string, Utf32EncodingTraits::str_length(string));
+  }
+
+  ECompactString& append(EString const& string) {
+    return append(string.data(), string.length());
+  }
+
+  ECompactString& append(ECompactString const& string) {
+    size_type string_length = string.m_length;
+
+    if (string_length == 0)
+      return *this;
+
+    if (string.m_width == m_width) {
+      _need_allocated(m_width, m_length + string_length);
+      memcpy(static_cast<char*>(m_buffer) + m_length * m_width, string.m_buffer, string_length * m_width);
+      m_length += string_length;
+
+      return *this;
+    }
+
+    char32_t chunk[chunk_size];
+
+    for (size_type index = 0; index < string_length; index += chunk_size)
+      append(chunk, string._widen_chunk(index, chunk));
+
+    return *this;
+  }
+
+  // Characters are checked like 'EString' checks them. On invalid one throws 'encoding_failed', leaving string unchanged.
+  template <typename CharType>
+  ECompactString& append(const CharType* string, size_type string_length_in_characters) {
+    using encoding_traits = EncodingTraits<CharType>;
+
+    size_type old_length = m_length;
+
+    for (const CharType* end = string + string_length_in_characters; string != end;) {
+      char32_t character = 0;
+      EEncodingError error = EEncodingError::none;
+      size_type length = _decode_encoded_char_checked(string, static_cast<size_type>(end - string), character, error);
+
+      if (length == 0) {
+        m_length = old_length;
+        throw encoding_failed(encoding_traits::encoding_name, error == EEncodingError::truncated ? _truncated_char_message<CharType>() : _encoding_error_message(error));
+      }
+
+      push_back(character);
+      string += length;
+    }
+
+    return *this;
+  }
+
+  template <typename CharType>
+  ECompactString& append(const CharType* string) {
+    return append(string, EncodingTraits<CharType>::str_length(string));
+  }
+
+  void push_back(char32_t character) {
+    size_type character_width = _width_for(character);
+
+    if (character_width > m_width || m_allocated == m_length)
+      _need_allocated(character_width, m_length + 1);
+
+    _set(m_length, character);
+    ++m_length;
+  }
+
+  char32_t pop_back() noexcept {
+    if (m_length == 0)
+      return 0;
+
+    return _get(--m_length);
+  }
+
+public:
+  // Search functions work on storage of its width: 1-byte storage is scanned by 'memchr()' and compared by 'memcmp()'
+  //  with pattern narrowed to bytes, 2-byte storage is widened in chunks. Pattern with characters wider than storage
+  //  can't be found, so it's rejected without scanning.
+  bool startswith(const char32_t* string, size_type string_length_in_characters) const noexcept {
+    return string_length_in_characters <= m_length && _is_range_equal(0, string, string_length_in_characters);
+  }
+
+  bool startswith(const char32_t* string) const noexcept {
+    return startswith(string, Utf32EncodingTraits::str_length(string));
+  }
+
+  bool startswith(EString const& string) const noexcept {
+    return startswith(string.data(), string.length());
+  }
+
+  bool endswith(const char32_t* string, size_type string_length_in_characters) const noexcept {
+    return string_length_in_characters <= m_length && _is_range_equal(m_length - string_length_in_characters, string, string_length_in_characters);
+  }
+
+  bool endswith(const char32_t* string) const noexcept {
+    return endswith(string, Utf32EncodingTraits::str_length(string));
+  }
+
+  bool endswith(EString const& string) const noexcept {
+    return endswith(string.data(), string.length());
+  }
+
+  bool contains(const char32_t* string, size_type string_length_in_characters) const noexcept {
+    return find(string, string_length_in_characters, 0) != npos;
+  }
+
+  bool contains(const char32_t* string) const noexcept {
+    return contains(string, Utf32EncodingTraits::str_length(string));
+  }
+
+  bool contains(EString const& string) const noexcept {
+    return contains(string.data(), string.length());
+  }
+
+  bool contains(char32_t character) const noexcept {
+    return find(character) != npos;
+  }
+
+  // Get index of first occurrence of 'character' at or after 'index', or 'npos'.
+  size_type find(char32_t character, size_type index = 0) const noexcept {
+    return find(&character, 1, index);
+  }
+
+  // Get index of first occurrence of 'string' at or after 'index', or 'npos'.
+  size_type find(const char32_t* string, size_type string_length_in_characters, size_type index) const noexcept {
+    if (index > m_length || string_length_in_characters > m_length - index)
+      return npos;
+
+    if (string_length_in_characters == 0)
+      return index;
+
+    if (_max_width(string, string_length_in_characters) > m_width)
+      return npos;
+
+    char32_t first_character = string[0];
+    // Last index where string still fits.
+    size_type last_index = m_length - string_length_in_characters;
+
+    while (index <= last_index) {
+      if (m_width == 1) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(m_buffer);
+        const void* found = memchr(bytes + index, static_cast<int>(first_character), last_index - index + 1);
+
+        if (!found)
+          return npos;
+
+        index = static_cast<size_type>(static_cast<const uint8_t*>(found) - bytes);
+      }
+      else {
+        while (index <= last_index && _get(index) != first_character)
+          ++index;
+
+        if (index > last_index)
+          return npos;
+      }
+
+      if (_is_range_equal(index + 1, string + 1, string_length_in_characters - 1))
+        return index;
+
+      ++index;
+    }
+
+    return npos;
+  }
+
+  size_type find(const char32_t* string, size_type index = 0) const noexcept {
+    return find(string, Utf32EncodingTraits::str_length(string), index);
+  }
+
+  size_type find(EString const& string, size_type index = 0) const noexcept {
+    return find(string.data(), string.length(), index);
+  }
+
+public:
+  bool operator==(ECompactString const& string) const noexcept {
+    if (m_length != string.m_length)
+      return false;
+
+    if (m_width == string.m_width)
+      return m_length == 0 || memcmp(m_buffer, string.m_buffer, m_length * m_width) == 0;
+
+    for (size_type index = 0; index < m_length; ++index)
+      if (_get(index) != string._get(index))
+        return false;
+
+    return true;
+  }
+
+  bool operator==(EString const& string) const noexcept {
+    return _is_str_equal(string.data(), string.length());
+  }
+
+  bool operator==(const char32_t* string) const noexcept {
+    return _is_str_equal(string, Utf32EncodingTraits::str_length(string));
+  }
+
+  // Invalid encoded characters don't match anything, like in 'EString::operator=='.
+  template <typename CharType>
+  bool operator==(const CharType* string) const {
+    const CharType* end = string + EncodingTraits<CharType>::str_length(string);
+
+    if (m_width == 4)
+      return _match_encoded_prefix(static_cast<const char32_t*>(m_buffer), m_length, string, static_cast<size_type>(end - string)) == m_length;
+
+    // Decode on the fly and stop on first mismatch.
+    size_type index = 0;
+
+    for (; string != end; ++index) {
+      char32_t character = 0;
+      EEncodingError error = EEncodingError::none;
+      size_type length = _decode_encoded_char_checked(string, static_cast<size_type>(end - string), character, error);
+
+      if (length == 0 || index >= m_length || _get(index) != character)
+        return false;
+
+      string += length;
+    }
+
+    return index == m_length;
+  }
+
+  bool operator!=(ECompactString const& string) const noexcept {
+    return !operator==(string);
+  }
+
+  bool operator!=(EString const& string) const noexcept {
+    return !operator==(string);
+  }
+
+  bool operator!=(const char32_t* string) const noexcept {
+    return !operator==(string);
+  }
+
+  template <typename CharType>
+  bool operator!=(const CharType* string) const {
+    return !operator==(string);
+  }
+
+private:
+  // Number of characters widened to utf32 at once by encoding and conversion.
+  static constexpr size_type chunk_size = 256;
+
+  static constexpr size_type _width_for(char32_t character) noexcept {
+    if (character <= 0xFF)
+      return 1;
+    else if (character <= 0xFFFF)
+      return 2;
+
+    return 4;
+  }
+
+  static constexpr size_type _max_width(const char32_t* string, size_type string_length_in_characters) noexcept {
+    char32_t max_character = 0;
+
+    for (size_type index = 0; index < string_length_in_characters; ++index)
+      max_character |= string[index];
+
+    return _width_for(max_character);
+  }
+
+  static void* _allocate(size_type width, size_type count) {
+    if (count == 0)
+      return nullptr;
+
+    switch (width) {
+    case 1:
+      return new uint8_t[count];
+    case 2:
+      return new char16_t[count];
+    default:
+      return new char32_t[count];
+    }
+  }
+
+  static void _free(void* buffer, size_type width) noexcept {
+    switch (width) {
+    case 1:
+      delete[] static_cast<uint8_t*>(buffer);
+      break;
+    case 2:
+      delete[] static_cast<char16_t*>(buffer);
+      break;
+    default:
+      delete[] static_cast<char32_t*>(buffer);
+      break;
+    }
+  }
+
+  static char32_t _get(const void* buffer, size_type width, size_type index) noexcept {
+    switch (width) {
+    case 1:
+      return static_cast<const uint8_t*>(buffer)[index];
+    case 2:
+      return static_cast<const char16_t*>(buffer)[index];
+    default:
+      return static_cast<const char32_t*>(buffer)[index];
+    }
+  }
+
+  static void _set(void* buffer, size_type width, size_type index, char32_t character) noexcept {
+    switch (width) {
+    case 1:
+      static_cast<uint8_t*>(buffer)[index] = static_cast<uint8_t>(character);
+      break;
+    case 2:
+      static_cast<char16_t*>(buffer)[index] = static_cast<char16_t>(character);
+      break;
+    default:
+      static_cast<char32_t*>(buffer)[index] = character;
+      break;
+    }
+  }
+
+  char32_t _get(size_type index) const noexcept {
+    return _get(m_buffer, m_width, index);
+  }
+
+  // Store character at 'index'. Storage must be wide enough for it.
+  void _set(size_type index, char32_t character) noexcept {
+    _set(m_buffer, m_width, index, character);
+  }
+
+  // Widen up to 'chunk_size' characters starting at 'index' to 'dest'.
+  // Returns number of widened characters.
+  size_type _widen_chunk(size_type index, char32_t* dest) const noexcept {
+    size_type count = m_length - index < chunk_size ? m_length - index : chunk_size;
+
+    for (size_type i = 0; i < count; ++i)
+      dest[i] = _get(index + i);
+
+    return count;
+  }
+
+  // Assert that storage is at least 'width' bytes wide and can store 'size' characters.
+  // If not, reallocate it.
+  void _need_allocated(size_type width, size_type size) {
+    if (width <= m_width && size <= m_allocated)
+      return;
+
+    size_type want_allocate = m_allocated;
+
+    if (want_allocate < size) {
+      want_allocate = m_allocated + m_allocated / 2;
+
+      if (want_allocate < size)
+        want_allocate = size;
+    }
+
+    _reallocate(width > m_width ? width : m_width, want_allocate);
+  }
+
+  // Reallocate storage with 'new_width' bytes per character and space for 'new_size' characters,
+  //  converting existing characters to the new width.
+  void _reallocate(size_type new_width, size_type new_size) {
+    void* prev_buffer = m_buffer;
+    size_type prev_width = m_width;
+
+    m_buffer = _allocate(new_width, new_size);
+
+    if (new_width == prev_width) {
+      if (m_length > 0)
+        memcpy(m_buffer, prev_buffer, m_length * m_width);
+    }
+    else {
+      for (size_type index = 0; index < m_length; ++index)
+        _set(m_buffer, new_width, index, _get(prev_buffer, prev_width, index));
+    }
+
+    m_width = new_width;
+    m_allocated = new_size;
+
+    _free(prev_buffer, prev_width);
+  }
+
+  // Check is stored characters equal to utf32 'string'.
+  bool _is_str_equal(const char32_t* string, size_type string_size_in_utf32_chars) const noexcept {
+    if (string_size_in_utf32_chars != m_length)
+      return false;
+
+    if (m_width == 4)
+      return m_length == 0 || memcmp(m_buffer, string, m_length * sizeof(char32_t)) == 0;
+
+    for (size_type index = 0; index < m_length; ++index)
+      if (_get(index) != string[index])
+        return false;
+
+    return true;
+  }
+
+  // Check is characters starting at 'index' equal to utf32 'string'. Storage must have enough characters.
+  bool _is_range_equal(size_type index, const char32_t* characters, size_type count) const noexcept {
+    if (count == 0)
+      return true;
+
+    if (m_width == 4)
+      return memcmp(static_cast<const char32_t*>(m_buffer) + index, characters, count * sizeof(char32_t)) == 0;
+
+    if (m_width == 1) {
+      // Narrow string to bytes, so it's compared with storage as is.
+      uint8_t chunk[chunk_size];
+
+      for (size_type offset = 0; offset < count; offset += chunk_size) {
+        size_type chunk_count = count - offset < chunk_size ? count - offset : chunk_size;
+
+        for (size_type i = 0; i < chunk_count; ++i) {
+          if (characters[offset + i] > 0xFF)
+            return false;
+
+          chunk[i] = static_cast<uint8_t>(characters[offset + i]);
+        }
+
+        if (memcmp(static_cast<const uint8_t*>(m_buffer) + index + offset, chunk, chunk_count) != 0)
+          return false;
+      }
+
+      return true;
+    }
+
+    // Widen storage, so it's compared with string as is.
+    char32_t chunk[chunk_size];
+    const char16_t* words = static_cast<const char16_t*>(m_buffer) + index;
+
+    for (size_type offset = 0; offset < count; offset += chunk_size) {
+      size_type chunk_count = count - offset < chunk_size ? count - offset : chunk_size;
+
+      for (size_type i = 0; i < chunk_count; ++i)
+        chunk[i] = words[offset + i];
+
+      if (memcmp(chunk, characters + offset, chunk_count * sizeof(char32_t)) != 0)
+        return false;
+    }
+
+    return true;
+  }
+
+private:
+  // Buffer of 'm_allocated' characters, 'm_width' bytes each.
+  void* m_buffer = nullptr;
+  // Length of string in characters.
+  size_type m_length = 0;
+  // Size of allocated space in characters.
+  size_type m_allocated = 0;
+  // Bytes per character: 1 (Latin-1), 2 (UCS-2) or 4 (UTF-32).
+  size_type m_width = 1;
+};
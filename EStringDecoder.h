@@ -0,0 +1,104 @@
+#pragma once
+#define EString_EStringDecoder_h_
+
+#include <stddef.h>
+
+#include <string_view>
+
+#include "EString.h"
+
+// Incremental decoder of encoded stream, that arrives in chunks of any size.
+// Character split between chunks is kept inside decoder until the rest of it arrives,
+//  so chunks can be decoded as soon as they are read, e.g. from socket.
+// Decoded characters are appended to target string, which buffer grows geometrically.
+template <typename CharType>
+class EStringDecoder {
+public:
+  using encoding_traits = EncodingTraits<CharType>;
+  using size_type = size_t;
+
+public:
+  EStringDecoder() = default;
+
+public:
+  // Decode chunk and append decoded characters to 'target'.
+  // Throws 'encoding_failed' on invalid character. Decoder must be reset after that.
+  template <typename Allocator>
+  void decode(const CharType* chunk, size_type chunk_length_in_chars, BasicEString<Allocator>& target) {
+    if (m_pending_length != 0) {
+      size_type used_length = _complete_pending(chunk, chunk_length_in_chars, target);
+
+      chunk += used_length;
+      chunk_length_in_chars -= used_length;
+
+      if (m_pending_length != 0)
+        return;
+    }
+
+    size_type complete_length = _complete_length<CharType>(chunk, chunk_length_in_chars);
+
+    target.append(chunk, complete_length);
+
+    for (size_type index = complete_length; index < chunk_length_in_chars; ++index)
+      m_pending[m_pending_length++] = chunk[index];
+  }
+
+  template <typename Allocator>
+  void decode(std::basic_string_view<CharType> chunk, BasicEString<Allocator>& target) {
+    decode(chunk.data(), chunk.length(), target);
+  }
+
+  // End of stream. Throws 'encoding_failed' if last character is incomplete.
+  void finish() {
+    if (m_pending_length != 0) {
+      m_pending_length = 0;
+      throw encoding_failed(encoding_traits::encoding_name, "Truncated character at the end of stream.");
+    }
+  }
+
+  // Drop incomplete character and start new stream.
+  void reset() noexcept {
+    m_pending_length = 0;
+  }
+
+  // Check is there incomplete character, waiting for next chunk.
+  bool has_pending() const noexcept {
+    return m_pending_length != 0;
+  }
+
+  // Number of 'CharType' of incomplete character.
+  size_type pending_length() const noexcept {
+    return m_pending_length;
+  }
+
+private:
+  // Move characters from chunk to incomplete character. Returns number of moved characters.
+  template <typename Allocator>
+  size_type _complete_pending(const CharType* chunk, size_type chunk_length_in_chars, BasicEString<Allocator>& target) {
+    size_type char_length = encoding_traits::char_length(m_pending);
+    size_type used_length = 0;
+
+    for (; m_pending_length < char_length && used_length < chunk_length_in_chars; ++used_length)
+      m_pending[m_pending_length++] = chunk[used_length];
+
+    if (m_pending_length == char_length) {
+      // Joined character is checked like characters of whole chunks are.
+      char32_t character = 0;
+      EEncodingError error = EEncodingError::none;
+
+      m_pending_length = 0;
+
+      if (_decode_encoded_char_checked(m_pending, char_length, character, error) == 0)
+        throw encoding_failed(encoding_traits::encoding_name, error == EEncodingError::truncated ? _truncated_char_message<CharType>() : _encoding_error_message(error));
+
+      target.push_back(character);
+    }
+
+    return used_length;
+  }
+
+private:
+  // Beginning of character, that was split between chunks.
+  CharType m_pending[encoding_traits::max_encoded_size] = {};
+  size_type m_pending_length = 0;
+};
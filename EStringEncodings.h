@@ -12,10 +12,25 @@
 #include <stddef.h>
 
 #include <exception>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "EStringSimd.h"
 
 template <typename CharType>
 struct EncodingTraits;
 
+// Check is there encoding traits for 'CharType'.
+template <typename CharType, typename = void>
+struct has_encoding_traits : std::false_type {};
+
+template <typename CharType>
+struct has_encoding_traits<CharType, std::void_t<decltype(EncodingTraits<CharType>::encoding_name)>> : std::true_type {};
+
+template <typename CharType>
+inline constexpr bool has_encoding_traits_v = has_encoding_traits<CharType>::value;
+
 // Throws when String::encode() or String::decode() failed.
 class encoding_failed : public std::exception {
 public:
@@ -30,6 +45,49 @@ private:
   const char* m_target_encoding;
 };
 
+// Kind of first invalid character, found by 'validate()'.
+enum class EEncodingError {
+  none,
+  // String ends in the middle of character.
+  truncated,
+  // Utf8 continuation byte without lead byte.
+  unexpected_continuation,
+  // Utf8 lead byte isn't followed by enough continuation bytes.
+  missing_continuation,
+  // Utf8 character is encoded with more bytes than needed.
+  overlong,
+  // Surrogate code point, encoded in utf8 or utf32.
+  surrogate,
+  // Code point is above 0x10FFFF.
+  too_large,
+  // Utf16 surrogate without its pair.
+  unpaired_surrogate,
+  // Character can't be represented in encoding.
+  invalid_character
+};
+
+// Result of 'validate()'.
+struct EValidationResult {
+  bool is_valid = true;
+  // Offset of first invalid character in encoded characters, or string length if string is valid.
+  size_t error_offset = 0;
+  EEncodingError error_kind = EEncodingError::none;
+};
+
+constexpr const char* _encoding_error_message(EEncodingError error) noexcept {
+  switch (error) {
+    case EEncodingError::truncated: return "Truncated character.";
+    case EEncodingError::unexpected_continuation: return "Unexpected continuation byte.";
+    case EEncodingError::missing_continuation: return "Missing continuation byte.";
+    case EEncodingError::overlong: return "Overlong character encoding.";
+    case EEncodingError::surrogate: return "Encoded surrogate code point.";
+    case EEncodingError::too_large: return "Invalid UNICODE character.";
+    case EEncodingError::unpaired_surrogate: return "Invalid UTF-16 surrogate pair.";
+    case EEncodingError::invalid_character: return "Invalid character.";
+    default: return "";
+  }
+}
+
 // Example of encoding traits.
 struct AsciiEncodingTraits {
   using encoded_char_type = char; // Minimal encoding unit.
@@ -102,6 +160,36 @@ struct AsciiEncodingTraits {
 
     return length;
   }
+
+  // Optional. Get number of 'char32_t' that 'to_utf32()' will write for given string.
+  // Used to allocate exact space before decoding.
+  static constexpr size_type utf32_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) {
+    (void)encoded_string;
+    return encoded_string_size_in_chars;
+  }
+
+  // Optional. Get number of 'encoded_char_type' that 'from_utf32()' will write for given string.
+  // Used to allocate exact space before encoding.
+  static constexpr size_type encoded_length(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars) {
+    (void)decoded_string;
+    return decoded_string_size_in_utf32_chars;
+  }
+
+  // Optional. Get length of longest prefix of string in 'encoded_char_type', that doesn't end with incomplete character.
+  // Used to decode strings, that arrive in chunks.
+  static constexpr size_type complete_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    (void)encoded_string;
+    return encoded_string_size_in_chars;
+  }
+
+  // Optional. Find first invalid character of string without throwing, see 'validate()'.
+  static constexpr EValidationResult validate(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    for (size_type index = 0; index < encoded_string_size_in_chars; ++index)
+      if (static_cast<unsigned char>(encoded_string[index]) > 0x7F)
+        return { false, index, EEncodingError::invalid_character };
+
+    return { true, encoded_string_size_in_chars, EEncodingError::none };
+  }
 };
 
 struct Utf8EncodingTraits {
@@ -125,6 +213,9 @@ struct Utf8EncodingTraits {
       return 2;
     }
     else if (original_char <= 0xFFFF) {
+      if ((original_char & 0xF800) == 0xD800)
+        throw encoding_failed(encoding_name, _encoding_error_message(EEncodingError::surrogate));
+
       dest[2] = static_cast<char8_t>(0x80 | (original_char & 0x3F));
       original_char >>= 6;
       dest[1] = static_cast<char8_t>(0x80 | (original_char & 0x3F));
@@ -183,30 +274,142 @@ struct Utf8EncodingTraits {
 
   static constexpr size_type from_utf32(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars, encoded_char_type* dest) {
     const encoded_char_type* begin = dest;
+    const char32_t* end = decoded_string + decoded_string_size_in_utf32_chars;
 
-    for (
-      const char32_t* end = decoded_string + decoded_string_size_in_utf32_chars;
-      decoded_string != end;
-      ++decoded_string, dest += char_length(dest)
-      )
-      char_from_utf32(decoded_string[0], dest);
+    while (decoded_string != end) {
+      if (!std::is_constant_evaluated()) {
+        // Encode whole blocks of same-sized characters at once.
+        size_type written_size = 0;
+        size_type block_length = _simd_utf32_to_utf8_blocks(decoded_string, static_cast<size_type>(end - decoded_string), dest, written_size);
+
+        decoded_string += block_length;
+        dest += written_size;
+
+        if (decoded_string == end)
+          break;
+      }
+
+      dest += char_from_utf32(decoded_string[0], dest);
+      ++decoded_string;
+    }
 
     return static_cast<size_type>(dest - begin);
   }
 
+  static constexpr size_type encoded_length(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars) {
+    if (!std::is_constant_evaluated())
+      return _simd_utf8_encoded_length(decoded_string, decoded_string_size_in_utf32_chars);
+
+    size_type length = decoded_string_size_in_utf32_chars;
+
+    for (size_type index = 0; index < decoded_string_size_in_utf32_chars; ++index) {
+      char32_t character = decoded_string[index];
+      length += (character > 0x7F) + (character > 0x7FF) + (character > 0xFFFF);
+    }
+
+    return length;
+  }
+
+  // With SIMD validator string is validated at once and then decoded without checking every character,
+  //  otherwise characters are checked while decoding.
   static constexpr size_type to_utf32(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars, char32_t* dest) {
+    if (!std::is_constant_evaluated() && _simd_has_utf8_validator) {
+      EValidationResult validation = validate(encoded_string, encoded_string_size_in_chars);
+
+      if (!validation.is_valid)
+        throw encoding_failed(encoding_name, _encoding_error_message(validation.error_kind));
+
+      return _to_utf32_valid(encoded_string, encoded_string_size_in_chars, dest);
+    }
+
     const char32_t* begin = dest;
+    const encoded_char_type* end = encoded_string + encoded_string_size_in_chars;
 
-    for (
-      const encoded_char_type* end = encoded_string + encoded_string_size_in_chars;
-      encoded_string != end;
-      ++dest, encoded_string += char_length(encoded_string)
-      )
-      dest[0] = char_to_utf32(encoded_string);
+    while (encoded_string != end) {
+      if (!std::is_constant_evaluated() && (encoded_string[0] & 0x80) == 0) {
+        // Widen whole run of ASCII characters at once.
+        size_type ascii_length = _simd_utf8_widen_ascii(encoded_string, static_cast<size_type>(end - encoded_string), dest);
+
+        encoded_string += ascii_length;
+        dest += ascii_length;
+
+        if (encoded_string == end)
+          break;
+      }
+
+      // Two-byte characters (e.g. Cyrillic) need no range checks except of lead byte.
+      encoded_char_type lead_byte = encoded_string[0];
+
+      if (lead_byte >= 0xC2 && lead_byte < 0xE0 && end - encoded_string >= 2 && (encoded_string[1] & 0xC0) == 0x80) {
+        *dest++ = (static_cast<char32_t>(lead_byte & 0x1F) << 6) | (encoded_string[1] & 0x3F);
+        encoded_string += 2;
+        continue;
+      }
+
+      EEncodingError error = EEncodingError::none;
+      size_type length = _decode_char_checked(encoded_string, static_cast<size_type>(end - encoded_string), dest[0], error);
+
+      if (length == 0)
+        throw encoding_failed(encoding_name, _encoding_error_message(error));
+
+      ++dest;
+      encoded_string += length;
+    }
 
     return static_cast<size_type>(dest - begin);
   }
 
+  static constexpr EValidationResult validate(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    // Valid prefix is skipped by SIMD validator, the rest is checked here to find exact error.
+    size_type index = std::is_constant_evaluated() ? 0 : _simd_utf8_valid_prefix(encoded_string, encoded_string_size_in_chars);
+
+    while (index < encoded_string_size_in_chars) {
+      if (encoded_string[index] < 0x80) {
+        ++index;
+        continue;
+      }
+
+      char32_t character = 0;
+      EEncodingError error = EEncodingError::none;
+      size_type length = _decode_char_checked(encoded_string + index, encoded_string_size_in_chars - index, character, error);
+
+      if (length == 0)
+        return { false, index, error };
+
+      index += length;
+    }
+
+    return { true, encoded_string_size_in_chars, EEncodingError::none };
+  }
+
+  static constexpr size_type utf32_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) {
+    if (!std::is_constant_evaluated())
+      return _simd_utf8_count_code_points(encoded_string, encoded_string_size_in_chars);
+
+    size_type length = 0;
+
+    for (size_type index = 0; index < encoded_string_size_in_chars; ++index)
+      length += (encoded_string[index] & 0xC0) != 0x80;
+
+    return length;
+  }
+
+  static constexpr size_type complete_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    // Find first byte of last character, it's at most 3 continuation bytes before the end.
+    for (size_type back_length = 1; back_length <= max_encoded_size && back_length <= encoded_string_size_in_chars; ++back_length) {
+      encoded_char_type byte = encoded_string[encoded_string_size_in_chars - back_length];
+
+      if ((byte & 0xC0) == 0x80)
+        continue;
+
+      size_type length = (byte & 0x80) == 0 ? 1 : (byte & 0xE0) == 0xC0 ? 2 : (byte & 0xF0) == 0xE0 ? 3 : (byte & 0xF8) == 0xF0 ? 4 : 1;
+
+      return length > back_length ? encoded_string_size_in_chars - back_length : encoded_string_size_in_chars;
+    }
+
+    return encoded_string_size_in_chars;
+  }
+
   static constexpr size_type char_length(const encoded_char_type* encoded_char) {
     encoded_char_type first_byte = encoded_char[0];
 
@@ -230,6 +433,121 @@ struct Utf8EncodingTraits {
 
     return length;
   }
+
+  // Decode character at the beginning of string, checking it by table 3-7 of UNICODE standard.
+  // Returns length of character, or 0 if it's invalid and then stores kind of error to 'error'.
+  static constexpr size_type _decode_char_checked(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars, char32_t& character, EEncodingError& error) noexcept {
+    encoded_char_type lead_byte = encoded_string[0];
+
+    if (lead_byte < 0x80) {
+      character = lead_byte;
+      return 1;
+    }
+
+    // Range of second byte depends on lead byte.
+    size_type length;
+    encoded_char_type min_second_byte = 0x80;
+    encoded_char_type max_second_byte = 0xBF;
+    EEncodingError second_byte_error = EEncodingError::missing_continuation;
+
+    if (lead_byte < 0xC0) {
+      error = EEncodingError::unexpected_continuation;
+      return 0;
+    }
+    else if (lead_byte < 0xC2) {
+      error = EEncodingError::overlong;
+      return 0;
+    }
+    else if (lead_byte < 0xE0) {
+      length = 2;
+      character = lead_byte & 0x1F;
+    }
+    else if (lead_byte < 0xF0) {
+      length = 3;
+      character = lead_byte & 0x0F;
+
+      if (lead_byte == 0xE0) {
+        min_second_byte = 0xA0;
+        second_byte_error = EEncodingError::overlong;
+      }
+      else if (lead_byte == 0xED) {
+        max_second_byte = 0x9F;
+        second_byte_error = EEncodingError::surrogate;
+      }
+    }
+    else if (lead_byte < 0xF5) {
+      length = 4;
+      character = lead_byte & 0x07;
+
+      if (lead_byte == 0xF0) {
+        min_second_byte = 0x90;
+        second_byte_error = EEncodingError::overlong;
+      }
+      else if (lead_byte == 0xF4) {
+        max_second_byte = 0x8F;
+        second_byte_error = EEncodingError::too_large;
+      }
+    }
+    else {
+      error = EEncodingError::too_large;
+      return 0;
+    }
+
+    for (size_type byte_index = 1; byte_index < length; ++byte_index) {
+      if (byte_index >= encoded_string_size_in_chars) {
+        error = EEncodingError::truncated;
+        return 0;
+      }
+
+      encoded_char_type byte = encoded_string[byte_index];
+
+      if ((byte & 0xC0) != 0x80) {
+        error = EEncodingError::missing_continuation;
+        return 0;
+      }
+
+      if (byte_index == 1 && (byte < min_second_byte || byte > max_second_byte)) {
+        error = second_byte_error;
+        return 0;
+      }
+
+      character = (character << 6) | (byte & 0x3F);
+    }
+
+    return length;
+  }
+
+private:
+  // Decode string, that is known to be valid.
+  static size_type _to_utf32_valid(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars, char32_t* dest) noexcept {
+    const char32_t* begin = dest;
+    const encoded_char_type* end = encoded_string + encoded_string_size_in_chars;
+
+    while (encoded_string != end) {
+      char32_t lead_byte = encoded_string[0];
+
+      if (lead_byte < 0x80) {
+        size_type ascii_length = _simd_utf8_widen_ascii(encoded_string, static_cast<size_type>(end - encoded_string), dest);
+
+        encoded_string += ascii_length;
+        dest += ascii_length;
+      }
+      else if (lead_byte < 0xE0) {
+        *dest++ = ((lead_byte & 0x1F) << 6) | (encoded_string[1] & 0x3F);
+        encoded_string += 2;
+      }
+      else if (lead_byte < 0xF0) {
+        *dest++ = ((lead_byte & 0x0F) << 12) | ((encoded_string[1] & 0x3F) << 6) | (encoded_string[2] & 0x3F);
+        encoded_string += 3;
+      }
+      else {
+        *dest++ = ((lead_byte & 0x07) << 18) | ((encoded_string[1] & 0x3F) << 12) | ((encoded_string[2] & 0x3F) << 6) | (encoded_string[3] & 0x3F);
+        encoded_string += 4;
+      }
+    }
+
+    return static_cast<size_type>(dest - begin);
+  }
 };
 
 template <typename EncodedCharType>
@@ -249,32 +567,29 @@ struct _Utf16EncodingTraits_Base {
       return 1;
     }
     else {
-      EncodedCharType character2 = static_cast<EncodedCharType>(original_char - 0x10000);
+      // Characters above BMP are encoded as surrogate pair, 10 bits in each word.
+      char32_t surrogate_bits = original_char - 0x10000;
 
-      dest[1] = 0xDC00 | (character2 & 0xFF);
-      character2 >>= 8;
-      dest[0] = 0xD800 | (character2 & 0xFF);
+      dest[1] = static_cast<EncodedCharType>(0xDC00 | (surrogate_bits & 0x3FF));
+      dest[0] = static_cast<EncodedCharType>(0xD800 | ((surrogate_bits >> 10) & 0x3FF));
 
       return 2;
     }
   }
 
   static constexpr char32_t char_to_utf32(const encoded_char_type* encoded_char) {
-    encoded_char_type first_word = encoded_char[0];
+    char32_t first_word = static_cast<char32_t>(encoded_char[0]);
 
-    if ((first_word & 0xFF00) == 0xD800) {
-      EncodedCharType first_byte = first_word & 0xFF;
-      EncodedCharType second_byte = encoded_char[1] & 0xFF;
+    if ((first_word & 0xFC00) == 0xD800) {
+      char32_t second_word = static_cast<char32_t>(encoded_char[1]);
 
-      char32_t result = first_byte;
-      result <<= 8;
-      result |= second_byte;
-      result += 0x10000;
+      if ((second_word & 0xFC00) != 0xDC00)
+        throw encoding_failed(encoding_name, "Invalid UTF-16 surrogate pair.");
 
-      return result;
+      return (((first_word & 0x3FF) << 10) | (second_word & 0x3FF)) + 0x10000;
     }
     else {
-      return static_cast<char32_t>(first_word);
+      return first_word;
     }
   }
 
@@ -291,21 +606,102 @@ struct _Utf16EncodingTraits_Base {
     return static_cast<size_type>(dest - begin);
   }
 
+  // At runtime string is validated at once and then decoded without checking every character.
   static constexpr size_type to_utf32(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars, char32_t* dest) {
     const char32_t* begin = dest;
+    const encoded_char_type* end = encoded_string + encoded_string_size_in_chars;
+
+    if (!std::is_constant_evaluated()) {
+      EValidationResult validation = validate(encoded_string, encoded_string_size_in_chars);
+
+      if (!validation.is_valid)
+        throw encoding_failed(encoding_name, _encoding_error_message(validation.error_kind));
+
+      for (; encoded_string != end; ++dest) {
+        char32_t word = static_cast<char32_t>(encoded_string[0]);
+
+        if ((word & 0xF800) != 0xD800) {
+          *dest = word;
+          ++encoded_string;
+        }
+        else {
+          *dest = (((word & 0x3FF) << 10) | (static_cast<char32_t>(encoded_string[1]) & 0x3FF)) + 0x10000;
+          encoded_string += 2;
+        }
+      }
+
+      return static_cast<size_type>(dest - begin);
+    }
+
+    while (encoded_string != end) {
+      size_type length = char_length(encoded_string);
+
+      if (length > static_cast<size_type>(end - encoded_string))
+        throw encoding_failed(encoding_name, "Truncated UTF-16 character.");
 
-    for (
-      const encoded_char_type* end = encoded_string + encoded_string_size_in_chars;
-      encoded_string != end;
-      ++dest, encoded_string += char_length(encoded_string)
-      )
       dest[0] = char_to_utf32(encoded_string);
 
+      ++dest;
+      encoded_string += length;
+    }
+
     return static_cast<size_type>(dest - begin);
   }
 
+  static constexpr size_type utf32_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) {
+    size_type length = 0;
+
+    for (size_type index = 0; index < encoded_string_size_in_chars; index += char_length(encoded_string + index))
+      ++length;
+
+    return length;
+  }
+
+  static constexpr size_type encoded_length(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars) {
+    size_type length = decoded_string_size_in_utf32_chars;
+
+    for (size_type index = 0; index < decoded_string_size_in_utf32_chars; ++index)
+      length += decoded_string[index] > 0xFFFF;
+
+    return length;
+  }
+
+  static constexpr EValidationResult validate(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    size_type index = std::is_constant_evaluated() ? 0 : _simd_utf16_surrogate_free_prefix(encoded_string, encoded_string_size_in_chars);
+
+    while (index < encoded_string_size_in_chars) {
+      char32_t word = static_cast<char32_t>(encoded_string[index]);
+
+      if ((word & 0xF800) != 0xD800) {
+        ++index;
+        continue;
+      }
+
+      if ((word & 0xFC00) == 0xDC00)
+        return { false, index, EEncodingError::unpaired_surrogate };
+
+      if (index + 1 == encoded_string_size_in_chars)
+        return { false, index, EEncodingError::truncated };
+
+      if ((static_cast<char32_t>(encoded_string[index + 1]) & 0xFC00) != 0xDC00)
+        return { false, index, EEncodingError::unpaired_surrogate };
+
+      index += 2;
+    }
+
+    return { true, encoded_string_size_in_chars, EEncodingError::none };
+  }
+
+  static constexpr size_type complete_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    // Cut high surrogate, which pair is in next chunk.
+    if (encoded_string_size_in_chars != 0 && (encoded_string[encoded_string_size_in_chars - 1] & 0xFC00) == 0xD800)
+      return encoded_string_size_in_chars - 1;
+
+    return encoded_string_size_in_chars;
+  }
+
   static constexpr size_type char_length(const encoded_char_type* encoded_char) {
-    if ((encoded_char[0] & 0xFF00) == 0xD800)
+    if ((encoded_char[0] & 0xFC00) == 0xD800)
       return 2;
     else
       return 1;
@@ -356,6 +752,35 @@ struct _Utf32EncodingTraits_Base {
     return encoded_string_size_in_chars;
   }
 
+  static constexpr size_type utf32_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) {
+    (void)encoded_string;
+    return encoded_string_size_in_chars;
+  }
+
+  static constexpr size_type encoded_length(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars) {
+    (void)decoded_string;
+    return decoded_string_size_in_utf32_chars;
+  }
+
+  static constexpr size_type complete_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    (void)encoded_string;
+    return encoded_string_size_in_chars;
+  }
+
+  static constexpr EValidationResult validate(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars) noexcept {
+    for (size_type index = 0; index < encoded_string_size_in_chars; ++index) {
+      char32_t character = static_cast<char32_t>(encoded_string[index]);
+
+      if (character > 0x10FFFF)
+        return { false, index, EEncodingError::too_large };
+
+      if ((character & 0xFFFFF800) == 0xD800)
+        return { false, index, EEncodingError::surrogate };
+    }
+
+    return { true, encoded_string_size_in_chars, EEncodingError::none };
+  }
+
   static constexpr size_type char_length(const encoded_char_type* encoded_char) {
     (void)encoded_char;
     return 1;
@@ -417,6 +842,9 @@ struct AnsiEncodingTraits {
   static char32_t char_to_utf32(const encoded_char_type* encoded_char);
   static size_type from_utf32(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars, encoded_char_type* dest);
   static size_type to_utf32(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars, char32_t* dest);
+  static size_type utf32_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars);
+  static size_type encoded_length(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars);
+  static size_type complete_length(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars);
   static size_type char_length(const encoded_char_type* encoded_char);
   static size_type str_length(const encoded_char_type* string);
 };
@@ -425,3 +853,483 @@ template<>
 struct EncodingTraits<ansichar_t> : AnsiEncodingTraits {};
 
 #endif
+
+// Find first invalid character of encoded string, without throwing exceptions.
+// Utf8 is checked by SIMD validator, invalid characters are then found by scalar one.
+// Encodings without 'validate()' in their traits are checked by decoding every character.
+template <typename CharType>
+constexpr EValidationResult validate(const CharType* encoded_string, size_t encoded_string_size_in_chars) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  if constexpr (requires { encoding_traits::validate(encoded_string, encoded_string_size_in_chars); }) {
+    return encoding_traits::validate(encoded_string, encoded_string_size_in_chars);
+  }
+  else {
+    size_t index = 0;
+
+    try {
+      while (index < encoded_string_size_in_chars) {
+        size_t char_length = encoding_traits::char_length(encoded_string + index);
+
+        if (char_length > encoded_string_size_in_chars - index)
+          return { false, index, EEncodingError::truncated };
+
+        encoding_traits::char_to_utf32(encoded_string + index);
+        index += char_length;
+      }
+    }
+    catch (encoding_failed const&) {
+      return { false, index, EEncodingError::invalid_character };
+    }
+
+    return { true, encoded_string_size_in_chars, EEncodingError::none };
+  }
+}
+
+template <typename CharType>
+constexpr EValidationResult validate(std::basic_string_view<CharType> encoded_string) {
+  return validate(encoded_string.data(), encoded_string.length());
+}
+
+// Optional traits members 'utf32_length()', 'encoded_length()' and 'complete_length()'.
+// Encodings without them are measured character by character with 'char_length()' and 'char_from_utf32()'.
+template <typename CharType>
+constexpr size_t _utf32_length(const CharType* encoded_string, size_t encoded_string_size_in_chars) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  if constexpr (requires { encoding_traits::utf32_length(encoded_string, encoded_string_size_in_chars); }) {
+    return encoding_traits::utf32_length(encoded_string, encoded_string_size_in_chars);
+  }
+  else {
+    size_t length = 0;
+
+    // Truncated last character is counted too, decoding will reject it.
+    for (size_t index = 0; index < encoded_string_size_in_chars; ++length)
+      index += encoding_traits::char_length(encoded_string + index);
+
+    return length;
+  }
+}
+
+template <typename CharType>
+constexpr size_t _encoded_length(const char32_t* decoded_string, size_t decoded_string_size_in_utf32_chars) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  if constexpr (requires { encoding_traits::encoded_length(decoded_string, decoded_string_size_in_utf32_chars); }) {
+    return encoding_traits::encoded_length(decoded_string, decoded_string_size_in_utf32_chars);
+  }
+  else {
+    size_t length = 0;
+    CharType encoded_char[encoding_traits::max_encoded_size] = {};
+
+    for (size_t index = 0; index < decoded_string_size_in_utf32_chars; ++index)
+      length += encoding_traits::char_from_utf32(decoded_string[index], encoded_char);
+
+    return length;
+  }
+}
+
+template <typename CharType>
+constexpr size_t _complete_length(const CharType* encoded_string, size_t encoded_string_size_in_chars) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  if constexpr (requires { encoding_traits::complete_length(encoded_string, encoded_string_size_in_chars); }) {
+    return encoding_traits::complete_length(encoded_string, encoded_string_size_in_chars);
+  }
+  else {
+    size_t index = 0;
+
+    while (index < encoded_string_size_in_chars) {
+      size_t char_length = encoding_traits::char_length(encoded_string + index);
+
+      if (char_length > encoded_string_size_in_chars - index)
+        break;
+
+      index += char_length;
+    }
+
+    return index;
+  }
+}
+
+// Progress of conversion to or from caller-provided buffer.
+struct ECodingProgress {
+  // Number of characters consumed from source.
+  size_t read = 0;
+  // Number of characters written to destination.
+  size_t written = 0;
+  // Whole source is converted. Otherwise destination has no space for next character,
+  //  or source ends with incomplete one, and conversion should continue after 'read' characters.
+  bool is_complete = false;
+};
+
+// Encode as many whole characters of utf32 'string' as fit to 'dest'.
+template <typename CharType>
+constexpr ECodingProgress _encode_into(const char32_t* string, size_t string_length, CharType* dest, size_t dest_size) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  ECodingProgress progress;
+
+  while (progress.read != string_length) {
+    size_t remaining_length = string_length - progress.read;
+    size_t free_size = dest_size - progress.written;
+
+    // Characters that fit even at maximal size are encoded at once.
+    size_t fitting_length = free_size / encoding_traits::max_encoded_size;
+
+    if (fitting_length != 0) {
+      if (fitting_length > remaining_length)
+        fitting_length = remaining_length;
+
+      progress.written += encoding_traits::from_utf32(string + progress.read, fitting_length, dest + progress.written);
+      progress.read += fitting_length;
+      continue;
+    }
+
+    // Near the end of buffer characters are encoded one by one, until one doesn't fit.
+    CharType encoded_char[encoding_traits::max_encoded_size] = {};
+    size_t char_size = encoding_traits::char_from_utf32(string[progress.read], encoded_char);
+
+    if (char_size > free_size)
+      break;
+
+    for (size_t index = 0; index < char_size; ++index)
+      dest[progress.written++] = encoded_char[index];
+
+    ++progress.read;
+  }
+
+  progress.is_complete = progress.read == string_length;
+
+  return progress;
+}
+
+// Unicode form of encoding traits. Transcoding between known forms uses dedicated kernels.
+enum class _EncodingForm {
+  other,
+  utf8,
+  utf16,
+  utf32
+};
+
+template <typename CharType>
+constexpr _EncodingForm _encoding_form() noexcept {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  if constexpr (std::is_base_of_v<Utf8EncodingTraits, encoding_traits>)
+    return _EncodingForm::utf8;
+  else if constexpr (std::is_base_of_v<_Utf16EncodingTraits_Base<CharType>, encoding_traits>)
+    return _EncodingForm::utf16;
+  else if constexpr (std::is_base_of_v<_Utf32EncodingTraits_Base<CharType>, encoding_traits>)
+    return _EncodingForm::utf32;
+  else
+    return _EncodingForm::other;
+}
+
+// Decode character at the beginning of encoded string, checking it like 'validate()' does.
+// Returns length of character, or 0 if it's invalid and then stores kind of error to 'error'.
+template <typename CharType>
+constexpr size_t _decode_encoded_char_checked(const CharType* encoded_string, size_t encoded_string_size_in_chars, char32_t& character, EEncodingError& error) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  if constexpr (_encoding_form<CharType>() == _EncodingForm::utf8) {
+    return encoding_traits::_decode_char_checked(encoded_string, encoded_string_size_in_chars, character, error);
+  }
+  else if constexpr (_encoding_form<CharType>() == _EncodingForm::utf16) {
+    char32_t first_word = static_cast<char32_t>(encoded_string[0]);
+
+    if ((first_word & 0xF800) != 0xD800) {
+      character = first_word;
+      return 1;
+    }
+
+    if ((first_word & 0xFC00) == 0xDC00) {
+      error = EEncodingError::unpaired_surrogate;
+      return 0;
+    }
+
+    if (encoded_string_size_in_chars < 2) {
+      error = EEncodingError::truncated;
+      return 0;
+    }
+
+    char32_t second_word = static_cast<char32_t>(encoded_string[1]);
+
+    if ((second_word & 0xFC00) != 0xDC00) {
+      error = EEncodingError::unpaired_surrogate;
+      return 0;
+    }
+
+    character = (((first_word & 0x3FF) << 10) | (second_word & 0x3FF)) + 0x10000;
+    return 2;
+  }
+  else {
+    size_t char_length = encoding_traits::char_length(encoded_string);
+
+    if (char_length > encoded_string_size_in_chars) {
+      error = EEncodingError::truncated;
+      return 0;
+    }
+
+    // Traits may have no 'validate()', then character is checked by decoding it.
+    EValidationResult validation = validate<CharType>(encoded_string, char_length);
+
+    if (!validation.is_valid) {
+      error = validation.error_kind;
+      return 0;
+    }
+
+    character = encoding_traits::char_to_utf32(encoded_string);
+    return char_length;
+  }
+}
+
+// Check that encoded string, decoded on the fly, is a prefix of utf32 'string'.
+// Stops at first mismatch or invalid character and doesn't allocate. Runs of ASCII characters of utf8 and ASCII strings are compared by SIMD.
+// Returns length of decoded string, or 'static_cast<size_t>(-1)' if it isn't a prefix.
+template <typename CharType>
+constexpr size_t _match_encoded_prefix(const char32_t* string, size_t string_length, const CharType* encoded_string, size_t encoded_string_length_in_chars) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  constexpr size_t no_match = static_cast<size_t>(-1);
+  constexpr bool is_ascii_compatible = _encoding_form<CharType>() == _EncodingForm::utf8 || std::is_base_of_v<AsciiEncodingTraits, encoding_traits>;
+
+  const CharType* end = encoded_string + encoded_string_length_in_chars;
+  size_t index = 0;
+
+  while (encoded_string != end) {
+    if constexpr (is_ascii_compatible) {
+      if (!std::is_constant_evaluated()) {
+        size_t remaining_length = static_cast<size_t>(end - encoded_string);
+        size_t matched_length = _simd_ascii_match(encoded_string, string + index, remaining_length < string_length - index ? remaining_length : string_length - index);
+
+        encoded_string += matched_length;
+        index += matched_length;
+
+        if (encoded_string == end)
+          break;
+      }
+    }
+
+    if (index >= string_length)
+      return no_match;
+
+    // Invalid characters (e.g. overlong utf8) don't match anything, as they can't be decoded.
+    char32_t character = 0;
+    EEncodingError error = EEncodingError::none;
+    size_t char_length = _decode_encoded_char_checked(encoded_string, static_cast<size_t>(end - encoded_string), character, error);
+
+    if (char_length == 0 || string[index] != character)
+      return no_match;
+
+    encoded_string += char_length;
+    ++index;
+  }
+
+  return index;
+}
+
+// Check that utf32 'string' is a prefix of encoded string, decoded on the fly. Counterpart of '_match_encoded_prefix()'.
+// Returns length of matched part of encoded string in chars, or 'static_cast<size_t>(-1)' if 'string' isn't its prefix.
+template <typename CharType>
+constexpr size_t _match_decoded_prefix(const CharType* encoded_string, size_t encoded_string_length_in_chars, const char32_t* string, size_t string_length) {
+  using encoding_traits = EncodingTraits<CharType>;
+
+  constexpr size_t no_match = static_cast<size_t>(-1);
+  constexpr bool is_ascii_compatible = _encoding_form<CharType>() == _EncodingForm::utf8 || std::is_base_of_v<AsciiEncodingTraits, encoding_traits>;
+
+  const CharType* begin = encoded_string;
+  const CharType* end = encoded_string + encoded_string_length_in_chars;
+  size_t index = 0;
+
+  while (index != string_length) {
+    if constexpr (is_ascii_compatible) {
+      if (!std::is_constant_evaluated()) {
+        size_t remaining_length = static_cast<size_t>(end - encoded_string);
+        size_t matched_length = _simd_ascii_match(encoded_string, string + index, remaining_length < string_length - index ? remaining_length : string_length - index);
+
+        encoded_string += matched_length;
+        index += matched_length;
+
+        if (index == string_length)
+          break;
+      }
+    }
+
+    if (encoded_string == end)
+      return no_match;
+
+    char32_t character = 0;
+    EEncodingError error = EEncodingError::none;
+    size_t char_length = _decode_encoded_char_checked(encoded_string, static_cast<size_t>(end - encoded_string), character, error);
+
+    if (char_length == 0 || string[index] != character)
+      return no_match;
+
+    encoded_string += char_length;
+    ++index;
+  }
+
+  return static_cast<size_t>(encoded_string - begin);
+}
+
+template <typename CharType>
+constexpr const char* _truncated_char_message() noexcept {
+  switch (_encoding_form<CharType>()) {
+    case _EncodingForm::utf8: return "Truncated UTF-8 character.";
+    case _EncodingForm::utf16: return "Truncated UTF-16 character.";
+    default: return "Truncated character.";
+  }
+}
+
+// Get upper bound of number of 'To' that 'transcode()' writes for 'encoded_string_size_in_chars' of 'From', without reading string.
+template <typename From, typename To>
+constexpr size_t max_transcoded_length(size_t encoded_string_size_in_chars) noexcept {
+  constexpr _EncodingForm from_form = _encoding_form<From>();
+  constexpr _EncodingForm to_form = _encoding_form<To>();
+
+  // Every character takes at least one 'From', and at most one utf32 character or one utf16 word per utf8 byte.
+  if constexpr (to_form == _EncodingForm::utf32 || (from_form == _EncodingForm::utf8 && to_form == _EncodingForm::utf16))
+    return encoded_string_size_in_chars;
+  // Utf16 word is at most 3 utf8 bytes, surrogate pair is 4 bytes.
+  else if constexpr (from_form == _EncodingForm::utf16 && to_form == _EncodingForm::utf8)
+    return encoded_string_size_in_chars * 3;
+  else
+    return encoded_string_size_in_chars * EncodingTraits<To>::max_encoded_size;
+}
+
+// Get exact number of 'To' that 'transcode()' writes for given string.
+template <typename From, typename To>
+constexpr size_t transcoded_length(const From* encoded_string, size_t encoded_string_size_in_chars) {
+  using from_traits = EncodingTraits<From>;
+
+  constexpr _EncodingForm from_form = _encoding_form<From>();
+  constexpr _EncodingForm to_form = _encoding_form<To>();
+
+  if constexpr (from_form == _EncodingForm::utf8 && to_form == _EncodingForm::utf16) {
+    // Every character is one word, except 4-byte ones, that are surrogate pairs.
+    size_t length = 0;
+
+    for (size_t index = 0; index < encoded_string_size_in_chars; ++index) {
+      char8_t byte = encoded_string[index];
+      length += ((byte & 0xC0) != 0x80) + ((byte & 0xF8) == 0xF0);
+    }
+
+    return length;
+  }
+  else if constexpr (to_form == _EncodingForm::utf32) {
+    return _utf32_length<From>(encoded_string, encoded_string_size_in_chars);
+  }
+  else if constexpr (std::is_same_v<From, char32_t>) {
+    return _encoded_length<To>(encoded_string, encoded_string_size_in_chars);
+  }
+  else {
+    size_t length = 0;
+
+    for (size_t index = 0; index < encoded_string_size_in_chars;) {
+      size_t char_length = from_traits::char_length(encoded_string + index);
+
+      if (char_length > encoded_string_size_in_chars - index)
+        throw encoding_failed(from_traits::encoding_name, _truncated_char_message<From>());
+
+      char32_t character = from_traits::char_to_utf32(encoded_string + index);
+
+      length += _encoded_length<To>(&character, 1);
+      index += char_length;
+    }
+
+    return length;
+  }
+}
+
+// Convert string from encoding of 'From' to encoding of 'To' in one pass, without utf32 intermediate buffer.
+// 'dest' should have space for 'transcoded_length()' (or 'max_transcoded_length()') characters.
+// Runs of ASCII characters between utf8 and utf16 or utf32 are converted by SIMD kernels,
+//  the rest is converted character by character by encoding traits.
+// Returns number of 'To' written to 'dest'. Throws 'encoding_failed' like 'decode()' and 'encode()' do.
+template <typename From, typename To>
+constexpr size_t transcode(const From* encoded_string, size_t encoded_string_size_in_chars, To* dest) {
+  using from_traits = EncodingTraits<From>;
+  using to_traits = EncodingTraits<To>;
+
+  constexpr _EncodingForm from_form = _encoding_form<From>();
+  constexpr _EncodingForm to_form = _encoding_form<To>();
+
+  constexpr bool has_ascii_kernel =
+    (from_form == _EncodingForm::utf8 && (to_form == _EncodingForm::utf16 || to_form == _EncodingForm::utf32)) ||
+    (from_form == _EncodingForm::utf16 && to_form == _EncodingForm::utf8);
+
+  constexpr bool has_block_kernel = from_form == _EncodingForm::utf32 && to_form == _EncodingForm::utf8;
+
+  const To* begin = dest;
+  const From* end = encoded_string + encoded_string_size_in_chars;
+
+  while (encoded_string != end) {
+    if constexpr (has_ascii_kernel || has_block_kernel) {
+      if (!std::is_constant_evaluated()) {
+        size_t remaining_length = static_cast<size_t>(end - encoded_string);
+        size_t converted_length = 0;
+
+        if constexpr (has_block_kernel) {
+          size_t written_size = 0;
+          converted_length = _simd_utf32_to_utf8_blocks(encoded_string, remaining_length, dest, written_size);
+          dest += written_size;
+        }
+        else if (static_cast<char32_t>(encoded_string[0]) < 0x80) {
+          if constexpr (from_form == _EncodingForm::utf16)
+            converted_length = _simd_utf16_narrow_ascii(encoded_string, remaining_length, dest);
+          else if constexpr (to_form == _EncodingForm::utf16)
+            converted_length = _simd_utf8_widen_ascii_to_utf16(encoded_string, remaining_length, dest);
+          else
+            converted_length = _simd_utf8_widen_ascii(encoded_string, remaining_length, dest);
+
+          dest += converted_length;
+        }
+
+        encoded_string += converted_length;
+
+        if (encoded_string == end)
+          break;
+      }
+    }
+
+    char32_t character = 0;
+    EEncodingError error = EEncodingError::none;
+    size_t char_length = _decode_encoded_char_checked(encoded_string, static_cast<size_t>(end - encoded_string), character, error);
+
+    if (char_length == 0)
+      throw encoding_failed(from_traits::encoding_name, error == EEncodingError::truncated ? _truncated_char_message<From>() : _encoding_error_message(error));
+
+    dest += to_traits::char_from_utf32(character, dest);
+    encoded_string += char_length;
+  }
+
+  return static_cast<size_t>(dest - begin);
+}
+
+// Convert string to encoding of 'To', e.g. 'transcode<char16_t>(u8"text")'.
+template <typename To, typename From>
+std::basic_string<To> transcode(std::basic_string_view<From> encoded_string) {
+  size_t max_length = max_transcoded_length<From, To>(encoded_string.length());
+
+  // Count exact length only if bound may be much longer than result.
+  size_t length = max_length == encoded_string.length()
+    ? max_length
+    : transcoded_length<From, To>(encoded_string.data(), encoded_string.length());
+
+  std::basic_string<To> result;
+  result.resize(length);
+  result.resize(transcode(encoded_string.data(), encoded_string.length(), result.data()));
+
+  return result;
+}
+
+template <typename To, typename From>
+std::basic_string<To> transcode(std::basic_string<From> const& encoded_string) {
+  return transcode<To>(std::basic_string_view<From>(encoded_string));
+}
+
+template <typename To, typename From>
+std::basic_string<To> transcode(const From* encoded_string) {
+  return transcode<To>(std::basic_string_view<From>(encoded_string, EncodingTraits<From>::str_length(encoded_string)));
+}
@@ -0,0 +1,170 @@
+#pragma once
+#define EString_EStringFile_h_
+
+#include <stddef.h>
+
+#include <bit>
+#include <initializer_list>
+#include <utility>
+
+#include "EStringEncodings.h"
+
+// Encoding of text file, detected by its byte order mark.
+enum class EFileEncoding {
+  utf8,
+  utf16,
+  utf32
+};
+
+// Read-only file, mapped to memory.
+// Pages are loaded by OS on first access, so opening even huge file is fast.
+// Platform-specific parts are implemented in 'EString.cpp'.
+// Throws 'std::system_error' if file can't be opened or mapped.
+class EMappedFile {
+public:
+  using size_type = size_t;
+
+public:
+  EMappedFile() = default;
+
+  explicit EMappedFile(const char* path);
+
+  EMappedFile(EMappedFile const&) = delete;
+  EMappedFile& operator=(EMappedFile const&) = delete;
+
+  EMappedFile(EMappedFile&& other) noexcept {
+    _take(other);
+  }
+
+  EMappedFile& operator=(EMappedFile&& other) noexcept {
+    if (this != &other) {
+      close();
+      _take(other);
+    }
+
+    return *this;
+  }
+
+  ~EMappedFile() {
+    close();
+  }
+
+public:
+  void close() noexcept;
+
+  // Hint OS that file will be read from the beginning to the end.
+  void advise_sequential() const noexcept;
+
+  // Hint OS that bytes in range will be read soon.
+  void advise_will_need(size_type offset, size_type size) const noexcept;
+
+  bool is_open() const noexcept {
+    return m_is_open;
+  }
+
+  const unsigned char* data() const noexcept {
+    return m_data;
+  }
+
+  size_type size() const noexcept {
+    return m_size;
+  }
+
+  // Detect encoding by byte order mark. Files without it are UTF-8.
+  // Throws 'encoding_failed' if byte order of file is different from native one.
+  EFileEncoding encoding() const {
+    return _detect_encoding().first;
+  }
+
+  // Size of byte order mark in bytes, or 0 if there's none.
+  size_type bom_size() const {
+    return _detect_encoding().second;
+  }
+
+  // Call 'function(const CharType* content, size_type content_length_in_chars)',
+  //  where content is text after byte order mark and 'CharType' is a character of detected encoding.
+  template <typename Function>
+  decltype(auto) visit_content(Function&& function) const {
+    auto [encoding, bom_size] = _detect_encoding();
+
+    const unsigned char* content = m_data + bom_size;
+    size_type content_size = m_size - bom_size;
+
+    switch (encoding) {
+      case EFileEncoding::utf16:
+        if (content_size % sizeof(char16_t) != 0)
+          throw encoding_failed(Utf16EncodingTraits::encoding_name, "Truncated UTF-16 character.");
+
+        return function(reinterpret_cast<const char16_t*>(content), content_size / sizeof(char16_t));
+
+      case EFileEncoding::utf32:
+        if (content_size % sizeof(char32_t) != 0)
+          throw encoding_failed(Utf32EncodingTraits::encoding_name, "Truncated UTF-32 character.");
+
+        return function(reinterpret_cast<const char32_t*>(content), content_size / sizeof(char32_t));
+
+      default:
+        return function(reinterpret_cast<const char8_t*>(content), content_size);
+    }
+  }
+
+private:
+  std::pair<EFileEncoding, size_type> _detect_encoding() const {
+    constexpr bool is_little_endian = std::endian::native == std::endian::little;
+
+    auto starts_with = [this](std::initializer_list<unsigned char> bom) {
+      if (m_size < bom.size())
+        return false;
+
+      size_type index = 0;
+
+      for (unsigned char byte : bom)
+        if (m_data[index++] != byte)
+          return false;
+
+      return true;
+    };
+
+    if (starts_with({ 0xEF, 0xBB, 0xBF }))
+      return { EFileEncoding::utf8, 3 };
+
+    // UTF-32 LE mark starts with UTF-16 LE one, so it's checked first.
+    if (starts_with({ 0xFF, 0xFE, 0x00, 0x00 }) || starts_with({ 0x00, 0x00, 0xFE, 0xFF })) {
+      if (m_data[0] != (is_little_endian ? 0xFF : 0x00))
+        throw encoding_failed(Utf32EncodingTraits::encoding_name, "Byte order of file isn't supported.");
+
+      return { EFileEncoding::utf32, 4 };
+    }
+
+    if (starts_with({ 0xFF, 0xFE }) || starts_with({ 0xFE, 0xFF })) {
+      if (m_data[0] != (is_little_endian ? 0xFF : 0xFE))
+        throw encoding_failed(Utf16EncodingTraits::encoding_name, "Byte order of file isn't supported.");
+
+      return { EFileEncoding::utf16, 2 };
+    }
+
+    return { EFileEncoding::utf8, 0 };
+  }
+
+  void _take(EMappedFile& other) noexcept {
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_is_open = std::exchange(other.m_is_open, false);
+
+#ifdef _WIN32
+    m_file_handle = std::exchange(other.m_file_handle, nullptr);
+    m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+#endif
+  }
+
+private:
+  // Mapped bytes, or nullptr for empty file.
+  const unsigned char* m_data = nullptr;
+  size_type m_size = 0;
+  bool m_is_open = false;
+
+#ifdef _WIN32
+  void* m_file_handle = nullptr;
+  void* m_mapping_handle = nullptr;
+#endif
+};
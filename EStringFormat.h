@@ -0,0 +1,700 @@
+#pragma once
+#define EString_EStringFormat_h_
+
+/*
+* This file contains format engine of 'EString::format()' and 'format_to()'.
+* Format string is utf32 string, it's parsed and checked against argument types at compile time,
+*  so invalid format string is a compilation error.
+*
+* Replacement field: '{' [argument index] [':' specification] '}'. Use '{{' and '}}' for braces.
+* Specification: [[fill] align] [sign] ['#'] ['0'] [width] ['.' precision] [type]
+*  align: '<' (left), '>' (right), '^' (center). Numbers are aligned to the right by default, other arguments to the left.
+*  sign: '+' (always), '-' (only negative), ' ' (space for positive). Only for numbers.
+*  '#': prefix '0x', '0b' or '0' for integers of type 'x', 'b' or 'o'.
+*  '0': pad numbers with zeros after sign and prefix.
+*  precision: digits after point for floating point numbers, maximal number of characters for strings.
+*  type:
+*   integers: 'd' (default), 'x', 'X', 'b', 'B', 'o', 'c' (as character, throws 'std::out_of_range' if it isn't a code point)
+*   floating point numbers: shortest representation (default), 'f', 'F', 'e', 'E', 'g', 'G'
+*   strings, characters and bools: 's' (or 'c' for characters)
+*
+* Arguments are written straight to utf32 buffer. Output size is computed before writing,
+*  so result is allocated once.
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "EStringEncodings.h"
+#include "EStringView.h"
+
+// Reports error in format string. It's not constexpr, so calling it at compile time fails compilation.
+inline void _format_error(const char* message) {
+  throw std::invalid_argument(message);
+}
+
+enum class _EFormatArgKind {
+  boolean,
+  character,
+  integer,
+  floating,
+  string,
+  encoded_string
+};
+
+struct _EFormatSpec {
+  char32_t fill = U' ';
+  // '<', '>', '^' or 0 for default alignment.
+  char align = 0;
+  char sign = '-';
+  bool is_alternate = false;
+  bool is_zero_padded = false;
+  size_t width = 0;
+  size_t precision = EStringView::npos;
+  // Type character or 0 for default type.
+  char type = 0;
+};
+
+// Type-erased argument.
+struct _EFormatArg {
+  _EFormatArgKind kind = _EFormatArgKind::boolean;
+
+  bool boolean = false;
+  char32_t character = 0;
+  // Integers are stored as magnitude and sign.
+  unsigned long long integer = 0;
+  bool is_negative = false;
+  double floating = 0.0;
+  EStringView string;
+  // Encoded strings are decoded by functions of their encoding.
+  const void* encoded_string = nullptr;
+  size_t encoded_string_length = 0;
+  size_t(*encoded_to_utf32)(const void*, size_t, char32_t*) = nullptr;
+  size_t(*encoded_utf32_length)(const void*, size_t) = nullptr;
+
+  // Check do characters of string argument lie in buffer ['buffer_begin', 'buffer_end').
+  bool is_overlapping(const void* buffer_begin, const void* buffer_end) const noexcept {
+    std::less<const void*> less;
+
+    if (kind == _EFormatArgKind::string)
+      return less(string.data(), buffer_end) && less(buffer_begin, string.data() + string.length());
+
+    // Length of encoded string is in units of unknown size, so only its beginning is checked.
+    if (kind == _EFormatArgKind::encoded_string)
+      return less(encoded_string, buffer_end) && !less(encoded_string, buffer_begin);
+
+    return false;
+  }
+};
+
+template <typename CharType>
+struct _EFormatEncoded {
+  static size_t to_utf32(const void* string, size_t length, char32_t* dest) {
+    return EncodingTraits<CharType>::to_utf32(static_cast<const CharType*>(string), length, dest);
+  }
+
+  static size_t utf32_length(const void* string, size_t length) {
+    return _utf32_length<CharType>(static_cast<const CharType*>(string), length);
+  }
+};
+
+template <typename Type>
+struct _EFormatEncodedCharOf {
+  using type = void;
+};
+
+template <typename CharType>
+struct _EFormatEncodedCharOf<const CharType*> {
+  using type = CharType;
+};
+
+template <typename CharType>
+struct _EFormatEncodedCharOf<CharType*> {
+  using type = CharType;
+};
+
+template <typename CharType, typename Traits, typename Allocator>
+struct _EFormatEncodedCharOf<std::basic_string<CharType, Traits, Allocator>> {
+  using type = CharType;
+};
+
+template <typename CharType, typename Traits>
+struct _EFormatEncodedCharOf<std::basic_string_view<CharType, Traits>> {
+  using type = CharType;
+};
+
+// Kind of argument of type 'Type'.
+template <typename Type>
+constexpr _EFormatArgKind _format_arg_kind() {
+  using value_type = std::decay_t<Type>;
+  using encoded_char_type = typename _EFormatEncodedCharOf<value_type>::type;
+
+  if constexpr (std::is_same_v<value_type, bool>)
+    return _EFormatArgKind::boolean;
+  else if constexpr (
+    std::is_same_v<value_type, char> || std::is_same_v<value_type, char8_t> || std::is_same_v<value_type, char16_t>
+    || std::is_same_v<value_type, char32_t> || std::is_same_v<value_type, wchar_t>
+  )
+    return _EFormatArgKind::character;
+  else if constexpr (std::is_integral_v<value_type>)
+    return _EFormatArgKind::integer;
+  else if constexpr (std::is_floating_point_v<value_type>)
+    return _EFormatArgKind::floating;
+  else if constexpr (std::is_convertible_v<value_type const&, EStringView>)
+    return _EFormatArgKind::string;
+  else if constexpr (!std::is_void_v<encoded_char_type> && has_encoding_traits_v<std::remove_cv_t<encoded_char_type>>)
+    return _EFormatArgKind::encoded_string;
+  else
+    static_assert(!sizeof(Type), "Type can't be formatted.");
+}
+
+template <typename Type>
+_EFormatArg _make_format_arg(Type const& value) {
+  constexpr _EFormatArgKind kind = _format_arg_kind<Type>();
+
+  _EFormatArg arg;
+  arg.kind = kind;
+
+  if constexpr (kind == _EFormatArgKind::boolean) {
+    arg.boolean = value;
+  }
+  else if constexpr (kind == _EFormatArgKind::character) {
+    arg.character = static_cast<char32_t>(static_cast<std::make_unsigned_t<Type>>(value));
+  }
+  else if constexpr (kind == _EFormatArgKind::integer) {
+    arg.is_negative = value < 0;
+    arg.integer = arg.is_negative ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+  }
+  else if constexpr (kind == _EFormatArgKind::floating) {
+    arg.floating = static_cast<double>(value);
+  }
+  else if constexpr (kind == _EFormatArgKind::string) {
+    arg.string = value;
+  }
+  else {
+    using value_type = std::decay_t<Type>;
+    using char_type = std::remove_cv_t<typename _EFormatEncodedCharOf<value_type>::type>;
+
+    if constexpr (std::is_pointer_v<value_type>) {
+      arg.encoded_string = value;
+      arg.encoded_string_length = EncodingTraits<char_type>::str_length(value);
+    }
+    else {
+      arg.encoded_string = value.data();
+      arg.encoded_string_length = value.length();
+    }
+
+    arg.encoded_to_utf32 = &_EFormatEncoded<char_type>::to_utf32;
+    arg.encoded_utf32_length = &_EFormatEncoded<char_type>::utf32_length;
+  }
+
+  return arg;
+}
+
+// Parser of format string, shared by compile-time checker and runtime writer.
+class _EFormatParser {
+public:
+  // Longest allowed precision of floating point numbers.
+  static constexpr size_t max_floating_precision = 100;
+
+  // Calls 'handler.on_text(const char32_t*, size_t)' for text between fields
+  //  and 'handler.on_field(size_t index, _EFormatSpec const&)' for every field.
+  template <typename Handler>
+  static constexpr void parse(EStringView format, Handler& handler) {
+    const char32_t* it = format.begin();
+    const char32_t* end = format.end();
+    const char32_t* text_begin = it;
+
+    size_t automatic_index = 0;
+    bool is_automatic = false;
+    bool is_manual = false;
+
+    while (it != end) {
+      if (*it == U'}') {
+        if (it + 1 == end || it[1] != U'}')
+          _format_error("Unmatched '}' in format string.");
+
+        handler.on_text(text_begin, static_cast<size_t>(it + 1 - text_begin));
+        it += 2;
+        text_begin = it;
+        continue;
+      }
+
+      if (*it != U'{') {
+        ++it;
+        continue;
+      }
+
+      if (it + 1 != end && it[1] == U'{') {
+        handler.on_text(text_begin, static_cast<size_t>(it + 1 - text_begin));
+        it += 2;
+        text_begin = it;
+        continue;
+      }
+
+      handler.on_text(text_begin, static_cast<size_t>(it - text_begin));
+      ++it;
+
+      size_t index;
+
+      if (it != end && _is_digit(*it)) {
+        index = _parse_number(it, end);
+        is_manual = true;
+      }
+      else {
+        index = automatic_index++;
+        is_automatic = true;
+      }
+
+      if (is_automatic && is_manual)
+        _format_error("Automatic and manual argument indexing can't be mixed.");
+
+      _EFormatSpec spec;
+
+      if (it != end && *it == U':')
+        _parse_spec(++it, end, spec);
+
+      if (it == end || *it != U'}')
+        _format_error("Unclosed replacement field.");
+
+      ++it;
+      text_begin = it;
+
+      handler.on_field(index, spec);
+    }
+
+    handler.on_text(text_begin, static_cast<size_t>(end - text_begin));
+  }
+
+  // Check that specification can be applied to argument.
+  static constexpr void check_spec(_EFormatArgKind kind, _EFormatSpec const& spec) {
+    bool is_number = kind == _EFormatArgKind::integer || kind == _EFormatArgKind::floating;
+    bool is_string = kind == _EFormatArgKind::string || kind == _EFormatArgKind::encoded_string;
+
+    if (!is_number && (spec.sign != '-' || spec.is_alternate || spec.is_zero_padded))
+      _format_error("Sign, '#' and '0' are allowed only for numbers.");
+
+    if (spec.precision != EStringView::npos && kind != _EFormatArgKind::floating && !is_string)
+      _format_error("Precision is allowed only for floating point numbers and strings.");
+
+    if (kind == _EFormatArgKind::floating && spec.precision != EStringView::npos && spec.precision > max_floating_precision)
+      _format_error("Precision is too big.");
+
+    const char* allowed_types = "";
+
+    switch (kind) {
+      case _EFormatArgKind::boolean: allowed_types = "s"; break;
+      case _EFormatArgKind::character: allowed_types = "c"; break;
+      case _EFormatArgKind::integer: allowed_types = "dxXbBoc"; break;
+      case _EFormatArgKind::floating: allowed_types = "fFeEgG"; break;
+      default: allowed_types = "s"; break;
+    }
+
+    if (spec.type != 0 && !_contains(allowed_types, spec.type))
+      _format_error("Type isn't allowed for argument.");
+
+    if (kind == _EFormatArgKind::floating && spec.is_alternate)
+      _format_error("'#' is allowed only for integers.");
+  }
+
+private:
+  static constexpr bool _is_digit(char32_t character) noexcept {
+    return character >= U'0' && character <= U'9';
+  }
+
+  static constexpr bool _is_align(char32_t character) noexcept {
+    return character == U'<' || character == U'>' || character == U'^';
+  }
+
+  static constexpr bool _contains(const char* string, char character) noexcept {
+    for (; *string; ++string)
+      if (*string == character)
+        return true;
+
+    return false;
+  }
+
+  static constexpr size_t _parse_number(const char32_t*& it, const char32_t* end) {
+    size_t number = 0;
+
+    for (; it != end && _is_digit(*it); ++it) {
+      number = number * 10 + static_cast<size_t>(*it - U'0');
+
+      if (number > 1000000)
+        _format_error("Number in format string is too big.");
+    }
+
+    return number;
+  }
+
+  static constexpr void _parse_spec(const char32_t*& it, const char32_t* end, _EFormatSpec& spec) {
+    if (end - it >= 2 && _is_align(it[1])) {
+      if (it[0] == U'{' || it[0] == U'}')
+        _format_error("Braces can't be used as fill character.");
+
+      spec.fill = it[0];
+      spec.align = static_cast<char>(it[1]);
+      it += 2;
+    }
+    else if (it != end && _is_align(*it)) {
+      spec.align = static_cast<char>(*it);
+      ++it;
+    }
+
+    if (it != end && (*it == U'+' || *it == U'-' || *it == U' ')) {
+      spec.sign = static_cast<char>(*it);
+      ++it;
+    }
+
+    if (it != end && *it == U'#') {
+      spec.is_alternate = true;
+      ++it;
+    }
+
+    if (it != end && *it == U'0') {
+      spec.is_zero_padded = true;
+      ++it;
+    }
+
+    spec.width = _parse_number(it, end);
+
+    if (it != end && *it == U'.') {
+      ++it;
+
+      if (it == end || !_is_digit(*it))
+        _format_error("Missing precision after '.'.");
+
+      spec.precision = _parse_number(it, end);
+    }
+
+    if (it != end && *it != U'}') {
+      if (*it > 0x7F)
+        _format_error("Invalid type in format string.");
+
+      spec.type = static_cast<char>(*it);
+      ++it;
+    }
+  }
+};
+
+// Format string, checked against 'Args' at compile time.
+template <typename... Args>
+class EFormatString {
+public:
+  consteval EFormatString(const char32_t* string) : m_string(string) {
+    _Checker checker;
+    _EFormatParser::parse(m_string, checker);
+  }
+
+  constexpr EStringView get() const noexcept {
+    return m_string;
+  }
+
+private:
+  struct _Checker {
+    static constexpr std::array<_EFormatArgKind, sizeof...(Args)> kinds = { _format_arg_kind<Args>()... };
+
+    constexpr void on_text(const char32_t*, size_t) const noexcept {}
+
+    constexpr void on_field(size_t index, _EFormatSpec const& spec) const {
+      if (index >= kinds.size())
+        _format_error("Argument index is out of range.");
+
+      _EFormatParser::check_spec(kinds[index], spec);
+    }
+  };
+
+private:
+  EStringView m_string;
+};
+
+// Runtime part of format engine.
+class _EFormatter {
+public:
+  // Get number of characters, that is enough to write formatted string.
+  static size_t size_bound(EStringView format, const _EFormatArg* args) {
+    _Sizer sizer { args };
+    _EFormatParser::parse(format, sizer);
+
+    return sizer.size;
+  }
+
+  // Write formatted string to 'dest', that has at least 'size_bound()' characters. Returns end of written string.
+  static char32_t* write(EStringView format, const _EFormatArg* args, char32_t* dest) {
+    _Writer writer { args, dest };
+    _EFormatParser::parse(format, writer);
+
+    return writer.dest;
+  }
+
+private:
+  // Enough for 64 binary digits, and for fixed floating point numbers with maximal precision.
+  static constexpr size_t number_buffer_size = 512;
+
+  struct _Sizer {
+    const _EFormatArg* args;
+    size_t size = 0;
+
+    void on_text(const char32_t*, size_t length) noexcept {
+      size += length;
+    }
+
+    void on_field(size_t index, _EFormatSpec const& spec) {
+      size += _field_size_bound(args[index], spec);
+    }
+  };
+
+  struct _Writer {
+    const _EFormatArg* args;
+    char32_t* dest;
+
+    void on_text(const char32_t* text, size_t length) noexcept {
+      if (length != 0)
+        memcpy(dest, text, length * sizeof(char32_t));
+
+      dest += length;
+    }
+
+    void on_field(size_t index, _EFormatSpec const& spec) {
+      dest = _write_field(args[index], spec, dest);
+    }
+  };
+
+  static size_t _integer_base(char type) noexcept {
+    switch (type) {
+      case 'x': case 'X': return 16;
+      case 'b': case 'B': return 2;
+      case 'o': return 8;
+      default: return 10;
+    }
+  }
+
+  static size_t _digits_count(unsigned long long value, size_t base) noexcept {
+    size_t count = 1;
+
+    for (value /= base; value != 0; value /= base)
+      ++count;
+
+    return count;
+  }
+
+  static size_t _field_size_bound(_EFormatArg const& arg, _EFormatSpec const& spec) {
+    size_t content_size = 0;
+
+    switch (arg.kind) {
+      case _EFormatArgKind::boolean:
+        content_size = 5;
+        break;
+
+      case _EFormatArgKind::character:
+        content_size = 1;
+        break;
+
+      case _EFormatArgKind::integer:
+        // Checked here, as sizes are computed before anything is written.
+        if (spec.type == 'c' && (arg.is_negative || arg.integer > 0x10FFFF))
+          throw std::out_of_range("Integer formatted as character is out of UNICODE range.");
+
+        // Sign, prefix and digits.
+        content_size = spec.type == 'c' ? 1 : 3 + _digits_count(arg.integer, _integer_base(spec.type));
+        break;
+
+      case _EFormatArgKind::floating: {
+        size_t precision = spec.precision == EStringView::npos ? 6 : spec.precision;
+        bool is_fixed = spec.type == 'f' || spec.type == 'F';
+
+        // Fixed numbers below 1e15 have at most 15 digits before point.
+        if (is_fixed)
+          content_size = (std::fabs(arg.floating) < 1e15 ? 18 : 312) + precision;
+        else
+          content_size = 32 + precision;
+
+        break;
+      }
+
+      case _EFormatArgKind::string:
+        content_size = arg.string.length() < spec.precision ? arg.string.length() : spec.precision;
+        break;
+
+      case _EFormatArgKind::encoded_string:
+        // Encoded string is decoded before it's truncated, and decoded length isn't greater than encoded one.
+        return spec.width + arg.encoded_string_length;
+    }
+
+    return content_size > spec.width ? content_size : spec.width;
+  }
+
+  static char32_t* _fill(char32_t* dest, char32_t fill, size_t count) noexcept {
+    for (size_t index = 0; index < count; ++index)
+      *dest++ = fill;
+
+    return dest;
+  }
+
+  static char32_t* _widen(char32_t* dest, const char* string, size_t length) noexcept {
+    for (size_t index = 0; index < length; ++index)
+      *dest++ = static_cast<char32_t>(static_cast<unsigned char>(string[index]));
+
+    return dest;
+  }
+
+  // Padding before and after content of 'content_length' characters.
+  static std::pair<size_t, size_t> _padding(_EFormatSpec const& spec, size_t content_length, char default_align) noexcept {
+    if (spec.width <= content_length)
+      return { 0, 0 };
+
+    size_t padding = spec.width - content_length;
+
+    switch (spec.align ? spec.align : default_align) {
+      case '>': return { padding, 0 };
+      case '^': return { padding / 2, padding - padding / 2 };
+      default: return { 0, padding };
+    }
+  }
+
+  // Write number of sign, prefix and digits, with padding.
+  static char32_t* _write_number(char32_t* dest, _EFormatSpec const& spec, const char* prefix, size_t prefix_length, const char* digits, size_t digits_length) {
+    size_t content_length = prefix_length + digits_length;
+
+    if (spec.is_zero_padded && !spec.align) {
+      dest = _widen(dest, prefix, prefix_length);
+      dest = _fill(dest, U'0', spec.width > content_length ? spec.width - content_length : 0);
+      return _widen(dest, digits, digits_length);
+    }
+
+    auto [before, after] = _padding(spec, content_length, '>');
+
+    dest = _fill(dest, spec.fill, before);
+    dest = _widen(dest, prefix, prefix_length);
+    dest = _widen(dest, digits, digits_length);
+
+    return _fill(dest, spec.fill, after);
+  }
+
+  static size_t _write_sign(char* prefix, bool is_negative, char sign) noexcept {
+    if (is_negative) {
+      prefix[0] = '-';
+      return 1;
+    }
+
+    if (sign == '+' || sign == ' ') {
+      prefix[0] = sign;
+      return 1;
+    }
+
+    return 0;
+  }
+
+  static char32_t* _write_utf32(char32_t* dest, _EFormatSpec const& spec, EStringView string, char default_align) noexcept {
+    auto [before, after] = _padding(spec, string.length(), default_align);
+
+    dest = _fill(dest, spec.fill, before);
+
+    if (!string.is_empty())
+      memcpy(dest, string.data(), string.length() * sizeof(char32_t));
+
+    return _fill(dest + string.length(), spec.fill, after);
+  }
+
+  static char32_t* _write_field(_EFormatArg const& arg, _EFormatSpec const& spec, char32_t* dest) {
+    switch (arg.kind) {
+      case _EFormatArgKind::boolean:
+        return _write_utf32(dest, spec, arg.boolean ? EStringView(U"true", 4) : EStringView(U"false", 5), '<');
+
+      case _EFormatArgKind::character:
+        return _write_utf32(dest, spec, EStringView(&arg.character, 1), '<');
+
+      case _EFormatArgKind::integer: {
+        if (spec.type == 'c') {
+          char32_t character = static_cast<char32_t>(arg.integer);
+          return _write_utf32(dest, spec, EStringView(&character, 1), '>');
+        }
+
+        char prefix[3];
+        size_t prefix_length = _write_sign(prefix, arg.is_negative, spec.sign);
+
+        if (spec.is_alternate && spec.type && spec.type != 'd') {
+          prefix[prefix_length++] = '0';
+
+          if (spec.type != 'o')
+            prefix[prefix_length++] = spec.type;
+        }
+
+        char digits[number_buffer_size];
+        char* digits_end = std::to_chars(digits, digits + number_buffer_size, arg.integer, static_cast<int>(_integer_base(spec.type))).ptr;
+
+        if (spec.type == 'X')
+          for (char* it = digits; it != digits_end; ++it)
+            if (*it >= 'a' && *it <= 'f')
+              *it = static_cast<char>(*it - 'a' + 'A');
+
+        return _write_number(dest, spec, prefix, prefix_length, digits, static_cast<size_t>(digits_end - digits));
+      }
+
+      case _EFormatArgKind::floating: {
+        char prefix[1];
+        size_t prefix_length = _write_sign(prefix, std::signbit(arg.floating), spec.sign);
+
+        double value = std::fabs(arg.floating);
+        char digits[number_buffer_size];
+        std::to_chars_result result;
+
+        switch (spec.type) {
+          case 'f': case 'F':
+            result = std::to_chars(digits, digits + number_buffer_size, value, std::chars_format::fixed, spec.precision == EStringView::npos ? 6 : static_cast<int>(spec.precision));
+            break;
+          case 'e': case 'E':
+            result = std::to_chars(digits, digits + number_buffer_size, value, std::chars_format::scientific, spec.precision == EStringView::npos ? 6 : static_cast<int>(spec.precision));
+            break;
+          case 'g': case 'G':
+            result = std::to_chars(digits, digits + number_buffer_size, value, std::chars_format::general, spec.precision == EStringView::npos ? 6 : static_cast<int>(spec.precision));
+            break;
+          default:
+            result = spec.precision == EStringView::npos
+              ? std::to_chars(digits, digits + number_buffer_size, value)
+              : std::to_chars(digits, digits + number_buffer_size, value, std::chars_format::general, static_cast<int>(spec.precision));
+            break;
+        }
+
+        if (spec.type == 'F' || spec.type == 'E' || spec.type == 'G')
+          for (char* it = digits; it != result.ptr; ++it)
+            if (*it >= 'a' && *it <= 'z')
+              *it = static_cast<char>(*it - 'a' + 'A');
+
+        return _write_number(dest, spec, prefix, prefix_length, digits, static_cast<size_t>(result.ptr - digits));
+      }
+
+      case _EFormatArgKind::string:
+        return _write_utf32(dest, spec, arg.string.substr(0, spec.precision), '<');
+
+      case _EFormatArgKind::encoded_string: {
+        size_t length = spec.width != 0 || spec.precision != EStringView::npos
+          ? arg.encoded_utf32_length(arg.encoded_string, arg.encoded_string_length)
+          : 0;
+        size_t content_length = length < spec.precision ? length : spec.precision;
+
+        auto [before, after] = _padding(spec, content_length, '<');
+
+        dest = _fill(dest, spec.fill, before);
+
+        size_t decoded_length = arg.encoded_to_utf32(arg.encoded_string, arg.encoded_string_length, dest);
+
+        if (decoded_length > spec.precision)
+          decoded_length = spec.precision;
+
+        return _fill(dest + decoded_length, spec.fill, after);
+      }
+    }
+
+    return dest;
+  }
+};
@@ -0,0 +1,170 @@
+#pragma once
+#define EString_EStringHash_h_
+
+/*
+* This file contains hash function of utf32 strings.
+* It's a wyhash-style hash over 16-byte blocks (4 characters) of utf32 buffer.
+* Hash depends only on characters, so encoded strings are hashed by decoding them
+*  to a small stack buffer, and get same hash as equal EString.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include "EStringEncodings.h"
+#include "EStringView.h"
+
+// Streaming hasher of utf32 characters.
+// 'update()' must be called with multiples of 'block_size' characters, only 'finish()' accepts a tail.
+class _EStringHasher {
+public:
+  using size_type = size_t;
+
+  // Characters in one block.
+  static constexpr size_type block_size = 4;
+
+public:
+  void update(const char32_t* string, size_type string_size_in_chars) noexcept {
+    for (size_type index = 0; index < string_size_in_chars; index += block_size) {
+      uint64_t first_word, second_word;
+
+      memcpy(&first_word, string + index, sizeof(first_word));
+      memcpy(&second_word, string + index + 2, sizeof(second_word));
+
+      m_state = _mix(first_word ^ secret_1, second_word ^ m_state);
+    }
+
+    m_length += string_size_in_chars;
+  }
+
+  // Hash last characters (less than 'block_size') and get result.
+  size_t finish(const char32_t* tail, size_type tail_size_in_chars) noexcept {
+    char32_t block[block_size] = {};
+
+    for (size_type index = 0; index < tail_size_in_chars; ++index)
+      block[index] = tail[index];
+
+    uint64_t first_word, second_word;
+
+    memcpy(&first_word, block, sizeof(first_word));
+    memcpy(&second_word, block + 2, sizeof(second_word));
+
+    m_length += tail_size_in_chars;
+
+    uint64_t state = _mix(first_word ^ secret_1, second_word ^ m_state);
+
+    size_t result = static_cast<size_t>(_mix(state ^ secret_2, m_length ^ secret_1));
+
+    // Zero is reserved by EString as "not computed yet".
+    return result ? result : 1;
+  }
+
+  // Hash whole utf32 string.
+  static size_t hash(const char32_t* string, size_type string_size_in_chars) noexcept {
+    _EStringHasher hasher;
+    size_type blocks_size = string_size_in_chars - string_size_in_chars % block_size;
+
+    hasher.update(string, blocks_size);
+
+    return hasher.finish(string + blocks_size, string_size_in_chars - blocks_size);
+  }
+
+  // Hash encoded string, as if it was decoded to utf32.
+  // Invalid encoded string doesn't throw: its invalid code units are hashed as 'invalid_unit' sentinels,
+  //  which aren't code points, so it never gets hash of valid string by accident.
+  template <typename CharType>
+  static size_t hash_encoded(const CharType* encoded_string, size_type encoded_string_length_in_chars) {
+    bool is_valid;
+    return hash_encoded(encoded_string, encoded_string_length_in_chars, is_valid);
+  }
+
+  // Same, but also reports is encoded string valid.
+  template <typename CharType>
+  static size_t hash_encoded(const CharType* encoded_string, size_type encoded_string_length_in_chars, bool& is_valid) {
+    using unsigned_char_type = std::make_unsigned_t<CharType>;
+
+    is_valid = true;
+
+    if constexpr (std::is_same_v<CharType, char32_t>) {
+      return hash(encoded_string, encoded_string_length_in_chars);
+    }
+    else {
+      _EStringHasher hasher;
+      char32_t chunk[64];
+      size_type chunk_length = 0;
+
+      for (const CharType* end = encoded_string + encoded_string_length_in_chars; encoded_string != end;) {
+        char32_t character;
+        EEncodingError error;
+        size_type length = _decode_encoded_char_checked(encoded_string, static_cast<size_type>(end - encoded_string), character, error);
+
+        if (length == 0) {
+          // Skip single code unit, so next character is checked from the next unit.
+          character = invalid_unit | static_cast<char32_t>(static_cast<unsigned_char_type>(*encoded_string));
+          length = 1;
+          is_valid = false;
+        }
+
+        chunk[chunk_length++] = character;
+        encoded_string += length;
+
+        if (chunk_length == 64) {
+          hasher.update(chunk, chunk_length);
+          chunk_length = 0;
+        }
+      }
+
+      size_type blocks_size = chunk_length - chunk_length % block_size;
+      hasher.update(chunk, blocks_size);
+
+      return hasher.finish(chunk + blocks_size, chunk_length - blocks_size);
+    }
+  }
+
+private:
+  // Marks invalid code unit, stored in low bits, in place of character. It's above any code point.
+  static constexpr char32_t invalid_unit = 0x80000000;
+
+  static constexpr uint64_t secret_0 = 0xA0761D6478BD642Full;
+  static constexpr uint64_t secret_1 = 0xE7037ED1A0B428DBull;
+  static constexpr uint64_t secret_2 = 0x8EBC6AF09C88C6E3ull;
+
+  // Multiply to 128 bits and fold halves.
+  static uint64_t _mix(uint64_t left, uint64_t right) noexcept {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low = _umul128(left, right, &high);
+    return low ^ high;
+#else
+    uint64_t left_high = left >> 32, left_low = left & 0xFFFFFFFF;
+    uint64_t right_high = right >> 32, right_low = right & 0xFFFFFFFF;
+    uint64_t low_low = left_low * right_low, low_high = left_low * right_high;
+    uint64_t high_low = left_high * right_low, high_high = left_high * right_high;
+    uint64_t middle = (low_low >> 32) + (low_high & 0xFFFFFFFF) + (high_low & 0xFFFFFFFF);
+    uint64_t low = (middle << 32) | (low_low & 0xFFFFFFFF);
+    uint64_t high = high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+    return low ^ high;
+#endif
+  }
+
+private:
+  uint64_t m_state = secret_0;
+  uint64_t m_length = 0;
+};
+
+template <>
+struct std::hash<EStringView> {
+  size_t operator()(EStringView string) const noexcept {
+    return _EStringHasher::hash(string.data(), string.length());
+  }
+};
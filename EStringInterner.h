@@ -0,0 +1,225 @@
+#pragma once
+#define EString_EStringInterner_h_
+
+#include <stddef.h>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "EString.h"
+
+// Thread-safe string interner.
+// Stores every distinct string once, in stable storage, and identifies it by 'Handle'.
+// Handles of equal strings are equal, so they are compared and hashed in O(1).
+// Table is split into shards with own locks, so lookups of different strings rarely contend.
+// Encoded strings are decoded on the fly while hashing and comparing,
+//  so interning them doesn't build temporary EString.
+class EStringInterner {
+public:
+  using size_type = size_t;
+
+private:
+  struct _Entry {
+    EString string;
+    size_t hash;
+  };
+
+public:
+  // Interned string identifier. Valid while interner that created it is alive.
+  class Handle {
+  public:
+    constexpr Handle() = default;
+
+    // Check is handle referring to interned string. Default constructed handles don't.
+    constexpr bool is_valid() const noexcept {
+      return m_entry != nullptr;
+    }
+
+    // Get interned string. Handle must be valid.
+    EStringView view() const noexcept {
+      return m_entry->string;
+    }
+
+    EString const& string() const noexcept {
+      return m_entry->string;
+    }
+
+    size_t hash() const noexcept {
+      return std::hash<const void*>()(m_entry);
+    }
+
+    constexpr bool operator==(Handle other) const noexcept {
+      return m_entry == other.m_entry;
+    }
+
+    constexpr bool operator!=(Handle other) const noexcept {
+      return m_entry != other.m_entry;
+    }
+
+  private:
+    friend class EStringInterner;
+
+    constexpr explicit Handle(const _Entry* entry) noexcept : m_entry(entry) {}
+
+    const _Entry* m_entry = nullptr;
+  };
+
+public:
+  EStringInterner() = default;
+
+  EStringInterner(EStringInterner const&) = delete;
+  EStringInterner& operator=(EStringInterner const&) = delete;
+
+public:
+  // Get handle of string, storing it if it wasn't interned yet.
+  Handle intern(EStringView string) {
+    return _intern(string.data(), string.length());
+  }
+
+  // Throws 'encoding_failed' if encoded string is invalid, like decoding it to EString does.
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  Handle intern(const CharType* encoded_string, size_type encoded_string_length_in_chars) {
+    return _intern(encoded_string, encoded_string_length_in_chars);
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  Handle intern(const CharType* encoded_string) {
+    return _intern(encoded_string, EncodingTraits<CharType>::str_length(encoded_string));
+  }
+
+  // Get handle of string if it's interned, or invalid handle otherwise.
+  Handle find(EStringView string) const {
+    return _find(string.data(), string.length());
+  }
+
+  // Invalid encoded string is never interned, so invalid handle is returned for it instead of throwing.
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  Handle find(const CharType* encoded_string, size_type encoded_string_length_in_chars) const {
+    return _find(encoded_string, encoded_string_length_in_chars);
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  Handle find(const CharType* encoded_string) const {
+    return _find(encoded_string, EncodingTraits<CharType>::str_length(encoded_string));
+  }
+
+  // Number of interned strings.
+  size_type size() const {
+    size_type count = 0;
+
+    for (_Shard const& shard : m_shards) {
+      std::shared_lock lock(shard.mutex);
+      count += shard.entries.size();
+    }
+
+    return count;
+  }
+
+private:
+  static constexpr size_type shard_bits = 4;
+  static constexpr size_type shards_count = 1 << shard_bits;
+
+  struct _Shard {
+    mutable std::shared_mutex mutex;
+    // Entries are only appended, so references to them stay valid.
+    std::deque<_Entry> entries;
+    std::unordered_multimap<size_t, const _Entry*> table;
+  };
+
+  // Hash encoded string by its utf32 characters, so all encodings of a string get same hash.
+  // Encoded string is checked while decoded, and 'is_valid' reports result of check.
+  template <typename CharType>
+  static size_t _hash(const CharType* encoded_string, size_type encoded_string_length_in_chars, bool& is_valid) {
+    return _EStringHasher::hash_encoded(encoded_string, encoded_string_length_in_chars, is_valid);
+  }
+
+  // Compare encoded string with utf32 one, decoding it on the fly.
+  // Encoded string is raw caller input here. It's checked while decoded, and invalid characters don't match anything,
+  //  so invalid string is never found, and '_intern()' then rejects it when decoding it to EString.
+  template <typename CharType>
+  static bool _is_equal(const CharType* encoded_string, size_type encoded_string_length_in_chars, EString const& string) noexcept {
+    return _match_encoded_prefix(string.data(), string.length(), encoded_string, encoded_string_length_in_chars) == string.length();
+  }
+
+  // Utf32 strings (and 'intern(EStringView)') are compared as is, like EString compares them,
+  //  so strings with any code points (e.g. lone surrogates) match their own entries.
+  static bool _is_equal(const char32_t* utf32_string, size_type utf32_string_length, EString const& string) noexcept {
+    return EStringView(utf32_string, utf32_string_length) == EStringView(string);
+  }
+
+  // Low bits select bucket inside shard, so high bits select shard.
+  _Shard& _shard_for(size_t hash) noexcept {
+    return m_shards[hash >> (sizeof(size_t) * 8 - shard_bits)];
+  }
+
+  _Shard const& _shard_for(size_t hash) const noexcept {
+    return m_shards[hash >> (sizeof(size_t) * 8 - shard_bits)];
+  }
+
+  // Find entry in shard. Shard must be locked.
+  template <typename CharType>
+  static const _Entry* _find_in_shard(_Shard const& shard, size_t hash, const CharType* encoded_string, size_type encoded_string_length_in_chars) noexcept {
+    auto [begin, end] = shard.table.equal_range(hash);
+
+    for (auto it = begin; it != end; ++it) {
+      if (_is_equal(encoded_string, encoded_string_length_in_chars, it->second->string))
+        return it->second;
+    }
+
+    return nullptr;
+  }
+
+  template <typename CharType>
+  Handle _find(const CharType* encoded_string, size_type encoded_string_length_in_chars) const {
+    bool is_valid;
+    size_t hash = _hash(encoded_string, encoded_string_length_in_chars, is_valid);
+
+    if (!is_valid)
+      return Handle();
+
+    _Shard const& shard = _shard_for(hash);
+
+    std::shared_lock lock(shard.mutex);
+
+    return Handle(_find_in_shard(shard, hash, encoded_string, encoded_string_length_in_chars));
+  }
+
+  template <typename CharType>
+  Handle _intern(const CharType* encoded_string, size_type encoded_string_length_in_chars) {
+    // Invalid string doesn't match any entry, so it's rejected below, when decoded to EString.
+    bool is_valid;
+    size_t hash = _hash(encoded_string, encoded_string_length_in_chars, is_valid);
+    _Shard& shard = _shard_for(hash);
+
+    {
+      std::shared_lock lock(shard.mutex);
+
+      if (const _Entry* entry = _find_in_shard(shard, hash, encoded_string, encoded_string_length_in_chars))
+        return Handle(entry);
+    }
+
+    std::unique_lock lock(shard.mutex);
+
+    // Other thread could intern same string while lock was released.
+    if (const _Entry* entry = _find_in_shard(shard, hash, encoded_string, encoded_string_length_in_chars))
+      return Handle(entry);
+
+    _Entry& entry = shard.entries.emplace_back(_Entry{ EString(encoded_string, encoded_string_length_in_chars), hash });
+    shard.table.emplace(hash, &entry);
+
+    return Handle(&entry);
+  }
+
+private:
+  _Shard m_shards[shards_count];
+};
+
+template <>
+struct std::hash<EStringInterner::Handle> {
+  size_t operator()(EStringInterner::Handle handle) const noexcept {
+    return handle.hash();
+  }
+};
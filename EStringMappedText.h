@@ -0,0 +1,109 @@
+#pragma once
+#define EString_EStringMappedText_h_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "EString.h"
+
+// Read-only text of memory-mapped file, decoded lazily by pages.
+// Page is a range of about 'page_size_in_bytes' encoded bytes, that is decoded on first access,
+//  so only text that is actually read is loaded from disk and decoded.
+// Page boundaries are moved back to character boundaries, so no character is split between pages.
+// Not thread-safe: 'page()' modifies cache of decoded pages.
+class EMappedText {
+public:
+  using size_type = size_t;
+
+  static constexpr size_type default_page_size_in_bytes = 256 * 1024;
+
+public:
+  explicit EMappedText(const char* path, size_type page_size_in_bytes = default_page_size_in_bytes)
+    : m_file(path)
+  {
+    m_encoding = m_file.encoding();
+
+    m_file.visit_content([this, page_size_in_bytes](auto* content, size_type content_length_in_chars) {
+      using char_type = std::remove_cv_t<std::remove_pointer_t<decltype(content)>>;
+
+      m_page_length_in_chars = page_size_in_bytes / sizeof(char_type);
+
+      if (m_page_length_in_chars == 0)
+        m_page_length_in_chars = 1;
+
+      m_content_length_in_chars = content_length_in_chars;
+    });
+
+    size_type pages_count = (m_content_length_in_chars + m_page_length_in_chars - 1) / m_page_length_in_chars;
+
+    m_pages.resize(pages_count);
+    m_is_page_decoded.resize(pages_count, false);
+  }
+
+public:
+  EFileEncoding encoding() const noexcept {
+    return m_encoding;
+  }
+
+  size_type pages_count() const noexcept {
+    return m_pages.size();
+  }
+
+  // Get decoded characters of page. Page is decoded on first access, and kept until 'release_page()'.
+  // Next page is prefetched, so sequential reading doesn't wait for disk.
+  EStringView page(size_type page_index) {
+    if (!m_is_page_decoded[page_index]) {
+      m_file.visit_content([this, page_index](auto* content, size_type content_length_in_chars) {
+        size_type begin = _page_begin(content, content_length_in_chars, page_index);
+        size_type end = _page_begin(content, content_length_in_chars, page_index + 1);
+
+        m_pages[page_index].decode(content + begin, end - begin);
+
+        size_type char_size = sizeof(*content);
+        m_file.advise_will_need(m_file.bom_size() + end * char_size, m_page_length_in_chars * char_size);
+      });
+
+      m_is_page_decoded[page_index] = true;
+    }
+
+    return m_pages[page_index];
+  }
+
+  // Free decoded characters of page. Page will be decoded again on next access.
+  void release_page(size_type page_index) {
+    m_pages[page_index] = EString();
+    m_is_page_decoded[page_index] = false;
+  }
+
+  // Decode whole text at once.
+  EString to_estring() const {
+    EString string;
+
+    m_file.visit_content([&string](auto* content, size_type content_length_in_chars) {
+      string.decode(content, content_length_in_chars);
+    });
+
+    return string;
+  }
+
+private:
+  // First character of page, in encoded characters from the beginning of content.
+  template <typename CharType>
+  size_type _page_begin(const CharType* content, size_type content_length_in_chars, size_type page_index) const noexcept {
+    size_type begin = page_index * m_page_length_in_chars;
+
+    if (begin >= content_length_in_chars)
+      return content_length_in_chars;
+
+    return _complete_length<CharType>(content, begin);
+  }
+
+private:
+  EMappedFile m_file;
+  EFileEncoding m_encoding = EFileEncoding::utf8;
+  size_type m_content_length_in_chars = 0;
+  size_type m_page_length_in_chars = 1;
+  std::vector<EString> m_pages;
+  std::vector<bool> m_is_page_decoded;
+};
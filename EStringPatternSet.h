@@ -0,0 +1,341 @@
+#pragma once
+#define EString_EStringPatternSet_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "EString.h"
+
+// Set of patterns, compiled to Aho-Corasick automaton.
+// Finds every occurrence of every pattern in one pass over string, regardless of patterns count.
+// Transitions of shallow states (where scan spends most of the time) are dense tables of ASCII characters,
+//  other transitions are sorted arrays of characters, shared by all states.
+// Patterns are added by 'add()', then set must be compiled by 'compile()' before searching.
+// Compiled set isn't modified by searching, so it can be used by many threads at once.
+class EStringPatternSet {
+public:
+  using size_type = size_t;
+
+  struct Match {
+    // Index of pattern, in order of adding.
+    size_type pattern_index;
+    // Index of first matched character in string.
+    size_type index;
+    // Number of matched characters.
+    size_type length;
+
+    constexpr bool operator==(Match const& other) const noexcept {
+      return pattern_index == other.pattern_index && index == other.index && length == other.length;
+    }
+  };
+
+public:
+  EStringPatternSet() = default;
+
+  // Add all patterns and compile.
+  EStringPatternSet(std::initializer_list<EStringView> patterns) {
+    for (EStringView pattern : patterns)
+      add(pattern);
+
+    compile();
+  }
+
+public:
+  // Add pattern and get its index. Empty patterns never match.
+  size_type add(EStringView pattern) {
+    m_patterns.emplace_back(pattern);
+    m_is_compiled = false;
+
+    return m_patterns.size() - 1;
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  size_type add(const CharType* encoded_pattern, size_type encoded_pattern_length_in_chars) {
+    m_patterns.emplace_back(encoded_pattern, encoded_pattern_length_in_chars);
+    m_is_compiled = false;
+
+    return m_patterns.size() - 1;
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  size_type add(const CharType* encoded_pattern) {
+    return add(encoded_pattern, EncodingTraits<CharType>::str_length(encoded_pattern));
+  }
+
+  // Build automaton of added patterns.
+  void compile();
+
+  constexpr bool is_compiled() const noexcept {
+    return m_is_compiled;
+  }
+
+  size_type patterns_count() const noexcept {
+    return m_patterns.size();
+  }
+
+  EString const& pattern(size_type pattern_index) const noexcept {
+    return m_patterns[pattern_index];
+  }
+
+public:
+  // Call 'callback(Match)' for every match, ordered by end of match, longer matches first.
+  // If callback returns bool, returning false stops scanning.
+  template <typename Callback>
+  void scan(EStringView string, Callback&& callback) const {
+    _check_compiled();
+
+    uint32_t state = root_state;
+
+    for (size_type index = 0; index < string.length(); ++index) {
+      state = _next_state(state, string[index]);
+
+      for (uint32_t output_state = m_states[state].output_state; output_state != no_state; output_state = m_states[output_state].dictionary_link) {
+        _State const& output = m_states[output_state];
+
+        for (uint32_t output_index = output.outputs_begin; output_index < output.outputs_end; ++output_index) {
+          size_type pattern_index = m_outputs[output_index];
+          size_type pattern_length = m_patterns[pattern_index].length();
+
+          Match match { pattern_index, index + 1 - pattern_length, pattern_length };
+
+          if constexpr (std::is_same_v<std::invoke_result_t<Callback&, Match const&>, bool>) {
+            if (!callback(match))
+              return;
+          }
+          else {
+            callback(match);
+          }
+        }
+      }
+    }
+  }
+
+  // Get all matches, in same order as 'scan()' reports them.
+  std::vector<Match> find_all(EStringView string) const {
+    std::vector<Match> matches;
+
+    scan(string, [&matches](Match const& match) {
+      matches.push_back(match);
+    });
+
+    return matches;
+  }
+
+  // Check is any pattern found in string. Stops at first match.
+  bool contains_any(EStringView string) const {
+    bool is_found = false;
+
+    scan(string, [&is_found](Match const&) {
+      is_found = true;
+      return false;
+    });
+
+    return is_found;
+  }
+
+private:
+  static constexpr uint32_t root_state = 0;
+  static constexpr uint32_t no_state = static_cast<uint32_t>(-1);
+
+  // Characters below this have dense transitions in shallow states.
+  static constexpr char32_t dense_characters_count = 128;
+  // States not deeper than this get dense transitions.
+  static constexpr size_type dense_depth = 2;
+  // Sparse transitions up to this count are searched linearly.
+  static constexpr uint32_t linear_search_limit = 8;
+
+  struct _State {
+    // Range of transitions in 'm_edge_characters' and 'm_edge_targets', sorted by character.
+    uint32_t edges_begin = 0;
+    uint32_t edges_end = 0;
+    // Longest proper suffix that is a state too.
+    uint32_t failure = root_state;
+    // Nearest state of suffix chain (including this one) where some pattern ends, or 'no_state'.
+    uint32_t output_state = no_state;
+    // Next state of suffix chain after this one where some pattern ends, or 'no_state'.
+    uint32_t dictionary_link = no_state;
+    // Range of indices of patterns ending in this state in 'm_outputs'.
+    uint32_t outputs_begin = 0;
+    uint32_t outputs_end = 0;
+    // Row in 'm_dense_transitions', or 'no_state'.
+    uint32_t dense_row = no_state;
+  };
+
+  void _check_compiled() const {
+    if (!m_is_compiled)
+      throw std::logic_error("EStringPatternSet must be compiled before searching.");
+  }
+
+  uint32_t _find_edge(_State const& state, char32_t character) const noexcept {
+    const char32_t* begin = m_edge_characters.data() + state.edges_begin;
+    const char32_t* end = m_edge_characters.data() + state.edges_end;
+
+    if (state.edges_end - state.edges_begin <= linear_search_limit) {
+      for (const char32_t* edge = begin; edge != end; ++edge)
+        if (*edge == character)
+          return m_edge_targets[edge - m_edge_characters.data()];
+
+      return no_state;
+    }
+
+    const char32_t* edge = std::lower_bound(begin, end, character);
+
+    if (edge != end && *edge == character)
+      return m_edge_targets[edge - m_edge_characters.data()];
+
+    return no_state;
+  }
+
+  uint32_t _next_state(uint32_t state, char32_t character) const noexcept {
+    for (;;) {
+      _State const& current = m_states[state];
+
+      // Dense rows are complete, they already include failure transitions.
+      if (character < dense_characters_count && current.dense_row != no_state)
+        return m_dense_transitions[current.dense_row * dense_characters_count + character];
+
+      uint32_t target = _find_edge(current, character);
+
+      if (target != no_state)
+        return target;
+
+      if (state == root_state)
+        return root_state;
+
+      state = current.failure;
+    }
+  }
+
+private:
+  std::vector<EString> m_patterns;
+  bool m_is_compiled = false;
+
+  std::vector<_State> m_states;
+  std::vector<char32_t> m_edge_characters;
+  std::vector<uint32_t> m_edge_targets;
+  std::vector<uint32_t> m_dense_transitions;
+  std::vector<uint32_t> m_outputs;
+};
+
+inline void EStringPatternSet::compile() {
+  // Build trie with ordered children first, then flatten it.
+  std::vector<std::map<char32_t, uint32_t>> children(1);
+  std::vector<std::vector<uint32_t>> ending_patterns(1);
+  std::vector<size_type> depths(1, 0);
+
+  for (size_type pattern_index = 0; pattern_index < m_patterns.size(); ++pattern_index) {
+    EString const& pattern = m_patterns[pattern_index];
+
+    if (pattern.is_empty())
+      continue;
+
+    uint32_t state = root_state;
+
+    for (char32_t character : pattern) {
+      auto [child, is_inserted] = children[state].try_emplace(character, static_cast<uint32_t>(children.size()));
+
+      if (is_inserted) {
+        children.emplace_back();
+        ending_patterns.emplace_back();
+        depths.push_back(depths[state] + 1);
+      }
+
+      state = child->second;
+    }
+
+    ending_patterns[state].push_back(static_cast<uint32_t>(pattern_index));
+  }
+
+  size_type states_count = children.size();
+
+  m_states.assign(states_count, _State());
+  m_edge_characters.clear();
+  m_edge_targets.clear();
+  m_dense_transitions.clear();
+  m_outputs.clear();
+
+  for (uint32_t state = 0; state < states_count; ++state) {
+    _State& current = m_states[state];
+
+    current.edges_begin = static_cast<uint32_t>(m_edge_characters.size());
+
+    for (auto const& [character, child] : children[state]) {
+      m_edge_characters.push_back(character);
+      m_edge_targets.push_back(child);
+    }
+
+    current.edges_end = static_cast<uint32_t>(m_edge_characters.size());
+
+    current.outputs_begin = static_cast<uint32_t>(m_outputs.size());
+    m_outputs.insert(m_outputs.end(), ending_patterns[state].begin(), ending_patterns[state].end());
+    current.outputs_end = static_cast<uint32_t>(m_outputs.size());
+  }
+
+  // Breadth-first order guarantees that failure state of every state is processed before it.
+  std::vector<uint32_t> queue;
+  queue.reserve(states_count);
+  queue.push_back(root_state);
+
+  for (size_type queue_index = 0; queue_index < queue.size(); ++queue_index) {
+    uint32_t state = queue[queue_index];
+    _State& current = m_states[state];
+
+    if (current.outputs_begin != current.outputs_end)
+      current.output_state = state;
+    else if (state != root_state)
+      current.output_state = m_states[current.failure].output_state;
+
+    if (state != root_state)
+      current.dictionary_link = m_states[current.failure].output_state;
+
+    if (depths[state] <= dense_depth) {
+      current.dense_row = static_cast<uint32_t>(m_dense_transitions.size() / dense_characters_count);
+      m_dense_transitions.resize(m_dense_transitions.size() + dense_characters_count);
+
+      uint32_t* row = m_dense_transitions.data() + current.dense_row * dense_characters_count;
+      // Failure state is shallower, so it has dense row too.
+      const uint32_t* failure_row = state == root_state
+        ? nullptr
+        : m_dense_transitions.data() + m_states[current.failure].dense_row * dense_characters_count;
+
+      for (char32_t character = 0; character < dense_characters_count; ++character) {
+        auto child = children[state].find(character);
+
+        if (child != children[state].end())
+          row[character] = child->second;
+        else
+          row[character] = failure_row ? failure_row[character] : root_state;
+      }
+    }
+
+    for (auto const& [character, child] : children[state]) {
+      uint32_t failure = root_state;
+
+      if (state != root_state) {
+        for (uint32_t candidate = current.failure;; candidate = m_states[candidate].failure) {
+          auto transition = children[candidate].find(character);
+
+          if (transition != children[candidate].end()) {
+            failure = transition->second;
+            break;
+          }
+
+          if (candidate == root_state)
+            break;
+        }
+      }
+
+      m_states[child].failure = failure;
+      queue.push_back(child);
+    }
+  }
+
+  m_is_compiled = true;
+}
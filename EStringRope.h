@@ -0,0 +1,512 @@
+#pragma once
+#define EString_EStringRope_h_
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "EString.h"
+
+// String for large texts that are edited in the middle, e.g. documents in text editor.
+// Characters are stored in EString leaves of balanced (AVL) binary tree, every internal node knows length of its subtree.
+// Insert, erase, split and concatenation change only O(log n) nodes, instead of moving the whole tail of string.
+class ERope {
+public:
+  using size_type = size_t;
+
+  // Leaves don't grow longer than this. Leaves are built half-full, so next insertions fit into them.
+  static constexpr size_type max_leaf_length = 1024;
+
+public:
+  ERope() = default;
+
+  ERope(EStringView string) : m_root(_build(string)) {}
+
+  ERope(const char32_t* string) : ERope(EStringView(string)) {}
+
+  ERope(EString const& string) : ERope(EStringView(string)) {}
+
+  // Short string becomes the only leaf, without copying characters.
+  ERope(EString&& string) {
+    if (string.length() > max_leaf_length) {
+      m_root = _build(string);
+      return;
+    }
+
+    if (string.is_empty())
+      return;
+
+    m_root = std::make_unique<_Node>();
+    m_root->length = string.length();
+    m_root->leaf = std::move(string);
+  }
+
+  ERope(ERope const& other) : m_root(_clone(other.m_root.get())) {}
+
+  ERope(ERope&& other) noexcept = default;
+
+  ERope& operator=(ERope const& other) {
+    if (this != &other)
+      m_root = _clone(other.m_root.get());
+
+    return *this;
+  }
+
+  ERope& operator=(ERope&& other) noexcept = default;
+
+public:
+  size_type length() const noexcept {
+    return m_root ? m_root->length : 0;
+  }
+
+  size_type size() const noexcept {
+    return length();
+  }
+
+  bool is_empty() const noexcept {
+    return !m_root;
+  }
+
+  // Get character at 'index'. O(log n). Index must be less than 'length()'.
+  char32_t operator[](size_type index) const noexcept {
+    assert(index < length());
+
+    const _Node* node = m_root.get();
+
+    while (!node->is_leaf()) {
+      if (index < node->left->length) {
+        node = node->left.get();
+      }
+      else {
+        index -= node->left->length;
+        node = node->right.get();
+      }
+    }
+
+    return node->leaf[index];
+  }
+
+  void insert(size_type index, EStringView string) {
+    if (string.is_empty())
+      return;
+
+    if (index > length())
+      index = length();
+
+    // Insert into leaf in place, if it has enough space.
+    if (m_root && _insert_into_leaf(m_root.get(), index, string))
+      return;
+
+    auto [left, right] = _split(std::move(m_root), index);
+    m_root = _join(_join(std::move(left), _build(string)), std::move(right));
+  }
+
+  void insert(size_type index, char32_t character) {
+    insert(index, EStringView(&character, 1));
+  }
+
+  void append(EStringView string) {
+    insert(length(), string);
+  }
+
+  // Append other rope, taking its nodes.
+  void append(ERope&& other) {
+    m_root = _join(std::move(m_root), std::move(other.m_root));
+  }
+
+  // Erase 'count' characters starting at 'index'. Range is clamped to the end of rope.
+  void erase(size_type index, size_type count = EStringView::npos) {
+    if (index >= length())
+      return;
+
+    if (count > length() - index)
+      count = length() - index;
+
+    auto [left, rest] = _split(std::move(m_root), index);
+    auto [erased, right] = _split(std::move(rest), count);
+
+    m_root = _join(std::move(left), std::move(right));
+  }
+
+  // Move characters starting at 'index' to new rope.
+  ERope split(size_type index) {
+    if (index > length())
+      index = length();
+
+    auto [left, right] = _split(std::move(m_root), index);
+
+    m_root = std::move(left);
+
+    ERope result;
+    result.m_root = std::move(right);
+
+    return result;
+  }
+
+  void clear() noexcept {
+    m_root.reset();
+  }
+
+  // Call 'callback(EStringView)' for every leaf, from left to right.
+  template <typename Callback>
+  void for_each_leaf(Callback&& callback) const {
+    _for_each_leaf(m_root.get(), callback);
+  }
+
+  EString to_estring() const {
+    EString string;
+    string.reserve(length() + 1);
+
+    for_each_leaf([&string](EStringView leaf) {
+      string.append(leaf.data(), leaf.length());
+    });
+
+    return string;
+  }
+
+  // Encode leaves one by one, straight to result.
+  template <typename CharType>
+  std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encode() const {
+    using encoding_traits = EncodingTraits<CharType>;
+
+    size_type encoded_length = 0;
+
+    for_each_leaf([&encoded_length](EStringView leaf) {
+      encoded_length += _encoded_length<CharType>(leaf.data(), leaf.length());
+    });
+
+    std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encoded_string;
+    encoded_string.resize(encoded_length);
+
+    CharType* dest = encoded_string.data();
+
+    for_each_leaf([&dest](EStringView leaf) {
+      dest += encoding_traits::from_utf32(leaf.data(), leaf.length(), dest);
+    });
+
+    return encoded_string;
+  }
+
+public:
+  // Leaves of both ropes are compared in place, piece by piece where their boundaries differ.
+  bool operator==(ERope const& other) const {
+    if (length() != other.length())
+      return false;
+
+    _LeafCursor left(m_root.get());
+    _LeafCursor right(other.m_root.get());
+
+    // Lengths are equal, so both ropes end at once.
+    while (!left.is_end()) {
+      EStringView left_part = left.rest();
+      EStringView right_part = right.rest();
+      size_type count = std::min(left_part.length(), right_part.length());
+
+      if (left_part.substr(0, count) != right_part.substr(0, count))
+        return false;
+
+      left.advance(count);
+      right.advance(count);
+    }
+
+    return true;
+  }
+
+  bool operator==(EStringView string) const {
+    if (length() != string.length())
+      return false;
+
+    size_type index = 0;
+
+    for (_LeafCursor cursor(m_root.get()); !cursor.is_end(); cursor.advance(cursor.rest().length())) {
+      EStringView leaf = cursor.rest();
+
+      if (string.substr(index, leaf.length()) != leaf)
+        return false;
+
+      index += leaf.length();
+    }
+
+    return true;
+  }
+
+  bool operator==(const char32_t* string) const {
+    return operator==(EStringView(string));
+  }
+
+  bool operator!=(ERope const& other) const {
+    return !operator==(other);
+  }
+
+  bool operator!=(EStringView string) const {
+    return !operator==(string);
+  }
+
+  bool operator!=(const char32_t* string) const {
+    return !operator==(string);
+  }
+
+private:
+  struct _Node;
+  using _NodePtr = std::unique_ptr<_Node>;
+
+  struct _Node {
+    // Characters of leaf. Empty for internal nodes.
+    EString leaf;
+    // Children of internal node. Null for leaves.
+    _NodePtr left;
+    _NodePtr right;
+    // Number of characters in subtree.
+    size_type length = 0;
+    // Height of subtree, leaves have height 1.
+    int height = 1;
+
+    bool is_leaf() const noexcept {
+      return !left;
+    }
+  };
+
+  static int _height(const _Node* node) noexcept {
+    return node ? node->height : 0;
+  }
+
+  static void _update(_Node* node) noexcept {
+    node->length = node->left->length + node->right->length;
+    node->height = 1 + std::max(node->left->height, node->right->height);
+  }
+
+  static _NodePtr _make_leaf(EStringView string) {
+    _NodePtr node = std::make_unique<_Node>();
+    node->leaf = EString(string);
+    node->length = string.length();
+
+    return node;
+  }
+
+  static _NodePtr _make_internal(_NodePtr left, _NodePtr right) {
+    _NodePtr node = std::make_unique<_Node>();
+    node->left = std::move(left);
+    node->right = std::move(right);
+    _update(node.get());
+
+    return node;
+  }
+
+  // Build balanced tree of half-full leaves.
+  static _NodePtr _build(EStringView string) {
+    if (string.is_empty())
+      return nullptr;
+
+    constexpr size_type leaf_length = max_leaf_length / 2;
+
+    if (string.length() <= leaf_length)
+      return _make_leaf(string);
+
+    // Split at leaf boundary, so all leaves except the last one are full.
+    size_type leaves_count = (string.length() + leaf_length - 1) / leaf_length;
+    size_type middle = leaves_count / 2 * leaf_length;
+
+    return _make_internal(_build(string.substr(0, middle)), _build(string.substr(middle)));
+  }
+
+  static _NodePtr _clone(const _Node* node) {
+    if (!node)
+      return nullptr;
+
+    if (node->is_leaf())
+      return _make_leaf(node->leaf);
+
+    return _make_internal(_clone(node->left.get()), _clone(node->right.get()));
+  }
+
+  static _NodePtr _rotate_left(_NodePtr node) {
+    _NodePtr right = std::move(node->right);
+    node->right = std::move(right->left);
+    _update(node.get());
+    right->left = std::move(node);
+    _update(right.get());
+
+    return right;
+  }
+
+  static _NodePtr _rotate_right(_NodePtr node) {
+    _NodePtr left = std::move(node->left);
+    node->left = std::move(left->right);
+    _update(node.get());
+    left->right = std::move(node);
+    _update(left.get());
+
+    return left;
+  }
+
+  static _NodePtr _rebalance(_NodePtr node) {
+    _update(node.get());
+
+    int balance = _height(node->left.get()) - _height(node->right.get());
+
+    if (balance > 1) {
+      if (_height(node->left->left.get()) < _height(node->left->right.get()))
+        node->left = _rotate_left(std::move(node->left));
+
+      return _rotate_right(std::move(node));
+    }
+
+    if (balance < -1) {
+      if (_height(node->right->right.get()) < _height(node->right->left.get()))
+        node->right = _rotate_right(std::move(node->right));
+
+      return _rotate_left(std::move(node));
+    }
+
+    return node;
+  }
+
+  // Concatenate trees. O(difference of heights).
+  static _NodePtr _join(_NodePtr left, _NodePtr right) {
+    if (!left)
+      return right;
+
+    if (!right)
+      return left;
+
+    // Merge small neighbour leaves, so edits don't fragment rope.
+    if (left->is_leaf() && right->is_leaf() && left->length + right->length <= max_leaf_length) {
+      left->leaf.append(right->leaf);
+      left->length = left->leaf.length();
+
+      return left;
+    }
+
+    int height_difference = left->height - right->height;
+
+    if (height_difference > 1) {
+      left->right = _join(std::move(left->right), std::move(right));
+      return _rebalance(std::move(left));
+    }
+
+    if (height_difference < -1) {
+      right->left = _join(std::move(left), std::move(right->left));
+      return _rebalance(std::move(right));
+    }
+
+    return _make_internal(std::move(left), std::move(right));
+  }
+
+  // Split tree to first 'index' characters and the rest. O(log n).
+  static std::pair<_NodePtr, _NodePtr> _split(_NodePtr node, size_type index) {
+    if (!node)
+      return { nullptr, nullptr };
+
+    if (index == 0)
+      return { nullptr, std::move(node) };
+
+    if (index >= node->length)
+      return { std::move(node), nullptr };
+
+    if (node->is_leaf()) {
+      EStringView leaf = node->leaf;
+      return { _make_leaf(leaf.substr(0, index)), _make_leaf(leaf.substr(index)) };
+    }
+
+    size_type left_length = node->left->length;
+
+    if (index <= left_length) {
+      auto [left, middle] = _split(std::move(node->left), index);
+      return { std::move(left), _join(std::move(middle), std::move(node->right)) };
+    }
+
+    auto [middle, right] = _split(std::move(node->right), index - left_length);
+    return { _join(std::move(node->left), std::move(middle)), std::move(right) };
+  }
+
+  // Insert string into leaf containing 'index', if it fits there. Updates lengths on the path.
+  static bool _insert_into_leaf(_Node* node, size_type index, EStringView string) {
+    if (node->is_leaf()) {
+      if (node->length + string.length() > max_leaf_length)
+        return false;
+
+      node->leaf.insert(index, string.data(), string.length());
+      node->length += string.length();
+
+      return true;
+    }
+
+    size_type left_length = node->left->length;
+    bool is_inserted = index <= left_length
+      ? _insert_into_leaf(node->left.get(), index, string)
+      : _insert_into_leaf(node->right.get(), index - left_length, string);
+
+    if (is_inserted)
+      node->length += string.length();
+
+    return is_inserted;
+  }
+
+  // Position in leaves of rope, visited in order without recursion.
+  class _LeafCursor {
+  public:
+    explicit _LeafCursor(const _Node* root) noexcept {
+      if (root)
+        _descend(root);
+    }
+
+    bool is_end() const noexcept {
+      return m_depth == 0;
+    }
+
+    // Characters of current leaf, that aren't passed yet.
+    EStringView rest() const noexcept {
+      return EStringView(m_path[m_depth - 1]->leaf).substr(m_offset);
+    }
+
+    // Pass 'count' characters of current leaf, going to next leaf at its end.
+    void advance(size_type count) noexcept {
+      m_offset += count;
+
+      if (m_offset < m_path[m_depth - 1]->leaf.length())
+        return;
+
+      m_offset = 0;
+
+      // Stack keeps current leaf on top and right subtrees, that are still to visit, under it.
+      if (--m_depth != 0)
+        _descend(m_path[--m_depth]);
+    }
+
+  private:
+    // AVL tree of height 96 would have more leaves than fit into memory.
+    static constexpr size_type max_height = 96;
+
+    void _descend(const _Node* node) noexcept {
+      for (; !node->is_leaf(); node = node->left.get())
+        m_path[m_depth++] = node->right.get();
+
+      m_path[m_depth++] = node;
+    }
+
+    const _Node* m_path[max_height] = {};
+    size_type m_depth = 0;
+    size_type m_offset = 0;
+  };
+
+  template <typename Callback>
+  static void _for_each_leaf(const _Node* node, Callback& callback) {
+    if (!node)
+      return;
+
+    if (node->is_leaf()) {
+      callback(EStringView(node->leaf));
+      return;
+    }
+
+    _for_each_leaf(node->left.get(), callback);
+    _for_each_leaf(node->right.get(), callback);
+  }
+
+private:
+  _NodePtr m_root;
+};
@@ -0,0 +1,244 @@
+#pragma once
+#define EString_EStringSearch_h_
+
+/*
+* This file contains substring search over utf32 characters.
+* Needles up to 'EStringSearcher::horspool_threshold' characters are searched by SIMD filter:
+*  first and last characters of needle are compared with 4 (SSE2) or 8 (AVX2) positions at once,
+*  and only positions where both match are compared fully.
+* Longer needles are searched by Boyer-Moore-Horspool with bad-character table indexed by low byte
+*  of character, so it skips up to needle length characters per step.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <bit>
+#include <type_traits>
+
+#include "EStringSimd.h"
+
+class EStringSearcher {
+public:
+  using size_type = size_t;
+
+  // Returned when nothing is found.
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  // Needles longer than this are searched by Boyer-Moore-Horspool.
+  static constexpr size_type horspool_threshold = 16;
+
+public:
+  // Prepare search of 'needle'. Needle characters must outlive searcher.
+  constexpr EStringSearcher(const char32_t* needle, size_type needle_length) noexcept
+    : m_needle(needle), m_length(needle_length)
+  {
+    if (m_length <= horspool_threshold)
+      return;
+
+    for (size_type index = 0; index < table_size; ++index) {
+      m_shift[index] = m_length;
+      m_reverse_shift[index] = m_length;
+    }
+
+    // Distance from character to the end of needle, for its last occurrence before the last character.
+    for (size_type index = 0; index + 1 < m_length; ++index)
+      m_shift[m_needle[index] & table_mask] = m_length - 1 - index;
+
+    // Distance from the beginning of needle, for first occurrence after the first character.
+    for (size_type index = m_length - 1; index > 0; --index)
+      m_reverse_shift[m_needle[index] & table_mask] = index;
+  }
+
+public:
+  // Get index of first occurrence at or after 'index', or 'npos'.
+  constexpr size_type find(const char32_t* haystack, size_type haystack_length, size_type index = 0) const noexcept {
+    if (m_length > haystack_length || index > haystack_length - m_length)
+      return npos;
+
+    if (m_length == 0)
+      return index;
+
+    if (std::is_constant_evaluated())
+      return _find_naive(haystack, haystack_length, index);
+
+    if (m_length == 1)
+      return _find_character(haystack, haystack_length, index);
+
+    if (m_length <= horspool_threshold)
+      return _find_filtered(haystack, haystack_length, index);
+
+    return _find_horspool(haystack, haystack_length, index);
+  }
+
+  // Get index of last occurrence starting at or before 'index', or 'npos'.
+  constexpr size_type rfind(const char32_t* haystack, size_type haystack_length, size_type index = npos) const noexcept {
+    if (m_length > haystack_length)
+      return npos;
+
+    if (index > haystack_length - m_length)
+      index = haystack_length - m_length;
+
+    if (m_length == 0)
+      return index;
+
+    if (m_length <= horspool_threshold || std::is_constant_evaluated())
+      return _rfind_naive(haystack, index);
+
+    return _rfind_horspool(haystack, index);
+  }
+
+private:
+  static constexpr size_type table_size = 256;
+  static constexpr char32_t table_mask = 0xFF;
+
+  constexpr bool _is_match(const char32_t* position) const noexcept {
+    if (std::is_constant_evaluated()) {
+      for (size_type index = 0; index < m_length; ++index)
+        if (position[index] != m_needle[index])
+          return false;
+
+      return true;
+    }
+
+    return memcmp(position, m_needle, m_length * sizeof(char32_t)) == 0;
+  }
+
+  constexpr size_type _find_naive(const char32_t* haystack, size_type haystack_length, size_type index) const noexcept {
+    for (size_type last_index = haystack_length - m_length; index <= last_index; ++index)
+      if (haystack[index] == m_needle[0] && _is_match(haystack + index))
+        return index;
+
+    return npos;
+  }
+
+  constexpr size_type _rfind_naive(const char32_t* haystack, size_type index) const noexcept {
+    for (size_type position = index + 1; position > 0; --position)
+      if (haystack[position - 1] == m_needle[0] && _is_match(haystack + position - 1))
+        return position - 1;
+
+    return npos;
+  }
+
+  size_type _find_character(const char32_t* haystack, size_type haystack_length, size_type index) const noexcept {
+    char32_t character = m_needle[0];
+
+#if defined(ESTRING_SIMD_AVX2)
+    const __m256i wide_pattern = _mm256_set1_epi32(static_cast<int>(character));
+
+    for (; index + 8 <= haystack_length; index += 8) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + index));
+      unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, wide_pattern))));
+
+      if (mask)
+        return index + std::countr_zero(mask);
+    }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+    const __m128i pattern = _mm_set1_epi32(static_cast<int>(character));
+
+    for (; index + 4 <= haystack_length; index += 4) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + index));
+      unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, pattern))));
+
+      if (mask)
+        return index + std::countr_zero(mask);
+    }
+#endif
+
+    for (; index < haystack_length; ++index)
+      if (haystack[index] == character)
+        return index;
+
+    return npos;
+  }
+
+  size_type _find_filtered(const char32_t* haystack, size_type haystack_length, size_type index) const noexcept {
+    size_type last_index = haystack_length - m_length;
+
+    // Candidate positions must match both first and last characters of needle.
+#if defined(ESTRING_SIMD_AVX2)
+    const __m256i wide_first = _mm256_set1_epi32(static_cast<int>(m_needle[0]));
+    const __m256i wide_last = _mm256_set1_epi32(static_cast<int>(m_needle[m_length - 1]));
+
+    for (; index + 7 <= last_index; index += 8) {
+      __m256i first_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + index));
+      __m256i last_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + index + m_length - 1));
+      __m256i matches = _mm256_and_si256(_mm256_cmpeq_epi32(first_block, wide_first), _mm256_cmpeq_epi32(last_block, wide_last));
+      unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(matches)));
+
+      for (; mask; mask &= mask - 1) {
+        size_type position = index + std::countr_zero(mask);
+
+        if (_is_match(haystack + position))
+          return position;
+      }
+    }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+    const __m128i first = _mm_set1_epi32(static_cast<int>(m_needle[0]));
+    const __m128i last = _mm_set1_epi32(static_cast<int>(m_needle[m_length - 1]));
+
+    for (; index + 3 <= last_index; index += 4) {
+      __m128i first_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + index));
+      __m128i last_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + index + m_length - 1));
+      __m128i matches = _mm_and_si128(_mm_cmpeq_epi32(first_block, first), _mm_cmpeq_epi32(last_block, last));
+      unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(matches)));
+
+      for (; mask; mask &= mask - 1) {
+        size_type position = index + std::countr_zero(mask);
+
+        if (_is_match(haystack + position))
+          return position;
+      }
+    }
+#endif
+
+    return _find_naive(haystack, haystack_length, index);
+  }
+
+  // Needle is longer than 'horspool_threshold' here.
+  size_type _find_horspool(const char32_t* haystack, size_type haystack_length, size_type index) const noexcept {
+    char32_t last_character = _simd_opaque_pointer(m_needle)[m_length - 1];
+
+    for (size_type last_index = haystack_length - m_length; index <= last_index;) {
+      char32_t character = haystack[index + m_length - 1];
+
+      if (character == last_character && _is_match(haystack + index))
+        return index;
+
+      index += m_shift[character & table_mask];
+    }
+
+    return npos;
+  }
+
+  size_type _rfind_horspool(const char32_t* haystack, size_type index) const noexcept {
+    char32_t first_character = m_needle[0];
+
+    for (;;) {
+      char32_t character = haystack[index];
+
+      if (character == first_character && _is_match(haystack + index))
+        return index;
+
+      size_type shift = m_reverse_shift[character & table_mask];
+
+      if (shift > index)
+        return npos;
+
+      index -= shift;
+    }
+  }
+
+private:
+  const char32_t* m_needle;
+  size_type m_length;
+  // Bad-character shifts for forward and backward search, used only for long needles.
+  // Tables are filled by constructor only for them, so short searches don't pay for clearing 4 KB.
+  size_type m_shift[table_size];
+  size_type m_reverse_shift[table_size];
+};
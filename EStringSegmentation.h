@@ -0,0 +1,443 @@
+#pragma once
+#define EString_EStringSegmentation_h_
+
+#include <stddef.h>
+
+#include <iterator>
+
+#include "EStringUnicode.h"
+#include "EStringView.h"
+
+// Lazy text segmentation by default rules of UAX #29: user-perceived characters (extended grapheme clusters),
+//  words and sentences.
+// Segments are '[begin, end)' offsets of characters in string. Iterator finds the end of next segment when it's
+//  incremented, nothing is allocated, so counting or truncating text doesn't materialize substrings.
+// Word segments are all pieces of text between word boundaries, including spaces and punctuation.
+// Iterators keep pointer to characters, string must outlive them.
+
+enum class ESegmentation {
+  grapheme,
+  word,
+  sentence
+};
+
+struct ESegment {
+  size_t begin;
+  size_t end;
+
+  size_t length() const noexcept {
+    return end - begin;
+  }
+
+  bool operator==(ESegment const& other) const noexcept = default;
+};
+
+inline bool _esegment_is_ascii_alphanumeric(char32_t character) noexcept {
+  return (character >= U'a' && character <= U'z') || (character >= U'A' && character <= U'Z') || (character >= U'0' && character <= U'9');
+}
+
+// Get the end of grapheme cluster starting at 'begin'.
+inline size_t _esegment_grapheme_end(const char32_t* string, size_t length, size_t begin) noexcept {
+  using enum _EGraphemeBreak;
+
+  uint16_t properties = _unicode_break_properties(string[begin]);
+  _EGraphemeBreak previous = _unicode_grapheme_break(properties);
+
+  // Number of regional indicators in a row before current character (GB12, GB13).
+  size_t regional_indicators_count = previous == regional_indicator;
+  // Previous characters are 'ExtPict Extend*' or 'ExtPict Extend* ZWJ' (GB11).
+  bool is_after_pictographic = properties & _unicode_break_is_extended_pictographic;
+  bool is_after_pictographic_zwj = false;
+
+  for (size_t index = begin + 1; index < length; ++index) {
+    char32_t character = string[index];
+
+    // Fast path: ASCII characters are never joined with each other, except CR LF.
+    if ((string[index - 1] | character) < 0x80)
+      return string[index - 1] == U'\r' && character == U'\n' ? index + 1 : index;
+
+    properties = _unicode_break_properties(character);
+    _EGraphemeBreak current = _unicode_grapheme_break(properties);
+
+    bool is_joined = false;
+
+    if (previous == cr || previous == lf || previous == control) {
+      // GB3, GB4
+      is_joined = previous == cr && current == lf;
+    }
+    else if (current != cr && current != lf && current != control) {
+      // GB5 breaks before controls, the rest are GB6 - GB13.
+      is_joined = current == extend || current == zwj || current == spacing_mark || previous == prepend
+        || (previous == l && (current == l || current == v || current == lv || current == lvt))
+        || ((previous == lv || previous == v) && (current == v || current == t))
+        || ((previous == lvt || previous == t) && current == t)
+        || (is_after_pictographic_zwj && (properties & _unicode_break_is_extended_pictographic))
+        || (current == regional_indicator && regional_indicators_count % 2 == 1);
+    }
+
+    if (!is_joined)
+      return index;
+
+    is_after_pictographic_zwj = is_after_pictographic && current == zwj;
+    is_after_pictographic = (properties & _unicode_break_is_extended_pictographic) || (is_after_pictographic && current == extend);
+    regional_indicators_count = current == regional_indicator ? regional_indicators_count + 1 : 0;
+    previous = current;
+  }
+
+  return length;
+}
+
+// Get word break property of the first character at or after 'index', that isn't ignored by WB4.
+inline _EWordBreak _esegment_next_word_break(const char32_t* string, size_t length, size_t index) noexcept {
+  using enum _EWordBreak;
+
+  for (; index < length; ++index) {
+    _EWordBreak word_break = _unicode_word_break(_unicode_break_properties(string[index]));
+
+    if (word_break != extend && word_break != format && word_break != zwj)
+      return word_break;
+  }
+
+  return other;
+}
+
+// Check rules WB5 - WB16 for characters, that aren't ignored by WB4: 'last' precedes 'current',
+//  'before_last' precedes 'last' and 'next' follows 'current'.
+inline bool _esegment_is_word_joined(
+  _EWordBreak before_last, _EWordBreak last, _EWordBreak current, _EWordBreak next, size_t regional_indicators_count
+) noexcept {
+  using enum _EWordBreak;
+
+  auto is_letter = [](_EWordBreak word_break) {
+    return word_break == a_letter || word_break == hebrew_letter;
+  };
+
+  auto is_letter_separator = [](_EWordBreak word_break) {
+    return word_break == mid_letter || word_break == mid_num_let || word_break == single_quote;
+  };
+
+  auto is_number_separator = [](_EWordBreak word_break) {
+    return word_break == mid_num || word_break == mid_num_let || word_break == single_quote;
+  };
+
+  // WB5 - WB7c: words, e.g. "can't" or "e.g".
+  if (is_letter(last) && (is_letter(current) || (is_letter_separator(current) && is_letter(next))))
+    return true;
+
+  if (is_letter(before_last) && is_letter_separator(last) && is_letter(current))
+    return true;
+
+  if (last == hebrew_letter && (current == single_quote || (current == double_quote && next == hebrew_letter)))
+    return true;
+
+  if (before_last == hebrew_letter && last == double_quote && current == hebrew_letter)
+    return true;
+
+  // WB8 - WB12: numbers, e.g. "3.14" or "1,000".
+  if ((is_letter(last) || last == numeric) && current == numeric)
+    return true;
+
+  if (last == numeric && (is_letter(current) || (is_number_separator(current) && next == numeric)))
+    return true;
+
+  if (before_last == numeric && is_number_separator(last) && current == numeric)
+    return true;
+
+  // WB13 - WB13b
+  if (last == katakana && current == katakana)
+    return true;
+
+  if ((is_letter(last) || last == numeric || last == katakana || last == extend_num_let) && current == extend_num_let)
+    return true;
+
+  if (last == extend_num_let && (is_letter(current) || current == numeric || current == katakana))
+    return true;
+
+  // WB15, WB16: pairs of regional indicators (flags).
+  return last == regional_indicator && current == regional_indicator && regional_indicators_count % 2 == 1;
+}
+
+// Get the end of word segment starting at 'begin'.
+inline size_t _esegment_word_end(const char32_t* string, size_t length, size_t begin) noexcept {
+  using enum _EWordBreak;
+
+  _EWordBreak previous = _unicode_word_break(_unicode_break_properties(string[begin]));
+
+  // Last two characters, that aren't ignored by WB4.
+  _EWordBreak before_last = other;
+  _EWordBreak last = previous;
+  // Number of regional indicators in a row, that ends at last character.
+  size_t regional_indicators_count = last == regional_indicator;
+
+  for (size_t index = begin + 1; index < length; ++index) {
+    char32_t character = string[index];
+
+    // Fast path: runs of ASCII letters and digits in words and numbers (WB5, WB8 - WB10).
+    if ((last == a_letter || last == numeric) && _esegment_is_ascii_alphanumeric(character)) {
+      previous = character <= U'9' ? numeric : a_letter;
+      before_last = last;
+      last = previous;
+      regional_indicators_count = 0;
+      continue;
+    }
+
+    uint16_t properties = _unicode_break_properties(character);
+    _EWordBreak current = _unicode_word_break(properties);
+
+    // WB3 - WB4 are checked for adjacent characters.
+    if (previous == cr || previous == lf || previous == newline || current == cr || current == lf || current == newline) {
+      if (previous != cr || current != lf)
+        return index;
+    }
+    else if (current == extend || current == format || current == zwj) {
+      previous = current;
+      continue;
+    }
+    else if (!(previous == zwj && (properties & _unicode_break_is_extended_pictographic))
+      && !(previous == w_seg_space && current == w_seg_space)) {
+      _EWordBreak next = other;
+
+      if (current == mid_letter || current == mid_num_let || current == mid_num || current == single_quote || current == double_quote)
+        next = _esegment_next_word_break(string, length, index + 1);
+
+      if (!_esegment_is_word_joined(before_last, last, current, next, regional_indicators_count))
+        return index;
+    }
+
+    previous = current;
+    before_last = last;
+    last = current;
+    regional_indicators_count = current == regional_indicator ? regional_indicators_count + 1 : 0;
+  }
+
+  return length;
+}
+
+// Get the first index at or after 'index', that isn't Extend or Format (SB5).
+inline size_t _esegment_skip_sentence_ignorables(const char32_t* string, size_t length, size_t index) noexcept {
+  for (; index < length; ++index) {
+    _ESentenceBreak sentence_break = _unicode_sentence_break(_unicode_break_properties(string[index]));
+
+    if (sentence_break != _ESentenceBreak::extend && sentence_break != _ESentenceBreak::format)
+      break;
+  }
+
+  return index;
+}
+
+// Get the end of paragraph separator at 'index' (SB3, SB4).
+inline size_t _esegment_paragraph_separator_end(const char32_t* string, size_t length, size_t index) noexcept {
+  return string[index] == U'\r' && index + 1 < length && string[index + 1] == U'\n' ? index + 2 : index + 1;
+}
+
+// Get the end of sentence starting at 'begin'.
+inline size_t _esegment_sentence_end(const char32_t* string, size_t length, size_t begin) noexcept {
+  using enum _ESentenceBreak;
+
+  size_t index = begin;
+
+  while (true) {
+    // There are no boundaries before terminator or paragraph separator (SB998).
+    _ESentenceBreak terminator = other;
+
+    for (; index < length; ++index) {
+      char32_t character = string[index];
+
+      // Fast path: ASCII characters except CR, LF, '.', '!' and '?' don't end sentences.
+      if (character < 0x80 && character != U'\r' && character != U'\n' && character != U'.' && character != U'!' && character != U'?')
+        continue;
+
+      terminator = _unicode_sentence_break(_unicode_break_properties(character));
+
+      if (terminator == sep || terminator == cr || terminator == lf)
+        return _esegment_paragraph_separator_end(string, length, index);
+
+      if (terminator == a_term || terminator == s_term)
+        break;
+    }
+
+    if (index == length)
+      return length;
+
+    size_t terminator_index = index;
+    index = _esegment_skip_sentence_ignorables(string, length, index + 1);
+
+    if (index == length)
+      return length;
+
+    _ESentenceBreak next = _unicode_sentence_break(_unicode_break_properties(string[index]));
+
+    // SB6, SB7: full stop in number or abbreviation, e.g. "3.14" or "U.S.A".
+    if (terminator == a_term && next == numeric)
+      continue;
+
+    if (terminator == a_term && next == upper) {
+      size_t previous_index = terminator_index;
+      _ESentenceBreak previous = other;
+
+      while (previous_index != 0) {
+        previous = _unicode_sentence_break(_unicode_break_properties(string[--previous_index]));
+
+        if (previous != extend && previous != format)
+          break;
+      }
+
+      if (previous == upper || previous == lower)
+        continue;
+    }
+
+    // SB9, SB10: closing punctuation and spaces belong to sentence.
+    while (next == close) {
+      index = _esegment_skip_sentence_ignorables(string, length, index + 1);
+      next = index < length ? _unicode_sentence_break(_unicode_break_properties(string[index])) : other;
+    }
+
+    while (next == sp) {
+      index = _esegment_skip_sentence_ignorables(string, length, index + 1);
+      next = index < length ? _unicode_sentence_break(_unicode_break_properties(string[index])) : other;
+    }
+
+    if (index == length)
+      return length;
+
+    // SB8: full stop is followed by lowercase word, e.g. "etc. and".
+    if (terminator == a_term) {
+      size_t lookahead_index = index;
+      _ESentenceBreak lookahead = next;
+
+      while (lookahead != o_letter && lookahead != upper && lookahead != lower && lookahead != sep && lookahead != cr
+        && lookahead != lf && lookahead != a_term && lookahead != s_term && ++lookahead_index < length)
+        lookahead = _unicode_sentence_break(_unicode_break_properties(string[lookahead_index]));
+
+      if (lookahead_index < length && lookahead == lower) {
+        index = lookahead_index;
+        continue;
+      }
+    }
+
+    // SB8a
+    if (next == s_continue || next == a_term || next == s_term)
+      continue;
+
+    // SB11: sentence ends after paragraph separator or before the next character.
+    if (next == sep || next == cr || next == lf)
+      return _esegment_paragraph_separator_end(string, length, index);
+
+    return index;
+  }
+}
+
+template <ESegmentation Segmentation>
+class ESegmentIterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = ESegment;
+  using difference_type = ptrdiff_t;
+  using pointer = const ESegment*;
+  using reference = ESegment;
+
+public:
+  ESegmentIterator() noexcept = default;
+
+  ESegmentIterator(const char32_t* string, size_t length, size_t begin) noexcept
+    : m_string(string), m_length(length), m_segment{ begin, _end(begin) } {}
+
+public:
+  ESegment operator*() const noexcept {
+    return m_segment;
+  }
+
+  const ESegment* operator->() const noexcept {
+    return &m_segment;
+  }
+
+  ESegmentIterator& operator++() noexcept {
+    m_segment = ESegment{ m_segment.end, _end(m_segment.end) };
+    return *this;
+  }
+
+  ESegmentIterator operator++(int) noexcept {
+    ESegmentIterator iterator = *this;
+    operator++();
+
+    return iterator;
+  }
+
+  bool operator==(ESegmentIterator const& other) const noexcept {
+    return m_segment.begin == other.m_segment.begin;
+  }
+
+private:
+  size_t _end(size_t begin) const noexcept {
+    if (begin >= m_length)
+      return begin;
+
+    if constexpr (Segmentation == ESegmentation::grapheme)
+      return _esegment_grapheme_end(m_string, m_length, begin);
+    else if constexpr (Segmentation == ESegmentation::word)
+      return _esegment_word_end(m_string, m_length, begin);
+    else
+      return _esegment_sentence_end(m_string, m_length, begin);
+  }
+
+private:
+  const char32_t* m_string = nullptr;
+  size_t m_length = 0;
+  ESegment m_segment = { 0, 0 };
+};
+
+// Range of segments of string.
+template <ESegmentation Segmentation>
+class ESegments {
+public:
+  using iterator = ESegmentIterator<Segmentation>;
+  using const_iterator = iterator;
+
+public:
+  ESegments(EStringView string) noexcept : m_string(string) {}
+
+public:
+  iterator begin() const noexcept {
+    return iterator(m_string.data(), m_string.length(), 0);
+  }
+
+  iterator end() const noexcept {
+    return iterator(m_string.data(), m_string.length(), m_string.length());
+  }
+
+  // Count segments, e.g. user-perceived characters.
+  size_t count() const noexcept {
+    size_t count = 0;
+
+    for (iterator iterator = begin(), end_iterator = end(); iterator != end_iterator; ++iterator)
+      ++count;
+
+    return count;
+  }
+
+  // Get prefix of string, that has at most 'max_count' segments, e.g. to truncate text without splitting characters.
+  EStringView prefix(size_t max_count) const noexcept {
+    size_t prefix_length = 0;
+
+    for (iterator iterator = begin(), end_iterator = end(); max_count != 0 && iterator != end_iterator; ++iterator, --max_count)
+      prefix_length = iterator->end;
+
+    return m_string.substr(0, prefix_length);
+  }
+
+private:
+  EStringView m_string;
+};
+
+// Segment EString, EStringView or any string convertible to EStringView.
+inline ESegments<ESegmentation::grapheme> egraphemes(EStringView string) noexcept {
+  return ESegments<ESegmentation::grapheme>(string);
+}
+
+inline ESegments<ESegmentation::word> ewords(EStringView string) noexcept {
+  return ESegments<ESegmentation::word>(string);
+}
+
+inline ESegments<ESegmentation::sentence> esentences(EStringView string) noexcept {
+  return ESegments<ESegmentation::sentence>(string);
+}
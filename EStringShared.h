@@ -0,0 +1,228 @@
+#pragma once
+#define EString_EStringShared_h_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <string>
+#include <utility>
+
+#include "EString.h"
+
+// Immutable string with atomically reference-counted buffer.
+// Copies are O(1) and share characters, so one string can be passed to many threads,
+//  and every thread can read it without synchronization.
+// Constructing from 'EString&&' takes its buffer, without copying characters.
+class ESharedString {
+public:
+  using size_type = size_t;
+
+public:
+  ESharedString() = default;
+
+  ESharedString(EString&& string) : m_shared(new _Shared(std::move(string))) {}
+
+  ESharedString(EString const& string) : m_shared(new _Shared(EString(string))) {}
+
+  ESharedString(EStringView string) : m_shared(new _Shared(EString(string))) {}
+
+  ESharedString(const char32_t* utf32_string) : m_shared(new _Shared(EString(utf32_string))) {}
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  ESharedString(const CharType* encoded_string) : m_shared(new _Shared(EString(encoded_string))) {}
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  ESharedString(const CharType* encoded_string, size_type encoded_string_length_in_chars)
+    : m_shared(new _Shared(EString(encoded_string, encoded_string_length_in_chars))) {}
+
+  ESharedString(ESharedString const& other) noexcept : m_shared(other.m_shared) {
+    _retain();
+  }
+
+  ESharedString(ESharedString&& other) noexcept : m_shared(other.m_shared) {
+    other.m_shared = nullptr;
+  }
+
+  ESharedString& operator=(ESharedString const& other) noexcept {
+    if (m_shared != other.m_shared) {
+      _release();
+      m_shared = other.m_shared;
+      _retain();
+    }
+
+    return *this;
+  }
+
+  ESharedString& operator=(ESharedString&& other) noexcept {
+    if (this != &other) {
+      _release();
+      m_shared = other.m_shared;
+      other.m_shared = nullptr;
+    }
+
+    return *this;
+  }
+
+  ~ESharedString() {
+    _release();
+  }
+
+public:
+  template <typename CharType>
+  std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encode() const {
+    return _string().encode<CharType>();
+  }
+
+  // Copy characters to new mutable string.
+  EString to_estring() const {
+    return _string();
+  }
+
+public:
+  const char32_t* c_str() const noexcept {
+    return _string().c_str();
+  }
+
+  const char32_t* data() const noexcept {
+    return _string().data();
+  }
+
+  const char32_t* begin() const noexcept {
+    return _string().begin();
+  }
+
+  const char32_t* end() const noexcept {
+    return _string().end();
+  }
+
+  char32_t front() const noexcept {
+    return _string().front();
+  }
+
+  char32_t back() const noexcept {
+    return _string().back();
+  }
+
+  bool is_empty() const noexcept {
+    return _string().is_empty();
+  }
+
+  size_type length() const noexcept {
+    return _string().length();
+  }
+
+  size_type size() const noexcept {
+    return _string().size();
+  }
+
+  // Number of strings sharing this buffer. Empty strings share nothing and return 0.
+  size_type use_count() const noexcept {
+    return m_shared ? m_shared->reference_count.load(std::memory_order_relaxed) : 0;
+  }
+
+  char32_t operator[](size_type index) const noexcept {
+    return _string()[index];
+  }
+
+  // 'startswith', 'endswith' and 'contains' accept same arguments as EString ones.
+  template <typename... Args>
+  bool startswith(Args&&... args) const {
+    return _string().startswith(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  bool endswith(Args&&... args) const {
+    return _string().endswith(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  bool contains(Args&&... args) const {
+    return _string().contains(std::forward<Args>(args)...);
+  }
+
+  operator EStringView() const noexcept {
+    return _string();
+  }
+
+  operator EString const&() const noexcept {
+    return _string();
+  }
+
+public:
+  bool operator==(ESharedString const& string) const noexcept {
+    return m_shared == string.m_shared || _string() == string._string();
+  }
+
+  bool operator==(EString const& string) const noexcept {
+    return _string() == string;
+  }
+
+  bool operator==(EStringView string) const noexcept {
+    return _string() == string;
+  }
+
+  bool operator==(const char32_t* string) const noexcept {
+    return _string() == string;
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  bool operator==(const CharType* string) const {
+    return _string() == string;
+  }
+
+  bool operator!=(ESharedString const& string) const noexcept {
+    return !operator==(string);
+  }
+
+  bool operator!=(EString const& string) const noexcept {
+    return !operator==(string);
+  }
+
+  bool operator!=(EStringView string) const noexcept {
+    return !operator==(string);
+  }
+
+  bool operator!=(const char32_t* string) const noexcept {
+    return !operator==(string);
+  }
+
+  template <typename CharType, typename = std::enable_if_t<has_encoding_traits_v<CharType>>>
+  bool operator!=(const CharType* string) const {
+    return !operator==(string);
+  }
+
+private:
+  // Control block, shared by all copies.
+  struct _Shared {
+    explicit _Shared(EString&& value) noexcept : string(std::move(value)) {}
+
+    std::atomic<size_type> reference_count = 1;
+    const EString string;
+  };
+
+  static EString const& _empty_string() noexcept {
+    static const EString empty_string;
+    return empty_string;
+  }
+
+  EString const& _string() const noexcept {
+    return m_shared ? m_shared->string : _empty_string();
+  }
+
+  void _retain() noexcept {
+    if (m_shared)
+      m_shared->reference_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void _release() noexcept {
+    // Last owner must see all writes of other owners before deleting.
+    if (m_shared && m_shared->reference_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete m_shared;
+
+    m_shared = nullptr;
+  }
+
+private:
+  // Shared control block, or nullptr for empty string.
+  _Shared* m_shared = nullptr;
+};
@@ -0,0 +1,747 @@
+#pragma once
+#define EString_EStringSimd_h_
+
+/*
+* This file contains SIMD kernels used by encoding traits.
+* Every kernel has a scalar fallback, so it can be used on any target.
+* Kernels are not constexpr, so callers must check 'std::is_constant_evaluated()'
+*  before calling them.
+*
+* NOTE: SSE2 is used on every x86-64 target, AVX2 is used only when compiler
+*  targets it (i.e. '-mavx2' or '/arch:AVX2').
+*/
+
+#include <stddef.h>
+
+#include <bit>
+
+#if defined(__AVX2__)
+#define ESTRING_SIMD_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ESTRING_SIMD_SSE2
+#endif
+
+#if defined(ESTRING_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(ESTRING_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+// Hide where pointer comes from, so optimizer doesn't know size of array it points to.
+// Kernels get length found at run time, so GCC can't prove that block loop (or long needle search)
+//  is skipped for short constant array, and warns about reads past it (-Warray-bounds). Pointer itself isn't changed.
+template <typename Unit>
+inline const Unit* _simd_opaque_pointer(const Unit* pointer) noexcept {
+#if defined(__GNUC__) && !defined(__clang__)
+  __asm__("" : "+r"(pointer));
+#endif
+  return pointer;
+}
+
+// Copy leading ASCII characters of utf8 'string' to 'dest', widening them to utf32.
+// Returns number of copied characters. Stops at first non-ASCII byte.
+// 'Unit' is any 4-byte character type, i.e. 'char32_t' or 'wchar_t' outside Windows.
+template <typename Unit>
+inline size_t _simd_utf8_widen_ascii(const char8_t* string, size_t string_size, Unit* dest) noexcept {
+  static_assert(sizeof(Unit) == 4);
+
+  size_t index = 0;
+
+#if defined(ESTRING_SIMD_AVX2)
+  for (; index + 32 <= string_size; index += 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(string + index));
+
+    if (_mm256_movemask_epi8(block) != 0)
+      break;
+
+    __m128i low = _mm256_castsi256_si128(block);
+    __m128i high = _mm256_extracti128_si256(block, 1);
+    __m256i* out = reinterpret_cast<__m256i*>(dest + index);
+
+    _mm256_storeu_si256(out + 0, _mm256_cvtepu8_epi32(low));
+    _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+    _mm256_storeu_si256(out + 2, _mm256_cvtepu8_epi32(high));
+    _mm256_storeu_si256(out + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+  }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+
+  for (; index + 16 <= string_size; index += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + index));
+
+    if (_mm_movemask_epi8(block) != 0)
+      break;
+
+    __m128i low = _mm_unpacklo_epi8(block, zero);
+    __m128i high = _mm_unpackhi_epi8(block, zero);
+    __m128i* out = reinterpret_cast<__m128i*>(dest + index);
+
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(low, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+  }
+#endif
+
+  for (; index < string_size && string[index] < 0x80; ++index)
+    dest[index] = static_cast<Unit>(string[index]);
+
+  return index;
+}
+
+// Copy leading ASCII characters of utf8 'string' to 'dest', widening them to utf16.
+// Returns number of copied characters. Stops at first non-ASCII byte.
+// 'Unit' is any 2-byte character type, i.e. 'char16_t' or 'wchar_t' on Windows.
+template <typename Unit>
+inline size_t _simd_utf8_widen_ascii_to_utf16(const char8_t* string, size_t string_size, Unit* dest) noexcept {
+  static_assert(sizeof(Unit) == 2);
+
+  size_t index = 0;
+
+#if defined(ESTRING_SIMD_AVX2)
+  for (; index + 32 <= string_size; index += 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(string + index));
+
+    if (_mm256_movemask_epi8(block) != 0)
+      break;
+
+    __m256i* out = reinterpret_cast<__m256i*>(dest + index);
+
+    _mm256_storeu_si256(out + 0, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(block)));
+    _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(block, 1)));
+  }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+
+  for (; index + 16 <= string_size; index += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + index));
+
+    if (_mm_movemask_epi8(block) != 0)
+      break;
+
+    __m128i* out = reinterpret_cast<__m128i*>(dest + index);
+
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi8(block, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(block, zero));
+  }
+#endif
+
+  for (; index < string_size && string[index] < 0x80; ++index)
+    dest[index] = static_cast<Unit>(string[index]);
+
+  return index;
+}
+
+// Copy leading ASCII characters of utf16 'string' to 'dest', narrowing them to utf8.
+// Returns number of copied characters. Stops at first non-ASCII word.
+template <typename Unit>
+inline size_t _simd_utf16_narrow_ascii(const Unit* string, size_t string_size, char8_t* dest) noexcept {
+  static_assert(sizeof(Unit) == 2);
+
+  size_t index = 0;
+
+#if defined(ESTRING_SIMD_AVX2)
+  const __m256i wide_not_ascii = _mm256_set1_epi16(static_cast<short>(0xFF80));
+
+  for (; index + 32 <= string_size; index += 32) {
+    const __m256i* in = reinterpret_cast<const __m256i*>(string + index);
+    __m256i first = _mm256_loadu_si256(in);
+    __m256i second = _mm256_loadu_si256(in + 1);
+
+    if (!_mm256_testz_si256(_mm256_or_si256(first, second), wide_not_ascii))
+      break;
+
+    // Pack works within 128-bit lanes, so lanes are reordered after it.
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + index), packed);
+  }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+  const __m128i not_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+
+  for (; index + 16 <= string_size; index += 16) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(string + index);
+    __m128i first = _mm_loadu_si128(in);
+    __m128i second = _mm_loadu_si128(in + 1);
+    __m128i overflow = _mm_and_si128(_mm_or_si128(first, second), not_ascii);
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(overflow, zero)) != 0xFFFF)
+      break;
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + index), _mm_packus_epi16(first, second));
+  }
+#endif
+
+  for (; index < string_size && string[index] < 0x80; ++index)
+    dest[index] = static_cast<char8_t>(string[index]);
+
+  return index;
+}
+
+// Count characters in utf8 'string', i.e. number of bytes that are not continuation bytes.
+inline size_t _simd_utf8_count_code_points(const char8_t* string, size_t string_size) noexcept {
+  size_t count = 0;
+  size_t index = 0;
+
+  string = _simd_opaque_pointer(string);
+
+  // Continuation bytes are 0x80..0xBF, i.e. -128..-65 as signed bytes,
+  //  so every byte greater than (signed)0xBF starts a character.
+#if defined(ESTRING_SIMD_AVX2)
+  const __m256i wide_threshold = _mm256_set1_epi8(static_cast<char>(0xBF));
+  const size_t wide_blocks_end = string_size - string_size % 32;
+
+  for (; index < wide_blocks_end; index += 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(string + index));
+    unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(block, wide_threshold)));
+
+    count += std::popcount(mask);
+  }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+  const __m128i threshold = _mm_set1_epi8(static_cast<char>(0xBF));
+  // Bound is computed once, so compiler sees that the loop is skipped for short strings.
+  const size_t blocks_end = string_size - string_size % 16;
+
+  for (; index < blocks_end; index += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + index));
+    unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpgt_epi8(block, threshold)));
+
+    count += std::popcount(mask);
+  }
+#endif
+
+  for (; index < string_size; ++index)
+    count += (string[index] & 0xC0) != 0x80;
+
+  return count;
+}
+
+// Count bytes needed to encode utf32 'string' to utf8.
+inline size_t _simd_utf8_encoded_length(const char32_t* string, size_t string_size) noexcept {
+  size_t length = string_size;
+  size_t index = 0;
+
+  // Every character takes one byte, plus one for each of thresholds 0x7F, 0x7FF and 0xFFFF it exceeds.
+  // Lane counters are flushed before they can overflow.
+#if defined(ESTRING_SIMD_AVX2)
+  const __m256i wide_threshold_1 = _mm256_set1_epi32(0x7F);
+  const __m256i wide_threshold_2 = _mm256_set1_epi32(0x7FF);
+  const __m256i wide_threshold_3 = _mm256_set1_epi32(0xFFFF);
+
+  while (index + 8 <= string_size) {
+    __m256i counters = _mm256_setzero_si256();
+
+    for (size_t block = 0; block < 0x10000 && index + 8 <= string_size; ++block, index += 8) {
+      __m256i characters = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(string + index));
+
+      counters = _mm256_sub_epi32(counters, _mm256_cmpgt_epi32(characters, wide_threshold_1));
+      counters = _mm256_sub_epi32(counters, _mm256_cmpgt_epi32(characters, wide_threshold_2));
+      counters = _mm256_sub_epi32(counters, _mm256_cmpgt_epi32(characters, wide_threshold_3));
+    }
+
+    alignas(32) unsigned int lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counters);
+
+    for (unsigned int lane : lanes)
+      length += lane;
+  }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+  const __m128i threshold_1 = _mm_set1_epi32(0x7F);
+  const __m128i threshold_2 = _mm_set1_epi32(0x7FF);
+  const __m128i threshold_3 = _mm_set1_epi32(0xFFFF);
+
+  while (index + 4 <= string_size) {
+    __m128i counters = _mm_setzero_si128();
+
+    for (size_t block = 0; block < 0x10000 && index + 4 <= string_size; ++block, index += 4) {
+      __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + index));
+
+      counters = _mm_sub_epi32(counters, _mm_cmpgt_epi32(characters, threshold_1));
+      counters = _mm_sub_epi32(counters, _mm_cmpgt_epi32(characters, threshold_2));
+      counters = _mm_sub_epi32(counters, _mm_cmpgt_epi32(characters, threshold_3));
+    }
+
+    alignas(16) unsigned int lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), counters);
+
+    for (unsigned int lane : lanes)
+      length += lane;
+  }
+#endif
+
+  for (; index < string_size; ++index) {
+    char32_t character = string[index];
+    length += (character > 0x7F) + (character > 0x7FF) + (character > 0xFFFF);
+  }
+
+  return length;
+}
+
+#if defined(ESTRING_SIMD_SSE2)
+
+// Check that every lane of 'characters' has no bits set in 'mask'.
+inline bool _simd_all_lanes_fit(__m128i characters, __m128i mask) noexcept {
+  __m128i overflow = _mm_and_si128(characters, mask);
+  return _mm_movemask_epi8(_mm_cmpeq_epi32(overflow, _mm_setzero_si128())) == 0xFFFF;
+}
+
+// Check that every lane of 'characters' has some bits set in 'mask'.
+inline bool _simd_no_lanes_fit(__m128i characters, __m128i mask) noexcept {
+  __m128i overflow = _mm_and_si128(characters, mask);
+  return _mm_movemask_epi8(_mm_cmpeq_epi32(overflow, _mm_setzero_si128())) == 0;
+}
+
+#endif
+
+// Encode leading blocks of utf32 'string' to utf8, where each block is either 16 ASCII characters,
+//  8 two-byte characters or 4 three-byte characters.
+// Returns number of encoded characters and stores number of written bytes to 'written_size'.
+// Stops at first block that mixes character sizes, the rest should be encoded one by one.
+// 'Unit' is any 4-byte character type, i.e. 'char32_t' or 'wchar_t' outside Windows.
+template <typename Unit>
+inline size_t _simd_utf32_to_utf8_blocks(const Unit* string, size_t string_size, char8_t* dest, size_t& written_size) noexcept {
+  static_assert(sizeof(Unit) == 4);
+
+  size_t index = 0;
+  char8_t* out = dest;
+
+#if defined(ESTRING_SIMD_SSE2)
+  const __m128i not_1_byte = _mm_set1_epi32(~0x7F);
+  const __m128i not_2_byte = _mm_set1_epi32(~0x7FF);
+  const __m128i not_3_byte = _mm_set1_epi32(~0xFFFF);
+  const __m128i low_6_bits = _mm_set1_epi32(0x3F);
+  const __m128i lead_2_byte = _mm_set1_epi32(0xC0);
+  const __m128i continuation = _mm_set1_epi32(0x80);
+  const __m128i surrogate_mask = _mm_set1_epi32(~0x7FF);
+  const __m128i surrogate_bits = _mm_set1_epi32(0xD800);
+
+  while (index + 4 <= string_size) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(string + index);
+    __m128i first = _mm_loadu_si128(in);
+
+    if (index + 16 <= string_size) {
+      __m128i second = _mm_loadu_si128(in + 1);
+      __m128i third = _mm_loadu_si128(in + 2);
+      __m128i fourth = _mm_loadu_si128(in + 3);
+      __m128i all = _mm_or_si128(_mm_or_si128(first, second), _mm_or_si128(third, fourth));
+
+      if (_simd_all_lanes_fit(all, not_1_byte)) {
+        // Every character is below 0x80, so saturating packs keep them intact.
+        __m128i low = _mm_packs_epi32(first, second);
+        __m128i high = _mm_packs_epi32(third, fourth);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(low, high));
+
+        index += 16;
+        out += 16;
+        continue;
+      }
+    }
+
+    if (index + 8 <= string_size) {
+      __m128i second = _mm_loadu_si128(in + 1);
+
+      if (
+        _simd_all_lanes_fit(_mm_or_si128(first, second), not_2_byte) &&
+        _simd_no_lanes_fit(first, not_1_byte) &&
+        _simd_no_lanes_fit(second, not_1_byte)
+      ) {
+        // Build 16-bit words '110xxxxx 10xxxxxx' in little-endian byte order.
+        __m128i first_words = _mm_or_si128(
+          _mm_or_si128(lead_2_byte, _mm_srli_epi32(first, 6)),
+          _mm_slli_epi32(_mm_or_si128(continuation, _mm_and_si128(first, low_6_bits)), 8)
+        );
+        __m128i second_words = _mm_or_si128(
+          _mm_or_si128(lead_2_byte, _mm_srli_epi32(second, 6)),
+          _mm_slli_epi32(_mm_or_si128(continuation, _mm_and_si128(second, low_6_bits)), 8)
+        );
+
+        // Sign-extend words, so signed saturating pack keeps their bits.
+        first_words = _mm_srai_epi32(_mm_slli_epi32(first_words, 16), 16);
+        second_words = _mm_srai_epi32(_mm_slli_epi32(second_words, 16), 16);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(first_words, second_words));
+
+        index += 8;
+        out += 16;
+        continue;
+      }
+    }
+
+    // Blocks with surrogates are left to character by character encoding, that rejects them.
+    if (
+      _simd_all_lanes_fit(first, not_3_byte) &&
+      _simd_no_lanes_fit(first, not_2_byte) &&
+      _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(first, surrogate_mask), surrogate_bits)) == 0
+    ) {
+      for (size_t end = index + 4; index < end; ++index, out += 3) {
+        char32_t character = static_cast<char32_t>(string[index]);
+
+        out[0] = static_cast<char8_t>(0xE0 | (character >> 12));
+        out[1] = static_cast<char8_t>(0x80 | ((character >> 6) & 0x3F));
+        out[2] = static_cast<char8_t>(0x80 | (character & 0x3F));
+      }
+
+      continue;
+    }
+
+    break;
+  }
+#else
+  (void)string;
+  (void)string_size;
+#endif
+
+  written_size = static_cast<size_t>(out - dest);
+
+  return index;
+}
+
+// Whether '_simd_utf8_valid_prefix()' checks non-ASCII characters. Without it utf8 is checked while decoding.
+#if defined(ESTRING_SIMD_AVX2)
+constexpr bool _simd_has_utf8_validator = true;
+#else
+constexpr bool _simd_has_utf8_validator = false;
+#endif
+
+#if defined(ESTRING_SIMD_AVX2)
+
+// Get 'input' shifted by 'Count' bytes, with last bytes of 'previous_input' shifted in.
+template <int Count>
+inline __m256i _simd_shift_in(__m256i input, __m256i previous_input) noexcept {
+  return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous_input, input, 0x21), 16 - Count);
+}
+
+// Find errors in 32 bytes of utf8, using lookup tables of invalid pairs of bytes
+//  (see "Validating UTF-8 In Less Than One Instruction Per Byte", J. Keiser, D. Lemire).
+// Sequences that continue past the end of 'input' are not errors here.
+inline __m256i _simd_utf8_block_errors(__m256i input, __m256i previous_input) noexcept {
+  // Each bit is a kind of invalid pair of bytes, pair is invalid if bit is set in all three tables.
+  constexpr char too_short = 1 << 0;      // Lead byte, followed by non-continuation byte.
+  constexpr char too_long = 1 << 1;       // ASCII byte, followed by continuation byte.
+  constexpr char overlong_3 = 1 << 2;     // 11100000 100_____
+  constexpr char too_large = 1 << 3;      // 11110100 1001____, 11110100 101_____, 11110101+ 10______
+  constexpr char surrogate = 1 << 4;      // 11101101 101_____
+  constexpr char overlong_2 = 1 << 5;     // 1100000_ 10______
+  constexpr char too_large_1000 = 1 << 6; // 11110101+ 1000____
+  constexpr char overlong_4 = 1 << 6;     // 11110000 1000____
+  constexpr char two_continuations = static_cast<char>(1 << 7);
+  constexpr char carry = too_short | too_long | two_continuations;
+
+  const __m256i byte_1_high_table = _mm256_setr_epi8(
+    too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+    two_continuations, two_continuations, two_continuations, two_continuations,
+    too_short | overlong_2, too_short, too_short | overlong_3 | surrogate, too_short | too_large | too_large_1000 | overlong_4,
+    too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+    two_continuations, two_continuations, two_continuations, two_continuations,
+    too_short | overlong_2, too_short, too_short | overlong_3 | surrogate, too_short | too_large | too_large_1000 | overlong_4
+  );
+
+  const __m256i byte_1_low_table = _mm256_setr_epi8(
+    carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+    carry | too_large, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000 | surrogate, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+    carry | too_large, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000 | surrogate, carry | too_large | too_large_1000, carry | too_large | too_large_1000
+  );
+
+  constexpr char continuation_1000 = too_long | overlong_2 | two_continuations | overlong_3 | too_large_1000 | overlong_4;
+  constexpr char continuation_1001 = too_long | overlong_2 | two_continuations | overlong_3 | too_large;
+  constexpr char continuation_101 = too_long | overlong_2 | two_continuations | surrogate | too_large;
+
+  const __m256i byte_2_high_table = _mm256_setr_epi8(
+    too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+    continuation_1000, continuation_1001, continuation_101, continuation_101,
+    too_short, too_short, too_short, too_short,
+    too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+    continuation_1000, continuation_1001, continuation_101, continuation_101,
+    too_short, too_short, too_short, too_short
+  );
+
+  const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+
+  __m256i previous_1 = _simd_shift_in<1>(input, previous_input);
+
+  __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, _mm256_and_si256(_mm256_srli_epi16(previous_1, 4), low_nibble));
+  __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(previous_1, low_nibble));
+  __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+
+  __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+  // Third and fourth bytes of sequences must be continuations, that is reported as 'two_continuations' above.
+  __m256i is_third_byte = _mm256_subs_epu8(_simd_shift_in<2>(input, previous_input), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+  __m256i is_fourth_byte = _mm256_subs_epu8(_simd_shift_in<3>(input, previous_input), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+  __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+  return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+#endif
+
+// Get length of prefix of utf8 'string', that is known to be valid.
+// Prefix ends at character boundary, before the first invalid character (if any),
+//  the rest should be checked by scalar validator to find exact error.
+inline size_t _simd_utf8_valid_prefix(const char8_t* string, size_t string_size) noexcept {
+  size_t index = 0;
+
+  string = _simd_opaque_pointer(string);
+
+#if defined(ESTRING_SIMD_AVX2)
+  // Last 3 bytes of block, that start sequence longer than rest of block.
+  const __m256i incomplete_threshold = _mm256_setr_epi8(
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1)
+  );
+
+  __m256i previous_input = _mm256_setzero_si256();
+  __m256i previous_incomplete = _mm256_setzero_si256();
+  const size_t blocks_end = string_size - string_size % 32;
+
+  for (; index < blocks_end; index += 32) {
+    __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(string + index));
+
+    if (_mm256_movemask_epi8(input) == 0) {
+      // ASCII block can't complete sequence of previous one.
+      if (!_mm256_testz_si256(previous_incomplete, previous_incomplete))
+        break;
+    }
+    else {
+      __m256i errors = _simd_utf8_block_errors(input, previous_input);
+
+      if (!_mm256_testz_si256(errors, errors))
+        break;
+    }
+
+    previous_incomplete = _mm256_subs_epu8(input, incomplete_threshold);
+    previous_input = input;
+  }
+#elif defined(ESTRING_SIMD_SSE2)
+  const size_t blocks_end = string_size - string_size % 16;
+
+  for (; index < blocks_end; index += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + index));
+
+    if (_mm_movemask_epi8(block) != 0)
+      break;
+  }
+#endif
+
+  // Error may be in character, that starts before unchecked part and continues in it,
+  //  so move back to first byte of last checked character.
+  if (index != 0)
+    --index;
+
+  for (size_t back_length = 0; back_length < 3 && index > 0 && (string[index] & 0xC0) == 0x80; ++back_length)
+    --index;
+
+  return index;
+}
+
+// Get length of prefix of utf16 'string' without surrogates.
+template <typename Unit>
+inline size_t _simd_utf16_surrogate_free_prefix(const Unit* string, size_t string_size) noexcept {
+  static_assert(sizeof(Unit) == 2);
+
+  size_t index = 0;
+
+  string = _simd_opaque_pointer(string);
+
+#if defined(ESTRING_SIMD_SSE2)
+  // Surrogates are 0xD800..0xDFFF, i.e. 11011___ ________.
+  const __m128i surrogate_mask = _mm_set1_epi16(static_cast<short>(0xF800));
+  const __m128i surrogate_bits = _mm_set1_epi16(static_cast<short>(0xD800));
+  const size_t blocks_end = string_size - string_size % 8;
+
+  for (; index < blocks_end; index += 8) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string + index));
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, surrogate_mask), surrogate_bits)) != 0)
+      break;
+  }
+#endif
+
+  for (; index < string_size && (static_cast<char32_t>(string[index]) & 0xF800) != 0xD800; ++index);
+
+  return index;
+}
+
+// Compare leading ASCII characters of 8-bit 'encoded_string' with utf32 'string', both of 'length' characters.
+// Returns number of equal characters. Stops at first non-ASCII byte or mismatch.
+template <typename Unit>
+inline size_t _simd_ascii_match(const Unit* encoded_string, const char32_t* string, size_t length) noexcept {
+  static_assert(sizeof(Unit) == 1);
+
+  encoded_string = _simd_opaque_pointer(encoded_string);
+  string = _simd_opaque_pointer(string);
+
+  size_t index = 0;
+
+#if defined(ESTRING_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+
+  for (; index + 16 <= length; index += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(encoded_string + index));
+
+    if (_mm_movemask_epi8(block) != 0)
+      break;
+
+    __m128i low = _mm_unpacklo_epi8(block, zero);
+    __m128i high = _mm_unpackhi_epi8(block, zero);
+    const __m128i* in = reinterpret_cast<const __m128i*>(string + index);
+
+    __m128i is_equal = _mm_and_si128(
+      _mm_and_si128(_mm_cmpeq_epi32(_mm_unpacklo_epi16(low, zero), _mm_loadu_si128(in + 0)), _mm_cmpeq_epi32(_mm_unpackhi_epi16(low, zero), _mm_loadu_si128(in + 1))),
+      _mm_and_si128(_mm_cmpeq_epi32(_mm_unpacklo_epi16(high, zero), _mm_loadu_si128(in + 2)), _mm_cmpeq_epi32(_mm_unpackhi_epi16(high, zero), _mm_loadu_si128(in + 3)))
+    );
+
+    if (_mm_movemask_epi8(is_equal) != 0xFFFF)
+      break;
+  }
+#endif
+
+  for (; index < length; ++index) {
+    char32_t character = static_cast<unsigned char>(encoded_string[index]);
+
+    if (character >= 0x80 || character != string[index])
+      break;
+  }
+
+  return index;
+}
+
+// Find first index where utf32 strings 'first' and 'second', both of 'length' characters, differ.
+// Returns 'length' if strings are equal.
+inline size_t _simd_utf32_mismatch(const char32_t* first, const char32_t* second, size_t length) noexcept {
+  size_t index = 0;
+
+  first = _simd_opaque_pointer(first);
+  second = _simd_opaque_pointer(second);
+
+#if defined(ESTRING_SIMD_AVX2)
+  const size_t wide_blocks_end = length - length % 8;
+
+  for (; index < wide_blocks_end; index += 8) {
+    __m256i first_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + index));
+    __m256i second_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + index));
+
+    unsigned int equal_mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(first_block, second_block)));
+
+    if (equal_mask != 0xFFFFFFFF)
+      return index + std::countr_one(equal_mask) / 4;
+  }
+#endif
+
+#if defined(ESTRING_SIMD_SSE2)
+  const size_t blocks_end = length - length % 4;
+
+  for (; index < blocks_end; index += 4) {
+    __m128i first_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + index));
+    __m128i second_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + index));
+
+    unsigned int equal_mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi32(first_block, second_block)));
+
+    if (equal_mask != 0xFFFF)
+      return index + std::countr_one(equal_mask) / 4;
+  }
+#endif
+
+  for (; index < length; ++index)
+    if (first[index] != second[index])
+      break;
+
+  return index;
+}
+
+// Convert case of leading ASCII characters of utf32 'string' in place, in blocks of 8 characters:
+//  characters in range ['first', 'last'] are changed by 'delta'.
+// Returns number of converted characters. Stops at first block with non-ASCII character, the rest should be
+//  converted by tables.
+inline size_t _simd_ascii_convert_case(char32_t* string, size_t length, char32_t first, char32_t last, int delta) noexcept {
+  size_t index = 0;
+
+#if defined(ESTRING_SIMD_AVX2)
+  const __m256i non_ascii_mask = _mm256_set1_epi32(~0x7F);
+  const __m256i before_first = _mm256_set1_epi32(static_cast<int>(first) - 1);
+  const __m256i after_last = _mm256_set1_epi32(static_cast<int>(last) + 1);
+  const __m256i delta_vector = _mm256_set1_epi32(delta);
+
+  for (; index + 8 <= length; index += 8) {
+    __m256i* block_pointer = reinterpret_cast<__m256i*>(string + index);
+    __m256i block = _mm256_loadu_si256(block_pointer);
+
+    if (!_mm256_testz_si256(block, non_ascii_mask))
+      break;
+
+    __m256i is_in_range = _mm256_and_si256(_mm256_cmpgt_epi32(block, before_first), _mm256_cmpgt_epi32(after_last, block));
+
+    _mm256_storeu_si256(block_pointer, _mm256_add_epi32(block, _mm256_and_si256(is_in_range, delta_vector)));
+  }
+#elif defined(ESTRING_SIMD_SSE2)
+  const __m128i non_ascii_mask = _mm_set1_epi32(~0x7F);
+  const __m128i before_first = _mm_set1_epi32(static_cast<int>(first) - 1);
+  const __m128i after_last = _mm_set1_epi32(static_cast<int>(last) + 1);
+  const __m128i delta_vector = _mm_set1_epi32(delta);
+
+  for (; index + 8 <= length; index += 8) {
+    __m128i* block_pointer = reinterpret_cast<__m128i*>(string + index);
+    __m128i low = _mm_loadu_si128(block_pointer);
+    __m128i high = _mm_loadu_si128(block_pointer + 1);
+
+    if (!_simd_all_lanes_fit(_mm_or_si128(low, high), non_ascii_mask))
+      break;
+
+    __m128i is_low_in_range = _mm_and_si128(_mm_cmpgt_epi32(low, before_first), _mm_cmplt_epi32(low, after_last));
+    __m128i is_high_in_range = _mm_and_si128(_mm_cmpgt_epi32(high, before_first), _mm_cmplt_epi32(high, after_last));
+
+    _mm_storeu_si128(block_pointer, _mm_add_epi32(low, _mm_and_si128(is_low_in_range, delta_vector)));
+    _mm_storeu_si128(block_pointer + 1, _mm_add_epi32(high, _mm_and_si128(is_high_in_range, delta_vector)));
+  }
+#endif
+
+  return index;
+}
+
+// Count leading characters of utf32 'string', that are less than 'limit'.
+inline size_t _simd_utf32_prefix_below(const char32_t* string, size_t length, char32_t limit) noexcept {
+  size_t index = 0;
+
+#if defined(ESTRING_SIMD_SSE2)
+  // Characters are compared as signed numbers, so sign bits are flipped.
+  const __m128i sign_bit = _mm_set1_epi32(static_cast<int>(0x80000000u));
+  const __m128i limit_vector = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(limit)), sign_bit);
+
+  for (; index + 8 <= length; index += 8) {
+    const __m128i* block_pointer = reinterpret_cast<const __m128i*>(string + index);
+    __m128i low = _mm_xor_si128(_mm_loadu_si128(block_pointer), sign_bit);
+    __m128i high = _mm_xor_si128(_mm_loadu_si128(block_pointer + 1), sign_bit);
+
+    __m128i is_below = _mm_packs_epi32(_mm_cmplt_epi32(low, limit_vector), _mm_cmplt_epi32(high, limit_vector));
+    unsigned int below_mask = static_cast<unsigned int>(_mm_movemask_epi8(is_below));
+
+    if (below_mask != 0xFFFF)
+      return index + std::countr_one(below_mask) / 2;
+  }
+#endif
+
+  while (index < length && string[index] < limit)
+    ++index;
+
+  return index;
+}
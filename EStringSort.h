@@ -0,0 +1,231 @@
+#pragma once
+#define EString_EStringSort_h_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "EString.h"
+
+// Sorting of string collections in code point order, i.e. the order of 'operator<=>'.
+// 'esort()' is MSD radix sort over 64-bit keys, that pack next 3 code points of every string.
+// Keys are stored in contiguous array next to string indices, so radix passes don't touch characters of strings,
+//  they are read only to load keys of next 3 code points for groups with equal keys.
+// Small groups are sorted by comparison. Strings are moved to their places once, at the end.
+
+// Code point is stored as 'code_point + 1' in 21 bits, 0 means end of string.
+// Characters that don't fit (not valid code points) are stored as '_esort_digit_mask' and make the rest of key
+//  saturated, so strings with such keys are ordered by comparison.
+constexpr uint64_t _esort_digit_mask = (uint64_t(1) << 21) - 1;
+
+// Groups smaller than this are sorted by comparison.
+constexpr size_t _esort_comparison_threshold = 32;
+
+struct _ESortEntry {
+  uint64_t key;
+  size_t index;
+};
+
+// Pack code points 'depth', 'depth + 1' and 'depth + 2' of 'string' to key.
+template <typename String>
+inline uint64_t _esort_key(String const& string, size_t depth) noexcept {
+  const char32_t* data = string.data();
+  size_t length = string.length();
+
+  uint64_t key = 0;
+  bool is_saturated = false;
+
+  for (size_t offset = 0; offset < 3; ++offset) {
+    uint64_t digit = 0;
+
+    if (is_saturated) {
+      digit = _esort_digit_mask;
+    }
+    else if (depth + offset < length) {
+      digit = static_cast<uint64_t>(data[depth + offset]) + 1;
+
+      if (digit >= _esort_digit_mask) {
+        digit = _esort_digit_mask;
+        is_saturated = true;
+      }
+    }
+
+    key = key << 21 | digit;
+  }
+
+  return key;
+}
+
+// Sort entries, which strings are equal before 'depth', by comparison.
+template <typename String>
+inline void _esort_by_comparison(_ESortEntry* entries, size_t count, String const* strings, size_t depth) {
+  std::sort(entries, entries + count, [strings, depth](_ESortEntry const& left, _ESortEntry const& right) {
+    if (left.key != right.key)
+      return left.key < right.key;
+
+    // Both strings end inside of key.
+    if ((left.key & _esort_digit_mask) == 0)
+      return false;
+
+    String const& left_string = strings[left.index];
+    String const& right_string = strings[right.index];
+
+    EStringView left_view(left_string.data() + depth, left_string.length() - depth);
+    EStringView right_view(right_string.data() + depth, right_string.length() - depth);
+
+    return left_view < right_view;
+  });
+}
+
+// Group of entries, which strings are equal before 'depth' and which keys are loaded for 'depth',
+//  to be sorted by bytes of keys starting from 'byte_index'.
+struct _ESortGroup {
+  size_t offset;
+  size_t count;
+  size_t depth;
+  int byte_index;
+};
+
+// Sort group by one radix pass, pushing its buckets to 'groups'.
+// 'buffer' is scratch space of the same size as 'entries'.
+template <typename String>
+void _esort_radix_group(_ESortEntry* entries, _ESortEntry* buffer, _ESortGroup group, String const* strings, std::vector<_ESortGroup>& groups) {
+  entries += group.offset;
+  buffer += group.offset;
+
+  size_t count = group.count;
+  size_t depth = group.depth;
+  int byte_index = group.byte_index;
+
+  while (count >= _esort_comparison_threshold) {
+    if (byte_index < 0) {
+      uint64_t low_digit = entries[0].key & _esort_digit_mask;
+
+      // Strings are equal.
+      if (low_digit == 0)
+        return;
+
+      if (low_digit == _esort_digit_mask)
+        break;
+
+      depth += 3;
+      byte_index = 7;
+
+      for (size_t index = 0; index < count; ++index)
+        entries[index].key = _esort_key(strings[entries[index].index], depth);
+    }
+
+    // Skip bytes that are equal in all keys, e.g. common prefix of strings.
+    uint64_t different_bits = 0;
+
+    for (size_t index = 1; index < count; ++index)
+      different_bits |= entries[index].key ^ entries[0].key;
+
+    different_bits &= (byte_index == 7 ? ~uint64_t(0) : (uint64_t(1) << (byte_index * 8 + 8)) - 1);
+
+    if (different_bits == 0) {
+      byte_index = -1;
+      continue;
+    }
+
+    byte_index = (63 - std::countl_zero(different_bits)) / 8;
+
+    int shift = byte_index * 8;
+    size_t bucket_sizes[256] = {};
+
+    for (size_t index = 0; index < count; ++index)
+      ++bucket_sizes[(entries[index].key >> shift) & 0xFF];
+
+    size_t bucket_offsets[256];
+    size_t offset = 0;
+
+    for (size_t bucket = 0; bucket < 256; ++bucket) {
+      bucket_offsets[bucket] = offset;
+      offset += bucket_sizes[bucket];
+    }
+
+    for (size_t index = 0; index < count; ++index)
+      buffer[bucket_offsets[(entries[index].key >> shift) & 0xFF]++] = entries[index];
+
+    memcpy(entries, buffer, count * sizeof(_ESortEntry));
+
+    offset = group.offset;
+
+    for (size_t bucket = 0; bucket < 256; ++bucket) {
+      size_t bucket_size = bucket_sizes[bucket];
+
+      if (bucket_size > 1)
+        groups.push_back(_ESortGroup{ offset, bucket_size, depth, byte_index - 1 });
+
+      offset += bucket_size;
+    }
+
+    return;
+  }
+
+  _esort_by_comparison(entries, count, strings, depth);
+}
+
+// Sort entries by keys loaded for depth 0.
+// Groups are kept in explicit stack instead of recursion, as long common prefixes would make recursion too deep.
+template <typename String>
+void _esort_radix(_ESortEntry* entries, _ESortEntry* buffer, size_t count, String const* strings) {
+  std::vector<_ESortGroup> groups;
+  groups.push_back(_ESortGroup{ 0, count, 0, 7 });
+
+  while (!groups.empty()) {
+    _ESortGroup group = groups.back();
+    groups.pop_back();
+
+    _esort_radix_group(entries, buffer, group, strings, groups);
+  }
+}
+
+// Sort strings in code point order. Not stable, but equal strings are indistinguishable anyway.
+// 'String' is any string with 'data()' and 'length()' of utf32 characters, e.g. EString, PmrEString or EStringView.
+template <typename String>
+void esort(std::span<String> strings) {
+  size_t count = strings.size();
+
+  if (count < 2)
+    return;
+
+  std::unique_ptr<_ESortEntry[]> entries = std::make_unique_for_overwrite<_ESortEntry[]>(count);
+  std::unique_ptr<_ESortEntry[]> buffer = std::make_unique_for_overwrite<_ESortEntry[]>(count);
+
+  for (size_t index = 0; index < count; ++index)
+    entries[index] = _ESortEntry{ _esort_key(strings[index], 0), index };
+
+  _esort_radix<String>(entries.get(), buffer.get(), count, strings.data());
+
+  // Move strings to their places, following cycles of permutation.
+  for (size_t index = 0; index < count; ++index) {
+    if (entries[index].index == index)
+      continue;
+
+    String string = std::move(strings[index]);
+    size_t place = index;
+
+    while (entries[place].index != index) {
+      size_t next_place = entries[place].index;
+
+      strings[place] = std::move(strings[next_place]);
+      entries[place].index = place;
+      place = next_place;
+    }
+
+    strings[place] = std::move(string);
+    entries[place].index = place;
+  }
+}
+
+template <typename String, typename VectorAllocator>
+void esort(std::vector<String, VectorAllocator>& strings) {
+  esort(std::span<String>(strings));
+}
@@ -0,0 +1,552 @@
+#pragma once
+#define EString_EStringUnicode_h_
+
+/*
+* Unicode character properties, used by case conversion, normalization and segmentation of EString.
+* Properties are stored in two-stage tables: code points are split to blocks of 128 characters,
+*  first stage maps block number to unique block of second stage, that maps character to index of record.
+*  Equal blocks (e.g. unassigned characters or ideographs) are stored once, so tables are small.
+* Tables are generated by 'tools/generate_unicode_data.py' from Unicode Character Database
+*  to 'EStringUnicodeData.inl', that is compiled by 'EString.cpp'.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "EStringSimd.h"
+
+constexpr unsigned _unicode_block_shift = 7;
+
+struct _EUnicodeTable {
+  const uint16_t* stage1;
+  // Blocks after the end of first stage have only zero values.
+  size_t stage1_length;
+  const uint16_t* stage2;
+};
+
+// Get value of character in two-stage table.
+inline uint16_t _unicode_lookup(_EUnicodeTable const& table, char32_t character) noexcept {
+  size_t block = character >> _unicode_block_shift;
+
+  if (block >= table.stage1_length)
+    return 0;
+
+  size_t block_offset = static_cast<size_t>(table.stage1[block]) << _unicode_block_shift;
+
+  return table.stage2[block_offset | (character & ((1u << _unicode_block_shift) - 1))];
+}
+
+// Version of Unicode Character Database, that tables are generated from.
+extern const char* const _unicode_version;
+
+enum class _ECaseMapping {
+  lower,
+  upper,
+  fold
+};
+
+// Case mappings of character. Most mappings are deltas of code point, shared by many characters.
+struct _EUnicodeCaseRecord {
+  int32_t lower_delta;
+  int32_t upper_delta;
+  int32_t fold_delta;
+  // Offsets of full mappings that expand to several characters (e.g. 'ß' to "SS") in '_unicode_case_expansions', or 0.
+  uint16_t lower_expansion;
+  uint16_t upper_expansion;
+  uint16_t fold_expansion;
+  uint16_t flags;
+};
+
+constexpr uint16_t _unicode_case_is_cased = 1;
+constexpr uint16_t _unicode_case_is_case_ignorable = 2;
+
+extern const _EUnicodeTable _unicode_case_table;
+extern const _EUnicodeCaseRecord _unicode_case_records[];
+// Characters of full mappings, each mapping is prefixed by its length.
+extern const char32_t _unicode_case_expansions[];
+
+inline _EUnicodeCaseRecord const& _unicode_case_record(char32_t character) noexcept {
+  return _unicode_case_records[_unicode_lookup(_unicode_case_table, character)];
+}
+
+// Get full mapping of character. Returns mapping prefixed by its length, or nullptr if it's single character,
+//  that is stored to 'mapped_character'.
+inline const char32_t* _unicode_map_case(char32_t character, _ECaseMapping mapping, char32_t& mapped_character) noexcept {
+  _EUnicodeCaseRecord const& record = _unicode_case_record(character);
+
+  int32_t delta = 0;
+  uint16_t expansion = 0;
+
+  switch (mapping) {
+    case _ECaseMapping::lower:
+      delta = record.lower_delta;
+      expansion = record.lower_expansion;
+      break;
+
+    case _ECaseMapping::upper:
+      delta = record.upper_delta;
+      expansion = record.upper_expansion;
+      break;
+
+    default:
+      delta = record.fold_delta;
+      expansion = record.fold_expansion;
+      break;
+  }
+
+  if (expansion != 0)
+    return _unicode_case_expansions + expansion;
+
+  mapped_character = static_cast<char32_t>(static_cast<int32_t>(character) + delta);
+
+  return nullptr;
+}
+
+// Get number of characters in full mapping of character.
+inline size_t _unicode_case_mapping_length(char32_t character, _ECaseMapping mapping) noexcept {
+  char32_t mapped_character;
+  const char32_t* expansion = _unicode_map_case(character, mapping, mapped_character);
+
+  return expansion ? expansion[0] : 1;
+}
+
+// Check is capital sigma at 'position' final one, i.e. it's preceded by cased letter and isn't followed by one,
+//  skipping case-ignorable characters (Final_Sigma condition of Unicode).
+// Characters before 'position' are in range ['begin', 'position'), characters after it are in range ['after', 'end').
+inline bool _unicode_is_final_sigma(const char32_t* begin, const char32_t* position, const char32_t* after, const char32_t* end) noexcept {
+  bool is_after_cased = false;
+
+  while (position != begin) {
+    uint16_t flags = _unicode_case_record(*--position).flags;
+
+    if (!(flags & _unicode_case_is_case_ignorable)) {
+      is_after_cased = flags & _unicode_case_is_cased;
+      break;
+    }
+  }
+
+  if (!is_after_cased)
+    return false;
+
+  for (; after != end; ++after) {
+    uint16_t flags = _unicode_case_record(*after).flags;
+
+    if (!(flags & _unicode_case_is_case_ignorable))
+      return !(flags & _unicode_case_is_cased);
+  }
+
+  return true;
+}
+
+// Unicode normalization forms (see UAX #15).
+enum class ENormalizationForm {
+  // Canonical decomposition, followed by canonical composition.
+  nfc,
+  // Canonical decomposition.
+  nfd,
+  // Compatibility decomposition (e.g. 'ﬁ' to "fi"), followed by canonical composition.
+  nfkc,
+  // Compatibility decomposition.
+  nfkd
+};
+
+// Normalization properties of character.
+struct _EUnicodeNormalizationRecord {
+  uint8_t combining_class;
+  // Quick check properties, '_unicode_*_no' and '_unicode_*_maybe' flags. Characters without flags are 'Yes'.
+  uint8_t flags;
+  // Offsets of full decompositions in '_unicode_decompositions', or 0 if character isn't decomposed.
+  uint16_t canonical_decomposition;
+  uint16_t compatibility_decomposition;
+  // Offset of compositions with this character as the first one in '_unicode_compositions', or 0.
+  uint16_t compositions;
+};
+
+constexpr uint8_t _unicode_nfd_no = 1;
+constexpr uint8_t _unicode_nfc_no = 2;
+constexpr uint8_t _unicode_nfc_maybe = 4;
+constexpr uint8_t _unicode_nfkd_no = 8;
+constexpr uint8_t _unicode_nfkc_no = 16;
+constexpr uint8_t _unicode_nfkc_maybe = 32;
+
+extern const _EUnicodeTable _unicode_normalization_table;
+extern const _EUnicodeNormalizationRecord _unicode_normalization_records[];
+// Characters of decompositions, each decomposition is prefixed by its length.
+extern const char32_t _unicode_decompositions[];
+// Lists of '(second character, composite)' pairs, sorted by second character. Each list is prefixed by number of pairs.
+extern const char32_t _unicode_compositions[];
+// Characters below these limits are 'Yes' and have no combining class in every form, so quick check skips them.
+extern const char32_t _unicode_quick_check_limits[];
+
+// Hangul syllables are decomposed and composed by algorithm, not by tables.
+constexpr char32_t _unicode_hangul_syllable_base = 0xAC00;
+constexpr char32_t _unicode_hangul_syllables_count = 11172;
+constexpr char32_t _unicode_hangul_l_base = 0x1100;
+constexpr char32_t _unicode_hangul_v_base = 0x1161;
+constexpr char32_t _unicode_hangul_t_base = 0x11A7;
+constexpr char32_t _unicode_hangul_l_count = 19;
+constexpr char32_t _unicode_hangul_v_count = 21;
+constexpr char32_t _unicode_hangul_t_count = 28;
+
+inline _EUnicodeNormalizationRecord const& _unicode_normalization_record(char32_t character) noexcept {
+  return _unicode_normalization_records[_unicode_lookup(_unicode_normalization_table, character)];
+}
+
+inline bool _unicode_is_composing_form(ENormalizationForm form) noexcept {
+  return form == ENormalizationForm::nfc || form == ENormalizationForm::nfkc;
+}
+
+inline bool _unicode_is_compatibility_form(ENormalizationForm form) noexcept {
+  return form == ENormalizationForm::nfkc || form == ENormalizationForm::nfkd;
+}
+
+// Get quick check flags, that mean 'No' and 'Maybe' in form.
+inline void _unicode_quick_check_flags(ENormalizationForm form, uint8_t& no_flag, uint8_t& maybe_flag) noexcept {
+  switch (form) {
+    case ENormalizationForm::nfc:
+      no_flag = _unicode_nfc_no;
+      maybe_flag = _unicode_nfc_maybe;
+      break;
+
+    case ENormalizationForm::nfd:
+      no_flag = _unicode_nfd_no;
+      maybe_flag = 0;
+      break;
+
+    case ENormalizationForm::nfkc:
+      no_flag = _unicode_nfkc_no;
+      maybe_flag = _unicode_nfkc_maybe;
+      break;
+
+    default:
+      no_flag = _unicode_nfkd_no;
+      maybe_flag = 0;
+      break;
+  }
+}
+
+enum class _EQuickCheckResult {
+  yes,
+  no,
+  maybe
+};
+
+// Check is string normalized by quick check properties, in one pass and without copying.
+// 'Maybe' means that string must be normalized to find out.
+// Index of the first character, that isn't 'Yes' or breaks canonical order, is stored to 'unsure_index'.
+// If 'is_stopping_at_unsure' is set, check stops there and returns 'Maybe' or 'No'.
+inline _EQuickCheckResult _unicode_quick_check(const char32_t* string, size_t length, ENormalizationForm form, size_t& unsure_index, bool is_stopping_at_unsure = false) noexcept {
+  char32_t limit = _unicode_quick_check_limits[static_cast<int>(form)];
+
+  uint8_t no_flag;
+  uint8_t maybe_flag;
+  _unicode_quick_check_flags(form, no_flag, maybe_flag);
+
+  _EQuickCheckResult result = _EQuickCheckResult::yes;
+  uint8_t last_combining_class = 0;
+  size_t index = 0;
+
+  unsure_index = length;
+
+  while (index < length) {
+    char32_t character = string[index];
+
+    // Skip run of characters, that are always 'Yes' (e.g. ASCII).
+    if (character < limit) {
+      index += _simd_utf32_prefix_below(string + index, length - index, limit);
+      last_combining_class = 0;
+      continue;
+    }
+
+    _EUnicodeNormalizationRecord const& record = _unicode_normalization_record(character);
+
+    if ((record.combining_class != 0 && record.combining_class < last_combining_class) || (record.flags & no_flag)) {
+      if (unsure_index == length)
+        unsure_index = index;
+
+      return _EQuickCheckResult::no;
+    }
+
+    if (record.flags & maybe_flag) {
+      if (unsure_index == length)
+        unsure_index = index;
+
+      result = _EQuickCheckResult::maybe;
+
+      if (is_stopping_at_unsure)
+        return result;
+    }
+
+    last_combining_class = record.combining_class;
+    ++index;
+  }
+
+  return result;
+}
+
+// Get index, from which string should be normalized, if quick check failed at 'unsure_index'.
+// Characters before it are kept: it's the last starter before 'unsure_index', that doesn't combine with previous characters.
+inline size_t _unicode_normalization_start(const char32_t* string, size_t unsure_index) noexcept {
+  size_t index = unsure_index;
+
+  while (index > 0) {
+    --index;
+
+    if (_unicode_normalization_record(string[index]).combining_class == 0)
+      break;
+  }
+
+  return index;
+}
+
+inline bool _unicode_is_hangul_syllable(char32_t character) noexcept {
+  return character - _unicode_hangul_syllable_base < _unicode_hangul_syllables_count;
+}
+
+// Get full decomposition of character. Returns decomposition prefixed by its length, or nullptr if character isn't decomposed.
+// Hangul syllables are decomposed to 'hangul_buffer'.
+inline const char32_t* _unicode_decomposition(char32_t character, bool is_compatibility, char32_t (&hangul_buffer)[4]) noexcept {
+  if (_unicode_is_hangul_syllable(character)) {
+    char32_t index = character - _unicode_hangul_syllable_base;
+    char32_t t_index = index % _unicode_hangul_t_count;
+
+    hangul_buffer[0] = t_index != 0 ? 3 : 2;
+    hangul_buffer[1] = _unicode_hangul_l_base + index / (_unicode_hangul_v_count * _unicode_hangul_t_count);
+    hangul_buffer[2] = _unicode_hangul_v_base + index % (_unicode_hangul_v_count * _unicode_hangul_t_count) / _unicode_hangul_t_count;
+    hangul_buffer[3] = _unicode_hangul_t_base + t_index;
+
+    return hangul_buffer;
+  }
+
+  _EUnicodeNormalizationRecord const& record = _unicode_normalization_record(character);
+  uint16_t offset = is_compatibility ? record.compatibility_decomposition : record.canonical_decomposition;
+
+  return offset != 0 ? _unicode_decompositions + offset : nullptr;
+}
+
+// Get number of characters, that string decomposes to.
+inline size_t _unicode_decomposed_length(const char32_t* string, size_t length, ENormalizationForm form) noexcept {
+  bool is_compatibility = _unicode_is_compatibility_form(form);
+  char32_t limit = _unicode_quick_check_limits[static_cast<int>(is_compatibility ? ENormalizationForm::nfkd : ENormalizationForm::nfd)];
+  char32_t hangul_buffer[4];
+  size_t decomposed_length = 0;
+
+  for (size_t index = 0; index < length; ++index) {
+    if (string[index] < limit) {
+      ++decomposed_length;
+      continue;
+    }
+
+    const char32_t* decomposition = _unicode_decomposition(string[index], is_compatibility, hangul_buffer);
+    decomposed_length += decomposition ? decomposition[0] : 1;
+  }
+
+  return decomposed_length;
+}
+
+// Decompose string to 'dest' and put combining characters to canonical order.
+// 'dest' must have space for '_unicode_decomposed_length()' characters. Returns number of written characters.
+inline size_t _unicode_decompose(const char32_t* string, size_t length, ENormalizationForm form, char32_t* dest) noexcept {
+  bool is_compatibility = _unicode_is_compatibility_form(form);
+  // Characters below limit of decomposing form aren't decomposed and have no combining class.
+  char32_t limit = _unicode_quick_check_limits[static_cast<int>(is_compatibility ? ENormalizationForm::nfkd : ENormalizationForm::nfd)];
+  char32_t hangul_buffer[4];
+  size_t dest_length = 0;
+
+  // Insert character after characters with not greater combining class (stable sort of combining characters).
+  auto put = [dest, &dest_length](char32_t character) {
+    uint8_t combining_class = _unicode_normalization_record(character).combining_class;
+    size_t index = dest_length++;
+
+    if (combining_class != 0) {
+      for (; index > 0; --index) {
+        if (_unicode_normalization_record(dest[index - 1]).combining_class <= combining_class)
+          break;
+
+        dest[index] = dest[index - 1];
+      }
+    }
+
+    dest[index] = character;
+  };
+
+  for (size_t index = 0; index < length; ++index) {
+    if (string[index] < limit) {
+      dest[dest_length++] = string[index];
+      continue;
+    }
+
+    const char32_t* decomposition = _unicode_decomposition(string[index], is_compatibility, hangul_buffer);
+
+    if (!decomposition) {
+      put(string[index]);
+      continue;
+    }
+
+    for (char32_t decomposition_index = 1; decomposition_index <= decomposition[0]; ++decomposition_index)
+      put(decomposition[decomposition_index]);
+  }
+
+  return dest_length;
+}
+
+// Get primary composite of two characters, or 0 if they don't compose.
+inline char32_t _unicode_compose_pair(char32_t first, char32_t second) noexcept {
+  if (first - _unicode_hangul_l_base < _unicode_hangul_l_count && second - _unicode_hangul_v_base < _unicode_hangul_v_count) {
+    char32_t l_index = first - _unicode_hangul_l_base;
+    char32_t v_index = second - _unicode_hangul_v_base;
+
+    return _unicode_hangul_syllable_base + (l_index * _unicode_hangul_v_count + v_index) * _unicode_hangul_t_count;
+  }
+
+  if (_unicode_is_hangul_syllable(first) && (first - _unicode_hangul_syllable_base) % _unicode_hangul_t_count == 0 &&
+      second - _unicode_hangul_t_base - 1 < _unicode_hangul_t_count - 1)
+    return first + (second - _unicode_hangul_t_base);
+
+  uint16_t offset = _unicode_normalization_record(first).compositions;
+
+  if (offset == 0)
+    return 0;
+
+  const char32_t* pairs = _unicode_compositions + offset + 1;
+  const char32_t* pairs_end = pairs + 2 * _unicode_compositions[offset];
+
+  for (; pairs != pairs_end && pairs[0] <= second; pairs += 2) {
+    if (pairs[0] == second)
+      return pairs[1];
+  }
+
+  return 0;
+}
+
+// Compose decomposed string in canonical order in place. Returns new length.
+inline size_t _unicode_compose(char32_t* string, size_t length) noexcept {
+  if (length == 0)
+    return 0;
+
+  constexpr size_t no_starter = static_cast<size_t>(-1);
+
+  uint8_t first_combining_class = _unicode_normalization_record(string[0]).combining_class;
+  size_t starter_index = first_combining_class == 0 ? 0 : no_starter;
+  // Combining class of the last character, that wasn't composed. 0 means that it's starter itself.
+  uint8_t last_combining_class = first_combining_class;
+  size_t composed_length = 1;
+
+  // Characters below limit of NFC are starters, that don't compose with previous ones.
+  char32_t limit = _unicode_quick_check_limits[static_cast<int>(ENormalizationForm::nfc)];
+
+  for (size_t index = 1; index < length; ++index) {
+    char32_t character = string[index];
+
+    if (character < limit) {
+      starter_index = composed_length;
+      last_combining_class = 0;
+      string[composed_length++] = character;
+      continue;
+    }
+
+    _EUnicodeNormalizationRecord const& record = _unicode_normalization_record(character);
+    uint8_t combining_class = record.combining_class;
+
+    // Character is blocked from starter by character with same or greater combining class.
+    bool is_blocked = last_combining_class != 0 && last_combining_class >= combining_class;
+
+    // Only 'Maybe' characters of NFC are second characters of compositions.
+    if (starter_index != no_starter && !is_blocked && (record.flags & _unicode_nfc_maybe)) {
+      char32_t composite = _unicode_compose_pair(string[starter_index], character);
+
+      if (composite != 0) {
+        string[starter_index] = composite;
+        continue;
+      }
+    }
+
+    if (combining_class == 0)
+      starter_index = composed_length;
+
+    last_combining_class = combining_class;
+    string[composed_length++] = character;
+  }
+
+  return composed_length;
+}
+
+// Break properties of text segmentation (see UAX #29). Values are packed to one value of '_unicode_break_table'.
+enum class _EGraphemeBreak : uint8_t {
+  other,
+  cr,
+  lf,
+  control,
+  extend,
+  zwj,
+  regional_indicator,
+  prepend,
+  spacing_mark,
+  l,
+  v,
+  t,
+  lv,
+  lvt
+};
+
+enum class _EWordBreak : uint8_t {
+  other,
+  cr,
+  lf,
+  newline,
+  extend,
+  zwj,
+  regional_indicator,
+  format,
+  katakana,
+  hebrew_letter,
+  a_letter,
+  single_quote,
+  double_quote,
+  mid_num_let,
+  mid_letter,
+  mid_num,
+  numeric,
+  extend_num_let,
+  w_seg_space
+};
+
+enum class _ESentenceBreak : uint8_t {
+  other,
+  cr,
+  lf,
+  extend,
+  sep,
+  format,
+  sp,
+  lower,
+  upper,
+  o_letter,
+  numeric,
+  a_term,
+  s_continue,
+  s_term,
+  close
+};
+
+constexpr unsigned _unicode_word_break_shift = 4;
+constexpr unsigned _unicode_sentence_break_shift = 9;
+constexpr uint16_t _unicode_break_is_extended_pictographic = 1 << 13;
+
+extern const _EUnicodeTable _unicode_break_table;
+
+inline uint16_t _unicode_break_properties(char32_t character) noexcept {
+  return _unicode_lookup(_unicode_break_table, character);
+}
+
+inline _EGraphemeBreak _unicode_grapheme_break(uint16_t properties) noexcept {
+  return static_cast<_EGraphemeBreak>(properties & 0xF);
+}
+
+inline _EWordBreak _unicode_word_break(uint16_t properties) noexcept {
+  return static_cast<_EWordBreak>((properties >> _unicode_word_break_shift) & 0x1F);
+}
+
+inline _ESentenceBreak _unicode_sentence_break(uint16_t properties) noexcept {
+  return static_cast<_ESentenceBreak>((properties >> _unicode_sentence_break_shift) & 0xF);
+}
@@ -0,0 +1,7539 @@
+// Generated by 'tools/generate_unicode_data.py' from Unicode Character Database 15.0.0. Do not edit.
+// Included only by 'EString.cpp', declarations are in 'EStringUnicode.h'.
+
+#include "EStringUnicode.h"
+
+const char* const _unicode_version = "15.0.0";
+
+// Case mappings: 282 records, 161 unique blocks.
+
+static const uint16_t _unicode_case_table_stage1[] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+  32, 33, 34, 34, 34, 34, 35, 36, 34, 34, 34, 34, 34, 34, 37, 38,
+  39, 40, 41, 34, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53,
+  54, 55, 56, 57, 34, 34, 34, 34, 34, 58, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 59, 60, 61, 62, 63, 34, 34, 34,
+  64, 65, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  66, 34, 34, 34, 34, 34, 34, 34, 34, 67, 34, 34, 68, 69, 70, 71,
+  72, 73, 74, 75, 76, 77, 78, 79, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 80, 81, 34, 34, 34, 34, 82, 83, 84, 85,
+  34, 34, 34, 86, 34, 87, 88, 34, 89, 90, 91, 92, 34, 34, 34, 93,
+  34, 34, 34, 34, 94, 95, 34, 34, 34, 96, 97, 34, 34, 98, 99, 100,
+  101, 102, 103, 104, 105, 106, 107, 34, 108, 109, 34, 110, 111, 112, 113, 34,
+  114, 115, 116, 117, 118, 119, 34, 34, 120, 121, 122, 123, 34, 124, 125, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 126, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 127, 128, 34, 34, 34, 34, 34, 129, 34, 130, 131,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 132,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 133, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 134, 34,
+  34, 34, 135, 136, 137, 34, 34, 34, 138, 139, 140, 141, 141, 142, 143, 144,
+  34, 34, 34, 34, 145, 146, 34, 34, 34, 34, 34, 34, 34, 34, 147, 34,
+  148, 149, 150, 34, 34, 151, 34, 34, 34, 152, 34, 34, 34, 34, 34, 34,
+  34, 153, 154, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 155, 156, 34, 34, 34, 157, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34, 34,
+  158, 34, 159, 160,
+};
+
+static const uint16_t _unicode_case_table_stage2[] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+  0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 1, 0,
+  1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 4, 0, 0, 1, 0, 1,
+  0, 0, 0, 0, 1, 5, 0, 1, 1, 0, 4, 0, 0, 0, 0, 0,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 6,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 0, 3, 3, 3, 3, 3, 3, 3, 7,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  10, 11, 8, 9, 8, 9, 8, 9, 4, 8, 9, 8, 9, 8, 9, 8,
+  9, 8, 9, 8, 9, 8, 9, 8, 9, 12, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 13, 8, 9, 8, 9, 8, 9, 14,
+  15, 16, 8, 9, 8, 9, 17, 8, 9, 18, 18, 8, 9, 4, 19, 20,
+  21, 8, 9, 18, 22, 23, 24, 25, 8, 9, 26, 4, 24, 27, 28, 29,
+  8, 9, 8, 9, 8, 9, 30, 8, 9, 30, 4, 4, 8, 9, 30, 8,
+  9, 31, 31, 8, 9, 8, 9, 32, 8, 9, 4, 0, 8, 9, 4, 33,
+  0, 0, 0, 0, 34, 35, 36, 34, 35, 36, 34, 35, 36, 8, 9, 8,
+  9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 37, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  38, 34, 35, 36, 8, 9, 39, 40, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  41, 4, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 4, 4, 4, 4, 4, 4, 42, 8, 9, 43, 44, 45,
+  45, 8, 9, 46, 47, 48, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  49, 50, 51, 52, 53, 4, 54, 54, 4, 55, 4, 56, 57, 4, 4, 4,
+  54, 58, 4, 59, 4, 60, 61, 4, 62, 63, 61, 64, 65, 4, 4, 63,
+  4, 66, 67, 4, 4, 68, 4, 4, 4, 4, 4, 4, 4, 69, 4, 4,
+  70, 4, 71, 70, 4, 4, 4, 72, 70, 73, 74, 74, 75, 4, 4, 4,
+  4, 4, 76, 4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 77, 78, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 1, 1, 1, 1, 1, 1, 1,
+  79, 79, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  79, 79, 79, 79, 79, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 80, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  8, 9, 8, 9, 1, 1, 8, 9, 0, 0, 79, 28, 28, 28, 0, 81,
+  0, 0, 0, 0, 1, 1, 82, 1, 83, 83, 83, 0, 84, 0, 85, 85,
+  86, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 87, 88, 88, 88,
+  89, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 90, 3, 3, 3, 3, 3, 3, 3, 3, 3, 91, 92, 92, 93,
+  94, 95, 4, 4, 4, 96, 97, 98, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  99, 100, 101, 102, 103, 104, 0, 8, 9, 105, 8, 9, 4, 41, 41, 41,
+  106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 0, 1, 1, 1, 1, 1, 1, 1, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  108, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 109,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  0, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+  110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+  110, 110, 110, 110, 110, 110, 110, 0, 0, 1, 0, 0, 0, 0, 0, 1,
+  4, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111,
+  111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111,
+  111, 111, 111, 111, 111, 111, 111, 112, 4, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1,
+  0, 1, 1, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+  0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+  0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+  0, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 0, 1, 1, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1,
+  0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1,
+  1, 0, 0, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0,
+  0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+  1, 1, 1, 1, 1, 0, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1,
+  1, 0, 1, 1, 1, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113,
+  113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113,
+  113, 113, 113, 113, 113, 113, 0, 113, 0, 0, 0, 0, 0, 113, 0, 0,
+  114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114,
+  114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114,
+  114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 0, 79, 114, 114, 114,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+  115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+  115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+  115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+  115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+  116, 116, 116, 116, 116, 116, 0, 0, 117, 117, 117, 117, 117, 117, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 0,
+  1, 0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0,
+  0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 0, 1, 0, 1,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1,
+  1, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0,
+  118, 119, 120, 121, 121, 122, 123, 124, 125, 0, 0, 0, 0, 0, 0, 0,
+  126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126,
+  126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126,
+  126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 126, 0, 0, 126, 126, 126,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 79, 127, 4, 4, 4, 128, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 129, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 130, 131, 132, 133, 134, 135, 4, 4, 136, 4,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  137, 137, 137, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138, 138, 138,
+  137, 137, 137, 137, 137, 137, 0, 0, 138, 138, 138, 138, 138, 138, 0, 0,
+  137, 137, 137, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138, 138, 138,
+  137, 137, 137, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138, 138, 138,
+  137, 137, 137, 137, 137, 137, 0, 0, 138, 138, 138, 138, 138, 138, 0, 0,
+  139, 137, 140, 137, 141, 137, 142, 137, 0, 138, 0, 138, 0, 138, 0, 138,
+  137, 137, 137, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138, 138, 138,
+  143, 143, 144, 144, 144, 144, 145, 145, 146, 146, 147, 147, 148, 148, 0, 0,
+  149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164,
+  165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180,
+  181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196,
+  137, 137, 197, 198, 199, 0, 200, 201, 138, 138, 202, 202, 203, 1, 204, 1,
+  1, 1, 205, 206, 207, 0, 208, 209, 210, 210, 210, 210, 211, 1, 1, 1,
+  137, 137, 212, 86, 0, 0, 213, 214, 138, 138, 215, 215, 0, 1, 1, 1,
+  137, 137, 216, 89, 217, 101, 218, 219, 138, 138, 220, 220, 105, 1, 1, 1,
+  0, 0, 221, 222, 223, 0, 224, 225, 226, 226, 227, 227, 228, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 79, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 79,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 4, 0, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 0, 4, 0, 0, 0, 4, 4, 4, 4, 4, 0, 0,
+  0, 0, 0, 0, 4, 0, 229, 0, 4, 0, 230, 231, 4, 4, 0, 4,
+  4, 4, 232, 4, 4, 0, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4,
+  0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 0, 0, 0, 0, 233, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234,
+  235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235,
+  0, 0, 0, 8, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+  236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+  237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237,
+  237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+  110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+  110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+  111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111,
+  111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111,
+  111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111,
+  8, 9, 238, 239, 240, 241, 242, 8, 9, 8, 9, 8, 9, 243, 244, 245,
+  246, 4, 8, 9, 4, 8, 9, 4, 4, 4, 4, 4, 79, 79, 247, 247,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 4, 0, 0, 0, 0, 0, 0, 8, 9, 8, 9, 1,
+  1, 1, 8, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+  248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+  248, 248, 248, 248, 248, 248, 0, 248, 0, 0, 0, 0, 0, 248, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0,
+  0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 0, 1,
+  1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 79, 79, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  4, 4, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  79, 4, 4, 4, 4, 4, 4, 4, 4, 8, 9, 8, 9, 249, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 1, 1, 1, 8, 9, 250, 4, 0,
+  8, 9, 8, 9, 251, 4, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 252, 253, 254, 255, 252, 4,
+  256, 257, 258, 259, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9,
+  8, 9, 8, 9, 260, 261, 262, 8, 9, 8, 9, 0, 0, 0, 0, 0,
+  8, 9, 0, 4, 0, 4, 8, 9, 8, 9, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 79, 79, 79, 8, 9, 0, 79, 79, 4, 0, 0, 0, 0, 0,
+  0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0,
+  0, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 1, 1,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0,
+  0, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 263, 4, 4, 4, 4, 4, 4, 4, 1, 79, 79, 79, 79,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 79, 1, 1, 0, 0, 0, 0,
+  264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264,
+  264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264,
+  264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264,
+  264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264,
+  264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264, 264,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  265, 266, 267, 268, 269, 270, 270, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 271, 272, 273, 274, 275, 0, 0, 0, 0, 0, 0, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+  0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 1, 0,
+  1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276,
+  276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276,
+  276, 276, 276, 276, 276, 276, 276, 276, 277, 277, 277, 277, 277, 277, 277, 277,
+  277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277,
+  277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276,
+  276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276,
+  276, 276, 276, 276, 0, 0, 0, 0, 277, 277, 277, 277, 277, 277, 277, 277,
+  277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277,
+  277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 0, 278, 278, 278, 278,
+  278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 0, 278, 278, 278, 278,
+  278, 278, 278, 0, 278, 278, 0, 279, 279, 279, 279, 279, 279, 279, 279, 279,
+  279, 279, 0, 279, 279, 279, 279, 279, 279, 279, 279, 279, 279, 279, 279, 279,
+  279, 279, 0, 279, 279, 279, 279, 279, 279, 279, 0, 279, 279, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  79, 1, 1, 79, 79, 79, 0, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 0, 79, 79, 79, 79, 79, 79, 79, 79, 79, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 0, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84,
+  84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84,
+  84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84, 84,
+  84, 84, 84, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91,
+  91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91,
+  91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91,
+  91, 91, 91, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0,
+  0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 1, 1, 1,
+  1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 1, 0, 0, 1, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0,
+  1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1,
+  1, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 0, 1,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0,
+  1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1,
+  0, 0, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0,
+  0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1,
+  1, 0, 1, 1, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0, 1, 1, 0, 1,
+  1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0,
+  1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4,
+  0, 0, 4, 0, 0, 4, 4, 0, 0, 4, 4, 4, 4, 0, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 0, 4, 4, 4,
+  4, 4, 4, 4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 0, 0, 4, 4, 4,
+  4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 0,
+  4, 4, 4, 4, 4, 0, 4, 0, 0, 0, 4, 4, 4, 4, 4, 4,
+  4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 0, 0, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 0, 4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0,
+  0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1,
+  1, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79,
+  79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 79, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280,
+  280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280, 280,
+  280, 280, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281,
+  281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281, 281,
+  281, 281, 281, 281, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+  0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+const _EUnicodeTable _unicode_case_table = { _unicode_case_table_stage1, 7172, _unicode_case_table_stage2 };
+
+const _EUnicodeCaseRecord _unicode_case_records[] = {
+  { 0, 0, 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 2 }, { 32, 0, 32, 0, 0, 0, 1 }, { 0, -32, 0, 0, 0, 0, 1 },
+  { 0, 0, 0, 0, 0, 0, 1 }, { 0, 743, 775, 0, 0, 0, 1 }, { 0, 0, 0, 0, 1, 4, 1 }, { 0, 121, 0, 0, 0, 0, 1 },
+  { 1, 0, 1, 0, 0, 0, 1 }, { 0, -1, 0, 0, 0, 0, 1 }, { 0, 0, 0, 7, 0, 7, 1 }, { 0, -232, 0, 0, 0, 0, 1 },
+  { 0, 0, 0, 0, 10, 13, 1 }, { -121, 0, -121, 0, 0, 0, 1 }, { 0, -300, -268, 0, 0, 0, 1 }, { 0, 195, 0, 0, 0, 0, 1 },
+  { 210, 0, 210, 0, 0, 0, 1 }, { 206, 0, 206, 0, 0, 0, 1 }, { 205, 0, 205, 0, 0, 0, 1 }, { 79, 0, 79, 0, 0, 0, 1 },
+  { 202, 0, 202, 0, 0, 0, 1 }, { 203, 0, 203, 0, 0, 0, 1 }, { 207, 0, 207, 0, 0, 0, 1 }, { 0, 97, 0, 0, 0, 0, 1 },
+  { 211, 0, 211, 0, 0, 0, 1 }, { 209, 0, 209, 0, 0, 0, 1 }, { 0, 163, 0, 0, 0, 0, 1 }, { 213, 0, 213, 0, 0, 0, 1 },
+  { 0, 130, 0, 0, 0, 0, 1 }, { 214, 0, 214, 0, 0, 0, 1 }, { 218, 0, 218, 0, 0, 0, 1 }, { 217, 0, 217, 0, 0, 0, 1 },
+  { 219, 0, 219, 0, 0, 0, 1 }, { 0, 56, 0, 0, 0, 0, 1 }, { 2, 0, 2, 0, 0, 0, 1 }, { 1, -1, 1, 0, 0, 0, 1 },
+  { 0, -2, 0, 0, 0, 0, 1 }, { 0, -79, 0, 0, 0, 0, 1 }, { 0, 0, 0, 0, 16, 19, 1 }, { -97, 0, -97, 0, 0, 0, 1 },
+  { -56, 0, -56, 0, 0, 0, 1 }, { -130, 0, -130, 0, 0, 0, 1 }, { 10795, 0, 10795, 0, 0, 0, 1 }, { -163, 0, -163, 0, 0, 0, 1 },
+  { 10792, 0, 10792, 0, 0, 0, 1 }, { 0, 10815, 0, 0, 0, 0, 1 }, { -195, 0, -195, 0, 0, 0, 1 }, { 69, 0, 69, 0, 0, 0, 1 },
+  { 71, 0, 71, 0, 0, 0, 1 }, { 0, 10783, 0, 0, 0, 0, 1 }, { 0, 10780, 0, 0, 0, 0, 1 }, { 0, 10782, 0, 0, 0, 0, 1 },
+  { 0, -210, 0, 0, 0, 0, 1 }, { 0, -206, 0, 0, 0, 0, 1 }, { 0, -205, 0, 0, 0, 0, 1 }, { 0, -202, 0, 0, 0, 0, 1 },
+  { 0, -203, 0, 0, 0, 0, 1 }, { 0, 42319, 0, 0, 0, 0, 1 }, { 0, 42315, 0, 0, 0, 0, 1 }, { 0, -207, 0, 0, 0, 0, 1 },
+  { 0, 42280, 0, 0, 0, 0, 1 }, { 0, 42308, 0, 0, 0, 0, 1 }, { 0, -209, 0, 0, 0, 0, 1 }, { 0, -211, 0, 0, 0, 0, 1 },
+  { 0, 10743, 0, 0, 0, 0, 1 }, { 0, 42305, 0, 0, 0, 0, 1 }, { 0, 10749, 0, 0, 0, 0, 1 }, { 0, -213, 0, 0, 0, 0, 1 },
+  { 0, -214, 0, 0, 0, 0, 1 }, { 0, 10727, 0, 0, 0, 0, 1 }, { 0, -218, 0, 0, 0, 0, 1 }, { 0, 42307, 0, 0, 0, 0, 1 },
+  { 0, 42282, 0, 0, 0, 0, 1 }, { 0, -69, 0, 0, 0, 0, 1 }, { 0, -217, 0, 0, 0, 0, 1 }, { 0, -71, 0, 0, 0, 0, 1 },
+  { 0, -219, 0, 0, 0, 0, 1 }, { 0, 42261, 0, 0, 0, 0, 1 }, { 0, 42258, 0, 0, 0, 0, 1 }, { 0, 0, 0, 0, 0, 0, 3 },
+  { 0, 84, 116, 0, 0, 0, 3 }, { 116, 0, 116, 0, 0, 0, 1 }, { 38, 0, 38, 0, 0, 0, 1 }, { 37, 0, 37, 0, 0, 0, 1 },
+  { 64, 0, 64, 0, 0, 0, 1 }, { 63, 0, 63, 0, 0, 0, 1 }, { 0, 0, 0, 0, 22, 26, 1 }, { 0, -38, 0, 0, 0, 0, 1 },
+  { 0, -37, 0, 0, 0, 0, 1 }, { 0, 0, 0, 0, 30, 34, 1 }, { 0, -31, 1, 0, 0, 0, 1 }, { 0, -64, 0, 0, 0, 0, 1 },
+  { 0, -63, 0, 0, 0, 0, 1 }, { 8, 0, 8, 0, 0, 0, 1 }, { 0, -62, -30, 0, 0, 0, 1 }, { 0, -57, -25, 0, 0, 0, 1 },
+  { 0, -47, -15, 0, 0, 0, 1 }, { 0, -54, -22, 0, 0, 0, 1 }, { 0, -8, 0, 0, 0, 0, 1 }, { 0, -86, -54, 0, 0, 0, 1 },
+  { 0, -80, -48, 0, 0, 0, 1 }, { 0, 7, 0, 0, 0, 0, 1 }, { 0, -116, 0, 0, 0, 0, 1 }, { -60, 0, -60, 0, 0, 0, 1 },
+  { 0, -96, -64, 0, 0, 0, 1 }, { -7, 0, -7, 0, 0, 0, 1 }, { 80, 0, 80, 0, 0, 0, 1 }, { 0, -80, 0, 0, 0, 0, 1 },
+  { 15, 0, 15, 0, 0, 0, 1 }, { 0, -15, 0, 0, 0, 0, 1 }, { 48, 0, 48, 0, 0, 0, 1 }, { 0, -48, 0, 0, 0, 0, 1 },
+  { 0, 0, 0, 0, 38, 41, 1 }, { 7264, 0, 7264, 0, 0, 0, 1 }, { 0, 3008, 0, 0, 0, 0, 1 }, { 38864, 0, 0, 0, 0, 0, 1 },
+  { 8, 0, 0, 0, 0, 0, 1 }, { 0, -8, -8, 0, 0, 0, 1 }, { 0, -6254, -6222, 0, 0, 0, 1 }, { 0, -6253, -6221, 0, 0, 0, 1 },
+  { 0, -6244, -6212, 0, 0, 0, 1 }, { 0, -6242, -6210, 0, 0, 0, 1 }, { 0, -6243, -6211, 0, 0, 0, 1 }, { 0, -6236, -6204, 0, 0, 0, 1 },
+  { 0, -6181, -6180, 0, 0, 0, 1 }, { 0, 35266, 35267, 0, 0, 0, 1 }, { -3008, 0, -3008, 0, 0, 0, 1 }, { 0, 35332, 0, 0, 0, 0, 1 },
+  { 0, 3814, 0, 0, 0, 0, 1 }, { 0, 35384, 0, 0, 0, 0, 1 }, { 0, 0, 0, 0, 44, 47, 1 }, { 0, 0, 0, 0, 50, 53, 1 },
+  { 0, 0, 0, 0, 56, 59, 1 }, { 0, 0, 0, 0, 62, 65, 1 }, { 0, 0, 0, 0, 68, 71, 1 }, { 0, -59, -58, 0, 0, 0, 1 },
+  { -7615, 0, 0, 0, 0, 4, 1 }, { 0, 8, 0, 0, 0, 0, 1 }, { -8, 0, -8, 0, 0, 0, 1 }, { 0, 0, 0, 0, 74, 77, 1 },
+  { 0, 0, 0, 0, 80, 84, 1 }, { 0, 0, 0, 0, 88, 92, 1 }, { 0, 0, 0, 0, 96, 100, 1 }, { 0, 74, 0, 0, 0, 0, 1 },
+  { 0, 86, 0, 0, 0, 0, 1 }, { 0, 100, 0, 0, 0, 0, 1 }, { 0, 128, 0, 0, 0, 0, 1 }, { 0, 112, 0, 0, 0, 0, 1 },
+  { 0, 126, 0, 0, 0, 0, 1 }, { 0, 0, 0, 0, 104, 107, 1 }, { 0, 0, 0, 0, 110, 113, 1 }, { 0, 0, 0, 0, 116, 119, 1 },
+  { 0, 0, 0, 0, 122, 125, 1 }, { 0, 0, 0, 0, 128, 131, 1 }, { 0, 0, 0, 0, 134, 137, 1 }, { 0, 0, 0, 0, 140, 143, 1 },
+  { 0, 0, 0, 0, 146, 149, 1 }, { -8, 0, 0, 0, 104, 107, 1 }, { -8, 0, 0, 0, 110, 113, 1 }, { -8, 0, 0, 0, 116, 119, 1 },
+  { -8, 0, 0, 0, 122, 125, 1 }, { -8, 0, 0, 0, 128, 131, 1 }, { -8, 0, 0, 0, 134, 137, 1 }, { -8, 0, 0, 0, 140, 143, 1 },
+  { -8, 0, 0, 0, 146, 149, 1 }, { 0, 0, 0, 0, 152, 155, 1 }, { 0, 0, 0, 0, 158, 161, 1 }, { 0, 0, 0, 0, 164, 167, 1 },
+  { 0, 0, 0, 0, 170, 173, 1 }, { 0, 0, 0, 0, 176, 179, 1 }, { 0, 0, 0, 0, 182, 185, 1 }, { 0, 0, 0, 0, 188, 191, 1 },
+  { 0, 0, 0, 0, 194, 197, 1 }, { -8, 0, 0, 0, 152, 155, 1 }, { -8, 0, 0, 0, 158, 161, 1 }, { -8, 0, 0, 0, 164, 167, 1 },
+  { -8, 0, 0, 0, 170, 173, 1 }, { -8, 0, 0, 0, 176, 179, 1 }, { -8, 0, 0, 0, 182, 185, 1 }, { -8, 0, 0, 0, 188, 191, 1 },
+  { -8, 0, 0, 0, 194, 197, 1 }, { 0, 0, 0, 0, 200, 203, 1 }, { 0, 0, 0, 0, 206, 209, 1 }, { 0, 0, 0, 0, 212, 215, 1 },
+  { 0, 0, 0, 0, 218, 221, 1 }, { 0, 0, 0, 0, 224, 227, 1 }, { 0, 0, 0, 0, 230, 233, 1 }, { 0, 0, 0, 0, 236, 239, 1 },
+  { 0, 0, 0, 0, 242, 245, 1 }, { -8, 0, 0, 0, 200, 203, 1 }, { -8, 0, 0, 0, 206, 209, 1 }, { -8, 0, 0, 0, 212, 215, 1 },
+  { -8, 0, 0, 0, 218, 221, 1 }, { -8, 0, 0, 0, 224, 227, 1 }, { -8, 0, 0, 0, 230, 233, 1 }, { -8, 0, 0, 0, 236, 239, 1 },
+  { -8, 0, 0, 0, 242, 245, 1 }, { 0, 0, 0, 0, 248, 251, 1 }, { 0, 0, 0, 0, 254, 257, 1 }, { 0, 0, 0, 0, 260, 263, 1 },
+  { 0, 0, 0, 0, 266, 269, 1 }, { 0, 0, 0, 0, 272, 276, 1 }, { -74, 0, -74, 0, 0, 0, 1 }, { -9, 0, 0, 0, 254, 257, 1 },
+  { 0, -7205, -7173, 0, 0, 0, 1 }, { 0, 0, 0, 0, 280, 283, 1 }, { 0, 0, 0, 0, 286, 289, 1 }, { 0, 0, 0, 0, 292, 295, 1 },
+  { 0, 0, 0, 0, 298, 301, 1 }, { 0, 0, 0, 0, 304, 308, 1 }, { -86, 0, -86, 0, 0, 0, 1 }, { -9, 0, 0, 0, 286, 289, 1 },
+  { 0, 0, 0, 0, 312, 316, 1 }, { 0, 0, 0, 0, 320, 323, 1 }, { 0, 0, 0, 0, 326, 330, 1 }, { -100, 0, -100, 0, 0, 0, 1 },
+  { 0, 0, 0, 0, 334, 338, 1 }, { 0, 0, 0, 0, 342, 345, 1 }, { 0, 0, 0, 0, 348, 351, 1 }, { 0, 0, 0, 0, 354, 358, 1 },
+  { -112, 0, -112, 0, 0, 0, 1 }, { 0, 0, 0, 0, 362, 365, 1 }, { 0, 0, 0, 0, 368, 371, 1 }, { 0, 0, 0, 0, 374, 377, 1 },
+  { 0, 0, 0, 0, 380, 383, 1 }, { 0, 0, 0, 0, 386, 390, 1 }, { -128, 0, -128, 0, 0, 0, 1 }, { -126, 0, -126, 0, 0, 0, 1 },
+  { -9, 0, 0, 0, 368, 371, 1 }, { -7517, 0, -7517, 0, 0, 0, 1 }, { -8383, 0, -8383, 0, 0, 0, 1 }, { -8262, 0, -8262, 0, 0, 0, 1 },
+  { 28, 0, 28, 0, 0, 0, 1 }, { 0, -28, 0, 0, 0, 0, 1 }, { 16, 0, 16, 0, 0, 0, 1 }, { 0, -16, 0, 0, 0, 0, 1 },
+  { 26, 0, 26, 0, 0, 0, 1 }, { 0, -26, 0, 0, 0, 0, 1 }, { -10743, 0, -10743, 0, 0, 0, 1 }, { -3814, 0, -3814, 0, 0, 0, 1 },
+  { -10727, 0, -10727, 0, 0, 0, 1 }, { 0, -10795, 0, 0, 0, 0, 1 }, { 0, -10792, 0, 0, 0, 0, 1 }, { -10780, 0, -10780, 0, 0, 0, 1 },
+  { -10749, 0, -10749, 0, 0, 0, 1 }, { -10783, 0, -10783, 0, 0, 0, 1 }, { -10782, 0, -10782, 0, 0, 0, 1 }, { -10815, 0, -10815, 0, 0, 0, 1 },
+  { 0, -7264, 0, 0, 0, 0, 1 }, { -35332, 0, -35332, 0, 0, 0, 1 }, { -42280, 0, -42280, 0, 0, 0, 1 }, { 0, 48, 0, 0, 0, 0, 1 },
+  { -42308, 0, -42308, 0, 0, 0, 1 }, { -42319, 0, -42319, 0, 0, 0, 1 }, { -42315, 0, -42315, 0, 0, 0, 1 }, { -42305, 0, -42305, 0, 0, 0, 1 },
+  { -42258, 0, -42258, 0, 0, 0, 1 }, { -42282, 0, -42282, 0, 0, 0, 1 }, { -42261, 0, -42261, 0, 0, 0, 1 }, { 928, 0, 928, 0, 0, 0, 1 },
+  { -48, 0, -48, 0, 0, 0, 1 }, { -42307, 0, -42307, 0, 0, 0, 1 }, { -35384, 0, -35384, 0, 0, 0, 1 }, { 0, -928, 0, 0, 0, 0, 1 },
+  { 0, -38864, -38864, 0, 0, 0, 1 }, { 0, 0, 0, 0, 394, 397, 1 }, { 0, 0, 0, 0, 400, 403, 1 }, { 0, 0, 0, 0, 406, 409, 1 },
+  { 0, 0, 0, 0, 412, 416, 1 }, { 0, 0, 0, 0, 420, 424, 1 }, { 0, 0, 0, 0, 428, 431, 1 }, { 0, 0, 0, 0, 434, 437, 1 },
+  { 0, 0, 0, 0, 440, 443, 1 }, { 0, 0, 0, 0, 446, 449, 1 }, { 0, 0, 0, 0, 452, 455, 1 }, { 0, 0, 0, 0, 458, 461, 1 },
+  { 40, 0, 40, 0, 0, 0, 1 }, { 0, -40, 0, 0, 0, 0, 1 }, { 39, 0, 39, 0, 0, 0, 1 }, { 0, -39, 0, 0, 0, 0, 1 },
+  { 34, 0, 34, 0, 0, 0, 1 }, { 0, -34, 0, 0, 0, 0, 1 },
+};
+
+const char32_t _unicode_case_expansions[] = {
+  0x0000, 0x0002, 0x0053, 0x0053, 0x0002, 0x0073, 0x0073, 0x0002, 0x0069, 0x0307, 0x0002, 0x02BC,
+  0x004E, 0x0002, 0x02BC, 0x006E, 0x0002, 0x004A, 0x030C, 0x0002, 0x006A, 0x030C, 0x0003, 0x0399,
+  0x0308, 0x0301, 0x0003, 0x03B9, 0x0308, 0x0301, 0x0003, 0x03A5, 0x0308, 0x0301, 0x0003, 0x03C5,
+  0x0308, 0x0301, 0x0002, 0x0535, 0x0552, 0x0002, 0x0565, 0x0582, 0x0002, 0x0048, 0x0331, 0x0002,
+  0x0068, 0x0331, 0x0002, 0x0054, 0x0308, 0x0002, 0x0074, 0x0308, 0x0002, 0x0057, 0x030A, 0x0002,
+  0x0077, 0x030A, 0x0002, 0x0059, 0x030A, 0x0002, 0x0079, 0x030A, 0x0002, 0x0041, 0x02BE, 0x0002,
+  0x0061, 0x02BE, 0x0002, 0x03A5, 0x0313, 0x0002, 0x03C5, 0x0313, 0x0003, 0x03A5, 0x0313, 0x0300,
+  0x0003, 0x03C5, 0x0313, 0x0300, 0x0003, 0x03A5, 0x0313, 0x0301, 0x0003, 0x03C5, 0x0313, 0x0301,
+  0x0003, 0x03A5, 0x0313, 0x0342, 0x0003, 0x03C5, 0x0313, 0x0342, 0x0002, 0x1F08, 0x0399, 0x0002,
+  0x1F00, 0x03B9, 0x0002, 0x1F09, 0x0399, 0x0002, 0x1F01, 0x03B9, 0x0002, 0x1F0A, 0x0399, 0x0002,
+  0x1F02, 0x03B9, 0x0002, 0x1F0B, 0x0399, 0x0002, 0x1F03, 0x03B9, 0x0002, 0x1F0C, 0x0399, 0x0002,
+  0x1F04, 0x03B9, 0x0002, 0x1F0D, 0x0399, 0x0002, 0x1F05, 0x03B9, 0x0002, 0x1F0E, 0x0399, 0x0002,
+  0x1F06, 0x03B9, 0x0002, 0x1F0F, 0x0399, 0x0002, 0x1F07, 0x03B9, 0x0002, 0x1F28, 0x0399, 0x0002,
+  0x1F20, 0x03B9, 0x0002, 0x1F29, 0x0399, 0x0002, 0x1F21, 0x03B9, 0x0002, 0x1F2A, 0x0399, 0x0002,
+  0x1F22, 0x03B9, 0x0002, 0x1F2B, 0x0399, 0x0002, 0x1F23, 0x03B9, 0x0002, 0x1F2C, 0x0399, 0x0002,
+  0x1F24, 0x03B9, 0x0002, 0x1F2D, 0x0399, 0x0002, 0x1F25, 0x03B9, 0x0002, 0x1F2E, 0x0399, 0x0002,
+  0x1F26, 0x03B9, 0x0002, 0x1F2F, 0x0399, 0x0002, 0x1F27, 0x03B9, 0x0002, 0x1F68, 0x0399, 0x0002,
+  0x1F60, 0x03B9, 0x0002, 0x1F69, 0x0399, 0x0002, 0x1F61, 0x03B9, 0x0002, 0x1F6A, 0x0399, 0x0002,
+  0x1F62, 0x03B9, 0x0002, 0x1F6B, 0x0399, 0x0002, 0x1F63, 0x03B9, 0x0002, 0x1F6C, 0x0399, 0x0002,
+  0x1F64, 0x03B9, 0x0002, 0x1F6D, 0x0399, 0x0002, 0x1F65, 0x03B9, 0x0002, 0x1F6E, 0x0399, 0x0002,
+  0x1F66, 0x03B9, 0x0002, 0x1F6F, 0x0399, 0x0002, 0x1F67, 0x03B9, 0x0002, 0x1FBA, 0x0399, 0x0002,
+  0x1F70, 0x03B9, 0x0002, 0x0391, 0x0399, 0x0002, 0x03B1, 0x03B9, 0x0002, 0x0386, 0x0399, 0x0002,
+  0x03AC, 0x03B9, 0x0002, 0x0391, 0x0342, 0x0002, 0x03B1, 0x0342, 0x0003, 0x0391, 0x0342, 0x0399,
+  0x0003, 0x03B1, 0x0342, 0x03B9, 0x0002, 0x1FCA, 0x0399, 0x0002, 0x1F74, 0x03B9, 0x0002, 0x0397,
+  0x0399, 0x0002, 0x03B7, 0x03B9, 0x0002, 0x0389, 0x0399, 0x0002, 0x03AE, 0x03B9, 0x0002, 0x0397,
+  0x0342, 0x0002, 0x03B7, 0x0342, 0x0003, 0x0397, 0x0342, 0x0399, 0x0003, 0x03B7, 0x0342, 0x03B9,
+  0x0003, 0x0399, 0x0308, 0x0300, 0x0003, 0x03B9, 0x0308, 0x0300, 0x0002, 0x0399, 0x0342, 0x0002,
+  0x03B9, 0x0342, 0x0003, 0x0399, 0x0308, 0x0342, 0x0003, 0x03B9, 0x0308, 0x0342, 0x0003, 0x03A5,
+  0x0308, 0x0300, 0x0003, 0x03C5, 0x0308, 0x0300, 0x0002, 0x03A1, 0x0313, 0x0002, 0x03C1, 0x0313,
+  0x0002, 0x03A5, 0x0342, 0x0002, 0x03C5, 0x0342, 0x0003, 0x03A5, 0x0308, 0x0342, 0x0003, 0x03C5,
+  0x0308, 0x0342, 0x0002, 0x1FFA, 0x0399, 0x0002, 0x1F7C, 0x03B9, 0x0002, 0x03A9, 0x0399, 0x0002,
+  0x03C9, 0x03B9, 0x0002, 0x038F, 0x0399, 0x0002, 0x03CE, 0x03B9, 0x0002, 0x03A9, 0x0342, 0x0002,
+  0x03C9, 0x0342, 0x0003, 0x03A9, 0x0342, 0x0399, 0x0003, 0x03C9, 0x0342, 0x03B9, 0x0002, 0x0046,
+  0x0046, 0x0002, 0x0066, 0x0066, 0x0002, 0x0046, 0x0049, 0x0002, 0x0066, 0x0069, 0x0002, 0x0046,
+  0x004C, 0x0002, 0x0066, 0x006C, 0x0003, 0x0046, 0x0046, 0x0049, 0x0003, 0x0066, 0x0066, 0x0069,
+  0x0003, 0x0046, 0x0046, 0x004C, 0x0003, 0x0066, 0x0066, 0x006C, 0x0002, 0x0053, 0x0054, 0x0002,
+  0x0073, 0x0074, 0x0002, 0x0544, 0x0546, 0x0002, 0x0574, 0x0576, 0x0002, 0x0544, 0x0535, 0x0002,
+  0x0574, 0x0565, 0x0002, 0x0544, 0x053B, 0x0002, 0x0574, 0x056B, 0x0002, 0x054E, 0x0546, 0x0002,
+  0x057E, 0x0576, 0x0002, 0x0544, 0x053D, 0x0002, 0x0574, 0x056D,
+};
+
+// Normalization properties: 4108 records, 169 unique blocks.
+
+static const uint16_t _unicode_normalization_table_stage1[] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+  32, 33, 34, 35, 10, 10, 36, 10, 10, 10, 10, 10, 10, 10, 37, 38,
+  10, 39, 40, 10, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52,
+  53, 54, 55, 56, 57, 58, 59, 10, 60, 61, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 62, 63, 10, 10, 64, 65, 66, 67, 10, 68, 69, 70,
+  71, 72, 73, 74, 75, 76, 77, 78, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 79, 80, 81, 82,
+  83, 84, 85, 86, 10, 87, 88, 89, 90, 90, 90, 90, 90, 90, 90, 90,
+  90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90,
+  90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90,
+  90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90,
+  90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90,
+  90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 91,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105,
+  10, 10, 10, 106, 10, 107, 108, 10, 10, 10, 10, 10, 10, 10, 10, 109,
+  10, 10, 10, 10, 110, 111, 10, 10, 10, 10, 112, 10, 10, 113, 114, 115,
+  116, 117, 118, 119, 120, 121, 122, 10, 123, 124, 10, 125, 126, 127, 128, 10,
+  129, 10, 130, 131, 132, 133, 10, 10, 126, 10, 134, 135, 10, 10, 136, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 137, 138, 10, 10, 10, 10, 10, 10, 10, 10, 139,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 140, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 141, 142, 143, 10, 10, 10, 144, 145, 146, 147, 148, 149, 150, 151,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  152, 153, 138, 10, 10, 154, 10, 10, 10, 155, 10, 10, 10, 10, 10, 10,
+  10, 156, 157, 10, 10, 10, 10, 10, 10, 10, 10, 10, 158, 159, 10, 10,
+  10, 10, 160, 161, 162, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 163, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  164, 165, 166, 167, 168,
+};
+
+static const uint16_t _unicode_normalization_table_stage2[] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 0,
+  0, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+  19, 0, 20, 21, 22, 23, 24, 25, 26, 27, 28, 0, 0, 0, 0, 0,
+  0, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43,
+  44, 0, 45, 46, 47, 48, 49, 50, 51, 52, 53, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  54, 0, 0, 0, 0, 0, 0, 0, 55, 0, 56, 0, 0, 0, 0, 57,
+  0, 0, 58, 59, 60, 61, 0, 0, 62, 63, 64, 0, 65, 66, 67, 0,
+  68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83,
+  0, 84, 85, 86, 87, 88, 89, 0, 90, 91, 92, 93, 94, 95, 0, 0,
+  96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+  0, 112, 113, 114, 115, 116, 117, 0, 118, 119, 120, 121, 122, 123, 0, 124,
+  125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140,
+  0, 0, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154,
+  155, 156, 157, 158, 159, 160, 0, 0, 161, 162, 163, 164, 165, 166, 167, 168,
+  169, 0, 170, 171, 172, 173, 174, 175, 0, 176, 177, 178, 179, 180, 181, 182,
+  183, 0, 0, 184, 185, 186, 187, 188, 189, 190, 0, 0, 191, 192, 193, 194,
+  195, 196, 0, 0, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208,
+  209, 210, 211, 212, 213, 214, 0, 0, 215, 216, 217, 218, 219, 220, 221, 222,
+  223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  239, 240, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 241,
+  242, 0, 0, 0, 0, 0, 0, 243, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255,
+  256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268, 0, 269, 270,
+  271, 272, 273, 274, 0, 0, 275, 276, 277, 278, 279, 280, 281, 282, 283, 284,
+  285, 286, 287, 288, 289, 290, 0, 0, 291, 292, 293, 294, 295, 296, 297, 298,
+  299, 300, 301, 302, 303, 304, 305, 306, 307, 308, 309, 310, 311, 312, 313, 314,
+  315, 316, 317, 318, 319, 320, 321, 322, 323, 324, 325, 326, 0, 0, 327, 328,
+  0, 0, 0, 0, 0, 0, 329, 330, 331, 332, 333, 334, 335, 336, 337, 338,
+  339, 340, 341, 342, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 343, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  344, 345, 346, 347, 348, 349, 350, 351, 352, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 353, 354, 355, 356, 357, 358, 0, 0,
+  359, 360, 361, 362, 363, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  364, 364, 364, 364, 364, 365, 364, 364, 364, 364, 364, 364, 364, 365, 365, 364,
+  365, 364, 365, 364, 364, 366, 367, 367, 367, 367, 366, 368, 367, 367, 367, 367,
+  367, 369, 369, 370, 370, 370, 370, 371, 371, 367, 367, 367, 367, 370, 370, 367,
+  370, 370, 367, 367, 372, 372, 372, 372, 373, 367, 367, 367, 367, 365, 365, 365,
+  374, 375, 364, 376, 377, 378, 365, 367, 367, 367, 365, 365, 365, 367, 367, 0,
+  365, 365, 365, 367, 367, 367, 367, 365, 366, 367, 367, 365, 379, 380, 380, 379,
+  380, 380, 379, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365,
+  0, 0, 0, 0, 381, 0, 0, 0, 0, 0, 382, 0, 0, 0, 383, 0,
+  0, 0, 0, 0, 60, 384, 385, 386, 387, 388, 389, 0, 390, 0, 391, 392,
+  393, 394, 0, 0, 0, 395, 0, 396, 0, 397, 0, 0, 0, 0, 0, 398,
+  0, 399, 0, 0, 0, 400, 0, 0, 0, 401, 402, 403, 404, 405, 406, 407,
+  408, 409, 0, 0, 0, 410, 0, 411, 0, 412, 0, 0, 0, 0, 0, 413,
+  0, 414, 0, 0, 0, 415, 0, 0, 0, 416, 417, 418, 419, 420, 421, 0,
+  422, 423, 424, 425, 426, 427, 428, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  429, 430, 431, 0, 432, 433, 0, 0, 0, 434, 0, 0, 0, 0, 0, 0,
+  435, 436, 0, 437, 0, 0, 438, 439, 0, 0, 0, 0, 440, 441, 442, 0,
+  443, 0, 0, 444, 0, 445, 446, 447, 448, 449, 450, 0, 0, 0, 451, 0,
+  0, 0, 0, 452, 0, 0, 0, 453, 0, 0, 0, 454, 0, 455, 0, 0,
+  456, 0, 0, 457, 0, 458, 459, 460, 461, 462, 463, 0, 0, 0, 464, 0,
+  0, 0, 0, 465, 0, 0, 0, 466, 0, 0, 0, 467, 0, 468, 0, 0,
+  469, 470, 0, 471, 0, 0, 472, 473, 0, 0, 0, 0, 474, 475, 476, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 477, 478, 479, 480, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 365, 365, 365, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 481, 482, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  483, 484, 485, 486, 0, 0, 487, 488, 489, 490, 491, 492, 493, 494, 495, 496,
+  0, 0, 497, 498, 499, 500, 501, 502, 503, 504, 505, 506, 507, 508, 509, 510,
+  511, 512, 513, 514, 515, 516, 0, 0, 517, 518, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 519, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 367, 365, 365, 365, 365, 367, 365, 365, 365, 520, 367, 365, 365, 365, 365,
+  365, 365, 367, 367, 367, 367, 367, 367, 365, 365, 367, 365, 365, 520, 521, 365,
+  522, 523, 524, 525, 526, 527, 528, 529, 530, 531, 531, 532, 533, 534, 0, 535,
+  0, 536, 537, 0, 365, 367, 0, 530, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 365, 365, 365, 365, 365, 538, 539, 540, 0, 0, 0, 0, 0,
+  0, 0, 541, 542, 543, 544, 545, 546, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 547, 0, 548, 549, 550, 551, 538, 539,
+  540, 552, 553, 364, 364, 370, 367, 365, 365, 365, 365, 365, 367, 365, 365, 367,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  554, 0, 0, 0, 0, 555, 556, 557, 558, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  559, 560, 561, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 562, 563, 0, 564, 365, 365, 365, 365, 365, 365, 365, 0, 0, 365,
+  365, 365, 365, 367, 365, 0, 0, 365, 365, 0, 367, 365, 365, 367, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 565, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 367, 365, 365, 367, 365, 365, 367, 367, 367, 365, 367, 367, 365, 367, 365,
+  365, 365, 367, 365, 367, 365, 367, 365, 367, 365, 365, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 365, 365, 365, 365,
+  365, 365, 367, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 367, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 365, 365, 365, 365, 0, 365, 365, 365, 365, 365,
+  365, 365, 365, 365, 0, 365, 365, 365, 0, 365, 365, 365, 365, 365, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 367, 367, 367, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 365, 367, 367, 367, 365, 365, 365, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 365, 365, 365, 365, 367,
+  367, 367, 367, 367, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365,
+  365, 365, 0, 367, 365, 365, 367, 365, 365, 367, 365, 365, 365, 367, 367, 367,
+  549, 550, 551, 365, 365, 365, 367, 365, 365, 367, 367, 365, 365, 365, 365, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 566, 567, 0, 0, 0, 0, 0, 0,
+  568, 569, 0, 570, 571, 0, 0, 0, 0, 0, 0, 0, 572, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 0, 0,
+  0, 365, 367, 365, 365, 0, 0, 0, 574, 575, 576, 577, 578, 579, 580, 581,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 0, 583, 0,
+  0, 0, 0, 0, 0, 0, 0, 584, 0, 0, 0, 585, 586, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 583, 0, 0, 0, 0, 587, 588, 0, 589,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 590, 0, 0, 591, 0, 0, 0, 0, 0, 582, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 592, 593, 594, 0, 0, 595, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 0, 583, 0,
+  0, 0, 0, 0, 0, 0, 0, 596, 597, 0, 0, 598, 599, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 583, 583, 0, 0, 0, 0, 600, 601, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 602, 0, 603, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 583, 0,
+  0, 0, 0, 0, 0, 0, 604, 605, 0, 0, 606, 607, 608, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 583, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 609, 0, 610, 0, 0, 0, 0, 573, 0, 0,
+  0, 0, 0, 0, 0, 611, 612, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 0, 0, 613,
+  614, 0, 583, 0, 0, 0, 615, 616, 617, 0, 618, 619, 0, 573, 0, 0,
+  0, 0, 0, 0, 0, 583, 583, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 573, 0, 583, 0,
+  0, 0, 0, 0, 0, 0, 620, 621, 0, 0, 622, 623, 624, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 583, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 625, 0, 0, 0, 0, 583,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 626, 627, 0, 628, 629, 630, 583,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 631, 0, 0, 0, 0, 632, 632, 573, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 633, 633, 633, 633, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 634, 0, 0, 0, 0, 635, 635, 573, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 636, 636, 636, 636, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 637, 638, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 639, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 367, 367, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 367, 0, 367, 0, 640, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 641, 0, 0, 0, 0, 0, 0, 0, 0, 0, 642, 0, 0,
+  0, 0, 643, 0, 0, 0, 0, 644, 0, 0, 0, 0, 645, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 646, 0, 0, 0, 0, 0, 0,
+  0, 647, 648, 649, 650, 651, 652, 653, 654, 655, 648, 648, 648, 648, 0, 0,
+  648, 656, 365, 365, 573, 0, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 657, 0, 0, 0, 0, 0, 0, 0, 0, 0, 658, 0, 0,
+  0, 0, 659, 0, 0, 0, 0, 660, 0, 0, 0, 0, 661, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 662, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 367, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 663, 664, 0, 0, 0, 0, 0, 0, 0, 583, 0,
+  0, 0, 0, 0, 0, 0, 0, 582, 0, 573, 573, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 367, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 665, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583,
+  583, 583, 583, 583, 583, 583, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 583, 583, 583, 583, 583, 583, 583, 583,
+  583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583, 583,
+  583, 583, 583, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 365, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 573, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 521, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 520, 365, 367, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 365, 367, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 365, 365, 365, 365, 365, 365, 365, 365, 0, 0, 367,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 365, 365, 367, 367, 367, 367, 367, 367, 365, 365, 367, 0, 367,
+  367, 365, 365, 367, 367, 365, 365, 365, 365, 365, 367, 365, 365, 365, 365, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 666, 667, 668, 669, 670, 671, 672, 673, 674, 675, 0,
+  0, 676, 677, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 582, 583, 0, 0, 0, 0, 678, 679, 680, 681, 682, 683,
+  684, 685, 686, 687, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 367, 365, 365, 365,
+  365, 365, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 573, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 582, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 573, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 582, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 0, 372, 367, 367, 367, 367, 367, 365, 365, 367, 367, 367, 367,
+  365, 0, 372, 372, 372, 372, 372, 372, 372, 0, 0, 0, 0, 367, 0, 0,
+  0, 0, 0, 0, 365, 0, 0, 0, 365, 365, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 688, 689, 690, 0,
+  691, 692, 693, 694, 695, 696, 697, 698, 699, 700, 701, 0, 702, 703, 704, 705,
+  706, 707, 708, 56, 709, 710, 711, 712, 713, 714, 715, 716, 717, 718, 0, 719,
+  720, 721, 64, 722, 723, 724, 725, 726, 727, 728, 729, 730, 731, 422, 732, 733,
+  427, 734, 735, 347, 727, 730, 422, 732, 430, 427, 734, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 736, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 737, 738, 739, 740, 717,
+  741, 742, 743, 744, 745, 746, 747, 748, 749, 750, 751, 752, 753, 754, 755, 756,
+  757, 758, 759, 760, 761, 762, 763, 764, 765, 766, 767, 768, 769, 770, 771, 423,
+  365, 365, 367, 365, 365, 365, 365, 365, 365, 365, 367, 365, 365, 380, 772, 367,
+  369, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365,
+  365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365,
+  365, 365, 365, 365, 365, 365, 366, 521, 521, 367, 773, 365, 379, 367, 365, 367,
+  774, 775, 776, 777, 778, 779, 780, 781, 782, 783, 784, 785, 786, 787, 788, 789,
+  790, 791, 792, 793, 794, 795, 796, 797, 798, 799, 800, 801, 802, 803, 804, 805,
+  806, 807, 808, 809, 810, 811, 812, 813, 814, 815, 816, 817, 818, 819, 820, 821,
+  822, 823, 824, 825, 826, 827, 828, 829, 830, 831, 832, 833, 834, 835, 836, 837,
+  838, 839, 840, 841, 842, 843, 844, 845, 846, 847, 848, 849, 850, 851, 852, 853,
+  854, 855, 856, 857, 858, 859, 860, 861, 862, 863, 864, 865, 866, 867, 868, 869,
+  870, 871, 872, 873, 874, 875, 876, 877, 878, 879, 880, 881, 882, 883, 884, 885,
+  886, 887, 888, 889, 890, 891, 892, 893, 894, 895, 896, 897, 898, 899, 900, 901,
+  902, 903, 904, 905, 906, 907, 908, 909, 910, 911, 912, 913, 914, 915, 916, 917,
+  918, 919, 920, 921, 922, 923, 924, 925, 926, 927, 928, 929, 0, 0, 0, 0,
+  930, 931, 932, 933, 934, 935, 936, 937, 938, 939, 940, 941, 942, 943, 944, 945,
+  946, 947, 948, 949, 950, 951, 952, 953, 954, 955, 956, 957, 958, 959, 960, 961,
+  962, 963, 964, 965, 966, 967, 968, 969, 970, 971, 972, 973, 974, 975, 976, 977,
+  978, 979, 980, 981, 982, 983, 984, 985, 986, 987, 988, 989, 990, 991, 992, 993,
+  994, 995, 996, 997, 998, 999, 1000, 1001, 1002, 1003, 1004, 1005, 1006, 1007, 1008, 1009,
+  1010, 1011, 1012, 1013, 1014, 1015, 1016, 1017, 1018, 1019, 0, 0, 0, 0, 0, 0,
+  1020, 1021, 1022, 1023, 1024, 1025, 1026, 1027, 1028, 1029, 1030, 1031, 1032, 1033, 1034, 1035,
+  1036, 1037, 1038, 1039, 1040, 1041, 0, 0, 1042, 1043, 1044, 1045, 1046, 1047, 0, 0,
+  1048, 1049, 1050, 1051, 1052, 1053, 1054, 1055, 1056, 1057, 1058, 1059, 1060, 1061, 1062, 1063,
+  1064, 1065, 1066, 1067, 1068, 1069, 1070, 1071, 1072, 1073, 1074, 1075, 1076, 1077, 1078, 1079,
+  1080, 1081, 1082, 1083, 1084, 1085, 0, 0, 1086, 1087, 1088, 1089, 1090, 1091, 0, 0,
+  1092, 1093, 1094, 1095, 1096, 1097, 1098, 1099, 0, 1100, 0, 1101, 0, 1102, 0, 1103,
+  1104, 1105, 1106, 1107, 1108, 1109, 1110, 1111, 1112, 1113, 1114, 1115, 1116, 1117, 1118, 1119,
+  1120, 1121, 1122, 1123, 1124, 1125, 1126, 1127, 1128, 1129, 1130, 1131, 1132, 1133, 0, 0,
+  1134, 1135, 1136, 1137, 1138, 1139, 1140, 1141, 1142, 1143, 1144, 1145, 1146, 1147, 1148, 1149,
+  1150, 1151, 1152, 1153, 1154, 1155, 1156, 1157, 1158, 1159, 1160, 1161, 1162, 1163, 1164, 1165,
+  1166, 1167, 1168, 1169, 1170, 1171, 1172, 1173, 1174, 1175, 1176, 1177, 1178, 1179, 1180, 1181,
+  1182, 1183, 1184, 1185, 1186, 0, 1187, 1188, 1189, 1190, 1191, 1192, 1193, 1194, 1195, 1196,
+  1197, 1198, 1199, 1200, 1201, 0, 1202, 1203, 1204, 1205, 1206, 1207, 1208, 1209, 1210, 1211,
+  1212, 1213, 1214, 1215, 0, 0, 1216, 1217, 1218, 1219, 1220, 1221, 0, 1222, 1223, 1224,
+  1225, 1226, 1227, 1228, 1229, 1230, 1231, 1232, 1233, 1234, 1235, 1236, 1237, 1238, 1239, 1240,
+  0, 0, 1241, 1242, 1243, 0, 1244, 1245, 1246, 1247, 1248, 1249, 1250, 1251, 1252, 0,
+  1253, 1254, 54, 54, 54, 54, 54, 54, 54, 54, 54, 0, 0, 0, 0, 0,
+  0, 1255, 0, 0, 0, 0, 0, 1256, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1257, 1258, 1259, 0, 0, 0, 0, 0, 0, 0, 0, 54,
+  0, 0, 0, 1260, 1261, 0, 1262, 1263, 0, 0, 0, 0, 1264, 0, 1265, 0,
+  0, 0, 0, 0, 0, 0, 0, 1266, 1267, 1268, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1269, 0, 0, 0, 0, 0, 0, 0, 54,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1270, 735, 0, 0, 1271, 1272, 1273, 1274, 1275, 1276, 1277, 1278, 1279, 1280, 1281, 1282,
+  1270, 63, 58, 59, 1271, 1272, 1273, 1274, 1275, 1276, 1277, 1278, 1279, 1280, 1281, 0,
+  56, 714, 64, 362, 715, 344, 719, 360, 720, 1282, 725, 361, 726, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1283, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 372, 372, 365, 365, 365, 365, 372, 372, 372, 365, 365, 0, 0, 0,
+  0, 365, 0, 0, 0, 372, 372, 365, 367, 365, 372, 372, 367, 367, 367, 367,
+  365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1284, 1285, 1286, 1287, 0, 1288, 1289, 1290, 0, 1291, 718, 695, 695, 695, 344, 1292,
+  696, 696, 699, 360, 0, 701, 1293, 0, 0, 704, 1294, 705, 705, 705, 0, 0,
+  1295, 1296, 1297, 0, 1298, 0, 1299, 0, 1298, 0, 1300, 1301, 690, 1286, 0, 714,
+  692, 1302, 0, 700, 64, 1303, 1304, 1305, 1306, 735, 0, 1307, 428, 732, 1308, 1309,
+  1310, 0, 0, 0, 0, 691, 713, 714, 735, 346, 0, 0, 0, 0, 0, 0,
+  1311, 1312, 1313, 1314, 1315, 1316, 1317, 1318, 1319, 1320, 1321, 1322, 1323, 1324, 1325, 1326,
+  696, 1327, 1328, 1329, 1330, 1331, 1332, 1333, 1334, 1335, 1336, 1337, 699, 1286, 691, 700,
+  735, 1338, 1339, 1340, 730, 1341, 1342, 1343, 1344, 362, 1345, 1346, 360, 738, 713, 720,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1347, 0, 0, 0, 0, 0, 0,
+  1348, 0, 1349, 0, 1350, 0, 0, 0, 0, 0, 1351, 1352, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1353, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1354, 1355, 1356,
+  1357, 0, 1358, 0, 1359, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1360, 1361, 0, 0, 0, 1362, 1363, 0, 1364, 1365, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1366, 1367, 1368, 1369, 0, 0, 0, 0, 0, 1370, 1371, 0, 1372,
+  1373, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1374, 0, 0, 0,
+  0, 1375, 0, 1376, 1377, 1378, 0, 1379, 1380, 1381, 0, 0, 0, 1382, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1383, 1384, 1385, 0, 1386, 1387, 0, 0, 0, 0, 0, 0, 0, 1388, 1389, 1390,
+  1391, 1392, 1393, 1394, 1395, 1396, 1397, 1398, 1399, 1400, 1401, 1402, 1403, 1404, 0, 0,
+  1405, 1406, 1407, 1408, 1409, 1410, 1411, 1412, 1413, 1414, 0, 0, 0, 0, 0, 0,
+  0, 1415, 1416, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1417, 0, 0, 0, 0, 0, 1418, 1419, 0, 1420, 1421, 1422, 1423, 1424,
+  0, 0, 1425, 1426, 1427, 1428, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1429, 1430, 1431, 1432, 0, 0, 0, 0, 0, 0, 1433, 1434, 1435, 1436, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1437, 1438, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  63, 58, 59, 1271, 1272, 1273, 1274, 1275, 1276, 1439, 1440, 1441, 1442, 1443, 1444, 1445,
+  1446, 1447, 1448, 1449, 1450, 1451, 1452, 1453, 1454, 1455, 1456, 1457, 1458, 1459, 1460, 1461,
+  1462, 1463, 1464, 1465, 1466, 1467, 1468, 1469, 1470, 1471, 1472, 1473, 1474, 1475, 1476, 1477,
+  1478, 1479, 1480, 1481, 1482, 1483, 1484, 1485, 1486, 1487, 1488, 1489, 1490, 1491, 1492, 1493,
+  1494, 1495, 1496, 1497, 1498, 1499, 1500, 1501, 1502, 1503, 1504, 1505, 1506, 1507, 1508, 1509,
+  1510, 1511, 1512, 1513, 1514, 1515, 688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697,
+  698, 699, 700, 701, 702, 704, 1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298,
+  56, 712, 738, 713, 714, 741, 718, 344, 735, 346, 719, 360, 720, 1282, 64, 725,
+  1518, 347, 361, 726, 727, 730, 351, 362, 352, 768, 1270, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1519, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1520, 1521, 1522, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1523, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 346, 1330, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365,
+  365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1524,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365,
+  365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1525,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 1526, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1527, 1528, 1529, 1530, 1531, 1532, 1533, 1534, 1535, 1536, 1537, 1538, 1539, 1540, 1541, 1542,
+  1543, 1544, 1545, 1546, 1547, 1548, 1549, 1550, 1551, 1552, 1553, 1554, 1555, 1556, 1557, 1558,
+  1559, 1560, 1561, 1562, 1563, 1564, 1565, 1566, 1567, 1568, 1569, 1570, 1571, 1572, 1573, 1574,
+  1575, 1576, 1577, 1578, 1579, 1580, 1581, 1582, 1583, 1584, 1585, 1586, 1587, 1588, 1589, 1590,
+  1591, 1592, 1593, 1594, 1595, 1596, 1597, 1598, 1599, 1600, 1601, 1602, 1603, 1604, 1605, 1606,
+  1607, 1608, 1609, 1610, 1611, 1612, 1613, 1614, 1615, 1616, 1617, 1618, 1619, 1620, 1621, 1622,
+  1623, 1624, 1625, 1626, 1627, 1628, 1629, 1630, 1631, 1632, 1633, 1634, 1635, 1636, 1637, 1638,
+  1639, 1640, 1641, 1642, 1643, 1644, 1645, 1646, 1647, 1648, 1649, 1650, 1651, 1652, 1653, 1654,
+  1655, 1656, 1657, 1658, 1659, 1660, 1661, 1662, 1663, 1664, 1665, 1666, 1667, 1668, 1669, 1670,
+  1671, 1672, 1673, 1674, 1675, 1676, 1677, 1678, 1679, 1680, 1681, 1682, 1683, 1684, 1685, 1686,
+  1687, 1688, 1689, 1690, 1691, 1692, 1693, 1694, 1695, 1696, 1697, 1698, 1699, 1700, 1701, 1702,
+  1703, 1704, 1705, 1706, 1707, 1708, 1709, 1710, 1711, 1712, 1713, 1714, 1715, 1716, 1717, 1718,
+  1719, 1720, 1721, 1722, 1723, 1724, 1725, 1726, 1727, 1728, 1729, 1730, 1731, 1732, 1733, 1734,
+  1735, 1736, 1737, 1738, 1739, 1740, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  54, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 773, 521, 366, 520, 1741, 1741,
+  0, 0, 0, 0, 0, 0, 1742, 0, 1550, 1743, 1744, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1745, 0, 0, 0, 0, 1746, 1747, 1748, 1749, 1750,
+  1751, 1752, 1753, 1754, 1755, 1756, 1757, 1758, 1759, 1760, 1761, 1762, 1763, 1764, 1765, 1766,
+  1767, 1768, 1769, 0, 1770, 1771, 1772, 1773, 1774, 1775, 0, 0, 0, 0, 0, 1776,
+  1777, 1778, 1779, 1780, 1781, 1782, 1783, 1784, 1785, 1786, 1787, 1788, 1789, 1790, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1791, 0, 0, 0, 0, 1792, 1792, 1793, 1794, 1795, 1796, 1797,
+  0, 0, 0, 0, 0, 0, 1798, 0, 0, 0, 0, 1799, 1800, 1801, 1802, 1803,
+  1804, 1805, 1806, 1807, 1808, 1809, 1810, 1811, 1812, 1813, 1814, 1815, 1816, 1817, 1818, 1819,
+  1820, 1821, 1822, 0, 1823, 1824, 1825, 1826, 1827, 1828, 0, 0, 0, 0, 0, 1829,
+  1830, 1831, 1832, 1833, 1834, 1835, 1836, 1837, 1838, 1839, 1840, 1841, 1842, 1843, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1844,
+  1845, 1846, 1847, 0, 1848, 0, 0, 1849, 1850, 1851, 1852, 0, 0, 1853, 1854, 1855,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1856, 1857, 1858, 1859, 1860, 1861, 1862, 1863, 1864, 1865, 1866, 1867, 1868, 1869, 1870,
+  1871, 1872, 1873, 1874, 1875, 1876, 1877, 1878, 1879, 1880, 1881, 1882, 1883, 1884, 1885, 1886,
+  1887, 1888, 1889, 1890, 1891, 1892, 1893, 1894, 1895, 1896, 1897, 1898, 1899, 1900, 1901, 1902,
+  1903, 1904, 1905, 1906, 1907, 1908, 1909, 1910, 1911, 1912, 1913, 1914, 1915, 1916, 1917, 1918,
+  1919, 1920, 1921, 1922, 1923, 1924, 1925, 1926, 1927, 1928, 1929, 1930, 1931, 1932, 1933, 1934,
+  1935, 1936, 1937, 1938, 1939, 1940, 1941, 1942, 1943, 1944, 1945, 1946, 1947, 1948, 1949, 0,
+  0, 0, 1527, 1533, 1950, 1951, 1952, 1953, 1954, 1955, 1531, 1956, 1957, 1958, 1959, 1535,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1960, 1961, 1962, 1963, 1964, 1965, 1966, 1967, 1968, 1969, 1970, 1971, 1972, 1973, 1974, 1975,
+  1976, 1977, 1978, 1979, 1980, 1981, 1982, 1983, 1984, 1985, 1986, 1987, 1988, 1989, 1990, 0,
+  1991, 1992, 1993, 1994, 1995, 1996, 1997, 1998, 1999, 2000, 2001, 2002, 2003, 2004, 2005, 2006,
+  2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019, 2020, 2021, 2022,
+  2023, 2024, 2025, 2026, 2027, 2028, 1593, 2029, 0, 0, 0, 0, 0, 0, 0, 0,
+  2030, 2031, 2032, 2033, 2034, 2035, 2036, 2037, 2038, 2039, 2040, 2041, 2042, 2043, 2044, 2045,
+  1856, 1859, 1862, 1864, 1872, 1873, 1876, 1878, 1879, 1881, 1882, 1883, 1884, 1885, 2046, 2047,
+  2048, 2049, 2050, 2051, 2052, 2053, 2054, 2055, 2056, 2057, 2058, 2059, 2060, 2061, 2062, 0,
+  1527, 1533, 1950, 1951, 2063, 2064, 2065, 1538, 2066, 1550, 1600, 1612, 1611, 1601, 1693, 1558,
+  1598, 2067, 2068, 2069, 2070, 2071, 2072, 2073, 2074, 2075, 2076, 1564, 2077, 2078, 2079, 2080,
+  2081, 2082, 2083, 2084, 1952, 1953, 1954, 2085, 2086, 2087, 2088, 2089, 2090, 2091, 2092, 2093,
+  2094, 2095, 2096, 2097, 2098, 2099, 2100, 2101, 2102, 2103, 2104, 2105, 2106, 2107, 2108, 2109,
+  2110, 2111, 2112, 2113, 2114, 2115, 2116, 2117, 2118, 2119, 2120, 2121, 2122, 2123, 2124, 2125,
+  2126, 2127, 2128, 2129, 2130, 2131, 2132, 2133, 2134, 2135, 2136, 2137, 2138, 2139, 2140, 2141,
+  2142, 2143, 2144, 2145, 2146, 2147, 2148, 2149, 2150, 2151, 2152, 2153, 2154, 2155, 2156, 2157,
+  2158, 2159, 2160, 2161, 2162, 2163, 2164, 2165, 2166, 2167, 2168, 2169, 2170, 2171, 2172, 2173,
+  2174, 2175, 2176, 2177, 2178, 2179, 2180, 2181, 2182, 2183, 2184, 2185, 2186, 2187, 2188, 2189,
+  2190, 2191, 2192, 2193, 2194, 2195, 2196, 2197, 2198, 2199, 2200, 2201, 2202, 2203, 2204, 2205,
+  2206, 2207, 2208, 2209, 2210, 2211, 2212, 2213, 2214, 2215, 2216, 2217, 2218, 2219, 2220, 2221,
+  2222, 2223, 2224, 2225, 2226, 2227, 2228, 2229, 2230, 2231, 2232, 2233, 2234, 2235, 2236, 2237,
+  2238, 2239, 2240, 2241, 2242, 2243, 2244, 2245, 2246, 2247, 2248, 2249, 2250, 2251, 2252, 2253,
+  2254, 2255, 2256, 2257, 2258, 2259, 2260, 2261, 2262, 2263, 2264, 2265, 2266, 2267, 2268, 2269,
+  2270, 2271, 2272, 2273, 2274, 2275, 2276, 2277, 2278, 2279, 2280, 2281, 2282, 2283, 2284, 2285,
+  2286, 2287, 2288, 2289, 2290, 2291, 2292, 2293, 2294, 2295, 2296, 2297, 2298, 2299, 2300, 2301,
+  2302, 2303, 2304, 2305, 2306, 2307, 2308, 2309, 2310, 2311, 2312, 2313, 2314, 2315, 2316, 2317,
+  2318, 2319, 2320, 2321, 2322, 2323, 2324, 2325, 2326, 2327, 2328, 2329, 2330, 2331, 2332, 2333,
+  2334, 2335, 2336, 2337, 2338, 2339, 2340, 2341, 2342, 2343, 2344, 2345, 2346, 2347, 2348, 2349,
+  2350, 2351, 2352, 2353, 2354, 2355, 2356, 2357, 2358, 2359, 2360, 2361, 2362, 2363, 2364, 2365,
+  2366, 2367, 2368, 2369, 2370, 2371, 2372, 2373, 2374, 2375, 2376, 2377, 2378, 2379, 2380, 2381,
+  2382, 2383, 2384, 2385, 2386, 2387, 2388, 2389, 2390, 2391, 2392, 2393, 2394, 2395, 2396, 2397,
+  2398, 2399, 2400, 2401, 2402, 2403, 2404, 2405, 2406, 2407, 2408, 2409, 2410, 2411, 2412, 2413,
+  2414, 2415, 2416, 2417, 2418, 2419, 2420, 2421, 2422, 2423, 2424, 2425, 2426, 2427, 2428, 2429,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365,
+  0, 0, 0, 0, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2430, 2431, 365, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2432, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1286, 1302, 1294, 0, 0, 0, 2433, 2434, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365,
+  365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 367, 367, 367, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 582, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 0, 365, 365, 367, 0, 0, 365, 365, 0, 0, 0, 0, 0, 365, 365,
+  0, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2435, 2436, 2437, 2438,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 2439, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440, 2440,
+  2440, 2440, 2440, 2440, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2441, 2442, 2443, 2444, 2445, 2446, 2447, 2448, 2448, 2449, 2450, 2451, 2452, 2453, 2454, 2455,
+  2456, 2457, 2458, 2459, 2460, 2461, 2462, 2463, 2464, 2465, 2466, 2467, 2468, 2469, 2470, 2471,
+  2472, 2473, 2474, 2475, 2476, 2477, 2478, 2479, 2480, 2481, 2482, 2483, 2484, 2485, 2486, 2487,
+  2488, 2489, 2490, 2491, 2492, 2493, 2494, 2495, 2496, 2497, 2498, 2499, 2500, 2501, 2502, 2503,
+  2504, 2505, 2506, 2507, 2508, 2509, 2510, 2511, 2512, 2513, 2514, 2515, 2516, 2517, 2518, 2519,
+  2520, 2521, 2522, 2523, 2524, 2525, 2526, 2527, 2528, 2529, 2530, 2531, 2460, 2532, 2533, 2534,
+  2535, 2536, 2537, 2538, 2539, 2540, 2541, 2542, 2543, 2544, 2545, 2546, 2547, 2548, 2549, 2550,
+  2551, 2552, 2553, 2554, 2555, 2556, 2557, 2558, 2559, 2560, 2561, 2562, 2563, 2564, 2565, 2566,
+  2567, 2568, 2569, 2570, 2571, 2572, 2573, 2574, 2575, 2576, 2577, 2578, 2579, 2580, 2581, 2582,
+  2583, 2584, 2585, 2586, 2587, 2588, 2589, 2590, 2591, 2592, 2593, 2594, 2595, 2596, 2597, 2598,
+  2599, 2550, 2600, 2601, 2602, 2603, 2604, 2605, 2606, 2607, 2534, 2608, 2609, 2610, 2611, 2612,
+  2613, 2614, 2615, 2616, 2617, 2618, 2619, 2620, 2621, 2622, 2623, 2624, 2625, 2626, 2627, 2460,
+  2628, 2629, 2630, 2631, 2632, 2633, 2634, 2635, 2636, 2637, 2638, 2639, 2640, 2641, 2642, 2643,
+  2644, 2645, 2646, 2647, 2648, 2649, 2650, 2651, 2652, 2653, 2654, 2536, 2655, 2656, 2657, 2658,
+  2659, 2660, 2661, 2662, 2663, 2664, 2665, 2666, 2667, 2668, 2669, 2670, 2671, 2672, 2673, 2674,
+  2675, 2676, 2677, 2678, 2679, 2680, 2681, 2682, 2683, 2684, 2685, 2686, 2687, 2688, 2689, 2690,
+  2691, 2692, 2693, 2694, 2695, 2696, 2697, 2698, 2699, 2700, 2701, 2702, 2703, 2704, 0, 0,
+  2705, 0, 2706, 0, 0, 2707, 2708, 2709, 2710, 2711, 2712, 2713, 2714, 2715, 2716, 0,
+  2717, 0, 2718, 0, 0, 2719, 2720, 0, 0, 0, 2721, 2722, 2723, 2724, 2725, 2726,
+  2727, 2728, 2729, 2730, 2731, 2732, 2733, 2734, 2735, 2736, 2737, 2738, 2739, 2740, 2741, 2742,
+  2743, 2744, 2745, 2746, 2747, 2748, 2749, 2750, 2751, 2752, 2753, 2754, 2755, 2756, 2757, 2758,
+  2759, 2760, 2761, 2762, 2763, 2764, 2765, 2589, 2766, 2767, 2768, 2769, 2770, 2771, 2771, 2772,
+  2773, 2774, 2775, 2776, 2777, 2778, 2779, 2719, 2780, 2781, 2782, 2783, 2784, 2785, 0, 0,
+  2786, 2787, 2788, 2789, 2790, 2791, 2792, 2793, 2733, 2794, 2795, 2796, 2705, 2797, 2798, 2799,
+  2800, 2801, 2802, 2803, 2804, 2805, 2806, 2807, 2808, 2742, 2809, 2743, 2810, 2811, 2812, 2813,
+  2814, 2706, 2481, 2815, 2816, 2817, 2551, 2638, 2818, 2819, 2750, 2820, 2751, 2821, 2822, 2823,
+  2708, 2824, 2825, 2826, 2827, 2828, 2709, 2829, 2830, 2831, 2832, 2833, 2834, 2765, 2835, 2836,
+  2589, 2837, 2769, 2838, 2839, 2840, 2841, 2842, 2774, 2843, 2718, 2844, 2775, 2532, 2845, 2776,
+  2846, 2778, 2847, 2848, 2849, 2850, 2851, 2780, 2714, 2852, 2781, 2853, 2782, 2854, 2448, 2855,
+  2856, 2857, 2858, 2859, 2860, 2861, 2862, 2863, 2864, 2865, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2866, 2867, 2868, 2869, 2870, 2871, 2871, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 2872, 2873, 2874, 2875, 2876, 0, 0, 0, 0, 0, 2877, 2878, 2879,
+  2880, 1303, 1306, 2881, 2882, 2883, 2884, 2885, 2886, 1277, 2887, 2888, 2889, 2890, 2891, 2892,
+  2893, 2894, 2895, 2896, 2897, 2898, 2899, 0, 2900, 2901, 2902, 2903, 2904, 0, 2905, 0,
+  2906, 2907, 0, 2908, 2909, 0, 2910, 2911, 2912, 2913, 2914, 2915, 2916, 2917, 2918, 2919,
+  2920, 2920, 2921, 2921, 2921, 2921, 2922, 2922, 2922, 2922, 2923, 2923, 2923, 2923, 2924, 2924,
+  2924, 2924, 2925, 2925, 2925, 2925, 2926, 2926, 2926, 2926, 2927, 2927, 2927, 2927, 2928, 2928,
+  2928, 2928, 2929, 2929, 2929, 2929, 2930, 2930, 2930, 2930, 2931, 2931, 2931, 2931, 2932, 2932,
+  2932, 2932, 2933, 2933, 2934, 2934, 2935, 2935, 2936, 2936, 2937, 2937, 2938, 2938, 2939, 2939,
+  2939, 2939, 2940, 2940, 2940, 2940, 2941, 2941, 2941, 2941, 2942, 2942, 2942, 2942, 2943, 2943,
+  2944, 2944, 2944, 2944, 2945, 2945, 2946, 2946, 2946, 2946, 2947, 2947, 2947, 2947, 2948, 2948,
+  2949, 2949, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 2950, 2950, 2950, 2950, 2951, 2951, 2952, 2952, 2953, 2953, 557, 2954, 2954,
+  2955, 2955, 2956, 2956, 2957, 2957, 2957, 2957, 2958, 2958, 2959, 2959, 2960, 2960, 2961, 2961,
+  2962, 2962, 2963, 2963, 2964, 2964, 2965, 2965, 2965, 2966, 2966, 2966, 2967, 2967, 2967, 2967,
+  2968, 2969, 2970, 2966, 2971, 2972, 2973, 2974, 2975, 2976, 2977, 2978, 2979, 2980, 2981, 2982,
+  2983, 2984, 2985, 2986, 2987, 2988, 2989, 2990, 2991, 2992, 2993, 2994, 2995, 2996, 2997, 2998,
+  2999, 3000, 3001, 3002, 3003, 3004, 3005, 3006, 3007, 3008, 3009, 3010, 3011, 3012, 3013, 3014,
+  3015, 3016, 3017, 3018, 3019, 3020, 3021, 3022, 3023, 3024, 3025, 3026, 3027, 3028, 3029, 3030,
+  3031, 3032, 3033, 3034, 3035, 3036, 3037, 3038, 3039, 3040, 3041, 3042, 3043, 3044, 3045, 3046,
+  3047, 3048, 3049, 3050, 3051, 3052, 3053, 3054, 3055, 3056, 3057, 3058, 3059, 3060, 3061, 3062,
+  3063, 3064, 3065, 3066, 3067, 3068, 2970, 3069, 2966, 2971, 3070, 3071, 2975, 3072, 2976, 2977,
+  3073, 3074, 2981, 3075, 2982, 2983, 3076, 3077, 2985, 3078, 2986, 2987, 3016, 3017, 3020, 3021,
+  3022, 3026, 3027, 3028, 3029, 3033, 3034, 3035, 3079, 3039, 3080, 3081, 3045, 3082, 3046, 3047,
+  3060, 3083, 3084, 3055, 3085, 3056, 3057, 2968, 2969, 3086, 2970, 3087, 2972, 2973, 2974, 2975,
+  3088, 2978, 2979, 2980, 2981, 3089, 2985, 2988, 2989, 2990, 2991, 2992, 2994, 2995, 2996, 2997,
+  2998, 2999, 3090, 3000, 3001, 3002, 3003, 3004, 3005, 3007, 3008, 3009, 3010, 3011, 3012, 3013,
+  3014, 3015, 3018, 3019, 3023, 3024, 3025, 3026, 3027, 3030, 3031, 3032, 3033, 3091, 3036, 3037,
+  3038, 3039, 3042, 3043, 3044, 3045, 3092, 3048, 3049, 3093, 3052, 3053, 3054, 3055, 3094, 2970,
+  3087, 2975, 3088, 2981, 3089, 2985, 3095, 2998, 3096, 3097, 3098, 3026, 3027, 3033, 3045, 3092,
+  3055, 3094, 3099, 3100, 3101, 3102, 3103, 3104, 3105, 3106, 3107, 3108, 3109, 3110, 3111, 3112,
+  3113, 3114, 3115, 3116, 3117, 3118, 3119, 3120, 3121, 3122, 3123, 3124, 3097, 3125, 3126, 3127,
+  3128, 3102, 3103, 3104, 3105, 3106, 3107, 3108, 3109, 3110, 3111, 3112, 3113, 3114, 3115, 3116,
+  3117, 3118, 3119, 3120, 3121, 3122, 3123, 3124, 3097, 3125, 3126, 3127, 3128, 3122, 3123, 3124,
+  3097, 3096, 3098, 3006, 2995, 2996, 2997, 3122, 3123, 3124, 3006, 3007, 3129, 3129, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3130, 3131, 3131, 3132, 3133, 3134, 3135, 3136, 3137, 3137, 3138, 3139, 3140, 3141, 3142, 3143,
+  3143, 3144, 3145, 3145, 3146, 3146, 3147, 3148, 3148, 3149, 3150, 3150, 3151, 3151, 3152, 3153,
+  3153, 3154, 3154, 3155, 3156, 3157, 3158, 3158, 3159, 3160, 3161, 3162, 3163, 3163, 3164, 3165,
+  3166, 3167, 3168, 3169, 3169, 3170, 3170, 3171, 3171, 3172, 3173, 3174, 3175, 3176, 3177, 3178,
+  0, 0, 3179, 3180, 3181, 3182, 3183, 3184, 3184, 3185, 3186, 3187, 3188, 3188, 3189, 3190,
+  3191, 3192, 3193, 3194, 3195, 3196, 3197, 3198, 3199, 3200, 3201, 3202, 3203, 3204, 3205, 3206,
+  3207, 3208, 3209, 3210, 3164, 3166, 3211, 3212, 3213, 3214, 3215, 3216, 3215, 3213, 3217, 3218,
+  3219, 3220, 3221, 3216, 3157, 3147, 3222, 3223, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3224, 3225, 3226, 3227, 3228, 3229, 3230, 3231, 3232, 3233, 3234, 3235, 3236, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3237, 3238, 3239, 3240, 3241, 3242, 3243, 3244, 3245, 1259, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 365, 365, 365, 365, 367, 367, 367, 367, 367, 367, 367, 365, 365,
+  1258, 3246, 3247, 3248, 3248, 1280, 1281, 3249, 3250, 3251, 3252, 3253, 3254, 3255, 3256, 3257,
+  3258, 3259, 3260, 3261, 3262, 0, 0, 3263, 3264, 1265, 1265, 1265, 1265, 3248, 3248, 3248,
+  3237, 3238, 1257, 0, 3241, 3240, 3243, 3242, 3246, 1280, 1281, 3249, 3250, 3251, 3252, 3265,
+  3266, 3267, 1277, 3268, 3269, 3270, 1279, 0, 3271, 3272, 3273, 3274, 0, 0, 0, 0,
+  3275, 3276, 3277, 0, 3278, 0, 3279, 3280, 3281, 3282, 3283, 3284, 3285, 3286, 3287, 3288,
+  3289, 3290, 3290, 3291, 3291, 3292, 3292, 3293, 3293, 3294, 3294, 3294, 3294, 3295, 3295, 3296,
+  3296, 3296, 3296, 3297, 3297, 3298, 3298, 3298, 3298, 3299, 3299, 3299, 3299, 3300, 3300, 3300,
+  3300, 3301, 3301, 3301, 3301, 3302, 3302, 3302, 3302, 3303, 3303, 3304, 3304, 3305, 3305, 3306,
+  3306, 3307, 3307, 3307, 3307, 3308, 3308, 3308, 3308, 3309, 3309, 3309, 3309, 3310, 3310, 3310,
+  3310, 3311, 3311, 3311, 3311, 3312, 3312, 3312, 3312, 3313, 3313, 3313, 3313, 3314, 3314, 3314,
+  3314, 3315, 3315, 3315, 3315, 3316, 3316, 3316, 3316, 3317, 3317, 3317, 3317, 3318, 3318, 3318,
+  3318, 3319, 3319, 3319, 3319, 3320, 3320, 3320, 3320, 3321, 3321, 3321, 3321, 3322, 3322, 2958,
+  2958, 3323, 3323, 3323, 3323, 3324, 3324, 3325, 3325, 3326, 3326, 3327, 3327, 0, 0, 0,
+  0, 3242, 3328, 3265, 3272, 3273, 3266, 3329, 1280, 1281, 3267, 1277, 3237, 3268, 1257, 3330,
+  1270, 63, 58, 59, 1271, 1272, 1273, 1274, 1275, 1276, 3240, 3241, 3269, 1279, 3270, 3243,
+  3274, 688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702,
+  704, 1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 3263, 3271, 3264, 3331, 3248,
+  3332, 56, 712, 738, 713, 714, 741, 718, 344, 735, 346, 719, 360, 720, 1282, 64,
+  725, 1518, 347, 361, 726, 727, 730, 351, 362, 352, 768, 3249, 3333, 3250, 3334, 3335,
+  3336, 3239, 3259, 3260, 3238, 3337, 2172, 3338, 3339, 3340, 3341, 3342, 3343, 3344, 3345, 3346,
+  3347, 2126, 2127, 2128, 2129, 2130, 2131, 2132, 2133, 2134, 2135, 2136, 2137, 2138, 2139, 2140,
+  2141, 2142, 2143, 2144, 2145, 2146, 2147, 2148, 2149, 2150, 2151, 2152, 2153, 2154, 2155, 2156,
+  2157, 2158, 2159, 2160, 2161, 2162, 2163, 2164, 2165, 2166, 2167, 2168, 2169, 3348, 3349, 3350,
+  1907, 1856, 1857, 1858, 1859, 1860, 1861, 1862, 1863, 1864, 1865, 1866, 1867, 1868, 1869, 1870,
+  1871, 1872, 1873, 1874, 1875, 1876, 1877, 1878, 1879, 1880, 1881, 1882, 1883, 1884, 1885, 0,
+  0, 0, 1886, 1887, 1888, 1889, 1890, 1891, 0, 0, 1892, 1893, 1894, 1895, 1896, 1897,
+  0, 0, 1898, 1899, 1900, 1901, 1902, 1903, 0, 0, 1904, 1905, 1906, 0, 0, 0,
+  3351, 3352, 3353, 57, 3354, 3355, 3356, 0, 3357, 3358, 3359, 3360, 3361, 3362, 3363, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 367, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  367, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 365, 365, 365, 365, 365, 0, 0, 0, 0, 0,
+  0, 3364, 3365, 3366, 3367, 3368, 0, 3369, 3370, 3371, 3372, 3373, 3374, 3375, 3376, 3377,
+  3378, 3379, 3380, 3381, 3382, 1292, 3383, 3384, 3385, 3386, 3387, 3388, 3389, 3390, 3391, 3392,
+  3393, 3394, 3395, 3396, 3397, 1518, 3398, 3399, 3400, 3401, 3402, 3403, 3404, 3405, 3406, 3407,
+  3408, 0, 3409, 3410, 3411, 3412, 3413, 3414, 3415, 3416, 3417, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 367, 0, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 365, 372, 367, 0, 0, 0, 0, 573,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 365, 367, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 365, 365, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 365, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 367, 367, 367,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 367, 367, 365, 365, 365, 367, 365, 367, 367, 367,
+  367, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 365, 367, 365, 367, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 3418, 3419, 3420, 3421, 0, 0, 0,
+  0, 0, 0, 0, 0, 3422, 0, 0, 0, 0, 0, 3423, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 572, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 583, 0, 0, 0, 0, 0, 0, 3424, 3425,
+  0, 3426, 3427, 573, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 582, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 573, 582, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 573, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 582, 582, 0, 583, 0,
+  0, 0, 0, 0, 0, 0, 0, 3428, 0, 0, 0, 3429, 3430, 573, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 583, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 365, 365, 365, 365, 365, 365, 365, 0, 0, 0,
+  365, 365, 365, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 573, 0, 0, 0, 582, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  583, 0, 0, 0, 0, 0, 0, 0, 0, 3431, 583, 3432, 3433, 583, 3434, 0,
+  0, 0, 573, 582, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 583,
+  0, 0, 0, 0, 0, 0, 0, 0, 3435, 3436, 3437, 3438, 0, 0, 0, 573,
+  582, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 573, 582, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 582, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  583, 0, 0, 0, 0, 3439, 0, 0, 3440, 0, 0, 0, 0, 573, 573, 0,
+  0, 0, 0, 582, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 582, 0, 573, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 573, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 573, 573, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  372, 372, 372, 372, 372, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  365, 365, 365, 365, 365, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3441, 3441, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 372, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3442, 3443,
+  3444, 3445, 3446, 3447, 3448, 640, 640, 372, 372, 372, 0, 0, 0, 3449, 640, 640,
+  640, 640, 640, 0, 0, 0, 0, 0, 0, 0, 0, 367, 367, 367, 367, 367,
+  367, 367, 367, 0, 0, 365, 365, 365, 365, 365, 367, 367, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 365, 365, 365, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3450, 3451, 3452, 3453, 3454,
+  3455, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 365, 365, 365, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702, 704,
+  1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 56, 712, 738, 713, 714, 741,
+  718, 344, 735, 346, 719, 360, 720, 1282, 64, 725, 1518, 347, 361, 726, 727, 730,
+  351, 362, 352, 768, 688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699,
+  700, 701, 702, 704, 1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 56, 712,
+  738, 713, 714, 741, 718, 0, 735, 346, 719, 360, 720, 1282, 64, 725, 1518, 347,
+  361, 726, 727, 730, 351, 362, 352, 768, 688, 690, 1286, 691, 692, 1302, 694, 695,
+  696, 697, 698, 699, 700, 701, 702, 704, 1294, 705, 1516, 706, 707, 1330, 708, 1335,
+  1517, 1298, 56, 712, 738, 713, 714, 741, 718, 344, 735, 346, 719, 360, 720, 1282,
+  64, 725, 1518, 347, 361, 726, 727, 730, 351, 362, 352, 768, 688, 0, 1286, 691,
+  0, 0, 694, 0, 0, 697, 698, 0, 0, 701, 702, 704, 1294, 0, 1516, 706,
+  707, 1330, 708, 1335, 1517, 1298, 56, 712, 738, 713, 0, 741, 0, 344, 735, 346,
+  719, 360, 720, 1282, 0, 725, 1518, 347, 361, 726, 727, 730, 351, 362, 352, 768,
+  688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702, 704,
+  1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 56, 712, 738, 713, 714, 741,
+  718, 344, 735, 346, 719, 360, 720, 1282, 64, 725, 1518, 347, 361, 726, 727, 730,
+  351, 362, 352, 768, 688, 690, 0, 691, 692, 1302, 694, 0, 0, 697, 698, 699,
+  700, 701, 702, 704, 1294, 0, 1516, 706, 707, 1330, 708, 1335, 1517, 0, 56, 712,
+  738, 713, 714, 741, 718, 344, 735, 346, 719, 360, 720, 1282, 64, 725, 1518, 347,
+  361, 726, 727, 730, 351, 362, 352, 768, 688, 690, 0, 691, 692, 1302, 694, 0,
+  696, 697, 698, 699, 700, 0, 702, 0, 0, 0, 1516, 706, 707, 1330, 708, 1335,
+  1517, 0, 56, 712, 738, 713, 714, 741, 718, 344, 735, 346, 719, 360, 720, 1282,
+  64, 725, 1518, 347, 361, 726, 727, 730, 351, 362, 352, 768, 688, 690, 1286, 691,
+  692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702, 704, 1294, 705, 1516, 706,
+  707, 1330, 708, 1335, 1517, 1298, 56, 712, 738, 713, 714, 741, 718, 344, 735, 346,
+  719, 360, 720, 1282, 64, 725, 1518, 347, 361, 726, 727, 730, 351, 362, 352, 768,
+  688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702, 704,
+  1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 56, 712, 738, 713, 714, 741,
+  718, 344, 735, 346, 719, 360, 720, 1282, 64, 725, 1518, 347, 361, 726, 727, 730,
+  351, 362, 352, 768, 688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699,
+  700, 701, 702, 704, 1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 56, 712,
+  738, 713, 714, 741, 718, 344, 735, 346, 719, 360, 720, 1282, 64, 725, 1518, 347,
+  361, 726, 727, 730, 351, 362, 352, 768, 688, 690, 1286, 691, 692, 1302, 694, 695,
+  696, 697, 698, 699, 700, 701, 702, 704, 1294, 705, 1516, 706, 707, 1330, 708, 1335,
+  1517, 1298, 56, 712, 738, 713, 714, 741, 718, 344, 735, 346, 719, 360, 720, 1282,
+  64, 725, 1518, 347, 361, 726, 727, 730, 351, 362, 352, 768, 688, 690, 1286, 691,
+  692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702, 704, 1294, 705, 1516, 706,
+  707, 1330, 708, 1335, 1517, 1298, 56, 712, 738, 713, 714, 741, 718, 344, 735, 346,
+  719, 360, 720, 1282, 64, 725, 1518, 347, 361, 726, 727, 730, 351, 362, 352, 768,
+  688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702, 704,
+  1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 56, 712, 738, 713, 714, 741,
+  718, 344, 735, 346, 719, 360, 720, 1282, 64, 725, 1518, 347, 361, 726, 727, 730,
+  351, 362, 352, 768, 3456, 3457, 0, 0, 3458, 3459, 1308, 3460, 3461, 3462, 3463, 432,
+  3464, 3465, 3466, 3467, 3468, 3469, 3470, 1309, 3471, 432, 434, 3472, 3473, 3474, 3475, 3476,
+  3477, 3478, 3479, 422, 732, 733, 433, 3480, 3481, 423, 3482, 429, 3483, 61, 3484, 3485,
+  3486, 428, 430, 431, 3487, 3488, 3489, 427, 734, 3490, 3491, 3492, 433, 423, 429, 427,
+  430, 428, 3458, 3459, 1308, 3460, 3461, 3462, 3463, 432, 3464, 3465, 3466, 3467, 3468, 3469,
+  3470, 1309, 3471, 432, 434, 3472, 3473, 3474, 3475, 3476, 3477, 3478, 3479, 422, 732, 733,
+  433, 3480, 3481, 423, 3482, 429, 3483, 61, 3484, 3485, 3486, 428, 430, 431, 3487, 3488,
+  3489, 427, 734, 3490, 3491, 3492, 433, 423, 429, 427, 430, 428, 3458, 3459, 1308, 3460,
+  3461, 3462, 3463, 432, 3464, 3465, 3466, 3467, 3468, 3469, 3470, 1309, 3471, 432, 434, 3472,
+  3473, 3474, 3475, 3476, 3477, 3478, 3479, 422, 732, 733, 433, 3480, 3481, 423, 3482, 429,
+  3483, 61, 3484, 3485, 3486, 428, 430, 431, 3487, 3488, 3489, 427, 734, 3490, 3491, 3492,
+  433, 423, 429, 427, 430, 428, 3458, 3459, 1308, 3460, 3461, 3462, 3463, 432, 3464, 3465,
+  3466, 3467, 3468, 3469, 3470, 1309, 3471, 432, 434, 3472, 3473, 3474, 3475, 3476, 3477, 3478,
+  3479, 422, 732, 733, 433, 3480, 3481, 423, 3482, 429, 3483, 61, 3484, 3485, 3486, 428,
+  430, 431, 3487, 3488, 3489, 427, 734, 3490, 3491, 3492, 433, 423, 429, 427, 430, 428,
+  3458, 3459, 1308, 3460, 3461, 3462, 3463, 432, 3464, 3465, 3466, 3467, 3468, 3469, 3470, 1309,
+  3471, 432, 434, 3472, 3473, 3474, 3475, 3476, 3477, 3478, 3479, 422, 732, 733, 433, 3480,
+  3481, 423, 3482, 429, 3483, 61, 3484, 3485, 3486, 428, 430, 431, 3487, 3488, 3489, 427,
+  734, 3490, 3491, 3492, 433, 423, 429, 427, 430, 428, 3493, 3494, 0, 0, 1270, 63,
+  58, 59, 1271, 1272, 1273, 1274, 1275, 1276, 1270, 63, 58, 59, 1271, 1272, 1273, 1274,
+  1275, 1276, 1270, 63, 58, 59, 1271, 1272, 1273, 1274, 1275, 1276, 1270, 63, 58, 59,
+  1271, 1272, 1273, 1274, 1275, 1276, 1270, 63, 58, 59, 1271, 1272, 1273, 1274, 1275, 1276,
+  365, 365, 365, 365, 365, 365, 365, 0, 365, 365, 365, 365, 365, 365, 365, 365,
+  365, 365, 365, 365, 365, 365, 365, 365, 365, 0, 0, 365, 365, 365, 365, 365,
+  365, 365, 0, 365, 365, 0, 365, 365, 365, 365, 365, 0, 0, 0, 0, 0,
+  3495, 3496, 3497, 3498, 3499, 3500, 3501, 3502, 3503, 3504, 3505, 3506, 3507, 3508, 3509, 3510,
+  3511, 3512, 3513, 3514, 3515, 3516, 3517, 3518, 3519, 3520, 3521, 3522, 3523, 3524, 3525, 3526,
+  3527, 3495, 3496, 3497, 3498, 3499, 3500, 3501, 3502, 3503, 3504, 3505, 3507, 3508, 3510, 3512,
+  3513, 3514, 3515, 3516, 3517, 2430, 3518, 3528, 3523, 3529, 3530, 3531, 3532, 3533, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 365, 365, 365, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 366, 366, 367, 365,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  367, 367, 367, 367, 367, 367, 367, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 365, 365, 365, 365, 365, 365, 582, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3295, 3296, 3300, 3303, 0, 3322, 3306, 3301, 3311, 3323, 3317, 3318, 3319, 3320, 3307, 3313,
+  3315, 3309, 3316, 3305, 3308, 3298, 3299, 3302, 3304, 3310, 3312, 3314, 3534, 2943, 3535, 3536,
+  0, 3296, 3300, 0, 3321, 0, 0, 3301, 0, 3323, 3317, 3318, 3319, 3320, 3307, 3313,
+  3315, 3309, 3316, 0, 3308, 3298, 3299, 3302, 0, 3310, 0, 3314, 0, 0, 0, 0,
+  0, 0, 3300, 0, 0, 0, 0, 3301, 0, 3323, 0, 3318, 0, 3320, 3307, 3313,
+  0, 3309, 3316, 0, 3308, 0, 0, 3302, 0, 3310, 0, 3314, 0, 2943, 0, 3536,
+  0, 3296, 3300, 0, 3321, 0, 0, 3301, 3311, 3323, 3317, 0, 3319, 3320, 3307, 3313,
+  3315, 3309, 3316, 0, 3308, 3298, 3299, 3302, 0, 3310, 3312, 3314, 3534, 0, 3535, 0,
+  3295, 3296, 3300, 3303, 3321, 3322, 3306, 3301, 3311, 3323, 0, 3318, 3319, 3320, 3307, 3313,
+  3315, 3309, 3316, 3305, 3308, 3298, 3299, 3302, 3304, 3310, 3312, 3314, 0, 0, 0, 0,
+  0, 3296, 3300, 3303, 0, 3322, 3306, 3301, 3311, 3323, 0, 3318, 3319, 3320, 3307, 3313,
+  3315, 3309, 3316, 3305, 3308, 3298, 3299, 3302, 3304, 3310, 3312, 3314, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3537, 3538, 3539, 3540, 3541, 3542, 3543, 3544, 3545, 3546, 3547, 0, 0, 0, 0, 0,
+  3548, 3549, 3550, 3551, 3552, 3553, 3554, 3555, 3556, 3557, 3558, 3559, 3560, 3561, 3562, 3563,
+  3564, 3565, 3566, 3567, 3568, 3569, 3570, 3571, 3572, 3573, 3574, 1286, 705, 3575, 3576, 0,
+  688, 690, 1286, 691, 692, 1302, 694, 695, 696, 697, 698, 699, 700, 701, 702, 704,
+  1294, 705, 1516, 706, 707, 1330, 708, 1335, 1517, 1298, 3577, 2359, 3578, 3579, 3580, 3581,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3582, 3583, 3584, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3585, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3586, 3587, 2136, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1590, 3588, 3589, 3590, 1533, 3591, 3592, 1958, 3593, 3594, 3595, 3596, 3597, 3598, 3599, 3600,
+  3601, 3602, 1626, 3603, 3604, 3605, 3606, 3607, 3608, 1527, 1950, 3609, 2085, 1953, 2086, 3610,
+  1682, 3611, 3612, 3613, 3614, 3615, 2068, 1600, 3616, 3617, 3618, 3619, 0, 0, 0, 0,
+  3620, 3621, 3622, 3623, 3624, 3625, 3626, 3627, 3628, 0, 0, 0, 0, 0, 0, 0,
+  3629, 3630, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1270, 63, 58, 59, 1271, 1272, 1273, 1274, 1275, 1276, 0, 0, 0, 0, 0, 0,
+  3631, 3632, 3633, 3634, 3635, 2727, 3636, 3637, 3638, 3639, 2728, 3640, 3641, 3642, 2729, 3643,
+  3644, 3645, 3646, 3647, 3648, 3649, 3650, 3651, 3652, 3653, 3654, 2787, 3655, 3656, 3657, 3658,
+  3659, 3660, 3661, 3662, 3663, 2792, 2730, 2731, 2793, 3664, 3665, 2538, 3666, 2732, 3667, 3668,
+  3669, 3670, 3670, 3670, 3671, 3672, 3673, 3674, 3675, 3676, 3677, 3678, 3679, 3680, 3681, 3682,
+  3683, 3684, 3685, 3686, 3687, 3688, 3688, 2795, 3689, 3690, 3691, 3692, 2734, 3693, 3694, 3695,
+  2691, 3696, 3697, 3698, 3699, 3700, 3701, 3702, 3703, 3704, 3705, 3706, 3707, 3708, 3709, 3710,
+  3711, 3712, 3713, 3714, 3715, 3716, 3717, 3718, 3719, 3720, 3721, 3721, 3722, 3723, 3724, 2534,
+  3725, 3726, 3727, 3728, 3729, 3730, 3731, 3732, 2739, 3733, 3734, 3735, 3736, 3737, 3738, 3739,
+  3740, 3741, 3742, 3743, 3744, 3745, 3746, 3747, 3748, 3749, 3750, 3751, 3752, 3753, 2480, 3754,
+  3755, 3756, 3756, 3757, 3758, 3758, 3759, 3760, 3761, 3762, 3763, 3764, 3765, 3766, 3767, 3768,
+  3769, 3770, 3771, 2740, 3772, 3773, 3774, 3775, 2807, 3775, 3776, 2742, 3777, 3778, 3779, 3780,
+  2743, 2453, 3781, 3782, 3783, 3784, 3785, 3786, 3787, 3788, 3789, 3790, 3791, 3792, 3793, 3794,
+  3795, 3796, 3797, 3798, 3799, 3800, 3801, 3802, 2744, 3803, 3804, 3805, 3806, 3807, 3808, 2746,
+  3809, 3810, 3811, 3812, 3813, 3814, 3815, 3816, 2481, 2815, 3817, 3818, 3819, 3820, 3821, 3822,
+  3823, 3824, 2747, 3825, 3826, 3827, 3828, 2858, 3829, 3830, 3831, 3832, 3833, 3834, 3835, 3836,
+  3837, 3838, 3839, 3840, 3841, 2551, 3842, 3843, 3844, 3845, 3846, 3847, 3848, 3849, 3850, 3851,
+  3852, 2748, 2638, 3853, 3854, 3855, 3856, 3857, 3858, 3859, 3860, 2819, 3861, 3862, 3863, 3864,
+  3865, 3866, 3867, 3868, 2820, 3869, 3870, 3871, 3872, 3873, 3874, 3875, 3876, 3877, 3878, 3879,
+  3880, 2822, 3881, 3882, 3883, 3884, 3885, 3886, 3887, 3888, 3889, 3890, 3891, 3891, 3892, 3893,
+  2824, 3894, 3895, 3896, 3897, 3898, 3899, 3900, 2537, 3901, 3902, 3903, 3904, 3905, 3906, 3907,
+  2830, 3908, 3909, 3910, 3911, 3912, 3913, 3913, 2831, 2860, 3914, 3915, 3916, 3917, 3918, 2499,
+  2833, 3919, 3920, 2759, 3921, 3922, 2713, 3923, 3924, 2763, 3925, 3926, 3927, 3928, 3928, 3929,
+  3930, 3931, 3932, 3933, 3934, 3935, 3936, 3937, 3938, 3939, 3940, 3941, 3942, 3943, 3944, 3945,
+  3946, 3947, 3948, 3949, 3950, 3951, 3952, 3953, 3954, 3955, 2769, 3956, 3957, 3958, 3959, 3960,
+  3961, 3962, 3963, 3964, 3965, 3966, 3967, 3968, 3969, 3970, 3971, 3757, 3972, 3973, 3974, 3975,
+  3976, 3977, 3978, 3979, 3980, 3981, 3982, 3983, 2555, 3984, 3985, 3986, 3987, 3988, 3989, 2772,
+  3990, 3991, 3992, 3993, 3994, 3995, 3996, 3997, 3998, 3999, 4000, 4001, 4002, 4003, 4004, 4005,
+  4006, 4007, 4008, 4009, 2494, 4010, 4011, 4012, 4013, 4014, 4015, 2840, 4016, 4017, 4018, 4019,
+  4020, 4021, 4022, 4023, 4024, 4025, 4026, 4027, 4028, 4029, 4030, 4031, 4032, 4033, 4034, 4035,
+  2845, 2846, 4036, 4037, 4038, 4039, 4040, 4041, 4042, 4043, 4044, 4045, 4046, 4047, 4048, 2847,
+  4049, 4050, 4051, 4052, 4053, 4054, 4055, 4056, 4057, 4058, 4059, 4060, 4061, 4062, 4063, 4064,
+  4065, 4066, 4067, 4068, 4069, 4070, 4071, 4072, 4073, 4074, 4075, 4076, 4077, 4078, 2853, 2853,
+  4079, 4080, 4081, 4082, 4083, 4084, 4085, 4086, 4087, 4088, 2854, 4089, 4090, 4091, 4092, 4093,
+  4094, 4095, 4096, 4097, 4098, 4099, 4100, 4101, 4102, 4103, 4104, 4105, 4106, 4107, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+const _EUnicodeTable _unicode_normalization_table = { _unicode_normalization_table_stage1, 1525, _unicode_normalization_table_stage2 };
+
+const _EUnicodeNormalizationRecord _unicode_normalization_records[] = {
+  { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 1 }, { 0, 0, 0, 0, 4 }, { 0, 0, 0, 0, 7 }, { 0, 0, 0, 0, 10 }, { 0, 0, 0, 0, 43 },
+  { 0, 0, 0, 0, 50 }, { 0, 0, 0, 0, 61 }, { 0, 0, 0, 0, 74 }, { 0, 0, 0, 0, 109 }, { 0, 0, 0, 0, 112 }, { 0, 0, 0, 0, 127 },
+  { 0, 0, 0, 0, 142 }, { 0, 0, 0, 0, 173 }, { 0, 0, 0, 0, 176 }, { 0, 0, 0, 0, 187 }, { 0, 0, 0, 0, 200 }, { 0, 0, 0, 0, 207 },
+  { 0, 0, 0, 0, 226 }, { 0, 0, 0, 0, 259 }, { 0, 0, 0, 0, 264 }, { 0, 0, 0, 0, 281 }, { 0, 0, 0, 0, 296 }, { 0, 0, 0, 0, 311 },
+  { 0, 0, 0, 0, 350 }, { 0, 0, 0, 0, 355 }, { 0, 0, 0, 0, 368 }, { 0, 0, 0, 0, 373 }, { 0, 0, 0, 0, 392 }, { 0, 0, 0, 0, 405 },
+  { 0, 0, 0, 0, 438 }, { 0, 0, 0, 0, 445 }, { 0, 0, 0, 0, 456 }, { 0, 0, 0, 0, 469 }, { 0, 0, 0, 0, 504 }, { 0, 0, 0, 0, 507 },
+  { 0, 0, 0, 0, 522 }, { 0, 0, 0, 0, 539 }, { 0, 0, 0, 0, 568 }, { 0, 0, 0, 0, 573 }, { 0, 0, 0, 0, 584 }, { 0, 0, 0, 0, 597 },
+  { 0, 0, 0, 0, 604 }, { 0, 0, 0, 0, 623 }, { 0, 0, 0, 0, 656 }, { 0, 0, 0, 0, 661 }, { 0, 0, 0, 0, 678 }, { 0, 0, 0, 0, 693 },
+  { 0, 0, 0, 0, 710 }, { 0, 0, 0, 0, 749 }, { 0, 0, 0, 0, 754 }, { 0, 0, 0, 0, 769 }, { 0, 0, 0, 0, 774 }, { 0, 0, 0, 0, 795 },
+  { 0, 24, 0, 1, 0 }, { 0, 24, 0, 3, 808 }, { 0, 24, 0, 6, 0 }, { 0, 24, 0, 8, 0 }, { 0, 24, 0, 11, 0 }, { 0, 24, 0, 13, 0 },
+  { 0, 24, 0, 15, 0 }, { 0, 24, 0, 18, 0 }, { 0, 24, 0, 20, 0 }, { 0, 24, 0, 23, 0 }, { 0, 24, 0, 25, 0 }, { 0, 24, 0, 27, 0 },
+  { 0, 24, 0, 31, 0 }, { 0, 24, 0, 35, 0 }, { 0, 9, 39, 39, 0 }, { 0, 9, 42, 42, 0 }, { 0, 9, 45, 45, 815 }, { 0, 9, 48, 48, 0 },
+  { 0, 9, 51, 51, 824 }, { 0, 9, 54, 54, 827 }, { 0, 0, 0, 0, 830 }, { 0, 9, 57, 57, 835 }, { 0, 9, 60, 60, 0 }, { 0, 9, 63, 63, 0 },
+  { 0, 9, 66, 66, 838 }, { 0, 9, 69, 69, 0 }, { 0, 9, 72, 72, 0 }, { 0, 9, 75, 75, 0 }, { 0, 9, 78, 78, 0 }, { 0, 9, 81, 81, 847 },
+  { 0, 9, 84, 84, 0 }, { 0, 9, 87, 87, 0 }, { 0, 9, 90, 90, 0 }, { 0, 9, 93, 93, 850 }, { 0, 9, 96, 96, 859 }, { 0, 9, 99, 99, 866 },
+  { 0, 0, 0, 0, 869 }, { 0, 9, 102, 102, 0 }, { 0, 9, 105, 105, 0 }, { 0, 9, 108, 108, 0 }, { 0, 9, 111, 111, 872 }, { 0, 9, 114, 114, 0 },
+  { 0, 9, 117, 117, 0 }, { 0, 9, 120, 120, 0 }, { 0, 9, 123, 123, 881 }, { 0, 9, 126, 126, 0 }, { 0, 9, 129, 129, 890 }, { 0, 9, 132, 132, 893 },
+  { 0, 0, 0, 0, 896 }, { 0, 9, 135, 135, 901 }, { 0, 9, 138, 138, 0 }, { 0, 9, 141, 141, 0 }, { 0, 9, 144, 144, 904 }, { 0, 9, 147, 147, 0 },
+  { 0, 9, 150, 150, 0 }, { 0, 9, 153, 153, 0 }, { 0, 9, 156, 156, 0 }, { 0, 9, 159, 159, 913 }, { 0, 9, 162, 162, 0 }, { 0, 9, 165, 165, 0 },
+  { 0, 9, 168, 168, 0 }, { 0, 9, 171, 171, 916 }, { 0, 9, 174, 174, 925 }, { 0, 9, 177, 177, 932 }, { 0, 0, 0, 0, 935 }, { 0, 9, 180, 180, 0 },
+  { 0, 9, 183, 183, 0 }, { 0, 9, 186, 186, 0 }, { 0, 9, 189, 189, 938 }, { 0, 9, 192, 192, 0 }, { 0, 9, 195, 195, 0 }, { 0, 9, 198, 198, 0 },
+  { 0, 9, 201, 201, 0 }, { 0, 9, 204, 204, 947 }, { 0, 9, 207, 207, 956 }, { 0, 9, 210, 210, 0 }, { 0, 9, 213, 213, 0 }, { 0, 9, 216, 216, 0 },
+  { 0, 9, 219, 219, 0 }, { 0, 9, 222, 222, 0 }, { 0, 9, 225, 225, 0 }, { 0, 9, 228, 228, 0 }, { 0, 9, 231, 231, 0 }, { 0, 9, 234, 234, 0 },
+  { 0, 9, 237, 237, 0 }, { 0, 9, 240, 240, 0 }, { 0, 9, 243, 243, 0 }, { 0, 9, 246, 246, 965 }, { 0, 9, 249, 249, 970 }, { 0, 9, 252, 252, 0 },
+  { 0, 9, 255, 255, 0 }, { 0, 9, 258, 258, 0 }, { 0, 9, 261, 261, 0 }, { 0, 9, 264, 264, 0 }, { 0, 9, 267, 267, 0 }, { 0, 9, 270, 270, 0 },
+  { 0, 9, 273, 273, 0 }, { 0, 9, 276, 276, 0 }, { 0, 9, 279, 279, 0 }, { 0, 9, 282, 282, 0 }, { 0, 9, 285, 285, 0 }, { 0, 9, 288, 288, 0 },
+  { 0, 9, 291, 291, 0 }, { 0, 9, 294, 294, 0 }, { 0, 9, 297, 297, 0 }, { 0, 9, 300, 300, 0 }, { 0, 9, 303, 303, 0 }, { 0, 9, 306, 306, 0 },
+  { 0, 9, 309, 309, 0 }, { 0, 9, 312, 312, 0 }, { 0, 9, 315, 315, 0 }, { 0, 9, 318, 318, 0 }, { 0, 9, 321, 321, 0 }, { 0, 9, 324, 324, 0 },
+  { 0, 9, 327, 327, 0 }, { 0, 9, 330, 330, 0 }, { 0, 24, 0, 333, 0 }, { 0, 24, 0, 336, 0 }, { 0, 9, 339, 339, 0 }, { 0, 9, 342, 342, 0 },
+  { 0, 9, 345, 345, 0 }, { 0, 9, 348, 348, 0 }, { 0, 9, 351, 351, 0 }, { 0, 9, 354, 354, 0 }, { 0, 9, 357, 357, 0 }, { 0, 9, 360, 360, 0 },
+  { 0, 9, 363, 363, 0 }, { 0, 9, 366, 366, 0 }, { 0, 24, 0, 369, 0 }, { 0, 24, 0, 372, 0 }, { 0, 9, 375, 375, 0 }, { 0, 9, 378, 378, 0 },
+  { 0, 9, 381, 381, 0 }, { 0, 9, 384, 384, 0 }, { 0, 9, 387, 387, 0 }, { 0, 9, 390, 390, 0 }, { 0, 24, 0, 393, 0 }, { 0, 9, 396, 396, 975 },
+  { 0, 9, 399, 399, 980 }, { 0, 9, 402, 402, 0 }, { 0, 9, 405, 405, 0 }, { 0, 9, 408, 408, 0 }, { 0, 9, 411, 411, 0 }, { 0, 9, 414, 414, 0 },
+  { 0, 9, 417, 417, 0 }, { 0, 9, 420, 420, 0 }, { 0, 9, 423, 423, 0 }, { 0, 9, 426, 426, 0 }, { 0, 9, 429, 429, 0 }, { 0, 9, 432, 432, 985 },
+  { 0, 9, 435, 435, 988 }, { 0, 9, 438, 438, 0 }, { 0, 9, 441, 441, 0 }, { 0, 9, 444, 444, 0 }, { 0, 9, 447, 447, 0 }, { 0, 9, 450, 450, 991 },
+  { 0, 9, 453, 453, 994 }, { 0, 9, 456, 456, 0 }, { 0, 9, 459, 459, 0 }, { 0, 9, 462, 462, 0 }, { 0, 9, 465, 465, 0 }, { 0, 9, 468, 468, 997 },
+  { 0, 9, 471, 471, 1000 }, { 0, 9, 474, 474, 1003 }, { 0, 9, 477, 477, 1006 }, { 0, 9, 480, 480, 0 }, { 0, 9, 483, 483, 0 }, { 0, 9, 486, 486, 0 },
+  { 0, 9, 489, 489, 0 }, { 0, 9, 492, 492, 0 }, { 0, 9, 495, 495, 0 }, { 0, 9, 498, 498, 0 }, { 0, 9, 501, 501, 0 }, { 0, 9, 504, 504, 0 },
+  { 0, 9, 507, 507, 0 }, { 0, 9, 510, 510, 0 }, { 0, 9, 513, 513, 0 }, { 0, 9, 516, 516, 0 }, { 0, 9, 519, 519, 0 }, { 0, 9, 522, 522, 0 },
+  { 0, 9, 525, 525, 0 }, { 0, 9, 528, 528, 0 }, { 0, 9, 531, 531, 0 }, { 0, 9, 534, 534, 0 }, { 0, 24, 0, 537, 1009 }, { 0, 9, 539, 539, 1012 },
+  { 0, 9, 542, 542, 1023 }, { 0, 9, 545, 545, 1034 }, { 0, 9, 548, 548, 1045 }, { 0, 0, 0, 0, 1056 }, { 0, 24, 0, 551, 0 }, { 0, 24, 0, 555, 0 },
+  { 0, 24, 0, 559, 0 }, { 0, 24, 0, 563, 0 }, { 0, 24, 0, 566, 0 }, { 0, 24, 0, 569, 0 }, { 0, 24, 0, 572, 0 }, { 0, 24, 0, 575, 0 },
+  { 0, 24, 0, 578, 0 }, { 0, 9, 581, 581, 0 }, { 0, 9, 584, 584, 0 }, { 0, 9, 587, 587, 0 }, { 0, 9, 590, 590, 0 }, { 0, 9, 593, 593, 0 },
+  { 0, 9, 596, 596, 0 }, { 0, 9, 599, 599, 0 }, { 0, 9, 602, 602, 0 }, { 0, 9, 605, 605, 0 }, { 0, 9, 609, 609, 0 }, { 0, 9, 613, 613, 0 },
+  { 0, 9, 617, 617, 0 }, { 0, 9, 621, 621, 0 }, { 0, 9, 625, 625, 0 }, { 0, 9, 629, 629, 0 }, { 0, 9, 633, 633, 0 }, { 0, 9, 637, 637, 0 },
+  { 0, 9, 641, 641, 0 }, { 0, 9, 645, 645, 0 }, { 0, 9, 649, 649, 0 }, { 0, 9, 653, 653, 0 }, { 0, 9, 656, 656, 0 }, { 0, 9, 659, 659, 0 },
+  { 0, 9, 662, 662, 0 }, { 0, 9, 665, 665, 0 }, { 0, 9, 668, 668, 0 }, { 0, 9, 671, 671, 1059 }, { 0, 9, 674, 674, 1062 }, { 0, 9, 677, 677, 0 },
+  { 0, 9, 681, 681, 0 }, { 0, 9, 685, 685, 0 }, { 0, 9, 688, 688, 0 }, { 0, 9, 691, 691, 0 }, { 0, 24, 0, 694, 0 }, { 0, 24, 0, 697, 0 },
+  { 0, 24, 0, 700, 0 }, { 0, 9, 703, 703, 0 }, { 0, 9, 706, 706, 0 }, { 0, 9, 709, 709, 0 }, { 0, 9, 712, 712, 0 }, { 0, 9, 715, 715, 0 },
+  { 0, 9, 719, 719, 0 }, { 0, 9, 723, 723, 0 }, { 0, 9, 726, 726, 0 }, { 0, 9, 729, 729, 0 }, { 0, 9, 732, 732, 0 }, { 0, 9, 735, 735, 0 },
+  { 0, 9, 738, 738, 0 }, { 0, 9, 741, 741, 0 }, { 0, 9, 744, 744, 0 }, { 0, 9, 747, 747, 0 }, { 0, 9, 750, 750, 0 }, { 0, 9, 753, 753, 0 },
+  { 0, 9, 756, 756, 0 }, { 0, 9, 759, 759, 0 }, { 0, 9, 762, 762, 0 }, { 0, 9, 765, 765, 0 }, { 0, 9, 768, 768, 0 }, { 0, 9, 771, 771, 0 },
+  { 0, 9, 774, 774, 0 }, { 0, 9, 777, 777, 0 }, { 0, 9, 780, 780, 0 }, { 0, 9, 783, 783, 0 }, { 0, 9, 786, 786, 0 }, { 0, 9, 789, 789, 0 },
+  { 0, 9, 792, 792, 0 }, { 0, 9, 795, 795, 0 }, { 0, 9, 798, 798, 0 }, { 0, 9, 801, 801, 0 }, { 0, 9, 804, 804, 0 }, { 0, 9, 807, 807, 0 },
+  { 0, 9, 810, 810, 0 }, { 0, 9, 813, 813, 0 }, { 0, 9, 816, 816, 0 }, { 0, 9, 819, 819, 0 }, { 0, 9, 822, 822, 0 }, { 0, 9, 825, 825, 1065 },
+  { 0, 9, 828, 828, 1068 }, { 0, 9, 831, 831, 1071 }, { 0, 9, 834, 834, 1074 }, { 0, 9, 837, 837, 0 }, { 0, 9, 841, 841, 0 }, { 0, 9, 845, 845, 0 },
+  { 0, 9, 849, 849, 0 }, { 0, 9, 853, 853, 1077 }, { 0, 9, 856, 856, 1080 }, { 0, 9, 859, 859, 0 }, { 0, 9, 863, 863, 0 }, { 0, 9, 867, 867, 0 },
+  { 0, 9, 870, 870, 0 }, { 0, 0, 0, 0, 1083 }, { 0, 24, 0, 873, 0 }, { 0, 24, 0, 875, 0 }, { 0, 24, 0, 877, 0 }, { 0, 24, 0, 879, 0 },
+  { 0, 24, 0, 881, 0 }, { 0, 24, 0, 883, 0 }, { 0, 24, 0, 885, 0 }, { 0, 24, 0, 887, 0 }, { 0, 24, 0, 889, 0 }, { 0, 24, 0, 891, 0 },
+  { 0, 24, 0, 894, 0 }, { 0, 24, 0, 897, 0 }, { 0, 24, 0, 900, 0 }, { 0, 24, 0, 903, 0 }, { 0, 24, 0, 906, 0 }, { 0, 24, 0, 909, 0 },
+  { 0, 24, 0, 911, 0 }, { 0, 24, 0, 537, 0 }, { 0, 24, 0, 913, 0 }, { 0, 24, 0, 915, 0 }, { 230, 36, 0, 0, 0 }, { 230, 0, 0, 0, 0 },
+  { 232, 0, 0, 0, 0 }, { 220, 0, 0, 0, 0 }, { 216, 36, 0, 0, 0 }, { 202, 0, 0, 0, 0 }, { 220, 36, 0, 0, 0 }, { 202, 36, 0, 0, 0 },
+  { 1, 0, 0, 0, 0 }, { 1, 36, 0, 0, 0 }, { 230, 27, 917, 917, 0 }, { 230, 27, 919, 919, 0 }, { 230, 27, 921, 921, 0 }, { 230, 27, 923, 923, 0 },
+  { 240, 36, 0, 0, 0 }, { 233, 0, 0, 0, 0 }, { 234, 0, 0, 0, 0 }, { 0, 27, 926, 926, 0 }, { 0, 24, 0, 928, 0 }, { 0, 27, 931, 931, 0 },
+  { 0, 25, 933, 936, 0 }, { 0, 9, 940, 940, 0 }, { 0, 27, 943, 943, 0 }, { 0, 9, 945, 945, 0 }, { 0, 9, 948, 948, 0 }, { 0, 9, 951, 951, 0 },
+  { 0, 9, 954, 954, 0 }, { 0, 9, 957, 957, 0 }, { 0, 9, 960, 960, 0 }, { 0, 9, 963, 963, 0 }, { 0, 0, 0, 0, 1086 }, { 0, 0, 0, 0, 1101 },
+  { 0, 0, 0, 0, 1110 }, { 0, 0, 0, 0, 1121 }, { 0, 0, 0, 0, 1136 }, { 0, 0, 0, 0, 1145 }, { 0, 0, 0, 0, 1148 }, { 0, 0, 0, 0, 1161 },
+  { 0, 9, 967, 967, 0 }, { 0, 9, 970, 970, 0 }, { 0, 9, 973, 973, 1172 }, { 0, 9, 976, 976, 0 }, { 0, 9, 979, 979, 1175 }, { 0, 9, 982, 982, 0 },
+  { 0, 9, 985, 985, 0 }, { 0, 0, 0, 0, 1178 }, { 0, 0, 0, 0, 1195 }, { 0, 0, 0, 0, 1204 }, { 0, 0, 0, 0, 1217 }, { 0, 0, 0, 0, 1234 },
+  { 0, 0, 0, 0, 1243 }, { 0, 0, 0, 0, 1248 }, { 0, 0, 0, 0, 1265 }, { 0, 9, 989, 989, 1278 }, { 0, 9, 992, 992, 1285 }, { 0, 9, 995, 995, 0 },
+  { 0, 9, 998, 998, 0 }, { 0, 9, 1001, 1001, 1292 }, { 0, 24, 0, 1004, 0 }, { 0, 24, 0, 1006, 0 }, { 0, 24, 0, 1008, 1295 }, { 0, 25, 1010, 957, 0 },
+  { 0, 25, 1013, 970, 0 }, { 0, 24, 0, 1016, 0 }, { 0, 24, 0, 1018, 0 }, { 0, 24, 0, 1020, 0 }, { 0, 24, 0, 1022, 0 }, { 0, 24, 0, 1024, 0 },
+  { 0, 24, 0, 1026, 0 }, { 0, 24, 0, 1028, 0 }, { 0, 24, 0, 1030, 0 }, { 0, 9, 1032, 1032, 0 }, { 0, 9, 1035, 1035, 0 }, { 0, 9, 1038, 1038, 0 },
+  { 0, 0, 0, 0, 1300 }, { 0, 9, 1041, 1041, 0 }, { 0, 9, 1044, 1044, 0 }, { 0, 9, 1047, 1047, 0 }, { 0, 9, 1050, 1050, 0 }, { 0, 0, 0, 0, 1303 },
+  { 0, 0, 0, 0, 1308 }, { 0, 0, 0, 0, 1311 }, { 0, 0, 0, 0, 1318 }, { 0, 0, 0, 0, 1323 }, { 0, 0, 0, 0, 1326 }, { 0, 9, 1053, 1053, 0 },
+  { 0, 0, 0, 0, 1335 }, { 0, 0, 0, 0, 1338 }, { 0, 0, 0, 0, 1341 }, { 0, 0, 0, 0, 1350 }, { 0, 0, 0, 0, 1353 }, { 0, 0, 0, 0, 1356 },
+  { 0, 0, 0, 0, 1359 }, { 0, 0, 0, 0, 1364 }, { 0, 0, 0, 0, 1367 }, { 0, 0, 0, 0, 1374 }, { 0, 0, 0, 0, 1379 }, { 0, 0, 0, 0, 1382 },
+  { 0, 9, 1056, 1056, 0 }, { 0, 0, 0, 0, 1391 }, { 0, 0, 0, 0, 1394 }, { 0, 0, 0, 0, 1397 }, { 0, 0, 0, 0, 1406 }, { 0, 0, 0, 0, 1409 },
+  { 0, 0, 0, 0, 1412 }, { 0, 9, 1059, 1059, 0 }, { 0, 9, 1062, 1062, 0 }, { 0, 9, 1065, 1065, 0 }, { 0, 0, 0, 0, 1415 }, { 0, 9, 1068, 1068, 0 },
+  { 0, 9, 1071, 1071, 0 }, { 0, 9, 1074, 1074, 0 }, { 0, 9, 1077, 1077, 0 }, { 0, 0, 0, 0, 1418 }, { 0, 0, 0, 0, 1421 }, { 0, 9, 1080, 1080, 0 },
+  { 0, 9, 1083, 1083, 0 }, { 0, 9, 1086, 1086, 0 }, { 0, 9, 1089, 1089, 0 }, { 0, 9, 1092, 1092, 0 }, { 0, 9, 1095, 1095, 0 }, { 0, 9, 1098, 1098, 0 },
+  { 0, 9, 1101, 1101, 0 }, { 0, 9, 1104, 1104, 0 }, { 0, 9, 1107, 1107, 0 }, { 0, 0, 0, 0, 1424 }, { 0, 0, 0, 0, 1427 }, { 0, 9, 1110, 1110, 0 },
+  { 0, 9, 1113, 1113, 0 }, { 0, 9, 1116, 1116, 0 }, { 0, 9, 1119, 1119, 0 }, { 0, 9, 1122, 1122, 0 }, { 0, 9, 1125, 1125, 0 }, { 0, 9, 1128, 1128, 0 },
+  { 0, 9, 1131, 1131, 0 }, { 0, 9, 1134, 1134, 0 }, { 0, 9, 1137, 1137, 0 }, { 0, 9, 1140, 1140, 0 }, { 0, 9, 1143, 1143, 0 }, { 0, 0, 0, 0, 1430 },
+  { 0, 0, 0, 0, 1433 }, { 0, 9, 1146, 1146, 0 }, { 0, 9, 1149, 1149, 0 }, { 0, 9, 1152, 1152, 0 }, { 0, 9, 1155, 1155, 0 }, { 0, 9, 1158, 1158, 0 },
+  { 0, 9, 1161, 1161, 0 }, { 0, 9, 1164, 1164, 0 }, { 0, 9, 1167, 1167, 0 }, { 0, 9, 1170, 1170, 0 }, { 0, 9, 1173, 1173, 0 }, { 0, 9, 1176, 1176, 0 },
+  { 0, 9, 1179, 1179, 0 }, { 0, 9, 1182, 1182, 0 }, { 0, 9, 1185, 1185, 0 }, { 0, 24, 0, 1188, 0 }, { 222, 0, 0, 0, 0 }, { 228, 0, 0, 0, 0 },
+  { 10, 0, 0, 0, 0 }, { 11, 0, 0, 0, 0 }, { 12, 0, 0, 0, 0 }, { 13, 0, 0, 0, 0 }, { 14, 0, 0, 0, 0 }, { 15, 0, 0, 0, 0 },
+  { 16, 0, 0, 0, 0 }, { 17, 0, 0, 0, 0 }, { 18, 0, 0, 0, 0 }, { 19, 0, 0, 0, 0 }, { 20, 0, 0, 0, 0 }, { 21, 0, 0, 0, 0 },
+  { 22, 0, 0, 0, 0 }, { 23, 0, 0, 0, 0 }, { 24, 0, 0, 0, 0 }, { 25, 0, 0, 0, 0 }, { 30, 0, 0, 0, 0 }, { 31, 0, 0, 0, 0 },
+  { 32, 0, 0, 0, 0 }, { 0, 9, 1191, 1191, 0 }, { 0, 9, 1194, 1194, 0 }, { 0, 9, 1197, 1197, 0 }, { 0, 9, 1200, 1200, 0 }, { 0, 9, 1203, 1203, 0 },
+  { 0, 0, 0, 0, 1436 }, { 0, 0, 0, 0, 1443 }, { 0, 0, 0, 0, 1446 }, { 27, 0, 0, 0, 0 }, { 28, 0, 0, 0, 0 }, { 29, 0, 0, 0, 0 },
+  { 33, 0, 0, 0, 0 }, { 34, 0, 0, 0, 0 }, { 35, 0, 0, 0, 0 }, { 0, 24, 0, 1206, 0 }, { 0, 24, 0, 1209, 0 }, { 0, 24, 0, 1212, 0 },
+  { 0, 24, 0, 1215, 0 }, { 0, 9, 1218, 1218, 0 }, { 0, 0, 0, 0, 1449 }, { 0, 9, 1221, 1221, 0 }, { 0, 0, 0, 0, 1452 }, { 0, 9, 1224, 1224, 0 },
+  { 0, 0, 0, 0, 1455 }, { 36, 0, 0, 0, 0 }, { 0, 0, 0, 0, 1458 }, { 0, 9, 1227, 1227, 0 }, { 0, 0, 0, 0, 1461 }, { 0, 9, 1230, 1230, 0 },
+  { 0, 0, 0, 0, 1464 }, { 0, 9, 1233, 1233, 0 }, { 7, 36, 0, 0, 0 }, { 9, 0, 0, 0, 0 }, { 0, 27, 1236, 1236, 0 }, { 0, 27, 1239, 1239, 0 },
+  { 0, 27, 1242, 1242, 0 }, { 0, 27, 1245, 1245, 0 }, { 0, 27, 1248, 1248, 0 }, { 0, 27, 1251, 1251, 0 }, { 0, 27, 1254, 1254, 0 }, { 0, 27, 1257, 1257, 0 },
+  { 7, 0, 0, 0, 0 }, { 0, 36, 0, 0, 0 }, { 0, 0, 0, 0, 1467 }, { 0, 9, 1260, 1260, 0 }, { 0, 9, 1263, 1263, 0 }, { 0, 27, 1266, 1266, 0 },
+  { 0, 27, 1269, 1269, 0 }, { 0, 27, 1272, 1272, 0 }, { 0, 27, 1275, 1275, 0 }, { 0, 27, 1278, 1278, 0 }, { 0, 27, 1281, 1281, 0 }, { 0, 27, 1284, 1284, 0 },
+  { 0, 27, 1287, 1287, 0 }, { 0, 27, 1290, 1290, 0 }, { 0, 0, 0, 0, 1472 }, { 0, 9, 1293, 1293, 0 }, { 0, 9, 1296, 1296, 0 }, { 0, 9, 1299, 1299, 0 },
+  { 0, 27, 1302, 1302, 0 }, { 0, 27, 1305, 1305, 0 }, { 0, 0, 0, 0, 1479 }, { 0, 9, 1308, 1308, 0 }, { 0, 0, 0, 0, 1482 }, { 0, 0, 0, 0, 1487 },
+  { 0, 9, 1311, 1311, 0 }, { 0, 9, 1314, 1314, 0 }, { 0, 9, 1317, 1317, 0 }, { 0, 0, 0, 0, 1490 }, { 0, 9, 1320, 1320, 0 }, { 84, 0, 0, 0, 0 },
+  { 91, 36, 0, 0, 0 }, { 0, 0, 0, 0, 1493 }, { 0, 9, 1323, 1323, 0 }, { 0, 0, 0, 0, 1496 }, { 0, 9, 1326, 1326, 0 }, { 0, 9, 1329, 1329, 0 },
+  { 0, 9, 1332, 1332, 1503 }, { 0, 9, 1335, 1335, 0 }, { 0, 0, 0, 0, 1506 }, { 0, 0, 0, 0, 1511 }, { 0, 9, 1339, 1339, 0 }, { 0, 9, 1342, 1342, 0 },
+  { 0, 9, 1345, 1345, 0 }, { 9, 36, 0, 0, 0 }, { 0, 0, 0, 0, 1514 }, { 0, 9, 1348, 1348, 0 }, { 0, 9, 1351, 1351, 1521 }, { 0, 9, 1354, 1354, 0 },
+  { 0, 9, 1358, 1358, 0 }, { 0, 24, 0, 1361, 0 }, { 103, 0, 0, 0, 0 }, { 107, 0, 0, 0, 0 }, { 0, 24, 0, 1364, 0 }, { 118, 0, 0, 0, 0 },
+  { 122, 0, 0, 0, 0 }, { 0, 24, 0, 1367, 0 }, { 0, 24, 0, 1370, 0 }, { 0, 24, 0, 1373, 0 }, { 216, 0, 0, 0, 0 }, { 0, 27, 1375, 1375, 0 },
+  { 0, 27, 1378, 1378, 0 }, { 0, 27, 1381, 1381, 0 }, { 0, 27, 1384, 1384, 0 }, { 0, 27, 1387, 1387, 0 }, { 0, 27, 1390, 1390, 0 }, { 129, 0, 0, 0, 0 },
+  { 130, 0, 0, 0, 0 }, { 0, 27, 1393, 1393, 0 }, { 132, 0, 0, 0, 0 }, { 0, 27, 1396, 1396, 0 }, { 0, 27, 1399, 1399, 0 }, { 0, 24, 0, 1402, 0 },
+  { 0, 27, 1406, 1406, 0 }, { 0, 24, 0, 1409, 0 }, { 0, 27, 1413, 1413, 0 }, { 0, 27, 1416, 1416, 0 }, { 0, 27, 1419, 1419, 0 }, { 0, 27, 1422, 1422, 0 },
+  { 0, 27, 1425, 1425, 0 }, { 0, 27, 1428, 1428, 0 }, { 0, 27, 1431, 1431, 0 }, { 0, 0, 0, 0, 1524 }, { 0, 9, 1434, 1434, 0 }, { 0, 24, 0, 1437, 0 },
+  { 0, 0, 0, 0, 1527 }, { 0, 9, 1439, 1439, 0 }, { 0, 0, 0, 0, 1530 }, { 0, 9, 1442, 1442, 0 }, { 0, 0, 0, 0, 1533 }, { 0, 9, 1445, 1445, 0 },
+  { 0, 0, 0, 0, 1536 }, { 0, 9, 1448, 1448, 0 }, { 0, 0, 0, 0, 1539 }, { 0, 9, 1451, 1451, 0 }, { 0, 0, 0, 0, 1542 }, { 0, 9, 1454, 1454, 0 },
+  { 0, 0, 0, 0, 1545 }, { 0, 9, 1457, 1457, 0 }, { 0, 0, 0, 0, 1548 }, { 0, 9, 1460, 1460, 0 }, { 0, 0, 0, 0, 1551 }, { 0, 0, 0, 0, 1554 },
+  { 0, 9, 1463, 1463, 0 }, { 0, 9, 1466, 1466, 0 }, { 0, 0, 0, 0, 1557 }, { 0, 9, 1469, 1469, 0 }, { 0, 24, 0, 1472, 0 }, { 0, 24, 0, 1474, 0 },
+  { 0, 24, 0, 1476, 0 }, { 0, 24, 0, 1478, 0 }, { 0, 24, 0, 1480, 0 }, { 0, 24, 0, 1482, 0 }, { 0, 24, 0, 1484, 0 }, { 0, 24, 0, 1486, 0 },
+  { 0, 24, 0, 1488, 0 }, { 0, 24, 0, 1490, 0 }, { 0, 24, 0, 1492, 0 }, { 0, 24, 0, 1494, 0 }, { 0, 24, 0, 1496, 0 }, { 0, 24, 0, 1498, 0 },
+  { 0, 24, 0, 1500, 0 }, { 0, 24, 0, 1502, 0 }, { 0, 24, 0, 1504, 0 }, { 0, 24, 0, 1506, 0 }, { 0, 24, 0, 1508, 0 }, { 0, 24, 0, 1510, 0 },
+  { 0, 24, 0, 1512, 0 }, { 0, 24, 0, 1514, 0 }, { 0, 24, 0, 1516, 0 }, { 0, 24, 0, 1518, 0 }, { 0, 24, 0, 1520, 0 }, { 0, 24, 0, 1522, 0 },
+  { 0, 24, 0, 1524, 0 }, { 0, 24, 0, 1526, 0 }, { 0, 24, 0, 1528, 0 }, { 0, 24, 0, 1530, 0 }, { 0, 24, 0, 1532, 0 }, { 0, 24, 0, 1534, 0 },
+  { 0, 24, 0, 1536, 0 }, { 0, 24, 0, 1538, 0 }, { 0, 24, 0, 1540, 0 }, { 0, 24, 0, 1542, 0 }, { 0, 24, 0, 1544, 0 }, { 0, 24, 0, 1546, 0 },
+  { 0, 24, 0, 1548, 0 }, { 0, 24, 0, 1550, 0 }, { 0, 24, 0, 1552, 0 }, { 0, 24, 0, 1554, 0 }, { 0, 24, 0, 1556, 0 }, { 0, 24, 0, 1558, 0 },
+  { 0, 24, 0, 1560, 0 }, { 0, 24, 0, 1562, 0 }, { 0, 24, 0, 1564, 0 }, { 0, 24, 0, 1566, 0 }, { 0, 24, 0, 1568, 0 }, { 0, 24, 0, 1570, 0 },
+  { 0, 24, 0, 1572, 0 }, { 0, 24, 0, 1574, 0 }, { 0, 24, 0, 1576, 0 }, { 0, 24, 0, 1578, 0 }, { 0, 24, 0, 1580, 0 }, { 0, 24, 0, 1582, 0 },
+  { 0, 24, 0, 1584, 0 }, { 0, 24, 0, 1586, 0 }, { 0, 24, 0, 1588, 0 }, { 0, 24, 0, 1590, 0 }, { 0, 24, 0, 1592, 0 }, { 0, 24, 0, 1594, 0 },
+  { 0, 24, 0, 1596, 0 }, { 0, 24, 0, 1598, 0 }, { 0, 24, 0, 1600, 0 }, { 0, 24, 0, 1602, 0 }, { 0, 24, 0, 1604, 0 }, { 0, 24, 0, 1606, 0 },
+  { 0, 24, 0, 1608, 0 }, { 0, 24, 0, 1610, 0 }, { 0, 24, 0, 1612, 0 }, { 0, 24, 0, 1614, 0 }, { 0, 24, 0, 1616, 0 }, { 0, 24, 0, 1618, 0 },
+  { 0, 24, 0, 1620, 0 }, { 0, 24, 0, 1622, 0 }, { 0, 24, 0, 1624, 0 }, { 0, 24, 0, 1626, 0 }, { 0, 24, 0, 1628, 0 }, { 0, 24, 0, 1630, 0 },
+  { 0, 24, 0, 1632, 0 }, { 0, 24, 0, 1634, 0 }, { 0, 24, 0, 1636, 0 }, { 0, 24, 0, 1638, 0 }, { 214, 0, 0, 0, 0 }, { 218, 0, 0, 0, 0 },
+  { 0, 9, 1640, 1640, 0 }, { 0, 9, 1643, 1643, 0 }, { 0, 9, 1646, 1646, 0 }, { 0, 9, 1649, 1649, 0 }, { 0, 9, 1652, 1652, 0 }, { 0, 9, 1655, 1655, 0 },
+  { 0, 9, 1658, 1658, 0 }, { 0, 9, 1661, 1661, 0 }, { 0, 9, 1664, 1664, 0 }, { 0, 9, 1668, 1668, 0 }, { 0, 9, 1672, 1672, 0 }, { 0, 9, 1675, 1675, 0 },
+  { 0, 9, 1678, 1678, 0 }, { 0, 9, 1681, 1681, 0 }, { 0, 9, 1684, 1684, 0 }, { 0, 9, 1687, 1687, 0 }, { 0, 9, 1690, 1690, 0 }, { 0, 9, 1693, 1693, 0 },
+  { 0, 9, 1696, 1696, 0 }, { 0, 9, 1699, 1699, 0 }, { 0, 9, 1702, 1702, 0 }, { 0, 9, 1706, 1706, 0 }, { 0, 9, 1710, 1710, 0 }, { 0, 9, 1714, 1714, 0 },
+  { 0, 9, 1718, 1718, 0 }, { 0, 9, 1721, 1721, 0 }, { 0, 9, 1724, 1724, 0 }, { 0, 9, 1727, 1727, 0 }, { 0, 9, 1730, 1730, 0 }, { 0, 9, 1734, 1734, 0 },
+  { 0, 9, 1738, 1738, 0 }, { 0, 9, 1741, 1741, 0 }, { 0, 9, 1744, 1744, 0 }, { 0, 9, 1747, 1747, 0 }, { 0, 9, 1750, 1750, 0 }, { 0, 9, 1753, 1753, 0 },
+  { 0, 9, 1756, 1756, 0 }, { 0, 9, 1759, 1759, 0 }, { 0, 9, 1762, 1762, 0 }, { 0, 9, 1765, 1765, 0 }, { 0, 9, 1768, 1768, 0 }, { 0, 9, 1771, 1771, 0 },
+  { 0, 9, 1774, 1774, 0 }, { 0, 9, 1777, 1777, 0 }, { 0, 9, 1780, 1780, 0 }, { 0, 9, 1783, 1783, 0 }, { 0, 9, 1786, 1786, 0 }, { 0, 9, 1790, 1790, 0 },
+  { 0, 9, 1794, 1794, 0 }, { 0, 9, 1797, 1797, 0 }, { 0, 9, 1800, 1800, 0 }, { 0, 9, 1803, 1803, 0 }, { 0, 9, 1806, 1806, 0 }, { 0, 9, 1809, 1809, 0 },
+  { 0, 9, 1812, 1812, 1560 }, { 0, 9, 1815, 1815, 1563 }, { 0, 9, 1818, 1818, 0 }, { 0, 9, 1822, 1822, 0 }, { 0, 9, 1826, 1826, 0 }, { 0, 9, 1829, 1829, 0 },
+  { 0, 9, 1832, 1832, 0 }, { 0, 9, 1835, 1835, 0 }, { 0, 9, 1838, 1838, 0 }, { 0, 9, 1841, 1841, 0 }, { 0, 9, 1844, 1844, 0 }, { 0, 9, 1847, 1847, 0 },
+  { 0, 9, 1850, 1850, 0 }, { 0, 9, 1853, 1853, 0 }, { 0, 9, 1856, 1856, 0 }, { 0, 9, 1859, 1859, 0 }, { 0, 9, 1862, 1862, 0 }, { 0, 9, 1865, 1865, 0 },
+  { 0, 9, 1868, 1868, 0 }, { 0, 9, 1871, 1871, 0 }, { 0, 9, 1874, 1874, 0 }, { 0, 9, 1877, 1877, 0 }, { 0, 9, 1880, 1880, 0 }, { 0, 9, 1884, 1884, 0 },
+  { 0, 9, 1888, 1888, 0 }, { 0, 9, 1892, 1892, 0 }, { 0, 9, 1896, 1896, 0 }, { 0, 9, 1900, 1900, 0 }, { 0, 9, 1904, 1904, 0 }, { 0, 9, 1908, 1908, 0 },
+  { 0, 9, 1912, 1912, 0 }, { 0, 9, 1915, 1915, 0 }, { 0, 9, 1918, 1918, 0 }, { 0, 9, 1921, 1921, 0 }, { 0, 9, 1924, 1924, 0 }, { 0, 9, 1927, 1927, 0 },
+  { 0, 9, 1930, 1930, 1566 }, { 0, 9, 1933, 1933, 1569 }, { 0, 9, 1936, 1936, 0 }, { 0, 9, 1940, 1940, 0 }, { 0, 9, 1944, 1944, 0 }, { 0, 9, 1947, 1947, 0 },
+  { 0, 9, 1950, 1950, 0 }, { 0, 9, 1953, 1953, 0 }, { 0, 9, 1956, 1956, 1572 }, { 0, 9, 1959, 1959, 1575 }, { 0, 9, 1962, 1962, 0 }, { 0, 9, 1966, 1966, 0 },
+  { 0, 9, 1970, 1970, 0 }, { 0, 9, 1974, 1974, 0 }, { 0, 9, 1978, 1978, 0 }, { 0, 9, 1982, 1982, 0 }, { 0, 9, 1986, 1986, 0 }, { 0, 9, 1989, 1989, 0 },
+  { 0, 9, 1992, 1992, 0 }, { 0, 9, 1995, 1995, 0 }, { 0, 9, 1998, 1998, 0 }, { 0, 9, 2001, 2001, 0 }, { 0, 9, 2004, 2004, 0 }, { 0, 9, 2007, 2007, 0 },
+  { 0, 9, 2010, 2010, 0 }, { 0, 9, 2013, 2013, 0 }, { 0, 9, 2016, 2016, 0 }, { 0, 9, 2019, 2019, 0 }, { 0, 9, 2022, 2022, 0 }, { 0, 9, 2025, 2025, 0 },
+  { 0, 9, 2028, 2028, 0 }, { 0, 9, 2032, 2032, 0 }, { 0, 9, 2036, 2036, 0 }, { 0, 9, 2040, 2040, 0 }, { 0, 9, 2044, 2044, 0 }, { 0, 9, 2047, 2047, 0 },
+  { 0, 9, 2050, 2050, 0 }, { 0, 9, 2053, 2053, 0 }, { 0, 9, 2056, 2056, 0 }, { 0, 9, 2059, 2059, 0 }, { 0, 9, 2062, 2062, 0 }, { 0, 9, 2065, 2065, 0 },
+  { 0, 9, 2068, 2068, 0 }, { 0, 9, 2071, 2071, 0 }, { 0, 9, 2074, 2074, 0 }, { 0, 9, 2077, 2077, 0 }, { 0, 9, 2080, 2080, 0 }, { 0, 9, 2083, 2083, 0 },
+  { 0, 9, 2086, 2086, 0 }, { 0, 9, 2089, 2089, 0 }, { 0, 9, 2092, 2092, 0 }, { 0, 9, 2095, 2095, 0 }, { 0, 9, 2098, 2098, 0 }, { 0, 9, 2101, 2101, 0 },
+  { 0, 9, 2104, 2104, 0 }, { 0, 9, 2107, 2107, 0 }, { 0, 9, 2110, 2110, 0 }, { 0, 9, 2113, 2113, 0 }, { 0, 9, 2116, 2116, 0 }, { 0, 9, 2119, 2119, 0 },
+  { 0, 9, 2122, 2122, 0 }, { 0, 9, 2125, 2125, 0 }, { 0, 9, 2128, 2128, 0 }, { 0, 9, 2131, 2131, 0 }, { 0, 24, 0, 2134, 0 }, { 0, 25, 2137, 1953, 0 },
+  { 0, 9, 2140, 2140, 1578 }, { 0, 9, 2143, 2143, 1583 }, { 0, 9, 2146, 2146, 0 }, { 0, 9, 2149, 2149, 0 }, { 0, 9, 2152, 2152, 0 }, { 0, 9, 2156, 2156, 0 },
+  { 0, 9, 2160, 2160, 0 }, { 0, 9, 2164, 2164, 0 }, { 0, 9, 2168, 2168, 0 }, { 0, 9, 2172, 2172, 0 }, { 0, 9, 2176, 2176, 0 }, { 0, 9, 2180, 2180, 0 },
+  { 0, 9, 2184, 2184, 0 }, { 0, 9, 2188, 2188, 0 }, { 0, 9, 2192, 2192, 0 }, { 0, 9, 2196, 2196, 0 }, { 0, 9, 2200, 2200, 0 }, { 0, 9, 2204, 2204, 0 },
+  { 0, 9, 2208, 2208, 0 }, { 0, 9, 2212, 2212, 0 }, { 0, 9, 2216, 2216, 0 }, { 0, 9, 2220, 2220, 0 }, { 0, 9, 2224, 2224, 0 }, { 0, 9, 2228, 2228, 0 },
+  { 0, 9, 2232, 2232, 1588 }, { 0, 9, 2235, 2235, 1591 }, { 0, 9, 2238, 2238, 0 }, { 0, 9, 2241, 2241, 0 }, { 0, 9, 2244, 2244, 0 }, { 0, 9, 2247, 2247, 0 },
+  { 0, 9, 2250, 2250, 0 }, { 0, 9, 2254, 2254, 0 }, { 0, 9, 2258, 2258, 0 }, { 0, 9, 2262, 2262, 0 }, { 0, 9, 2266, 2266, 0 }, { 0, 9, 2270, 2270, 0 },
+  { 0, 9, 2274, 2274, 0 }, { 0, 9, 2278, 2278, 0 }, { 0, 9, 2282, 2282, 0 }, { 0, 9, 2286, 2286, 0 }, { 0, 9, 2290, 2290, 0 }, { 0, 9, 2293, 2293, 0 },
+  { 0, 9, 2296, 2296, 0 }, { 0, 9, 2299, 2299, 0 }, { 0, 9, 2302, 2302, 1594 }, { 0, 9, 2305, 2305, 1597 }, { 0, 9, 2308, 2308, 0 }, { 0, 9, 2311, 2311, 0 },
+  { 0, 9, 2314, 2314, 0 }, { 0, 9, 2318, 2318, 0 }, { 0, 9, 2322, 2322, 0 }, { 0, 9, 2326, 2326, 0 }, { 0, 9, 2330, 2330, 0 }, { 0, 9, 2334, 2334, 0 },
+  { 0, 9, 2338, 2338, 0 }, { 0, 9, 2342, 2342, 0 }, { 0, 9, 2346, 2346, 0 }, { 0, 9, 2350, 2350, 0 }, { 0, 9, 2354, 2354, 0 }, { 0, 9, 2358, 2358, 0 },
+  { 0, 9, 2362, 2362, 0 }, { 0, 9, 2366, 2366, 0 }, { 0, 9, 2370, 2370, 0 }, { 0, 9, 2374, 2374, 0 }, { 0, 9, 2378, 2378, 0 }, { 0, 9, 2382, 2382, 0 },
+  { 0, 9, 2386, 2386, 0 }, { 0, 9, 2390, 2390, 0 }, { 0, 9, 2394, 2394, 0 }, { 0, 9, 2397, 2397, 0 }, { 0, 9, 2400, 2400, 0 }, { 0, 9, 2403, 2403, 0 },
+  { 0, 9, 2406, 2406, 0 }, { 0, 9, 2410, 2410, 0 }, { 0, 9, 2414, 2414, 0 }, { 0, 9, 2418, 2418, 0 }, { 0, 9, 2422, 2422, 0 }, { 0, 9, 2426, 2426, 0 },
+  { 0, 9, 2430, 2430, 0 }, { 0, 9, 2434, 2434, 0 }, { 0, 9, 2438, 2438, 0 }, { 0, 9, 2442, 2442, 0 }, { 0, 9, 2446, 2446, 0 }, { 0, 9, 2449, 2449, 0 },
+  { 0, 9, 2452, 2452, 0 }, { 0, 9, 2455, 2455, 0 }, { 0, 9, 2458, 2458, 0 }, { 0, 9, 2461, 2461, 0 }, { 0, 9, 2464, 2464, 0 }, { 0, 9, 2467, 2467, 0 },
+  { 0, 9, 2470, 2470, 1600 }, { 0, 9, 2473, 2473, 1609 }, { 0, 9, 2476, 2476, 1618 }, { 0, 9, 2480, 2480, 1621 }, { 0, 9, 2484, 2484, 1624 }, { 0, 9, 2488, 2488, 1627 },
+  { 0, 9, 2492, 2492, 1630 }, { 0, 9, 2496, 2496, 1633 }, { 0, 9, 2500, 2500, 1636 }, { 0, 9, 2503, 2503, 1645 }, { 0, 9, 2506, 2506, 1654 }, { 0, 9, 2510, 2510, 1657 },
+  { 0, 9, 2514, 2514, 1660 }, { 0, 9, 2518, 2518, 1663 }, { 0, 9, 2522, 2522, 1666 }, { 0, 9, 2526, 2526, 1669 }, { 0, 9, 2530, 2530, 1672 }, { 0, 9, 2533, 2533, 1677 },
+  { 0, 9, 2536, 2536, 0 }, { 0, 9, 2540, 2540, 0 }, { 0, 9, 2544, 2544, 0 }, { 0, 9, 2548, 2548, 0 }, { 0, 9, 2552, 2552, 1682 }, { 0, 9, 2555, 2555, 1687 },
+  { 0, 9, 2558, 2558, 0 }, { 0, 9, 2562, 2562, 0 }, { 0, 9, 2566, 2566, 0 }, { 0, 9, 2570, 2570, 0 }, { 0, 9, 2574, 2574, 1692 }, { 0, 9, 2577, 2577, 1701 },
+  { 0, 9, 2580, 2580, 1710 }, { 0, 9, 2584, 2584, 1713 }, { 0, 9, 2588, 2588, 1716 }, { 0, 9, 2592, 2592, 1719 }, { 0, 9, 2596, 2596, 1722 }, { 0, 9, 2600, 2600, 1725 },
+  { 0, 9, 2604, 2604, 1728 }, { 0, 9, 2607, 2607, 1737 }, { 0, 9, 2610, 2610, 1746 }, { 0, 9, 2614, 2614, 1749 }, { 0, 9, 2618, 2618, 1752 }, { 0, 9, 2622, 2622, 1755 },
+  { 0, 9, 2626, 2626, 1758 }, { 0, 9, 2630, 2630, 1761 }, { 0, 9, 2634, 2634, 1764 }, { 0, 9, 2637, 2637, 1771 }, { 0, 9, 2640, 2640, 0 }, { 0, 9, 2644, 2644, 0 },
+  { 0, 9, 2648, 2648, 0 }, { 0, 9, 2652, 2652, 0 }, { 0, 9, 2656, 2656, 0 }, { 0, 9, 2660, 2660, 0 }, { 0, 9, 2664, 2664, 1778 }, { 0, 9, 2667, 2667, 1785 },
+  { 0, 9, 2670, 2670, 0 }, { 0, 9, 2674, 2674, 0 }, { 0, 9, 2678, 2678, 0 }, { 0, 9, 2682, 2682, 0 }, { 0, 9, 2686, 2686, 0 }, { 0, 9, 2690, 2690, 0 },
+  { 0, 9, 2694, 2694, 1792 }, { 0, 9, 2697, 2697, 1797 }, { 0, 9, 2700, 2700, 0 }, { 0, 9, 2704, 2704, 0 }, { 0, 9, 2708, 2708, 0 }, { 0, 9, 2712, 2712, 0 },
+  { 0, 9, 2716, 2716, 1802 }, { 0, 9, 2719, 2719, 1807 }, { 0, 9, 2722, 2722, 0 }, { 0, 9, 2726, 2726, 0 }, { 0, 9, 2730, 2730, 0 }, { 0, 9, 2734, 2734, 0 },
+  { 0, 9, 2738, 2738, 1812 }, { 0, 9, 2741, 2741, 1819 }, { 0, 9, 2744, 2744, 0 }, { 0, 9, 2748, 2748, 0 }, { 0, 9, 2752, 2752, 0 }, { 0, 9, 2756, 2756, 0 },
+  { 0, 9, 2760, 2760, 0 }, { 0, 9, 2764, 2764, 0 }, { 0, 9, 2768, 2768, 1826 }, { 0, 9, 2771, 2771, 0 }, { 0, 9, 2775, 2775, 0 }, { 0, 9, 2779, 2779, 0 },
+  { 0, 9, 2783, 2783, 1833 }, { 0, 9, 2786, 2786, 1842 }, { 0, 9, 2789, 2789, 1851 }, { 0, 9, 2793, 2793, 1854 }, { 0, 9, 2797, 2797, 1857 }, { 0, 9, 2801, 2801, 1860 },
+  { 0, 9, 2805, 2805, 1863 }, { 0, 9, 2809, 2809, 1866 }, { 0, 9, 2813, 2813, 1869 }, { 0, 9, 2816, 2816, 1878 }, { 0, 9, 2819, 2819, 1887 }, { 0, 9, 2823, 2823, 1890 },
+  { 0, 9, 2827, 2827, 1893 }, { 0, 9, 2831, 2831, 1896 }, { 0, 9, 2835, 2835, 1899 }, { 0, 9, 2839, 2839, 1902 }, { 0, 9, 2843, 2843, 1905 }, { 0, 27, 973, 973, 0 },
+  { 0, 9, 2846, 2846, 0 }, { 0, 27, 976, 976, 0 }, { 0, 9, 2849, 2849, 1908 }, { 0, 27, 979, 979, 0 }, { 0, 9, 2852, 2852, 0 }, { 0, 27, 982, 982, 0 },
+  { 0, 9, 2855, 2855, 0 }, { 0, 27, 995, 995, 0 }, { 0, 9, 2858, 2858, 0 }, { 0, 27, 998, 998, 0 }, { 0, 9, 2861, 2861, 1911 }, { 0, 27, 1001, 1001, 0 },
+  { 0, 9, 2864, 2864, 0 }, { 0, 9, 2868, 2868, 0 }, { 0, 9, 2872, 2872, 0 }, { 0, 9, 2877, 2877, 0 }, { 0, 9, 2882, 2882, 0 }, { 0, 9, 2887, 2887, 0 },
+  { 0, 9, 2892, 2892, 0 }, { 0, 9, 2897, 2897, 0 }, { 0, 9, 2902, 2902, 0 }, { 0, 9, 2906, 2906, 0 }, { 0, 9, 2910, 2910, 0 }, { 0, 9, 2915, 2915, 0 },
+  { 0, 9, 2920, 2920, 0 }, { 0, 9, 2925, 2925, 0 }, { 0, 9, 2930, 2930, 0 }, { 0, 9, 2935, 2935, 0 }, { 0, 9, 2940, 2940, 0 }, { 0, 9, 2944, 2944, 0 },
+  { 0, 9, 2948, 2948, 0 }, { 0, 9, 2953, 2953, 0 }, { 0, 9, 2958, 2958, 0 }, { 0, 9, 2963, 2963, 0 }, { 0, 9, 2968, 2968, 0 }, { 0, 9, 2973, 2973, 0 },
+  { 0, 9, 2978, 2978, 0 }, { 0, 9, 2982, 2982, 0 }, { 0, 9, 2986, 2986, 0 }, { 0, 9, 2991, 2991, 0 }, { 0, 9, 2996, 2996, 0 }, { 0, 9, 3001, 3001, 0 },
+  { 0, 9, 3006, 3006, 0 }, { 0, 9, 3011, 3011, 0 }, { 0, 9, 3016, 3016, 0 }, { 0, 9, 3020, 3020, 0 }, { 0, 9, 3024, 3024, 0 }, { 0, 9, 3029, 3029, 0 },
+  { 0, 9, 3034, 3034, 0 }, { 0, 9, 3039, 3039, 0 }, { 0, 9, 3044, 3044, 0 }, { 0, 9, 3049, 3049, 0 }, { 0, 9, 3054, 3054, 0 }, { 0, 9, 3058, 3058, 0 },
+  { 0, 9, 3062, 3062, 0 }, { 0, 9, 3067, 3067, 0 }, { 0, 9, 3072, 3072, 0 }, { 0, 9, 3077, 3077, 0 }, { 0, 9, 3082, 3082, 0 }, { 0, 9, 3087, 3087, 0 },
+  { 0, 9, 3092, 3092, 0 }, { 0, 9, 3095, 3095, 0 }, { 0, 9, 3098, 3098, 0 }, { 0, 9, 3102, 3102, 0 }, { 0, 9, 3105, 3105, 0 }, { 0, 9, 3109, 3109, 1914 },
+  { 0, 9, 3112, 3112, 0 }, { 0, 9, 3116, 3116, 0 }, { 0, 9, 3119, 3119, 0 }, { 0, 9, 3122, 3122, 0 }, { 0, 27, 940, 940, 0 }, { 0, 9, 3125, 3125, 0 },
+  { 0, 24, 0, 3128, 0 }, { 0, 27, 3131, 3131, 0 }, { 0, 24, 0, 3128, 1917 }, { 0, 24, 0, 3133, 0 }, { 0, 25, 3136, 3139, 0 }, { 0, 9, 3143, 3143, 0 },
+  { 0, 9, 3147, 3147, 0 }, { 0, 9, 3150, 3150, 0 }, { 0, 9, 3154, 3154, 1924 }, { 0, 9, 3157, 3157, 0 }, { 0, 9, 3161, 3161, 0 }, { 0, 27, 945, 945, 0 },
+  { 0, 9, 3164, 3164, 0 }, { 0, 27, 948, 948, 0 }, { 0, 9, 3167, 3167, 0 }, { 0, 25, 3170, 3173, 0 }, { 0, 25, 3177, 3180, 0 }, { 0, 25, 3184, 3187, 0 },
+  { 0, 9, 3191, 3191, 0 }, { 0, 9, 3194, 3194, 0 }, { 0, 9, 3197, 3197, 0 }, { 0, 27, 963, 963, 0 }, { 0, 9, 3201, 3201, 0 }, { 0, 9, 3204, 3204, 0 },
+  { 0, 9, 3208, 3208, 0 }, { 0, 9, 3211, 3211, 0 }, { 0, 9, 3214, 3214, 0 }, { 0, 27, 951, 951, 0 }, { 0, 25, 3217, 3220, 0 }, { 0, 25, 3224, 3227, 0 },
+  { 0, 25, 3231, 3234, 0 }, { 0, 9, 3238, 3238, 0 }, { 0, 9, 3241, 3241, 0 }, { 0, 9, 3244, 3244, 0 }, { 0, 27, 985, 985, 0 }, { 0, 9, 3248, 3248, 0 },
+  { 0, 9, 3251, 3251, 0 }, { 0, 9, 3254, 3254, 0 }, { 0, 9, 3257, 3257, 0 }, { 0, 9, 3261, 3261, 0 }, { 0, 9, 3264, 3264, 0 }, { 0, 9, 3267, 3267, 0 },
+  { 0, 27, 957, 957, 0 }, { 0, 9, 3270, 3270, 0 }, { 0, 25, 3273, 3276, 0 }, { 0, 27, 933, 936, 0 }, { 0, 27, 3280, 3280, 0 }, { 0, 9, 3282, 3282, 0 },
+  { 0, 9, 3286, 3286, 0 }, { 0, 9, 3289, 3289, 0 }, { 0, 9, 3293, 3293, 1927 }, { 0, 9, 3296, 3296, 0 }, { 0, 9, 3300, 3300, 0 }, { 0, 27, 954, 954, 0 },
+  { 0, 9, 3303, 3303, 0 }, { 0, 27, 960, 960, 0 }, { 0, 9, 3306, 3306, 0 }, { 0, 27, 3309, 15, 0 }, { 0, 24, 0, 3311, 1930 }, { 0, 27, 3314, 1, 0 },
+  { 0, 27, 3316, 1, 0 }, { 0, 24, 0, 3318, 0 }, { 0, 24, 0, 3320, 0 }, { 0, 24, 0, 3323, 0 }, { 0, 24, 0, 3325, 0 }, { 0, 24, 0, 3328, 0 },
+  { 0, 24, 0, 3332, 0 }, { 0, 24, 0, 3335, 0 }, { 0, 24, 0, 3339, 0 }, { 0, 24, 0, 3342, 0 }, { 0, 24, 0, 3346, 0 }, { 0, 24, 0, 3349, 0 },
+  { 0, 24, 0, 3352, 0 }, { 0, 24, 0, 3355, 0 }, { 0, 24, 0, 3358, 0 }, { 0, 24, 0, 3361, 0 }, { 0, 24, 0, 3366, 0 }, { 0, 24, 0, 3368, 0 },
+  { 0, 24, 0, 3370, 0 }, { 0, 24, 0, 3372, 0 }, { 0, 24, 0, 3374, 0 }, { 0, 24, 0, 3376, 0 }, { 0, 24, 0, 3378, 0 }, { 0, 24, 0, 3380, 0 },
+  { 0, 24, 0, 3382, 0 }, { 0, 24, 0, 3384, 0 }, { 0, 24, 0, 3386, 0 }, { 0, 24, 0, 3388, 0 }, { 0, 24, 0, 3390, 0 }, { 0, 24, 0, 3392, 0 },
+  { 0, 24, 0, 3395, 0 }, { 0, 24, 0, 3399, 0 }, { 0, 24, 0, 3403, 0 }, { 0, 24, 0, 3405, 0 }, { 0, 24, 0, 3408, 0 }, { 0, 24, 0, 3412, 0 },
+  { 0, 24, 0, 3416, 0 }, { 0, 24, 0, 3418, 0 }, { 0, 24, 0, 3421, 0 }, { 0, 24, 0, 3423, 0 }, { 0, 24, 0, 3426, 0 }, { 0, 24, 0, 3428, 0 },
+  { 0, 24, 0, 3431, 0 }, { 0, 24, 0, 3435, 0 }, { 0, 24, 0, 3438, 0 }, { 0, 27, 3440, 3440, 0 }, { 0, 27, 1492, 1492, 0 }, { 0, 27, 54, 54, 0 },
+  { 0, 24, 0, 3442, 0 }, { 0, 24, 0, 3444, 0 }, { 0, 24, 0, 3446, 0 }, { 0, 24, 0, 3448, 0 }, { 0, 24, 0, 3450, 0 }, { 0, 24, 0, 3452, 0 },
+  { 0, 24, 0, 3456, 0 }, { 0, 24, 0, 3458, 0 }, { 0, 24, 0, 3460, 0 }, { 0, 24, 0, 3462, 0 }, { 0, 24, 0, 3466, 0 }, { 0, 24, 0, 3470, 0 },
+  { 0, 24, 0, 3475, 0 }, { 0, 24, 0, 3479, 0 }, { 0, 24, 0, 3483, 0 }, { 0, 24, 0, 3487, 0 }, { 0, 24, 0, 3491, 0 }, { 0, 24, 0, 3495, 0 },
+  { 0, 24, 0, 3499, 0 }, { 0, 24, 0, 3503, 0 }, { 0, 24, 0, 3507, 0 }, { 0, 24, 0, 3511, 0 }, { 0, 24, 0, 3515, 0 }, { 0, 24, 0, 3519, 0 },
+  { 0, 24, 0, 3523, 0 }, { 0, 24, 0, 3526, 0 }, { 0, 24, 0, 3529, 0 }, { 0, 24, 0, 3533, 0 }, { 0, 24, 0, 3536, 0 }, { 0, 24, 0, 3538, 0 },
+  { 0, 24, 0, 3541, 0 }, { 0, 24, 0, 3545, 0 }, { 0, 24, 0, 3550, 0 }, { 0, 24, 0, 3553, 0 }, { 0, 24, 0, 3555, 0 }, { 0, 24, 0, 3558, 0 },
+  { 0, 24, 0, 3562, 0 }, { 0, 24, 0, 3565, 0 }, { 0, 24, 0, 3569, 0 }, { 0, 24, 0, 3572, 0 }, { 0, 24, 0, 3575, 0 }, { 0, 24, 0, 3579, 0 },
+  { 0, 24, 0, 3584, 0 }, { 0, 24, 0, 3587, 0 }, { 0, 24, 0, 3590, 0 }, { 0, 24, 0, 3594, 0 }, { 0, 0, 0, 0, 1937 }, { 0, 0, 0, 0, 1940 },
+  { 0, 0, 0, 0, 1943 }, { 0, 9, 3598, 3598, 0 }, { 0, 9, 3601, 3601, 0 }, { 0, 9, 3604, 3604, 0 }, { 0, 9, 3607, 3607, 0 }, { 0, 9, 3610, 3610, 0 },
+  { 0, 9, 3613, 3613, 0 }, { 0, 0, 0, 0, 1946 }, { 0, 0, 0, 0, 1949 }, { 0, 0, 0, 0, 1952 }, { 0, 0, 0, 0, 1955 }, { 0, 9, 3616, 3616, 0 },
+  { 0, 0, 0, 0, 1958 }, { 0, 9, 3619, 3619, 0 }, { 0, 0, 0, 0, 1961 }, { 0, 9, 3622, 3622, 0 }, { 0, 0, 0, 0, 1964 }, { 0, 9, 3625, 3625, 0 },
+  { 0, 0, 0, 0, 1967 }, { 0, 9, 3628, 3628, 0 }, { 0, 24, 0, 3631, 0 }, { 0, 24, 0, 3634, 0 }, { 0, 24, 0, 3638, 0 }, { 0, 24, 0, 3641, 0 },
+  { 0, 0, 0, 0, 1970 }, { 0, 9, 3645, 3645, 0 }, { 0, 0, 0, 0, 1973 }, { 0, 9, 3648, 3648, 0 }, { 0, 0, 0, 0, 1976 }, { 0, 9, 3651, 3651, 0 },
+  { 0, 0, 0, 0, 1979 }, { 0, 9, 3654, 3654, 0 }, { 0, 0, 0, 0, 1982 }, { 0, 9, 3657, 3657, 0 }, { 0, 0, 0, 0, 1985 }, { 0, 9, 3660, 3660, 0 },
+  { 0, 0, 0, 0, 1988 }, { 0, 0, 0, 0, 1991 }, { 0, 9, 3663, 3663, 0 }, { 0, 9, 3666, 3666, 0 }, { 0, 9, 3669, 3669, 0 }, { 0, 9, 3672, 3672, 0 },
+  { 0, 9, 3675, 3675, 0 }, { 0, 0, 0, 0, 1994 }, { 0, 0, 0, 0, 1997 }, { 0, 9, 3678, 3678, 0 }, { 0, 9, 3681, 3681, 0 }, { 0, 0, 0, 0, 2000 },
+  { 0, 0, 0, 0, 2003 }, { 0, 9, 3684, 3684, 0 }, { 0, 9, 3687, 3687, 0 }, { 0, 0, 0, 0, 2006 }, { 0, 0, 0, 0, 2009 }, { 0, 0, 0, 0, 2012 },
+  { 0, 0, 0, 0, 2015 }, { 0, 9, 3690, 3690, 0 }, { 0, 9, 3693, 3693, 0 }, { 0, 0, 0, 0, 2018 }, { 0, 0, 0, 0, 2021 }, { 0, 9, 3696, 3696, 0 },
+  { 0, 9, 3699, 3699, 0 }, { 0, 0, 0, 0, 2024 }, { 0, 0, 0, 0, 2027 }, { 0, 9, 3702, 3702, 0 }, { 0, 9, 3705, 3705, 0 }, { 0, 0, 0, 0, 2030 },
+  { 0, 0, 0, 0, 2033 }, { 0, 0, 0, 0, 2036 }, { 0, 0, 0, 0, 2039 }, { 0, 0, 0, 0, 2042 }, { 0, 0, 0, 0, 2045 }, { 0, 9, 3708, 3708, 0 },
+  { 0, 9, 3711, 3711, 0 }, { 0, 9, 3714, 3714, 0 }, { 0, 9, 3717, 3717, 0 }, { 0, 0, 0, 0, 2048 }, { 0, 0, 0, 0, 2051 }, { 0, 0, 0, 0, 2054 },
+  { 0, 0, 0, 0, 2057 }, { 0, 9, 3720, 3720, 0 }, { 0, 9, 3723, 3723, 0 }, { 0, 9, 3726, 3726, 0 }, { 0, 9, 3729, 3729, 0 }, { 0, 9, 3732, 3732, 0 },
+  { 0, 9, 3735, 3735, 0 }, { 0, 9, 3738, 3738, 0 }, { 0, 9, 3741, 3741, 0 }, { 0, 27, 3744, 3744, 0 }, { 0, 27, 3746, 3746, 0 }, { 0, 24, 0, 3748, 0 },
+  { 0, 24, 0, 3751, 0 }, { 0, 24, 0, 3754, 0 }, { 0, 24, 0, 3757, 0 }, { 0, 24, 0, 3760, 0 }, { 0, 24, 0, 3763, 0 }, { 0, 24, 0, 3766, 0 },
+  { 0, 24, 0, 3769, 0 }, { 0, 24, 0, 3772, 0 }, { 0, 24, 0, 3775, 0 }, { 0, 24, 0, 3778, 0 }, { 0, 24, 0, 3781, 0 }, { 0, 24, 0, 3785, 0 },
+  { 0, 24, 0, 3789, 0 }, { 0, 24, 0, 3793, 0 }, { 0, 24, 0, 3797, 0 }, { 0, 24, 0, 3801, 0 }, { 0, 24, 0, 3805, 0 }, { 0, 24, 0, 3809, 0 },
+  { 0, 24, 0, 3813, 0 }, { 0, 24, 0, 3817, 0 }, { 0, 24, 0, 3822, 0 }, { 0, 24, 0, 3827, 0 }, { 0, 24, 0, 3832, 0 }, { 0, 24, 0, 3837, 0 },
+  { 0, 24, 0, 3842, 0 }, { 0, 24, 0, 3847, 0 }, { 0, 24, 0, 3852, 0 }, { 0, 24, 0, 3857, 0 }, { 0, 24, 0, 3862, 0 }, { 0, 24, 0, 3867, 0 },
+  { 0, 24, 0, 3872, 0 }, { 0, 24, 0, 3875, 0 }, { 0, 24, 0, 3878, 0 }, { 0, 24, 0, 3881, 0 }, { 0, 24, 0, 3884, 0 }, { 0, 24, 0, 3887, 0 },
+  { 0, 24, 0, 3890, 0 }, { 0, 24, 0, 3893, 0 }, { 0, 24, 0, 3896, 0 }, { 0, 24, 0, 3899, 0 }, { 0, 24, 0, 3903, 0 }, { 0, 24, 0, 3907, 0 },
+  { 0, 24, 0, 3911, 0 }, { 0, 24, 0, 3915, 0 }, { 0, 24, 0, 3919, 0 }, { 0, 24, 0, 3923, 0 }, { 0, 24, 0, 3927, 0 }, { 0, 24, 0, 3931, 0 },
+  { 0, 24, 0, 3935, 0 }, { 0, 24, 0, 3939, 0 }, { 0, 24, 0, 3943, 0 }, { 0, 24, 0, 3947, 0 }, { 0, 24, 0, 3951, 0 }, { 0, 24, 0, 3955, 0 },
+  { 0, 24, 0, 3959, 0 }, { 0, 24, 0, 3963, 0 }, { 0, 24, 0, 3967, 0 }, { 0, 24, 0, 3971, 0 }, { 0, 24, 0, 3975, 0 }, { 0, 24, 0, 3979, 0 },
+  { 0, 24, 0, 3983, 0 }, { 0, 24, 0, 3987, 0 }, { 0, 24, 0, 3991, 0 }, { 0, 24, 0, 3995, 0 }, { 0, 24, 0, 3999, 0 }, { 0, 24, 0, 4003, 0 },
+  { 0, 24, 0, 4007, 0 }, { 0, 24, 0, 4011, 0 }, { 0, 24, 0, 4015, 0 }, { 0, 24, 0, 4019, 0 }, { 0, 24, 0, 4023, 0 }, { 0, 24, 0, 4027, 0 },
+  { 0, 24, 0, 4031, 0 }, { 0, 24, 0, 4035, 0 }, { 0, 24, 0, 4039, 0 }, { 0, 24, 0, 4043, 0 }, { 0, 24, 0, 4047, 0 }, { 0, 24, 0, 4049, 0 },
+  { 0, 24, 0, 4051, 0 }, { 0, 24, 0, 4053, 0 }, { 0, 24, 0, 4058, 0 }, { 0, 24, 0, 4062, 0 }, { 0, 24, 0, 4065, 0 }, { 0, 27, 4069, 4069, 0 },
+  { 0, 24, 0, 4072, 0 }, { 0, 24, 0, 4074, 0 }, { 0, 24, 0, 4076, 0 }, { 0, 24, 0, 4078, 0 }, { 0, 24, 0, 4080, 0 }, { 0, 24, 0, 4082, 0 },
+  { 0, 24, 0, 4084, 0 }, { 0, 24, 0, 4086, 0 }, { 0, 24, 0, 4088, 0 }, { 0, 24, 0, 4090, 0 }, { 0, 24, 0, 4092, 0 }, { 0, 24, 0, 4094, 0 },
+  { 0, 24, 0, 4096, 0 }, { 0, 24, 0, 4098, 0 }, { 0, 24, 0, 4100, 0 }, { 0, 24, 0, 4102, 0 }, { 0, 24, 0, 4104, 0 }, { 0, 24, 0, 4106, 0 },
+  { 0, 24, 0, 4108, 0 }, { 0, 24, 0, 4110, 0 }, { 0, 24, 0, 4112, 0 }, { 0, 24, 0, 4114, 0 }, { 0, 24, 0, 4116, 0 }, { 0, 24, 0, 4118, 0 },
+  { 0, 24, 0, 4120, 0 }, { 0, 24, 0, 4122, 0 }, { 0, 24, 0, 4124, 0 }, { 0, 24, 0, 4126, 0 }, { 0, 24, 0, 4128, 0 }, { 0, 24, 0, 4130, 0 },
+  { 0, 24, 0, 4132, 0 }, { 0, 24, 0, 4134, 0 }, { 0, 24, 0, 4136, 0 }, { 0, 24, 0, 4138, 0 }, { 0, 24, 0, 4140, 0 }, { 0, 24, 0, 4142, 0 },
+  { 0, 24, 0, 4144, 0 }, { 0, 24, 0, 4146, 0 }, { 0, 24, 0, 4148, 0 }, { 0, 24, 0, 4150, 0 }, { 0, 24, 0, 4152, 0 }, { 0, 24, 0, 4154, 0 },
+  { 0, 24, 0, 4156, 0 }, { 0, 24, 0, 4158, 0 }, { 0, 24, 0, 4160, 0 }, { 0, 24, 0, 4162, 0 }, { 0, 24, 0, 4164, 0 }, { 0, 24, 0, 4166, 0 },
+  { 0, 24, 0, 4168, 0 }, { 0, 24, 0, 4170, 0 }, { 0, 24, 0, 4172, 0 }, { 0, 24, 0, 4174, 0 }, { 0, 24, 0, 4176, 0 }, { 0, 24, 0, 4178, 0 },
+  { 0, 24, 0, 4180, 0 }, { 0, 24, 0, 4182, 0 }, { 0, 24, 0, 4184, 0 }, { 0, 24, 0, 4186, 0 }, { 0, 24, 0, 4188, 0 }, { 0, 24, 0, 4190, 0 },
+  { 0, 24, 0, 4192, 0 }, { 0, 24, 0, 4194, 0 }, { 0, 24, 0, 4196, 0 }, { 0, 24, 0, 4198, 0 }, { 0, 24, 0, 4200, 0 }, { 0, 24, 0, 4202, 0 },
+  { 0, 24, 0, 4204, 0 }, { 0, 24, 0, 4206, 0 }, { 0, 24, 0, 4208, 0 }, { 0, 24, 0, 4210, 0 }, { 0, 24, 0, 4212, 0 }, { 0, 24, 0, 4214, 0 },
+  { 0, 24, 0, 4216, 0 }, { 0, 24, 0, 4218, 0 }, { 0, 24, 0, 4220, 0 }, { 0, 24, 0, 4222, 0 }, { 0, 24, 0, 4224, 0 }, { 0, 24, 0, 4226, 0 },
+  { 0, 24, 0, 4228, 0 }, { 0, 24, 0, 4230, 0 }, { 0, 24, 0, 4232, 0 }, { 0, 24, 0, 4234, 0 }, { 0, 24, 0, 4236, 0 }, { 0, 24, 0, 4238, 0 },
+  { 0, 24, 0, 4240, 0 }, { 0, 24, 0, 4242, 0 }, { 0, 24, 0, 4244, 0 }, { 0, 24, 0, 4246, 0 }, { 0, 24, 0, 4248, 0 }, { 0, 24, 0, 4250, 0 },
+  { 0, 24, 0, 4252, 0 }, { 0, 24, 0, 4254, 0 }, { 0, 24, 0, 4256, 0 }, { 0, 24, 0, 4258, 0 }, { 0, 24, 0, 4260, 0 }, { 0, 24, 0, 4262, 0 },
+  { 0, 24, 0, 4264, 0 }, { 0, 24, 0, 4266, 0 }, { 0, 24, 0, 4268, 0 }, { 0, 24, 0, 4270, 0 }, { 0, 24, 0, 4272, 0 }, { 0, 24, 0, 4274, 0 },
+  { 0, 24, 0, 4276, 0 }, { 0, 24, 0, 4278, 0 }, { 0, 24, 0, 4280, 0 }, { 0, 24, 0, 4282, 0 }, { 0, 24, 0, 4284, 0 }, { 0, 24, 0, 4286, 0 },
+  { 0, 24, 0, 4288, 0 }, { 0, 24, 0, 4290, 0 }, { 0, 24, 0, 4292, 0 }, { 0, 24, 0, 4294, 0 }, { 0, 24, 0, 4296, 0 }, { 0, 24, 0, 4298, 0 },
+  { 0, 24, 0, 4300, 0 }, { 0, 24, 0, 4302, 0 }, { 0, 24, 0, 4304, 0 }, { 0, 24, 0, 4306, 0 }, { 0, 24, 0, 4308, 0 }, { 0, 24, 0, 4310, 0 },
+  { 0, 24, 0, 4312, 0 }, { 0, 24, 0, 4314, 0 }, { 0, 24, 0, 4316, 0 }, { 0, 24, 0, 4318, 0 }, { 0, 24, 0, 4320, 0 }, { 0, 24, 0, 4322, 0 },
+  { 0, 24, 0, 4324, 0 }, { 0, 24, 0, 4326, 0 }, { 0, 24, 0, 4328, 0 }, { 0, 24, 0, 4330, 0 }, { 0, 24, 0, 4332, 0 }, { 0, 24, 0, 4334, 0 },
+  { 0, 24, 0, 4336, 0 }, { 0, 24, 0, 4338, 0 }, { 0, 24, 0, 4340, 0 }, { 0, 24, 0, 4342, 0 }, { 0, 24, 0, 4344, 0 }, { 0, 24, 0, 4346, 0 },
+  { 0, 24, 0, 4348, 0 }, { 0, 24, 0, 4350, 0 }, { 0, 24, 0, 4352, 0 }, { 0, 24, 0, 4354, 0 }, { 0, 24, 0, 4356, 0 }, { 0, 24, 0, 4358, 0 },
+  { 0, 24, 0, 4360, 0 }, { 0, 24, 0, 4362, 0 }, { 0, 24, 0, 4364, 0 }, { 0, 24, 0, 4366, 0 }, { 0, 24, 0, 4368, 0 }, { 0, 24, 0, 4370, 0 },
+  { 0, 24, 0, 4372, 0 }, { 0, 24, 0, 4374, 0 }, { 0, 24, 0, 4376, 0 }, { 0, 24, 0, 4378, 0 }, { 0, 24, 0, 4380, 0 }, { 0, 24, 0, 4382, 0 },
+  { 0, 24, 0, 4384, 0 }, { 0, 24, 0, 4386, 0 }, { 0, 24, 0, 4388, 0 }, { 0, 24, 0, 4390, 0 }, { 0, 24, 0, 4392, 0 }, { 0, 24, 0, 4394, 0 },
+  { 0, 24, 0, 4396, 0 }, { 0, 24, 0, 4398, 0 }, { 0, 24, 0, 4400, 0 }, { 0, 24, 0, 4402, 0 }, { 0, 24, 0, 4404, 0 }, { 0, 24, 0, 4406, 0 },
+  { 0, 24, 0, 4408, 0 }, { 0, 24, 0, 4410, 0 }, { 0, 24, 0, 4412, 0 }, { 0, 24, 0, 4414, 0 }, { 0, 24, 0, 4416, 0 }, { 0, 24, 0, 4418, 0 },
+  { 0, 24, 0, 4420, 0 }, { 0, 24, 0, 4422, 0 }, { 0, 24, 0, 4424, 0 }, { 0, 24, 0, 4426, 0 }, { 0, 24, 0, 4428, 0 }, { 0, 24, 0, 4430, 0 },
+  { 0, 24, 0, 4432, 0 }, { 0, 24, 0, 4434, 0 }, { 0, 24, 0, 4436, 0 }, { 0, 24, 0, 4438, 0 }, { 0, 24, 0, 4440, 0 }, { 0, 24, 0, 4442, 0 },
+  { 0, 24, 0, 4444, 0 }, { 0, 24, 0, 4446, 0 }, { 0, 24, 0, 4448, 0 }, { 0, 24, 0, 4450, 0 }, { 0, 24, 0, 4452, 0 }, { 0, 24, 0, 4454, 0 },
+  { 0, 24, 0, 4456, 0 }, { 0, 24, 0, 4458, 0 }, { 0, 24, 0, 4460, 0 }, { 0, 24, 0, 4462, 0 }, { 0, 24, 0, 4464, 0 }, { 0, 24, 0, 4466, 0 },
+  { 0, 24, 0, 4468, 0 }, { 0, 24, 0, 4470, 0 }, { 0, 24, 0, 4472, 0 }, { 0, 24, 0, 4474, 0 }, { 0, 24, 0, 4476, 0 }, { 0, 24, 0, 4478, 0 },
+  { 0, 24, 0, 4480, 0 }, { 0, 24, 0, 4482, 0 }, { 0, 24, 0, 4484, 0 }, { 0, 24, 0, 4486, 0 }, { 0, 24, 0, 4488, 0 }, { 0, 24, 0, 4490, 0 },
+  { 0, 24, 0, 4492, 0 }, { 0, 24, 0, 4494, 0 }, { 0, 24, 0, 4496, 0 }, { 0, 24, 0, 4498, 0 }, { 0, 24, 0, 4500, 0 }, { 0, 24, 0, 4502, 0 },
+  { 0, 24, 0, 4504, 0 }, { 224, 0, 0, 0, 0 }, { 0, 24, 0, 4506, 0 }, { 0, 24, 0, 4508, 0 }, { 0, 24, 0, 4510, 0 }, { 0, 0, 0, 0, 2060 },
+  { 0, 0, 0, 0, 2063 }, { 0, 9, 4512, 4512, 0 }, { 0, 0, 0, 0, 2066 }, { 0, 9, 4515, 4515, 0 }, { 0, 0, 0, 0, 2069 }, { 0, 9, 4518, 4518, 0 },
+  { 0, 0, 0, 0, 2072 }, { 0, 9, 4521, 4521, 0 }, { 0, 0, 0, 0, 2075 }, { 0, 9, 4524, 4524, 0 }, { 0, 0, 0, 0, 2078 }, { 0, 9, 4527, 4527, 0 },
+  { 0, 0, 0, 0, 2081 }, { 0, 9, 4530, 4530, 0 }, { 0, 0, 0, 0, 2084 }, { 0, 9, 4533, 4533, 0 }, { 0, 0, 0, 0, 2087 }, { 0, 9, 4536, 4536, 0 },
+  { 0, 0, 0, 0, 2090 }, { 0, 9, 4539, 4539, 0 }, { 0, 0, 0, 0, 2093 }, { 0, 9, 4542, 4542, 0 }, { 0, 0, 0, 0, 2096 }, { 0, 9, 4545, 4545, 0 },
+  { 0, 0, 0, 0, 2099 }, { 0, 9, 4548, 4548, 0 }, { 0, 0, 0, 0, 2102 }, { 0, 9, 4551, 4551, 0 }, { 0, 0, 0, 0, 2105 }, { 0, 9, 4554, 4554, 0 },
+  { 0, 0, 0, 0, 2108 }, { 0, 9, 4557, 4557, 0 }, { 0, 9, 4560, 4560, 0 }, { 0, 0, 0, 0, 2113 }, { 0, 9, 4563, 4563, 0 }, { 0, 9, 4566, 4566, 0 },
+  { 0, 0, 0, 0, 2118 }, { 0, 9, 4569, 4569, 0 }, { 0, 9, 4572, 4572, 0 }, { 0, 0, 0, 0, 2123 }, { 0, 9, 4575, 4575, 0 }, { 0, 9, 4578, 4578, 0 },
+  { 0, 0, 0, 0, 2128 }, { 0, 9, 4581, 4581, 0 }, { 0, 9, 4584, 4584, 0 }, { 0, 9, 4587, 4587, 0 }, { 8, 36, 0, 0, 0 }, { 0, 24, 0, 4590, 0 },
+  { 0, 24, 0, 4593, 0 }, { 0, 0, 0, 0, 2133 }, { 0, 9, 4596, 4596, 0 }, { 0, 24, 0, 4599, 0 }, { 0, 0, 0, 0, 2136 }, { 0, 0, 0, 0, 2139 },
+  { 0, 9, 4602, 4602, 0 }, { 0, 0, 0, 0, 2142 }, { 0, 9, 4605, 4605, 0 }, { 0, 0, 0, 0, 2145 }, { 0, 9, 4608, 4608, 0 }, { 0, 0, 0, 0, 2148 },
+  { 0, 9, 4611, 4611, 0 }, { 0, 0, 0, 0, 2151 }, { 0, 9, 4614, 4614, 0 }, { 0, 0, 0, 0, 2154 }, { 0, 9, 4617, 4617, 0 }, { 0, 0, 0, 0, 2157 },
+  { 0, 9, 4620, 4620, 0 }, { 0, 0, 0, 0, 2160 }, { 0, 9, 4623, 4623, 0 }, { 0, 0, 0, 0, 2163 }, { 0, 9, 4626, 4626, 0 }, { 0, 0, 0, 0, 2166 },
+  { 0, 9, 4629, 4629, 0 }, { 0, 0, 0, 0, 2169 }, { 0, 9, 4632, 4632, 0 }, { 0, 0, 0, 0, 2172 }, { 0, 9, 4635, 4635, 0 }, { 0, 0, 0, 0, 2175 },
+  { 0, 9, 4638, 4638, 0 }, { 0, 0, 0, 0, 2178 }, { 0, 9, 4641, 4641, 0 }, { 0, 0, 0, 0, 2181 }, { 0, 9, 4644, 4644, 0 }, { 0, 0, 0, 0, 2184 },
+  { 0, 9, 4647, 4647, 0 }, { 0, 9, 4650, 4650, 0 }, { 0, 0, 0, 0, 2189 }, { 0, 9, 4653, 4653, 0 }, { 0, 9, 4656, 4656, 0 }, { 0, 0, 0, 0, 2194 },
+  { 0, 9, 4659, 4659, 0 }, { 0, 9, 4662, 4662, 0 }, { 0, 0, 0, 0, 2199 }, { 0, 9, 4665, 4665, 0 }, { 0, 9, 4668, 4668, 0 }, { 0, 0, 0, 0, 2204 },
+  { 0, 9, 4671, 4671, 0 }, { 0, 9, 4674, 4674, 0 }, { 0, 0, 0, 0, 2209 }, { 0, 0, 0, 0, 2212 }, { 0, 0, 0, 0, 2215 }, { 0, 0, 0, 0, 2218 },
+  { 0, 9, 4677, 4677, 0 }, { 0, 9, 4680, 4680, 0 }, { 0, 9, 4683, 4683, 0 }, { 0, 9, 4686, 4686, 0 }, { 0, 9, 4689, 4689, 0 }, { 0, 0, 0, 0, 2221 },
+  { 0, 9, 4692, 4692, 0 }, { 0, 24, 0, 4695, 0 }, { 0, 24, 0, 4698, 0 }, { 0, 24, 0, 4700, 0 }, { 0, 24, 0, 4702, 0 }, { 0, 24, 0, 4704, 0 },
+  { 0, 24, 0, 4706, 0 }, { 0, 24, 0, 4708, 0 }, { 0, 24, 0, 4710, 0 }, { 0, 24, 0, 4712, 0 }, { 0, 24, 0, 4714, 0 }, { 0, 24, 0, 4716, 0 },
+  { 0, 24, 0, 4718, 0 }, { 0, 24, 0, 4720, 0 }, { 0, 24, 0, 4722, 0 }, { 0, 24, 0, 4724, 0 }, { 0, 24, 0, 4726, 0 }, { 0, 24, 0, 4728, 0 },
+  { 0, 24, 0, 4730, 0 }, { 0, 24, 0, 4732, 0 }, { 0, 24, 0, 4734, 0 }, { 0, 24, 0, 4736, 0 }, { 0, 24, 0, 4738, 0 }, { 0, 24, 0, 4740, 0 },
+  { 0, 24, 0, 4742, 0 }, { 0, 24, 0, 4744, 0 }, { 0, 24, 0, 4746, 0 }, { 0, 24, 0, 4748, 0 }, { 0, 24, 0, 4750, 0 }, { 0, 24, 0, 4752, 0 },
+  { 0, 24, 0, 4754, 0 }, { 0, 24, 0, 4756, 0 }, { 0, 24, 0, 4758, 0 }, { 0, 24, 0, 4760, 0 }, { 0, 24, 0, 4762, 0 }, { 0, 24, 0, 4764, 0 },
+  { 0, 24, 0, 4766, 0 }, { 0, 24, 0, 4768, 0 }, { 0, 24, 0, 4770, 0 }, { 0, 24, 0, 4772, 0 }, { 0, 24, 0, 4774, 0 }, { 0, 24, 0, 4776, 0 },
+  { 0, 24, 0, 4778, 0 }, { 0, 24, 0, 4780, 0 }, { 0, 24, 0, 4782, 0 }, { 0, 24, 0, 4784, 0 }, { 0, 24, 0, 4786, 0 }, { 0, 24, 0, 4788, 0 },
+  { 0, 24, 0, 4790, 0 }, { 0, 24, 0, 4792, 0 }, { 0, 24, 0, 4794, 0 }, { 0, 24, 0, 4796, 0 }, { 0, 24, 0, 4798, 0 }, { 0, 24, 0, 4800, 0 },
+  { 0, 24, 0, 4802, 0 }, { 0, 24, 0, 4804, 0 }, { 0, 24, 0, 4806, 0 }, { 0, 24, 0, 4808, 0 }, { 0, 24, 0, 4810, 0 }, { 0, 24, 0, 4812, 0 },
+  { 0, 24, 0, 4814, 0 }, { 0, 24, 0, 4816, 0 }, { 0, 24, 0, 4818, 0 }, { 0, 24, 0, 4820, 0 }, { 0, 24, 0, 4822, 0 }, { 0, 24, 0, 4824, 0 },
+  { 0, 24, 0, 4826, 0 }, { 0, 24, 0, 4828, 0 }, { 0, 24, 0, 4830, 0 }, { 0, 24, 0, 4832, 0 }, { 0, 24, 0, 4834, 0 }, { 0, 24, 0, 4836, 0 },
+  { 0, 24, 0, 4838, 0 }, { 0, 24, 0, 4840, 0 }, { 0, 24, 0, 4842, 0 }, { 0, 24, 0, 4844, 0 }, { 0, 24, 0, 4846, 0 }, { 0, 24, 0, 4848, 0 },
+  { 0, 24, 0, 4850, 0 }, { 0, 24, 0, 4852, 0 }, { 0, 24, 0, 4854, 0 }, { 0, 24, 0, 4856, 0 }, { 0, 24, 0, 4858, 0 }, { 0, 24, 0, 4860, 0 },
+  { 0, 24, 0, 4862, 0 }, { 0, 24, 0, 4864, 0 }, { 0, 24, 0, 4866, 0 }, { 0, 24, 0, 4868, 0 }, { 0, 24, 0, 4870, 0 }, { 0, 24, 0, 4872, 0 },
+  { 0, 24, 0, 4874, 0 }, { 0, 24, 0, 4876, 0 }, { 0, 24, 0, 4878, 0 }, { 0, 24, 0, 4880, 0 }, { 0, 24, 0, 4882, 0 }, { 0, 24, 0, 4884, 0 },
+  { 0, 24, 0, 4886, 0 }, { 0, 24, 0, 4888, 0 }, { 0, 24, 0, 4890, 0 }, { 0, 24, 0, 4892, 0 }, { 0, 24, 0, 4894, 0 }, { 0, 24, 0, 4896, 0 },
+  { 0, 24, 0, 4898, 0 }, { 0, 24, 0, 4900, 0 }, { 0, 24, 0, 4902, 0 }, { 0, 24, 0, 4904, 0 }, { 0, 24, 0, 4906, 0 }, { 0, 24, 0, 4910, 0 },
+  { 0, 24, 0, 4914, 0 }, { 0, 24, 0, 4918, 0 }, { 0, 24, 0, 4922, 0 }, { 0, 24, 0, 4926, 0 }, { 0, 24, 0, 4930, 0 }, { 0, 24, 0, 4934, 0 },
+  { 0, 24, 0, 4938, 0 }, { 0, 24, 0, 4942, 0 }, { 0, 24, 0, 4946, 0 }, { 0, 24, 0, 4950, 0 }, { 0, 24, 0, 4954, 0 }, { 0, 24, 0, 4958, 0 },
+  { 0, 24, 0, 4962, 0 }, { 0, 24, 0, 4967, 0 }, { 0, 24, 0, 4972, 0 }, { 0, 24, 0, 4977, 0 }, { 0, 24, 0, 4982, 0 }, { 0, 24, 0, 4987, 0 },
+  { 0, 24, 0, 4992, 0 }, { 0, 24, 0, 4997, 0 }, { 0, 24, 0, 5002, 0 }, { 0, 24, 0, 5007, 0 }, { 0, 24, 0, 5012, 0 }, { 0, 24, 0, 5017, 0 },
+  { 0, 24, 0, 5022, 0 }, { 0, 24, 0, 5027, 0 }, { 0, 24, 0, 5032, 0 }, { 0, 24, 0, 5037, 0 }, { 0, 24, 0, 5045, 0 }, { 0, 24, 0, 5052, 0 },
+  { 0, 24, 0, 5056, 0 }, { 0, 24, 0, 5060, 0 }, { 0, 24, 0, 5064, 0 }, { 0, 24, 0, 5068, 0 }, { 0, 24, 0, 5072, 0 }, { 0, 24, 0, 5076, 0 },
+  { 0, 24, 0, 5080, 0 }, { 0, 24, 0, 5084, 0 }, { 0, 24, 0, 5088, 0 }, { 0, 24, 0, 5092, 0 }, { 0, 24, 0, 5096, 0 }, { 0, 24, 0, 5100, 0 },
+  { 0, 24, 0, 5104, 0 }, { 0, 24, 0, 5108, 0 }, { 0, 24, 0, 5112, 0 }, { 0, 24, 0, 5116, 0 }, { 0, 24, 0, 5120, 0 }, { 0, 24, 0, 5124, 0 },
+  { 0, 24, 0, 5128, 0 }, { 0, 24, 0, 5132, 0 }, { 0, 24, 0, 5136, 0 }, { 0, 24, 0, 5140, 0 }, { 0, 24, 0, 5144, 0 }, { 0, 24, 0, 5148, 0 },
+  { 0, 24, 0, 5152, 0 }, { 0, 24, 0, 5156, 0 }, { 0, 24, 0, 5160, 0 }, { 0, 24, 0, 5164, 0 }, { 0, 24, 0, 5168, 0 }, { 0, 24, 0, 5172, 0 },
+  { 0, 24, 0, 5176, 0 }, { 0, 24, 0, 5180, 0 }, { 0, 24, 0, 5184, 0 }, { 0, 24, 0, 5188, 0 }, { 0, 24, 0, 5192, 0 }, { 0, 24, 0, 5196, 0 },
+  { 0, 24, 0, 5198, 0 }, { 0, 24, 0, 5200, 0 }, { 0, 24, 0, 5202, 0 }, { 0, 24, 0, 5206, 0 }, { 0, 24, 0, 5209, 0 }, { 0, 24, 0, 5212, 0 },
+  { 0, 24, 0, 5215, 0 }, { 0, 24, 0, 5218, 0 }, { 0, 24, 0, 5221, 0 }, { 0, 24, 0, 5224, 0 }, { 0, 24, 0, 5227, 0 }, { 0, 24, 0, 5230, 0 },
+  { 0, 24, 0, 5233, 0 }, { 0, 24, 0, 5236, 0 }, { 0, 24, 0, 5239, 0 }, { 0, 24, 0, 5242, 0 }, { 0, 24, 0, 5245, 0 }, { 0, 24, 0, 5248, 0 },
+  { 0, 24, 0, 5251, 0 }, { 0, 24, 0, 5254, 0 }, { 0, 24, 0, 5257, 0 }, { 0, 24, 0, 5260, 0 }, { 0, 24, 0, 5263, 0 }, { 0, 24, 0, 5266, 0 },
+  { 0, 24, 0, 5269, 0 }, { 0, 24, 0, 5272, 0 }, { 0, 24, 0, 5275, 0 }, { 0, 24, 0, 5278, 0 }, { 0, 24, 0, 5281, 0 }, { 0, 24, 0, 5284, 0 },
+  { 0, 24, 0, 5287, 0 }, { 0, 24, 0, 5290, 0 }, { 0, 24, 0, 5293, 0 }, { 0, 24, 0, 5299, 0 }, { 0, 24, 0, 5304, 0 }, { 0, 24, 0, 5307, 0 },
+  { 0, 24, 0, 5309, 0 }, { 0, 24, 0, 5311, 0 }, { 0, 24, 0, 5313, 0 }, { 0, 24, 0, 5315, 0 }, { 0, 24, 0, 5317, 0 }, { 0, 24, 0, 5319, 0 },
+  { 0, 24, 0, 5321, 0 }, { 0, 24, 0, 5323, 0 }, { 0, 24, 0, 5325, 0 }, { 0, 24, 0, 5327, 0 }, { 0, 24, 0, 5329, 0 }, { 0, 24, 0, 5331, 0 },
+  { 0, 24, 0, 5333, 0 }, { 0, 24, 0, 5335, 0 }, { 0, 24, 0, 5337, 0 }, { 0, 24, 0, 5339, 0 }, { 0, 24, 0, 5341, 0 }, { 0, 24, 0, 5343, 0 },
+  { 0, 24, 0, 5345, 0 }, { 0, 24, 0, 5347, 0 }, { 0, 24, 0, 5349, 0 }, { 0, 24, 0, 5351, 0 }, { 0, 24, 0, 5353, 0 }, { 0, 24, 0, 5355, 0 },
+  { 0, 24, 0, 5357, 0 }, { 0, 24, 0, 5359, 0 }, { 0, 24, 0, 5361, 0 }, { 0, 24, 0, 5363, 0 }, { 0, 24, 0, 5365, 0 }, { 0, 24, 0, 5367, 0 },
+  { 0, 24, 0, 5369, 0 }, { 0, 24, 0, 5371, 0 }, { 0, 24, 0, 5374, 0 }, { 0, 24, 0, 5377, 0 }, { 0, 24, 0, 5380, 0 }, { 0, 24, 0, 5383, 0 },
+  { 0, 24, 0, 5386, 0 }, { 0, 24, 0, 5389, 0 }, { 0, 24, 0, 5392, 0 }, { 0, 24, 0, 5395, 0 }, { 0, 24, 0, 5398, 0 }, { 0, 24, 0, 5401, 0 },
+  { 0, 24, 0, 5404, 0 }, { 0, 24, 0, 5407, 0 }, { 0, 24, 0, 5410, 0 }, { 0, 24, 0, 5413, 0 }, { 0, 24, 0, 5416, 0 }, { 0, 24, 0, 5419, 0 },
+  { 0, 24, 0, 5422, 0 }, { 0, 24, 0, 5425, 0 }, { 0, 24, 0, 5428, 0 }, { 0, 24, 0, 5431, 0 }, { 0, 24, 0, 5434, 0 }, { 0, 24, 0, 5437, 0 },
+  { 0, 24, 0, 5440, 0 }, { 0, 24, 0, 5443, 0 }, { 0, 24, 0, 5447, 0 }, { 0, 24, 0, 5451, 0 }, { 0, 24, 0, 5455, 0 }, { 0, 24, 0, 5458, 0 },
+  { 0, 24, 0, 5462, 0 }, { 0, 24, 0, 5465, 0 }, { 0, 24, 0, 5469, 0 }, { 0, 24, 0, 5471, 0 }, { 0, 24, 0, 5473, 0 }, { 0, 24, 0, 5475, 0 },
+  { 0, 24, 0, 5477, 0 }, { 0, 24, 0, 5479, 0 }, { 0, 24, 0, 5481, 0 }, { 0, 24, 0, 5483, 0 }, { 0, 24, 0, 5485, 0 }, { 0, 24, 0, 5487, 0 },
+  { 0, 24, 0, 5489, 0 }, { 0, 24, 0, 5491, 0 }, { 0, 24, 0, 5493, 0 }, { 0, 24, 0, 5495, 0 }, { 0, 24, 0, 5497, 0 }, { 0, 24, 0, 5499, 0 },
+  { 0, 24, 0, 5501, 0 }, { 0, 24, 0, 5503, 0 }, { 0, 24, 0, 5505, 0 }, { 0, 24, 0, 5507, 0 }, { 0, 24, 0, 5509, 0 }, { 0, 24, 0, 5511, 0 },
+  { 0, 24, 0, 5513, 0 }, { 0, 24, 0, 5515, 0 }, { 0, 24, 0, 5517, 0 }, { 0, 24, 0, 5519, 0 }, { 0, 24, 0, 5521, 0 }, { 0, 24, 0, 5523, 0 },
+  { 0, 24, 0, 5525, 0 }, { 0, 24, 0, 5527, 0 }, { 0, 24, 0, 5529, 0 }, { 0, 24, 0, 5531, 0 }, { 0, 24, 0, 5533, 0 }, { 0, 24, 0, 5535, 0 },
+  { 0, 24, 0, 5537, 0 }, { 0, 24, 0, 5539, 0 }, { 0, 24, 0, 5541, 0 }, { 0, 24, 0, 5543, 0 }, { 0, 24, 0, 5545, 0 }, { 0, 24, 0, 5547, 0 },
+  { 0, 24, 0, 5549, 0 }, { 0, 24, 0, 5551, 0 }, { 0, 24, 0, 5553, 0 }, { 0, 24, 0, 5555, 0 }, { 0, 24, 0, 5557, 0 }, { 0, 24, 0, 5559, 0 },
+  { 0, 24, 0, 5561, 0 }, { 0, 24, 0, 5563, 0 }, { 0, 24, 0, 5566, 0 }, { 0, 24, 0, 5572, 0 }, { 0, 24, 0, 5577, 0 }, { 0, 24, 0, 5583, 0 },
+  { 0, 24, 0, 5587, 0 }, { 0, 24, 0, 5593, 0 }, { 0, 24, 0, 5597, 0 }, { 0, 24, 0, 5601, 0 }, { 0, 24, 0, 5608, 0 }, { 0, 24, 0, 5613, 0 },
+  { 0, 24, 0, 5617, 0 }, { 0, 24, 0, 5621, 0 }, { 0, 24, 0, 5625, 0 }, { 0, 24, 0, 5630, 0 }, { 0, 24, 0, 5635, 0 }, { 0, 24, 0, 5640, 0 },
+  { 0, 24, 0, 5645, 0 }, { 0, 24, 0, 5650, 0 }, { 0, 24, 0, 5655, 0 }, { 0, 24, 0, 5660, 0 }, { 0, 24, 0, 5667, 0 }, { 0, 24, 0, 5670, 0 },
+  { 0, 24, 0, 5677, 0 }, { 0, 24, 0, 5684, 0 }, { 0, 24, 0, 5690, 0 }, { 0, 24, 0, 5695, 0 }, { 0, 24, 0, 5702, 0 }, { 0, 24, 0, 5709, 0 },
+  { 0, 24, 0, 5714, 0 }, { 0, 24, 0, 5718, 0 }, { 0, 24, 0, 5722, 0 }, { 0, 24, 0, 5727, 0 }, { 0, 24, 0, 5732, 0 }, { 0, 24, 0, 5738, 0 },
+  { 0, 24, 0, 5744, 0 }, { 0, 24, 0, 5748, 0 }, { 0, 24, 0, 5752, 0 }, { 0, 24, 0, 5757, 0 }, { 0, 24, 0, 5761, 0 }, { 0, 24, 0, 5765, 0 },
+  { 0, 24, 0, 5768, 0 }, { 0, 24, 0, 5771, 0 }, { 0, 24, 0, 5775, 0 }, { 0, 24, 0, 5779, 0 }, { 0, 24, 0, 5786, 0 }, { 0, 24, 0, 5791, 0 },
+  { 0, 24, 0, 5797, 0 }, { 0, 24, 0, 5804, 0 }, { 0, 24, 0, 5809, 0 }, { 0, 24, 0, 5813, 0 }, { 0, 24, 0, 5817, 0 }, { 0, 24, 0, 5824, 0 },
+  { 0, 24, 0, 5829, 0 }, { 0, 24, 0, 5836, 0 }, { 0, 24, 0, 5840, 0 }, { 0, 24, 0, 5846, 0 }, { 0, 24, 0, 5850, 0 }, { 0, 24, 0, 5855, 0 },
+  { 0, 24, 0, 5859, 0 }, { 0, 24, 0, 5864, 0 }, { 0, 24, 0, 5870, 0 }, { 0, 24, 0, 5875, 0 }, { 0, 24, 0, 5881, 0 }, { 0, 24, 0, 5886, 0 },
+  { 0, 24, 0, 5889, 0 }, { 0, 24, 0, 5895, 0 }, { 0, 24, 0, 5899, 0 }, { 0, 24, 0, 5903, 0 }, { 0, 24, 0, 5908, 0 }, { 0, 24, 0, 5912, 0 },
+  { 0, 24, 0, 5916, 0 }, { 0, 24, 0, 5920, 0 }, { 0, 24, 0, 5926, 0 }, { 0, 24, 0, 5931, 0 }, { 0, 24, 0, 5934, 0 }, { 0, 24, 0, 5941, 0 },
+  { 0, 24, 0, 5945, 0 }, { 0, 24, 0, 5951, 0 }, { 0, 24, 0, 5956, 0 }, { 0, 24, 0, 5961, 0 }, { 0, 24, 0, 5965, 0 }, { 0, 24, 0, 5969, 0 },
+  { 0, 24, 0, 5974, 0 }, { 0, 24, 0, 5977, 0 }, { 0, 24, 0, 5982, 0 }, { 0, 24, 0, 5988, 0 }, { 0, 24, 0, 5991, 0 }, { 0, 24, 0, 5998, 0 },
+  { 0, 24, 0, 6002, 0 }, { 0, 24, 0, 6005, 0 }, { 0, 24, 0, 6008, 0 }, { 0, 24, 0, 6011, 0 }, { 0, 24, 0, 6014, 0 }, { 0, 24, 0, 6017, 0 },
+  { 0, 24, 0, 6020, 0 }, { 0, 24, 0, 6023, 0 }, { 0, 24, 0, 6026, 0 }, { 0, 24, 0, 6029, 0 }, { 0, 24, 0, 6032, 0 }, { 0, 24, 0, 6036, 0 },
+  { 0, 24, 0, 6040, 0 }, { 0, 24, 0, 6044, 0 }, { 0, 24, 0, 6048, 0 }, { 0, 24, 0, 6052, 0 }, { 0, 24, 0, 6056, 0 }, { 0, 24, 0, 6060, 0 },
+  { 0, 24, 0, 6064, 0 }, { 0, 24, 0, 6068, 0 }, { 0, 24, 0, 6072, 0 }, { 0, 24, 0, 6076, 0 }, { 0, 24, 0, 6080, 0 }, { 0, 24, 0, 6084, 0 },
+  { 0, 24, 0, 6088, 0 }, { 0, 24, 0, 6092, 0 }, { 0, 24, 0, 6096, 0 }, { 0, 24, 0, 6099, 0 }, { 0, 24, 0, 6102, 0 }, { 0, 24, 0, 6106, 0 },
+  { 0, 24, 0, 6109, 0 }, { 0, 24, 0, 6112, 0 }, { 0, 24, 0, 6115, 0 }, { 0, 24, 0, 6119, 0 }, { 0, 24, 0, 6123, 0 }, { 0, 24, 0, 6126, 0 },
+  { 0, 24, 0, 6129, 0 }, { 0, 24, 0, 6132, 0 }, { 0, 24, 0, 6135, 0 }, { 0, 24, 0, 6138, 0 }, { 0, 24, 0, 6143, 0 }, { 0, 24, 0, 6146, 0 },
+  { 0, 24, 0, 6149, 0 }, { 0, 24, 0, 6152, 0 }, { 0, 24, 0, 6155, 0 }, { 0, 24, 0, 6158, 0 }, { 0, 24, 0, 6161, 0 }, { 0, 24, 0, 6164, 0 },
+  { 0, 24, 0, 6167, 0 }, { 0, 24, 0, 6171, 0 }, { 0, 24, 0, 6176, 0 }, { 0, 24, 0, 6179, 0 }, { 0, 24, 0, 6182, 0 }, { 0, 24, 0, 6185, 0 },
+  { 0, 24, 0, 6188, 0 }, { 0, 24, 0, 6191, 0 }, { 0, 24, 0, 6194, 0 }, { 0, 24, 0, 6197, 0 }, { 0, 24, 0, 6201, 0 }, { 0, 24, 0, 6205, 0 },
+  { 0, 24, 0, 6209, 0 }, { 0, 24, 0, 6213, 0 }, { 0, 24, 0, 6216, 0 }, { 0, 24, 0, 6219, 0 }, { 0, 24, 0, 6222, 0 }, { 0, 24, 0, 6225, 0 },
+  { 0, 24, 0, 6228, 0 }, { 0, 24, 0, 6231, 0 }, { 0, 24, 0, 6234, 0 }, { 0, 24, 0, 6237, 0 }, { 0, 24, 0, 6240, 0 }, { 0, 24, 0, 6243, 0 },
+  { 0, 24, 0, 6247, 0 }, { 0, 24, 0, 6251, 0 }, { 0, 24, 0, 6254, 0 }, { 0, 24, 0, 6258, 0 }, { 0, 24, 0, 6262, 0 }, { 0, 24, 0, 6266, 0 },
+  { 0, 24, 0, 6269, 0 }, { 0, 24, 0, 6273, 0 }, { 0, 24, 0, 6277, 0 }, { 0, 24, 0, 6282, 0 }, { 0, 24, 0, 6285, 0 }, { 0, 24, 0, 6289, 0 },
+  { 0, 24, 0, 6293, 0 }, { 0, 24, 0, 6297, 0 }, { 0, 24, 0, 6301, 0 }, { 0, 24, 0, 6307, 0 }, { 0, 24, 0, 6314, 0 }, { 0, 24, 0, 6317, 0 },
+  { 0, 24, 0, 6320, 0 }, { 0, 24, 0, 6323, 0 }, { 0, 24, 0, 6326, 0 }, { 0, 24, 0, 6329, 0 }, { 0, 24, 0, 6332, 0 }, { 0, 24, 0, 6335, 0 },
+  { 0, 24, 0, 6338, 0 }, { 0, 24, 0, 6341, 0 }, { 0, 24, 0, 6344, 0 }, { 0, 24, 0, 6347, 0 }, { 0, 24, 0, 6350, 0 }, { 0, 24, 0, 6353, 0 },
+  { 0, 24, 0, 6356, 0 }, { 0, 24, 0, 6359, 0 }, { 0, 24, 0, 6362, 0 }, { 0, 24, 0, 6365, 0 }, { 0, 24, 0, 6368, 0 }, { 0, 24, 0, 6373, 0 },
+  { 0, 24, 0, 6376, 0 }, { 0, 24, 0, 6379, 0 }, { 0, 24, 0, 6382, 0 }, { 0, 24, 0, 6387, 0 }, { 0, 24, 0, 6391, 0 }, { 0, 24, 0, 6394, 0 },
+  { 0, 24, 0, 6397, 0 }, { 0, 24, 0, 6400, 0 }, { 0, 24, 0, 6403, 0 }, { 0, 24, 0, 6406, 0 }, { 0, 24, 0, 6409, 0 }, { 0, 24, 0, 6412, 0 },
+  { 0, 24, 0, 6415, 0 }, { 0, 24, 0, 6418, 0 }, { 0, 24, 0, 6421, 0 }, { 0, 24, 0, 6425, 0 }, { 0, 24, 0, 6428, 0 }, { 0, 24, 0, 6431, 0 },
+  { 0, 24, 0, 6435, 0 }, { 0, 24, 0, 6439, 0 }, { 0, 24, 0, 6442, 0 }, { 0, 24, 0, 6447, 0 }, { 0, 24, 0, 6451, 0 }, { 0, 24, 0, 6454, 0 },
+  { 0, 24, 0, 6457, 0 }, { 0, 24, 0, 6460, 0 }, { 0, 24, 0, 6463, 0 }, { 0, 24, 0, 6467, 0 }, { 0, 24, 0, 6471, 0 }, { 0, 24, 0, 6474, 0 },
+  { 0, 24, 0, 6477, 0 }, { 0, 24, 0, 6480, 0 }, { 0, 24, 0, 6483, 0 }, { 0, 24, 0, 6486, 0 }, { 0, 24, 0, 6489, 0 }, { 0, 24, 0, 6492, 0 },
+  { 0, 24, 0, 6495, 0 }, { 0, 24, 0, 6498, 0 }, { 0, 24, 0, 6502, 0 }, { 0, 24, 0, 6506, 0 }, { 0, 24, 0, 6510, 0 }, { 0, 24, 0, 6514, 0 },
+  { 0, 24, 0, 6518, 0 }, { 0, 24, 0, 6522, 0 }, { 0, 24, 0, 6526, 0 }, { 0, 24, 0, 6530, 0 }, { 0, 24, 0, 6534, 0 }, { 0, 24, 0, 6538, 0 },
+  { 0, 24, 0, 6542, 0 }, { 0, 24, 0, 6546, 0 }, { 0, 24, 0, 6550, 0 }, { 0, 24, 0, 6554, 0 }, { 0, 24, 0, 6558, 0 }, { 0, 24, 0, 6562, 0 },
+  { 0, 24, 0, 6566, 0 }, { 0, 24, 0, 6570, 0 }, { 0, 24, 0, 6574, 0 }, { 0, 24, 0, 6578, 0 }, { 0, 24, 0, 6582, 0 }, { 0, 24, 0, 6586, 0 },
+  { 0, 24, 0, 6590, 0 }, { 0, 24, 0, 6592, 0 }, { 0, 24, 0, 6594, 0 }, { 0, 24, 0, 6596, 0 }, { 0, 24, 0, 6598, 0 }, { 0, 24, 0, 6600, 0 },
+  { 0, 24, 0, 6602, 0 }, { 0, 24, 0, 6604, 0 }, { 0, 24, 0, 6606, 0 }, { 0, 24, 0, 6608, 0 }, { 0, 9, 0, 0, 0 }, { 0, 27, 6610, 6610, 0 },
+  { 0, 27, 6612, 6612, 0 }, { 0, 27, 4394, 4394, 0 }, { 0, 27, 6614, 6614, 0 }, { 0, 27, 6616, 6616, 0 }, { 0, 27, 6618, 6618, 0 }, { 0, 27, 6620, 6620, 0 },
+  { 0, 27, 4502, 4502, 0 }, { 0, 27, 6622, 6622, 0 }, { 0, 27, 4410, 4410, 0 }, { 0, 27, 6624, 6624, 0 }, { 0, 27, 6626, 6626, 0 }, { 0, 27, 6628, 6628, 0 },
+  { 0, 27, 6630, 6630, 0 }, { 0, 27, 6632, 6632, 0 }, { 0, 27, 6634, 6634, 0 }, { 0, 27, 6636, 6636, 0 }, { 0, 27, 6638, 6638, 0 }, { 0, 27, 6640, 6640, 0 },
+  { 0, 27, 6642, 6642, 0 }, { 0, 27, 6644, 6644, 0 }, { 0, 27, 6646, 6646, 0 }, { 0, 27, 6648, 6648, 0 }, { 0, 27, 6650, 6650, 0 }, { 0, 27, 6652, 6652, 0 },
+  { 0, 27, 6654, 6654, 0 }, { 0, 27, 6656, 6656, 0 }, { 0, 27, 6658, 6658, 0 }, { 0, 27, 6660, 6660, 0 }, { 0, 27, 6662, 6662, 0 }, { 0, 27, 6664, 6664, 0 },
+  { 0, 27, 6666, 6666, 0 }, { 0, 27, 6668, 6668, 0 }, { 0, 27, 6670, 6670, 0 }, { 0, 27, 6672, 6672, 0 }, { 0, 27, 6674, 6674, 0 }, { 0, 27, 6676, 6676, 0 },
+  { 0, 27, 6678, 6678, 0 }, { 0, 27, 6680, 6680, 0 }, { 0, 27, 6682, 6682, 0 }, { 0, 27, 6684, 6684, 0 }, { 0, 27, 6686, 6686, 0 }, { 0, 27, 6688, 6688, 0 },
+  { 0, 27, 6690, 6690, 0 }, { 0, 27, 6692, 6692, 0 }, { 0, 27, 6694, 6694, 0 }, { 0, 27, 6696, 6696, 0 }, { 0, 27, 6698, 6698, 0 }, { 0, 27, 6700, 6700, 0 },
+  { 0, 27, 6702, 6702, 0 }, { 0, 27, 6704, 6704, 0 }, { 0, 27, 4326, 4326, 0 }, { 0, 27, 6706, 6706, 0 }, { 0, 27, 6708, 6708, 0 }, { 0, 27, 6710, 6710, 0 },
+  { 0, 27, 6712, 6712, 0 }, { 0, 27, 6714, 6714, 0 }, { 0, 27, 6716, 6716, 0 }, { 0, 27, 6718, 6718, 0 }, { 0, 27, 6720, 6720, 0 }, { 0, 27, 6722, 6722, 0 },
+  { 0, 27, 6724, 6724, 0 }, { 0, 27, 6726, 6726, 0 }, { 0, 27, 4472, 4472, 0 }, { 0, 27, 6728, 6728, 0 }, { 0, 27, 6730, 6730, 0 }, { 0, 27, 6732, 6732, 0 },
+  { 0, 27, 6734, 6734, 0 }, { 0, 27, 6736, 6736, 0 }, { 0, 27, 6738, 6738, 0 }, { 0, 27, 6740, 6740, 0 }, { 0, 27, 6742, 6742, 0 }, { 0, 27, 6744, 6744, 0 },
+  { 0, 27, 6746, 6746, 0 }, { 0, 27, 6748, 6748, 0 }, { 0, 27, 6750, 6750, 0 }, { 0, 27, 6752, 6752, 0 }, { 0, 27, 6754, 6754, 0 }, { 0, 27, 6756, 6756, 0 },
+  { 0, 27, 6758, 6758, 0 }, { 0, 27, 6760, 6760, 0 }, { 0, 27, 6762, 6762, 0 }, { 0, 27, 6764, 6764, 0 }, { 0, 27, 6766, 6766, 0 }, { 0, 27, 6768, 6768, 0 },
+  { 0, 27, 6770, 6770, 0 }, { 0, 27, 6772, 6772, 0 }, { 0, 27, 6774, 6774, 0 }, { 0, 27, 6776, 6776, 0 }, { 0, 27, 6778, 6778, 0 }, { 0, 27, 6780, 6780, 0 },
+  { 0, 27, 6782, 6782, 0 }, { 0, 27, 6784, 6784, 0 }, { 0, 27, 6786, 6786, 0 }, { 0, 27, 6788, 6788, 0 }, { 0, 27, 6790, 6790, 0 }, { 0, 27, 6792, 6792, 0 },
+  { 0, 27, 6794, 6794, 0 }, { 0, 27, 6796, 6796, 0 }, { 0, 27, 6798, 6798, 0 }, { 0, 27, 6800, 6800, 0 }, { 0, 27, 6802, 6802, 0 }, { 0, 27, 6804, 6804, 0 },
+  { 0, 27, 6806, 6806, 0 }, { 0, 27, 6808, 6808, 0 }, { 0, 27, 6810, 6810, 0 }, { 0, 27, 6812, 6812, 0 }, { 0, 27, 6814, 6814, 0 }, { 0, 27, 6816, 6816, 0 },
+  { 0, 27, 6818, 6818, 0 }, { 0, 27, 6820, 6820, 0 }, { 0, 27, 4398, 4398, 0 }, { 0, 27, 6822, 6822, 0 }, { 0, 27, 6824, 6824, 0 }, { 0, 27, 6826, 6826, 0 },
+  { 0, 27, 6828, 6828, 0 }, { 0, 27, 6830, 6830, 0 }, { 0, 27, 6832, 6832, 0 }, { 0, 27, 6834, 6834, 0 }, { 0, 27, 6836, 6836, 0 }, { 0, 27, 6838, 6838, 0 },
+  { 0, 27, 6840, 6840, 0 }, { 0, 27, 6842, 6842, 0 }, { 0, 27, 6844, 6844, 0 }, { 0, 27, 6846, 6846, 0 }, { 0, 27, 6848, 6848, 0 }, { 0, 27, 6850, 6850, 0 },
+  { 0, 27, 4152, 4152, 0 }, { 0, 27, 6852, 6852, 0 }, { 0, 27, 6854, 6854, 0 }, { 0, 27, 6856, 6856, 0 }, { 0, 27, 6858, 6858, 0 }, { 0, 27, 6860, 6860, 0 },
+  { 0, 27, 6862, 6862, 0 }, { 0, 27, 6864, 6864, 0 }, { 0, 27, 6866, 6866, 0 }, { 0, 27, 4114, 4114, 0 }, { 0, 27, 6868, 6868, 0 }, { 0, 27, 6870, 6870, 0 },
+  { 0, 27, 6872, 6872, 0 }, { 0, 27, 6874, 6874, 0 }, { 0, 27, 6876, 6876, 0 }, { 0, 27, 6878, 6878, 0 }, { 0, 27, 6880, 6880, 0 }, { 0, 27, 6882, 6882, 0 },
+  { 0, 27, 6884, 6884, 0 }, { 0, 27, 6886, 6886, 0 }, { 0, 27, 6888, 6888, 0 }, { 0, 27, 6890, 6890, 0 }, { 0, 27, 6892, 6892, 0 }, { 0, 27, 6894, 6894, 0 },
+  { 0, 27, 6896, 6896, 0 }, { 0, 27, 6898, 6898, 0 }, { 0, 27, 6900, 6900, 0 }, { 0, 27, 6902, 6902, 0 }, { 0, 27, 6904, 6904, 0 }, { 0, 27, 6906, 6906, 0 },
+  { 0, 27, 6908, 6908, 0 }, { 0, 27, 6910, 6910, 0 }, { 0, 27, 6912, 6912, 0 }, { 0, 27, 6914, 6914, 0 }, { 0, 27, 6916, 6916, 0 }, { 0, 27, 6918, 6918, 0 },
+  { 0, 27, 6920, 6920, 0 }, { 0, 27, 6922, 6922, 0 }, { 0, 27, 6924, 6924, 0 }, { 0, 27, 6926, 6926, 0 }, { 0, 27, 6928, 6928, 0 }, { 0, 27, 6930, 6930, 0 },
+  { 0, 27, 6932, 6932, 0 }, { 0, 27, 6934, 6934, 0 }, { 0, 27, 6936, 6936, 0 }, { 0, 27, 6938, 6938, 0 }, { 0, 27, 6940, 6940, 0 }, { 0, 27, 6942, 6942, 0 },
+  { 0, 27, 6944, 6944, 0 }, { 0, 27, 6946, 6946, 0 }, { 0, 27, 6948, 6948, 0 }, { 0, 27, 6950, 6950, 0 }, { 0, 27, 6952, 6952, 0 }, { 0, 27, 6954, 6954, 0 },
+  { 0, 27, 6956, 6956, 0 }, { 0, 27, 6958, 6958, 0 }, { 0, 27, 6960, 6960, 0 }, { 0, 27, 6962, 6962, 0 }, { 0, 27, 6964, 6964, 0 }, { 0, 27, 6966, 6966, 0 },
+  { 0, 27, 6968, 6968, 0 }, { 0, 27, 6970, 6970, 0 }, { 0, 27, 6972, 6972, 0 }, { 0, 27, 6974, 6974, 0 }, { 0, 27, 4500, 4500, 0 }, { 0, 27, 6976, 6976, 0 },
+  { 0, 27, 6978, 6978, 0 }, { 0, 27, 6980, 6980, 0 }, { 0, 27, 6982, 6982, 0 }, { 0, 27, 6984, 6984, 0 }, { 0, 27, 6986, 6986, 0 }, { 0, 27, 6988, 6988, 0 },
+  { 0, 27, 6990, 6990, 0 }, { 0, 27, 6992, 6992, 0 }, { 0, 27, 6994, 6994, 0 }, { 0, 27, 6996, 6996, 0 }, { 0, 27, 6998, 6998, 0 }, { 0, 27, 5309, 5309, 0 },
+  { 0, 27, 7000, 7000, 0 }, { 0, 27, 7002, 7002, 0 }, { 0, 27, 7004, 7004, 0 }, { 0, 27, 7006, 7006, 0 }, { 0, 27, 7008, 7008, 0 }, { 0, 27, 7010, 7010, 0 },
+  { 0, 27, 7012, 7012, 0 }, { 0, 27, 7014, 7014, 0 }, { 0, 27, 7016, 7016, 0 }, { 0, 27, 7018, 7018, 0 }, { 0, 27, 7020, 7020, 0 }, { 0, 27, 7022, 7022, 0 },
+  { 0, 27, 7024, 7024, 0 }, { 0, 27, 7026, 7026, 0 }, { 0, 27, 7028, 7028, 0 }, { 0, 27, 7030, 7030, 0 }, { 0, 27, 7032, 7032, 0 }, { 0, 27, 7034, 7034, 0 },
+  { 0, 27, 7036, 7036, 0 }, { 0, 27, 7038, 7038, 0 }, { 0, 27, 7040, 7040, 0 }, { 0, 27, 7042, 7042, 0 }, { 0, 27, 4408, 4408, 0 }, { 0, 27, 7044, 7044, 0 },
+  { 0, 27, 7046, 7046, 0 }, { 0, 27, 7048, 7048, 0 }, { 0, 27, 7050, 7050, 0 }, { 0, 27, 7052, 7052, 0 }, { 0, 27, 7054, 7054, 0 }, { 0, 27, 7056, 7056, 0 },
+  { 0, 27, 7058, 7058, 0 }, { 0, 27, 7060, 7060, 0 }, { 0, 27, 7062, 7062, 0 }, { 0, 27, 7064, 7064, 0 }, { 0, 27, 7066, 7066, 0 }, { 0, 27, 7068, 7068, 0 },
+  { 0, 27, 4310, 4310, 0 }, { 0, 27, 7070, 7070, 0 }, { 0, 27, 7072, 7072, 0 }, { 0, 27, 7074, 7074, 0 }, { 0, 27, 7076, 7076, 0 }, { 0, 27, 7078, 7078, 0 },
+  { 0, 27, 7080, 7080, 0 }, { 0, 27, 7082, 7082, 0 }, { 0, 27, 7084, 7084, 0 }, { 0, 27, 7086, 7086, 0 }, { 0, 27, 7088, 7088, 0 }, { 0, 27, 7090, 7090, 0 },
+  { 0, 27, 7092, 7092, 0 }, { 0, 27, 7094, 7094, 0 }, { 0, 27, 7096, 7096, 0 }, { 0, 27, 7098, 7098, 0 }, { 0, 27, 7100, 7100, 0 }, { 0, 27, 4364, 4364, 0 },
+  { 0, 27, 7102, 7102, 0 }, { 0, 27, 4370, 4370, 0 }, { 0, 27, 7104, 7104, 0 }, { 0, 27, 7106, 7106, 0 }, { 0, 27, 7108, 7108, 0 }, { 0, 27, 7110, 7110, 0 },
+  { 0, 27, 7112, 7112, 0 }, { 0, 27, 7114, 7114, 0 }, { 0, 27, 7116, 7116, 0 }, { 0, 27, 7118, 7118, 0 }, { 0, 27, 7120, 7120, 0 }, { 0, 27, 7122, 7122, 0 },
+  { 0, 27, 7124, 7124, 0 }, { 0, 27, 7126, 7126, 0 }, { 0, 27, 7128, 7128, 0 }, { 0, 27, 7130, 7130, 0 }, { 0, 27, 4324, 4324, 0 }, { 0, 27, 7132, 7132, 0 },
+  { 0, 27, 7134, 7134, 0 }, { 0, 27, 7136, 7136, 0 }, { 0, 27, 7138, 7138, 0 }, { 0, 27, 7140, 7140, 0 }, { 0, 27, 7142, 7142, 0 }, { 0, 27, 7144, 7144, 0 },
+  { 0, 27, 7146, 7146, 0 }, { 0, 27, 7148, 7148, 0 }, { 0, 27, 7150, 7150, 0 }, { 0, 27, 7152, 7152, 0 }, { 0, 27, 7154, 7154, 0 }, { 0, 27, 7156, 7156, 0 },
+  { 0, 27, 7158, 7158, 0 }, { 0, 27, 7160, 7160, 0 }, { 0, 27, 7162, 7162, 0 }, { 0, 27, 7164, 7164, 0 }, { 0, 27, 7166, 7166, 0 }, { 0, 27, 7168, 7168, 0 },
+  { 0, 27, 7170, 7170, 0 }, { 0, 27, 7172, 7172, 0 }, { 0, 27, 7174, 7174, 0 }, { 0, 27, 4166, 4166, 0 }, { 0, 27, 7176, 7176, 0 }, { 0, 27, 7178, 7178, 0 },
+  { 0, 27, 7180, 7180, 0 }, { 0, 27, 7182, 7182, 0 }, { 0, 27, 7184, 7184, 0 }, { 0, 27, 7186, 7186, 0 }, { 0, 27, 7188, 7188, 0 }, { 0, 27, 7190, 7190, 0 },
+  { 0, 27, 7192, 7192, 0 }, { 0, 27, 7194, 7194, 0 }, { 0, 27, 7196, 7196, 0 }, { 0, 27, 7198, 7198, 0 }, { 0, 27, 7200, 7200, 0 }, { 0, 27, 7202, 7202, 0 },
+  { 0, 27, 7204, 7204, 0 }, { 0, 27, 5319, 5319, 0 }, { 0, 27, 7206, 7206, 0 }, { 0, 27, 7208, 7208, 0 }, { 0, 27, 7210, 7210, 0 }, { 0, 27, 7212, 7212, 0 },
+  { 0, 27, 5327, 5327, 0 }, { 0, 27, 7214, 7214, 0 }, { 0, 27, 7216, 7216, 0 }, { 0, 27, 7218, 7218, 0 }, { 0, 27, 7220, 7220, 0 }, { 0, 27, 7222, 7222, 0 },
+  { 0, 27, 7224, 7224, 0 }, { 0, 27, 7226, 7226, 0 }, { 0, 27, 7228, 7228, 0 }, { 0, 27, 7230, 7230, 0 }, { 0, 27, 7232, 7232, 0 }, { 0, 27, 7234, 7234, 0 },
+  { 0, 27, 7236, 7236, 0 }, { 0, 27, 7238, 7238, 0 }, { 0, 27, 7240, 7240, 0 }, { 0, 27, 7242, 7242, 0 }, { 0, 27, 7244, 7244, 0 }, { 0, 27, 7246, 7246, 0 },
+  { 0, 27, 7248, 7248, 0 }, { 0, 27, 7250, 7250, 0 }, { 0, 27, 7252, 7252, 0 }, { 0, 27, 7254, 7254, 0 }, { 0, 27, 7256, 7256, 0 }, { 0, 27, 7258, 7258, 0 },
+  { 0, 27, 7260, 7260, 0 }, { 0, 27, 7262, 7262, 0 }, { 0, 27, 7264, 7264, 0 }, { 0, 27, 7266, 7266, 0 }, { 0, 27, 7268, 7268, 0 }, { 0, 27, 7270, 7270, 0 },
+  { 0, 27, 7272, 7272, 0 }, { 0, 27, 7274, 7274, 0 }, { 0, 27, 7276, 7276, 0 }, { 0, 27, 7278, 7278, 0 }, { 0, 27, 7280, 7280, 0 }, { 0, 27, 7282, 7282, 0 },
+  { 0, 27, 7284, 7284, 0 }, { 0, 27, 7286, 7286, 0 }, { 0, 27, 7288, 7288, 0 }, { 0, 27, 7290, 7290, 0 }, { 0, 27, 7292, 7292, 0 }, { 0, 27, 7294, 7294, 0 },
+  { 0, 27, 7296, 7296, 0 }, { 0, 27, 7298, 7298, 0 }, { 0, 27, 7300, 7300, 0 }, { 0, 27, 7302, 7302, 0 }, { 0, 27, 7304, 7304, 0 }, { 0, 27, 7306, 7306, 0 },
+  { 0, 27, 7308, 7308, 0 }, { 0, 27, 7310, 7310, 0 }, { 0, 27, 7312, 7312, 0 }, { 0, 27, 7314, 7314, 0 }, { 0, 27, 7316, 7316, 0 }, { 0, 27, 7318, 7318, 0 },
+  { 0, 27, 7320, 7320, 0 }, { 0, 27, 7322, 7322, 0 }, { 0, 27, 7324, 7324, 0 }, { 0, 27, 4232, 4232, 0 }, { 0, 27, 7326, 7326, 0 }, { 0, 27, 7328, 7328, 0 },
+  { 0, 27, 7330, 7330, 0 }, { 0, 27, 7332, 7332, 0 }, { 0, 27, 7334, 7334, 0 }, { 0, 27, 7336, 7336, 0 }, { 0, 27, 7338, 7338, 0 }, { 0, 27, 7340, 7340, 0 },
+  { 0, 27, 7342, 7342, 0 }, { 0, 27, 7344, 7344, 0 }, { 0, 27, 7346, 7346, 0 }, { 0, 27, 7348, 7348, 0 }, { 0, 27, 7350, 7350, 0 }, { 0, 27, 7352, 7352, 0 },
+  { 0, 27, 7354, 7354, 0 }, { 0, 27, 7356, 7356, 0 }, { 0, 27, 7358, 7358, 0 }, { 0, 27, 7360, 7360, 0 }, { 0, 27, 7362, 7362, 0 }, { 0, 27, 7364, 7364, 0 },
+  { 0, 27, 7366, 7366, 0 }, { 0, 27, 7368, 7368, 0 }, { 0, 27, 7370, 7370, 0 }, { 0, 27, 7372, 7372, 0 }, { 0, 27, 7374, 7374, 0 }, { 0, 27, 7376, 7376, 0 },
+  { 0, 27, 7378, 7378, 0 }, { 0, 27, 7380, 7380, 0 }, { 0, 27, 7382, 7382, 0 }, { 0, 27, 7384, 7384, 0 }, { 0, 27, 7386, 7386, 0 }, { 0, 27, 7388, 7388, 0 },
+  { 0, 27, 7390, 7390, 0 }, { 0, 27, 7392, 7392, 0 }, { 0, 27, 7394, 7394, 0 }, { 0, 27, 7396, 7396, 0 }, { 0, 27, 7398, 7398, 0 }, { 0, 27, 7400, 7400, 0 },
+  { 0, 27, 7402, 7402, 0 }, { 0, 27, 7404, 7404, 0 }, { 0, 27, 7406, 7406, 0 }, { 0, 27, 7408, 7408, 0 }, { 0, 27, 7410, 7410, 0 }, { 0, 27, 7412, 7412, 0 },
+  { 0, 27, 7414, 7414, 0 }, { 0, 27, 7416, 7416, 0 }, { 0, 27, 7418, 7418, 0 }, { 0, 27, 7420, 7420, 0 }, { 0, 24, 0, 7422, 0 }, { 0, 24, 0, 7425, 0 },
+  { 0, 24, 0, 7428, 0 }, { 0, 24, 0, 7431, 0 }, { 0, 24, 0, 7435, 0 }, { 0, 24, 0, 7439, 0 }, { 0, 24, 0, 7442, 0 }, { 0, 24, 0, 7445, 0 },
+  { 0, 24, 0, 7448, 0 }, { 0, 24, 0, 7451, 0 }, { 0, 24, 0, 7454, 0 }, { 0, 27, 7457, 7457, 0 }, { 26, 0, 0, 0, 0 }, { 0, 27, 7460, 7460, 0 },
+  { 0, 24, 0, 7463, 0 }, { 0, 24, 0, 7465, 0 }, { 0, 24, 0, 7467, 0 }, { 0, 24, 0, 7469, 0 }, { 0, 24, 0, 7471, 0 }, { 0, 24, 0, 7473, 0 },
+  { 0, 24, 0, 7475, 0 }, { 0, 27, 7477, 7477, 0 }, { 0, 27, 7480, 7480, 0 }, { 0, 27, 7483, 7483, 0 }, { 0, 27, 7487, 7487, 0 }, { 0, 27, 7491, 7491, 0 },
+  { 0, 27, 7494, 7494, 0 }, { 0, 27, 7497, 7497, 0 }, { 0, 27, 7500, 7500, 0 }, { 0, 27, 7503, 7503, 0 }, { 0, 27, 7506, 7506, 0 }, { 0, 27, 7509, 7509, 0 },
+  { 0, 27, 7512, 7512, 0 }, { 0, 27, 7515, 7515, 0 }, { 0, 27, 7518, 7518, 0 }, { 0, 27, 7521, 7521, 0 }, { 0, 27, 7524, 7524, 0 }, { 0, 27, 7527, 7527, 0 },
+  { 0, 27, 7530, 7530, 0 }, { 0, 27, 7533, 7533, 0 }, { 0, 27, 7536, 7536, 0 }, { 0, 27, 7539, 7539, 0 }, { 0, 27, 7542, 7542, 0 }, { 0, 27, 7545, 7545, 0 },
+  { 0, 27, 7548, 7548, 0 }, { 0, 27, 7551, 7551, 0 }, { 0, 27, 7554, 7554, 0 }, { 0, 27, 7557, 7557, 0 }, { 0, 27, 7560, 7560, 0 }, { 0, 27, 7563, 7563, 0 },
+  { 0, 27, 7566, 7566, 0 }, { 0, 27, 7569, 7569, 0 }, { 0, 27, 7572, 7572, 0 }, { 0, 24, 0, 7575, 0 }, { 0, 24, 0, 7578, 0 }, { 0, 24, 0, 7580, 0 },
+  { 0, 24, 0, 7582, 0 }, { 0, 24, 0, 7584, 0 }, { 0, 24, 0, 7586, 0 }, { 0, 24, 0, 7588, 0 }, { 0, 24, 0, 7590, 0 }, { 0, 24, 0, 7592, 0 },
+  { 0, 24, 0, 7594, 0 }, { 0, 24, 0, 7596, 0 }, { 0, 24, 0, 7598, 0 }, { 0, 24, 0, 7600, 0 }, { 0, 24, 0, 7602, 0 }, { 0, 24, 0, 7604, 0 },
+  { 0, 24, 0, 7606, 0 }, { 0, 24, 0, 7608, 0 }, { 0, 24, 0, 7610, 0 }, { 0, 24, 0, 7612, 0 }, { 0, 24, 0, 7614, 0 }, { 0, 24, 0, 7616, 0 },
+  { 0, 24, 0, 7618, 0 }, { 0, 24, 0, 7620, 0 }, { 0, 24, 0, 7622, 0 }, { 0, 24, 0, 7624, 0 }, { 0, 24, 0, 7626, 0 }, { 0, 24, 0, 1218, 0 },
+  { 0, 24, 0, 7628, 0 }, { 0, 24, 0, 7630, 0 }, { 0, 24, 0, 7632, 0 }, { 0, 24, 0, 1224, 0 }, { 0, 24, 0, 7634, 0 }, { 0, 24, 0, 7636, 0 },
+  { 0, 24, 0, 7638, 0 }, { 0, 24, 0, 7640, 0 }, { 0, 24, 0, 7642, 0 }, { 0, 24, 0, 7644, 0 }, { 0, 24, 0, 7646, 0 }, { 0, 24, 0, 7648, 0 },
+  { 0, 24, 0, 7650, 0 }, { 0, 24, 0, 7652, 0 }, { 0, 24, 0, 7656, 0 }, { 0, 24, 0, 7660, 0 }, { 0, 24, 0, 7664, 0 }, { 0, 24, 0, 7668, 0 },
+  { 0, 24, 0, 7672, 0 }, { 0, 24, 0, 7676, 0 }, { 0, 24, 0, 7680, 0 }, { 0, 24, 0, 7684, 0 }, { 0, 24, 0, 7686, 0 }, { 0, 24, 0, 7690, 0 },
+  { 0, 24, 0, 7694, 0 }, { 0, 24, 0, 7698, 0 }, { 0, 24, 0, 7702, 0 }, { 0, 24, 0, 7705, 0 }, { 0, 24, 0, 7708, 0 }, { 0, 24, 0, 7711, 0 },
+  { 0, 24, 0, 7714, 0 }, { 0, 24, 0, 7717, 0 }, { 0, 24, 0, 7720, 0 }, { 0, 24, 0, 7723, 0 }, { 0, 24, 0, 7726, 0 }, { 0, 24, 0, 7729, 0 },
+  { 0, 24, 0, 7732, 0 }, { 0, 24, 0, 7735, 0 }, { 0, 24, 0, 7738, 0 }, { 0, 24, 0, 7741, 0 }, { 0, 24, 0, 7744, 0 }, { 0, 24, 0, 7747, 0 },
+  { 0, 24, 0, 7750, 0 }, { 0, 24, 0, 7753, 0 }, { 0, 24, 0, 7756, 0 }, { 0, 24, 0, 7759, 0 }, { 0, 24, 0, 7762, 0 }, { 0, 24, 0, 7765, 0 },
+  { 0, 24, 0, 7768, 0 }, { 0, 24, 0, 7771, 0 }, { 0, 24, 0, 7774, 0 }, { 0, 24, 0, 7777, 0 }, { 0, 24, 0, 7780, 0 }, { 0, 24, 0, 7783, 0 },
+  { 0, 24, 0, 7786, 0 }, { 0, 24, 0, 7789, 0 }, { 0, 24, 0, 7792, 0 }, { 0, 24, 0, 7795, 0 }, { 0, 24, 0, 7798, 0 }, { 0, 24, 0, 7801, 0 },
+  { 0, 24, 0, 7804, 0 }, { 0, 24, 0, 7807, 0 }, { 0, 24, 0, 7810, 0 }, { 0, 24, 0, 7813, 0 }, { 0, 24, 0, 7816, 0 }, { 0, 24, 0, 7819, 0 },
+  { 0, 24, 0, 7822, 0 }, { 0, 24, 0, 7825, 0 }, { 0, 24, 0, 7828, 0 }, { 0, 24, 0, 7831, 0 }, { 0, 24, 0, 7834, 0 }, { 0, 24, 0, 7837, 0 },
+  { 0, 24, 0, 7840, 0 }, { 0, 24, 0, 7843, 0 }, { 0, 24, 0, 7846, 0 }, { 0, 24, 0, 7849, 0 }, { 0, 24, 0, 7852, 0 }, { 0, 24, 0, 7855, 0 },
+  { 0, 24, 0, 7858, 0 }, { 0, 24, 0, 7861, 0 }, { 0, 24, 0, 7864, 0 }, { 0, 24, 0, 7867, 0 }, { 0, 24, 0, 7870, 0 }, { 0, 24, 0, 7873, 0 },
+  { 0, 24, 0, 7876, 0 }, { 0, 24, 0, 7879, 0 }, { 0, 24, 0, 7882, 0 }, { 0, 24, 0, 7885, 0 }, { 0, 24, 0, 7888, 0 }, { 0, 24, 0, 7891, 0 },
+  { 0, 24, 0, 7894, 0 }, { 0, 24, 0, 7897, 0 }, { 0, 24, 0, 7900, 0 }, { 0, 24, 0, 7903, 0 }, { 0, 24, 0, 7906, 0 }, { 0, 24, 0, 7909, 0 },
+  { 0, 24, 0, 7912, 0 }, { 0, 24, 0, 7915, 0 }, { 0, 24, 0, 7918, 0 }, { 0, 24, 0, 7921, 0 }, { 0, 24, 0, 7924, 0 }, { 0, 24, 0, 7927, 0 },
+  { 0, 24, 0, 7930, 0 }, { 0, 24, 0, 7933, 0 }, { 0, 24, 0, 7936, 0 }, { 0, 24, 0, 7939, 0 }, { 0, 24, 0, 7942, 0 }, { 0, 24, 0, 7945, 0 },
+  { 0, 24, 0, 7948, 0 }, { 0, 24, 0, 7951, 0 }, { 0, 24, 0, 7954, 0 }, { 0, 24, 0, 7957, 0 }, { 0, 24, 0, 7960, 0 }, { 0, 24, 0, 7963, 0 },
+  { 0, 24, 0, 7966, 0 }, { 0, 24, 0, 7969, 0 }, { 0, 24, 0, 7973, 0 }, { 0, 24, 0, 7977, 0 }, { 0, 24, 0, 7981, 0 }, { 0, 24, 0, 7985, 0 },
+  { 0, 24, 0, 7989, 0 }, { 0, 24, 0, 7993, 0 }, { 0, 24, 0, 7997, 0 }, { 0, 24, 0, 8001, 0 }, { 0, 24, 0, 8005, 0 }, { 0, 24, 0, 8008, 0 },
+  { 0, 24, 0, 8011, 0 }, { 0, 24, 0, 8014, 0 }, { 0, 24, 0, 8017, 0 }, { 0, 24, 0, 8020, 0 }, { 0, 24, 0, 8023, 0 }, { 0, 24, 0, 8026, 0 },
+  { 0, 24, 0, 8029, 0 }, { 0, 24, 0, 8032, 0 }, { 0, 24, 0, 8035, 0 }, { 0, 24, 0, 8038, 0 }, { 0, 24, 0, 8041, 0 }, { 0, 24, 0, 8044, 0 },
+  { 0, 24, 0, 8047, 0 }, { 0, 24, 0, 8050, 0 }, { 0, 24, 0, 8053, 0 }, { 0, 24, 0, 8057, 0 }, { 0, 24, 0, 8061, 0 }, { 0, 24, 0, 8064, 0 },
+  { 0, 24, 0, 8067, 0 }, { 0, 24, 0, 8070, 0 }, { 0, 24, 0, 8073, 0 }, { 0, 24, 0, 8076, 0 }, { 0, 24, 0, 8079, 0 }, { 0, 24, 0, 8082, 0 },
+  { 0, 24, 0, 8085, 0 }, { 0, 24, 0, 8088, 0 }, { 0, 24, 0, 8091, 0 }, { 0, 24, 0, 8094, 0 }, { 0, 24, 0, 8098, 0 }, { 0, 24, 0, 8102, 0 },
+  { 0, 24, 0, 8106, 0 }, { 0, 24, 0, 8109, 0 }, { 0, 24, 0, 8112, 0 }, { 0, 24, 0, 8115, 0 }, { 0, 24, 0, 8118, 0 }, { 0, 24, 0, 8121, 0 },
+  { 0, 24, 0, 8124, 0 }, { 0, 24, 0, 8127, 0 }, { 0, 24, 0, 8130, 0 }, { 0, 24, 0, 8133, 0 }, { 0, 24, 0, 8136, 0 }, { 0, 24, 0, 8139, 0 },
+  { 0, 24, 0, 8142, 0 }, { 0, 24, 0, 8145, 0 }, { 0, 24, 0, 8148, 0 }, { 0, 24, 0, 8151, 0 }, { 0, 24, 0, 8154, 0 }, { 0, 24, 0, 8157, 0 },
+  { 0, 24, 0, 8160, 0 }, { 0, 24, 0, 8163, 0 }, { 0, 24, 0, 8166, 0 }, { 0, 24, 0, 8169, 0 }, { 0, 24, 0, 8172, 0 }, { 0, 24, 0, 8175, 0 },
+  { 0, 24, 0, 8178, 0 }, { 0, 24, 0, 8181, 0 }, { 0, 24, 0, 8184, 0 }, { 0, 24, 0, 8187, 0 }, { 0, 24, 0, 8190, 0 }, { 0, 24, 0, 8194, 0 },
+  { 0, 24, 0, 8198, 0 }, { 0, 24, 0, 8202, 0 }, { 0, 24, 0, 8206, 0 }, { 0, 24, 0, 8210, 0 }, { 0, 24, 0, 8214, 0 }, { 0, 24, 0, 8218, 0 },
+  { 0, 24, 0, 8222, 0 }, { 0, 24, 0, 8226, 0 }, { 0, 24, 0, 8230, 0 }, { 0, 24, 0, 8234, 0 }, { 0, 24, 0, 8238, 0 }, { 0, 24, 0, 8242, 0 },
+  { 0, 24, 0, 8246, 0 }, { 0, 24, 0, 8250, 0 }, { 0, 24, 0, 8254, 0 }, { 0, 24, 0, 8258, 0 }, { 0, 24, 0, 8262, 0 }, { 0, 24, 0, 8266, 0 },
+  { 0, 24, 0, 8270, 0 }, { 0, 24, 0, 8274, 0 }, { 0, 24, 0, 8278, 0 }, { 0, 24, 0, 8282, 0 }, { 0, 24, 0, 8286, 0 }, { 0, 24, 0, 8290, 0 },
+  { 0, 24, 0, 8294, 0 }, { 0, 24, 0, 8298, 0 }, { 0, 24, 0, 8302, 0 }, { 0, 24, 0, 8306, 0 }, { 0, 24, 0, 8310, 0 }, { 0, 24, 0, 8314, 0 },
+  { 0, 24, 0, 8318, 0 }, { 0, 24, 0, 8322, 0 }, { 0, 24, 0, 8326, 0 }, { 0, 24, 0, 8330, 0 }, { 0, 24, 0, 8334, 0 }, { 0, 24, 0, 8338, 0 },
+  { 0, 24, 0, 8342, 0 }, { 0, 24, 0, 8346, 0 }, { 0, 24, 0, 8350, 0 }, { 0, 24, 0, 8354, 0 }, { 0, 24, 0, 8358, 0 }, { 0, 24, 0, 8362, 0 },
+  { 0, 24, 0, 8366, 0 }, { 0, 24, 0, 8370, 0 }, { 0, 24, 0, 8374, 0 }, { 0, 24, 0, 8378, 0 }, { 0, 24, 0, 8382, 0 }, { 0, 24, 0, 8386, 0 },
+  { 0, 24, 0, 8390, 0 }, { 0, 24, 0, 8394, 0 }, { 0, 24, 0, 8398, 0 }, { 0, 24, 0, 8402, 0 }, { 0, 24, 0, 8406, 0 }, { 0, 24, 0, 8410, 0 },
+  { 0, 24, 0, 8414, 0 }, { 0, 24, 0, 8418, 0 }, { 0, 24, 0, 8422, 0 }, { 0, 24, 0, 8426, 0 }, { 0, 24, 0, 8430, 0 }, { 0, 24, 0, 8434, 0 },
+  { 0, 24, 0, 8438, 0 }, { 0, 24, 0, 8442, 0 }, { 0, 24, 0, 8446, 0 }, { 0, 24, 0, 8450, 0 }, { 0, 24, 0, 8454, 0 }, { 0, 24, 0, 8458, 0 },
+  { 0, 24, 0, 8462, 0 }, { 0, 24, 0, 8466, 0 }, { 0, 24, 0, 8470, 0 }, { 0, 24, 0, 8474, 0 }, { 0, 24, 0, 8478, 0 }, { 0, 24, 0, 8482, 0 },
+  { 0, 24, 0, 8486, 0 }, { 0, 24, 0, 8490, 0 }, { 0, 24, 0, 8494, 0 }, { 0, 24, 0, 8498, 0 }, { 0, 24, 0, 8502, 0 }, { 0, 24, 0, 8506, 0 },
+  { 0, 24, 0, 8510, 0 }, { 0, 24, 0, 8514, 0 }, { 0, 24, 0, 8518, 0 }, { 0, 24, 0, 8522, 0 }, { 0, 24, 0, 8526, 0 }, { 0, 24, 0, 8530, 0 },
+  { 0, 24, 0, 8534, 0 }, { 0, 24, 0, 8538, 0 }, { 0, 24, 0, 8542, 0 }, { 0, 24, 0, 8546, 0 }, { 0, 24, 0, 8550, 0 }, { 0, 24, 0, 8554, 0 },
+  { 0, 24, 0, 8558, 0 }, { 0, 24, 0, 8562, 0 }, { 0, 24, 0, 8566, 0 }, { 0, 24, 0, 8570, 0 }, { 0, 24, 0, 8574, 0 }, { 0, 24, 0, 8579, 0 },
+  { 0, 24, 0, 8584, 0 }, { 0, 24, 0, 8589, 0 }, { 0, 24, 0, 8594, 0 }, { 0, 24, 0, 8599, 0 }, { 0, 24, 0, 8604, 0 }, { 0, 24, 0, 8609, 0 },
+  { 0, 24, 0, 8613, 0 }, { 0, 24, 0, 8632, 0 }, { 0, 24, 0, 8641, 0 }, { 0, 24, 0, 8646, 0 }, { 0, 24, 0, 8648, 0 }, { 0, 24, 0, 8650, 0 },
+  { 0, 24, 0, 8652, 0 }, { 0, 24, 0, 931, 0 }, { 0, 24, 0, 8654, 0 }, { 0, 24, 0, 8656, 0 }, { 0, 24, 0, 8658, 0 }, { 0, 24, 0, 8660, 0 },
+  { 0, 24, 0, 8662, 0 }, { 0, 24, 0, 8664, 0 }, { 0, 24, 0, 8666, 0 }, { 0, 24, 0, 8668, 0 }, { 0, 24, 0, 8670, 0 }, { 0, 24, 0, 8672, 0 },
+  { 0, 24, 0, 8674, 0 }, { 0, 24, 0, 8676, 0 }, { 0, 24, 0, 8678, 0 }, { 0, 24, 0, 8680, 0 }, { 0, 24, 0, 8682, 0 }, { 0, 24, 0, 3744, 0 },
+  { 0, 24, 0, 3746, 0 }, { 0, 24, 0, 8684, 0 }, { 0, 24, 0, 8686, 0 }, { 0, 24, 0, 8688, 0 }, { 0, 24, 0, 8690, 0 }, { 0, 24, 0, 8692, 0 },
+  { 0, 24, 0, 8694, 0 }, { 0, 24, 0, 8696, 0 }, { 0, 24, 0, 8698, 0 }, { 0, 24, 0, 8700, 0 }, { 0, 24, 0, 8702, 0 }, { 0, 24, 0, 8704, 0 },
+  { 0, 24, 0, 8706, 0 }, { 0, 24, 0, 8708, 0 }, { 0, 24, 0, 8710, 0 }, { 0, 24, 0, 8712, 0 }, { 0, 24, 0, 8714, 0 }, { 0, 24, 0, 8716, 0 },
+  { 0, 24, 0, 8719, 0 }, { 0, 24, 0, 8722, 0 }, { 0, 24, 0, 8725, 0 }, { 0, 24, 0, 8728, 0 }, { 0, 24, 0, 8731, 0 }, { 0, 24, 0, 8734, 0 },
+  { 0, 24, 0, 8737, 0 }, { 0, 24, 0, 8740, 0 }, { 0, 24, 0, 8743, 0 }, { 0, 24, 0, 8746, 0 }, { 0, 24, 0, 8749, 0 }, { 0, 24, 0, 8752, 0 },
+  { 0, 24, 0, 8755, 0 }, { 0, 24, 0, 8758, 0 }, { 0, 24, 0, 1191, 0 }, { 0, 24, 0, 1194, 0 }, { 0, 24, 0, 1197, 0 }, { 0, 24, 0, 1200, 0 },
+  { 0, 24, 0, 1203, 0 }, { 0, 24, 0, 8760, 0 }, { 0, 24, 0, 8762, 0 }, { 0, 24, 0, 8764, 0 }, { 0, 24, 0, 8766, 0 }, { 0, 24, 0, 8768, 0 },
+  { 0, 24, 0, 8770, 0 }, { 0, 24, 0, 8772, 0 }, { 0, 24, 0, 8774, 0 }, { 0, 24, 0, 8776, 0 }, { 0, 24, 0, 8778, 0 }, { 0, 24, 0, 8780, 0 },
+  { 0, 24, 0, 8782, 0 }, { 0, 24, 0, 8784, 0 }, { 0, 24, 0, 8786, 0 }, { 0, 24, 0, 8788, 0 }, { 0, 24, 0, 8790, 0 }, { 0, 24, 0, 8792, 0 },
+  { 0, 24, 0, 8794, 0 }, { 0, 24, 0, 8796, 0 }, { 0, 24, 0, 8798, 0 }, { 0, 24, 0, 8800, 0 }, { 0, 24, 0, 8802, 0 }, { 0, 24, 0, 8804, 0 },
+  { 0, 24, 0, 8806, 0 }, { 0, 24, 0, 8808, 0 }, { 0, 24, 0, 8810, 0 }, { 0, 24, 0, 8812, 0 }, { 0, 24, 0, 8814, 0 }, { 0, 24, 0, 8816, 0 },
+  { 0, 24, 0, 8818, 0 }, { 0, 24, 0, 8822, 0 }, { 0, 24, 0, 8826, 0 }, { 0, 24, 0, 8830, 0 }, { 0, 24, 0, 8833, 0 }, { 0, 24, 0, 8835, 0 },
+  { 0, 24, 0, 8837, 0 }, { 0, 24, 0, 8839, 0 }, { 0, 24, 0, 3280, 0 }, { 0, 24, 0, 8841, 0 }, { 0, 24, 0, 8843, 0 }, { 0, 24, 0, 8845, 0 },
+  { 0, 24, 0, 8847, 0 }, { 0, 24, 0, 8849, 0 }, { 0, 24, 0, 8851, 0 }, { 0, 24, 0, 8853, 0 }, { 0, 24, 0, 8855, 0 }, { 0, 24, 0, 8857, 0 },
+  { 0, 24, 0, 8859, 0 }, { 0, 24, 0, 8861, 0 }, { 0, 24, 0, 8863, 0 }, { 0, 24, 0, 8865, 0 }, { 0, 24, 0, 8867, 0 }, { 0, 24, 0, 8869, 0 },
+  { 0, 24, 0, 8871, 0 }, { 0, 24, 0, 8873, 0 }, { 0, 24, 0, 8875, 0 }, { 0, 24, 0, 8877, 0 }, { 0, 24, 0, 8879, 0 }, { 0, 24, 0, 8881, 0 },
+  { 0, 24, 0, 8883, 0 }, { 0, 24, 0, 8885, 0 }, { 0, 24, 0, 8887, 0 }, { 0, 24, 0, 8889, 0 }, { 0, 24, 0, 8891, 0 }, { 0, 24, 0, 8893, 0 },
+  { 0, 24, 0, 8895, 0 }, { 0, 24, 0, 8897, 0 }, { 0, 24, 0, 8899, 0 }, { 0, 24, 0, 8901, 0 }, { 0, 24, 0, 8903, 0 }, { 0, 24, 0, 8905, 0 },
+  { 0, 24, 0, 8907, 0 }, { 0, 24, 0, 8909, 0 }, { 0, 24, 0, 8911, 0 }, { 0, 24, 0, 8913, 0 }, { 0, 24, 0, 8915, 0 }, { 0, 24, 0, 8917, 0 },
+  { 0, 24, 0, 8919, 0 }, { 0, 24, 0, 8921, 0 }, { 0, 24, 0, 8923, 0 }, { 0, 24, 0, 8925, 0 }, { 0, 24, 0, 8927, 0 }, { 0, 24, 0, 8929, 0 },
+  { 0, 24, 0, 8931, 0 }, { 0, 24, 0, 8933, 0 }, { 0, 24, 0, 8935, 0 }, { 0, 24, 0, 8937, 0 }, { 0, 24, 0, 8939, 0 }, { 0, 24, 0, 8941, 0 },
+  { 0, 24, 0, 8943, 0 }, { 0, 24, 0, 8945, 0 }, { 0, 24, 0, 8947, 0 }, { 0, 24, 0, 8949, 0 }, { 0, 24, 0, 8951, 0 }, { 0, 24, 0, 8953, 0 },
+  { 0, 24, 0, 8955, 0 }, { 0, 24, 0, 8957, 0 }, { 0, 24, 0, 8959, 0 }, { 0, 24, 0, 8961, 0 }, { 0, 24, 0, 8963, 0 }, { 0, 24, 0, 8965, 0 },
+  { 0, 24, 0, 8967, 0 }, { 0, 24, 0, 8969, 0 }, { 0, 24, 0, 8971, 0 }, { 0, 24, 0, 8973, 0 }, { 0, 24, 0, 8975, 0 }, { 0, 24, 0, 8977, 0 },
+  { 0, 24, 0, 8979, 0 }, { 0, 24, 0, 8981, 0 }, { 0, 24, 0, 8983, 0 }, { 0, 24, 0, 8985, 0 }, { 0, 24, 0, 8987, 0 }, { 0, 24, 0, 8989, 0 },
+  { 0, 24, 0, 8991, 0 }, { 0, 24, 0, 8993, 0 }, { 0, 24, 0, 8995, 0 }, { 0, 24, 0, 8997, 0 }, { 0, 24, 0, 8999, 0 }, { 0, 24, 0, 9001, 0 },
+  { 0, 24, 0, 9003, 0 }, { 0, 24, 0, 9005, 0 }, { 0, 24, 0, 9007, 0 }, { 0, 24, 0, 9009, 0 }, { 0, 0, 0, 0, 2224 }, { 0, 9, 9011, 9011, 0 },
+  { 0, 0, 0, 0, 2227 }, { 0, 9, 9014, 9014, 0 }, { 0, 0, 0, 0, 2230 }, { 0, 9, 9017, 9017, 0 }, { 0, 9, 9020, 9020, 0 }, { 0, 9, 9023, 9023, 0 },
+  { 0, 0, 0, 0, 2233 }, { 0, 0, 0, 0, 2236 }, { 0, 0, 0, 0, 2239 }, { 0, 9, 9026, 9026, 0 }, { 0, 9, 9029, 9029, 0 }, { 0, 0, 0, 0, 2244 },
+  { 0, 9, 9032, 9032, 0 }, { 0, 9, 9035, 9035, 0 }, { 0, 9, 9038, 9038, 0 }, { 0, 0, 0, 0, 2251 }, { 0, 0, 0, 0, 2254 }, { 0, 9, 9041, 9041, 0 },
+  { 0, 9, 9044, 9044, 0 }, { 0, 0, 0, 0, 2257 }, { 0, 9, 9047, 9047, 0 }, { 6, 0, 0, 0, 0 }, { 0, 27, 9050, 9050, 0 }, { 0, 27, 9053, 9053, 0 },
+  { 0, 27, 9056, 9056, 0 }, { 0, 27, 9060, 9060, 0 }, { 0, 27, 9064, 9064, 0 }, { 0, 27, 9068, 9068, 0 }, { 0, 27, 9072, 9072, 0 }, { 226, 0, 0, 0, 0 },
+  { 0, 27, 9076, 9076, 0 }, { 0, 27, 9079, 9079, 0 }, { 0, 27, 9082, 9082, 0 }, { 0, 27, 9086, 9086, 0 }, { 0, 27, 9090, 9090, 0 }, { 0, 27, 9094, 9094, 0 },
+  { 0, 24, 0, 9098, 0 }, { 0, 24, 0, 9100, 0 }, { 0, 24, 0, 9102, 0 }, { 0, 24, 0, 9104, 0 }, { 0, 24, 0, 9106, 0 }, { 0, 24, 0, 9108, 0 },
+  { 0, 24, 0, 9110, 0 }, { 0, 24, 0, 9112, 0 }, { 0, 24, 0, 9114, 0 }, { 0, 24, 0, 9116, 0 }, { 0, 24, 0, 9118, 0 }, { 0, 24, 0, 9120, 0 },
+  { 0, 24, 0, 9122, 0 }, { 0, 24, 0, 9124, 0 }, { 0, 24, 0, 9126, 0 }, { 0, 24, 0, 9128, 0 }, { 0, 24, 0, 9130, 0 }, { 0, 24, 0, 1008, 0 },
+  { 0, 24, 0, 9132, 0 }, { 0, 24, 0, 9134, 0 }, { 0, 24, 0, 9136, 0 }, { 0, 24, 0, 3440, 0 }, { 0, 24, 0, 9138, 0 }, { 0, 24, 0, 9140, 0 },
+  { 0, 24, 0, 9142, 0 }, { 0, 24, 0, 9144, 0 }, { 0, 24, 0, 3131, 0 }, { 0, 24, 0, 9146, 0 }, { 0, 24, 0, 9148, 0 }, { 0, 24, 0, 9150, 0 },
+  { 0, 24, 0, 9152, 0 }, { 0, 24, 0, 9154, 0 }, { 0, 24, 0, 9156, 0 }, { 0, 24, 0, 9158, 0 }, { 0, 24, 0, 9160, 0 }, { 0, 24, 0, 9162, 0 },
+  { 0, 24, 0, 9164, 0 }, { 0, 24, 0, 9166, 0 }, { 0, 24, 0, 9168, 0 }, { 0, 24, 0, 9170, 0 }, { 0, 24, 0, 9172, 0 }, { 0, 24, 0, 9174, 0 },
+  { 0, 24, 0, 9176, 0 }, { 0, 24, 0, 9178, 0 }, { 0, 24, 0, 9180, 0 }, { 0, 24, 0, 9182, 0 }, { 0, 24, 0, 9184, 0 }, { 0, 24, 0, 9186, 0 },
+  { 0, 24, 0, 9188, 0 }, { 0, 24, 0, 9190, 0 }, { 0, 24, 0, 9192, 0 }, { 0, 24, 0, 9194, 0 }, { 0, 24, 0, 9196, 0 }, { 0, 24, 0, 9198, 0 },
+  { 0, 24, 0, 9200, 0 }, { 0, 24, 0, 9202, 0 }, { 0, 24, 0, 9204, 0 }, { 0, 24, 0, 9206, 0 }, { 0, 24, 0, 9208, 0 }, { 0, 24, 0, 9210, 0 },
+  { 0, 24, 0, 9212, 0 }, { 0, 24, 0, 9214, 0 }, { 0, 24, 0, 9216, 0 }, { 0, 24, 0, 9218, 0 }, { 0, 24, 0, 9220, 0 }, { 0, 24, 0, 9222, 0 },
+  { 0, 24, 0, 9224, 0 }, { 0, 24, 0, 9226, 0 }, { 0, 24, 0, 9228, 0 }, { 0, 24, 0, 9230, 0 }, { 0, 24, 0, 9232, 0 }, { 0, 24, 0, 9234, 0 },
+  { 0, 24, 0, 9236, 0 }, { 0, 24, 0, 9238, 0 }, { 0, 24, 0, 9240, 0 }, { 0, 24, 0, 9242, 0 }, { 0, 24, 0, 9244, 0 }, { 0, 24, 0, 9246, 0 },
+  { 0, 24, 0, 9248, 0 }, { 0, 24, 0, 9250, 0 }, { 0, 24, 0, 9252, 0 }, { 0, 24, 0, 9254, 0 }, { 0, 24, 0, 9257, 0 }, { 0, 24, 0, 9260, 0 },
+  { 0, 24, 0, 9263, 0 }, { 0, 24, 0, 9266, 0 }, { 0, 24, 0, 9269, 0 }, { 0, 24, 0, 9272, 0 }, { 0, 24, 0, 9275, 0 }, { 0, 24, 0, 9278, 0 },
+  { 0, 24, 0, 9281, 0 }, { 0, 24, 0, 9284, 0 }, { 0, 24, 0, 9287, 0 }, { 0, 24, 0, 9291, 0 }, { 0, 24, 0, 9295, 0 }, { 0, 24, 0, 9299, 0 },
+  { 0, 24, 0, 9303, 0 }, { 0, 24, 0, 9307, 0 }, { 0, 24, 0, 9311, 0 }, { 0, 24, 0, 9315, 0 }, { 0, 24, 0, 9319, 0 }, { 0, 24, 0, 9323, 0 },
+  { 0, 24, 0, 9327, 0 }, { 0, 24, 0, 9331, 0 }, { 0, 24, 0, 9335, 0 }, { 0, 24, 0, 9339, 0 }, { 0, 24, 0, 9343, 0 }, { 0, 24, 0, 9347, 0 },
+  { 0, 24, 0, 9351, 0 }, { 0, 24, 0, 9355, 0 }, { 0, 24, 0, 9359, 0 }, { 0, 24, 0, 9363, 0 }, { 0, 24, 0, 9367, 0 }, { 0, 24, 0, 9371, 0 },
+  { 0, 24, 0, 9375, 0 }, { 0, 24, 0, 9379, 0 }, { 0, 24, 0, 9383, 0 }, { 0, 24, 0, 9387, 0 }, { 0, 24, 0, 9391, 0 }, { 0, 24, 0, 9395, 0 },
+  { 0, 24, 0, 9398, 0 }, { 0, 24, 0, 9401, 0 }, { 0, 24, 0, 9404, 0 }, { 0, 24, 0, 9407, 0 }, { 0, 24, 0, 9410, 0 }, { 0, 24, 0, 9414, 0 },
+  { 0, 24, 0, 9417, 0 }, { 0, 24, 0, 9420, 0 }, { 0, 24, 0, 9423, 0 }, { 0, 24, 0, 9426, 0 }, { 0, 24, 0, 9429, 0 }, { 0, 24, 0, 9432, 0 },
+  { 0, 24, 0, 9435, 0 }, { 0, 24, 0, 9437, 0 }, { 0, 24, 0, 4641, 0 }, { 0, 24, 0, 9439, 0 }, { 0, 24, 0, 9441, 0 }, { 0, 24, 0, 9443, 0 },
+  { 0, 24, 0, 9445, 0 }, { 0, 24, 0, 9447, 0 }, { 0, 24, 0, 6966, 0 }, { 0, 24, 0, 9449, 0 }, { 0, 24, 0, 9451, 0 }, { 0, 24, 0, 9453, 0 },
+  { 0, 24, 0, 9455, 0 }, { 0, 24, 0, 9457, 0 }, { 0, 24, 0, 9459, 0 }, { 0, 24, 0, 9461, 0 }, { 0, 24, 0, 9463, 0 }, { 0, 24, 0, 9465, 0 },
+  { 0, 24, 0, 9467, 0 }, { 0, 24, 0, 9469, 0 }, { 0, 24, 0, 9471, 0 }, { 0, 24, 0, 9473, 0 }, { 0, 24, 0, 9475, 0 }, { 0, 24, 0, 9477, 0 },
+  { 0, 24, 0, 9479, 0 }, { 0, 24, 0, 9481, 0 }, { 0, 24, 0, 9483, 0 }, { 0, 24, 0, 9485, 0 }, { 0, 24, 0, 9487, 0 }, { 0, 24, 0, 9489, 0 },
+  { 0, 24, 0, 9491, 0 }, { 0, 24, 0, 9493, 0 }, { 0, 24, 0, 9495, 0 }, { 0, 24, 0, 9499, 0 }, { 0, 24, 0, 9503, 0 }, { 0, 24, 0, 9507, 0 },
+  { 0, 24, 0, 9511, 0 }, { 0, 24, 0, 9515, 0 }, { 0, 24, 0, 9519, 0 }, { 0, 24, 0, 9523, 0 }, { 0, 24, 0, 9527, 0 }, { 0, 24, 0, 9531, 0 },
+  { 0, 24, 0, 9533, 0 }, { 0, 27, 9535, 9535, 0 }, { 0, 27, 9537, 9537, 0 }, { 0, 27, 9539, 9539, 0 }, { 0, 27, 9541, 9541, 0 }, { 0, 27, 9543, 9543, 0 },
+  { 0, 27, 9545, 9545, 0 }, { 0, 27, 9547, 9547, 0 }, { 0, 27, 9549, 9549, 0 }, { 0, 27, 9551, 9551, 0 }, { 0, 27, 9553, 9553, 0 }, { 0, 27, 9555, 9555, 0 },
+  { 0, 27, 9557, 9557, 0 }, { 0, 27, 9559, 9559, 0 }, { 0, 27, 9561, 9561, 0 }, { 0, 27, 9563, 9563, 0 }, { 0, 27, 9565, 9565, 0 }, { 0, 27, 9567, 9567, 0 },
+  { 0, 27, 9569, 9569, 0 }, { 0, 27, 9453, 9453, 0 }, { 0, 27, 9571, 9571, 0 }, { 0, 27, 9573, 9573, 0 }, { 0, 27, 9575, 9575, 0 }, { 0, 27, 9577, 9577, 0 },
+  { 0, 27, 9579, 9579, 0 }, { 0, 27, 9581, 9581, 0 }, { 0, 27, 4110, 4110, 0 }, { 0, 27, 9583, 9583, 0 }, { 0, 27, 9585, 9585, 0 }, { 0, 27, 9587, 9587, 0 },
+  { 0, 27, 9589, 9589, 0 }, { 0, 27, 9489, 9489, 0 }, { 0, 27, 9591, 9591, 0 }, { 0, 27, 9593, 9593, 0 }, { 0, 27, 9595, 9595, 0 }, { 0, 27, 9597, 9597, 0 },
+  { 0, 27, 9599, 9599, 0 }, { 0, 27, 9601, 9601, 0 }, { 0, 27, 9603, 9603, 0 }, { 0, 27, 9605, 9605, 0 }, { 0, 27, 9607, 9607, 0 }, { 0, 27, 9609, 9609, 0 },
+  { 0, 27, 9611, 9611, 0 }, { 0, 27, 9613, 9613, 0 }, { 0, 27, 9615, 9615, 0 }, { 0, 27, 9617, 9617, 0 }, { 0, 27, 9619, 9619, 0 }, { 0, 27, 9621, 9621, 0 },
+  { 0, 27, 9623, 9623, 0 }, { 0, 27, 9625, 9625, 0 }, { 0, 27, 9627, 9627, 0 }, { 0, 27, 9629, 9629, 0 }, { 0, 27, 9631, 9631, 0 }, { 0, 27, 9633, 9633, 0 },
+  { 0, 27, 9635, 9635, 0 }, { 0, 27, 9637, 9637, 0 }, { 0, 27, 9639, 9639, 0 }, { 0, 27, 9641, 9641, 0 }, { 0, 27, 9643, 9643, 0 }, { 0, 27, 9645, 9645, 0 },
+  { 0, 27, 9647, 9647, 0 }, { 0, 27, 9649, 9649, 0 }, { 0, 27, 9651, 9651, 0 }, { 0, 27, 9653, 9653, 0 }, { 0, 27, 9655, 9655, 0 }, { 0, 27, 9657, 9657, 0 },
+  { 0, 27, 9659, 9659, 0 }, { 0, 27, 9661, 9661, 0 }, { 0, 27, 9663, 9663, 0 }, { 0, 27, 9665, 9665, 0 }, { 0, 27, 9667, 9667, 0 }, { 0, 27, 9669, 9669, 0 },
+  { 0, 27, 9671, 9671, 0 }, { 0, 27, 9673, 9673, 0 }, { 0, 27, 9675, 9675, 0 }, { 0, 27, 9677, 9677, 0 }, { 0, 27, 9679, 9679, 0 }, { 0, 27, 9681, 9681, 0 },
+  { 0, 27, 9439, 9439, 0 }, { 0, 27, 9683, 9683, 0 }, { 0, 27, 9685, 9685, 0 }, { 0, 27, 9687, 9687, 0 }, { 0, 27, 9689, 9689, 0 }, { 0, 27, 9691, 9691, 0 },
+  { 0, 27, 9693, 9693, 0 }, { 0, 27, 9695, 9695, 0 }, { 0, 27, 9697, 9697, 0 }, { 0, 27, 9699, 9699, 0 }, { 0, 27, 9701, 9701, 0 }, { 0, 27, 9703, 9703, 0 },
+  { 0, 27, 9705, 9705, 0 }, { 0, 27, 9707, 9707, 0 }, { 0, 27, 9709, 9709, 0 }, { 0, 27, 9711, 9711, 0 }, { 0, 27, 9713, 9713, 0 }, { 0, 27, 9715, 9715, 0 },
+  { 0, 27, 9717, 9717, 0 }, { 0, 27, 9719, 9719, 0 }, { 0, 27, 9721, 9721, 0 }, { 0, 27, 9723, 9723, 0 }, { 0, 27, 4162, 4162, 0 }, { 0, 27, 9725, 9725, 0 },
+  { 0, 27, 9727, 9727, 0 }, { 0, 27, 9729, 9729, 0 }, { 0, 27, 9731, 9731, 0 }, { 0, 27, 9733, 9733, 0 }, { 0, 27, 9735, 9735, 0 }, { 0, 27, 9737, 9737, 0 },
+  { 0, 27, 9739, 9739, 0 }, { 0, 27, 9741, 9741, 0 }, { 0, 27, 9743, 9743, 0 }, { 0, 27, 9745, 9745, 0 }, { 0, 27, 9747, 9747, 0 }, { 0, 27, 9749, 9749, 0 },
+  { 0, 27, 9751, 9751, 0 }, { 0, 27, 9753, 9753, 0 }, { 0, 27, 9755, 9755, 0 }, { 0, 27, 9757, 9757, 0 }, { 0, 27, 9759, 9759, 0 }, { 0, 27, 9761, 9761, 0 },
+  { 0, 27, 9763, 9763, 0 }, { 0, 27, 9765, 9765, 0 }, { 0, 27, 9767, 9767, 0 }, { 0, 27, 9769, 9769, 0 }, { 0, 27, 9771, 9771, 0 }, { 0, 27, 4186, 4186, 0 },
+  { 0, 27, 9773, 9773, 0 }, { 0, 27, 9775, 9775, 0 }, { 0, 27, 9777, 9777, 0 }, { 0, 27, 9779, 9779, 0 }, { 0, 27, 9781, 9781, 0 }, { 0, 27, 9783, 9783, 0 },
+  { 0, 27, 9785, 9785, 0 }, { 0, 27, 9787, 9787, 0 }, { 0, 27, 9789, 9789, 0 }, { 0, 27, 9791, 9791, 0 }, { 0, 27, 9793, 9793, 0 }, { 0, 27, 9795, 9795, 0 },
+  { 0, 27, 9797, 9797, 0 }, { 0, 27, 9799, 9799, 0 }, { 0, 27, 9801, 9801, 0 }, { 0, 27, 9803, 9803, 0 }, { 0, 27, 9805, 9805, 0 }, { 0, 27, 9807, 9807, 0 },
+  { 0, 27, 9809, 9809, 0 }, { 0, 27, 9811, 9811, 0 }, { 0, 27, 9813, 9813, 0 }, { 0, 27, 9815, 9815, 0 }, { 0, 27, 9817, 9817, 0 }, { 0, 27, 9819, 9819, 0 },
+  { 0, 27, 9821, 9821, 0 }, { 0, 27, 9823, 9823, 0 }, { 0, 27, 9825, 9825, 0 }, { 0, 27, 9827, 9827, 0 }, { 0, 27, 9829, 9829, 0 }, { 0, 27, 9831, 9831, 0 },
+  { 0, 27, 9833, 9833, 0 }, { 0, 27, 9835, 9835, 0 }, { 0, 27, 9837, 9837, 0 }, { 0, 27, 9839, 9839, 0 }, { 0, 27, 9841, 9841, 0 }, { 0, 27, 9843, 9843, 0 },
+  { 0, 27, 9845, 9845, 0 }, { 0, 27, 9847, 9847, 0 }, { 0, 27, 9849, 9849, 0 }, { 0, 27, 9851, 9851, 0 }, { 0, 27, 9853, 9853, 0 }, { 0, 27, 9855, 9855, 0 },
+  { 0, 27, 9857, 9857, 0 }, { 0, 27, 9859, 9859, 0 }, { 0, 27, 9861, 9861, 0 }, { 0, 27, 9863, 9863, 0 }, { 0, 27, 9865, 9865, 0 }, { 0, 27, 9867, 9867, 0 },
+  { 0, 27, 9869, 9869, 0 }, { 0, 27, 9871, 9871, 0 }, { 0, 27, 9873, 9873, 0 }, { 0, 27, 9875, 9875, 0 }, { 0, 27, 9877, 9877, 0 }, { 0, 27, 9879, 9879, 0 },
+  { 0, 27, 9881, 9881, 0 }, { 0, 27, 9883, 9883, 0 }, { 0, 27, 9885, 9885, 0 }, { 0, 27, 9887, 9887, 0 }, { 0, 27, 9889, 9889, 0 }, { 0, 27, 9891, 9891, 0 },
+  { 0, 27, 9893, 9893, 0 }, { 0, 27, 9895, 9895, 0 }, { 0, 27, 9897, 9897, 0 }, { 0, 27, 9899, 9899, 0 }, { 0, 27, 9901, 9901, 0 }, { 0, 27, 9903, 9903, 0 },
+  { 0, 27, 9905, 9905, 0 }, { 0, 27, 9907, 9907, 0 }, { 0, 27, 9909, 9909, 0 }, { 0, 27, 9911, 9911, 0 }, { 0, 27, 9913, 9913, 0 }, { 0, 27, 9915, 9915, 0 },
+  { 0, 27, 9917, 9917, 0 }, { 0, 27, 9919, 9919, 0 }, { 0, 27, 9921, 9921, 0 }, { 0, 27, 9923, 9923, 0 }, { 0, 27, 9925, 9925, 0 }, { 0, 27, 9927, 9927, 0 },
+  { 0, 27, 9929, 9929, 0 }, { 0, 27, 9931, 9931, 0 }, { 0, 27, 9933, 9933, 0 }, { 0, 27, 9935, 9935, 0 }, { 0, 27, 9937, 9937, 0 }, { 0, 27, 9939, 9939, 0 },
+  { 0, 27, 9941, 9941, 0 }, { 0, 27, 9943, 9943, 0 }, { 0, 27, 9945, 9945, 0 }, { 0, 27, 9947, 9947, 0 }, { 0, 27, 9949, 9949, 0 }, { 0, 27, 9951, 9951, 0 },
+  { 0, 27, 9953, 9953, 0 }, { 0, 27, 9955, 9955, 0 }, { 0, 27, 9957, 9957, 0 }, { 0, 27, 9959, 9959, 0 }, { 0, 27, 9961, 9961, 0 }, { 0, 27, 9963, 9963, 0 },
+  { 0, 27, 9965, 9965, 0 }, { 0, 27, 9967, 9967, 0 }, { 0, 27, 9969, 9969, 0 }, { 0, 27, 9971, 9971, 0 }, { 0, 27, 9973, 9973, 0 }, { 0, 27, 9975, 9975, 0 },
+  { 0, 27, 9977, 9977, 0 }, { 0, 27, 9979, 9979, 0 }, { 0, 27, 9981, 9981, 0 }, { 0, 27, 9983, 9983, 0 }, { 0, 27, 9985, 9985, 0 }, { 0, 27, 9987, 9987, 0 },
+  { 0, 27, 9989, 9989, 0 }, { 0, 27, 9991, 9991, 0 }, { 0, 27, 9993, 9993, 0 }, { 0, 27, 9995, 9995, 0 }, { 0, 27, 9997, 9997, 0 }, { 0, 27, 9999, 9999, 0 },
+  { 0, 27, 10001, 10001, 0 }, { 0, 27, 10003, 10003, 0 }, { 0, 27, 10005, 10005, 0 }, { 0, 27, 10007, 10007, 0 }, { 0, 27, 10009, 10009, 0 }, { 0, 27, 10011, 10011, 0 },
+  { 0, 27, 10013, 10013, 0 }, { 0, 27, 10015, 10015, 0 }, { 0, 27, 10017, 10017, 0 }, { 0, 27, 10019, 10019, 0 }, { 0, 27, 10021, 10021, 0 }, { 0, 27, 10023, 10023, 0 },
+  { 0, 27, 10025, 10025, 0 }, { 0, 27, 10027, 10027, 0 }, { 0, 27, 10029, 10029, 0 }, { 0, 27, 10031, 10031, 0 }, { 0, 27, 10033, 10033, 0 }, { 0, 27, 10035, 10035, 0 },
+  { 0, 27, 10037, 10037, 0 }, { 0, 27, 10039, 10039, 0 }, { 0, 27, 10041, 10041, 0 }, { 0, 27, 10043, 10043, 0 }, { 0, 27, 10045, 10045, 0 }, { 0, 27, 10047, 10047, 0 },
+  { 0, 27, 10049, 10049, 0 }, { 0, 27, 10051, 10051, 0 }, { 0, 27, 10053, 10053, 0 }, { 0, 27, 10055, 10055, 0 }, { 0, 27, 10057, 10057, 0 }, { 0, 27, 10059, 10059, 0 },
+  { 0, 27, 10061, 10061, 0 }, { 0, 27, 10063, 10063, 0 }, { 0, 27, 10065, 10065, 0 }, { 0, 27, 10067, 10067, 0 }, { 0, 27, 10069, 10069, 0 }, { 0, 27, 10071, 10071, 0 },
+  { 0, 27, 10073, 10073, 0 }, { 0, 27, 10075, 10075, 0 }, { 0, 27, 10077, 10077, 0 }, { 0, 27, 10079, 10079, 0 }, { 0, 27, 10081, 10081, 0 }, { 0, 27, 10083, 10083, 0 },
+  { 0, 27, 10085, 10085, 0 }, { 0, 27, 10087, 10087, 0 }, { 0, 27, 10089, 10089, 0 }, { 0, 27, 10091, 10091, 0 }, { 0, 27, 10093, 10093, 0 }, { 0, 27, 10095, 10095, 0 },
+  { 0, 27, 10097, 10097, 0 }, { 0, 27, 10099, 10099, 0 }, { 0, 27, 10101, 10101, 0 }, { 0, 27, 10103, 10103, 0 }, { 0, 27, 10105, 10105, 0 }, { 0, 27, 10107, 10107, 0 },
+  { 0, 27, 10109, 10109, 0 }, { 0, 27, 10111, 10111, 0 }, { 0, 27, 10113, 10113, 0 }, { 0, 27, 10115, 10115, 0 }, { 0, 27, 10117, 10117, 0 }, { 0, 27, 10119, 10119, 0 },
+  { 0, 27, 10121, 10121, 0 }, { 0, 27, 10123, 10123, 0 }, { 0, 27, 10125, 10125, 0 }, { 0, 27, 10127, 10127, 0 }, { 0, 27, 10129, 10129, 0 }, { 0, 27, 10131, 10131, 0 },
+  { 0, 27, 10133, 10133, 0 }, { 0, 27, 10135, 10135, 0 }, { 0, 27, 10137, 10137, 0 }, { 0, 27, 10139, 10139, 0 }, { 0, 27, 10141, 10141, 0 }, { 0, 27, 10143, 10143, 0 },
+  { 0, 27, 10145, 10145, 0 }, { 0, 27, 10147, 10147, 0 }, { 0, 27, 10149, 10149, 0 }, { 0, 27, 10151, 10151, 0 }, { 0, 27, 10153, 10153, 0 }, { 0, 27, 10155, 10155, 0 },
+  { 0, 27, 10157, 10157, 0 }, { 0, 27, 10159, 10159, 0 }, { 0, 27, 10161, 10161, 0 }, { 0, 27, 10163, 10163, 0 }, { 0, 27, 10165, 10165, 0 }, { 0, 27, 10167, 10167, 0 },
+  { 0, 27, 10169, 10169, 0 }, { 0, 27, 10171, 10171, 0 }, { 0, 27, 10173, 10173, 0 }, { 0, 27, 10175, 10175, 0 }, { 0, 27, 10177, 10177, 0 }, { 0, 27, 10179, 10179, 0 },
+  { 0, 27, 10181, 10181, 0 }, { 0, 27, 10183, 10183, 0 }, { 0, 27, 10185, 10185, 0 }, { 0, 27, 10187, 10187, 0 }, { 0, 27, 10189, 10189, 0 }, { 0, 27, 10191, 10191, 0 },
+  { 0, 27, 10193, 10193, 0 }, { 0, 27, 10195, 10195, 0 }, { 0, 27, 10197, 10197, 0 }, { 0, 27, 10199, 10199, 0 }, { 0, 27, 10201, 10201, 0 }, { 0, 27, 10203, 10203, 0 },
+  { 0, 27, 10205, 10205, 0 }, { 0, 27, 10207, 10207, 0 }, { 0, 27, 10209, 10209, 0 }, { 0, 27, 10211, 10211, 0 }, { 0, 27, 10213, 10213, 0 }, { 0, 27, 10215, 10215, 0 },
+  { 0, 27, 10217, 10217, 0 }, { 0, 27, 10219, 10219, 0 }, { 0, 27, 10221, 10221, 0 }, { 0, 27, 10223, 10223, 0 }, { 0, 27, 10225, 10225, 0 }, { 0, 27, 10227, 10227, 0 },
+  { 0, 27, 10229, 10229, 0 }, { 0, 27, 10231, 10231, 0 }, { 0, 27, 10233, 10233, 0 }, { 0, 27, 10235, 10235, 0 }, { 0, 27, 10237, 10237, 0 }, { 0, 27, 10239, 10239, 0 },
+  { 0, 27, 10241, 10241, 0 }, { 0, 27, 10243, 10243, 0 }, { 0, 27, 10245, 10245, 0 }, { 0, 27, 10247, 10247, 0 }, { 0, 27, 10249, 10249, 0 }, { 0, 27, 10251, 10251, 0 },
+  { 0, 27, 10253, 10253, 0 }, { 0, 27, 10255, 10255, 0 }, { 0, 27, 10257, 10257, 0 }, { 0, 27, 10259, 10259, 0 }, { 0, 27, 10261, 10261, 0 }, { 0, 27, 10263, 10263, 0 },
+  { 0, 27, 10265, 10265, 0 }, { 0, 27, 10267, 10267, 0 }, { 0, 27, 10269, 10269, 0 }, { 0, 27, 10271, 10271, 0 }, { 0, 27, 10273, 10273, 0 }, { 0, 27, 10275, 10275, 0 },
+  { 0, 27, 10277, 10277, 0 }, { 0, 27, 10279, 10279, 0 }, { 0, 27, 10281, 10281, 0 }, { 0, 27, 10283, 10283, 0 }, { 0, 27, 10285, 10285, 0 }, { 0, 27, 10287, 10287, 0 },
+  { 0, 27, 10289, 10289, 0 }, { 0, 27, 10291, 10291, 0 }, { 0, 27, 10293, 10293, 0 }, { 0, 27, 10295, 10295, 0 }, { 0, 27, 10297, 10297, 0 }, { 0, 27, 10299, 10299, 0 },
+  { 0, 27, 10301, 10301, 0 }, { 0, 27, 10303, 10303, 0 }, { 0, 27, 10305, 10305, 0 }, { 0, 27, 10307, 10307, 0 }, { 0, 27, 4366, 4366, 0 }, { 0, 27, 10309, 10309, 0 },
+  { 0, 27, 10311, 10311, 0 }, { 0, 27, 10313, 10313, 0 }, { 0, 27, 10315, 10315, 0 }, { 0, 27, 10317, 10317, 0 }, { 0, 27, 10319, 10319, 0 }, { 0, 27, 10321, 10321, 0 },
+  { 0, 27, 10323, 10323, 0 }, { 0, 27, 10325, 10325, 0 }, { 0, 27, 10327, 10327, 0 }, { 0, 27, 10329, 10329, 0 }, { 0, 27, 4380, 4380, 0 }, { 0, 27, 10331, 10331, 0 },
+  { 0, 27, 10333, 10333, 0 }, { 0, 27, 10335, 10335, 0 }, { 0, 27, 10337, 10337, 0 }, { 0, 27, 10339, 10339, 0 }, { 0, 27, 10341, 10341, 0 }, { 0, 27, 10343, 10343, 0 },
+  { 0, 27, 10345, 10345, 0 }, { 0, 27, 10347, 10347, 0 }, { 0, 27, 10349, 10349, 0 }, { 0, 27, 10351, 10351, 0 }, { 0, 27, 10353, 10353, 0 }, { 0, 27, 10355, 10355, 0 },
+  { 0, 27, 10357, 10357, 0 }, { 0, 27, 10359, 10359, 0 }, { 0, 27, 10361, 10361, 0 }, { 0, 27, 10363, 10363, 0 }, { 0, 27, 10365, 10365, 0 }, { 0, 27, 10367, 10367, 0 },
+  { 0, 27, 10369, 10369, 0 }, { 0, 27, 10371, 10371, 0 }, { 0, 27, 10373, 10373, 0 }, { 0, 27, 10375, 10375, 0 }, { 0, 27, 10377, 10377, 0 }, { 0, 27, 10379, 10379, 0 },
+  { 0, 27, 10381, 10381, 0 }, { 0, 27, 10383, 10383, 0 }, { 0, 27, 10385, 10385, 0 }, { 0, 27, 10387, 10387, 0 }, { 0, 27, 10389, 10389, 0 }, { 0, 27, 10391, 10391, 0 },
+  { 0, 27, 10393, 10393, 0 }, { 0, 27, 10395, 10395, 0 }, { 0, 27, 10397, 10397, 0 }, { 0, 27, 10399, 10399, 0 }, { 0, 27, 10401, 10401, 0 }, { 0, 27, 10403, 10403, 0 },
+  { 0, 27, 10405, 10405, 0 }, { 0, 27, 10407, 10407, 0 }, { 0, 27, 10409, 10409, 0 }, { 0, 27, 10411, 10411, 0 }, { 0, 27, 10413, 10413, 0 }, { 0, 27, 10415, 10415, 0 },
+  { 0, 27, 10417, 10417, 0 }, { 0, 27, 10419, 10419, 0 }, { 0, 27, 10421, 10421, 0 }, { 0, 27, 10423, 10423, 0 }, { 0, 27, 10425, 10425, 0 }, { 0, 27, 10427, 10427, 0 },
+  { 0, 27, 10429, 10429, 0 }, { 0, 27, 10431, 10431, 0 }, { 0, 27, 10433, 10433, 0 }, { 0, 27, 10435, 10435, 0 }, { 0, 27, 10437, 10437, 0 }, { 0, 27, 10439, 10439, 0 },
+  { 0, 27, 10441, 10441, 0 }, { 0, 27, 10443, 10443, 0 }, { 0, 27, 10445, 10445, 0 }, { 0, 27, 10447, 10447, 0 }, { 0, 27, 10449, 10449, 0 }, { 0, 27, 10451, 10451, 0 },
+  { 0, 27, 10453, 10453, 0 }, { 0, 27, 4476, 4476, 0 }, { 0, 27, 10455, 10455, 0 }, { 0, 27, 4484, 4484, 0 }, { 0, 27, 10457, 10457, 0 }, { 0, 27, 10459, 10459, 0 },
+  { 0, 27, 10461, 10461, 0 }, { 0, 27, 10463, 10463, 0 }, { 0, 27, 4494, 4494, 0 }, { 0, 27, 10465, 10465, 0 },
+};
+
+const char32_t _unicode_decompositions[] = {
+  0x0000, 0x0001, 0x0020, 0x0002, 0x0020, 0x0308, 0x0001, 0x0061, 0x0002, 0x0020, 0x0304, 0x0001,
+  0x0032, 0x0001, 0x0033, 0x0002, 0x0020, 0x0301, 0x0001, 0x03BC, 0x0002, 0x0020, 0x0327, 0x0001,
+  0x0031, 0x0001, 0x006F, 0x0003, 0x0031, 0x2044, 0x0034, 0x0003, 0x0031, 0x2044, 0x0032, 0x0003,
+  0x0033, 0x2044, 0x0034, 0x0002, 0x0041, 0x0300, 0x0002, 0x0041, 0x0301, 0x0002, 0x0041, 0x0302,
+  0x0002, 0x0041, 0x0303, 0x0002, 0x0041, 0x0308, 0x0002, 0x0041, 0x030A, 0x0002, 0x0043, 0x0327,
+  0x0002, 0x0045, 0x0300, 0x0002, 0x0045, 0x0301, 0x0002, 0x0045, 0x0302, 0x0002, 0x0045, 0x0308,
+  0x0002, 0x0049, 0x0300, 0x0002, 0x0049, 0x0301, 0x0002, 0x0049, 0x0302, 0x0002, 0x0049, 0x0308,
+  0x0002, 0x004E, 0x0303, 0x0002, 0x004F, 0x0300, 0x0002, 0x004F, 0x0301, 0x0002, 0x004F, 0x0302,
+  0x0002, 0x004F, 0x0303, 0x0002, 0x004F, 0x0308, 0x0002, 0x0055, 0x0300, 0x0002, 0x0055, 0x0301,
+  0x0002, 0x0055, 0x0302, 0x0002, 0x0055, 0x0308, 0x0002, 0x0059, 0x0301, 0x0002, 0x0061, 0x0300,
+  0x0002, 0x0061, 0x0301, 0x0002, 0x0061, 0x0302, 0x0002, 0x0061, 0x0303, 0x0002, 0x0061, 0x0308,
+  0x0002, 0x0061, 0x030A, 0x0002, 0x0063, 0x0327, 0x0002, 0x0065, 0x0300, 0x0002, 0x0065, 0x0301,
+  0x0002, 0x0065, 0x0302, 0x0002, 0x0065, 0x0308, 0x0002, 0x0069, 0x0300, 0x0002, 0x0069, 0x0301,
+  0x0002, 0x0069, 0x0302, 0x0002, 0x0069, 0x0308, 0x0002, 0x006E, 0x0303, 0x0002, 0x006F, 0x0300,
+  0x0002, 0x006F, 0x0301, 0x0002, 0x006F, 0x0302, 0x0002, 0x006F, 0x0303, 0x0002, 0x006F, 0x0308,
+  0x0002, 0x0075, 0x0300, 0x0002, 0x0075, 0x0301, 0x0002, 0x0075, 0x0302, 0x0002, 0x0075, 0x0308,
+  0x0002, 0x0079, 0x0301, 0x0002, 0x0079, 0x0308, 0x0002, 0x0041, 0x0304, 0x0002, 0x0061, 0x0304,
+  0x0002, 0x0041, 0x0306, 0x0002, 0x0061, 0x0306, 0x0002, 0x0041, 0x0328, 0x0002, 0x0061, 0x0328,
+  0x0002, 0x0043, 0x0301, 0x0002, 0x0063, 0x0301, 0x0002, 0x0043, 0x0302, 0x0002, 0x0063, 0x0302,
+  0x0002, 0x0043, 0x0307, 0x0002, 0x0063, 0x0307, 0x0002, 0x0043, 0x030C, 0x0002, 0x0063, 0x030C,
+  0x0002, 0x0044, 0x030C, 0x0002, 0x0064, 0x030C, 0x0002, 0x0045, 0x0304, 0x0002, 0x0065, 0x0304,
+  0x0002, 0x0045, 0x0306, 0x0002, 0x0065, 0x0306, 0x0002, 0x0045, 0x0307, 0x0002, 0x0065, 0x0307,
+  0x0002, 0x0045, 0x0328, 0x0002, 0x0065, 0x0328, 0x0002, 0x0045, 0x030C, 0x0002, 0x0065, 0x030C,
+  0x0002, 0x0047, 0x0302, 0x0002, 0x0067, 0x0302, 0x0002, 0x0047, 0x0306, 0x0002, 0x0067, 0x0306,
+  0x0002, 0x0047, 0x0307, 0x0002, 0x0067, 0x0307, 0x0002, 0x0047, 0x0327, 0x0002, 0x0067, 0x0327,
+  0x0002, 0x0048, 0x0302, 0x0002, 0x0068, 0x0302, 0x0002, 0x0049, 0x0303, 0x0002, 0x0069, 0x0303,
+  0x0002, 0x0049, 0x0304, 0x0002, 0x0069, 0x0304, 0x0002, 0x0049, 0x0306, 0x0002, 0x0069, 0x0306,
+  0x0002, 0x0049, 0x0328, 0x0002, 0x0069, 0x0328, 0x0002, 0x0049, 0x0307, 0x0002, 0x0049, 0x004A,
+  0x0002, 0x0069, 0x006A, 0x0002, 0x004A, 0x0302, 0x0002, 0x006A, 0x0302, 0x0002, 0x004B, 0x0327,
+  0x0002, 0x006B, 0x0327, 0x0002, 0x004C, 0x0301, 0x0002, 0x006C, 0x0301, 0x0002, 0x004C, 0x0327,
+  0x0002, 0x006C, 0x0327, 0x0002, 0x004C, 0x030C, 0x0002, 0x006C, 0x030C, 0x0002, 0x004C, 0x00B7,
+  0x0002, 0x006C, 0x00B7, 0x0002, 0x004E, 0x0301, 0x0002, 0x006E, 0x0301, 0x0002, 0x004E, 0x0327,
+  0x0002, 0x006E, 0x0327, 0x0002, 0x004E, 0x030C, 0x0002, 0x006E, 0x030C, 0x0002, 0x02BC, 0x006E,
+  0x0002, 0x004F, 0x0304, 0x0002, 0x006F, 0x0304, 0x0002, 0x004F, 0x0306, 0x0002, 0x006F, 0x0306,
+  0x0002, 0x004F, 0x030B, 0x0002, 0x006F, 0x030B, 0x0002, 0x0052, 0x0301, 0x0002, 0x0072, 0x0301,
+  0x0002, 0x0052, 0x0327, 0x0002, 0x0072, 0x0327, 0x0002, 0x0052, 0x030C, 0x0002, 0x0072, 0x030C,
+  0x0002, 0x0053, 0x0301, 0x0002, 0x0073, 0x0301, 0x0002, 0x0053, 0x0302, 0x0002, 0x0073, 0x0302,
+  0x0002, 0x0053, 0x0327, 0x0002, 0x0073, 0x0327, 0x0002, 0x0053, 0x030C, 0x0002, 0x0073, 0x030C,
+  0x0002, 0x0054, 0x0327, 0x0002, 0x0074, 0x0327, 0x0002, 0x0054, 0x030C, 0x0002, 0x0074, 0x030C,
+  0x0002, 0x0055, 0x0303, 0x0002, 0x0075, 0x0303, 0x0002, 0x0055, 0x0304, 0x0002, 0x0075, 0x0304,
+  0x0002, 0x0055, 0x0306, 0x0002, 0x0075, 0x0306, 0x0002, 0x0055, 0x030A, 0x0002, 0x0075, 0x030A,
+  0x0002, 0x0055, 0x030B, 0x0002, 0x0075, 0x030B, 0x0002, 0x0055, 0x0328, 0x0002, 0x0075, 0x0328,
+  0x0002, 0x0057, 0x0302, 0x0002, 0x0077, 0x0302, 0x0002, 0x0059, 0x0302, 0x0002, 0x0079, 0x0302,
+  0x0002, 0x0059, 0x0308, 0x0002, 0x005A, 0x0301, 0x0002, 0x007A, 0x0301, 0x0002, 0x005A, 0x0307,
+  0x0002, 0x007A, 0x0307, 0x0002, 0x005A, 0x030C, 0x0002, 0x007A, 0x030C, 0x0001, 0x0073, 0x0002,
+  0x004F, 0x031B, 0x0002, 0x006F, 0x031B, 0x0002, 0x0055, 0x031B, 0x0002, 0x0075, 0x031B, 0x0003,
+  0x0044, 0x005A, 0x030C, 0x0003, 0x0044, 0x007A, 0x030C, 0x0003, 0x0064, 0x007A, 0x030C, 0x0002,
+  0x004C, 0x004A, 0x0002, 0x004C, 0x006A, 0x0002, 0x006C, 0x006A, 0x0002, 0x004E, 0x004A, 0x0002,
+  0x004E, 0x006A, 0x0002, 0x006E, 0x006A, 0x0002, 0x0041, 0x030C, 0x0002, 0x0061, 0x030C, 0x0002,
+  0x0049, 0x030C, 0x0002, 0x0069, 0x030C, 0x0002, 0x004F, 0x030C, 0x0002, 0x006F, 0x030C, 0x0002,
+  0x0055, 0x030C, 0x0002, 0x0075, 0x030C, 0x0003, 0x0055, 0x0308, 0x0304, 0x0003, 0x0075, 0x0308,
+  0x0304, 0x0003, 0x0055, 0x0308, 0x0301, 0x0003, 0x0075, 0x0308, 0x0301, 0x0003, 0x0055, 0x0308,
+  0x030C, 0x0003, 0x0075, 0x0308, 0x030C, 0x0003, 0x0055, 0x0308, 0x0300, 0x0003, 0x0075, 0x0308,
+  0x0300, 0x0003, 0x0041, 0x0308, 0x0304, 0x0003, 0x0061, 0x0308, 0x0304, 0x0003, 0x0041, 0x0307,
+  0x0304, 0x0003, 0x0061, 0x0307, 0x0304, 0x0002, 0x00C6, 0x0304, 0x0002, 0x00E6, 0x0304, 0x0002,
+  0x0047, 0x030C, 0x0002, 0x0067, 0x030C, 0x0002, 0x004B, 0x030C, 0x0002, 0x006B, 0x030C, 0x0002,
+  0x004F, 0x0328, 0x0002, 0x006F, 0x0328, 0x0003, 0x004F, 0x0328, 0x0304, 0x0003, 0x006F, 0x0328,
+  0x0304, 0x0002, 0x01B7, 0x030C, 0x0002, 0x0292, 0x030C, 0x0002, 0x006A, 0x030C, 0x0002, 0x0044,
+  0x005A, 0x0002, 0x0044, 0x007A, 0x0002, 0x0064, 0x007A, 0x0002, 0x0047, 0x0301, 0x0002, 0x0067,
+  0x0301, 0x0002, 0x004E, 0x0300, 0x0002, 0x006E, 0x0300, 0x0003, 0x0041, 0x030A, 0x0301, 0x0003,
+  0x0061, 0x030A, 0x0301, 0x0002, 0x00C6, 0x0301, 0x0002, 0x00E6, 0x0301, 0x0002, 0x00D8, 0x0301,
+  0x0002, 0x00F8, 0x0301, 0x0002, 0x0041, 0x030F, 0x0002, 0x0061, 0x030F, 0x0002, 0x0041, 0x0311,
+  0x0002, 0x0061, 0x0311, 0x0002, 0x0045, 0x030F, 0x0002, 0x0065, 0x030F, 0x0002, 0x0045, 0x0311,
+  0x0002, 0x0065, 0x0311, 0x0002, 0x0049, 0x030F, 0x0002, 0x0069, 0x030F, 0x0002, 0x0049, 0x0311,
+  0x0002, 0x0069, 0x0311, 0x0002, 0x004F, 0x030F, 0x0002, 0x006F, 0x030F, 0x0002, 0x004F, 0x0311,
+  0x0002, 0x006F, 0x0311, 0x0002, 0x0052, 0x030F, 0x0002, 0x0072, 0x030F, 0x0002, 0x0052, 0x0311,
+  0x0002, 0x0072, 0x0311, 0x0002, 0x0055, 0x030F, 0x0002, 0x0075, 0x030F, 0x0002, 0x0055, 0x0311,
+  0x0002, 0x0075, 0x0311, 0x0002, 0x0053, 0x0326, 0x0002, 0x0073, 0x0326, 0x0002, 0x0054, 0x0326,
+  0x0002, 0x0074, 0x0326, 0x0002, 0x0048, 0x030C, 0x0002, 0x0068, 0x030C, 0x0002, 0x0041, 0x0307,
+  0x0002, 0x0061, 0x0307, 0x0002, 0x0045, 0x0327, 0x0002, 0x0065, 0x0327, 0x0003, 0x004F, 0x0308,
+  0x0304, 0x0003, 0x006F, 0x0308, 0x0304, 0x0003, 0x004F, 0x0303, 0x0304, 0x0003, 0x006F, 0x0303,
+  0x0304, 0x0002, 0x004F, 0x0307, 0x0002, 0x006F, 0x0307, 0x0003, 0x004F, 0x0307, 0x0304, 0x0003,
+  0x006F, 0x0307, 0x0304, 0x0002, 0x0059, 0x0304, 0x0002, 0x0079, 0x0304, 0x0001, 0x0068, 0x0001,
+  0x0266, 0x0001, 0x006A, 0x0001, 0x0072, 0x0001, 0x0279, 0x0001, 0x027B, 0x0001, 0x0281, 0x0001,
+  0x0077, 0x0001, 0x0079, 0x0002, 0x0020, 0x0306, 0x0002, 0x0020, 0x0307, 0x0002, 0x0020, 0x030A,
+  0x0002, 0x0020, 0x0328, 0x0002, 0x0020, 0x0303, 0x0002, 0x0020, 0x030B, 0x0001, 0x0263, 0x0001,
+  0x006C, 0x0001, 0x0078, 0x0001, 0x0295, 0x0001, 0x0300, 0x0001, 0x0301, 0x0001, 0x0313, 0x0002,
+  0x0308, 0x0301, 0x0001, 0x02B9, 0x0002, 0x0020, 0x0345, 0x0001, 0x003B, 0x0002, 0x00A8, 0x0301,
+  0x0003, 0x0020, 0x0308, 0x0301, 0x0002, 0x0391, 0x0301, 0x0001, 0x00B7, 0x0002, 0x0395, 0x0301,
+  0x0002, 0x0397, 0x0301, 0x0002, 0x0399, 0x0301, 0x0002, 0x039F, 0x0301, 0x0002, 0x03A5, 0x0301,
+  0x0002, 0x03A9, 0x0301, 0x0003, 0x03B9, 0x0308, 0x0301, 0x0002, 0x0399, 0x0308, 0x0002, 0x03A5,
+  0x0308, 0x0002, 0x03B1, 0x0301, 0x0002, 0x03B5, 0x0301, 0x0002, 0x03B7, 0x0301, 0x0002, 0x03B9,
+  0x0301, 0x0003, 0x03C5, 0x0308, 0x0301, 0x0002, 0x03B9, 0x0308, 0x0002, 0x03C5, 0x0308, 0x0002,
+  0x03BF, 0x0301, 0x0002, 0x03C5, 0x0301, 0x0002, 0x03C9, 0x0301, 0x0001, 0x03B2, 0x0001, 0x03B8,
+  0x0001, 0x03A5, 0x0002, 0x03D2, 0x0301, 0x0002, 0x03D2, 0x0308, 0x0001, 0x03C6, 0x0001, 0x03C0,
+  0x0001, 0x03BA, 0x0001, 0x03C1, 0x0001, 0x03C2, 0x0001, 0x0398, 0x0001, 0x03B5, 0x0001, 0x03A3,
+  0x0002, 0x0415, 0x0300, 0x0002, 0x0415, 0x0308, 0x0002, 0x0413, 0x0301, 0x0002, 0x0406, 0x0308,
+  0x0002, 0x041A, 0x0301, 0x0002, 0x0418, 0x0300, 0x0002, 0x0423, 0x0306, 0x0002, 0x0418, 0x0306,
+  0x0002, 0x0438, 0x0306, 0x0002, 0x0435, 0x0300, 0x0002, 0x0435, 0x0308, 0x0002, 0x0433, 0x0301,
+  0x0002, 0x0456, 0x0308, 0x0002, 0x043A, 0x0301, 0x0002, 0x0438, 0x0300, 0x0002, 0x0443, 0x0306,
+  0x0002, 0x0474, 0x030F, 0x0002, 0x0475, 0x030F, 0x0002, 0x0416, 0x0306, 0x0002, 0x0436, 0x0306,
+  0x0002, 0x0410, 0x0306, 0x0002, 0x0430, 0x0306, 0x0002, 0x0410, 0x0308, 0x0002, 0x0430, 0x0308,
+  0x0002, 0x0415, 0x0306, 0x0002, 0x0435, 0x0306, 0x0002, 0x04D8, 0x0308, 0x0002, 0x04D9, 0x0308,
+  0x0002, 0x0416, 0x0308, 0x0002, 0x0436, 0x0308, 0x0002, 0x0417, 0x0308, 0x0002, 0x0437, 0x0308,
+  0x0002, 0x0418, 0x0304, 0x0002, 0x0438, 0x0304, 0x0002, 0x0418, 0x0308, 0x0002, 0x0438, 0x0308,
+  0x0002, 0x041E, 0x0308, 0x0002, 0x043E, 0x0308, 0x0002, 0x04E8, 0x0308, 0x0002, 0x04E9, 0x0308,
+  0x0002, 0x042D, 0x0308, 0x0002, 0x044D, 0x0308, 0x0002, 0x0423, 0x0304, 0x0002, 0x0443, 0x0304,
+  0x0002, 0x0423, 0x0308, 0x0002, 0x0443, 0x0308, 0x0002, 0x0423, 0x030B, 0x0002, 0x0443, 0x030B,
+  0x0002, 0x0427, 0x0308, 0x0002, 0x0447, 0x0308, 0x0002, 0x042B, 0x0308, 0x0002, 0x044B, 0x0308,
+  0x0002, 0x0565, 0x0582, 0x0002, 0x0627, 0x0653, 0x0002, 0x0627, 0x0654, 0x0002, 0x0648, 0x0654,
+  0x0002, 0x0627, 0x0655, 0x0002, 0x064A, 0x0654, 0x0002, 0x0627, 0x0674, 0x0002, 0x0648, 0x0674,
+  0x0002, 0x06C7, 0x0674, 0x0002, 0x064A, 0x0674, 0x0002, 0x06D5, 0x0654, 0x0002, 0x06C1, 0x0654,
+  0x0002, 0x06D2, 0x0654, 0x0002, 0x0928, 0x093C, 0x0002, 0x0930, 0x093C, 0x0002, 0x0933, 0x093C,
+  0x0002, 0x0915, 0x093C, 0x0002, 0x0916, 0x093C, 0x0002, 0x0917, 0x093C, 0x0002, 0x091C, 0x093C,
+  0x0002, 0x0921, 0x093C, 0x0002, 0x0922, 0x093C, 0x0002, 0x092B, 0x093C, 0x0002, 0x092F, 0x093C,
+  0x0002, 0x09C7, 0x09BE, 0x0002, 0x09C7, 0x09D7, 0x0002, 0x09A1, 0x09BC, 0x0002, 0x09A2, 0x09BC,
+  0x0002, 0x09AF, 0x09BC, 0x0002, 0x0A32, 0x0A3C, 0x0002, 0x0A38, 0x0A3C, 0x0002, 0x0A16, 0x0A3C,
+  0x0002, 0x0A17, 0x0A3C, 0x0002, 0x0A1C, 0x0A3C, 0x0002, 0x0A2B, 0x0A3C, 0x0002, 0x0B47, 0x0B56,
+  0x0002, 0x0B47, 0x0B3E, 0x0002, 0x0B47, 0x0B57, 0x0002, 0x0B21, 0x0B3C, 0x0002, 0x0B22, 0x0B3C,
+  0x0002, 0x0B92, 0x0BD7, 0x0002, 0x0BC6, 0x0BBE, 0x0002, 0x0BC7, 0x0BBE, 0x0002, 0x0BC6, 0x0BD7,
+  0x0002, 0x0C46, 0x0C56, 0x0002, 0x0CBF, 0x0CD5, 0x0002, 0x0CC6, 0x0CD5, 0x0002, 0x0CC6, 0x0CD6,
+  0x0002, 0x0CC6, 0x0CC2, 0x0003, 0x0CC6, 0x0CC2, 0x0CD5, 0x0002, 0x0D46, 0x0D3E, 0x0002, 0x0D47,
+  0x0D3E, 0x0002, 0x0D46, 0x0D57, 0x0002, 0x0DD9, 0x0DCA, 0x0002, 0x0DD9, 0x0DCF, 0x0003, 0x0DD9,
+  0x0DCF, 0x0DCA, 0x0002, 0x0DD9, 0x0DDF, 0x0002, 0x0E4D, 0x0E32, 0x0002, 0x0ECD, 0x0EB2, 0x0002,
+  0x0EAB, 0x0E99, 0x0002, 0x0EAB, 0x0EA1, 0x0001, 0x0F0B, 0x0002, 0x0F42, 0x0FB7, 0x0002, 0x0F4C,
+  0x0FB7, 0x0002, 0x0F51, 0x0FB7, 0x0002, 0x0F56, 0x0FB7, 0x0002, 0x0F5B, 0x0FB7, 0x0002, 0x0F40,
+  0x0FB5, 0x0002, 0x0F71, 0x0F72, 0x0002, 0x0F71, 0x0F74, 0x0002, 0x0FB2, 0x0F80, 0x0003, 0x0FB2,
+  0x0F71, 0x0F80, 0x0002, 0x0FB3, 0x0F80, 0x0003, 0x0FB3, 0x0F71, 0x0F80, 0x0002, 0x0F71, 0x0F80,
+  0x0002, 0x0F92, 0x0FB7, 0x0002, 0x0F9C, 0x0FB7, 0x0002, 0x0FA1, 0x0FB7, 0x0002, 0x0FA6, 0x0FB7,
+  0x0002, 0x0FAB, 0x0FB7, 0x0002, 0x0F90, 0x0FB5, 0x0002, 0x1025, 0x102E, 0x0001, 0x10DC, 0x0002,
+  0x1B05, 0x1B35, 0x0002, 0x1B07, 0x1B35, 0x0002, 0x1B09, 0x1B35, 0x0002, 0x1B0B, 0x1B35, 0x0002,
+  0x1B0D, 0x1B35, 0x0002, 0x1B11, 0x1B35, 0x0002, 0x1B3A, 0x1B35, 0x0002, 0x1B3C, 0x1B35, 0x0002,
+  0x1B3E, 0x1B35, 0x0002, 0x1B3F, 0x1B35, 0x0002, 0x1B42, 0x1B35, 0x0001, 0x0041, 0x0001, 0x00C6,
+  0x0001, 0x0042, 0x0001, 0x0044, 0x0001, 0x0045, 0x0001, 0x018E, 0x0001, 0x0047, 0x0001, 0x0048,
+  0x0001, 0x0049, 0x0001, 0x004A, 0x0001, 0x004B, 0x0001, 0x004C, 0x0001, 0x004D, 0x0001, 0x004E,
+  0x0001, 0x004F, 0x0001, 0x0222, 0x0001, 0x0050, 0x0001, 0x0052, 0x0001, 0x0054, 0x0001, 0x0055,
+  0x0001, 0x0057, 0x0001, 0x0250, 0x0001, 0x0251, 0x0001, 0x1D02, 0x0001, 0x0062, 0x0001, 0x0064,
+  0x0001, 0x0065, 0x0001, 0x0259, 0x0001, 0x025B, 0x0001, 0x025C, 0x0001, 0x0067, 0x0001, 0x006B,
+  0x0001, 0x006D, 0x0001, 0x014B, 0x0001, 0x0254, 0x0001, 0x1D16, 0x0001, 0x1D17, 0x0001, 0x0070,
+  0x0001, 0x0074, 0x0001, 0x0075, 0x0001, 0x1D1D, 0x0001, 0x026F, 0x0001, 0x0076, 0x0001, 0x1D25,
+  0x0001, 0x03B3, 0x0001, 0x03B4, 0x0001, 0x03C7, 0x0001, 0x0069, 0x0001, 0x043D, 0x0001, 0x0252,
+  0x0001, 0x0063, 0x0001, 0x0255, 0x0001, 0x00F0, 0x0001, 0x0066, 0x0001, 0x025F, 0x0001, 0x0261,
+  0x0001, 0x0265, 0x0001, 0x0268, 0x0001, 0x0269, 0x0001, 0x026A, 0x0001, 0x1D7B, 0x0001, 0x029D,
+  0x0001, 0x026D, 0x0001, 0x1D85, 0x0001, 0x029F, 0x0001, 0x0271, 0x0001, 0x0270, 0x0001, 0x0272,
+  0x0001, 0x0273, 0x0001, 0x0274, 0x0001, 0x0275, 0x0001, 0x0278, 0x0001, 0x0282, 0x0001, 0x0283,
+  0x0001, 0x01AB, 0x0001, 0x0289, 0x0001, 0x028A, 0x0001, 0x1D1C, 0x0001, 0x028B, 0x0001, 0x028C,
+  0x0001, 0x007A, 0x0001, 0x0290, 0x0001, 0x0291, 0x0001, 0x0292, 0x0002, 0x0041, 0x0325, 0x0002,
+  0x0061, 0x0325, 0x0002, 0x0042, 0x0307, 0x0002, 0x0062, 0x0307, 0x0002, 0x0042, 0x0323, 0x0002,
+  0x0062, 0x0323, 0x0002, 0x0042, 0x0331, 0x0002, 0x0062, 0x0331, 0x0003, 0x0043, 0x0327, 0x0301,
+  0x0003, 0x0063, 0x0327, 0x0301, 0x0002, 0x0044, 0x0307, 0x0002, 0x0064, 0x0307, 0x0002, 0x0044,
+  0x0323, 0x0002, 0x0064, 0x0323, 0x0002, 0x0044, 0x0331, 0x0002, 0x0064, 0x0331, 0x0002, 0x0044,
+  0x0327, 0x0002, 0x0064, 0x0327, 0x0002, 0x0044, 0x032D, 0x0002, 0x0064, 0x032D, 0x0003, 0x0045,
+  0x0304, 0x0300, 0x0003, 0x0065, 0x0304, 0x0300, 0x0003, 0x0045, 0x0304, 0x0301, 0x0003, 0x0065,
+  0x0304, 0x0301, 0x0002, 0x0045, 0x032D, 0x0002, 0x0065, 0x032D, 0x0002, 0x0045, 0x0330, 0x0002,
+  0x0065, 0x0330, 0x0003, 0x0045, 0x0327, 0x0306, 0x0003, 0x0065, 0x0327, 0x0306, 0x0002, 0x0046,
+  0x0307, 0x0002, 0x0066, 0x0307, 0x0002, 0x0047, 0x0304, 0x0002, 0x0067, 0x0304, 0x0002, 0x0048,
+  0x0307, 0x0002, 0x0068, 0x0307, 0x0002, 0x0048, 0x0323, 0x0002, 0x0068, 0x0323, 0x0002, 0x0048,
+  0x0308, 0x0002, 0x0068, 0x0308, 0x0002, 0x0048, 0x0327, 0x0002, 0x0068, 0x0327, 0x0002, 0x0048,
+  0x032E, 0x0002, 0x0068, 0x032E, 0x0002, 0x0049, 0x0330, 0x0002, 0x0069, 0x0330, 0x0003, 0x0049,
+  0x0308, 0x0301, 0x0003, 0x0069, 0x0308, 0x0301, 0x0002, 0x004B, 0x0301, 0x0002, 0x006B, 0x0301,
+  0x0002, 0x004B, 0x0323, 0x0002, 0x006B, 0x0323, 0x0002, 0x004B, 0x0331, 0x0002, 0x006B, 0x0331,
+  0x0002, 0x004C, 0x0323, 0x0002, 0x006C, 0x0323, 0x0003, 0x004C, 0x0323, 0x0304, 0x0003, 0x006C,
+  0x0323, 0x0304, 0x0002, 0x004C, 0x0331, 0x0002, 0x006C, 0x0331, 0x0002, 0x004C, 0x032D, 0x0002,
+  0x006C, 0x032D, 0x0002, 0x004D, 0x0301, 0x0002, 0x006D, 0x0301, 0x0002, 0x004D, 0x0307, 0x0002,
+  0x006D, 0x0307, 0x0002, 0x004D, 0x0323, 0x0002, 0x006D, 0x0323, 0x0002, 0x004E, 0x0307, 0x0002,
+  0x006E, 0x0307, 0x0002, 0x004E, 0x0323, 0x0002, 0x006E, 0x0323, 0x0002, 0x004E, 0x0331, 0x0002,
+  0x006E, 0x0331, 0x0002, 0x004E, 0x032D, 0x0002, 0x006E, 0x032D, 0x0003, 0x004F, 0x0303, 0x0301,
+  0x0003, 0x006F, 0x0303, 0x0301, 0x0003, 0x004F, 0x0303, 0x0308, 0x0003, 0x006F, 0x0303, 0x0308,
+  0x0003, 0x004F, 0x0304, 0x0300, 0x0003, 0x006F, 0x0304, 0x0300, 0x0003, 0x004F, 0x0304, 0x0301,
+  0x0003, 0x006F, 0x0304, 0x0301, 0x0002, 0x0050, 0x0301, 0x0002, 0x0070, 0x0301, 0x0002, 0x0050,
+  0x0307, 0x0002, 0x0070, 0x0307, 0x0002, 0x0052, 0x0307, 0x0002, 0x0072, 0x0307, 0x0002, 0x0052,
+  0x0323, 0x0002, 0x0072, 0x0323, 0x0003, 0x0052, 0x0323, 0x0304, 0x0003, 0x0072, 0x0323, 0x0304,
+  0x0002, 0x0052, 0x0331, 0x0002, 0x0072, 0x0331, 0x0002, 0x0053, 0x0307, 0x0002, 0x0073, 0x0307,
+  0x0002, 0x0053, 0x0323, 0x0002, 0x0073, 0x0323, 0x0003, 0x0053, 0x0301, 0x0307, 0x0003, 0x0073,
+  0x0301, 0x0307, 0x0003, 0x0053, 0x030C, 0x0307, 0x0003, 0x0073, 0x030C, 0x0307, 0x0003, 0x0053,
+  0x0323, 0x0307, 0x0003, 0x0073, 0x0323, 0x0307, 0x0002, 0x0054, 0x0307, 0x0002, 0x0074, 0x0307,
+  0x0002, 0x0054, 0x0323, 0x0002, 0x0074, 0x0323, 0x0002, 0x0054, 0x0331, 0x0002, 0x0074, 0x0331,
+  0x0002, 0x0054, 0x032D, 0x0002, 0x0074, 0x032D, 0x0002, 0x0055, 0x0324, 0x0002, 0x0075, 0x0324,
+  0x0002, 0x0055, 0x0330, 0x0002, 0x0075, 0x0330, 0x0002, 0x0055, 0x032D, 0x0002, 0x0075, 0x032D,
+  0x0003, 0x0055, 0x0303, 0x0301, 0x0003, 0x0075, 0x0303, 0x0301, 0x0003, 0x0055, 0x0304, 0x0308,
+  0x0003, 0x0075, 0x0304, 0x0308, 0x0002, 0x0056, 0x0303, 0x0002, 0x0076, 0x0303, 0x0002, 0x0056,
+  0x0323, 0x0002, 0x0076, 0x0323, 0x0002, 0x0057, 0x0300, 0x0002, 0x0077, 0x0300, 0x0002, 0x0057,
+  0x0301, 0x0002, 0x0077, 0x0301, 0x0002, 0x0057, 0x0308, 0x0002, 0x0077, 0x0308, 0x0002, 0x0057,
+  0x0307, 0x0002, 0x0077, 0x0307, 0x0002, 0x0057, 0x0323, 0x0002, 0x0077, 0x0323, 0x0002, 0x0058,
+  0x0307, 0x0002, 0x0078, 0x0307, 0x0002, 0x0058, 0x0308, 0x0002, 0x0078, 0x0308, 0x0002, 0x0059,
+  0x0307, 0x0002, 0x0079, 0x0307, 0x0002, 0x005A, 0x0302, 0x0002, 0x007A, 0x0302, 0x0002, 0x005A,
+  0x0323, 0x0002, 0x007A, 0x0323, 0x0002, 0x005A, 0x0331, 0x0002, 0x007A, 0x0331, 0x0002, 0x0068,
+  0x0331, 0x0002, 0x0074, 0x0308, 0x0002, 0x0077, 0x030A, 0x0002, 0x0079, 0x030A, 0x0002, 0x0061,
+  0x02BE, 0x0002, 0x017F, 0x0307, 0x0002, 0x0041, 0x0323, 0x0002, 0x0061, 0x0323, 0x0002, 0x0041,
+  0x0309, 0x0002, 0x0061, 0x0309, 0x0003, 0x0041, 0x0302, 0x0301, 0x0003, 0x0061, 0x0302, 0x0301,
+  0x0003, 0x0041, 0x0302, 0x0300, 0x0003, 0x0061, 0x0302, 0x0300, 0x0003, 0x0041, 0x0302, 0x0309,
+  0x0003, 0x0061, 0x0302, 0x0309, 0x0003, 0x0041, 0x0302, 0x0303, 0x0003, 0x0061, 0x0302, 0x0303,
+  0x0003, 0x0041, 0x0323, 0x0302, 0x0003, 0x0061, 0x0323, 0x0302, 0x0003, 0x0041, 0x0306, 0x0301,
+  0x0003, 0x0061, 0x0306, 0x0301, 0x0003, 0x0041, 0x0306, 0x0300, 0x0003, 0x0061, 0x0306, 0x0300,
+  0x0003, 0x0041, 0x0306, 0x0309, 0x0003, 0x0061, 0x0306, 0x0309, 0x0003, 0x0041, 0x0306, 0x0303,
+  0x0003, 0x0061, 0x0306, 0x0303, 0x0003, 0x0041, 0x0323, 0x0306, 0x0003, 0x0061, 0x0323, 0x0306,
+  0x0002, 0x0045, 0x0323, 0x0002, 0x0065, 0x0323, 0x0002, 0x0045, 0x0309, 0x0002, 0x0065, 0x0309,
+  0x0002, 0x0045, 0x0303, 0x0002, 0x0065, 0x0303, 0x0003, 0x0045, 0x0302, 0x0301, 0x0003, 0x0065,
+  0x0302, 0x0301, 0x0003, 0x0045, 0x0302, 0x0300, 0x0003, 0x0065, 0x0302, 0x0300, 0x0003, 0x0045,
+  0x0302, 0x0309, 0x0003, 0x0065, 0x0302, 0x0309, 0x0003, 0x0045, 0x0302, 0x0303, 0x0003, 0x0065,
+  0x0302, 0x0303, 0x0003, 0x0045, 0x0323, 0x0302, 0x0003, 0x0065, 0x0323, 0x0302, 0x0002, 0x0049,
+  0x0309, 0x0002, 0x0069, 0x0309, 0x0002, 0x0049, 0x0323, 0x0002, 0x0069, 0x0323, 0x0002, 0x004F,
+  0x0323, 0x0002, 0x006F, 0x0323, 0x0002, 0x004F, 0x0309, 0x0002, 0x006F, 0x0309, 0x0003, 0x004F,
+  0x0302, 0x0301, 0x0003, 0x006F, 0x0302, 0x0301, 0x0003, 0x004F, 0x0302, 0x0300, 0x0003, 0x006F,
+  0x0302, 0x0300, 0x0003, 0x004F, 0x0302, 0x0309, 0x0003, 0x006F, 0x0302, 0x0309, 0x0003, 0x004F,
+  0x0302, 0x0303, 0x0003, 0x006F, 0x0302, 0x0303, 0x0003, 0x004F, 0x0323, 0x0302, 0x0003, 0x006F,
+  0x0323, 0x0302, 0x0003, 0x004F, 0x031B, 0x0301, 0x0003, 0x006F, 0x031B, 0x0301, 0x0003, 0x004F,
+  0x031B, 0x0300, 0x0003, 0x006F, 0x031B, 0x0300, 0x0003, 0x004F, 0x031B, 0x0309, 0x0003, 0x006F,
+  0x031B, 0x0309, 0x0003, 0x004F, 0x031B, 0x0303, 0x0003, 0x006F, 0x031B, 0x0303, 0x0003, 0x004F,
+  0x031B, 0x0323, 0x0003, 0x006F, 0x031B, 0x0323, 0x0002, 0x0055, 0x0323, 0x0002, 0x0075, 0x0323,
+  0x0002, 0x0055, 0x0309, 0x0002, 0x0075, 0x0309, 0x0003, 0x0055, 0x031B, 0x0301, 0x0003, 0x0075,
+  0x031B, 0x0301, 0x0003, 0x0055, 0x031B, 0x0300, 0x0003, 0x0075, 0x031B, 0x0300, 0x0003, 0x0055,
+  0x031B, 0x0309, 0x0003, 0x0075, 0x031B, 0x0309, 0x0003, 0x0055, 0x031B, 0x0303, 0x0003, 0x0075,
+  0x031B, 0x0303, 0x0003, 0x0055, 0x031B, 0x0323, 0x0003, 0x0075, 0x031B, 0x0323, 0x0002, 0x0059,
+  0x0300, 0x0002, 0x0079, 0x0300, 0x0002, 0x0059, 0x0323, 0x0002, 0x0079, 0x0323, 0x0002, 0x0059,
+  0x0309, 0x0002, 0x0079, 0x0309, 0x0002, 0x0059, 0x0303, 0x0002, 0x0079, 0x0303, 0x0002, 0x03B1,
+  0x0313, 0x0002, 0x03B1, 0x0314, 0x0003, 0x03B1, 0x0313, 0x0300, 0x0003, 0x03B1, 0x0314, 0x0300,
+  0x0003, 0x03B1, 0x0313, 0x0301, 0x0003, 0x03B1, 0x0314, 0x0301, 0x0003, 0x03B1, 0x0313, 0x0342,
+  0x0003, 0x03B1, 0x0314, 0x0342, 0x0002, 0x0391, 0x0313, 0x0002, 0x0391, 0x0314, 0x0003, 0x0391,
+  0x0313, 0x0300, 0x0003, 0x0391, 0x0314, 0x0300, 0x0003, 0x0391, 0x0313, 0x0301, 0x0003, 0x0391,
+  0x0314, 0x0301, 0x0003, 0x0391, 0x0313, 0x0342, 0x0003, 0x0391, 0x0314, 0x0342, 0x0002, 0x03B5,
+  0x0313, 0x0002, 0x03B5, 0x0314, 0x0003, 0x03B5, 0x0313, 0x0300, 0x0003, 0x03B5, 0x0314, 0x0300,
+  0x0003, 0x03B5, 0x0313, 0x0301, 0x0003, 0x03B5, 0x0314, 0x0301, 0x0002, 0x0395, 0x0313, 0x0002,
+  0x0395, 0x0314, 0x0003, 0x0395, 0x0313, 0x0300, 0x0003, 0x0395, 0x0314, 0x0300, 0x0003, 0x0395,
+  0x0313, 0x0301, 0x0003, 0x0395, 0x0314, 0x0301, 0x0002, 0x03B7, 0x0313, 0x0002, 0x03B7, 0x0314,
+  0x0003, 0x03B7, 0x0313, 0x0300, 0x0003, 0x03B7, 0x0314, 0x0300, 0x0003, 0x03B7, 0x0313, 0x0301,
+  0x0003, 0x03B7, 0x0314, 0x0301, 0x0003, 0x03B7, 0x0313, 0x0342, 0x0003, 0x03B7, 0x0314, 0x0342,
+  0x0002, 0x0397, 0x0313, 0x0002, 0x0397, 0x0314, 0x0003, 0x0397, 0x0313, 0x0300, 0x0003, 0x0397,
+  0x0314, 0x0300, 0x0003, 0x0397, 0x0313, 0x0301, 0x0003, 0x0397, 0x0314, 0x0301, 0x0003, 0x0397,
+  0x0313, 0x0342, 0x0003, 0x0397, 0x0314, 0x0342, 0x0002, 0x03B9, 0x0313, 0x0002, 0x03B9, 0x0314,
+  0x0003, 0x03B9, 0x0313, 0x0300, 0x0003, 0x03B9, 0x0314, 0x0300, 0x0003, 0x03B9, 0x0313, 0x0301,
+  0x0003, 0x03B9, 0x0314, 0x0301, 0x0003, 0x03B9, 0x0313, 0x0342, 0x0003, 0x03B9, 0x0314, 0x0342,
+  0x0002, 0x0399, 0x0313, 0x0002, 0x0399, 0x0314, 0x0003, 0x0399, 0x0313, 0x0300, 0x0003, 0x0399,
+  0x0314, 0x0300, 0x0003, 0x0399, 0x0313, 0x0301, 0x0003, 0x0399, 0x0314, 0x0301, 0x0003, 0x0399,
+  0x0313, 0x0342, 0x0003, 0x0399, 0x0314, 0x0342, 0x0002, 0x03BF, 0x0313, 0x0002, 0x03BF, 0x0314,
+  0x0003, 0x03BF, 0x0313, 0x0300, 0x0003, 0x03BF, 0x0314, 0x0300, 0x0003, 0x03BF, 0x0313, 0x0301,
+  0x0003, 0x03BF, 0x0314, 0x0301, 0x0002, 0x039F, 0x0313, 0x0002, 0x039F, 0x0314, 0x0003, 0x039F,
+  0x0313, 0x0300, 0x0003, 0x039F, 0x0314, 0x0300, 0x0003, 0x039F, 0x0313, 0x0301, 0x0003, 0x039F,
+  0x0314, 0x0301, 0x0002, 0x03C5, 0x0313, 0x0002, 0x03C5, 0x0314, 0x0003, 0x03C5, 0x0313, 0x0300,
+  0x0003, 0x03C5, 0x0314, 0x0300, 0x0003, 0x03C5, 0x0313, 0x0301, 0x0003, 0x03C5, 0x0314, 0x0301,
+  0x0003, 0x03C5, 0x0313, 0x0342, 0x0003, 0x03C5, 0x0314, 0x0342, 0x0002, 0x03A5, 0x0314, 0x0003,
+  0x03A5, 0x0314, 0x0300, 0x0003, 0x03A5, 0x0314, 0x0301, 0x0003, 0x03A5, 0x0314, 0x0342, 0x0002,
+  0x03C9, 0x0313, 0x0002, 0x03C9, 0x0314, 0x0003, 0x03C9, 0x0313, 0x0300, 0x0003, 0x03C9, 0x0314,
+  0x0300, 0x0003, 0x03C9, 0x0313, 0x0301, 0x0003, 0x03C9, 0x0314, 0x0301, 0x0003, 0x03C9, 0x0313,
+  0x0342, 0x0003, 0x03C9, 0x0314, 0x0342, 0x0002, 0x03A9, 0x0313, 0x0002, 0x03A9, 0x0314, 0x0003,
+  0x03A9, 0x0313, 0x0300, 0x0003, 0x03A9, 0x0314, 0x0300, 0x0003, 0x03A9, 0x0313, 0x0301, 0x0003,
+  0x03A9, 0x0314, 0x0301, 0x0003, 0x03A9, 0x0313, 0x0342, 0x0003, 0x03A9, 0x0314, 0x0342, 0x0002,
+  0x03B1, 0x0300, 0x0002, 0x03B5, 0x0300, 0x0002, 0x03B7, 0x0300, 0x0002, 0x03B9, 0x0300, 0x0002,
+  0x03BF, 0x0300, 0x0002, 0x03C5, 0x0300, 0x0002, 0x03C9, 0x0300, 0x0003, 0x03B1, 0x0313, 0x0345,
+  0x0003, 0x03B1, 0x0314, 0x0345, 0x0004, 0x03B1, 0x0313, 0x0300, 0x0345, 0x0004, 0x03B1, 0x0314,
+  0x0300, 0x0345, 0x0004, 0x03B1, 0x0313, 0x0301, 0x0345, 0x0004, 0x03B1, 0x0314, 0x0301, 0x0345,
+  0x0004, 0x03B1, 0x0313, 0x0342, 0x0345, 0x0004, 0x03B1, 0x0314, 0x0342, 0x0345, 0x0003, 0x0391,
+  0x0313, 0x0345, 0x0003, 0x0391, 0x0314, 0x0345, 0x0004, 0x0391, 0x0313, 0x0300, 0x0345, 0x0004,
+  0x0391, 0x0314, 0x0300, 0x0345, 0x0004, 0x0391, 0x0313, 0x0301, 0x0345, 0x0004, 0x0391, 0x0314,
+  0x0301, 0x0345, 0x0004, 0x0391, 0x0313, 0x0342, 0x0345, 0x0004, 0x0391, 0x0314, 0x0342, 0x0345,
+  0x0003, 0x03B7, 0x0313, 0x0345, 0x0003, 0x03B7, 0x0314, 0x0345, 0x0004, 0x03B7, 0x0313, 0x0300,
+  0x0345, 0x0004, 0x03B7, 0x0314, 0x0300, 0x0345, 0x0004, 0x03B7, 0x0313, 0x0301, 0x0345, 0x0004,
+  0x03B7, 0x0314, 0x0301, 0x0345, 0x0004, 0x03B7, 0x0313, 0x0342, 0x0345, 0x0004, 0x03B7, 0x0314,
+  0x0342, 0x0345, 0x0003, 0x0397, 0x0313, 0x0345, 0x0003, 0x0397, 0x0314, 0x0345, 0x0004, 0x0397,
+  0x0313, 0x0300, 0x0345, 0x0004, 0x0397, 0x0314, 0x0300, 0x0345, 0x0004, 0x0397, 0x0313, 0x0301,
+  0x0345, 0x0004, 0x0397, 0x0314, 0x0301, 0x0345, 0x0004, 0x0397, 0x0313, 0x0342, 0x0345, 0x0004,
+  0x0397, 0x0314, 0x0342, 0x0345, 0x0003, 0x03C9, 0x0313, 0x0345, 0x0003, 0x03C9, 0x0314, 0x0345,
+  0x0004, 0x03C9, 0x0313, 0x0300, 0x0345, 0x0004, 0x03C9, 0x0314, 0x0300, 0x0345, 0x0004, 0x03C9,
+  0x0313, 0x0301, 0x0345, 0x0004, 0x03C9, 0x0314, 0x0301, 0x0345, 0x0004, 0x03C9, 0x0313, 0x0342,
+  0x0345, 0x0004, 0x03C9, 0x0314, 0x0342, 0x0345, 0x0003, 0x03A9, 0x0313, 0x0345, 0x0003, 0x03A9,
+  0x0314, 0x0345, 0x0004, 0x03A9, 0x0313, 0x0300, 0x0345, 0x0004, 0x03A9, 0x0314, 0x0300, 0x0345,
+  0x0004, 0x03A9, 0x0313, 0x0301, 0x0345, 0x0004, 0x03A9, 0x0314, 0x0301, 0x0345, 0x0004, 0x03A9,
+  0x0313, 0x0342, 0x0345, 0x0004, 0x03A9, 0x0314, 0x0342, 0x0345, 0x0002, 0x03B1, 0x0306, 0x0002,
+  0x03B1, 0x0304, 0x0003, 0x03B1, 0x0300, 0x0345, 0x0002, 0x03B1, 0x0345, 0x0003, 0x03B1, 0x0301,
+  0x0345, 0x0002, 0x03B1, 0x0342, 0x0003, 0x03B1, 0x0342, 0x0345, 0x0002, 0x0391, 0x0306, 0x0002,
+  0x0391, 0x0304, 0x0002, 0x0391, 0x0300, 0x0002, 0x0391, 0x0345, 0x0002, 0x0020, 0x0313, 0x0001,
+  0x03B9, 0x0002, 0x0020, 0x0342, 0x0002, 0x00A8, 0x0342, 0x0003, 0x0020, 0x0308, 0x0342, 0x0003,
+  0x03B7, 0x0300, 0x0345, 0x0002, 0x03B7, 0x0345, 0x0003, 0x03B7, 0x0301, 0x0345, 0x0002, 0x03B7,
+  0x0342, 0x0003, 0x03B7, 0x0342, 0x0345, 0x0002, 0x0395, 0x0300, 0x0002, 0x0397, 0x0300, 0x0002,
+  0x0397, 0x0345, 0x0002, 0x1FBF, 0x0300, 0x0003, 0x0020, 0x0313, 0x0300, 0x0002, 0x1FBF, 0x0301,
+  0x0003, 0x0020, 0x0313, 0x0301, 0x0002, 0x1FBF, 0x0342, 0x0003, 0x0020, 0x0313, 0x0342, 0x0002,
+  0x03B9, 0x0306, 0x0002, 0x03B9, 0x0304, 0x0003, 0x03B9, 0x0308, 0x0300, 0x0002, 0x03B9, 0x0342,
+  0x0003, 0x03B9, 0x0308, 0x0342, 0x0002, 0x0399, 0x0306, 0x0002, 0x0399, 0x0304, 0x0002, 0x0399,
+  0x0300, 0x0002, 0x1FFE, 0x0300, 0x0003, 0x0020, 0x0314, 0x0300, 0x0002, 0x1FFE, 0x0301, 0x0003,
+  0x0020, 0x0314, 0x0301, 0x0002, 0x1FFE, 0x0342, 0x0003, 0x0020, 0x0314, 0x0342, 0x0002, 0x03C5,
+  0x0306, 0x0002, 0x03C5, 0x0304, 0x0003, 0x03C5, 0x0308, 0x0300, 0x0002, 0x03C1, 0x0313, 0x0002,
+  0x03C1, 0x0314, 0x0002, 0x03C5, 0x0342, 0x0003, 0x03C5, 0x0308, 0x0342, 0x0002, 0x03A5, 0x0306,
+  0x0002, 0x03A5, 0x0304, 0x0002, 0x03A5, 0x0300, 0x0002, 0x03A1, 0x0314, 0x0002, 0x00A8, 0x0300,
+  0x0003, 0x0020, 0x0308, 0x0300, 0x0001, 0x0060, 0x0003, 0x03C9, 0x0300, 0x0345, 0x0002, 0x03C9,
+  0x0345, 0x0003, 0x03C9, 0x0301, 0x0345, 0x0002, 0x03C9, 0x0342, 0x0003, 0x03C9, 0x0342, 0x0345,
+  0x0002, 0x039F, 0x0300, 0x0002, 0x03A9, 0x0300, 0x0002, 0x03A9, 0x0345, 0x0001, 0x00B4, 0x0002,
+  0x0020, 0x0314, 0x0001, 0x2002, 0x0001, 0x2003, 0x0001, 0x2010, 0x0002, 0x0020, 0x0333, 0x0001,
+  0x002E, 0x0002, 0x002E, 0x002E, 0x0003, 0x002E, 0x002E, 0x002E, 0x0002, 0x2032, 0x2032, 0x0003,
+  0x2032, 0x2032, 0x2032, 0x0002, 0x2035, 0x2035, 0x0003, 0x2035, 0x2035, 0x2035, 0x0002, 0x0021,
+  0x0021, 0x0002, 0x0020, 0x0305, 0x0002, 0x003F, 0x003F, 0x0002, 0x003F, 0x0021, 0x0002, 0x0021,
+  0x003F, 0x0004, 0x2032, 0x2032, 0x2032, 0x2032, 0x0001, 0x0030, 0x0001, 0x0034, 0x0001, 0x0035,
+  0x0001, 0x0036, 0x0001, 0x0037, 0x0001, 0x0038, 0x0001, 0x0039, 0x0001, 0x002B, 0x0001, 0x2212,
+  0x0001, 0x003D, 0x0001, 0x0028, 0x0001, 0x0029, 0x0001, 0x006E, 0x0002, 0x0052, 0x0073, 0x0003,
+  0x0061, 0x002F, 0x0063, 0x0003, 0x0061, 0x002F, 0x0073, 0x0001, 0x0043, 0x0002, 0x00B0, 0x0043,
+  0x0003, 0x0063, 0x002F, 0x006F, 0x0003, 0x0063, 0x002F, 0x0075, 0x0001, 0x0190, 0x0002, 0x00B0,
+  0x0046, 0x0001, 0x0127, 0x0002, 0x004E, 0x006F, 0x0001, 0x0051, 0x0002, 0x0053, 0x004D, 0x0003,
+  0x0054, 0x0045, 0x004C, 0x0002, 0x0054, 0x004D, 0x0001, 0x005A, 0x0001, 0x03A9, 0x0001, 0x0046,
+  0x0001, 0x05D0, 0x0001, 0x05D1, 0x0001, 0x05D2, 0x0001, 0x05D3, 0x0003, 0x0046, 0x0041, 0x0058,
+  0x0001, 0x0393, 0x0001, 0x03A0, 0x0001, 0x2211, 0x0003, 0x0031, 0x2044, 0x0037, 0x0003, 0x0031,
+  0x2044, 0x0039, 0x0004, 0x0031, 0x2044, 0x0031, 0x0030, 0x0003, 0x0031, 0x2044, 0x0033, 0x0003,
+  0x0032, 0x2044, 0x0033, 0x0003, 0x0031, 0x2044, 0x0035, 0x0003, 0x0032, 0x2044, 0x0035, 0x0003,
+  0x0033, 0x2044, 0x0035, 0x0003, 0x0034, 0x2044, 0x0035, 0x0003, 0x0031, 0x2044, 0x0036, 0x0003,
+  0x0035, 0x2044, 0x0036, 0x0003, 0x0031, 0x2044, 0x0038, 0x0003, 0x0033, 0x2044, 0x0038, 0x0003,
+  0x0035, 0x2044, 0x0038, 0x0003, 0x0037, 0x2044, 0x0038, 0x0002, 0x0031, 0x2044, 0x0002, 0x0049,
+  0x0049, 0x0003, 0x0049, 0x0049, 0x0049, 0x0002, 0x0049, 0x0056, 0x0001, 0x0056, 0x0002, 0x0056,
+  0x0049, 0x0003, 0x0056, 0x0049, 0x0049, 0x0004, 0x0056, 0x0049, 0x0049, 0x0049, 0x0002, 0x0049,
+  0x0058, 0x0001, 0x0058, 0x0002, 0x0058, 0x0049, 0x0003, 0x0058, 0x0049, 0x0049, 0x0002, 0x0069,
+  0x0069, 0x0003, 0x0069, 0x0069, 0x0069, 0x0002, 0x0069, 0x0076, 0x0002, 0x0076, 0x0069, 0x0003,
+  0x0076, 0x0069, 0x0069, 0x0004, 0x0076, 0x0069, 0x0069, 0x0069, 0x0002, 0x0069, 0x0078, 0x0002,
+  0x0078, 0x0069, 0x0003, 0x0078, 0x0069, 0x0069, 0x0003, 0x0030, 0x2044, 0x0033, 0x0002, 0x2190,
+  0x0338, 0x0002, 0x2192, 0x0338, 0x0002, 0x2194, 0x0338, 0x0002, 0x21D0, 0x0338, 0x0002, 0x21D4,
+  0x0338, 0x0002, 0x21D2, 0x0338, 0x0002, 0x2203, 0x0338, 0x0002, 0x2208, 0x0338, 0x0002, 0x220B,
+  0x0338, 0x0002, 0x2223, 0x0338, 0x0002, 0x2225, 0x0338, 0x0002, 0x222B, 0x222B, 0x0003, 0x222B,
+  0x222B, 0x222B, 0x0002, 0x222E, 0x222E, 0x0003, 0x222E, 0x222E, 0x222E, 0x0002, 0x223C, 0x0338,
+  0x0002, 0x2243, 0x0338, 0x0002, 0x2245, 0x0338, 0x0002, 0x2248, 0x0338, 0x0002, 0x003D, 0x0338,
+  0x0002, 0x2261, 0x0338, 0x0002, 0x224D, 0x0338, 0x0002, 0x003C, 0x0338, 0x0002, 0x003E, 0x0338,
+  0x0002, 0x2264, 0x0338, 0x0002, 0x2265, 0x0338, 0x0002, 0x2272, 0x0338, 0x0002, 0x2273, 0x0338,
+  0x0002, 0x2276, 0x0338, 0x0002, 0x2277, 0x0338, 0x0002, 0x227A, 0x0338, 0x0002, 0x227B, 0x0338,
+  0x0002, 0x2282, 0x0338, 0x0002, 0x2283, 0x0338, 0x0002, 0x2286, 0x0338, 0x0002, 0x2287, 0x0338,
+  0x0002, 0x22A2, 0x0338, 0x0002, 0x22A8, 0x0338, 0x0002, 0x22A9, 0x0338, 0x0002, 0x22AB, 0x0338,
+  0x0002, 0x227C, 0x0338, 0x0002, 0x227D, 0x0338, 0x0002, 0x2291, 0x0338, 0x0002, 0x2292, 0x0338,
+  0x0002, 0x22B2, 0x0338, 0x0002, 0x22B3, 0x0338, 0x0002, 0x22B4, 0x0338, 0x0002, 0x22B5, 0x0338,
+  0x0001, 0x3008, 0x0001, 0x3009, 0x0002, 0x0031, 0x0030, 0x0002, 0x0031, 0x0031, 0x0002, 0x0031,
+  0x0032, 0x0002, 0x0031, 0x0033, 0x0002, 0x0031, 0x0034, 0x0002, 0x0031, 0x0035, 0x0002, 0x0031,
+  0x0036, 0x0002, 0x0031, 0x0037, 0x0002, 0x0031, 0x0038, 0x0002, 0x0031, 0x0039, 0x0002, 0x0032,
+  0x0030, 0x0003, 0x0028, 0x0031, 0x0029, 0x0003, 0x0028, 0x0032, 0x0029, 0x0003, 0x0028, 0x0033,
+  0x0029, 0x0003, 0x0028, 0x0034, 0x0029, 0x0003, 0x0028, 0x0035, 0x0029, 0x0003, 0x0028, 0x0036,
+  0x0029, 0x0003, 0x0028, 0x0037, 0x0029, 0x0003, 0x0028, 0x0038, 0x0029, 0x0003, 0x0028, 0x0039,
+  0x0029, 0x0004, 0x0028, 0x0031, 0x0030, 0x0029, 0x0004, 0x0028, 0x0031, 0x0031, 0x0029, 0x0004,
+  0x0028, 0x0031, 0x0032, 0x0029, 0x0004, 0x0028, 0x0031, 0x0033, 0x0029, 0x0004, 0x0028, 0x0031,
+  0x0034, 0x0029, 0x0004, 0x0028, 0x0031, 0x0035, 0x0029, 0x0004, 0x0028, 0x0031, 0x0036, 0x0029,
+  0x0004, 0x0028, 0x0031, 0x0037, 0x0029, 0x0004, 0x0028, 0x0031, 0x0038, 0x0029, 0x0004, 0x0028,
+  0x0031, 0x0039, 0x0029, 0x0004, 0x0028, 0x0032, 0x0030, 0x0029, 0x0002, 0x0031, 0x002E, 0x0002,
+  0x0032, 0x002E, 0x0002, 0x0033, 0x002E, 0x0002, 0x0034, 0x002E, 0x0002, 0x0035, 0x002E, 0x0002,
+  0x0036, 0x002E, 0x0002, 0x0037, 0x002E, 0x0002, 0x0038, 0x002E, 0x0002, 0x0039, 0x002E, 0x0003,
+  0x0031, 0x0030, 0x002E, 0x0003, 0x0031, 0x0031, 0x002E, 0x0003, 0x0031, 0x0032, 0x002E, 0x0003,
+  0x0031, 0x0033, 0x002E, 0x0003, 0x0031, 0x0034, 0x002E, 0x0003, 0x0031, 0x0035, 0x002E, 0x0003,
+  0x0031, 0x0036, 0x002E, 0x0003, 0x0031, 0x0037, 0x002E, 0x0003, 0x0031, 0x0038, 0x002E, 0x0003,
+  0x0031, 0x0039, 0x002E, 0x0003, 0x0032, 0x0030, 0x002E, 0x0003, 0x0028, 0x0061, 0x0029, 0x0003,
+  0x0028, 0x0062, 0x0029, 0x0003, 0x0028, 0x0063, 0x0029, 0x0003, 0x0028, 0x0064, 0x0029, 0x0003,
+  0x0028, 0x0065, 0x0029, 0x0003, 0x0028, 0x0066, 0x0029, 0x0003, 0x0028, 0x0067, 0x0029, 0x0003,
+  0x0028, 0x0068, 0x0029, 0x0003, 0x0028, 0x0069, 0x0029, 0x0003, 0x0028, 0x006A, 0x0029, 0x0003,
+  0x0028, 0x006B, 0x0029, 0x0003, 0x0028, 0x006C, 0x0029, 0x0003, 0x0028, 0x006D, 0x0029, 0x0003,
+  0x0028, 0x006E, 0x0029, 0x0003, 0x0028, 0x006F, 0x0029, 0x0003, 0x0028, 0x0070, 0x0029, 0x0003,
+  0x0028, 0x0071, 0x0029, 0x0003, 0x0028, 0x0072, 0x0029, 0x0003, 0x0028, 0x0073, 0x0029, 0x0003,
+  0x0028, 0x0074, 0x0029, 0x0003, 0x0028, 0x0075, 0x0029, 0x0003, 0x0028, 0x0076, 0x0029, 0x0003,
+  0x0028, 0x0077, 0x0029, 0x0003, 0x0028, 0x0078, 0x0029, 0x0003, 0x0028, 0x0079, 0x0029, 0x0003,
+  0x0028, 0x007A, 0x0029, 0x0001, 0x0053, 0x0001, 0x0059, 0x0001, 0x0071, 0x0004, 0x222B, 0x222B,
+  0x222B, 0x222B, 0x0003, 0x003A, 0x003A, 0x003D, 0x0002, 0x003D, 0x003D, 0x0003, 0x003D, 0x003D,
+  0x003D, 0x0002, 0x2ADD, 0x0338, 0x0001, 0x2D61, 0x0001, 0x6BCD, 0x0001, 0x9F9F, 0x0001, 0x4E00,
+  0x0001, 0x4E28, 0x0001, 0x4E36, 0x0001, 0x4E3F, 0x0001, 0x4E59, 0x0001, 0x4E85, 0x0001, 0x4E8C,
+  0x0001, 0x4EA0, 0x0001, 0x4EBA, 0x0001, 0x513F, 0x0001, 0x5165, 0x0001, 0x516B, 0x0001, 0x5182,
+  0x0001, 0x5196, 0x0001, 0x51AB, 0x0001, 0x51E0, 0x0001, 0x51F5, 0x0001, 0x5200, 0x0001, 0x529B,
+  0x0001, 0x52F9, 0x0001, 0x5315, 0x0001, 0x531A, 0x0001, 0x5338, 0x0001, 0x5341, 0x0001, 0x535C,
+  0x0001, 0x5369, 0x0001, 0x5382, 0x0001, 0x53B6, 0x0001, 0x53C8, 0x0001, 0x53E3, 0x0001, 0x56D7,
+  0x0001, 0x571F, 0x0001, 0x58EB, 0x0001, 0x5902, 0x0001, 0x590A, 0x0001, 0x5915, 0x0001, 0x5927,
+  0x0001, 0x5973, 0x0001, 0x5B50, 0x0001, 0x5B80, 0x0001, 0x5BF8, 0x0001, 0x5C0F, 0x0001, 0x5C22,
+  0x0001, 0x5C38, 0x0001, 0x5C6E, 0x0001, 0x5C71, 0x0001, 0x5DDB, 0x0001, 0x5DE5, 0x0001, 0x5DF1,
+  0x0001, 0x5DFE, 0x0001, 0x5E72, 0x0001, 0x5E7A, 0x0001, 0x5E7F, 0x0001, 0x5EF4, 0x0001, 0x5EFE,
+  0x0001, 0x5F0B, 0x0001, 0x5F13, 0x0001, 0x5F50, 0x0001, 0x5F61, 0x0001, 0x5F73, 0x0001, 0x5FC3,
+  0x0001, 0x6208, 0x0001, 0x6236, 0x0001, 0x624B, 0x0001, 0x652F, 0x0001, 0x6534, 0x0001, 0x6587,
+  0x0001, 0x6597, 0x0001, 0x65A4, 0x0001, 0x65B9, 0x0001, 0x65E0, 0x0001, 0x65E5, 0x0001, 0x66F0,
+  0x0001, 0x6708, 0x0001, 0x6728, 0x0001, 0x6B20, 0x0001, 0x6B62, 0x0001, 0x6B79, 0x0001, 0x6BB3,
+  0x0001, 0x6BCB, 0x0001, 0x6BD4, 0x0001, 0x6BDB, 0x0001, 0x6C0F, 0x0001, 0x6C14, 0x0001, 0x6C34,
+  0x0001, 0x706B, 0x0001, 0x722A, 0x0001, 0x7236, 0x0001, 0x723B, 0x0001, 0x723F, 0x0001, 0x7247,
+  0x0001, 0x7259, 0x0001, 0x725B, 0x0001, 0x72AC, 0x0001, 0x7384, 0x0001, 0x7389, 0x0001, 0x74DC,
+  0x0001, 0x74E6, 0x0001, 0x7518, 0x0001, 0x751F, 0x0001, 0x7528, 0x0001, 0x7530, 0x0001, 0x758B,
+  0x0001, 0x7592, 0x0001, 0x7676, 0x0001, 0x767D, 0x0001, 0x76AE, 0x0001, 0x76BF, 0x0001, 0x76EE,
+  0x0001, 0x77DB, 0x0001, 0x77E2, 0x0001, 0x77F3, 0x0001, 0x793A, 0x0001, 0x79B8, 0x0001, 0x79BE,
+  0x0001, 0x7A74, 0x0001, 0x7ACB, 0x0001, 0x7AF9, 0x0001, 0x7C73, 0x0001, 0x7CF8, 0x0001, 0x7F36,
+  0x0001, 0x7F51, 0x0001, 0x7F8A, 0x0001, 0x7FBD, 0x0001, 0x8001, 0x0001, 0x800C, 0x0001, 0x8012,
+  0x0001, 0x8033, 0x0001, 0x807F, 0x0001, 0x8089, 0x0001, 0x81E3, 0x0001, 0x81EA, 0x0001, 0x81F3,
+  0x0001, 0x81FC, 0x0001, 0x820C, 0x0001, 0x821B, 0x0001, 0x821F, 0x0001, 0x826E, 0x0001, 0x8272,
+  0x0001, 0x8278, 0x0001, 0x864D, 0x0001, 0x866B, 0x0001, 0x8840, 0x0001, 0x884C, 0x0001, 0x8863,
+  0x0001, 0x897E, 0x0001, 0x898B, 0x0001, 0x89D2, 0x0001, 0x8A00, 0x0001, 0x8C37, 0x0001, 0x8C46,
+  0x0001, 0x8C55, 0x0001, 0x8C78, 0x0001, 0x8C9D, 0x0001, 0x8D64, 0x0001, 0x8D70, 0x0001, 0x8DB3,
+  0x0001, 0x8EAB, 0x0001, 0x8ECA, 0x0001, 0x8F9B, 0x0001, 0x8FB0, 0x0001, 0x8FB5, 0x0001, 0x9091,
+  0x0001, 0x9149, 0x0001, 0x91C6, 0x0001, 0x91CC, 0x0001, 0x91D1, 0x0001, 0x9577, 0x0001, 0x9580,
+  0x0001, 0x961C, 0x0001, 0x96B6, 0x0001, 0x96B9, 0x0001, 0x96E8, 0x0001, 0x9751, 0x0001, 0x975E,
+  0x0001, 0x9762, 0x0001, 0x9769, 0x0001, 0x97CB, 0x0001, 0x97ED, 0x0001, 0x97F3, 0x0001, 0x9801,
+  0x0001, 0x98A8, 0x0001, 0x98DB, 0x0001, 0x98DF, 0x0001, 0x9996, 0x0001, 0x9999, 0x0001, 0x99AC,
+  0x0001, 0x9AA8, 0x0001, 0x9AD8, 0x0001, 0x9ADF, 0x0001, 0x9B25, 0x0001, 0x9B2F, 0x0001, 0x9B32,
+  0x0001, 0x9B3C, 0x0001, 0x9B5A, 0x0001, 0x9CE5, 0x0001, 0x9E75, 0x0001, 0x9E7F, 0x0001, 0x9EA5,
+  0x0001, 0x9EBB, 0x0001, 0x9EC3, 0x0001, 0x9ECD, 0x0001, 0x9ED1, 0x0001, 0x9EF9, 0x0001, 0x9EFD,
+  0x0001, 0x9F0E, 0x0001, 0x9F13, 0x0001, 0x9F20, 0x0001, 0x9F3B, 0x0001, 0x9F4A, 0x0001, 0x9F52,
+  0x0001, 0x9F8D, 0x0001, 0x9F9C, 0x0001, 0x9FA0, 0x0001, 0x3012, 0x0001, 0x5344, 0x0001, 0x5345,
+  0x0002, 0x304B, 0x3099, 0x0002, 0x304D, 0x3099, 0x0002, 0x304F, 0x3099, 0x0002, 0x3051, 0x3099,
+  0x0002, 0x3053, 0x3099, 0x0002, 0x3055, 0x3099, 0x0002, 0x3057, 0x3099, 0x0002, 0x3059, 0x3099,
+  0x0002, 0x305B, 0x3099, 0x0002, 0x305D, 0x3099, 0x0002, 0x305F, 0x3099, 0x0002, 0x3061, 0x3099,
+  0x0002, 0x3064, 0x3099, 0x0002, 0x3066, 0x3099, 0x0002, 0x3068, 0x3099, 0x0002, 0x306F, 0x3099,
+  0x0002, 0x306F, 0x309A, 0x0002, 0x3072, 0x3099, 0x0002, 0x3072, 0x309A, 0x0002, 0x3075, 0x3099,
+  0x0002, 0x3075, 0x309A, 0x0002, 0x3078, 0x3099, 0x0002, 0x3078, 0x309A, 0x0002, 0x307B, 0x3099,
+  0x0002, 0x307B, 0x309A, 0x0002, 0x3046, 0x3099, 0x0002, 0x0020, 0x3099, 0x0002, 0x0020, 0x309A,
+  0x0002, 0x309D, 0x3099, 0x0002, 0x3088, 0x308A, 0x0002, 0x30AB, 0x3099, 0x0002, 0x30AD, 0x3099,
+  0x0002, 0x30AF, 0x3099, 0x0002, 0x30B1, 0x3099, 0x0002, 0x30B3, 0x3099, 0x0002, 0x30B5, 0x3099,
+  0x0002, 0x30B7, 0x3099, 0x0002, 0x30B9, 0x3099, 0x0002, 0x30BB, 0x3099, 0x0002, 0x30BD, 0x3099,
+  0x0002, 0x30BF, 0x3099, 0x0002, 0x30C1, 0x3099, 0x0002, 0x30C4, 0x3099, 0x0002, 0x30C6, 0x3099,
+  0x0002, 0x30C8, 0x3099, 0x0002, 0x30CF, 0x3099, 0x0002, 0x30CF, 0x309A, 0x0002, 0x30D2, 0x3099,
+  0x0002, 0x30D2, 0x309A, 0x0002, 0x30D5, 0x3099, 0x0002, 0x30D5, 0x309A, 0x0002, 0x30D8, 0x3099,
+  0x0002, 0x30D8, 0x309A, 0x0002, 0x30DB, 0x3099, 0x0002, 0x30DB, 0x309A, 0x0002, 0x30A6, 0x3099,
+  0x0002, 0x30EF, 0x3099, 0x0002, 0x30F0, 0x3099, 0x0002, 0x30F1, 0x3099, 0x0002, 0x30F2, 0x3099,
+  0x0002, 0x30FD, 0x3099, 0x0002, 0x30B3, 0x30C8, 0x0001, 0x1100, 0x0001, 0x1101, 0x0001, 0x11AA,
+  0x0001, 0x1102, 0x0001, 0x11AC, 0x0001, 0x11AD, 0x0001, 0x1103, 0x0001, 0x1104, 0x0001, 0x1105,
+  0x0001, 0x11B0, 0x0001, 0x11B1, 0x0001, 0x11B2, 0x0001, 0x11B3, 0x0001, 0x11B4, 0x0001, 0x11B5,
+  0x0001, 0x111A, 0x0001, 0x1106, 0x0001, 0x1107, 0x0001, 0x1108, 0x0001, 0x1121, 0x0001, 0x1109,
+  0x0001, 0x110A, 0x0001, 0x110B, 0x0001, 0x110C, 0x0001, 0x110D, 0x0001, 0x110E, 0x0001, 0x110F,
+  0x0001, 0x1110, 0x0001, 0x1111, 0x0001, 0x1112, 0x0001, 0x1161, 0x0001, 0x1162, 0x0001, 0x1163,
+  0x0001, 0x1164, 0x0001, 0x1165, 0x0001, 0x1166, 0x0001, 0x1167, 0x0001, 0x1168, 0x0001, 0x1169,
+  0x0001, 0x116A, 0x0001, 0x116B, 0x0001, 0x116C, 0x0001, 0x116D, 0x0001, 0x116E, 0x0001, 0x116F,
+  0x0001, 0x1170, 0x0001, 0x1171, 0x0001, 0x1172, 0x0001, 0x1173, 0x0001, 0x1174, 0x0001, 0x1175,
+  0x0001, 0x1160, 0x0001, 0x1114, 0x0001, 0x1115, 0x0001, 0x11C7, 0x0001, 0x11C8, 0x0001, 0x11CC,
+  0x0001, 0x11CE, 0x0001, 0x11D3, 0x0001, 0x11D7, 0x0001, 0x11D9, 0x0001, 0x111C, 0x0001, 0x11DD,
+  0x0001, 0x11DF, 0x0001, 0x111D, 0x0001, 0x111E, 0x0001, 0x1120, 0x0001, 0x1122, 0x0001, 0x1123,
+  0x0001, 0x1127, 0x0001, 0x1129, 0x0001, 0x112B, 0x0001, 0x112C, 0x0001, 0x112D, 0x0001, 0x112E,
+  0x0001, 0x112F, 0x0001, 0x1132, 0x0001, 0x1136, 0x0001, 0x1140, 0x0001, 0x1147, 0x0001, 0x114C,
+  0x0001, 0x11F1, 0x0001, 0x11F2, 0x0001, 0x1157, 0x0001, 0x1158, 0x0001, 0x1159, 0x0001, 0x1184,
+  0x0001, 0x1185, 0x0001, 0x1188, 0x0001, 0x1191, 0x0001, 0x1192, 0x0001, 0x1194, 0x0001, 0x119E,
+  0x0001, 0x11A1, 0x0001, 0x4E09, 0x0001, 0x56DB, 0x0001, 0x4E0A, 0x0001, 0x4E2D, 0x0001, 0x4E0B,
+  0x0001, 0x7532, 0x0001, 0x4E19, 0x0001, 0x4E01, 0x0001, 0x5929, 0x0001, 0x5730, 0x0003, 0x0028,
+  0x1100, 0x0029, 0x0003, 0x0028, 0x1102, 0x0029, 0x0003, 0x0028, 0x1103, 0x0029, 0x0003, 0x0028,
+  0x1105, 0x0029, 0x0003, 0x0028, 0x1106, 0x0029, 0x0003, 0x0028, 0x1107, 0x0029, 0x0003, 0x0028,
+  0x1109, 0x0029, 0x0003, 0x0028, 0x110B, 0x0029, 0x0003, 0x0028, 0x110C, 0x0029, 0x0003, 0x0028,
+  0x110E, 0x0029, 0x0003, 0x0028, 0x110F, 0x0029, 0x0003, 0x0028, 0x1110, 0x0029, 0x0003, 0x0028,
+  0x1111, 0x0029, 0x0003, 0x0028, 0x1112, 0x0029, 0x0004, 0x0028, 0x1100, 0x1161, 0x0029, 0x0004,
+  0x0028, 0x1102, 0x1161, 0x0029, 0x0004, 0x0028, 0x1103, 0x1161, 0x0029, 0x0004, 0x0028, 0x1105,
+  0x1161, 0x0029, 0x0004, 0x0028, 0x1106, 0x1161, 0x0029, 0x0004, 0x0028, 0x1107, 0x1161, 0x0029,
+  0x0004, 0x0028, 0x1109, 0x1161, 0x0029, 0x0004, 0x0028, 0x110B, 0x1161, 0x0029, 0x0004, 0x0028,
+  0x110C, 0x1161, 0x0029, 0x0004, 0x0028, 0x110E, 0x1161, 0x0029, 0x0004, 0x0028, 0x110F, 0x1161,
+  0x0029, 0x0004, 0x0028, 0x1110, 0x1161, 0x0029, 0x0004, 0x0028, 0x1111, 0x1161, 0x0029, 0x0004,
+  0x0028, 0x1112, 0x1161, 0x0029, 0x0004, 0x0028, 0x110C, 0x116E, 0x0029, 0x0007, 0x0028, 0x110B,
+  0x1169, 0x110C, 0x1165, 0x11AB, 0x0029, 0x0006, 0x0028, 0x110B, 0x1169, 0x1112, 0x116E, 0x0029,
+  0x0003, 0x0028, 0x4E00, 0x0029, 0x0003, 0x0028, 0x4E8C, 0x0029, 0x0003, 0x0028, 0x4E09, 0x0029,
+  0x0003, 0x0028, 0x56DB, 0x0029, 0x0003, 0x0028, 0x4E94, 0x0029, 0x0003, 0x0028, 0x516D, 0x0029,
+  0x0003, 0x0028, 0x4E03, 0x0029, 0x0003, 0x0028, 0x516B, 0x0029, 0x0003, 0x0028, 0x4E5D, 0x0029,
+  0x0003, 0x0028, 0x5341, 0x0029, 0x0003, 0x0028, 0x6708, 0x0029, 0x0003, 0x0028, 0x706B, 0x0029,
+  0x0003, 0x0028, 0x6C34, 0x0029, 0x0003, 0x0028, 0x6728, 0x0029, 0x0003, 0x0028, 0x91D1, 0x0029,
+  0x0003, 0x0028, 0x571F, 0x0029, 0x0003, 0x0028, 0x65E5, 0x0029, 0x0003, 0x0028, 0x682A, 0x0029,
+  0x0003, 0x0028, 0x6709, 0x0029, 0x0003, 0x0028, 0x793E, 0x0029, 0x0003, 0x0028, 0x540D, 0x0029,
+  0x0003, 0x0028, 0x7279, 0x0029, 0x0003, 0x0028, 0x8CA1, 0x0029, 0x0003, 0x0028, 0x795D, 0x0029,
+  0x0003, 0x0028, 0x52B4, 0x0029, 0x0003, 0x0028, 0x4EE3, 0x0029, 0x0003, 0x0028, 0x547C, 0x0029,
+  0x0003, 0x0028, 0x5B66, 0x0029, 0x0003, 0x0028, 0x76E3, 0x0029, 0x0003, 0x0028, 0x4F01, 0x0029,
+  0x0003, 0x0028, 0x8CC7, 0x0029, 0x0003, 0x0028, 0x5354, 0x0029, 0x0003, 0x0028, 0x796D, 0x0029,
+  0x0003, 0x0028, 0x4F11, 0x0029, 0x0003, 0x0028, 0x81EA, 0x0029, 0x0003, 0x0028, 0x81F3, 0x0029,
+  0x0001, 0x554F, 0x0001, 0x5E7C, 0x0001, 0x7B8F, 0x0003, 0x0050, 0x0054, 0x0045, 0x0002, 0x0032,
+  0x0031, 0x0002, 0x0032, 0x0032, 0x0002, 0x0032, 0x0033, 0x0002, 0x0032, 0x0034, 0x0002, 0x0032,
+  0x0035, 0x0002, 0x0032, 0x0036, 0x0002, 0x0032, 0x0037, 0x0002, 0x0032, 0x0038, 0x0002, 0x0032,
+  0x0039, 0x0002, 0x0033, 0x0030, 0x0002, 0x0033, 0x0031, 0x0002, 0x0033, 0x0032, 0x0002, 0x0033,
+  0x0033, 0x0002, 0x0033, 0x0034, 0x0002, 0x0033, 0x0035, 0x0002, 0x1100, 0x1161, 0x0002, 0x1102,
+  0x1161, 0x0002, 0x1103, 0x1161, 0x0002, 0x1105, 0x1161, 0x0002, 0x1106, 0x1161, 0x0002, 0x1107,
+  0x1161, 0x0002, 0x1109, 0x1161, 0x0002, 0x110B, 0x1161, 0x0002, 0x110C, 0x1161, 0x0002, 0x110E,
+  0x1161, 0x0002, 0x110F, 0x1161, 0x0002, 0x1110, 0x1161, 0x0002, 0x1111, 0x1161, 0x0002, 0x1112,
+  0x1161, 0x0005, 0x110E, 0x1161, 0x11B7, 0x1100, 0x1169, 0x0004, 0x110C, 0x116E, 0x110B, 0x1174,
+  0x0002, 0x110B, 0x116E, 0x0001, 0x4E94, 0x0001, 0x516D, 0x0001, 0x4E03, 0x0001, 0x4E5D, 0x0001,
+  0x682A, 0x0001, 0x6709, 0x0001, 0x793E, 0x0001, 0x540D, 0x0001, 0x7279, 0x0001, 0x8CA1, 0x0001,
+  0x795D, 0x0001, 0x52B4, 0x0001, 0x79D8, 0x0001, 0x7537, 0x0001, 0x9069, 0x0001, 0x512A, 0x0001,
+  0x5370, 0x0001, 0x6CE8, 0x0001, 0x9805, 0x0001, 0x4F11, 0x0001, 0x5199, 0x0001, 0x6B63, 0x0001,
+  0x5DE6, 0x0001, 0x53F3, 0x0001, 0x533B, 0x0001, 0x5B97, 0x0001, 0x5B66, 0x0001, 0x76E3, 0x0001,
+  0x4F01, 0x0001, 0x8CC7, 0x0001, 0x5354, 0x0001, 0x591C, 0x0002, 0x0033, 0x0036, 0x0002, 0x0033,
+  0x0037, 0x0002, 0x0033, 0x0038, 0x0002, 0x0033, 0x0039, 0x0002, 0x0034, 0x0030, 0x0002, 0x0034,
+  0x0031, 0x0002, 0x0034, 0x0032, 0x0002, 0x0034, 0x0033, 0x0002, 0x0034, 0x0034, 0x0002, 0x0034,
+  0x0035, 0x0002, 0x0034, 0x0036, 0x0002, 0x0034, 0x0037, 0x0002, 0x0034, 0x0038, 0x0002, 0x0034,
+  0x0039, 0x0002, 0x0035, 0x0030, 0x0002, 0x0031, 0x6708, 0x0002, 0x0032, 0x6708, 0x0002, 0x0033,
+  0x6708, 0x0002, 0x0034, 0x6708, 0x0002, 0x0035, 0x6708, 0x0002, 0x0036, 0x6708, 0x0002, 0x0037,
+  0x6708, 0x0002, 0x0038, 0x6708, 0x0002, 0x0039, 0x6708, 0x0003, 0x0031, 0x0030, 0x6708, 0x0003,
+  0x0031, 0x0031, 0x6708, 0x0003, 0x0031, 0x0032, 0x6708, 0x0002, 0x0048, 0x0067, 0x0003, 0x0065,
+  0x0072, 0x0067, 0x0002, 0x0065, 0x0056, 0x0003, 0x004C, 0x0054, 0x0044, 0x0001, 0x30A2, 0x0001,
+  0x30A4, 0x0001, 0x30A6, 0x0001, 0x30A8, 0x0001, 0x30AA, 0x0001, 0x30AB, 0x0001, 0x30AD, 0x0001,
+  0x30AF, 0x0001, 0x30B1, 0x0001, 0x30B3, 0x0001, 0x30B5, 0x0001, 0x30B7, 0x0001, 0x30B9, 0x0001,
+  0x30BB, 0x0001, 0x30BD, 0x0001, 0x30BF, 0x0001, 0x30C1, 0x0001, 0x30C4, 0x0001, 0x30C6, 0x0001,
+  0x30C8, 0x0001, 0x30CA, 0x0001, 0x30CB, 0x0001, 0x30CC, 0x0001, 0x30CD, 0x0001, 0x30CE, 0x0001,
+  0x30CF, 0x0001, 0x30D2, 0x0001, 0x30D5, 0x0001, 0x30D8, 0x0001, 0x30DB, 0x0001, 0x30DE, 0x0001,
+  0x30DF, 0x0001, 0x30E0, 0x0001, 0x30E1, 0x0001, 0x30E2, 0x0001, 0x30E4, 0x0001, 0x30E6, 0x0001,
+  0x30E8, 0x0001, 0x30E9, 0x0001, 0x30EA, 0x0001, 0x30EB, 0x0001, 0x30EC, 0x0001, 0x30ED, 0x0001,
+  0x30EF, 0x0001, 0x30F0, 0x0001, 0x30F1, 0x0001, 0x30F2, 0x0002, 0x4EE4, 0x548C, 0x0005, 0x30A2,
+  0x30CF, 0x309A, 0x30FC, 0x30C8, 0x0004, 0x30A2, 0x30EB, 0x30D5, 0x30A1, 0x0005, 0x30A2, 0x30F3,
+  0x30D8, 0x309A, 0x30A2, 0x0003, 0x30A2, 0x30FC, 0x30EB, 0x0005, 0x30A4, 0x30CB, 0x30F3, 0x30AF,
+  0x3099, 0x0003, 0x30A4, 0x30F3, 0x30C1, 0x0003, 0x30A6, 0x30A9, 0x30F3, 0x0006, 0x30A8, 0x30B9,
+  0x30AF, 0x30FC, 0x30C8, 0x3099, 0x0004, 0x30A8, 0x30FC, 0x30AB, 0x30FC, 0x0003, 0x30AA, 0x30F3,
+  0x30B9, 0x0003, 0x30AA, 0x30FC, 0x30E0, 0x0003, 0x30AB, 0x30A4, 0x30EA, 0x0004, 0x30AB, 0x30E9,
+  0x30C3, 0x30C8, 0x0004, 0x30AB, 0x30ED, 0x30EA, 0x30FC, 0x0004, 0x30AB, 0x3099, 0x30ED, 0x30F3,
+  0x0004, 0x30AB, 0x3099, 0x30F3, 0x30DE, 0x0004, 0x30AD, 0x3099, 0x30AB, 0x3099, 0x0004, 0x30AD,
+  0x3099, 0x30CB, 0x30FC, 0x0004, 0x30AD, 0x30E5, 0x30EA, 0x30FC, 0x0006, 0x30AD, 0x3099, 0x30EB,
+  0x30BF, 0x3099, 0x30FC, 0x0002, 0x30AD, 0x30ED, 0x0006, 0x30AD, 0x30ED, 0x30AF, 0x3099, 0x30E9,
+  0x30E0, 0x0006, 0x30AD, 0x30ED, 0x30E1, 0x30FC, 0x30C8, 0x30EB, 0x0005, 0x30AD, 0x30ED, 0x30EF,
+  0x30C3, 0x30C8, 0x0004, 0x30AF, 0x3099, 0x30E9, 0x30E0, 0x0006, 0x30AF, 0x3099, 0x30E9, 0x30E0,
+  0x30C8, 0x30F3, 0x0006, 0x30AF, 0x30EB, 0x30BB, 0x3099, 0x30A4, 0x30ED, 0x0004, 0x30AF, 0x30ED,
+  0x30FC, 0x30CD, 0x0003, 0x30B1, 0x30FC, 0x30B9, 0x0003, 0x30B3, 0x30EB, 0x30CA, 0x0004, 0x30B3,
+  0x30FC, 0x30DB, 0x309A, 0x0004, 0x30B5, 0x30A4, 0x30AF, 0x30EB, 0x0005, 0x30B5, 0x30F3, 0x30C1,
+  0x30FC, 0x30E0, 0x0005, 0x30B7, 0x30EA, 0x30F3, 0x30AF, 0x3099, 0x0003, 0x30BB, 0x30F3, 0x30C1,
+  0x0003, 0x30BB, 0x30F3, 0x30C8, 0x0004, 0x30BF, 0x3099, 0x30FC, 0x30B9, 0x0003, 0x30C6, 0x3099,
+  0x30B7, 0x0003, 0x30C8, 0x3099, 0x30EB, 0x0002, 0x30C8, 0x30F3, 0x0002, 0x30CA, 0x30CE, 0x0003,
+  0x30CE, 0x30C3, 0x30C8, 0x0003, 0x30CF, 0x30A4, 0x30C4, 0x0006, 0x30CF, 0x309A, 0x30FC, 0x30BB,
+  0x30F3, 0x30C8, 0x0004, 0x30CF, 0x309A, 0x30FC, 0x30C4, 0x0005, 0x30CF, 0x3099, 0x30FC, 0x30EC,
+  0x30EB, 0x0006, 0x30D2, 0x309A, 0x30A2, 0x30B9, 0x30C8, 0x30EB, 0x0004, 0x30D2, 0x309A, 0x30AF,
+  0x30EB, 0x0003, 0x30D2, 0x309A, 0x30B3, 0x0003, 0x30D2, 0x3099, 0x30EB, 0x0006, 0x30D5, 0x30A1,
+  0x30E9, 0x30C3, 0x30C8, 0x3099, 0x0004, 0x30D5, 0x30A3, 0x30FC, 0x30C8, 0x0006, 0x30D5, 0x3099,
+  0x30C3, 0x30B7, 0x30A7, 0x30EB, 0x0003, 0x30D5, 0x30E9, 0x30F3, 0x0005, 0x30D8, 0x30AF, 0x30BF,
+  0x30FC, 0x30EB, 0x0003, 0x30D8, 0x309A, 0x30BD, 0x0004, 0x30D8, 0x309A, 0x30CB, 0x30D2, 0x0003,
+  0x30D8, 0x30EB, 0x30C4, 0x0004, 0x30D8, 0x309A, 0x30F3, 0x30B9, 0x0005, 0x30D8, 0x309A, 0x30FC,
+  0x30B7, 0x3099, 0x0004, 0x30D8, 0x3099, 0x30FC, 0x30BF, 0x0005, 0x30DB, 0x309A, 0x30A4, 0x30F3,
+  0x30C8, 0x0004, 0x30DB, 0x3099, 0x30EB, 0x30C8, 0x0002, 0x30DB, 0x30F3, 0x0005, 0x30DB, 0x309A,
+  0x30F3, 0x30C8, 0x3099, 0x0003, 0x30DB, 0x30FC, 0x30EB, 0x0003, 0x30DB, 0x30FC, 0x30F3, 0x0004,
+  0x30DE, 0x30A4, 0x30AF, 0x30ED, 0x0003, 0x30DE, 0x30A4, 0x30EB, 0x0003, 0x30DE, 0x30C3, 0x30CF,
+  0x0003, 0x30DE, 0x30EB, 0x30AF, 0x0005, 0x30DE, 0x30F3, 0x30B7, 0x30E7, 0x30F3, 0x0004, 0x30DF,
+  0x30AF, 0x30ED, 0x30F3, 0x0002, 0x30DF, 0x30EA, 0x0006, 0x30DF, 0x30EA, 0x30CF, 0x3099, 0x30FC,
+  0x30EB, 0x0003, 0x30E1, 0x30AB, 0x3099, 0x0005, 0x30E1, 0x30AB, 0x3099, 0x30C8, 0x30F3, 0x0004,
+  0x30E1, 0x30FC, 0x30C8, 0x30EB, 0x0004, 0x30E4, 0x30FC, 0x30C8, 0x3099, 0x0003, 0x30E4, 0x30FC,
+  0x30EB, 0x0003, 0x30E6, 0x30A2, 0x30F3, 0x0004, 0x30EA, 0x30C3, 0x30C8, 0x30EB, 0x0002, 0x30EA,
+  0x30E9, 0x0004, 0x30EB, 0x30D2, 0x309A, 0x30FC, 0x0005, 0x30EB, 0x30FC, 0x30D5, 0x3099, 0x30EB,
+  0x0002, 0x30EC, 0x30E0, 0x0006, 0x30EC, 0x30F3, 0x30C8, 0x30B1, 0x3099, 0x30F3, 0x0003, 0x30EF,
+  0x30C3, 0x30C8, 0x0002, 0x0030, 0x70B9, 0x0002, 0x0031, 0x70B9, 0x0002, 0x0032, 0x70B9, 0x0002,
+  0x0033, 0x70B9, 0x0002, 0x0034, 0x70B9, 0x0002, 0x0035, 0x70B9, 0x0002, 0x0036, 0x70B9, 0x0002,
+  0x0037, 0x70B9, 0x0002, 0x0038, 0x70B9, 0x0002, 0x0039, 0x70B9, 0x0003, 0x0031, 0x0030, 0x70B9,
+  0x0003, 0x0031, 0x0031, 0x70B9, 0x0003, 0x0031, 0x0032, 0x70B9, 0x0003, 0x0031, 0x0033, 0x70B9,
+  0x0003, 0x0031, 0x0034, 0x70B9, 0x0003, 0x0031, 0x0035, 0x70B9, 0x0003, 0x0031, 0x0036, 0x70B9,
+  0x0003, 0x0031, 0x0037, 0x70B9, 0x0003, 0x0031, 0x0038, 0x70B9, 0x0003, 0x0031, 0x0039, 0x70B9,
+  0x0003, 0x0032, 0x0030, 0x70B9, 0x0003, 0x0032, 0x0031, 0x70B9, 0x0003, 0x0032, 0x0032, 0x70B9,
+  0x0003, 0x0032, 0x0033, 0x70B9, 0x0003, 0x0032, 0x0034, 0x70B9, 0x0003, 0x0068, 0x0050, 0x0061,
+  0x0002, 0x0064, 0x0061, 0x0002, 0x0041, 0x0055, 0x0003, 0x0062, 0x0061, 0x0072, 0x0002, 0x006F,
+  0x0056, 0x0002, 0x0070, 0x0063, 0x0002, 0x0064, 0x006D, 0x0003, 0x0064, 0x006D, 0x0032, 0x0003,
+  0x0064, 0x006D, 0x0033, 0x0002, 0x0049, 0x0055, 0x0002, 0x5E73, 0x6210, 0x0002, 0x662D, 0x548C,
+  0x0002, 0x5927, 0x6B63, 0x0002, 0x660E, 0x6CBB, 0x0004, 0x682A, 0x5F0F, 0x4F1A, 0x793E, 0x0002,
+  0x0070, 0x0041, 0x0002, 0x006E, 0x0041, 0x0002, 0x03BC, 0x0041, 0x0002, 0x006D, 0x0041, 0x0002,
+  0x006B, 0x0041, 0x0002, 0x004B, 0x0042, 0x0002, 0x004D, 0x0042, 0x0002, 0x0047, 0x0042, 0x0003,
+  0x0063, 0x0061, 0x006C, 0x0004, 0x006B, 0x0063, 0x0061, 0x006C, 0x0002, 0x0070, 0x0046, 0x0002,
+  0x006E, 0x0046, 0x0002, 0x03BC, 0x0046, 0x0002, 0x03BC, 0x0067, 0x0002, 0x006D, 0x0067, 0x0002,
+  0x006B, 0x0067, 0x0002, 0x0048, 0x007A, 0x0003, 0x006B, 0x0048, 0x007A, 0x0003, 0x004D, 0x0048,
+  0x007A, 0x0003, 0x0047, 0x0048, 0x007A, 0x0003, 0x0054, 0x0048, 0x007A, 0x0002, 0x03BC, 0x006C,
+  0x0002, 0x006D, 0x006C, 0x0002, 0x0064, 0x006C, 0x0002, 0x006B, 0x006C, 0x0002, 0x0066, 0x006D,
+  0x0002, 0x006E, 0x006D, 0x0002, 0x03BC, 0x006D, 0x0002, 0x006D, 0x006D, 0x0002, 0x0063, 0x006D,
+  0x0002, 0x006B, 0x006D, 0x0003, 0x006D, 0x006D, 0x0032, 0x0003, 0x0063, 0x006D, 0x0032, 0x0002,
+  0x006D, 0x0032, 0x0003, 0x006B, 0x006D, 0x0032, 0x0003, 0x006D, 0x006D, 0x0033, 0x0003, 0x0063,
+  0x006D, 0x0033, 0x0002, 0x006D, 0x0033, 0x0003, 0x006B, 0x006D, 0x0033, 0x0003, 0x006D, 0x2215,
+  0x0073, 0x0004, 0x006D, 0x2215, 0x0073, 0x0032, 0x0002, 0x0050, 0x0061, 0x0003, 0x006B, 0x0050,
+  0x0061, 0x0003, 0x004D, 0x0050, 0x0061, 0x0003, 0x0047, 0x0050, 0x0061, 0x0003, 0x0072, 0x0061,
+  0x0064, 0x0005, 0x0072, 0x0061, 0x0064, 0x2215, 0x0073, 0x0006, 0x0072, 0x0061, 0x0064, 0x2215,
+  0x0073, 0x0032, 0x0002, 0x0070, 0x0073, 0x0002, 0x006E, 0x0073, 0x0002, 0x03BC, 0x0073, 0x0002,
+  0x006D, 0x0073, 0x0002, 0x0070, 0x0056, 0x0002, 0x006E, 0x0056, 0x0002, 0x03BC, 0x0056, 0x0002,
+  0x006D, 0x0056, 0x0002, 0x006B, 0x0056, 0x0002, 0x004D, 0x0056, 0x0002, 0x0070, 0x0057, 0x0002,
+  0x006E, 0x0057, 0x0002, 0x03BC, 0x0057, 0x0002, 0x006D, 0x0057, 0x0002, 0x006B, 0x0057, 0x0002,
+  0x004D, 0x0057, 0x0002, 0x006B, 0x03A9, 0x0002, 0x004D, 0x03A9, 0x0004, 0x0061, 0x002E, 0x006D,
+  0x002E, 0x0002, 0x0042, 0x0071, 0x0002, 0x0063, 0x0063, 0x0002, 0x0063, 0x0064, 0x0004, 0x0043,
+  0x2215, 0x006B, 0x0067, 0x0003, 0x0043, 0x006F, 0x002E, 0x0002, 0x0064, 0x0042, 0x0002, 0x0047,
+  0x0079, 0x0002, 0x0068, 0x0061, 0x0002, 0x0048, 0x0050, 0x0002, 0x0069, 0x006E, 0x0002, 0x004B,
+  0x004B, 0x0002, 0x004B, 0x004D, 0x0002, 0x006B, 0x0074, 0x0002, 0x006C, 0x006D, 0x0002, 0x006C,
+  0x006E, 0x0003, 0x006C, 0x006F, 0x0067, 0x0002, 0x006C, 0x0078, 0x0002, 0x006D, 0x0062, 0x0003,
+  0x006D, 0x0069, 0x006C, 0x0003, 0x006D, 0x006F, 0x006C, 0x0002, 0x0050, 0x0048, 0x0004, 0x0070,
+  0x002E, 0x006D, 0x002E, 0x0003, 0x0050, 0x0050, 0x004D, 0x0002, 0x0050, 0x0052, 0x0002, 0x0073,
+  0x0072, 0x0002, 0x0053, 0x0076, 0x0002, 0x0057, 0x0062, 0x0003, 0x0056, 0x2215, 0x006D, 0x0003,
+  0x0041, 0x2215, 0x006D, 0x0002, 0x0031, 0x65E5, 0x0002, 0x0032, 0x65E5, 0x0002, 0x0033, 0x65E5,
+  0x0002, 0x0034, 0x65E5, 0x0002, 0x0035, 0x65E5, 0x0002, 0x0036, 0x65E5, 0x0002, 0x0037, 0x65E5,
+  0x0002, 0x0038, 0x65E5, 0x0002, 0x0039, 0x65E5, 0x0003, 0x0031, 0x0030, 0x65E5, 0x0003, 0x0031,
+  0x0031, 0x65E5, 0x0003, 0x0031, 0x0032, 0x65E5, 0x0003, 0x0031, 0x0033, 0x65E5, 0x0003, 0x0031,
+  0x0034, 0x65E5, 0x0003, 0x0031, 0x0035, 0x65E5, 0x0003, 0x0031, 0x0036, 0x65E5, 0x0003, 0x0031,
+  0x0037, 0x65E5, 0x0003, 0x0031, 0x0038, 0x65E5, 0x0003, 0x0031, 0x0039, 0x65E5, 0x0003, 0x0032,
+  0x0030, 0x65E5, 0x0003, 0x0032, 0x0031, 0x65E5, 0x0003, 0x0032, 0x0032, 0x65E5, 0x0003, 0x0032,
+  0x0033, 0x65E5, 0x0003, 0x0032, 0x0034, 0x65E5, 0x0003, 0x0032, 0x0035, 0x65E5, 0x0003, 0x0032,
+  0x0036, 0x65E5, 0x0003, 0x0032, 0x0037, 0x65E5, 0x0003, 0x0032, 0x0038, 0x65E5, 0x0003, 0x0032,
+  0x0039, 0x65E5, 0x0003, 0x0033, 0x0030, 0x65E5, 0x0003, 0x0033, 0x0031, 0x65E5, 0x0003, 0x0067,
+  0x0061, 0x006C, 0x0001, 0x044A, 0x0001, 0x044C, 0x0001, 0xA76F, 0x0001, 0x0126, 0x0001, 0x0153,
+  0x0001, 0xA727, 0x0001, 0xAB37, 0x0001, 0x026B, 0x0001, 0xAB52, 0x0001, 0x028D, 0x0001, 0x8C48,
+  0x0001, 0x66F4, 0x0001, 0x8CC8, 0x0001, 0x6ED1, 0x0001, 0x4E32, 0x0001, 0x53E5, 0x0001, 0x5951,
+  0x0001, 0x5587, 0x0001, 0x5948, 0x0001, 0x61F6, 0x0001, 0x7669, 0x0001, 0x7F85, 0x0001, 0x863F,
+  0x0001, 0x87BA, 0x0001, 0x88F8, 0x0001, 0x908F, 0x0001, 0x6A02, 0x0001, 0x6D1B, 0x0001, 0x70D9,
+  0x0001, 0x73DE, 0x0001, 0x843D, 0x0001, 0x916A, 0x0001, 0x99F1, 0x0001, 0x4E82, 0x0001, 0x5375,
+  0x0001, 0x6B04, 0x0001, 0x721B, 0x0001, 0x862D, 0x0001, 0x9E1E, 0x0001, 0x5D50, 0x0001, 0x6FEB,
+  0x0001, 0x85CD, 0x0001, 0x8964, 0x0001, 0x62C9, 0x0001, 0x81D8, 0x0001, 0x881F, 0x0001, 0x5ECA,
+  0x0001, 0x6717, 0x0001, 0x6D6A, 0x0001, 0x72FC, 0x0001, 0x90CE, 0x0001, 0x4F86, 0x0001, 0x51B7,
+  0x0001, 0x52DE, 0x0001, 0x64C4, 0x0001, 0x6AD3, 0x0001, 0x7210, 0x0001, 0x76E7, 0x0001, 0x8606,
+  0x0001, 0x865C, 0x0001, 0x8DEF, 0x0001, 0x9732, 0x0001, 0x9B6F, 0x0001, 0x9DFA, 0x0001, 0x788C,
+  0x0001, 0x797F, 0x0001, 0x7DA0, 0x0001, 0x83C9, 0x0001, 0x9304, 0x0001, 0x8AD6, 0x0001, 0x58DF,
+  0x0001, 0x5F04, 0x0001, 0x7C60, 0x0001, 0x807E, 0x0001, 0x7262, 0x0001, 0x78CA, 0x0001, 0x8CC2,
+  0x0001, 0x96F7, 0x0001, 0x58D8, 0x0001, 0x5C62, 0x0001, 0x6A13, 0x0001, 0x6DDA, 0x0001, 0x6F0F,
+  0x0001, 0x7D2F, 0x0001, 0x7E37, 0x0001, 0x964B, 0x0001, 0x52D2, 0x0001, 0x808B, 0x0001, 0x51DC,
+  0x0001, 0x51CC, 0x0001, 0x7A1C, 0x0001, 0x7DBE, 0x0001, 0x83F1, 0x0001, 0x9675, 0x0001, 0x8B80,
+  0x0001, 0x62CF, 0x0001, 0x8AFE, 0x0001, 0x4E39, 0x0001, 0x5BE7, 0x0001, 0x6012, 0x0001, 0x7387,
+  0x0001, 0x7570, 0x0001, 0x5317, 0x0001, 0x78FB, 0x0001, 0x4FBF, 0x0001, 0x5FA9, 0x0001, 0x4E0D,
+  0x0001, 0x6CCC, 0x0001, 0x6578, 0x0001, 0x7D22, 0x0001, 0x53C3, 0x0001, 0x585E, 0x0001, 0x7701,
+  0x0001, 0x8449, 0x0001, 0x8AAA, 0x0001, 0x6BBA, 0x0001, 0x6C88, 0x0001, 0x62FE, 0x0001, 0x82E5,
+  0x0001, 0x63A0, 0x0001, 0x7565, 0x0001, 0x4EAE, 0x0001, 0x5169, 0x0001, 0x51C9, 0x0001, 0x6881,
+  0x0001, 0x7CE7, 0x0001, 0x826F, 0x0001, 0x8AD2, 0x0001, 0x91CF, 0x0001, 0x52F5, 0x0001, 0x5442,
+  0x0001, 0x5EEC, 0x0001, 0x65C5, 0x0001, 0x6FFE, 0x0001, 0x792A, 0x0001, 0x95AD, 0x0001, 0x9A6A,
+  0x0001, 0x9E97, 0x0001, 0x9ECE, 0x0001, 0x66C6, 0x0001, 0x6B77, 0x0001, 0x8F62, 0x0001, 0x5E74,
+  0x0001, 0x6190, 0x0001, 0x6200, 0x0001, 0x649A, 0x0001, 0x6F23, 0x0001, 0x7149, 0x0001, 0x7489,
+  0x0001, 0x79CA, 0x0001, 0x7DF4, 0x0001, 0x806F, 0x0001, 0x8F26, 0x0001, 0x84EE, 0x0001, 0x9023,
+  0x0001, 0x934A, 0x0001, 0x5217, 0x0001, 0x52A3, 0x0001, 0x54BD, 0x0001, 0x70C8, 0x0001, 0x88C2,
+  0x0001, 0x5EC9, 0x0001, 0x5FF5, 0x0001, 0x637B, 0x0001, 0x6BAE, 0x0001, 0x7C3E, 0x0001, 0x7375,
+  0x0001, 0x4EE4, 0x0001, 0x56F9, 0x0001, 0x5DBA, 0x0001, 0x601C, 0x0001, 0x73B2, 0x0001, 0x7469,
+  0x0001, 0x7F9A, 0x0001, 0x8046, 0x0001, 0x9234, 0x0001, 0x96F6, 0x0001, 0x9748, 0x0001, 0x9818,
+  0x0001, 0x4F8B, 0x0001, 0x79AE, 0x0001, 0x91B4, 0x0001, 0x96B8, 0x0001, 0x60E1, 0x0001, 0x4E86,
+  0x0001, 0x50DA, 0x0001, 0x5BEE, 0x0001, 0x5C3F, 0x0001, 0x6599, 0x0001, 0x71CE, 0x0001, 0x7642,
+  0x0001, 0x84FC, 0x0001, 0x907C, 0x0001, 0x6688, 0x0001, 0x962E, 0x0001, 0x5289, 0x0001, 0x677B,
+  0x0001, 0x67F3, 0x0001, 0x6D41, 0x0001, 0x6E9C, 0x0001, 0x7409, 0x0001, 0x7559, 0x0001, 0x786B,
+  0x0001, 0x7D10, 0x0001, 0x985E, 0x0001, 0x622E, 0x0001, 0x9678, 0x0001, 0x502B, 0x0001, 0x5D19,
+  0x0001, 0x6DEA, 0x0001, 0x8F2A, 0x0001, 0x5F8B, 0x0001, 0x6144, 0x0001, 0x6817, 0x0001, 0x9686,
+  0x0001, 0x5229, 0x0001, 0x540F, 0x0001, 0x5C65, 0x0001, 0x6613, 0x0001, 0x674E, 0x0001, 0x68A8,
+  0x0001, 0x6CE5, 0x0001, 0x7406, 0x0001, 0x75E2, 0x0001, 0x7F79, 0x0001, 0x88CF, 0x0001, 0x88E1,
+  0x0001, 0x96E2, 0x0001, 0x533F, 0x0001, 0x6EBA, 0x0001, 0x541D, 0x0001, 0x71D0, 0x0001, 0x7498,
+  0x0001, 0x85FA, 0x0001, 0x96A3, 0x0001, 0x9C57, 0x0001, 0x9E9F, 0x0001, 0x6797, 0x0001, 0x6DCB,
+  0x0001, 0x81E8, 0x0001, 0x7B20, 0x0001, 0x7C92, 0x0001, 0x72C0, 0x0001, 0x7099, 0x0001, 0x8B58,
+  0x0001, 0x4EC0, 0x0001, 0x8336, 0x0001, 0x523A, 0x0001, 0x5207, 0x0001, 0x5EA6, 0x0001, 0x62D3,
+  0x0001, 0x7CD6, 0x0001, 0x5B85, 0x0001, 0x6D1E, 0x0001, 0x66B4, 0x0001, 0x8F3B, 0x0001, 0x964D,
+  0x0001, 0x5ED3, 0x0001, 0x5140, 0x0001, 0x55C0, 0x0001, 0x585A, 0x0001, 0x6674, 0x0001, 0x51DE,
+  0x0001, 0x732A, 0x0001, 0x76CA, 0x0001, 0x793C, 0x0001, 0x795E, 0x0001, 0x7965, 0x0001, 0x798F,
+  0x0001, 0x9756, 0x0001, 0x7CBE, 0x0001, 0x8612, 0x0001, 0x8AF8, 0x0001, 0x9038, 0x0001, 0x90FD,
+  0x0001, 0x98EF, 0x0001, 0x98FC, 0x0001, 0x9928, 0x0001, 0x9DB4, 0x0001, 0x90DE, 0x0001, 0x96B7,
+  0x0001, 0x4FAE, 0x0001, 0x50E7, 0x0001, 0x514D, 0x0001, 0x52C9, 0x0001, 0x52E4, 0x0001, 0x5351,
+  0x0001, 0x559D, 0x0001, 0x5606, 0x0001, 0x5668, 0x0001, 0x5840, 0x0001, 0x58A8, 0x0001, 0x5C64,
+  0x0001, 0x6094, 0x0001, 0x6168, 0x0001, 0x618E, 0x0001, 0x61F2, 0x0001, 0x654F, 0x0001, 0x65E2,
+  0x0001, 0x6691, 0x0001, 0x6885, 0x0001, 0x6D77, 0x0001, 0x6E1A, 0x0001, 0x6F22, 0x0001, 0x716E,
+  0x0001, 0x722B, 0x0001, 0x7422, 0x0001, 0x7891, 0x0001, 0x7949, 0x0001, 0x7948, 0x0001, 0x7950,
+  0x0001, 0x7956, 0x0001, 0x798D, 0x0001, 0x798E, 0x0001, 0x7A40, 0x0001, 0x7A81, 0x0001, 0x7BC0,
+  0x0001, 0x7E09, 0x0001, 0x7E41, 0x0001, 0x7F72, 0x0001, 0x8005, 0x0001, 0x81ED, 0x0001, 0x8279,
+  0x0001, 0x8457, 0x0001, 0x8910, 0x0001, 0x8996, 0x0001, 0x8B01, 0x0001, 0x8B39, 0x0001, 0x8CD3,
+  0x0001, 0x8D08, 0x0001, 0x8FB6, 0x0001, 0x96E3, 0x0001, 0x97FF, 0x0001, 0x983B, 0x0001, 0x6075,
+  0x0001, 0x242EE, 0x0001, 0x8218, 0x0001, 0x4E26, 0x0001, 0x51B5, 0x0001, 0x5168, 0x0001, 0x4F80,
+  0x0001, 0x5145, 0x0001, 0x5180, 0x0001, 0x52C7, 0x0001, 0x52FA, 0x0001, 0x5555, 0x0001, 0x5599,
+  0x0001, 0x55E2, 0x0001, 0x58B3, 0x0001, 0x5944, 0x0001, 0x5954, 0x0001, 0x5A62, 0x0001, 0x5B28,
+  0x0001, 0x5ED2, 0x0001, 0x5ED9, 0x0001, 0x5F69, 0x0001, 0x5FAD, 0x0001, 0x60D8, 0x0001, 0x614E,
+  0x0001, 0x6108, 0x0001, 0x6160, 0x0001, 0x6234, 0x0001, 0x63C4, 0x0001, 0x641C, 0x0001, 0x6452,
+  0x0001, 0x6556, 0x0001, 0x671B, 0x0001, 0x6756, 0x0001, 0x6EDB, 0x0001, 0x6ECB, 0x0001, 0x701E,
+  0x0001, 0x77A7, 0x0001, 0x7235, 0x0001, 0x72AF, 0x0001, 0x7471, 0x0001, 0x7506, 0x0001, 0x753B,
+  0x0001, 0x761D, 0x0001, 0x761F, 0x0001, 0x76DB, 0x0001, 0x76F4, 0x0001, 0x774A, 0x0001, 0x7740,
+  0x0001, 0x78CC, 0x0001, 0x7AB1, 0x0001, 0x7C7B, 0x0001, 0x7D5B, 0x0001, 0x7F3E, 0x0001, 0x8352,
+  0x0001, 0x83EF, 0x0001, 0x8779, 0x0001, 0x8941, 0x0001, 0x8986, 0x0001, 0x8ABF, 0x0001, 0x8ACB,
+  0x0001, 0x8AED, 0x0001, 0x8B8A, 0x0001, 0x8F38, 0x0001, 0x9072, 0x0001, 0x9199, 0x0001, 0x9276,
+  0x0001, 0x967C, 0x0001, 0x97DB, 0x0001, 0x980B, 0x0001, 0x9B12, 0x0001, 0x2284A, 0x0001, 0x22844,
+  0x0001, 0x233D5, 0x0001, 0x3B9D, 0x0001, 0x4018, 0x0001, 0x4039, 0x0001, 0x25249, 0x0001, 0x25CD0,
+  0x0001, 0x27ED3, 0x0001, 0x9F43, 0x0001, 0x9F8E, 0x0002, 0x0066, 0x0066, 0x0002, 0x0066, 0x0069,
+  0x0002, 0x0066, 0x006C, 0x0003, 0x0066, 0x0066, 0x0069, 0x0003, 0x0066, 0x0066, 0x006C, 0x0002,
+  0x0073, 0x0074, 0x0002, 0x0574, 0x0576, 0x0002, 0x0574, 0x0565, 0x0002, 0x0574, 0x056B, 0x0002,
+  0x057E, 0x0576, 0x0002, 0x0574, 0x056D, 0x0002, 0x05D9, 0x05B4, 0x0002, 0x05F2, 0x05B7, 0x0001,
+  0x05E2, 0x0001, 0x05D4, 0x0001, 0x05DB, 0x0001, 0x05DC, 0x0001, 0x05DD, 0x0001, 0x05E8, 0x0001,
+  0x05EA, 0x0002, 0x05E9, 0x05C1, 0x0002, 0x05E9, 0x05C2, 0x0003, 0x05E9, 0x05BC, 0x05C1, 0x0003,
+  0x05E9, 0x05BC, 0x05C2, 0x0002, 0x05D0, 0x05B7, 0x0002, 0x05D0, 0x05B8, 0x0002, 0x05D0, 0x05BC,
+  0x0002, 0x05D1, 0x05BC, 0x0002, 0x05D2, 0x05BC, 0x0002, 0x05D3, 0x05BC, 0x0002, 0x05D4, 0x05BC,
+  0x0002, 0x05D5, 0x05BC, 0x0002, 0x05D6, 0x05BC, 0x0002, 0x05D8, 0x05BC, 0x0002, 0x05D9, 0x05BC,
+  0x0002, 0x05DA, 0x05BC, 0x0002, 0x05DB, 0x05BC, 0x0002, 0x05DC, 0x05BC, 0x0002, 0x05DE, 0x05BC,
+  0x0002, 0x05E0, 0x05BC, 0x0002, 0x05E1, 0x05BC, 0x0002, 0x05E3, 0x05BC, 0x0002, 0x05E4, 0x05BC,
+  0x0002, 0x05E6, 0x05BC, 0x0002, 0x05E7, 0x05BC, 0x0002, 0x05E8, 0x05BC, 0x0002, 0x05E9, 0x05BC,
+  0x0002, 0x05EA, 0x05BC, 0x0002, 0x05D5, 0x05B9, 0x0002, 0x05D1, 0x05BF, 0x0002, 0x05DB, 0x05BF,
+  0x0002, 0x05E4, 0x05BF, 0x0002, 0x05D0, 0x05DC, 0x0001, 0x0671, 0x0001, 0x067B, 0x0001, 0x067E,
+  0x0001, 0x0680, 0x0001, 0x067A, 0x0001, 0x067F, 0x0001, 0x0679, 0x0001, 0x06A4, 0x0001, 0x06A6,
+  0x0001, 0x0684, 0x0001, 0x0683, 0x0001, 0x0686, 0x0001, 0x0687, 0x0001, 0x068D, 0x0001, 0x068C,
+  0x0001, 0x068E, 0x0001, 0x0688, 0x0001, 0x0698, 0x0001, 0x0691, 0x0001, 0x06A9, 0x0001, 0x06AF,
+  0x0001, 0x06B3, 0x0001, 0x06B1, 0x0001, 0x06BA, 0x0001, 0x06BB, 0x0001, 0x06C1, 0x0001, 0x06BE,
+  0x0001, 0x06D2, 0x0001, 0x06AD, 0x0001, 0x06C7, 0x0001, 0x06C6, 0x0001, 0x06C8, 0x0001, 0x06CB,
+  0x0001, 0x06C5, 0x0001, 0x06C9, 0x0001, 0x06D0, 0x0001, 0x0649, 0x0003, 0x064A, 0x0654, 0x0627,
+  0x0003, 0x064A, 0x0654, 0x06D5, 0x0003, 0x064A, 0x0654, 0x0648, 0x0003, 0x064A, 0x0654, 0x06C7,
+  0x0003, 0x064A, 0x0654, 0x06C6, 0x0003, 0x064A, 0x0654, 0x06C8, 0x0003, 0x064A, 0x0654, 0x06D0,
+  0x0003, 0x064A, 0x0654, 0x0649, 0x0001, 0x06CC, 0x0003, 0x064A, 0x0654, 0x062C, 0x0003, 0x064A,
+  0x0654, 0x062D, 0x0003, 0x064A, 0x0654, 0x0645, 0x0003, 0x064A, 0x0654, 0x064A, 0x0002, 0x0628,
+  0x062C, 0x0002, 0x0628, 0x062D, 0x0002, 0x0628, 0x062E, 0x0002, 0x0628, 0x0645, 0x0002, 0x0628,
+  0x0649, 0x0002, 0x0628, 0x064A, 0x0002, 0x062A, 0x062C, 0x0002, 0x062A, 0x062D, 0x0002, 0x062A,
+  0x062E, 0x0002, 0x062A, 0x0645, 0x0002, 0x062A, 0x0649, 0x0002, 0x062A, 0x064A, 0x0002, 0x062B,
+  0x062C, 0x0002, 0x062B, 0x0645, 0x0002, 0x062B, 0x0649, 0x0002, 0x062B, 0x064A, 0x0002, 0x062C,
+  0x062D, 0x0002, 0x062C, 0x0645, 0x0002, 0x062D, 0x062C, 0x0002, 0x062D, 0x0645, 0x0002, 0x062E,
+  0x062C, 0x0002, 0x062E, 0x062D, 0x0002, 0x062E, 0x0645, 0x0002, 0x0633, 0x062C, 0x0002, 0x0633,
+  0x062D, 0x0002, 0x0633, 0x062E, 0x0002, 0x0633, 0x0645, 0x0002, 0x0635, 0x062D, 0x0002, 0x0635,
+  0x0645, 0x0002, 0x0636, 0x062C, 0x0002, 0x0636, 0x062D, 0x0002, 0x0636, 0x062E, 0x0002, 0x0636,
+  0x0645, 0x0002, 0x0637, 0x062D, 0x0002, 0x0637, 0x0645, 0x0002, 0x0638, 0x0645, 0x0002, 0x0639,
+  0x062C, 0x0002, 0x0639, 0x0645, 0x0002, 0x063A, 0x062C, 0x0002, 0x063A, 0x0645, 0x0002, 0x0641,
+  0x062C, 0x0002, 0x0641, 0x062D, 0x0002, 0x0641, 0x062E, 0x0002, 0x0641, 0x0645, 0x0002, 0x0641,
+  0x0649, 0x0002, 0x0641, 0x064A, 0x0002, 0x0642, 0x062D, 0x0002, 0x0642, 0x0645, 0x0002, 0x0642,
+  0x0649, 0x0002, 0x0642, 0x064A, 0x0002, 0x0643, 0x0627, 0x0002, 0x0643, 0x062C, 0x0002, 0x0643,
+  0x062D, 0x0002, 0x0643, 0x062E, 0x0002, 0x0643, 0x0644, 0x0002, 0x0643, 0x0645, 0x0002, 0x0643,
+  0x0649, 0x0002, 0x0643, 0x064A, 0x0002, 0x0644, 0x062C, 0x0002, 0x0644, 0x062D, 0x0002, 0x0644,
+  0x062E, 0x0002, 0x0644, 0x0645, 0x0002, 0x0644, 0x0649, 0x0002, 0x0644, 0x064A, 0x0002, 0x0645,
+  0x062C, 0x0002, 0x0645, 0x062D, 0x0002, 0x0645, 0x062E, 0x0002, 0x0645, 0x0645, 0x0002, 0x0645,
+  0x0649, 0x0002, 0x0645, 0x064A, 0x0002, 0x0646, 0x062C, 0x0002, 0x0646, 0x062D, 0x0002, 0x0646,
+  0x062E, 0x0002, 0x0646, 0x0645, 0x0002, 0x0646, 0x0649, 0x0002, 0x0646, 0x064A, 0x0002, 0x0647,
+  0x062C, 0x0002, 0x0647, 0x0645, 0x0002, 0x0647, 0x0649, 0x0002, 0x0647, 0x064A, 0x0002, 0x064A,
+  0x062C, 0x0002, 0x064A, 0x062D, 0x0002, 0x064A, 0x062E, 0x0002, 0x064A, 0x0645, 0x0002, 0x064A,
+  0x0649, 0x0002, 0x064A, 0x064A, 0x0002, 0x0630, 0x0670, 0x0002, 0x0631, 0x0670, 0x0002, 0x0649,
+  0x0670, 0x0003, 0x0020, 0x064C, 0x0651, 0x0003, 0x0020, 0x064D, 0x0651, 0x0003, 0x0020, 0x064E,
+  0x0651, 0x0003, 0x0020, 0x064F, 0x0651, 0x0003, 0x0020, 0x0650, 0x0651, 0x0003, 0x0020, 0x0651,
+  0x0670, 0x0003, 0x064A, 0x0654, 0x0631, 0x0003, 0x064A, 0x0654, 0x0632, 0x0003, 0x064A, 0x0654,
+  0x0646, 0x0002, 0x0628, 0x0631, 0x0002, 0x0628, 0x0632, 0x0002, 0x0628, 0x0646, 0x0002, 0x062A,
+  0x0631, 0x0002, 0x062A, 0x0632, 0x0002, 0x062A, 0x0646, 0x0002, 0x062B, 0x0631, 0x0002, 0x062B,
+  0x0632, 0x0002, 0x062B, 0x0646, 0x0002, 0x0645, 0x0627, 0x0002, 0x0646, 0x0631, 0x0002, 0x0646,
+  0x0632, 0x0002, 0x0646, 0x0646, 0x0002, 0x064A, 0x0631, 0x0002, 0x064A, 0x0632, 0x0002, 0x064A,
+  0x0646, 0x0003, 0x064A, 0x0654, 0x062E, 0x0003, 0x064A, 0x0654, 0x0647, 0x0002, 0x0628, 0x0647,
+  0x0002, 0x062A, 0x0647, 0x0002, 0x0635, 0x062E, 0x0002, 0x0644, 0x0647, 0x0002, 0x0646, 0x0647,
+  0x0002, 0x0647, 0x0670, 0x0002, 0x064A, 0x0647, 0x0002, 0x062B, 0x0647, 0x0002, 0x0633, 0x0647,
+  0x0002, 0x0634, 0x0645, 0x0002, 0x0634, 0x0647, 0x0003, 0x0640, 0x064E, 0x0651, 0x0003, 0x0640,
+  0x064F, 0x0651, 0x0003, 0x0640, 0x0650, 0x0651, 0x0002, 0x0637, 0x0649, 0x0002, 0x0637, 0x064A,
+  0x0002, 0x0639, 0x0649, 0x0002, 0x0639, 0x064A, 0x0002, 0x063A, 0x0649, 0x0002, 0x063A, 0x064A,
+  0x0002, 0x0633, 0x0649, 0x0002, 0x0633, 0x064A, 0x0002, 0x0634, 0x0649, 0x0002, 0x0634, 0x064A,
+  0x0002, 0x062D, 0x0649, 0x0002, 0x062D, 0x064A, 0x0002, 0x062C, 0x0649, 0x0002, 0x062C, 0x064A,
+  0x0002, 0x062E, 0x0649, 0x0002, 0x062E, 0x064A, 0x0002, 0x0635, 0x0649, 0x0002, 0x0635, 0x064A,
+  0x0002, 0x0636, 0x0649, 0x0002, 0x0636, 0x064A, 0x0002, 0x0634, 0x062C, 0x0002, 0x0634, 0x062D,
+  0x0002, 0x0634, 0x062E, 0x0002, 0x0634, 0x0631, 0x0002, 0x0633, 0x0631, 0x0002, 0x0635, 0x0631,
+  0x0002, 0x0636, 0x0631, 0x0002, 0x0627, 0x064B, 0x0003, 0x062A, 0x062C, 0x0645, 0x0003, 0x062A,
+  0x062D, 0x062C, 0x0003, 0x062A, 0x062D, 0x0645, 0x0003, 0x062A, 0x062E, 0x0645, 0x0003, 0x062A,
+  0x0645, 0x062C, 0x0003, 0x062A, 0x0645, 0x062D, 0x0003, 0x062A, 0x0645, 0x062E, 0x0003, 0x062C,
+  0x0645, 0x062D, 0x0003, 0x062D, 0x0645, 0x064A, 0x0003, 0x062D, 0x0645, 0x0649, 0x0003, 0x0633,
+  0x062D, 0x062C, 0x0003, 0x0633, 0x062C, 0x062D, 0x0003, 0x0633, 0x062C, 0x0649, 0x0003, 0x0633,
+  0x0645, 0x062D, 0x0003, 0x0633, 0x0645, 0x062C, 0x0003, 0x0633, 0x0645, 0x0645, 0x0003, 0x0635,
+  0x062D, 0x062D, 0x0003, 0x0635, 0x0645, 0x0645, 0x0003, 0x0634, 0x062D, 0x0645, 0x0003, 0x0634,
+  0x062C, 0x064A, 0x0003, 0x0634, 0x0645, 0x062E, 0x0003, 0x0634, 0x0645, 0x0645, 0x0003, 0x0636,
+  0x062D, 0x0649, 0x0003, 0x0636, 0x062E, 0x0645, 0x0003, 0x0637, 0x0645, 0x062D, 0x0003, 0x0637,
+  0x0645, 0x0645, 0x0003, 0x0637, 0x0645, 0x064A, 0x0003, 0x0639, 0x062C, 0x0645, 0x0003, 0x0639,
+  0x0645, 0x0645, 0x0003, 0x0639, 0x0645, 0x0649, 0x0003, 0x063A, 0x0645, 0x0645, 0x0003, 0x063A,
+  0x0645, 0x064A, 0x0003, 0x063A, 0x0645, 0x0649, 0x0003, 0x0641, 0x062E, 0x0645, 0x0003, 0x0642,
+  0x0645, 0x062D, 0x0003, 0x0642, 0x0645, 0x0645, 0x0003, 0x0644, 0x062D, 0x0645, 0x0003, 0x0644,
+  0x062D, 0x064A, 0x0003, 0x0644, 0x062D, 0x0649, 0x0003, 0x0644, 0x062C, 0x062C, 0x0003, 0x0644,
+  0x062E, 0x0645, 0x0003, 0x0644, 0x0645, 0x062D, 0x0003, 0x0645, 0x062D, 0x062C, 0x0003, 0x0645,
+  0x062D, 0x0645, 0x0003, 0x0645, 0x062D, 0x064A, 0x0003, 0x0645, 0x062C, 0x062D, 0x0003, 0x0645,
+  0x062C, 0x0645, 0x0003, 0x0645, 0x062E, 0x062C, 0x0003, 0x0645, 0x062E, 0x0645, 0x0003, 0x0645,
+  0x062C, 0x062E, 0x0003, 0x0647, 0x0645, 0x062C, 0x0003, 0x0647, 0x0645, 0x0645, 0x0003, 0x0646,
+  0x062D, 0x0645, 0x0003, 0x0646, 0x062D, 0x0649, 0x0003, 0x0646, 0x062C, 0x0645, 0x0003, 0x0646,
+  0x062C, 0x0649, 0x0003, 0x0646, 0x0645, 0x064A, 0x0003, 0x0646, 0x0645, 0x0649, 0x0003, 0x064A,
+  0x0645, 0x0645, 0x0003, 0x0628, 0x062E, 0x064A, 0x0003, 0x062A, 0x062C, 0x064A, 0x0003, 0x062A,
+  0x062C, 0x0649, 0x0003, 0x062A, 0x062E, 0x064A, 0x0003, 0x062A, 0x062E, 0x0649, 0x0003, 0x062A,
+  0x0645, 0x064A, 0x0003, 0x062A, 0x0645, 0x0649, 0x0003, 0x062C, 0x0645, 0x064A, 0x0003, 0x062C,
+  0x062D, 0x0649, 0x0003, 0x062C, 0x0645, 0x0649, 0x0003, 0x0633, 0x062E, 0x0649, 0x0003, 0x0635,
+  0x062D, 0x064A, 0x0003, 0x0634, 0x062D, 0x064A, 0x0003, 0x0636, 0x062D, 0x064A, 0x0003, 0x0644,
+  0x062C, 0x064A, 0x0003, 0x0644, 0x0645, 0x064A, 0x0003, 0x064A, 0x062D, 0x064A, 0x0003, 0x064A,
+  0x062C, 0x064A, 0x0003, 0x064A, 0x0645, 0x064A, 0x0003, 0x0645, 0x0645, 0x064A, 0x0003, 0x0642,
+  0x0645, 0x064A, 0x0003, 0x0646, 0x062D, 0x064A, 0x0003, 0x0639, 0x0645, 0x064A, 0x0003, 0x0643,
+  0x0645, 0x064A, 0x0003, 0x0646, 0x062C, 0x062D, 0x0003, 0x0645, 0x062E, 0x064A, 0x0003, 0x0644,
+  0x062C, 0x0645, 0x0003, 0x0643, 0x0645, 0x0645, 0x0003, 0x062C, 0x062D, 0x064A, 0x0003, 0x062D,
+  0x062C, 0x064A, 0x0003, 0x0645, 0x062C, 0x064A, 0x0003, 0x0641, 0x0645, 0x064A, 0x0003, 0x0628,
+  0x062D, 0x064A, 0x0003, 0x0633, 0x062E, 0x064A, 0x0003, 0x0646, 0x062C, 0x064A, 0x0003, 0x0635,
+  0x0644, 0x06D2, 0x0003, 0x0642, 0x0644, 0x06D2, 0x0004, 0x0627, 0x0644, 0x0644, 0x0647, 0x0004,
+  0x0627, 0x0643, 0x0628, 0x0631, 0x0004, 0x0645, 0x062D, 0x0645, 0x062F, 0x0004, 0x0635, 0x0644,
+  0x0639, 0x0645, 0x0004, 0x0631, 0x0633, 0x0648, 0x0644, 0x0004, 0x0639, 0x0644, 0x064A, 0x0647,
+  0x0004, 0x0648, 0x0633, 0x0644, 0x0645, 0x0003, 0x0635, 0x0644, 0x0649, 0x0012, 0x0635, 0x0644,
+  0x0649, 0x0020, 0x0627, 0x0644, 0x0644, 0x0647, 0x0020, 0x0639, 0x0644, 0x064A, 0x0647, 0x0020,
+  0x0648, 0x0633, 0x0644, 0x0645, 0x0008, 0x062C, 0x0644, 0x0020, 0x062C, 0x0644, 0x0627, 0x0644,
+  0x0647, 0x0004, 0x0631, 0x06CC, 0x0627, 0x0644, 0x0001, 0x002C, 0x0001, 0x3001, 0x0001, 0x3002,
+  0x0001, 0x003A, 0x0001, 0x0021, 0x0001, 0x003F, 0x0001, 0x3016, 0x0001, 0x3017, 0x0001, 0x2014,
+  0x0001, 0x2013, 0x0001, 0x005F, 0x0001, 0x007B, 0x0001, 0x007D, 0x0001, 0x3014, 0x0001, 0x3015,
+  0x0001, 0x3010, 0x0001, 0x3011, 0x0001, 0x300A, 0x0001, 0x300B, 0x0001, 0x300C, 0x0001, 0x300D,
+  0x0001, 0x300E, 0x0001, 0x300F, 0x0001, 0x005B, 0x0001, 0x005D, 0x0001, 0x0023, 0x0001, 0x0026,
+  0x0001, 0x002A, 0x0001, 0x002D, 0x0001, 0x003C, 0x0001, 0x003E, 0x0001, 0x005C, 0x0001, 0x0024,
+  0x0001, 0x0025, 0x0001, 0x0040, 0x0002, 0x0020, 0x064B, 0x0002, 0x0640, 0x064B, 0x0002, 0x0020,
+  0x064C, 0x0002, 0x0020, 0x064D, 0x0002, 0x0020, 0x064E, 0x0002, 0x0640, 0x064E, 0x0002, 0x0020,
+  0x064F, 0x0002, 0x0640, 0x064F, 0x0002, 0x0020, 0x0650, 0x0002, 0x0640, 0x0650, 0x0002, 0x0020,
+  0x0651, 0x0002, 0x0640, 0x0651, 0x0002, 0x0020, 0x0652, 0x0002, 0x0640, 0x0652, 0x0001, 0x0621,
+  0x0001, 0x0627, 0x0001, 0x0628, 0x0001, 0x0629, 0x0001, 0x062A, 0x0001, 0x062B, 0x0001, 0x062C,
+  0x0001, 0x062D, 0x0001, 0x062E, 0x0001, 0x062F, 0x0001, 0x0630, 0x0001, 0x0631, 0x0001, 0x0632,
+  0x0001, 0x0633, 0x0001, 0x0634, 0x0001, 0x0635, 0x0001, 0x0636, 0x0001, 0x0637, 0x0001, 0x0638,
+  0x0001, 0x0639, 0x0001, 0x063A, 0x0001, 0x0641, 0x0001, 0x0642, 0x0001, 0x0643, 0x0001, 0x0644,
+  0x0001, 0x0645, 0x0001, 0x0646, 0x0001, 0x0647, 0x0001, 0x0648, 0x0001, 0x064A, 0x0003, 0x0644,
+  0x0627, 0x0653, 0x0003, 0x0644, 0x0627, 0x0654, 0x0003, 0x0644, 0x0627, 0x0655, 0x0002, 0x0644,
+  0x0627, 0x0001, 0x0022, 0x0001, 0x0027, 0x0001, 0x002F, 0x0001, 0x005E, 0x0001, 0x007C, 0x0001,
+  0x007E, 0x0001, 0x2985, 0x0001, 0x2986, 0x0001, 0x30FB, 0x0001, 0x30A1, 0x0001, 0x30A3, 0x0001,
+  0x30A5, 0x0001, 0x30A7, 0x0001, 0x30A9, 0x0001, 0x30E3, 0x0001, 0x30E5, 0x0001, 0x30E7, 0x0001,
+  0x30C3, 0x0001, 0x30FC, 0x0001, 0x30F3, 0x0001, 0x3099, 0x0001, 0x309A, 0x0001, 0x00A2, 0x0001,
+  0x00A3, 0x0001, 0x00AC, 0x0001, 0x00A6, 0x0001, 0x00A5, 0x0001, 0x20A9, 0x0001, 0x2502, 0x0001,
+  0x2190, 0x0001, 0x2191, 0x0001, 0x2192, 0x0001, 0x2193, 0x0001, 0x25A0, 0x0001, 0x25CB, 0x0001,
+  0x02D0, 0x0001, 0x02D1, 0x0001, 0x00E6, 0x0001, 0x0299, 0x0001, 0x0253, 0x0001, 0x02A3, 0x0001,
+  0xAB66, 0x0001, 0x02A5, 0x0001, 0x02A4, 0x0001, 0x0256, 0x0001, 0x0257, 0x0001, 0x1D91, 0x0001,
+  0x0258, 0x0001, 0x025E, 0x0001, 0x02A9, 0x0001, 0x0264, 0x0001, 0x0262, 0x0001, 0x0260, 0x0001,
+  0x029B, 0x0001, 0x029C, 0x0001, 0x0267, 0x0001, 0x0284, 0x0001, 0x02AA, 0x0001, 0x02AB, 0x0001,
+  0x026C, 0x0001, 0x1DF04, 0x0001, 0xA78E, 0x0001, 0x026E, 0x0001, 0x1DF05, 0x0001, 0x028E, 0x0001,
+  0x1DF06, 0x0001, 0x00F8, 0x0001, 0x0276, 0x0001, 0x0277, 0x0001, 0x027A, 0x0001, 0x1DF08, 0x0001,
+  0x027D, 0x0001, 0x027E, 0x0001, 0x0280, 0x0001, 0x02A8, 0x0001, 0x02A6, 0x0001, 0xAB67, 0x0001,
+  0x02A7, 0x0001, 0x0288, 0x0001, 0x2C71, 0x0001, 0x028F, 0x0001, 0x02A1, 0x0001, 0x02A2, 0x0001,
+  0x0298, 0x0001, 0x01C0, 0x0001, 0x01C1, 0x0001, 0x01C2, 0x0001, 0x1DF0A, 0x0001, 0x1DF1E, 0x0002,
+  0x11099, 0x110BA, 0x0002, 0x1109B, 0x110BA, 0x0002, 0x110A5, 0x110BA, 0x0002, 0x11131, 0x11127, 0x0002,
+  0x11132, 0x11127, 0x0002, 0x11347, 0x1133E, 0x0002, 0x11347, 0x11357, 0x0002, 0x114B9, 0x114BA, 0x0002,
+  0x114B9, 0x114B0, 0x0002, 0x114B9, 0x114BD, 0x0002, 0x115B8, 0x115AF, 0x0002, 0x115B9, 0x115AF, 0x0002,
+  0x11935, 0x11930, 0x0002, 0x1D157, 0x1D165, 0x0002, 0x1D158, 0x1D165, 0x0003, 0x1D158, 0x1D165, 0x1D16E,
+  0x0003, 0x1D158, 0x1D165, 0x1D16F, 0x0003, 0x1D158, 0x1D165, 0x1D170, 0x0003, 0x1D158, 0x1D165, 0x1D171,
+  0x0003, 0x1D158, 0x1D165, 0x1D172, 0x0002, 0x1D1B9, 0x1D165, 0x0002, 0x1D1BA, 0x1D165, 0x0003, 0x1D1B9,
+  0x1D165, 0x1D16E, 0x0003, 0x1D1BA, 0x1D165, 0x1D16E, 0x0003, 0x1D1B9, 0x1D165, 0x1D16F, 0x0003, 0x1D1BA,
+  0x1D165, 0x1D16F, 0x0001, 0x0131, 0x0001, 0x0237, 0x0001, 0x0391, 0x0001, 0x0392, 0x0001, 0x0394,
+  0x0001, 0x0395, 0x0001, 0x0396, 0x0001, 0x0397, 0x0001, 0x0399, 0x0001, 0x039A, 0x0001, 0x039B,
+  0x0001, 0x039C, 0x0001, 0x039D, 0x0001, 0x039E, 0x0001, 0x039F, 0x0001, 0x03A1, 0x0001, 0x03A4,
+  0x0001, 0x03A6, 0x0001, 0x03A7, 0x0001, 0x03A8, 0x0001, 0x2207, 0x0001, 0x03B1, 0x0001, 0x03B6,
+  0x0001, 0x03B7, 0x0001, 0x03BB, 0x0001, 0x03BD, 0x0001, 0x03BE, 0x0001, 0x03BF, 0x0001, 0x03C3,
+  0x0001, 0x03C4, 0x0001, 0x03C5, 0x0001, 0x03C8, 0x0001, 0x03C9, 0x0001, 0x2202, 0x0001, 0x03DC,
+  0x0001, 0x03DD, 0x0001, 0x0430, 0x0001, 0x0431, 0x0001, 0x0432, 0x0001, 0x0433, 0x0001, 0x0434,
+  0x0001, 0x0435, 0x0001, 0x0436, 0x0001, 0x0437, 0x0001, 0x0438, 0x0001, 0x043A, 0x0001, 0x043B,
+  0x0001, 0x043C, 0x0001, 0x043E, 0x0001, 0x043F, 0x0001, 0x0440, 0x0001, 0x0441, 0x0001, 0x0442,
+  0x0001, 0x0443, 0x0001, 0x0444, 0x0001, 0x0445, 0x0001, 0x0446, 0x0001, 0x0447, 0x0001, 0x0448,
+  0x0001, 0x044B, 0x0001, 0x044D, 0x0001, 0x044E, 0x0001, 0xA689, 0x0001, 0x04D9, 0x0001, 0x0456,
+  0x0001, 0x0458, 0x0001, 0x04E9, 0x0001, 0x04AF, 0x0001, 0x04CF, 0x0001, 0x0491, 0x0001, 0x0455,
+  0x0001, 0x045F, 0x0001, 0x04AB, 0x0001, 0xA651, 0x0001, 0x04B1, 0x0001, 0x066E, 0x0001, 0x06A1,
+  0x0001, 0x066F, 0x0002, 0x0030, 0x002E, 0x0002, 0x0030, 0x002C, 0x0002, 0x0031, 0x002C, 0x0002,
+  0x0032, 0x002C, 0x0002, 0x0033, 0x002C, 0x0002, 0x0034, 0x002C, 0x0002, 0x0035, 0x002C, 0x0002,
+  0x0036, 0x002C, 0x0002, 0x0037, 0x002C, 0x0002, 0x0038, 0x002C, 0x0002, 0x0039, 0x002C, 0x0003,
+  0x0028, 0x0041, 0x0029, 0x0003, 0x0028, 0x0042, 0x0029, 0x0003, 0x0028, 0x0043, 0x0029, 0x0003,
+  0x0028, 0x0044, 0x0029, 0x0003, 0x0028, 0x0045, 0x0029, 0x0003, 0x0028, 0x0046, 0x0029, 0x0003,
+  0x0028, 0x0047, 0x0029, 0x0003, 0x0028, 0x0048, 0x0029, 0x0003, 0x0028, 0x0049, 0x0029, 0x0003,
+  0x0028, 0x004A, 0x0029, 0x0003, 0x0028, 0x004B, 0x0029, 0x0003, 0x0028, 0x004C, 0x0029, 0x0003,
+  0x0028, 0x004D, 0x0029, 0x0003, 0x0028, 0x004E, 0x0029, 0x0003, 0x0028, 0x004F, 0x0029, 0x0003,
+  0x0028, 0x0050, 0x0029, 0x0003, 0x0028, 0x0051, 0x0029, 0x0003, 0x0028, 0x0052, 0x0029, 0x0003,
+  0x0028, 0x0053, 0x0029, 0x0003, 0x0028, 0x0054, 0x0029, 0x0003, 0x0028, 0x0055, 0x0029, 0x0003,
+  0x0028, 0x0056, 0x0029, 0x0003, 0x0028, 0x0057, 0x0029, 0x0003, 0x0028, 0x0058, 0x0029, 0x0003,
+  0x0028, 0x0059, 0x0029, 0x0003, 0x0028, 0x005A, 0x0029, 0x0003, 0x3014, 0x0053, 0x3015, 0x0002,
+  0x0043, 0x0044, 0x0002, 0x0057, 0x005A, 0x0002, 0x0048, 0x0056, 0x0002, 0x0053, 0x0044, 0x0002,
+  0x0053, 0x0053, 0x0003, 0x0050, 0x0050, 0x0056, 0x0002, 0x0057, 0x0043, 0x0002, 0x004D, 0x0043,
+  0x0002, 0x004D, 0x0044, 0x0002, 0x004D, 0x0052, 0x0002, 0x0044, 0x004A, 0x0002, 0x307B, 0x304B,
+  0x0002, 0x30B3, 0x30B3, 0x0001, 0x5B57, 0x0001, 0x53CC, 0x0001, 0x591A, 0x0001, 0x89E3, 0x0001,
+  0x4EA4, 0x0001, 0x6620, 0x0001, 0x7121, 0x0001, 0x524D, 0x0001, 0x5F8C, 0x0001, 0x518D, 0x0001,
+  0x65B0, 0x0001, 0x521D, 0x0001, 0x7D42, 0x0001, 0x8CA9, 0x0001, 0x58F0, 0x0001, 0x5439, 0x0001,
+  0x6F14, 0x0001, 0x6295, 0x0001, 0x6355, 0x0001, 0x904A, 0x0001, 0x6307, 0x0001, 0x6253, 0x0001,
+  0x7981, 0x0001, 0x7A7A, 0x0001, 0x5408, 0x0001, 0x6E80, 0x0001, 0x7533, 0x0001, 0x5272, 0x0001,
+  0x55B6, 0x0001, 0x914D, 0x0003, 0x3014, 0x672C, 0x3015, 0x0003, 0x3014, 0x4E09, 0x3015, 0x0003,
+  0x3014, 0x4E8C, 0x3015, 0x0003, 0x3014, 0x5B89, 0x3015, 0x0003, 0x3014, 0x70B9, 0x3015, 0x0003,
+  0x3014, 0x6253, 0x3015, 0x0003, 0x3014, 0x76D7, 0x3015, 0x0003, 0x3014, 0x52DD, 0x3015, 0x0003,
+  0x3014, 0x6557, 0x3015, 0x0001, 0x5F97, 0x0001, 0x53EF, 0x0001, 0x4E3D, 0x0001, 0x4E38, 0x0001,
+  0x4E41, 0x0001, 0x20122, 0x0001, 0x4F60, 0x0001, 0x4FBB, 0x0001, 0x5002, 0x0001, 0x507A, 0x0001,
+  0x5099, 0x0001, 0x50CF, 0x0001, 0x349E, 0x0001, 0x2063A, 0x0001, 0x5154, 0x0001, 0x5164, 0x0001,
+  0x5177, 0x0001, 0x2051C, 0x0001, 0x34B9, 0x0001, 0x5167, 0x0001, 0x2054B, 0x0001, 0x5197, 0x0001,
+  0x51A4, 0x0001, 0x4ECC, 0x0001, 0x51AC, 0x0001, 0x291DF, 0x0001, 0x5203, 0x0001, 0x34DF, 0x0001,
+  0x523B, 0x0001, 0x5246, 0x0001, 0x5277, 0x0001, 0x3515, 0x0001, 0x5305, 0x0001, 0x5306, 0x0001,
+  0x5349, 0x0001, 0x535A, 0x0001, 0x5373, 0x0001, 0x537D, 0x0001, 0x537F, 0x0001, 0x20A2C, 0x0001,
+  0x7070, 0x0001, 0x53CA, 0x0001, 0x53DF, 0x0001, 0x20B63, 0x0001, 0x53EB, 0x0001, 0x53F1, 0x0001,
+  0x5406, 0x0001, 0x549E, 0x0001, 0x5438, 0x0001, 0x5448, 0x0001, 0x5468, 0x0001, 0x54A2, 0x0001,
+  0x54F6, 0x0001, 0x5510, 0x0001, 0x5553, 0x0001, 0x5563, 0x0001, 0x5584, 0x0001, 0x55AB, 0x0001,
+  0x55B3, 0x0001, 0x55C2, 0x0001, 0x5716, 0x0001, 0x5717, 0x0001, 0x5651, 0x0001, 0x5674, 0x0001,
+  0x58EE, 0x0001, 0x57CE, 0x0001, 0x57F4, 0x0001, 0x580D, 0x0001, 0x578B, 0x0001, 0x5832, 0x0001,
+  0x5831, 0x0001, 0x58AC, 0x0001, 0x214E4, 0x0001, 0x58F2, 0x0001, 0x58F7, 0x0001, 0x5906, 0x0001,
+  0x5922, 0x0001, 0x5962, 0x0001, 0x216A8, 0x0001, 0x216EA, 0x0001, 0x59EC, 0x0001, 0x5A1B, 0x0001,
+  0x5A27, 0x0001, 0x59D8, 0x0001, 0x5A66, 0x0001, 0x36EE, 0x0001, 0x36FC, 0x0001, 0x5B08, 0x0001,
+  0x5B3E, 0x0001, 0x219C8, 0x0001, 0x5BC3, 0x0001, 0x5BD8, 0x0001, 0x5BF3, 0x0001, 0x21B18, 0x0001,
+  0x5BFF, 0x0001, 0x5C06, 0x0001, 0x5F53, 0x0001, 0x3781, 0x0001, 0x5C60, 0x0001, 0x5CC0, 0x0001,
+  0x5C8D, 0x0001, 0x21DE4, 0x0001, 0x5D43, 0x0001, 0x21DE6, 0x0001, 0x5D6E, 0x0001, 0x5D6B, 0x0001,
+  0x5D7C, 0x0001, 0x5DE1, 0x0001, 0x5DE2, 0x0001, 0x382F, 0x0001, 0x5DFD, 0x0001, 0x5E28, 0x0001,
+  0x5E3D, 0x0001, 0x5E69, 0x0001, 0x3862, 0x0001, 0x22183, 0x0001, 0x387C, 0x0001, 0x5EB0, 0x0001,
+  0x5EB3, 0x0001, 0x5EB6, 0x0001, 0x2A392, 0x0001, 0x22331, 0x0001, 0x8201, 0x0001, 0x5F22, 0x0001,
+  0x38C7, 0x0001, 0x232B8, 0x0001, 0x261DA, 0x0001, 0x5F62, 0x0001, 0x5F6B, 0x0001, 0x38E3, 0x0001,
+  0x5F9A, 0x0001, 0x5FCD, 0x0001, 0x5FD7, 0x0001, 0x5FF9, 0x0001, 0x6081, 0x0001, 0x393A, 0x0001,
+  0x391C, 0x0001, 0x226D4, 0x0001, 0x60C7, 0x0001, 0x6148, 0x0001, 0x614C, 0x0001, 0x617A, 0x0001,
+  0x61B2, 0x0001, 0x61A4, 0x0001, 0x61AF, 0x0001, 0x61DE, 0x0001, 0x6210, 0x0001, 0x621B, 0x0001,
+  0x625D, 0x0001, 0x62B1, 0x0001, 0x62D4, 0x0001, 0x6350, 0x0001, 0x22B0C, 0x0001, 0x633D, 0x0001,
+  0x62FC, 0x0001, 0x6368, 0x0001, 0x6383, 0x0001, 0x63E4, 0x0001, 0x22BF1, 0x0001, 0x6422, 0x0001,
+  0x63C5, 0x0001, 0x63A9, 0x0001, 0x3A2E, 0x0001, 0x6469, 0x0001, 0x647E, 0x0001, 0x649D, 0x0001,
+  0x6477, 0x0001, 0x3A6C, 0x0001, 0x656C, 0x0001, 0x2300A, 0x0001, 0x65E3, 0x0001, 0x66F8, 0x0001,
+  0x6649, 0x0001, 0x3B19, 0x0001, 0x3B08, 0x0001, 0x3AE4, 0x0001, 0x5192, 0x0001, 0x5195, 0x0001,
+  0x6700, 0x0001, 0x669C, 0x0001, 0x80AD, 0x0001, 0x43D9, 0x0001, 0x6721, 0x0001, 0x675E, 0x0001,
+  0x6753, 0x0001, 0x233C3, 0x0001, 0x3B49, 0x0001, 0x67FA, 0x0001, 0x6785, 0x0001, 0x6852, 0x0001,
+  0x2346D, 0x0001, 0x688E, 0x0001, 0x681F, 0x0001, 0x6914, 0x0001, 0x6942, 0x0001, 0x69A3, 0x0001,
+  0x69EA, 0x0001, 0x6AA8, 0x0001, 0x236A3, 0x0001, 0x6ADB, 0x0001, 0x3C18, 0x0001, 0x6B21, 0x0001,
+  0x238A7, 0x0001, 0x6B54, 0x0001, 0x3C4E, 0x0001, 0x6B72, 0x0001, 0x6B9F, 0x0001, 0x6BBB, 0x0001,
+  0x23A8D, 0x0001, 0x21D0B, 0x0001, 0x23AFA, 0x0001, 0x6C4E, 0x0001, 0x23CBC, 0x0001, 0x6CBF, 0x0001,
+  0x6CCD, 0x0001, 0x6C67, 0x0001, 0x6D16, 0x0001, 0x6D3E, 0x0001, 0x6D69, 0x0001, 0x6D78, 0x0001,
+  0x6D85, 0x0001, 0x23D1E, 0x0001, 0x6D34, 0x0001, 0x6E2F, 0x0001, 0x6E6E, 0x0001, 0x3D33, 0x0001,
+  0x6EC7, 0x0001, 0x23ED1, 0x0001, 0x6DF9, 0x0001, 0x6F6E, 0x0001, 0x23F5E, 0x0001, 0x23F8E, 0x0001,
+  0x6FC6, 0x0001, 0x7039, 0x0001, 0x701B, 0x0001, 0x3D96, 0x0001, 0x704A, 0x0001, 0x707D, 0x0001,
+  0x7077, 0x0001, 0x70AD, 0x0001, 0x20525, 0x0001, 0x7145, 0x0001, 0x24263, 0x0001, 0x719C, 0x0001,
+  0x243AB, 0x0001, 0x7228, 0x0001, 0x7250, 0x0001, 0x24608, 0x0001, 0x7280, 0x0001, 0x7295, 0x0001,
+  0x24735, 0x0001, 0x24814, 0x0001, 0x737A, 0x0001, 0x738B, 0x0001, 0x3EAC, 0x0001, 0x73A5, 0x0001,
+  0x3EB8, 0x0001, 0x7447, 0x0001, 0x745C, 0x0001, 0x7485, 0x0001, 0x74CA, 0x0001, 0x3F1B, 0x0001,
+  0x7524, 0x0001, 0x24C36, 0x0001, 0x753E, 0x0001, 0x24C92, 0x0001, 0x2219F, 0x0001, 0x7610, 0x0001,
+  0x24FA1, 0x0001, 0x24FB8, 0x0001, 0x25044, 0x0001, 0x3FFC, 0x0001, 0x4008, 0x0001, 0x250F3, 0x0001,
+  0x250F2, 0x0001, 0x25119, 0x0001, 0x25133, 0x0001, 0x771E, 0x0001, 0x771F, 0x0001, 0x778B, 0x0001,
+  0x4046, 0x0001, 0x4096, 0x0001, 0x2541D, 0x0001, 0x784E, 0x0001, 0x40E3, 0x0001, 0x25626, 0x0001,
+  0x2569A, 0x0001, 0x256C5, 0x0001, 0x79EB, 0x0001, 0x412F, 0x0001, 0x7A4A, 0x0001, 0x7A4F, 0x0001,
+  0x2597C, 0x0001, 0x25AA7, 0x0001, 0x7AEE, 0x0001, 0x4202, 0x0001, 0x25BAB, 0x0001, 0x7BC6, 0x0001,
+  0x7BC9, 0x0001, 0x4227, 0x0001, 0x25C80, 0x0001, 0x7CD2, 0x0001, 0x42A0, 0x0001, 0x7CE8, 0x0001,
+  0x7CE3, 0x0001, 0x7D00, 0x0001, 0x25F86, 0x0001, 0x7D63, 0x0001, 0x4301, 0x0001, 0x7DC7, 0x0001,
+  0x7E02, 0x0001, 0x7E45, 0x0001, 0x4334, 0x0001, 0x26228, 0x0001, 0x26247, 0x0001, 0x4359, 0x0001,
+  0x262D9, 0x0001, 0x7F7A, 0x0001, 0x2633E, 0x0001, 0x7F95, 0x0001, 0x7FFA, 0x0001, 0x264DA, 0x0001,
+  0x26523, 0x0001, 0x8060, 0x0001, 0x265A8, 0x0001, 0x8070, 0x0001, 0x2335F, 0x0001, 0x43D5, 0x0001,
+  0x80B2, 0x0001, 0x8103, 0x0001, 0x440B, 0x0001, 0x813E, 0x0001, 0x5AB5, 0x0001, 0x267A7, 0x0001,
+  0x267B5, 0x0001, 0x23393, 0x0001, 0x2339C, 0x0001, 0x8204, 0x0001, 0x8F9E, 0x0001, 0x446B, 0x0001,
+  0x8291, 0x0001, 0x828B, 0x0001, 0x829D, 0x0001, 0x52B3, 0x0001, 0x82B1, 0x0001, 0x82B3, 0x0001,
+  0x82BD, 0x0001, 0x82E6, 0x0001, 0x26B3C, 0x0001, 0x831D, 0x0001, 0x8363, 0x0001, 0x83AD, 0x0001,
+  0x8323, 0x0001, 0x83BD, 0x0001, 0x83E7, 0x0001, 0x8353, 0x0001, 0x83CA, 0x0001, 0x83CC, 0x0001,
+  0x83DC, 0x0001, 0x26C36, 0x0001, 0x26D6B, 0x0001, 0x26CD5, 0x0001, 0x452B, 0x0001, 0x84F1, 0x0001,
+  0x84F3, 0x0001, 0x8516, 0x0001, 0x273CA, 0x0001, 0x8564, 0x0001, 0x26F2C, 0x0001, 0x455D, 0x0001,
+  0x4561, 0x0001, 0x26FB1, 0x0001, 0x270D2, 0x0001, 0x456B, 0x0001, 0x8650, 0x0001, 0x8667, 0x0001,
+  0x8669, 0x0001, 0x86A9, 0x0001, 0x8688, 0x0001, 0x870E, 0x0001, 0x86E2, 0x0001, 0x8728, 0x0001,
+  0x876B, 0x0001, 0x8786, 0x0001, 0x45D7, 0x0001, 0x87E1, 0x0001, 0x8801, 0x0001, 0x45F9, 0x0001,
+  0x8860, 0x0001, 0x27667, 0x0001, 0x88D7, 0x0001, 0x88DE, 0x0001, 0x4635, 0x0001, 0x88FA, 0x0001,
+  0x34BB, 0x0001, 0x278AE, 0x0001, 0x27966, 0x0001, 0x46BE, 0x0001, 0x46C7, 0x0001, 0x8AA0, 0x0001,
+  0x27CA8, 0x0001, 0x8CAB, 0x0001, 0x8CC1, 0x0001, 0x8D1B, 0x0001, 0x8D77, 0x0001, 0x27F2F, 0x0001,
+  0x20804, 0x0001, 0x8DCB, 0x0001, 0x8DBC, 0x0001, 0x8DF0, 0x0001, 0x208DE, 0x0001, 0x8ED4, 0x0001,
+  0x285D2, 0x0001, 0x285ED, 0x0001, 0x9094, 0x0001, 0x90F1, 0x0001, 0x9111, 0x0001, 0x2872E, 0x0001,
+  0x911B, 0x0001, 0x9238, 0x0001, 0x92D7, 0x0001, 0x92D8, 0x0001, 0x927C, 0x0001, 0x93F9, 0x0001,
+  0x9415, 0x0001, 0x28BFA, 0x0001, 0x958B, 0x0001, 0x4995, 0x0001, 0x95B7, 0x0001, 0x28D77, 0x0001,
+  0x49E6, 0x0001, 0x96C3, 0x0001, 0x5DB2, 0x0001, 0x9723, 0x0001, 0x29145, 0x0001, 0x2921A, 0x0001,
+  0x4A6E, 0x0001, 0x4A76, 0x0001, 0x97E0, 0x0001, 0x2940A, 0x0001, 0x4AB2, 0x0001, 0x29496, 0x0001,
+  0x9829, 0x0001, 0x295B6, 0x0001, 0x98E2, 0x0001, 0x4B33, 0x0001, 0x9929, 0x0001, 0x99A7, 0x0001,
+  0x99C2, 0x0001, 0x99FE, 0x0001, 0x4BCE, 0x0001, 0x29B30, 0x0001, 0x9C40, 0x0001, 0x9CFD, 0x0001,
+  0x4CCE, 0x0001, 0x4CED, 0x0001, 0x9D67, 0x0001, 0x2A0CE, 0x0001, 0x4CF8, 0x0001, 0x2A105, 0x0001,
+  0x2A20E, 0x0001, 0x2A291, 0x0001, 0x4D56, 0x0001, 0x9EFE, 0x0001, 0x9F05, 0x0001, 0x9F0F, 0x0001,
+  0x9F16, 0x0001, 0x2A600,
+};
+
+const char32_t _unicode_compositions[] = {
+  0x0000, 0x0001, 0x0338, 0x226E, 0x0001, 0x0338, 0x2260, 0x0001, 0x0338, 0x226F, 0x0010, 0x0300,
+  0x00C0, 0x0301, 0x00C1, 0x0302, 0x00C2, 0x0303, 0x00C3, 0x0304, 0x0100, 0x0306, 0x0102, 0x0307,
+  0x0226, 0x0308, 0x00C4, 0x0309, 0x1EA2, 0x030A, 0x00C5, 0x030C, 0x01CD, 0x030F, 0x0200, 0x0311,
+  0x0202, 0x0323, 0x1EA0, 0x0325, 0x1E00, 0x0328, 0x0104, 0x0003, 0x0307, 0x1E02, 0x0323, 0x1E04,
+  0x0331, 0x1E06, 0x0005, 0x0301, 0x0106, 0x0302, 0x0108, 0x0307, 0x010A, 0x030C, 0x010C, 0x0327,
+  0x00C7, 0x0006, 0x0307, 0x1E0A, 0x030C, 0x010E, 0x0323, 0x1E0C, 0x0327, 0x1E10, 0x032D, 0x1E12,
+  0x0331, 0x1E0E, 0x0011, 0x0300, 0x00C8, 0x0301, 0x00C9, 0x0302, 0x00CA, 0x0303, 0x1EBC, 0x0304,
+  0x0112, 0x0306, 0x0114, 0x0307, 0x0116, 0x0308, 0x00CB, 0x0309, 0x1EBA, 0x030C, 0x011A, 0x030F,
+  0x0204, 0x0311, 0x0206, 0x0323, 0x1EB8, 0x0327, 0x0228, 0x0328, 0x0118, 0x032D, 0x1E18, 0x0330,
+  0x1E1A, 0x0001, 0x0307, 0x1E1E, 0x0007, 0x0301, 0x01F4, 0x0302, 0x011C, 0x0304, 0x1E20, 0x0306,
+  0x011E, 0x0307, 0x0120, 0x030C, 0x01E6, 0x0327, 0x0122, 0x0007, 0x0302, 0x0124, 0x0307, 0x1E22,
+  0x0308, 0x1E26, 0x030C, 0x021E, 0x0323, 0x1E24, 0x0327, 0x1E28, 0x032E, 0x1E2A, 0x000F, 0x0300,
+  0x00CC, 0x0301, 0x00CD, 0x0302, 0x00CE, 0x0303, 0x0128, 0x0304, 0x012A, 0x0306, 0x012C, 0x0307,
+  0x0130, 0x0308, 0x00CF, 0x0309, 0x1EC8, 0x030C, 0x01CF, 0x030F, 0x0208, 0x0311, 0x020A, 0x0323,
+  0x1ECA, 0x0328, 0x012E, 0x0330, 0x1E2C, 0x0001, 0x0302, 0x0134, 0x0005, 0x0301, 0x1E30, 0x030C,
+  0x01E8, 0x0323, 0x1E32, 0x0327, 0x0136, 0x0331, 0x1E34, 0x0006, 0x0301, 0x0139, 0x030C, 0x013D,
+  0x0323, 0x1E36, 0x0327, 0x013B, 0x032D, 0x1E3C, 0x0331, 0x1E3A, 0x0003, 0x0301, 0x1E3E, 0x0307,
+  0x1E40, 0x0323, 0x1E42, 0x0009, 0x0300, 0x01F8, 0x0301, 0x0143, 0x0303, 0x00D1, 0x0307, 0x1E44,
+  0x030C, 0x0147, 0x0323, 0x1E46, 0x0327, 0x0145, 0x032D, 0x1E4A, 0x0331, 0x1E48, 0x0010, 0x0300,
+  0x00D2, 0x0301, 0x00D3, 0x0302, 0x00D4, 0x0303, 0x00D5, 0x0304, 0x014C, 0x0306, 0x014E, 0x0307,
+  0x022E, 0x0308, 0x00D6, 0x0309, 0x1ECE, 0x030B, 0x0150, 0x030C, 0x01D1, 0x030F, 0x020C, 0x0311,
+  0x020E, 0x031B, 0x01A0, 0x0323, 0x1ECC, 0x0328, 0x01EA, 0x0002, 0x0301, 0x1E54, 0x0307, 0x1E56,
+  0x0008, 0x0301, 0x0154, 0x0307, 0x1E58, 0x030C, 0x0158, 0x030F, 0x0210, 0x0311, 0x0212, 0x0323,
+  0x1E5A, 0x0327, 0x0156, 0x0331, 0x1E5E, 0x0007, 0x0301, 0x015A, 0x0302, 0x015C, 0x0307, 0x1E60,
+  0x030C, 0x0160, 0x0323, 0x1E62, 0x0326, 0x0218, 0x0327, 0x015E, 0x0007, 0x0307, 0x1E6A, 0x030C,
+  0x0164, 0x0323, 0x1E6C, 0x0326, 0x021A, 0x0327, 0x0162, 0x032D, 0x1E70, 0x0331, 0x1E6E, 0x0013,
+  0x0300, 0x00D9, 0x0301, 0x00DA, 0x0302, 0x00DB, 0x0303, 0x0168, 0x0304, 0x016A, 0x0306, 0x016C,
+  0x0308, 0x00DC, 0x0309, 0x1EE6, 0x030A, 0x016E, 0x030B, 0x0170, 0x030C, 0x01D3, 0x030F, 0x0214,
+  0x0311, 0x0216, 0x031B, 0x01AF, 0x0323, 0x1EE4, 0x0324, 0x1E72, 0x0328, 0x0172, 0x032D, 0x1E76,
+  0x0330, 0x1E74, 0x0002, 0x0303, 0x1E7C, 0x0323, 0x1E7E, 0x0006, 0x0300, 0x1E80, 0x0301, 0x1E82,
+  0x0302, 0x0174, 0x0307, 0x1E86, 0x0308, 0x1E84, 0x0323, 0x1E88, 0x0002, 0x0307, 0x1E8A, 0x0308,
+  0x1E8C, 0x0009, 0x0300, 0x1EF2, 0x0301, 0x00DD, 0x0302, 0x0176, 0x0303, 0x1EF8, 0x0304, 0x0232,
+  0x0307, 0x1E8E, 0x0308, 0x0178, 0x0309, 0x1EF6, 0x0323, 0x1EF4, 0x0006, 0x0301, 0x0179, 0x0302,
+  0x1E90, 0x0307, 0x017B, 0x030C, 0x017D, 0x0323, 0x1E92, 0x0331, 0x1E94, 0x0010, 0x0300, 0x00E0,
+  0x0301, 0x00E1, 0x0302, 0x00E2, 0x0303, 0x00E3, 0x0304, 0x0101, 0x0306, 0x0103, 0x0307, 0x0227,
+  0x0308, 0x00E4, 0x0309, 0x1EA3, 0x030A, 0x00E5, 0x030C, 0x01CE, 0x030F, 0x0201, 0x0311, 0x0203,
+  0x0323, 0x1EA1, 0x0325, 0x1E01, 0x0328, 0x0105, 0x0003, 0x0307, 0x1E03, 0x0323, 0x1E05, 0x0331,
+  0x1E07, 0x0005, 0x0301, 0x0107, 0x0302, 0x0109, 0x0307, 0x010B, 0x030C, 0x010D, 0x0327, 0x00E7,
+  0x0006, 0x0307, 0x1E0B, 0x030C, 0x010F, 0x0323, 0x1E0D, 0x0327, 0x1E11, 0x032D, 0x1E13, 0x0331,
+  0x1E0F, 0x0011, 0x0300, 0x00E8, 0x0301, 0x00E9, 0x0302, 0x00EA, 0x0303, 0x1EBD, 0x0304, 0x0113,
+  0x0306, 0x0115, 0x0307, 0x0117, 0x0308, 0x00EB, 0x0309, 0x1EBB, 0x030C, 0x011B, 0x030F, 0x0205,
+  0x0311, 0x0207, 0x0323, 0x1EB9, 0x0327, 0x0229, 0x0328, 0x0119, 0x032D, 0x1E19, 0x0330, 0x1E1B,
+  0x0001, 0x0307, 0x1E1F, 0x0007, 0x0301, 0x01F5, 0x0302, 0x011D, 0x0304, 0x1E21, 0x0306, 0x011F,
+  0x0307, 0x0121, 0x030C, 0x01E7, 0x0327, 0x0123, 0x0008, 0x0302, 0x0125, 0x0307, 0x1E23, 0x0308,
+  0x1E27, 0x030C, 0x021F, 0x0323, 0x1E25, 0x0327, 0x1E29, 0x032E, 0x1E2B, 0x0331, 0x1E96, 0x000E,
+  0x0300, 0x00EC, 0x0301, 0x00ED, 0x0302, 0x00EE, 0x0303, 0x0129, 0x0304, 0x012B, 0x0306, 0x012D,
+  0x0308, 0x00EF, 0x0309, 0x1EC9, 0x030C, 0x01D0, 0x030F, 0x0209, 0x0311, 0x020B, 0x0323, 0x1ECB,
+  0x0328, 0x012F, 0x0330, 0x1E2D, 0x0002, 0x0302, 0x0135, 0x030C, 0x01F0, 0x0005, 0x0301, 0x1E31,
+  0x030C, 0x01E9, 0x0323, 0x1E33, 0x0327, 0x0137, 0x0331, 0x1E35, 0x0006, 0x0301, 0x013A, 0x030C,
+  0x013E, 0x0323, 0x1E37, 0x0327, 0x013C, 0x032D, 0x1E3D, 0x0331, 0x1E3B, 0x0003, 0x0301, 0x1E3F,
+  0x0307, 0x1E41, 0x0323, 0x1E43, 0x0009, 0x0300, 0x01F9, 0x0301, 0x0144, 0x0303, 0x00F1, 0x0307,
+  0x1E45, 0x030C, 0x0148, 0x0323, 0x1E47, 0x0327, 0x0146, 0x032D, 0x1E4B, 0x0331, 0x1E49, 0x0010,
+  0x0300, 0x00F2, 0x0301, 0x00F3, 0x0302, 0x00F4, 0x0303, 0x00F5, 0x0304, 0x014D, 0x0306, 0x014F,
+  0x0307, 0x022F, 0x0308, 0x00F6, 0x0309, 0x1ECF, 0x030B, 0x0151, 0x030C, 0x01D2, 0x030F, 0x020D,
+  0x0311, 0x020F, 0x031B, 0x01A1, 0x0323, 0x1ECD, 0x0328, 0x01EB, 0x0002, 0x0301, 0x1E55, 0x0307,
+  0x1E57, 0x0008, 0x0301, 0x0155, 0x0307, 0x1E59, 0x030C, 0x0159, 0x030F, 0x0211, 0x0311, 0x0213,
+  0x0323, 0x1E5B, 0x0327, 0x0157, 0x0331, 0x1E5F, 0x0007, 0x0301, 0x015B, 0x0302, 0x015D, 0x0307,
+  0x1E61, 0x030C, 0x0161, 0x0323, 0x1E63, 0x0326, 0x0219, 0x0327, 0x015F, 0x0008, 0x0307, 0x1E6B,
+  0x0308, 0x1E97, 0x030C, 0x0165, 0x0323, 0x1E6D, 0x0326, 0x021B, 0x0327, 0x0163, 0x032D, 0x1E71,
+  0x0331, 0x1E6F, 0x0013, 0x0300, 0x00F9, 0x0301, 0x00FA, 0x0302, 0x00FB, 0x0303, 0x0169, 0x0304,
+  0x016B, 0x0306, 0x016D, 0x0308, 0x00FC, 0x0309, 0x1EE7, 0x030A, 0x016F, 0x030B, 0x0171, 0x030C,
+  0x01D4, 0x030F, 0x0215, 0x0311, 0x0217, 0x031B, 0x01B0, 0x0323, 0x1EE5, 0x0324, 0x1E73, 0x0328,
+  0x0173, 0x032D, 0x1E77, 0x0330, 0x1E75, 0x0002, 0x0303, 0x1E7D, 0x0323, 0x1E7F, 0x0007, 0x0300,
+  0x1E81, 0x0301, 0x1E83, 0x0302, 0x0175, 0x0307, 0x1E87, 0x0308, 0x1E85, 0x030A, 0x1E98, 0x0323,
+  0x1E89, 0x0002, 0x0307, 0x1E8B, 0x0308, 0x1E8D, 0x000A, 0x0300, 0x1EF3, 0x0301, 0x00FD, 0x0302,
+  0x0177, 0x0303, 0x1EF9, 0x0304, 0x0233, 0x0307, 0x1E8F, 0x0308, 0x00FF, 0x0309, 0x1EF7, 0x030A,
+  0x1E99, 0x0323, 0x1EF5, 0x0006, 0x0301, 0x017A, 0x0302, 0x1E91, 0x0307, 0x017C, 0x030C, 0x017E,
+  0x0323, 0x1E93, 0x0331, 0x1E95, 0x0003, 0x0300, 0x1FED, 0x0301, 0x0385, 0x0342, 0x1FC1, 0x0004,
+  0x0300, 0x1EA6, 0x0301, 0x1EA4, 0x0303, 0x1EAA, 0x0309, 0x1EA8, 0x0001, 0x0304, 0x01DE, 0x0001,
+  0x0301, 0x01FA, 0x0002, 0x0301, 0x01FC, 0x0304, 0x01E2, 0x0001, 0x0301, 0x1E08, 0x0004, 0x0300,
+  0x1EC0, 0x0301, 0x1EBE, 0x0303, 0x1EC4, 0x0309, 0x1EC2, 0x0001, 0x0301, 0x1E2E, 0x0004, 0x0300,
+  0x1ED2, 0x0301, 0x1ED0, 0x0303, 0x1ED6, 0x0309, 0x1ED4, 0x0003, 0x0301, 0x1E4C, 0x0304, 0x022C,
+  0x0308, 0x1E4E, 0x0001, 0x0304, 0x022A, 0x0001, 0x0301, 0x01FE, 0x0004, 0x0300, 0x01DB, 0x0301,
+  0x01D7, 0x0304, 0x01D5, 0x030C, 0x01D9, 0x0004, 0x0300, 0x1EA7, 0x0301, 0x1EA5, 0x0303, 0x1EAB,
+  0x0309, 0x1EA9, 0x0001, 0x0304, 0x01DF, 0x0001, 0x0301, 0x01FB, 0x0002, 0x0301, 0x01FD, 0x0304,
+  0x01E3, 0x0001, 0x0301, 0x1E09, 0x0004, 0x0300, 0x1EC1, 0x0301, 0x1EBF, 0x0303, 0x1EC5, 0x0309,
+  0x1EC3, 0x0001, 0x0301, 0x1E2F, 0x0004, 0x0300, 0x1ED3, 0x0301, 0x1ED1, 0x0303, 0x1ED7, 0x0309,
+  0x1ED5, 0x0003, 0x0301, 0x1E4D, 0x0304, 0x022D, 0x0308, 0x1E4F, 0x0001, 0x0304, 0x022B, 0x0001,
+  0x0301, 0x01FF, 0x0004, 0x0300, 0x01DC, 0x0301, 0x01D8, 0x0304, 0x01D6, 0x030C, 0x01DA, 0x0004,
+  0x0300, 0x1EB0, 0x0301, 0x1EAE, 0x0303, 0x1EB4, 0x0309, 0x1EB2, 0x0004, 0x0300, 0x1EB1, 0x0301,
+  0x1EAF, 0x0303, 0x1EB5, 0x0309, 0x1EB3, 0x0002, 0x0300, 0x1E14, 0x0301, 0x1E16, 0x0002, 0x0300,
+  0x1E15, 0x0301, 0x1E17, 0x0002, 0x0300, 0x1E50, 0x0301, 0x1E52, 0x0002, 0x0300, 0x1E51, 0x0301,
+  0x1E53, 0x0001, 0x0307, 0x1E64, 0x0001, 0x0307, 0x1E65, 0x0001, 0x0307, 0x1E66, 0x0001, 0x0307,
+  0x1E67, 0x0001, 0x0301, 0x1E78, 0x0001, 0x0301, 0x1E79, 0x0001, 0x0308, 0x1E7A, 0x0001, 0x0308,
+  0x1E7B, 0x0001, 0x0307, 0x1E9B, 0x0005, 0x0300, 0x1EDC, 0x0301, 0x1EDA, 0x0303, 0x1EE0, 0x0309,
+  0x1EDE, 0x0323, 0x1EE2, 0x0005, 0x0300, 0x1EDD, 0x0301, 0x1EDB, 0x0303, 0x1EE1, 0x0309, 0x1EDF,
+  0x0323, 0x1EE3, 0x0005, 0x0300, 0x1EEA, 0x0301, 0x1EE8, 0x0303, 0x1EEE, 0x0309, 0x1EEC, 0x0323,
+  0x1EF0, 0x0005, 0x0300, 0x1EEB, 0x0301, 0x1EE9, 0x0303, 0x1EEF, 0x0309, 0x1EED, 0x0323, 0x1EF1,
+  0x0001, 0x030C, 0x01EE, 0x0001, 0x0304, 0x01EC, 0x0001, 0x0304, 0x01ED, 0x0001, 0x0304, 0x01E0,
+  0x0001, 0x0304, 0x01E1, 0x0001, 0x0306, 0x1E1C, 0x0001, 0x0306, 0x1E1D, 0x0001, 0x0304, 0x0230,
+  0x0001, 0x0304, 0x0231, 0x0001, 0x030C, 0x01EF, 0x0007, 0x0300, 0x1FBA, 0x0301, 0x0386, 0x0304,
+  0x1FB9, 0x0306, 0x1FB8, 0x0313, 0x1F08, 0x0314, 0x1F09, 0x0345, 0x1FBC, 0x0004, 0x0300, 0x1FC8,
+  0x0301, 0x0388, 0x0313, 0x1F18, 0x0314, 0x1F19, 0x0005, 0x0300, 0x1FCA, 0x0301, 0x0389, 0x0313,
+  0x1F28, 0x0314, 0x1F29, 0x0345, 0x1FCC, 0x0007, 0x0300, 0x1FDA, 0x0301, 0x038A, 0x0304, 0x1FD9,
+  0x0306, 0x1FD8, 0x0308, 0x03AA, 0x0313, 0x1F38, 0x0314, 0x1F39, 0x0004, 0x0300, 0x1FF8, 0x0301,
+  0x038C, 0x0313, 0x1F48, 0x0314, 0x1F49, 0x0001, 0x0314, 0x1FEC, 0x0006, 0x0300, 0x1FEA, 0x0301,
+  0x038E, 0x0304, 0x1FE9, 0x0306, 0x1FE8, 0x0308, 0x03AB, 0x0314, 0x1F59, 0x0005, 0x0300, 0x1FFA,
+  0x0301, 0x038F, 0x0313, 0x1F68, 0x0314, 0x1F69, 0x0345, 0x1FFC, 0x0001, 0x0345, 0x1FB4, 0x0001,
+  0x0345, 0x1FC4, 0x0008, 0x0300, 0x1F70, 0x0301, 0x03AC, 0x0304, 0x1FB1, 0x0306, 0x1FB0, 0x0313,
+  0x1F00, 0x0314, 0x1F01, 0x0342, 0x1FB6, 0x0345, 0x1FB3, 0x0004, 0x0300, 0x1F72, 0x0301, 0x03AD,
+  0x0313, 0x1F10, 0x0314, 0x1F11, 0x0006, 0x0300, 0x1F74, 0x0301, 0x03AE, 0x0313, 0x1F20, 0x0314,
+  0x1F21, 0x0342, 0x1FC6, 0x0345, 0x1FC3, 0x0008, 0x0300, 0x1F76, 0x0301, 0x03AF, 0x0304, 0x1FD1,
+  0x0306, 0x1FD0, 0x0308, 0x03CA, 0x0313, 0x1F30, 0x0314, 0x1F31, 0x0342, 0x1FD6, 0x0004, 0x0300,
+  0x1F78, 0x0301, 0x03CC, 0x0313, 0x1F40, 0x0314, 0x1F41, 0x0002, 0x0313, 0x1FE4, 0x0314, 0x1FE5,
+  0x0008, 0x0300, 0x1F7A, 0x0301, 0x03CD, 0x0304, 0x1FE1, 0x0306, 0x1FE0, 0x0308, 0x03CB, 0x0313,
+  0x1F50, 0x0314, 0x1F51, 0x0342, 0x1FE6, 0x0006, 0x0300, 0x1F7C, 0x0301, 0x03CE, 0x0313, 0x1F60,
+  0x0314, 0x1F61, 0x0342, 0x1FF6, 0x0345, 0x1FF3, 0x0003, 0x0300, 0x1FD2, 0x0301, 0x0390, 0x0342,
+  0x1FD7, 0x0003, 0x0300, 0x1FE2, 0x0301, 0x03B0, 0x0342, 0x1FE7, 0x0001, 0x0345, 0x1FF4, 0x0002,
+  0x0301, 0x03D3, 0x0308, 0x03D4, 0x0001, 0x0308, 0x0407, 0x0002, 0x0306, 0x04D0, 0x0308, 0x04D2,
+  0x0001, 0x0301, 0x0403, 0x0003, 0x0300, 0x0400, 0x0306, 0x04D6, 0x0308, 0x0401, 0x0002, 0x0306,
+  0x04C1, 0x0308, 0x04DC, 0x0001, 0x0308, 0x04DE, 0x0004, 0x0300, 0x040D, 0x0304, 0x04E2, 0x0306,
+  0x0419, 0x0308, 0x04E4, 0x0001, 0x0301, 0x040C, 0x0001, 0x0308, 0x04E6, 0x0004, 0x0304, 0x04EE,
+  0x0306, 0x040E, 0x0308, 0x04F0, 0x030B, 0x04F2, 0x0001, 0x0308, 0x04F4, 0x0001, 0x0308, 0x04F8,
+  0x0001, 0x0308, 0x04EC, 0x0002, 0x0306, 0x04D1, 0x0308, 0x04D3, 0x0001, 0x0301, 0x0453, 0x0003,
+  0x0300, 0x0450, 0x0306, 0x04D7, 0x0308, 0x0451, 0x0002, 0x0306, 0x04C2, 0x0308, 0x04DD, 0x0001,
+  0x0308, 0x04DF, 0x0004, 0x0300, 0x045D, 0x0304, 0x04E3, 0x0306, 0x0439, 0x0308, 0x04E5, 0x0001,
+  0x0301, 0x045C, 0x0001, 0x0308, 0x04E7, 0x0004, 0x0304, 0x04EF, 0x0306, 0x045E, 0x0308, 0x04F1,
+  0x030B, 0x04F3, 0x0001, 0x0308, 0x04F5, 0x0001, 0x0308, 0x04F9, 0x0001, 0x0308, 0x04ED, 0x0001,
+  0x0308, 0x0457, 0x0001, 0x030F, 0x0476, 0x0001, 0x030F, 0x0477, 0x0001, 0x0308, 0x04DA, 0x0001,
+  0x0308, 0x04DB, 0x0001, 0x0308, 0x04EA, 0x0001, 0x0308, 0x04EB, 0x0003, 0x0653, 0x0622, 0x0654,
+  0x0623, 0x0655, 0x0625, 0x0001, 0x0654, 0x0624, 0x0001, 0x0654, 0x0626, 0x0001, 0x0654, 0x06C2,
+  0x0001, 0x0654, 0x06D3, 0x0001, 0x0654, 0x06C0, 0x0001, 0x093C, 0x0929, 0x0001, 0x093C, 0x0931,
+  0x0001, 0x093C, 0x0934, 0x0002, 0x09BE, 0x09CB, 0x09D7, 0x09CC, 0x0003, 0x0B3E, 0x0B4B, 0x0B56,
+  0x0B48, 0x0B57, 0x0B4C, 0x0001, 0x0BD7, 0x0B94, 0x0002, 0x0BBE, 0x0BCA, 0x0BD7, 0x0BCC, 0x0001,
+  0x0BBE, 0x0BCB, 0x0001, 0x0C56, 0x0C48, 0x0001, 0x0CD5, 0x0CC0, 0x0003, 0x0CC2, 0x0CCA, 0x0CD5,
+  0x0CC7, 0x0CD6, 0x0CC8, 0x0001, 0x0CD5, 0x0CCB, 0x0002, 0x0D3E, 0x0D4A, 0x0D57, 0x0D4C, 0x0001,
+  0x0D3E, 0x0D4B, 0x0003, 0x0DCA, 0x0DDA, 0x0DCF, 0x0DDC, 0x0DDF, 0x0DDE, 0x0001, 0x0DCA, 0x0DDD,
+  0x0001, 0x102E, 0x1026, 0x0001, 0x1B35, 0x1B06, 0x0001, 0x1B35, 0x1B08, 0x0001, 0x1B35, 0x1B0A,
+  0x0001, 0x1B35, 0x1B0C, 0x0001, 0x1B35, 0x1B0E, 0x0001, 0x1B35, 0x1B12, 0x0001, 0x1B35, 0x1B3B,
+  0x0001, 0x1B35, 0x1B3D, 0x0001, 0x1B35, 0x1B40, 0x0001, 0x1B35, 0x1B41, 0x0001, 0x1B35, 0x1B43,
+  0x0001, 0x0304, 0x1E38, 0x0001, 0x0304, 0x1E39, 0x0001, 0x0304, 0x1E5C, 0x0001, 0x0304, 0x1E5D,
+  0x0001, 0x0307, 0x1E68, 0x0001, 0x0307, 0x1E69, 0x0002, 0x0302, 0x1EAC, 0x0306, 0x1EB6, 0x0002,
+  0x0302, 0x1EAD, 0x0306, 0x1EB7, 0x0001, 0x0302, 0x1EC6, 0x0001, 0x0302, 0x1EC7, 0x0001, 0x0302,
+  0x1ED8, 0x0001, 0x0302, 0x1ED9, 0x0004, 0x0300, 0x1F02, 0x0301, 0x1F04, 0x0342, 0x1F06, 0x0345,
+  0x1F80, 0x0004, 0x0300, 0x1F03, 0x0301, 0x1F05, 0x0342, 0x1F07, 0x0345, 0x1F81, 0x0001, 0x0345,
+  0x1F82, 0x0001, 0x0345, 0x1F83, 0x0001, 0x0345, 0x1F84, 0x0001, 0x0345, 0x1F85, 0x0001, 0x0345,
+  0x1F86, 0x0001, 0x0345, 0x1F87, 0x0004, 0x0300, 0x1F0A, 0x0301, 0x1F0C, 0x0342, 0x1F0E, 0x0345,
+  0x1F88, 0x0004, 0x0300, 0x1F0B, 0x0301, 0x1F0D, 0x0342, 0x1F0F, 0x0345, 0x1F89, 0x0001, 0x0345,
+  0x1F8A, 0x0001, 0x0345, 0x1F8B, 0x0001, 0x0345, 0x1F8C, 0x0001, 0x0345, 0x1F8D, 0x0001, 0x0345,
+  0x1F8E, 0x0001, 0x0345, 0x1F8F, 0x0002, 0x0300, 0x1F12, 0x0301, 0x1F14, 0x0002, 0x0300, 0x1F13,
+  0x0301, 0x1F15, 0x0002, 0x0300, 0x1F1A, 0x0301, 0x1F1C, 0x0002, 0x0300, 0x1F1B, 0x0301, 0x1F1D,
+  0x0004, 0x0300, 0x1F22, 0x0301, 0x1F24, 0x0342, 0x1F26, 0x0345, 0x1F90, 0x0004, 0x0300, 0x1F23,
+  0x0301, 0x1F25, 0x0342, 0x1F27, 0x0345, 0x1F91, 0x0001, 0x0345, 0x1F92, 0x0001, 0x0345, 0x1F93,
+  0x0001, 0x0345, 0x1F94, 0x0001, 0x0345, 0x1F95, 0x0001, 0x0345, 0x1F96, 0x0001, 0x0345, 0x1F97,
+  0x0004, 0x0300, 0x1F2A, 0x0301, 0x1F2C, 0x0342, 0x1F2E, 0x0345, 0x1F98, 0x0004, 0x0300, 0x1F2B,
+  0x0301, 0x1F2D, 0x0342, 0x1F2F, 0x0345, 0x1F99, 0x0001, 0x0345, 0x1F9A, 0x0001, 0x0345, 0x1F9B,
+  0x0001, 0x0345, 0x1F9C, 0x0001, 0x0345, 0x1F9D, 0x0001, 0x0345, 0x1F9E, 0x0001, 0x0345, 0x1F9F,
+  0x0003, 0x0300, 0x1F32, 0x0301, 0x1F34, 0x0342, 0x1F36, 0x0003, 0x0300, 0x1F33, 0x0301, 0x1F35,
+  0x0342, 0x1F37, 0x0003, 0x0300, 0x1F3A, 0x0301, 0x1F3C, 0x0342, 0x1F3E, 0x0003, 0x0300, 0x1F3B,
+  0x0301, 0x1F3D, 0x0342, 0x1F3F, 0x0002, 0x0300, 0x1F42, 0x0301, 0x1F44, 0x0002, 0x0300, 0x1F43,
+  0x0301, 0x1F45, 0x0002, 0x0300, 0x1F4A, 0x0301, 0x1F4C, 0x0002, 0x0300, 0x1F4B, 0x0301, 0x1F4D,
+  0x0003, 0x0300, 0x1F52, 0x0301, 0x1F54, 0x0342, 0x1F56, 0x0003, 0x0300, 0x1F53, 0x0301, 0x1F55,
+  0x0342, 0x1F57, 0x0003, 0x0300, 0x1F5B, 0x0301, 0x1F5D, 0x0342, 0x1F5F, 0x0004, 0x0300, 0x1F62,
+  0x0301, 0x1F64, 0x0342, 0x1F66, 0x0345, 0x1FA0, 0x0004, 0x0300, 0x1F63, 0x0301, 0x1F65, 0x0342,
+  0x1F67, 0x0345, 0x1FA1, 0x0001, 0x0345, 0x1FA2, 0x0001, 0x0345, 0x1FA3, 0x0001, 0x0345, 0x1FA4,
+  0x0001, 0x0345, 0x1FA5, 0x0001, 0x0345, 0x1FA6, 0x0001, 0x0345, 0x1FA7, 0x0004, 0x0300, 0x1F6A,
+  0x0301, 0x1F6C, 0x0342, 0x1F6E, 0x0345, 0x1FA8, 0x0004, 0x0300, 0x1F6B, 0x0301, 0x1F6D, 0x0342,
+  0x1F6F, 0x0345, 0x1FA9, 0x0001, 0x0345, 0x1FAA, 0x0001, 0x0345, 0x1FAB, 0x0001, 0x0345, 0x1FAC,
+  0x0001, 0x0345, 0x1FAD, 0x0001, 0x0345, 0x1FAE, 0x0001, 0x0345, 0x1FAF, 0x0001, 0x0345, 0x1FB2,
+  0x0001, 0x0345, 0x1FC2, 0x0001, 0x0345, 0x1FF2, 0x0001, 0x0345, 0x1FB7, 0x0003, 0x0300, 0x1FCD,
+  0x0301, 0x1FCE, 0x0342, 0x1FCF, 0x0001, 0x0345, 0x1FC7, 0x0001, 0x0345, 0x1FF7, 0x0003, 0x0300,
+  0x1FDD, 0x0301, 0x1FDE, 0x0342, 0x1FDF, 0x0001, 0x0338, 0x219A, 0x0001, 0x0338, 0x219B, 0x0001,
+  0x0338, 0x21AE, 0x0001, 0x0338, 0x21CD, 0x0001, 0x0338, 0x21CF, 0x0001, 0x0338, 0x21CE, 0x0001,
+  0x0338, 0x2204, 0x0001, 0x0338, 0x2209, 0x0001, 0x0338, 0x220C, 0x0001, 0x0338, 0x2224, 0x0001,
+  0x0338, 0x2226, 0x0001, 0x0338, 0x2241, 0x0001, 0x0338, 0x2244, 0x0001, 0x0338, 0x2247, 0x0001,
+  0x0338, 0x2249, 0x0001, 0x0338, 0x226D, 0x0001, 0x0338, 0x2262, 0x0001, 0x0338, 0x2270, 0x0001,
+  0x0338, 0x2271, 0x0001, 0x0338, 0x2274, 0x0001, 0x0338, 0x2275, 0x0001, 0x0338, 0x2278, 0x0001,
+  0x0338, 0x2279, 0x0001, 0x0338, 0x2280, 0x0001, 0x0338, 0x2281, 0x0001, 0x0338, 0x22E0, 0x0001,
+  0x0338, 0x22E1, 0x0001, 0x0338, 0x2284, 0x0001, 0x0338, 0x2285, 0x0001, 0x0338, 0x2288, 0x0001,
+  0x0338, 0x2289, 0x0001, 0x0338, 0x22E2, 0x0001, 0x0338, 0x22E3, 0x0001, 0x0338, 0x22AC, 0x0001,
+  0x0338, 0x22AD, 0x0001, 0x0338, 0x22AE, 0x0001, 0x0338, 0x22AF, 0x0001, 0x0338, 0x22EA, 0x0001,
+  0x0338, 0x22EB, 0x0001, 0x0338, 0x22EC, 0x0001, 0x0338, 0x22ED, 0x0001, 0x3099, 0x3094, 0x0001,
+  0x3099, 0x304C, 0x0001, 0x3099, 0x304E, 0x0001, 0x3099, 0x3050, 0x0001, 0x3099, 0x3052, 0x0001,
+  0x3099, 0x3054, 0x0001, 0x3099, 0x3056, 0x0001, 0x3099, 0x3058, 0x0001, 0x3099, 0x305A, 0x0001,
+  0x3099, 0x305C, 0x0001, 0x3099, 0x305E, 0x0001, 0x3099, 0x3060, 0x0001, 0x3099, 0x3062, 0x0001,
+  0x3099, 0x3065, 0x0001, 0x3099, 0x3067, 0x0001, 0x3099, 0x3069, 0x0002, 0x3099, 0x3070, 0x309A,
+  0x3071, 0x0002, 0x3099, 0x3073, 0x309A, 0x3074, 0x0002, 0x3099, 0x3076, 0x309A, 0x3077, 0x0002,
+  0x3099, 0x3079, 0x309A, 0x307A, 0x0002, 0x3099, 0x307C, 0x309A, 0x307D, 0x0001, 0x3099, 0x309E,
+  0x0001, 0x3099, 0x30F4, 0x0001, 0x3099, 0x30AC, 0x0001, 0x3099, 0x30AE, 0x0001, 0x3099, 0x30B0,
+  0x0001, 0x3099, 0x30B2, 0x0001, 0x3099, 0x30B4, 0x0001, 0x3099, 0x30B6, 0x0001, 0x3099, 0x30B8,
+  0x0001, 0x3099, 0x30BA, 0x0001, 0x3099, 0x30BC, 0x0001, 0x3099, 0x30BE, 0x0001, 0x3099, 0x30C0,
+  0x0001, 0x3099, 0x30C2, 0x0001, 0x3099, 0x30C5, 0x0001, 0x3099, 0x30C7, 0x0001, 0x3099, 0x30C9,
+  0x0002, 0x3099, 0x30D0, 0x309A, 0x30D1, 0x0002, 0x3099, 0x30D3, 0x309A, 0x30D4, 0x0002, 0x3099,
+  0x30D6, 0x309A, 0x30D7, 0x0002, 0x3099, 0x30D9, 0x309A, 0x30DA, 0x0002, 0x3099, 0x30DC, 0x309A,
+  0x30DD, 0x0001, 0x3099, 0x30F7, 0x0001, 0x3099, 0x30F8, 0x0001, 0x3099, 0x30F9, 0x0001, 0x3099,
+  0x30FA, 0x0001, 0x3099, 0x30FE, 0x0001, 0x110BA, 0x1109A, 0x0001, 0x110BA, 0x1109C, 0x0001, 0x110BA,
+  0x110AB, 0x0001, 0x11127, 0x1112E, 0x0001, 0x11127, 0x1112F, 0x0002, 0x1133E, 0x1134B, 0x11357, 0x1134C,
+  0x0003, 0x114B0, 0x114BC, 0x114BA, 0x114BB, 0x114BD, 0x114BE, 0x0001, 0x115AF, 0x115BA, 0x0001, 0x115AF,
+  0x115BB, 0x0001, 0x11930, 0x11938,
+};
+
+const char32_t _unicode_quick_check_limits[] = {
+  0x0300, 0x00C0, 0x00A0, 0x00A0,
+};
+
+// Break properties: packed values, 249 unique blocks.
+
+static const uint16_t _unicode_break_table_stage1[] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+  32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 41, 41, 42, 43, 44, 45,
+  46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61,
+  62, 63, 64, 65, 66, 66, 67, 68, 66, 69, 66, 70, 71, 72, 73, 74,
+  66, 66, 75, 76, 66, 66, 77, 66, 78, 79, 80, 81, 82, 66, 66, 66,
+  83, 84, 85, 86, 66, 87, 88, 66, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 90, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  41, 41, 41, 41, 41, 41, 41, 41, 41, 91, 41, 41, 92, 93, 94, 95,
+  96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 104,
+  105, 106, 107, 108, 109, 110, 104, 105, 106, 107, 108, 109, 110, 104, 105, 106,
+  107, 108, 109, 110, 104, 105, 106, 107, 108, 109, 110, 104, 105, 106, 107, 108,
+  109, 110, 104, 105, 106, 107, 108, 109, 110, 104, 105, 106, 107, 108, 109, 110,
+  104, 105, 106, 107, 108, 109, 110, 104, 105, 106, 107, 108, 109, 110, 104, 105,
+  106, 107, 108, 109, 110, 104, 105, 106, 107, 108, 109, 110, 104, 105, 106, 111,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 89, 89, 112, 113, 114, 115, 41, 41, 116, 117, 118, 119, 120, 121,
+  122, 123, 124, 125, 66, 126, 127, 128, 129, 130, 131, 132, 41, 41, 133, 134,
+  135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 66, 66, 146, 147, 148,
+  149, 150, 151, 152, 153, 154, 155, 66, 156, 157, 66, 158, 159, 160, 161, 66,
+  162, 163, 164, 165, 166, 167, 66, 66, 168, 169, 170, 171, 66, 172, 173, 174,
+  41, 41, 41, 41, 41, 41, 41, 175, 176, 41, 177, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 178,
+  41, 41, 41, 41, 41, 41, 41, 41, 179, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 41, 41, 41, 41, 180, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  41, 41, 41, 41, 181, 182, 183, 184, 66, 66, 66, 66, 185, 186, 187, 188,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 189,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 190, 191, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 192,
+  193, 89, 194, 89, 89, 195, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 196, 197, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 198, 66,
+  66, 66, 199, 200, 201, 66, 66, 66, 202, 203, 204, 205, 206, 207, 208, 209,
+  66, 66, 66, 66, 210, 211, 66, 66, 66, 66, 66, 66, 66, 66, 212, 66,
+  213, 214, 215, 66, 66, 216, 66, 66, 66, 217, 66, 66, 66, 66, 66, 218,
+  41, 219, 220, 66, 66, 66, 66, 66, 66, 66, 66, 66, 221, 222, 66, 66,
+  223, 223, 224, 225, 226, 223, 223, 227, 223, 223, 228, 223, 229, 223, 230, 231,
+  232, 233, 234, 223, 223, 223, 66, 235, 223, 223, 223, 223, 223, 223, 223, 236,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 237, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 238, 89,
+  239, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 240, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 241, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  89, 89, 89, 89, 242, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 243, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89, 89,
+  89, 89, 89, 89, 89, 89, 89, 244, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66, 66,
+  245, 246, 247, 248, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246,
+  246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246,
+};
+
+static const uint16_t _unicode_break_table_stage2[] = {
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3075, 1058, 3123, 3123, 529, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3360, 6656, 7360, 0, 0, 0, 0, 7344, 7168, 7168, 0, 0, 6384, 6144, 5840, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 6368, 240, 0, 0, 0, 6656,
+  0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 7168, 0, 7168, 0, 272,
+  0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 7168, 0, 7168, 0, 3,
+  3, 3, 3, 3, 3, 2099, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3072, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 3744, 7168, 0, 2675, 8192, 0,
+  0, 0, 0, 0, 0, 3744, 0, 224, 0, 0, 3744, 7168, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256,
+  3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 4256, 3744, 4256, 3744, 4256, 3744, 3744,
+  3744, 4256, 4256, 3744, 4256, 3744, 4256, 4256, 3744, 4256, 4256, 4256, 3744, 3744, 4256, 4256,
+  4256, 4256, 3744, 4256, 4256, 3744, 4256, 4256, 4256, 3744, 3744, 3744, 4256, 4256, 3744, 4256,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 4256, 3744, 4256, 3744, 3744, 4256, 3744, 4256, 4256,
+  3744, 4256, 4256, 4256, 3744, 4256, 3744, 4256, 4256, 3744, 3744, 4768, 4256, 3744, 3744, 3744,
+  4768, 4768, 4768, 4768, 4256, 4256, 3744, 4256, 4256, 3744, 4256, 4256, 3744, 4256, 3744, 4256,
+  3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  3744, 4256, 4256, 3744, 4256, 3744, 4256, 4256, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 3744, 4256, 4256, 3744,
+  3744, 4256, 3744, 4256, 4256, 4256, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 4768, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  3744, 3744, 160, 160, 160, 160, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 160, 160, 160, 160, 160, 160, 0, 0, 0, 0, 0, 0, 160, 160,
+  3744, 3744, 3744, 3744, 3744, 160, 160, 160, 160, 160, 160, 160, 4768, 160, 4768, 160,
+  160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  4256, 3744, 4256, 3744, 4768, 0, 4256, 3744, 0, 0, 3744, 3744, 3744, 3744, 240, 4256,
+  0, 0, 0, 0, 0, 0, 4256, 224, 4256, 4256, 4256, 0, 4256, 0, 4256, 4256,
+  3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256,
+  3744, 3744, 4256, 4256, 4256, 3744, 3744, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  3744, 3744, 3744, 3744, 4256, 3744, 0, 4256, 3744, 4256, 4256, 3744, 3744, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 0, 4768, 160, 160, 160, 6144, 160, 224,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 6896, 160, 0, 0, 0, 0, 0,
+  0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 1604,
+  0, 1604, 1604, 0, 1604, 1604, 0, 1604, 0, 0, 0, 0, 0, 0, 0, 0,
+  4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752,
+  4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 0, 0, 0, 0, 4752,
+  4752, 4752, 4752, 4768, 224, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  2679, 2679, 2679, 2679, 2679, 2679, 0, 0, 0, 0, 0, 0, 6384, 6384, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 2675, 6656, 6656, 6656,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 5376, 5360, 0, 4768, 4768,
+  1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 6656, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 2679, 0, 1604,
+  1604, 1604, 1604, 1604, 1604, 4768, 4768, 1604, 1604, 0, 1604, 1604, 1604, 1604, 4768, 4768,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4768, 4768, 4768, 0, 0, 4768,
+  6656, 6656, 6656, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2679,
+  4768, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 4768, 4768, 0, 0, 6384, 6656, 4768, 0, 0, 1604, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 4768, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 4768, 1604, 1604, 1604, 4768, 1604, 1604, 1604, 1604, 1604, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 6656, 0, 6656, 0, 0, 0, 6656, 6656, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  2679, 2679, 0, 0, 0, 0, 0, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 2679, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1608, 1604, 4768, 1608, 1608,
+  1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1608, 1608, 1608, 1604, 1608, 1608,
+  4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 1604, 1604, 6656, 6656, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 1604, 1608, 1608, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768,
+  4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 0, 0, 0, 4768, 4768, 4768, 4768, 0, 0, 1604, 4768, 1604, 1608,
+  1608, 1604, 1604, 1604, 1604, 0, 0, 1608, 1608, 0, 0, 1608, 1608, 1604, 4768, 0,
+  0, 0, 0, 0, 0, 0, 0, 1604, 0, 0, 0, 0, 4768, 4768, 0, 4768,
+  4768, 4768, 1604, 1604, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4768, 0, 1604, 0,
+  0, 1604, 1604, 1608, 0, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 4768,
+  4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 4768, 0, 4768, 4768, 0, 4768, 4768, 0, 0, 1604, 0, 1608, 1608,
+  1608, 1604, 1604, 0, 0, 0, 0, 1604, 1604, 0, 0, 1604, 1604, 1604, 0, 0,
+  0, 1604, 0, 0, 0, 0, 0, 0, 0, 4768, 4768, 4768, 4768, 0, 4768, 0,
+  0, 0, 0, 0, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  1604, 1604, 4768, 4768, 4768, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1604, 1604, 1608, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768,
+  4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 0, 0, 1604, 4768, 1608, 1608,
+  1608, 1604, 1604, 1604, 1604, 1604, 0, 1604, 1604, 1608, 0, 1608, 1608, 1604, 0, 0,
+  4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 1604, 1604, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 4768, 1604, 1604, 1604, 1604, 1604, 1604,
+  0, 1604, 1608, 1608, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768,
+  4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 0, 0, 1604, 4768, 1604, 1604,
+  1608, 1604, 1604, 1604, 1604, 0, 0, 1608, 1608, 0, 0, 1608, 1608, 1604, 0, 0,
+  0, 0, 0, 0, 0, 1604, 1604, 1604, 0, 0, 0, 0, 4768, 4768, 0, 4768,
+  4768, 4768, 1604, 1604, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1604, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 4768, 4768,
+  4768, 0, 4768, 4768, 4768, 4768, 0, 0, 0, 4768, 4768, 0, 4768, 0, 4768, 4768,
+  0, 0, 0, 4768, 4768, 0, 0, 0, 4768, 4768, 4768, 0, 0, 0, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 1604, 1608,
+  1604, 1608, 1608, 0, 0, 0, 1608, 1608, 1608, 0, 1608, 1608, 1608, 1604, 0, 0,
+  4768, 0, 0, 0, 0, 0, 0, 1604, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1608, 1608, 1608, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768,
+  4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 1604, 4768, 1604, 1604,
+  1604, 1608, 1608, 1608, 1608, 0, 1604, 1604, 1604, 0, 1604, 1604, 1604, 1604, 0, 0,
+  0, 0, 0, 0, 0, 1604, 1604, 0, 4768, 4768, 4768, 0, 0, 4768, 0, 0,
+  4768, 4768, 1604, 1604, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 1604, 1608, 1608, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768,
+  4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 0, 0, 1604, 4768, 1608, 1604,
+  1608, 1608, 1604, 1608, 1608, 0, 1604, 1608, 1608, 0, 1608, 1608, 1604, 1604, 0, 0,
+  0, 0, 0, 0, 0, 1604, 1604, 0, 0, 0, 0, 0, 0, 4768, 4768, 0,
+  4768, 4768, 1604, 1604, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 4768, 4768, 1608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1608, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768,
+  4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 4768, 1604, 1608,
+  1608, 1604, 1604, 1604, 1604, 0, 1608, 1608, 1608, 0, 1608, 1608, 1608, 1604, 4775, 0,
+  0, 0, 0, 0, 4768, 4768, 4768, 1604, 0, 0, 0, 0, 0, 0, 0, 4768,
+  4768, 4768, 1604, 1604, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 1604, 1608, 1608, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 1604, 0, 0, 0, 0, 1604,
+  1608, 1608, 1604, 1604, 1604, 0, 1604, 0, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1604,
+  0, 0, 0, 0, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 0, 1608, 1608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 1604, 4608, 4616, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 4608, 4608, 0, 4608, 0, 4608, 4608, 4608, 4608, 4608, 0, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 0, 4608, 0, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 1604, 4608, 4616, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 4608, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 0, 4608, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 4608, 4608, 4608, 4608,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 1604, 1604, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1604, 0, 1604, 0, 1604, 7168, 7168, 7168, 7168, 1608, 1608,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608,
+  1604, 1604, 1604, 1604, 1604, 0, 1604, 1604, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 1600, 1600, 1604, 1604, 1604,
+  1604, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1600, 1604, 1604, 1608, 1608, 1604, 1604, 4608,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 6656, 6656, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 1608, 1608, 1604, 1604, 4608, 4608, 4608, 4608, 1604, 1604,
+  1604, 4608, 1600, 1600, 1600, 4608, 4608, 1600, 1600, 1600, 1600, 1600, 1600, 1600, 4608, 4608,
+  4608, 1604, 1604, 1604, 1604, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 1604, 1600, 1608, 1604, 1604, 1600, 1600, 1600, 1600, 1600, 1600, 1604, 4608, 1600,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 1600, 1600, 1600, 1604, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 0, 4256, 0, 0, 0, 0, 0, 4256, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 3744, 4768, 4768, 4768,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777,
+  4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778,
+  4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778,
+  4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778,
+  4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778,
+  4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 0, 4768, 4768, 4768, 4768, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  4768, 0, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 1604, 1604, 1604,
+  0, 0, 6656, 0, 0, 0, 0, 6656, 6656, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 0, 0, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0,
+  0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 6656, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  3360, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 7168, 7168, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 1604, 1604, 1604, 1608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 1604, 1604, 1608, 6656, 6656, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768,
+  4768, 0, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 1604, 1604, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1608,
+  1608, 1608, 1608, 1608, 1608, 1608, 1604, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 0, 0, 0, 4608, 0, 0, 0, 0, 4608, 1604, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 6144, 6656, 0, 0, 0, 0, 6144, 6656, 0, 1604, 1604, 1604, 2675, 1604,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 1604, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 4768, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  1604, 1604, 1604, 1608, 1608, 1608, 1608, 1604, 1604, 1608, 1608, 1608, 0, 0, 0, 0,
+  1608, 1608, 1604, 1608, 1608, 1608, 1608, 1608, 1608, 1604, 1604, 1604, 0, 0, 0, 0,
+  0, 0, 0, 0, 6656, 6656, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1608, 1608, 1604, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 1608, 1604, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0,
+  1604, 1600, 1604, 1600, 1600, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1608, 1608,
+  1608, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 1604,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 4608, 6656, 6656, 6656, 6656, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1604, 1608, 1608, 1608,
+  1608, 1608, 1604, 1608, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 6656, 6656, 0, 0, 6656, 6656,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6656, 6656, 0,
+  1604, 1604, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 1608, 1604, 1604, 1604, 1604, 1608, 1608, 1604, 1604, 1608, 1604, 1604, 1604, 4768, 4768,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 1604, 1608, 1604, 1604, 1608, 1608, 1608, 1604, 1608, 1604,
+  1604, 1604, 1608, 1608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1608, 1608, 1604, 1604, 0, 0, 0, 6656, 6656, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 4768, 4768, 4768,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 6656, 6656,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 4768, 4768, 4768, 4768, 1604, 4768, 4768,
+  4768, 4768, 4768, 4768, 1604, 4768, 4768, 1608, 1604, 1604, 4768, 0, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 4256, 4256, 4256, 4256, 4256, 4256, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 4256, 4256, 4256, 4256, 4256, 4256, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 4256, 0, 4256, 0, 4256, 0, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 0, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 0, 3744, 0,
+  0, 0, 3744, 3744, 3744, 0, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 0, 0, 0,
+  3744, 3744, 3744, 3744, 0, 0, 3744, 3744, 4256, 4256, 4256, 4256, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 0, 0, 0,
+  0, 0, 3744, 3744, 3744, 0, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 0, 0, 0,
+  3360, 3360, 3360, 3360, 3360, 3360, 3360, 3072, 3360, 3360, 3360, 2563, 1604, 1621, 2675, 2675,
+  0, 0, 0, 6144, 6144, 0, 0, 0, 7376, 7376, 7168, 7168, 7168, 7168, 7168, 7168,
+  0, 0, 0, 0, 5840, 0, 0, 224, 2099, 2099, 2675, 2675, 2675, 2675, 2675, 3344,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 7168, 7168, 0, 14848, 6656, 0, 272,
+  272, 0, 0, 0, 240, 7168, 7168, 6656, 6656, 14848, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 272, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3360,
+  2675, 2675, 2675, 2675, 2675, 3, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675,
+  0, 3744, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7168, 7168, 3744,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7168, 7168, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 4256, 0, 0, 0, 0, 4256, 0, 0, 3744, 4256, 4256, 4256, 3744, 3744,
+  4256, 4256, 4256, 3744, 0, 4256, 0, 0, 0, 4256, 4256, 4256, 4256, 4256, 0, 0,
+  0, 0, 8192, 0, 4256, 0, 4256, 0, 4256, 0, 4256, 4256, 4256, 4256, 0, 3744,
+  4256, 4256, 4256, 4256, 3744, 4768, 4768, 4768, 4768, 11936, 0, 0, 3744, 3744, 4256, 4256,
+  0, 0, 0, 0, 0, 4256, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 3744, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4768, 4768, 4768, 4256, 3744, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 7168, 7168, 7168, 7168, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 8192, 7168, 7168, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 8192, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 0, 0, 0, 0, 8192, 8192, 8192, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 12448, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 8192, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  8192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 0,
+  8192, 8192, 8192, 8192, 8192, 8192, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 0, 8192, 0, 8192, 0, 0, 0, 0, 0, 0, 8192, 0, 0,
+  0, 8192, 0, 0, 0, 0, 0, 0, 8192, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 8192, 8192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 8192, 0, 0, 8192, 0, 0, 0, 0, 8192, 0, 8192, 0,
+  0, 0, 0, 8192, 8192, 8192, 0, 8192, 0, 0, 0, 7168, 7168, 7168, 7168, 7168,
+  7168, 0, 0, 8192, 8192, 8192, 8192, 8192, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168,
+  7168, 7168, 7168, 7168, 7168, 7168, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 8192, 8192, 8192, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 8192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  8192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192,
+  0, 0, 0, 0, 0, 7168, 7168, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 8192, 8192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168,
+  7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 7168, 7168, 7168, 7168, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7168, 7168, 0, 0,
+  0, 0, 0, 0, 0, 8192, 8192, 8192, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  8192, 0, 0, 0, 0, 8192, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4256, 3744, 4256, 4256, 4256, 3744, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 4256, 4256,
+  4256, 3744, 4256, 3744, 3744, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 3744, 0, 0, 0, 0, 0, 0, 4256, 3744, 4256, 3744, 1604,
+  1604, 1604, 4256, 3744, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 0, 3744, 0, 0, 0, 0, 0, 3744, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7168, 7168, 0, 0,
+  7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 0, 0, 0, 0, 6656, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6656, 0, 0, 0,
+  0, 0, 7168, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 6656, 6656, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3360, 6144, 6656, 0, 0, 4768, 4608, 4608, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168,
+  7168, 7168, 0, 0, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 0, 7168, 7168, 7168,
+  0, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 1604, 1604, 1604, 1604, 1604, 1604,
+  8192, 4736, 4736, 4736, 4736, 4736, 0, 0, 4608, 4608, 4608, 4768, 4768, 8192, 0, 0,
+  0, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 1604, 1604, 128, 128, 4608, 4608, 4608,
+  128, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 0, 4736, 4736, 4736, 4736,
+  0, 0, 0, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 8192, 0, 8192, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 0,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+  128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+  128, 128, 128, 128, 128, 128, 128, 128, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 6656,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 6656, 6656,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4768, 4768, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4768, 1604,
+  1604, 1604, 1604, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 4768,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 3744, 3744, 1604, 1604,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  1604, 1604, 0, 6656, 0, 0, 0, 6656, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 160, 160, 160, 160, 160, 160, 160, 160,
+  160, 160, 160, 160, 160, 160, 160, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  160, 160, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  3744, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 3744, 4256, 3744, 4256, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4768, 160, 160, 4256, 3744, 4256, 3744, 4768,
+  4256, 3744, 4256, 3744, 3744, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 4256, 4256, 4256, 4256, 3744,
+  4256, 4256, 4256, 4256, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744, 4256, 3744,
+  4256, 3744, 4256, 3744, 4256, 4256, 4256, 4256, 3744, 4256, 3744, 0, 0, 0, 0, 0,
+  4256, 3744, 0, 3744, 0, 3744, 4256, 3744, 4256, 3744, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 3744, 3744, 3744, 4256, 3744, 4768, 3744, 3744, 3744, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 1604, 4768, 4768, 4768, 1604, 4768, 4768, 4768, 4768, 1604, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 1608, 1608, 1604, 1604, 1608, 0, 0, 0, 0, 1604, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 0, 0, 6656, 6656, 0, 0, 0, 0, 0, 0, 0, 0,
+  1608, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608,
+  1608, 1608, 1608, 1608, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 6656, 6656,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 4768, 0, 4768, 4768, 1604,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 6656,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1608, 1608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777,
+  4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 4777, 0, 0, 0,
+  1604, 1604, 1604, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 1604, 1608, 1608, 1604, 1604, 1604, 1604, 1608, 1608, 1604, 1604, 1608, 1608,
+  1608, 0, 0, 0, 0, 0, 0, 0, 6656, 6656, 0, 0, 0, 0, 0, 4768,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 1604, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4608, 4608, 4608, 4608, 4608, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1608,
+  1608, 1604, 1604, 1608, 1608, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1608, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 6656, 6656, 6656,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 4608, 1600, 1604, 1600, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  1604, 4608, 1604, 1604, 1604, 4608, 4608, 1604, 1604, 4608, 4608, 4608, 4608, 4608, 1604, 1604,
+  4608, 1604, 4608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4608, 4608, 4608, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1608, 1604, 1604, 1608, 1608,
+  6656, 6656, 4768, 4768, 4768, 1608, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  0, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 160, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 1608, 1608, 1604, 1608, 1608, 1604, 1608, 1608, 6656, 1608, 1604, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4780, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781, 4781,
+  4781, 4781, 4781, 4781, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778, 4778,
+  4778, 4778, 4778, 4778, 4778, 4778, 4778, 0, 0, 0, 0, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779,
+  4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 4779, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 0, 4752, 1604, 4752,
+  4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 0, 4752, 4752, 4752, 4752, 4752, 4752,
+  4752, 4752, 4752, 4752, 4752, 4752, 4752, 0, 4752, 4752, 4752, 4752, 4752, 0, 4752, 0,
+  4752, 4752, 0, 4752, 4752, 0, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752, 4752,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 7168, 7168,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  6384, 6144, 0, 6368, 240, 0, 0, 7168, 7168, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  0, 6144, 6144, 272, 272, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168, 7168,
+  7168, 7168, 7168, 7168, 7168, 0, 0, 7168, 7168, 0, 0, 0, 0, 272, 272, 272,
+  6384, 6144, 5840, 0, 240, 6368, 6656, 6656, 6144, 7168, 7168, 7168, 7168, 7168, 7168, 0,
+  0, 0, 0, 6144, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 2675,
+  0, 6656, 0, 0, 0, 0, 0, 208, 7168, 7168, 0, 0, 6384, 6144, 5840, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 6368, 240, 0, 0, 0, 6656,
+  0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 7168, 0, 7168, 0, 272,
+  0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 7168, 0, 7168, 0, 7168,
+  7168, 6656, 7168, 7168, 6144, 0, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736,
+  4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 1604, 1604,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 2675, 2675, 2675, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 0, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 0, 0, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 0, 0, 0, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 0, 4256, 4256, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 3744, 3744, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3744, 4768, 4768, 3744, 3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 0, 0, 0, 4768, 0, 0, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 0, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 4768, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 1604, 1604, 1604, 0, 1604, 1604, 0, 0, 0, 0, 0, 1604, 1604, 1604, 1604,
+  4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 1604, 1604, 1604, 0, 0, 0, 0, 1604,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 6656, 6656, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 1604, 1604, 0, 0, 0,
+  4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604, 1604, 1604,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 4768, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 0, 0, 0, 0, 6656, 6656, 6656, 6656, 6656, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 1604, 1604, 1604, 1604, 6656, 6656, 6656, 6656, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1608, 1604, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 6656, 6656, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  1604, 4768, 4768, 1604, 1604, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604,
+  1604, 1604, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  1608, 1608, 1608, 1604, 1604, 1604, 1604, 1608, 1608, 1604, 1604, 0, 0, 2679, 6656, 6656,
+  6656, 6656, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2679, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1608, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 0, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  0, 6656, 6656, 6656, 4768, 1608, 1608, 4768, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 1604, 0, 0, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 1608, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608,
+  1608, 4768, 4775, 4775, 4768, 6656, 6656, 0, 0, 1604, 1604, 1604, 1604, 6656, 1608, 1604,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 4768, 0, 4768, 0, 6656, 6656,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1608, 1608, 1608, 1604,
+  1604, 1604, 1608, 1608, 1604, 1608, 1604, 1604, 6656, 6656, 0, 6656, 6656, 0, 1604, 4768,
+  4768, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 0, 4768, 4768, 4768, 4768, 0, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 6656, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604,
+  1608, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1608, 1608, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768,
+  4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 0, 1604, 1604, 4768, 1604, 1608,
+  1604, 1608, 1608, 1608, 1608, 0, 0, 1608, 1608, 0, 0, 1608, 1608, 1608, 0, 0,
+  4768, 0, 0, 0, 0, 0, 0, 1604, 0, 0, 0, 0, 0, 4768, 4768, 4768,
+  4768, 4768, 1608, 1608, 0, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 1608, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1608, 1608, 1604, 1604, 1604, 1608, 1604, 4768, 4768, 4768, 4768, 6656, 6656, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 1604, 4768,
+  4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  1604, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1604, 1608, 1608, 1604, 1608, 1604,
+  1604, 1608, 1604, 1604, 4768, 4768, 0, 4768, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604,
+  1608, 1608, 1604, 1604, 1604, 1604, 0, 0, 1608, 1608, 1608, 1608, 1604, 1604, 1608, 1604,
+  1604, 0, 6656, 6656, 0, 0, 0, 0, 0, 6656, 6656, 6656, 6656, 6656, 6656, 6656,
+  6656, 6656, 6656, 6656, 6656, 6656, 6656, 6656, 4768, 4768, 4768, 4768, 1604, 1604, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  1608, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1608, 1604, 1608, 1604,
+  1604, 6656, 6656, 0, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1608, 1604, 1608, 1608,
+  1604, 1604, 1604, 1604, 1604, 1604, 1608, 1604, 4768, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 1604, 1604, 1604,
+  1600, 1600, 1604, 1604, 1604, 1604, 1608, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 6656, 6656, 6656, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1608, 1608, 1608, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1604, 1604, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768, 0, 0, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 0, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  1604, 1608, 1608, 1608, 1608, 1608, 0, 1608, 1608, 0, 0, 1604, 1604, 1608, 1604, 4775,
+  1608, 4775, 1608, 1604, 6656, 0, 6656, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 1608, 1608, 1608, 1604, 1604, 1604, 1604, 0, 0, 1604, 1604, 1608, 1608, 1608, 1608,
+  1604, 4768, 0, 4768, 1608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 4775, 1604, 1604, 1604, 1604, 0,
+  0, 0, 6656, 6656, 0, 0, 0, 1604, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1608, 1604, 1604, 1604, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4775, 4775, 4775, 4775, 4775, 4775, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1604, 1604, 0, 6656, 6656, 4768, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1608,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1608, 1604,
+  4768, 6656, 6656, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 1608, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1608, 1604, 1604, 1608, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 1604, 0, 1604, 1604, 0, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 4775, 1604, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1608, 1608, 1608, 1608, 1608, 0,
+  1604, 1604, 0, 1608, 1608, 1604, 1608, 1604, 4768, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 1604, 1604, 1608, 1608, 6656, 6656, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 4775, 1608, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 1608, 1608, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 1608, 1608,
+  1604, 1608, 1604, 6656, 6656, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675,
+  1604, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 6656, 6656,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 6656, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 6656, 6656, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 6656, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 6656, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 1604,
+  4768, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608,
+  1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608,
+  1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608,
+  1608, 1608, 1608, 1608, 1608, 1608, 1608, 1608, 0, 0, 0, 0, 0, 0, 0, 1604,
+  1604, 1604, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 0, 4768, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1608, 1608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4736, 4736, 4736, 4736, 0, 4736, 4736, 4736, 4736, 4736, 4736, 4736, 0, 4736, 4736, 0,
+  4736, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4736, 4736, 4736, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 4608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 0, 0, 4736, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 4736, 4736, 4736, 4736, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 1604, 1604, 6656,
+  2675, 2675, 2675, 2675, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 1604, 1608, 1604, 1604, 1604, 0, 0, 0, 1608, 1604, 1604,
+  1604, 1604, 1604, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 2675, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 0, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604, 1604, 1604, 1604, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 1604, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 0, 4256, 4256,
+  0, 0, 4256, 0, 0, 4256, 4256, 0, 0, 4256, 4256, 4256, 4256, 0, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 0, 3744, 0, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 4256, 4256, 0, 4256, 4256, 4256, 4256, 0, 0, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 0, 4256, 4256, 4256, 4256, 0,
+  4256, 4256, 4256, 4256, 4256, 0, 4256, 0, 0, 0, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 3744, 3744, 3744, 3744,
+  3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 0, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 0, 3744, 3744, 3744, 3744, 3744, 3744, 4256, 3744, 0, 0, 5376, 5376,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0,
+  0, 0, 0, 0, 0, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 1604, 0, 0, 0, 6656, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604, 1604, 1604, 1604, 1604,
+  0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 4768, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0,
+  0, 0, 0, 0, 0, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 0, 1604, 1604, 0, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1604,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 4768, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 1604, 1604, 1604, 1604,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 0, 4768, 4768, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744, 3744,
+  3744, 3744, 3744, 3744, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 4768, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  0, 4768, 4768, 0, 4768, 0, 0, 4768, 0, 4768, 4768, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 0, 4768, 0, 4768, 0, 0, 0, 0,
+  0, 0, 4768, 0, 0, 0, 0, 4768, 0, 4768, 0, 4768, 0, 4768, 4768, 4768,
+  0, 4768, 4768, 0, 4768, 0, 0, 4768, 0, 4768, 0, 4768, 0, 4768, 0, 4768,
+  0, 4768, 4768, 0, 4768, 0, 0, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 0, 4768, 0,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0,
+  0, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768, 0, 4768, 4768, 4768, 4768, 4768,
+  4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 4768, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 0, 0, 0, 0, 0,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 0, 8192, 8192, 8192, 8192,
+  12448, 12448, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 12448, 12448,
+  4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 4256, 0, 0, 0, 0, 8192, 0,
+  0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102,
+  102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102,
+  0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192,
+  0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 0, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 68, 68, 68, 68, 68,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 0, 0,
+  0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 7168, 7168, 7168, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 0, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 0, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 5376, 0, 0, 0, 0, 0, 0,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+  8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 0, 0, 0, 0, 0,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608, 4608,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  3, 2675, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604, 1604,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+};
+
+const _EUnicodeTable _unicode_break_table = { _unicode_break_table_stage1, 7200, _unicode_break_table_stage2 };
@@ -0,0 +1,253 @@
+#pragma once
+#define EString_EStringView_h_
+
+#include <stddef.h>
+
+#include <compare>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "EStringEncodings.h"
+#include "EStringSearch.h"
+
+// Non-owning view of utf32 characters: pointer and length.
+// Doesn't require null-terminating character, so views of substrings don't copy anything.
+// Viewed characters must outlive the view.
+class EStringView {
+public:
+  using size_type = size_t;
+
+  // Returned by search functions when nothing is found.
+  // Also means "until the end" when passed as count.
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+public:
+  constexpr EStringView() = default;
+
+  constexpr EStringView(const char32_t* string, size_type string_length_in_chars) noexcept
+    : m_data(string), m_length(string_length_in_chars) {}
+
+  constexpr EStringView(const char32_t* string) noexcept
+    : m_data(string), m_length(Utf32EncodingTraits::str_length(string)) {}
+
+public:
+  template <typename CharType>
+  constexpr std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>> encode() const {
+    using encoding_traits = EncodingTraits<CharType>;
+    using string_type = std::basic_string<CharType, std::char_traits<CharType>, std::allocator<CharType>>;
+
+    string_type encoded_string;
+    encoded_string.resize(_encoded_length<CharType>(m_data, m_length));
+
+    encoding_traits::from_utf32(m_data, m_length, encoded_string.data());
+
+    return encoded_string;
+  }
+
+  // Get number of 'CharType' that 'encode()' would produce.
+  template <typename CharType>
+  constexpr size_type encoded_size() const {
+    return _encoded_length<CharType>(m_data, m_length);
+  }
+
+  // Encode characters starting at 'index' to caller-provided buffer, without allocating.
+  // If buffer is too small, only whole characters that fit are written, and encoding can be continued
+  //  from 'index + progress.read' into next buffer.
+  template <typename CharType>
+  constexpr ECodingProgress encode_into(std::span<CharType> dest, size_type index = 0) const {
+    if (index > m_length)
+      index = m_length;
+
+    return _encode_into(m_data + index, m_length - index, dest.data(), dest.size());
+  }
+
+public:
+  constexpr const char32_t* data() const noexcept {
+    return m_data;
+  }
+
+  constexpr const char32_t* begin() const noexcept {
+    return m_data;
+  }
+
+  constexpr const char32_t* end() const noexcept {
+    return m_data + m_length;
+  }
+
+  constexpr char32_t front() const noexcept {
+    return m_data[0];
+  }
+
+  constexpr char32_t back() const noexcept {
+    return m_data[m_length - 1];
+  }
+
+  constexpr bool is_empty() const noexcept {
+    return m_length == 0;
+  }
+
+  constexpr size_type length() const noexcept {
+    return m_length;
+  }
+
+  constexpr size_type size() const noexcept {
+    return m_length;
+  }
+
+  constexpr char32_t operator[](size_type index) const noexcept {
+    return m_data[index];
+  }
+
+  // Get view of 'count' characters starting at 'index'.
+  // Range is clamped to the end of this view.
+  constexpr EStringView substr(size_type index, size_type count = npos) const noexcept {
+    if (index > m_length)
+      index = m_length;
+
+    if (count > m_length - index)
+      count = m_length - index;
+
+    return EStringView(m_data + index, count);
+  }
+
+  constexpr void remove_prefix(size_type count) noexcept {
+    if (count > m_length)
+      count = m_length;
+
+    m_data += count;
+    m_length -= count;
+  }
+
+  constexpr void remove_suffix(size_type count) noexcept {
+    if (count > m_length)
+      count = m_length;
+
+    m_length -= count;
+  }
+
+  constexpr bool startswith(EStringView string) const noexcept {
+    return string.m_length <= m_length && _is_substr_equal(0, string);
+  }
+
+  constexpr bool endswith(EStringView string) const noexcept {
+    return string.m_length <= m_length && _is_substr_equal(m_length - string.m_length, string);
+  }
+
+  constexpr bool contains(EStringView string) const noexcept {
+    return find(string) != npos;
+  }
+
+  constexpr bool contains(char32_t character) const noexcept {
+    return find(character) != npos;
+  }
+
+  // Get index of first occurrence of 'character' at or after 'index', or 'npos'.
+  constexpr size_type find(char32_t character, size_type index = 0) const noexcept {
+    return EStringSearcher(&character, 1).find(m_data, m_length, index);
+  }
+
+  // Get index of first occurrence of 'string' at or after 'index', or 'npos'.
+  constexpr size_type find(EStringView string, size_type index = 0) const noexcept {
+    return EStringSearcher(string.m_data, string.m_length).find(m_data, m_length, index);
+  }
+
+  // Get index of last occurrence of 'character' at or before 'index', or 'npos'.
+  constexpr size_type rfind(char32_t character, size_type index = npos) const noexcept {
+    return EStringSearcher(&character, 1).rfind(m_data, m_length, index);
+  }
+
+  // Get index of last occurrence of 'string' starting at or before 'index', or 'npos'.
+  constexpr size_type rfind(EStringView string, size_type index = npos) const noexcept {
+    return EStringSearcher(string.m_data, string.m_length).rfind(m_data, m_length, index);
+  }
+
+  // Get indices of all non-overlapping occurrences of 'string', from left to right.
+  // Empty string isn't searched.
+  std::vector<size_type> find_all(EStringView string) const {
+    std::vector<size_type> indices;
+
+    if (string.m_length == 0)
+      return indices;
+
+    EStringSearcher searcher(string.m_data, string.m_length);
+
+    for (size_type index = searcher.find(m_data, m_length); index != npos; index = searcher.find(m_data, m_length, index + string.m_length))
+      indices.push_back(index);
+
+    return indices;
+  }
+
+  // Count non-overlapping occurrences of 'string'. Empty string isn't searched.
+  constexpr size_type count(EStringView string) const noexcept {
+    if (string.m_length == 0)
+      return 0;
+
+    EStringSearcher searcher(string.m_data, string.m_length);
+    size_type count = 0;
+
+    for (size_type index = searcher.find(m_data, m_length); index != npos; index = searcher.find(m_data, m_length, index + string.m_length))
+      ++count;
+
+    return count;
+  }
+
+  constexpr size_type count(char32_t character) const noexcept {
+    return count(EStringView(&character, 1));
+  }
+
+public:
+  constexpr bool operator==(EStringView string) const noexcept {
+    return m_length == string.m_length && _mismatch(string.m_data, m_length) == m_length;
+  }
+
+  constexpr bool operator!=(EStringView string) const noexcept {
+    return !operator==(string);
+  }
+
+  // Order by code points, like 'std::u32string'. Shorter string is less than string it's prefix of.
+  constexpr std::strong_ordering operator<=>(EStringView string) const noexcept {
+    size_type common_length = m_length < string.m_length ? m_length : string.m_length;
+    size_type index = _mismatch(string.m_data, common_length);
+
+    if (index != common_length)
+      return m_data[index] <=> string.m_data[index];
+
+    return m_length <=> string.m_length;
+  }
+
+  // Returns negative number if this string is less than 'string', positive if it's greater, or 0 if they are equal.
+  constexpr int compare(EStringView string) const noexcept {
+    std::strong_ordering order = operator<=>(string);
+
+    return order < 0 ? -1 : order > 0 ? 1 : 0;
+  }
+
+private:
+  // Find first index where characters differ, comparing first 'length' characters.
+  constexpr size_type _mismatch(const char32_t* string, size_type length) const noexcept {
+    if (!std::is_constant_evaluated())
+      return _simd_utf32_mismatch(m_data, string, length);
+
+    size_type index = 0;
+
+    while (index < length && m_data[index] == string[index])
+      ++index;
+
+    return index;
+  }
+
+  constexpr bool _is_substr_equal(size_type index, EStringView string) const noexcept {
+    for (size_type string_index = 0; string_index < string.m_length; ++index, ++string_index) {
+      if (m_data[index] != string.m_data[string_index])
+        return false;
+    }
+    return true;
+  }
+
+private:
+  // First viewed character.
+  const char32_t* m_data = nullptr;
+  // Number of viewed characters.
+  size_type m_length = 0;
+};
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <new>
+#include <string>
+
+#include <EString.h>
+
+// Measures heap allocations and time per operation for short-string workloads.
+
+static size_t g_allocations_count = 0;
+
+void* operator new(size_t size) {
+  ++g_allocations_count;
+
+  if (void* pointer = malloc(size ? size : 1))
+    return pointer;
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  free(pointer);
+}
+
+static volatile size_t g_sink = 0;
+
+template <typename Function>
+static void run_benchmark(const char* name, Function function) {
+  constexpr size_t iterations = 1000000;
+
+  size_t allocations_before = g_allocations_count;
+  auto time_before = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < iterations; ++i)
+    g_sink = g_sink + function();
+
+  auto time_after = std::chrono::steady_clock::now();
+  size_t allocations = g_allocations_count - allocations_before;
+  double nanoseconds = std::chrono::duration<double, std::nano>(time_after - time_before).count();
+
+  printf(
+    "%-40s %8.2f allocs/op %10.2f ns/op\n",
+    name,
+    static_cast<double>(allocations) / iterations,
+    nanoseconds / iterations
+  );
+}
+
+int main() {
+  EString short_string = U"token";
+  EString long_string = U"a string that is way longer than inline capacity";
+  std::u32string long_std_string = long_string.encode<char32_t>();
+  std::u32string short_std_string = short_string.encode<char32_t>();
+
+  run_benchmark("EString construct short (ASCII)", [] {
+    EString string = "token";
+    return string.length();
+  });
+
+  run_benchmark("EString construct short (UTF-8)", [] {
+    EString string = u8"ключ";
+    return string.length();
+  });
+
+  run_benchmark("EString copy short", [&] {
+    EString string = short_string;
+    return string.length();
+  });
+
+  run_benchmark("EString push_back 7 characters", [] {
+    EString string;
+
+    for (char32_t character = U'a'; character < U'h'; ++character)
+      string.push_back(character);
+
+    return string.length();
+  });
+
+  run_benchmark("EString copy long", [&] {
+    EString string = long_string;
+    return string.length();
+  });
+
+  run_benchmark("EString concatenate 12 fragments", [&] {
+    EString string = long_string + U", " + short_string + U": " + long_string + u8" — " + short_string
+      + U" / " + long_string + U"; " + short_string + U".";
+    return string.length();
+  });
+
+  run_benchmark("std::u32string construct short", [] {
+    std::u32string string = U"token";
+    return string.length();
+  });
+
+  run_benchmark("std::u32string copy long", [&] {
+    std::u32string string = long_std_string;
+    return string.length();
+  });
+
+  run_benchmark("std::u32string concatenate 12 fragments", [&] {
+    std::u32string string = long_std_string + U", " + short_std_string + U": " + long_std_string + U" — " + short_std_string
+      + U" / " + long_std_string + U"; " + short_std_string + U".";
+    return string.length();
+  });
+
+  return 0;
+}
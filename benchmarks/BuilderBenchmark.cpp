@@ -0,0 +1,54 @@
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+
+#include <EStringBuilder.h>
+
+// Compares assembling large UTF-8 report with EString appends and with EStringBuilder.
+
+template <typename Function>
+static double measure(Function function) {
+  auto time_before = std::chrono::steady_clock::now();
+
+  function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(time_after - time_before).count();
+}
+
+int main() {
+  constexpr int lines_count = 200000;
+
+  size_t estring_size = 0, builder_size = 0;
+
+  double estring_time = measure([&] {
+    EString report;
+
+    for (int line = 0; line < lines_count; ++line) {
+      report.append(u8"Строка отчёта, значение: ");
+      report.append(U"0123456789");
+      report.append(U'\n');
+    }
+
+    estring_size = report.encode<char8_t>().size();
+  });
+
+  double builder_time = measure([&] {
+    EStringBuilder report;
+
+    for (int line = 0; line < lines_count; ++line) {
+      report.append(u8"Строка отчёта, значение: ");
+      report.append(U"0123456789");
+      report.append(U'\n');
+    }
+
+    builder_size = report.encode<char8_t>().size();
+  });
+
+  printf("%-32s %10.2f ms\n", "EString append + encode", estring_time);
+  printf("%-32s %10.2f ms\n", "EStringBuilder append + encode", builder_time);
+
+  return estring_size == builder_size ? 0 : 1;
+}
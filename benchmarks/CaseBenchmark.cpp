@@ -0,0 +1,79 @@
+#include <locale.h>
+#include <stdio.h>
+#include <wctype.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+
+#include <EString.h>
+
+// Compares EString::to_lower with towlower applied to every character of std::wstring.
+
+static volatile size_t g_sink = 0;
+
+template <typename Function>
+static double measure(Function function) {
+  constexpr size_t iterations = 20;
+
+  auto time_before = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < iterations; ++i)
+    g_sink = g_sink + function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(time_after - time_before).count() / iterations;
+}
+
+int main() {
+  setlocale(LC_ALL, "C.UTF-8");
+
+  constexpr size_t text_length = 4 * 1024 * 1024;
+
+  const char32_t* alphabets[] = {
+    U"The Quick Brown Fox Jumps Over The Lazy Dog ",
+    U"Съешь Же Ещё Этих Мягких Французских Булок ",
+  };
+
+  printf("%-12s %14s %14s\n", "text", "EString ms", "towlower ms");
+
+  for (size_t alphabet_index = 0; alphabet_index < 2; ++alphabet_index) {
+    std::u32string alphabet = alphabets[alphabet_index];
+
+    std::mt19937 random(42);
+    std::u32string text;
+    text.reserve(text_length);
+
+    // Words of alphabet in random order.
+    while (text.length() < text_length) {
+      size_t word_begin = random() % alphabet.length();
+      size_t word_end = alphabet.find(U' ', word_begin);
+
+      text.append(alphabet, word_begin, word_end - word_begin + 1);
+    }
+
+    EString string = text.c_str();
+    std::wstring wide_text(text.begin(), text.end());
+
+    double estring_time = measure([&] {
+      EString lowered = string;
+      lowered.to_lower();
+
+      return lowered.length();
+    });
+
+    double towlower_time = measure([&] {
+      std::wstring lowered = wide_text;
+
+      for (wchar_t& character : lowered)
+        character = static_cast<wchar_t>(towlower(static_cast<wint_t>(character)));
+
+      return lowered.length();
+    });
+
+    printf("%-12s %14.3f %14.3f\n", alphabet_index == 0 ? "latin" : "cyrillic", estring_time, towlower_time);
+  }
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+
+#include <EString.h>
+
+// Measures quick check of already normalized text and normalization of decomposed text.
+
+static volatile size_t g_sink = 0;
+
+template <typename Function>
+static double measure(Function function) {
+  constexpr size_t iterations = 20;
+
+  auto time_before = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < iterations; ++i)
+    g_sink = g_sink + function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(time_after - time_before).count() / iterations;
+}
+
+int main() {
+  constexpr size_t text_length = 4 * 1024 * 1024;
+
+  const char32_t* alphabets[] = {
+    U"user name example ",
+    U"Zoë Åström Müller Dvořák ",
+    U"Съешь же ещё этих мягких французских булок ",
+  };
+
+  const char* alphabet_names[] = { "ascii", "latin", "cyrillic" };
+
+  printf("%-12s %18s %18s %18s\n", "text", "is_normalized ms", "normalize NFC ms", "NFD -> NFC ms");
+
+  for (size_t alphabet_index = 0; alphabet_index < 3; ++alphabet_index) {
+    std::u32string alphabet = alphabets[alphabet_index];
+
+    std::u32string text;
+    text.reserve(text_length);
+
+    while (text.length() < text_length)
+      text += alphabet;
+
+    EString string = text.c_str();
+    EString decomposed_string = string.normalized(ENormalizationForm::nfd);
+
+    double check_time = measure([&] {
+      return static_cast<size_t>(string.is_normalized());
+    });
+
+    double normalize_time = measure([&] {
+      return string.normalized().length();
+    });
+
+    double decomposed_time = measure([&] {
+      return decomposed_string.normalized().length();
+    });
+
+    printf("%-12s %18.3f %18.3f %18.3f\n", alphabet_names[alphabet_index], check_time, normalize_time, decomposed_time);
+  }
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+#include <stdio.h>
+
+#include <chrono>
+#include <random>
+
+#include <EStringRope.h>
+
+// Compares single-character edits in the middle of large document in EString and ERope.
+
+template <typename Function>
+static double measure(Function function) {
+  auto time_before = std::chrono::steady_clock::now();
+
+  function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::micro>(time_after - time_before).count();
+}
+
+int main() {
+  constexpr size_t document_length = 8 * 1024 * 1024;
+  constexpr size_t edits_count = 1000;
+
+  EString document;
+  document.reserve(document_length + edits_count + 1);
+
+  for (size_t index = 0; index < document_length; ++index)
+    document.push_back(static_cast<char32_t>(U'a' + index % 26));
+
+  ERope rope = document;
+
+  std::mt19937 random(7);
+  size_t positions[edits_count];
+
+  for (size_t& position : positions)
+    position = random() % document_length;
+
+  double estring_time = measure([&] {
+    for (size_t position : positions)
+      document.insert(position, U'x');
+  });
+
+  double rope_time = measure([&] {
+    for (size_t position : positions)
+      rope.insert(position, U'x');
+  });
+
+  printf("%-32s %12.2f us/edit\n", "EString insert", estring_time / edits_count);
+  printf("%-32s %12.2f us/edit\n", "ERope insert", rope_time / edits_count);
+
+  return document.length() == rope.length() ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <stdio.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+
+#include <EString.h>
+
+// Compares EString substring search with std::u32string::find on multi-megabyte inputs.
+
+static volatile size_t g_sink = 0;
+
+template <typename Function>
+static double measure(Function function) {
+  constexpr size_t iterations = 20;
+
+  auto time_before = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < iterations; ++i)
+    g_sink = g_sink + function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(time_after - time_before).count() / iterations;
+}
+
+int main() {
+  constexpr size_t haystack_length = 4 * 1024 * 1024;
+
+  // Text-like haystack of latin and cyrillic letters and spaces. Needle is placed only at the end.
+  const char32_t alphabet[] = U"etaoinshrdlu    абвгдежзиклмнопр";
+  constexpr size_t alphabet_size = sizeof(alphabet) / sizeof(char32_t) - 1;
+
+  std::mt19937 random(42);
+  std::u32string haystack;
+  haystack.reserve(haystack_length);
+
+  for (size_t index = 0; index < haystack_length; ++index)
+    haystack.push_back(alphabet[random() % alphabet_size]);
+
+  EString string = haystack.c_str();
+
+  const size_t needle_lengths[] = { 1, 4, 12, 40, 200 };
+
+  printf("%-12s %14s %14s\n", "needle", "EString ms", "u32string ms");
+
+  for (size_t needle_length : needle_lengths) {
+    std::u32string needle;
+
+    for (size_t index = 0; index < needle_length; ++index)
+      needle.push_back(U'x' + static_cast<char32_t>(index % 3));
+
+    // Place needle at the end, so whole haystack is scanned.
+    std::u32string placed_haystack = haystack;
+    placed_haystack.replace(haystack_length - needle_length, needle_length, needle);
+
+    EString placed_string = placed_haystack.c_str();
+    EStringView needle_view(needle.data(), needle.length());
+
+    double estring_time = measure([&] {
+      return placed_string.find(needle_view);
+    });
+
+    double std_time = measure([&] {
+      return placed_haystack.find(needle);
+    });
+
+    printf("%-12zu %14.3f %14.3f\n", needle_length, estring_time, std_time);
+  }
+
+  return 0;
+}
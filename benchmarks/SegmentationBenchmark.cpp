@@ -0,0 +1,84 @@
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <EString.h>
+#include <EStringSegmentation.h>
+
+// Measures counting of graphemes, words and sentences with lazy iterators,
+//  compared to splitting text to vector of substrings by spaces.
+
+static volatile size_t g_sink = 0;
+
+template <typename Function>
+static double measure(Function function) {
+  constexpr size_t iterations = 10;
+
+  auto time_before = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < iterations; ++i)
+    g_sink = g_sink + function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(time_after - time_before).count() / iterations;
+}
+
+int main() {
+  constexpr size_t text_length = 4 * 1024 * 1024;
+
+  const char32_t* alphabets[] = {
+    U"The quick brown fox jumps over the lazy dog. It's 3.14, isn't it? ",
+    U"Съешь же ещё этих мягких французских булок, да выпей чаю. ",
+    U"Emoji \U0001F469\U0001F3FD\u200D\U0001F4BB and flags \U0001F1FA\U0001F1F8 with café. ",
+  };
+
+  const char* alphabet_names[] = { "ascii", "cyrillic", "emoji" };
+
+  printf("%-12s %14s %14s %14s %14s\n", "text", "graphemes ms", "words ms", "sentences ms", "split ms");
+
+  for (size_t alphabet_index = 0; alphabet_index < 3; ++alphabet_index) {
+    std::u32string alphabet = alphabets[alphabet_index];
+
+    std::u32string text;
+    text.reserve(text_length);
+
+    while (text.length() < text_length)
+      text += alphabet;
+
+    EString string = text.c_str();
+
+    double graphemes_time = measure([&] {
+      return egraphemes(string).count();
+    });
+
+    double words_time = measure([&] {
+      return ewords(string).count();
+    });
+
+    double sentences_time = measure([&] {
+      return esentences(string).count();
+    });
+
+    // Materializing substrings, the way words were counted before.
+    double split_time = measure([&] {
+      std::vector<EString> words;
+      size_t begin = 0;
+
+      for (size_t index = 0; index <= string.length(); ++index) {
+        if (index == string.length() || string[index] == U' ') {
+          words.push_back(EString(EStringView(string).substr(begin, index - begin)));
+          begin = index + 1;
+        }
+      }
+
+      return words.size();
+    });
+
+    printf("%-12s %14.3f %14.3f %14.3f %14.3f\n", alphabet_names[alphabet_index], graphemes_time, words_time, sentences_time, split_time);
+  }
+
+  return 0;
+}
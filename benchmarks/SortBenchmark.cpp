@@ -0,0 +1,72 @@
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <EStringSort.h>
+
+// Compares esort with std::sort of EString by operator<, on keys that share long prefixes.
+
+template <typename Function>
+static double measure(Function function) {
+  auto time_before = std::chrono::steady_clock::now();
+
+  function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(time_after - time_before).count();
+}
+
+int main() {
+  constexpr size_t keys_count = 2 * 1000 * 1000;
+
+  // Keys look like paths of storage, e.g. "/data/table_17/part_0042/ключ_8f3a".
+  const char32_t alphabet[] = U"0123456789abcdefключ";
+  constexpr size_t alphabet_size = sizeof(alphabet) / sizeof(char32_t) - 1;
+
+  std::mt19937 random(42);
+  std::vector<EString> keys;
+  keys.reserve(keys_count);
+
+  for (size_t index = 0; index < keys_count; ++index) {
+    std::u32string key = U"/data/table_";
+    key += alphabet[random() % 10];
+    key += U"/part_";
+
+    for (size_t character_index = 0; character_index < 4; ++character_index)
+      key += alphabet[random() % 10];
+
+    key += U'/';
+
+    for (size_t character_index = 0; character_index < 12; ++character_index)
+      key += alphabet[random() % alphabet_size];
+
+    keys.push_back(EString(key.c_str()));
+  }
+
+  printf("%-12s %14s %14s\n", "keys", "esort ms", "std::sort ms");
+
+  for (size_t count : { keys_count / 100, keys_count / 10, keys_count }) {
+    std::vector<EString> radix_keys(keys.begin(), keys.begin() + count);
+    std::vector<EString> comparison_keys = radix_keys;
+
+    double esort_time = measure([&] {
+      esort(radix_keys);
+    });
+
+    double std_time = measure([&] {
+      std::sort(comparison_keys.begin(), comparison_keys.end());
+    });
+
+    if (radix_keys != comparison_keys)
+      printf("results differ\n");
+
+    printf("%-12zu %14.3f %14.3f\n", count, esort_time, std_time);
+  }
+
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+
+#include <EString.h>
+
+// Compares UTF-8 <-> UTF-16 conversion through EString with direct transcoding.
+
+template <typename Function>
+static double measure(Function function) {
+  auto time_before = std::chrono::steady_clock::now();
+
+  function();
+
+  auto time_after = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(time_after - time_before).count();
+}
+
+int main() {
+  constexpr int repeats_count = 200;
+
+  std::u8string utf8_text;
+
+  for (int line = 0; line < 2000; ++line)
+    utf8_text += u8"GET /api/v1/items?id=42 HTTP/1.1 — Привет, 世界 \U0001F600\n";
+
+  std::u16string utf16_text = EString(utf8_text).encode<char16_t>();
+
+  size_t checksum = 0;
+
+  double two_pass_to_utf16 = measure([&] {
+    for (int repeat = 0; repeat < repeats_count; ++repeat)
+      checksum += EString(utf8_text).encode<char16_t>().size();
+  });
+
+  double transcode_to_utf16 = measure([&] {
+    for (int repeat = 0; repeat < repeats_count; ++repeat)
+      checksum += transcode<char16_t>(utf8_text).size();
+  });
+
+  double two_pass_to_utf8 = measure([&] {
+    for (int repeat = 0; repeat < repeats_count; ++repeat)
+      checksum += EString(utf16_text).encode<char8_t>().size();
+  });
+
+  double transcode_to_utf8 = measure([&] {
+    for (int repeat = 0; repeat < repeats_count; ++repeat)
+      checksum += transcode<char8_t>(utf16_text).size();
+  });
+
+  printf("%-32s %10.2f ms\n", "UTF-8 -> EString -> UTF-16", two_pass_to_utf16);
+  printf("%-32s %10.2f ms\n", "transcode UTF-8 -> UTF-16", transcode_to_utf16);
+  printf("%-32s %10.2f ms\n", "UTF-16 -> EString -> UTF-8", two_pass_to_utf8);
+  printf("%-32s %10.2f ms\n", "transcode UTF-16 -> UTF-8", transcode_to_utf8);
+
+  return checksum != 0 ? 0 : 1;
+}
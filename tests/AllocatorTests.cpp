@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+
+#include <EString.h>
+
+namespace AllocatorTests {
+
+  // Memory resource that counts allocations and forwards them to upstream resource.
+  class CountingResource : public std::pmr::memory_resource {
+  public:
+    size_t allocations_count = 0;
+    size_t deallocations_count = 0;
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+      ++allocations_count;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+      ++deallocations_count;
+      std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  };
+
+  TEST(AllocatorTests, AllocatesFromMemoryResource) {
+    CountingResource resource;
+
+    {
+      PmrEString string(U"Long enough string to leave inline buffer", &resource);
+
+      string.append(U", and then some more characters");
+
+      EXPECT_EQ(string.get_allocator().resource(), &resource);
+      EXPECT_TRUE(string == U"Long enough string to leave inline buffer, and then some more characters");
+    }
+
+    EXPECT_EQ(resource.allocations_count, 2);
+    EXPECT_EQ(resource.deallocations_count, 2);
+  }
+
+  TEST(AllocatorTests, ShortStringsDontTouchResource) {
+    CountingResource resource;
+    PmrEString string(U"key", &resource);
+
+    EXPECT_EQ(resource.allocations_count, 0);
+  }
+
+  TEST(AllocatorTests, MonotonicBuffer) {
+    char32_t memory[256];
+    std::pmr::monotonic_buffer_resource resource(memory, sizeof(memory), std::pmr::null_memory_resource());
+
+    PmrEString string(u8"Привет, мир! Decoded straight into the arena.", &resource);
+
+    EXPECT_TRUE(string.data() >= memory && string.data() < memory + 256);
+    EXPECT_TRUE(string.startswith(U"Привет"));
+  }
+
+  TEST(AllocatorTests, MoveBetweenResources) {
+    CountingResource first_resource;
+    CountingResource second_resource;
+
+    PmrEString first(U"Long enough string to leave inline buffer", &first_resource);
+    PmrEString second(U"Another string that lives on the heap", &second_resource);
+
+    second = std::move(first);
+
+    // Resources are different, so buffer is copied instead of stolen.
+    EXPECT_EQ(second.get_allocator().resource(), &second_resource);
+    EXPECT_TRUE(second == U"Long enough string to leave inline buffer");
+  }
+
+}
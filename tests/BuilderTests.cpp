@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <EStringBuilder.h>
+
+namespace BuilderTests {
+
+  TEST(BuilderTests, AppendAndBuild) {
+    EStringBuilder builder;
+    EString name = U"мир";
+
+    builder.append(U"Привет, ").append(name).append(U'!');
+    builder += u8" \U0001F600";
+
+    EString string = builder.to_estring();
+
+    EXPECT_EQ(builder.length(), 14);
+    EXPECT_TRUE(string == U"Привет, мир! \U0001F600");
+    EXPECT_EQ(string.capacity(), string.length() + 1);
+  }
+
+  TEST(BuilderTests, SplitBetweenChunks) {
+    // Tiny chunks make most strings and encoded characters cross chunk boundaries.
+    EStringBuilder builder(3);
+    EString expected_result;
+
+    for (int index = 0; index < 100; ++index) {
+      builder.append(u8"ab\U0001F600в");
+      builder.append(u"\U0001F361x");
+      builder.append(U"long utf32 string");
+
+      expected_result.append(U"ab\U0001F600в\U0001F361xlong utf32 string");
+    }
+
+    EXPECT_EQ(builder.length(), expected_result.length());
+    EXPECT_TRUE(builder.to_estring() == expected_result);
+  }
+
+  TEST(BuilderTests, EncodeWithoutEString) {
+    EStringBuilder builder(16);
+    std::u8string expected_result;
+
+    for (int index = 0; index < 50; ++index) {
+      builder.append(u8"строка ");
+      builder.append(std::to_string(index).c_str());
+      builder.append(U'\n');
+
+      expected_result += u8"строка ";
+      for (char character : std::to_string(index))
+        expected_result += static_cast<char8_t>(character);
+      expected_result += u8'\n';
+    }
+
+    EXPECT_TRUE(builder.encode<char8_t>() == expected_result);
+    EXPECT_EQ(builder.encode<char16_t>(), builder.to_estring().encode<char16_t>());
+  }
+
+  TEST(BuilderTests, Clear) {
+    EStringBuilder builder;
+    builder.append(U"text");
+    builder.clear();
+
+    EXPECT_TRUE(builder.is_empty());
+    EXPECT_TRUE(builder.to_estring().is_empty());
+  }
+
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <EString.h>
+
+namespace CaseTests {
+
+  TEST(CaseTests, AsciiConversion) {
+    // Longer than SIMD block, with non-ASCII character in the middle.
+    EString string = U"Hello, World! THE QUICK BROWN FOX jumps over the lazy dog 0123456789";
+
+    EXPECT_TRUE(string.lowered() == U"hello, world! the quick brown fox jumps over the lazy dog 0123456789");
+    EXPECT_TRUE(string.uppered() == U"HELLO, WORLD! THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789");
+
+    string.to_upper();
+
+    EXPECT_TRUE(string == U"HELLO, WORLD! THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789");
+  }
+
+  TEST(CaseTests, NonAsciiConversion) {
+    EString string = U"Привет, Мир! Ärger über Ölfässer, Ǆ ǅ ǆ, \U00010400\U00010428";
+
+    EXPECT_TRUE(string.lowered() == U"привет, мир! ärger über ölfässer, ǆ ǆ ǆ, \U00010428\U00010428");
+    EXPECT_TRUE(string.uppered() == U"ПРИВЕТ, МИР! ÄRGER ÜBER ÖLFÄSSER, Ǆ Ǆ Ǆ, \U00010400\U00010400");
+  }
+
+  TEST(CaseTests, Expansions) {
+    EString string = U"straße ﬁne";
+
+    string.to_upper();
+
+    EXPECT_TRUE(string == U"STRASSE FINE");
+    EXPECT_TRUE(EString(U"İstanbul").lowered() == U"i̇stanbul");
+    EXPECT_TRUE(EString(U"ŉ ǰ").uppered() == U"ʼN J̌");
+  }
+
+  TEST(CaseTests, ExpansionsGrowBufferOnce) {
+    std::u32string text;
+
+    for (int index = 0; index < 100; ++index)
+      text += U"aßﬃ";
+
+    EString string = text.c_str();
+    string.to_upper();
+
+    std::u32string expected_text;
+
+    for (int index = 0; index < 100; ++index)
+      expected_text += U"ASSFFI";
+
+    EXPECT_TRUE(string == expected_text.c_str());
+    EXPECT_EQ(string.capacity(), string.length() + 1);
+  }
+
+  TEST(CaseTests, FinalSigma) {
+    EXPECT_TRUE(EString(U"ΟΔΥΣΣΕΥΣ").lowered() == U"οδυσσευς");
+    EXPECT_TRUE(EString(U"ΣΑΣ ΣΑΣ.").lowered() == U"σας σας.");
+    // Not preceded by letter, or followed by one after case-ignorable characters.
+    EXPECT_TRUE(EString(U"Σ 'Σ' Α'Σ'Α").lowered() == U"σ 'σ' α'σ'α");
+    EXPECT_TRUE(EString(U"ΑΣ'").lowered() == U"ας'");
+    // Expansion before sigma converts the rest of string in other way.
+    EXPECT_TRUE(EString(U"İΣ ΑΣ").lowered() == U"i̇ς ας");
+  }
+
+  TEST(CaseTests, CaseFolding) {
+    EXPECT_TRUE(EString(U"Straße").casefolded() == EString(U"STRASSE").casefolded());
+    EXPECT_TRUE(EString(U"ΣΑΣ σας").casefolded() == U"σασ σασ");
+    EXPECT_TRUE(EString(U"ǅ ﬃ ß ẞ K").casefolded() == U"ǆ ffi ss ss k");
+  }
+
+  TEST(CaseTests, EmptyAndUnassigned) {
+    EString string;
+    string.to_lower();
+
+    EXPECT_TRUE(string.is_empty());
+
+    // Unassigned and invalid code points are kept.
+    EString invalid_string = U"\U000E0080A";
+    invalid_string.push_back(static_cast<char32_t>(0x7FFFFFFF));
+
+    invalid_string.to_lower();
+
+    EXPECT_EQ(invalid_string[0], U'\U000E0080');
+    EXPECT_EQ(invalid_string[1], U'a');
+    EXPECT_EQ(invalid_string[2], static_cast<char32_t>(0x7FFFFFFF));
+  }
+
+}
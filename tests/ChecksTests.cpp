@@ -60,6 +60,7 @@ namespace EndsWithTests {
     second = u8"рим!";
 
     EXPECT_FALSE(first.endswith(second));
+    EXPECT_FALSE(first.endswith(u8"Hello, Hello, мир!"));
   }
 
 }
@@ -83,6 +84,40 @@ namespace ContainsTests {
     EString string = U"Привет, мир!";
 
     EXPECT_TRUE(string.contains(u8"мир"));
+    EXPECT_FALSE(string.contains(u8"миру"));
+  }
+
+  TEST(ContainsTests, ContainsLongUtf8) {
+    // Substring is longer than stack buffer of 'contains()'.
+    EString string = U"Привет, мир! This is a long text, that contains a long substring, which is searched: Привет, мир!!!";
+
+    EXPECT_TRUE(string.contains(u8"This is a long text, that contains a long substring, which is searched: Привет"));
+    EXPECT_TRUE(string.contains(u8"Привет, мир!!!"));
+    EXPECT_FALSE(string.contains(u8"This is a long text, that contains a long substring, which is searched: Привет!"));
+    EXPECT_FALSE(string.contains(u8"Привет, мир! This is a long text, that contains a long substring, which is searched: Привет, мир!!!!"));
+  }
+
+  TEST(ContainsTests, InvalidStringsMatchNothing) {
+    // Overlong utf8 '/' must not be decoded to '/', wherever it is checked.
+    const char8_t short_needle[] = { u8'.', u8'.', 0xC0, 0xAF, 0 };
+    const char8_t long_needle[] = {
+      u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF,
+      u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF,
+      u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF,
+      u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF, u8'.', u8'.', 0xC0, 0xAF,
+      u8'.', u8'.', 0xC0, 0xAF, 0
+    };
+    const char16_t lone_surrogate[] = { u'a', 0xD800, 0 };
+
+    EString string = U"../../../../../../../../../../../../../../../../../etc/passwd";
+    EString surrogate_string = U"a\xD800";
+
+    EXPECT_FALSE(string.startswith(short_needle));
+    EXPECT_FALSE(EString(U"etc/..").endswith(short_needle));
+    EXPECT_FALSE(string.contains(short_needle));
+    EXPECT_FALSE(string.contains(long_needle));
+    EXPECT_FALSE(surrogate_string.startswith(lone_surrogate));
+    EXPECT_FALSE(surrogate_string.contains(lone_surrogate));
   }
 
 }
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include <EStringCompact.h>
+
+namespace CompactStorageTests {
+
+  TEST(CompactStorageTests, ChoosesNarrowestWidth) {
+    EXPECT_EQ(ECompactString(U"Hello, world!").width(), 1);
+    EXPECT_EQ(ECompactString(U"Ãçcèñtš").width(), 2);
+    EXPECT_EQ(ECompactString(U"Привет, мир!").width(), 2);
+    EXPECT_EQ(ECompactString(U"Hello, \U0001F600").width(), 4);
+  }
+
+  TEST(CompactStorageTests, WidensOnModification) {
+    ECompactString string = U"Hello";
+
+    string.push_back(U'!');
+    EXPECT_EQ(string.width(), 1);
+
+    string.insert(0, U"Привет ");
+    EXPECT_EQ(string.width(), 2);
+
+    string.append(U" \U0001F600");
+    EXPECT_EQ(string.width(), 4);
+
+    EXPECT_TRUE(string == U"Привет Hello! \U0001F600");
+  }
+
+  TEST(CompactStorageTests, ShrinkToFitNarrows) {
+    ECompactString string = U"Hello, мир!";
+
+    string.erase(7, 3);
+    string.shrink_to_fit();
+
+    EXPECT_EQ(string.width(), 1);
+    EXPECT_TRUE(string == U"Hello, !");
+  }
+
+  TEST(CompactStorageTests, AssignmentAcrossWidths) {
+    ECompactString narrow_string = U"Hello";
+    ECompactString wide_string = U"Привет, \U0001F600";
+
+    ECompactString string = U"Привет";
+    string = narrow_string;
+
+    EXPECT_EQ(string.width(), 1);
+    EXPECT_TRUE(string == U"Hello");
+
+    string = wide_string;
+
+    EXPECT_EQ(string.width(), 4);
+    EXPECT_TRUE(string == U"Привет, \U0001F600");
+
+    wide_string = narrow_string;
+
+    EXPECT_EQ(wide_string.width(), 1);
+    EXPECT_TRUE(wide_string == U"Hello");
+  }
+
+  TEST(CompactStorageTests, Indexing) {
+    ECompactString string = U"aß\U0001F600";
+
+    EXPECT_EQ(string[0], U'a');
+    EXPECT_EQ(string[1], U'ß');
+    EXPECT_EQ(string[2], U'\U0001F600');
+
+    string.set(0, U'Ж');
+
+    EXPECT_EQ(string[0], U'Ж');
+    EXPECT_EQ(string.length(), 3);
+  }
+
+  TEST(CompactStorageTests, ComparisonAcrossWidths) {
+    ECompactString narrow = U"Hello";
+    ECompactString wide = U"Hello\U0001F600";
+
+    wide.pop_back();
+
+    EXPECT_EQ(narrow.width(), 1);
+    EXPECT_EQ(wide.width(), 4);
+    EXPECT_TRUE(narrow == wide);
+    EXPECT_TRUE(narrow == EString(U"Hello"));
+    EXPECT_TRUE(narrow == u8"Hello");
+    EXPECT_TRUE(narrow != u8"Hello!");
+  }
+
+  TEST(CompactStorageTests, SearchInNarrowStorage) {
+    ECompactString string = U"Hello, world! Hello!";
+
+    EXPECT_EQ(string.width(), 1);
+    EXPECT_TRUE(string.startswith(U"Hello"));
+    EXPECT_TRUE(string.endswith(U"Hello!"));
+    EXPECT_FALSE(string.endswith(U"Hello"));
+    EXPECT_TRUE(string.contains(U"world"));
+    EXPECT_TRUE(string.contains(EString(U"lo, w")));
+    EXPECT_FALSE(string.contains(U"worlds"));
+    EXPECT_FALSE(string.contains(U"w\u00F6rld"));
+    EXPECT_FALSE(string.contains(U"Привет"));
+    EXPECT_TRUE(string.contains(U'!'));
+    EXPECT_EQ(string.find(U"Hello", 1), 14);
+    EXPECT_EQ(string.find(U'o', 5), 8);
+    EXPECT_EQ(string.find(U"!", 20), ECompactString::npos);
+    EXPECT_TRUE(string.startswith(U""));
+  }
+
+  TEST(CompactStorageTests, SearchInWideStorage) {
+    ECompactString ucs2 = U"Привет, мир! Привет!";
+    ECompactString utf32 = U"Hello, \U0001F600 world \U0001F600";
+
+    EXPECT_EQ(ucs2.width(), 2);
+    EXPECT_TRUE(ucs2.startswith(U"Привет"));
+    EXPECT_TRUE(ucs2.endswith(EString(U"Привет!")));
+    EXPECT_TRUE(ucs2.contains(U"мир"));
+    EXPECT_FALSE(ucs2.contains(U"мир\U0001F600"));
+    EXPECT_EQ(ucs2.find(U"Привет", 1), 13);
+
+    EXPECT_EQ(utf32.width(), 4);
+    EXPECT_TRUE(utf32.startswith(U"Hello"));
+    EXPECT_TRUE(utf32.endswith(U"world \U0001F600"));
+    EXPECT_TRUE(utf32.contains(U"\U0001F600 w"));
+    EXPECT_EQ(utf32.find(U'\U0001F600', 8), 15);
+  }
+
+  TEST(CompactStorageTests, SearchLongPatterns) {
+    // Longer than chunk used to compare narrowed and widened characters.
+    EString pattern;
+
+    for (int i = 0; i < 300; ++i)
+      pattern.append(static_cast<char32_t>(U'a' + i % 26));
+
+    ECompactString narrow = U"x";
+    narrow.append(pattern);
+
+    ECompactString wide = U"\u0416";
+    wide.append(pattern);
+
+    EXPECT_EQ(narrow.find(pattern), 1);
+    EXPECT_TRUE(narrow.endswith(pattern));
+    EXPECT_EQ(wide.width(), 2);
+    EXPECT_EQ(wide.find(pattern), 1);
+    EXPECT_TRUE(wide.endswith(pattern));
+
+    pattern.append(U'!');
+    EXPECT_FALSE(narrow.contains(pattern));
+    EXPECT_FALSE(wide.contains(pattern));
+  }
+
+  TEST(CompactStorageTests, EncodeAndDecode) {
+    ECompactString string = u8"Привет, мир!";
+
+    EXPECT_EQ(string.width(), 2);
+    EXPECT_EQ(string.length(), 12);
+    EXPECT_EQ(string.encode<char16_t>(), u"Привет, мир!");
+    EXPECT_EQ(string.to_estring().encode<char32_t>(), U"Привет, мир!");
+    EXPECT_EQ(ECompactString("Hello").encode<char>(), "Hello");
+  }
+
+  TEST(CompactStorageTests, RejectsInvalidEncodedCharacters) {
+    const char8_t overlong[] = { 0xC0, 0xAF, 0 };
+    const char8_t surrogate[] = { 0xED, 0xA0, 0x80, 0 };
+
+    EXPECT_THROW(ECompactString{ overlong }, encoding_failed);
+    EXPECT_THROW(ECompactString{ surrogate }, encoding_failed);
+
+    ECompactString string = U"Hello";
+
+    EXPECT_THROW(string.decode(u8"ok \xFF"), encoding_failed);
+    EXPECT_THROW(string.append(overlong), encoding_failed);
+    EXPECT_TRUE(string == U"Hello");
+  }
+
+  TEST(CompactStorageTests, ComparisonWithInvalidEncodedCharacters) {
+    const char8_t overlong[] = { 0xC0, 0xAF, 0 };
+
+    EXPECT_FALSE(ECompactString(U"/") == overlong);
+    EXPECT_FALSE(ECompactString(U"/\U0001F600") == u8"\xC0\xAF\U0001F600");
+
+    // Truncated character right before terminator doesn't read past it.
+    std::unique_ptr<char8_t[]> truncated(new char8_t[2] { 0xC3, 0 });
+
+    EXPECT_FALSE(ECompactString(U"\u00C0") == truncated.get());
+    EXPECT_FALSE(ECompactString(U"\U0001F600") == truncated.get());
+  }
+
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <EStringDecoder.h>
+
+namespace DecoderTests {
+
+  TEST(DecoderTests, Utf8AnySplit) {
+    std::u8string encoded_string = u8"aб€\U0001F600 Привет, мир! \U0010FFFF";
+    EString expected_result = U"aб€\U0001F600 Привет, мир! \U0010FFFF";
+
+    // Split in two chunks at every position, including middles of characters.
+    for (size_t split = 0; split <= encoded_string.length(); ++split) {
+      EStringDecoder<char8_t> decoder;
+      EString string;
+
+      decoder.decode(encoded_string.data(), split, string);
+      decoder.decode(encoded_string.data() + split, encoded_string.length() - split, string);
+      decoder.finish();
+
+      EXPECT_TRUE(string == expected_result);
+    }
+  }
+
+  TEST(DecoderTests, Utf8ByteByByte) {
+    std::u8string encoded_string = u8"\U0001F600€б";
+    EStringDecoder<char8_t> decoder;
+    EString string;
+
+    for (size_t index = 0; index < encoded_string.length(); ++index) {
+      decoder.decode(encoded_string.data() + index, 1, string);
+
+      EXPECT_EQ(decoder.has_pending(), index != 3 && index != 6 && index != 8);
+    }
+
+    decoder.finish();
+
+    EXPECT_TRUE(string == U"\U0001F600€б");
+  }
+
+  TEST(DecoderTests, Utf16SurrogateSplit) {
+    std::u16string encoded_string = u"x\U0001F600y";
+    EStringDecoder<char16_t> decoder;
+    EString string;
+
+    decoder.decode(std::u16string_view(encoded_string).substr(0, 2), string);
+
+    EXPECT_TRUE(decoder.has_pending());
+    EXPECT_TRUE(string == U"x");
+
+    decoder.decode(std::u16string_view(encoded_string).substr(2), string);
+    decoder.finish();
+
+    EXPECT_TRUE(string == U"x\U0001F600y");
+  }
+
+  TEST(DecoderTests, TruncatedStream) {
+    std::u8string encoded_string = u8"ab€";
+    EStringDecoder<char8_t> decoder;
+    EString string;
+
+    decoder.decode(encoded_string.data(), encoded_string.length() - 1, string);
+
+    EXPECT_EQ(decoder.pending_length(), 2);
+    EXPECT_THROW(decoder.finish(), encoding_failed);
+    EXPECT_FALSE(decoder.has_pending());
+    EXPECT_TRUE(string == U"ab");
+  }
+
+  TEST(DecoderTests, InvalidCharacter) {
+    const char8_t encoded_string[] = { u8'a', 0xFF, u8'b' };
+    EStringDecoder<char8_t> decoder;
+    EString string = U"prefix ";
+
+    EXPECT_THROW(decoder.decode(encoded_string, 3, string), encoding_failed);
+    EXPECT_TRUE(string == U"prefix ");
+  }
+
+  TEST(DecoderTests, InvalidCharacterSplit) {
+    const char8_t overlong[] = { 0xC0, 0xAF };
+    const char8_t surrogate[] = { 0xED, 0xA0, 0x80 };
+    const char8_t missing_continuation[] = { 0xD0, u8'a' };
+    const char16_t unpaired_surrogate[] = { 0xD800, u'a' };
+
+    for (size_t split = 1; split < 3; ++split) {
+      EStringDecoder<char8_t> decoder;
+      EString string;
+
+      decoder.decode(surrogate, split, string);
+
+      EXPECT_THROW(decoder.decode(surrogate + split, 3 - split, string), encoding_failed);
+      EXPECT_TRUE(string.is_empty());
+    }
+
+    EStringDecoder<char8_t> decoder;
+    EString string;
+
+    decoder.decode(overlong, 1, string);
+    EXPECT_THROW(decoder.decode(overlong + 1, 1, string), encoding_failed);
+    EXPECT_FALSE(decoder.has_pending());
+
+    decoder.decode(missing_continuation, 1, string);
+    EXPECT_THROW(decoder.decode(missing_continuation + 1, 1, string), encoding_failed);
+
+    EStringDecoder<char16_t> utf16_decoder;
+
+    utf16_decoder.decode(unpaired_surrogate, 1, string);
+    EXPECT_THROW(utf16_decoder.decode(unpaired_surrogate + 1, 1, string), encoding_failed);
+    EXPECT_TRUE(string.is_empty());
+  }
+
+  TEST(DecoderTests, LongStream) {
+    std::u8string encoded_string;
+    EString expected_result;
+
+    for (int index = 0; index < 1000; ++index) {
+      encoded_string += u8"Кусок текста \U0001F600 ";
+      expected_result.append(U"Кусок текста \U0001F600 ");
+    }
+
+    EStringDecoder<char8_t> decoder;
+    EString string;
+
+    for (size_t index = 0; index < encoded_string.length(); index += 7)
+      decoder.decode(encoded_string.data() + index, std::min<size_t>(7, encoded_string.length() - index), string);
+
+    decoder.finish();
+
+    EXPECT_TRUE(string == expected_result);
+  }
+
+}
@@ -1,9 +1,64 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <vector>
 
 #include <EString.h>
 
+// Encoding with only required traits members, optional ones are taken from fallbacks.
+struct TestLatin1EncodingTraits {
+  using encoded_char_type = signed char;
+
+  using size_type = size_t;
+
+  static constexpr size_type max_encoded_size = 1;
+
+  static constexpr const char* encoding_name = "latin1";
+
+  static constexpr size_type char_from_utf32(char32_t original_char, encoded_char_type* dest) {
+    if (original_char > 0xFF)
+      throw encoding_failed(encoding_name, "Trying to encode non-Latin-1 character.");
+
+    dest[0] = static_cast<encoded_char_type>(original_char);
+
+    return 1;
+  }
+
+  static constexpr char32_t char_to_utf32(const encoded_char_type* encoded_char) {
+    return static_cast<unsigned char>(encoded_char[0]);
+  }
+
+  static constexpr size_type from_utf32(const char32_t* decoded_string, size_type decoded_string_size_in_utf32_chars, encoded_char_type* dest) {
+    for (size_type index = 0; index < decoded_string_size_in_utf32_chars; ++index)
+      char_from_utf32(decoded_string[index], dest + index);
+
+    return decoded_string_size_in_utf32_chars;
+  }
+
+  static constexpr size_type to_utf32(const encoded_char_type* encoded_string, size_type encoded_string_size_in_chars, char32_t* dest) {
+    for (size_type index = 0; index < encoded_string_size_in_chars; ++index)
+      dest[index] = char_to_utf32(encoded_string + index);
+
+    return encoded_string_size_in_chars;
+  }
+
+  static constexpr size_type char_length(const encoded_char_type* encoded_char) {
+    (void)encoded_char;
+    return 1;
+  }
+
+  static constexpr size_type str_length(const encoded_char_type* string) noexcept {
+    size_type length = 0;
+
+    for (; string[length]; ++length) {}
+
+    return length;
+  }
+};
+
+template <>
+struct EncodingTraits<signed char> : TestLatin1EncodingTraits {};
+
 #define ENCODING_TEST(test_suite_name, test_name, target_char_type, target_string, expected_string) \
 TEST(test_suite_name, test_name) {\
   using string_type = std::basic_string<target_char_type, std::char_traits<target_char_type>>;\
@@ -42,10 +97,97 @@ namespace EncodingTests {
 
   ENCODING_TEST(EncodingTests, EncodeToUtf16, char16_t, U"Привет, мир!", u"Привет, мир!")
 
+  ENCODING_TEST(EncodingTests, EncodeSurrogatePairToUtf16, char16_t, U"\U0001F600 \U0010FFFF", u"\U0001F600 \U0010FFFF")
+
   ENCODING_TEST(EncodingTests, EncodeToUtf32, char32_t, U"Привет, мир!", U"Привет, мир!")
 
   ENCODING_TEST(EncodingTests, EncodeToWide, wchar_t, U"Привет, мир!", L"Привет, мир!")
 
+  TEST(EncodingTests, EncodeLongUtf8) {
+    std::u32string original_string;
+    std::u8string expected_result;
+
+    for (int i = 0; i < 20; ++i) {
+      original_string += U"Hello, world! Long enough ASCII run to fill blocks. Привет, мир! Длинная строка. 你好世界你好世界 \U0001F600";
+      expected_result += u8"Hello, world! Long enough ASCII run to fill blocks. Привет, мир! Длинная строка. 你好世界你好世界 \U0001F600";
+    }
+
+    EString string = original_string;
+    std::u8string encoded_string = string.encode<char8_t>();
+
+    EXPECT_EQ(encoded_string.size(), expected_result.size());
+    EXPECT_TRUE(encoded_string == expected_result);
+  }
+
+  TEST(EncodingTests, EncodeSurrogateToUtf8) {
+    const char32_t surrogate_string[] = { U'a', 0xD800, U'b', 0 };
+    const char32_t surrogate_block[] = { 0x800, 0xDFFF, 0x801, 0x802, 0x803, 0 };
+
+    EXPECT_THROW(EString(surrogate_string, 3).encode<char8_t>(), encoding_failed);
+    EXPECT_THROW(EString(surrogate_block, 5).encode<char8_t>(), encoding_failed);
+  }
+
+  TEST(EncodingTests, EncodedSize) {
+    EString string = U"ab ы \U0001F600";
+
+    EXPECT_EQ(string.encoded_size<char8_t>(), string.encode<char8_t>().length());
+    EXPECT_EQ(string.encoded_size<char16_t>(), 7);
+    EXPECT_EQ(EStringView(string).encoded_size<char32_t>(), string.length());
+  }
+
+  TEST(EncodingTests, EncodeIntoBuffer) {
+    EString string = U"Привет, \U0001F600!";
+    char8_t buffer[64];
+
+    ECodingProgress progress = string.encode_into<char8_t>(buffer);
+
+    EXPECT_TRUE(progress.is_complete);
+    EXPECT_EQ(progress.read, string.length());
+    EXPECT_TRUE(std::u8string(buffer, progress.written) == string.encode<char8_t>());
+  }
+
+  TEST(EncodingTests, EncodeIntoChunks) {
+    EString string;
+
+    for (int index = 0; index < 50; ++index)
+      string.append(U"ascii Кириллица \U0001F600 ");
+
+    std::u8string expected_result = string.encode<char8_t>();
+
+    // Every buffer size splits output at different characters.
+    for (size_t buffer_size = 4; buffer_size <= 37; ++buffer_size) {
+      std::vector<char8_t> buffer(buffer_size);
+      std::u8string result;
+      size_t index = 0;
+
+      while (true) {
+        ECodingProgress progress = string.encode_into<char8_t>(buffer, index);
+
+        ASSERT_TRUE(progress.is_complete || progress.read != 0);
+        EXPECT_LE(progress.written, buffer_size);
+
+        result.append(buffer.data(), progress.written);
+        index += progress.read;
+
+        if (progress.is_complete)
+          break;
+      }
+
+      EXPECT_TRUE(result == expected_result);
+    }
+  }
+
+  TEST(EncodingTests, EncodeIntoTooSmallBuffer) {
+    EString string = U"\U0001F600";
+    char16_t buffer[1];
+
+    ECodingProgress progress = string.encode_into<char16_t>(buffer);
+
+    EXPECT_FALSE(progress.is_complete);
+    EXPECT_EQ(progress.read, 0);
+    EXPECT_EQ(progress.written, 0);
+  }
+
 }
 
 namespace DecodingTests {
@@ -54,8 +196,94 @@ namespace DecodingTests {
 
   DECODING_TEST(DecodingTests, DecodeFromUtf16, char16_t, u"Привет, мир!", U"Привет, мир!")
 
+  DECODING_TEST(DecodingTests, DecodeSurrogatePairFromUtf16, char16_t, u"\U0001F600 \U00010000", U"\U0001F600 \U00010000")
+
   DECODING_TEST(DecodingTests, DecodeFromUtf32, char32_t, U"Привет, мир!", U"Привет, мир!")
 
   DECODING_TEST(DecodingTests, DecodeFromWide, wchar_t, L"Привет, мир!", U"Привет, мир!")
 
+  TEST(DecodingTests, DecodeLongUtf8) {
+    std::u8string original_string;
+    std::u32string expected_result;
+
+    for (int i = 0; i < 20; ++i) {
+      original_string += u8"Hello, world! Привет, мир! Long enough ASCII run to fill SIMD blocks. ";
+      expected_result += U"Hello, world! Привет, мир! Long enough ASCII run to fill SIMD blocks. ";
+    }
+
+    EString string;
+    string.decode(original_string);
+
+    EXPECT_EQ(std::u32string_view(string.data(), string.length()), expected_result);
+  }
+
+  TEST(DecodingTests, DecodeAllocatesExactLength) {
+    EString string;
+    string.decode<char8_t>(u8"Привет, мир!");
+
+    EXPECT_EQ(string.length(), 12);
+    EXPECT_EQ(string.capacity(), string.length() + 1);
+  }
+
+  TEST(DecodingTests, DecodeTruncatedUtf8) {
+    const char8_t truncated_string[] = { u8'a', 0xD0 };
+
+    EString string;
+
+    EXPECT_THROW(string.decode<char8_t>(truncated_string, 2), encoding_failed);
+  }
+
+  TEST(DecodingTests, DecodeFromChunks) {
+    std::u8string original_string = u8"Привет, мир! \U0001F600 Hello!";
+
+    for (size_t chunk_size = 1; chunk_size <= 8; ++chunk_size) {
+      EString string;
+      string.reserve(original_string.length() + 1);
+
+      std::u8string pending;
+      const char32_t* buffer = string.data();
+
+      for (size_t index = 0; index < original_string.length(); index += chunk_size) {
+        pending += original_string.substr(index, chunk_size);
+
+        ECodingProgress progress = string.decode_from<char8_t>(pending);
+        pending.erase(0, progress.read);
+
+        EXPECT_EQ(progress.is_complete, pending.empty());
+      }
+
+      EXPECT_TRUE(pending.empty());
+      EXPECT_TRUE(string == U"Привет, мир! \U0001F600 Hello!");
+      // Reserved buffer is reused.
+      EXPECT_EQ(string.data(), buffer);
+    }
+  }
+
+  TEST(DecodingTests, CustomTraitsWithoutOptionalMembers) {
+    const signed char latin1_string[] = { 'c', 'a', 'f', static_cast<signed char>(0xE9), 0 };
+
+    EString string = latin1_string;
+
+    EXPECT_TRUE(string == U"caf\u00E9");
+    EXPECT_EQ(string.encoded_size<signed char>(), 4);
+    EXPECT_TRUE(string.encode<signed char>() == std::basic_string<signed char>(latin1_string));
+
+    ECodingProgress progress = string.decode_from<signed char>(latin1_string, 4);
+
+    EXPECT_TRUE(progress.is_complete);
+    EXPECT_TRUE(string == U"caf\u00E9caf\u00E9");
+    EXPECT_THROW(EString(U"\u0100").encode<signed char>(), encoding_failed);
+  }
+
+  TEST(DecodingTests, CompareWithCustomTraitsWithoutValidate) {
+    const signed char latin1_string[] = { 'c', 'a', 'f', static_cast<signed char>(0xE9), 0 };
+
+    EString string = U"caf\u00E9";
+
+    EXPECT_TRUE(string == latin1_string);
+    EXPECT_FALSE(EString(U"cafe") == latin1_string);
+    EXPECT_TRUE(string.startswith(latin1_string, 3));
+    EXPECT_TRUE(transcode<char8_t>(latin1_string) == u8"caf\u00E9");
+  }
+
 }
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <EStringMappedText.h>
+
+namespace FileTests {
+
+  // Temporary file, removed at the end of test.
+  class TemporaryFile {
+  public:
+    TemporaryFile(const void* data, size_t size) {
+      m_path = (std::filesystem::temp_directory_path() / ("estring_file_test_" + std::to_string(s_counter++))).string();
+
+      FILE* file = fopen(m_path.c_str(), "wb");
+      fwrite(data, 1, size, file);
+      fclose(file);
+    }
+
+    ~TemporaryFile() {
+      std::filesystem::remove(m_path);
+    }
+
+    const char* path() const {
+      return m_path.c_str();
+    }
+
+  private:
+    static inline int s_counter = 0;
+    std::string m_path;
+  };
+
+  TEST(FileTests, Utf8WithoutBom) {
+    std::u8string content = u8"Привет, мир! \U0001F600";
+    TemporaryFile file(content.data(), content.size());
+
+    EXPECT_TRUE(EString::from_file(file.path()) == U"Привет, мир! \U0001F600");
+  }
+
+  TEST(FileTests, Utf8WithBom) {
+    std::u8string content = u8"\uFEFFHello";
+    TemporaryFile file(content.data(), content.size());
+
+    EMappedFile mapped_file(file.path());
+
+    EXPECT_EQ(mapped_file.encoding(), EFileEncoding::utf8);
+    EXPECT_EQ(mapped_file.bom_size(), 3);
+    EXPECT_TRUE(EString::from_file(file.path()) == U"Hello");
+  }
+
+  TEST(FileTests, Utf16WithBom) {
+    std::u16string content = u"\uFEFFПривет, \U0001F600!";
+    TemporaryFile file(content.data(), content.size() * sizeof(char16_t));
+
+    EXPECT_EQ(EMappedFile(file.path()).encoding(), EFileEncoding::utf16);
+    EXPECT_TRUE(EString::from_file(file.path()) == U"Привет, \U0001F600!");
+  }
+
+  TEST(FileTests, EmptyFile) {
+    TemporaryFile file("", 0);
+
+    EXPECT_TRUE(EString::from_file(file.path()).is_empty());
+    EXPECT_EQ(EMappedText(file.path()).pages_count(), 0);
+  }
+
+  TEST(FileTests, MissingFile) {
+    EXPECT_THROW(EString::from_file("/this/file/does/not/exist"), std::system_error);
+  }
+
+  TEST(FileTests, LazyPages) {
+    std::u8string content;
+
+    for (int index = 0; index < 500; ++index)
+      content += u8"строка \U0001F600 line ";
+
+    TemporaryFile file(content.data(), content.size());
+
+    // Small pages split many characters.
+    EMappedText text(file.path(), 61);
+    EString expected_result = EString::from_file(file.path());
+    EString result;
+
+    EXPECT_EQ(text.pages_count(), (content.size() + 60) / 61);
+
+    for (size_t index = 0; index < text.pages_count(); ++index)
+      result.append(text.page(index).data(), text.page(index).length());
+
+    EXPECT_TRUE(result == expected_result);
+    EXPECT_TRUE(text.to_estring() == expected_result);
+
+    EString first_page(text.page(0));
+    text.release_page(0);
+
+    EXPECT_TRUE(text.page(0) == first_page);
+  }
+
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <EString.h>
+
+namespace FormatTests {
+
+  TEST(FormatTests, Arguments) {
+    EString name = U"мир";
+    std::string encoded_name = "world";
+
+    EString string = EString::format(U"{} {}, {} {}! {} {} {}", 42, -7, name, u8"\U0001F600", encoded_name, U'ы', true);
+
+    EXPECT_TRUE(string == U"42 -7, мир \U0001F600! world ы true");
+  }
+
+  TEST(FormatTests, Braces) {
+    EXPECT_TRUE(EString::format(U"{{}} {{{}}}", 1) == U"{} {1}");
+    EXPECT_TRUE(EString::format(U"no fields") == U"no fields");
+    EXPECT_TRUE(EString::format(U"") == U"");
+  }
+
+  TEST(FormatTests, ManualIndexes) {
+    EXPECT_TRUE(EString::format(U"{1} {0} {1}", U"a", U"b") == U"b a b");
+  }
+
+  TEST(FormatTests, Integers) {
+    EXPECT_TRUE(EString::format(U"{:x} {:X} {:#x} {:#b} {:o} {:#o}", 255, 255, 255, 5, 8, 8) == U"ff FF 0xff 0b101 10 010");
+    EXPECT_TRUE(EString::format(U"{:+} {: } {:+}", 5, 5, -5) == U"+5  5 -5");
+    EXPECT_TRUE(EString::format(U"{:05} {:#06x} {:c}", -42, 255, 0x44B) == U"-0042 0x00ff ы");
+    EXPECT_TRUE(EString::format(U"{} {}", -9223372036854775807ll - 1, 18446744073709551615ull) == U"-9223372036854775808 18446744073709551615");
+  }
+
+  TEST(FormatTests, IntegerCharacterOutOfRange) {
+    EString string = U"prefix";
+
+    EXPECT_TRUE(EString::format(U"{:c}", 0x10FFFF) == U"\U0010FFFF");
+    EXPECT_THROW(EString::format(U"{:c}", -1), std::out_of_range);
+    EXPECT_THROW(EString::format(U"{:c}", 0x110000), std::out_of_range);
+    EXPECT_THROW(format_to(string, U"{:c}", -65), std::out_of_range);
+    EXPECT_TRUE(string == U"prefix");
+  }
+
+  TEST(FormatTests, Floats) {
+    EXPECT_TRUE(EString::format(U"{} {} {}", 1.5, 0.1, -2.0f) == U"1.5 0.1 -2");
+    EXPECT_TRUE(EString::format(U"{:.2f} {:e} {:.3g} {:E}", 3.14159, 1234.5, 0.000123456, 1e10) == U"3.14 1.234500e+03 0.000123 1.000000E+10");
+    EXPECT_TRUE(EString::format(U"{:+.1f} {:08.3f}", 2.25, -1.5) == U"+2.2 -001.500");
+    EXPECT_TRUE(EString::format(U"{:f}", 1e300).length() == 308);
+  }
+
+  TEST(FormatTests, Alignment) {
+    EXPECT_TRUE(EString::format(U"[{:5}] [{:5}] [{:^5}] [{:*>5}]", U"ab", 12, U'c', U"ы") == U"[ab   ] [   12] [  c  ] [****ы]");
+    EXPECT_TRUE(EString::format(U"[{:<4}] [{:→^7}]", 1, u8"ab\U0001F600") == U"[1   ] [→→ab\U0001F600→→]");
+  }
+
+  TEST(FormatTests, StringPrecision) {
+    EXPECT_TRUE(EString::format(U"[{:.3}] [{:>6.2}] [{:.1}]", U"abcdef", u8"пример", u"\U0001F600x") == U"[abc] [    пр] [\U0001F600]");
+  }
+
+  TEST(FormatTests, FormatToAppends) {
+    EString string = U"log: ";
+
+    format_to(string, U"{} + {} = {}", 2, 2, 4);
+    format_to(string, U"; {}", EStringView(U"done"));
+
+    EXPECT_TRUE(string == U"log: 2 + 2 = 4; done");
+  }
+
+  TEST(FormatTests, FormatToItself) {
+    EString string = U"abcdefghij";
+
+    format_to(string, U" [{}]", string);
+    format_to(string, U" {:.3} {}", EStringView(string), EStringView(string).substr(0, 2));
+
+    EXPECT_TRUE(string == U"abcdefghij [abcdefghij] abc ab");
+  }
+
+  TEST(FormatTests, SingleAllocation) {
+    EString string = EString::format(U"{} items cost {:.2f} in {}", 12345, 99.5, U"a long enough name of the shop to skip inline buffer");
+
+    EXPECT_TRUE(string == U"12345 items cost 99.50 in a long enough name of the shop to skip inline buffer");
+    // Size is estimated before writing, so result is allocated once with small slack.
+    EXPECT_LT(string.capacity() - string.length(), 32);
+  }
+
+}
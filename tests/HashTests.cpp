@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <unordered_map>
+
+#include <EString.h>
+
+namespace HashTests {
+
+  TEST(HashTests, EqualStringsHaveEqualHashes) {
+    EString first = U"Привет, мир!";
+    EString second = u8"Привет, мир!";
+
+    EXPECT_EQ(std::hash<EString>()(first), std::hash<EString>()(second));
+    EXPECT_EQ(first.hash(), std::hash<EStringView>()(first));
+    EXPECT_EQ(first.hash(), EStringHash()(u8"Привет, мир!"));
+    EXPECT_EQ(first.hash(), EStringHash()(std::u16string_view(u"Привет, мир!")));
+    EXPECT_NE(first.hash(), EString(U"Привет, мир?").hash());
+  }
+
+  TEST(HashTests, LongEncodedStringsHaveEqualHashes) {
+    std::u8string encoded_string;
+
+    for (int i = 0; i < 30; ++i)
+      encoded_string += u8"Привет, мир! ";
+
+    EString string = encoded_string;
+
+    EXPECT_EQ(string.hash(), EStringHash()(encoded_string));
+  }
+
+  TEST(HashTests, MutationInvalidatesCachedHash) {
+    EString string = U"Hello";
+    size_t hash = string.hash();
+
+    string.append(U'!');
+    EXPECT_NE(string.hash(), hash);
+
+    string.pop_back();
+    EXPECT_EQ(string.hash(), hash);
+
+    string[0] = U'J';
+    EXPECT_EQ(string.hash(), EString(U"Jello").hash());
+  }
+
+  TEST(HashTests, Utf32StringsWithSurrogates) {
+    const char32_t characters[] = { U'a', 0xD800, U'b', 0 };
+    EString string(characters, 3);
+
+    EXPECT_EQ(EStringHash{}(string), EStringHash{}(characters));
+    EXPECT_TRUE(EStringEqual{}(string, characters));
+    EXPECT_TRUE(EStringEqual{}(std::u32string_view(characters, 3), string));
+  }
+
+  constexpr size_t modified_length() {
+    EString string(U"hello");
+    string.push_back(U'!');
+    string[0] = U'H';
+
+    EString copy;
+    copy = string;
+
+    return copy.length();
+  }
+
+  TEST(HashTests, ConstantEvaluated) {
+    static_assert(modified_length() == 6);
+  }
+
+  TEST(HashTests, HeterogeneousLookup) {
+    std::unordered_map<EString, int, EStringHash, EStringEqual> map;
+
+    map.emplace(U"GET", 1);
+    map.emplace(U"POST", 2);
+    map.emplace(U"Привет", 3);
+
+    EXPECT_EQ(map.find(std::u8string_view(u8"GET"))->second, 1);
+    EXPECT_EQ(map.find(U"POST")->second, 2);
+    EXPECT_EQ(map.find(u8"Привет")->second, 3);
+    EXPECT_EQ(map.find(EStringView(U"Привет, мир").substr(0, 6))->second, 3);
+    EXPECT_TRUE(map.find(std::u8string_view(u8"PUT")) == map.end());
+    EXPECT_EQ(map.find(std::u8string(u8"GET"))->second, 1);
+    EXPECT_EQ(map.find(std::u16string(u"Привет"))->second, 3);
+    EXPECT_TRUE(map.find(std::u8string(u8"PUT")) == map.end());
+
+    map.emplace(U"/", 4);
+    const char8_t overlong_slash[] = { 0xC0, 0xAF, 0 };
+    EXPECT_TRUE(map.find(overlong_slash) == map.end());
+  }
+
+  TEST(HashTests, MalformedEncodedKeys) {
+    std::unordered_map<EString, int, EStringHash, EStringEqual> map;
+    map.emplace(U"/", 1);
+
+    const char8_t lone_continuation[] = { 0x80 };
+    const char8_t truncated[] = { 0xE2, 0x82 };
+    const char8_t overlong_slash[] = { 0xC0, 0xAF };
+    const char16_t lone_surrogate[] = { 0xD800 };
+
+    EXPECT_NO_THROW(EStringHash{}(std::u8string_view(lone_continuation, 1)));
+    EXPECT_EQ(EStringHash{}(std::u8string_view(truncated, 2)), EStringHash{}(std::u8string_view(truncated, 2)));
+    EXPECT_NE(EStringHash{}(std::u8string_view(overlong_slash, 2)), EStringHash{}(U"/"));
+
+    EXPECT_TRUE(map.find(std::u8string_view(lone_continuation, 1)) == map.end());
+    EXPECT_TRUE(map.find(std::u8string_view(truncated, 2)) == map.end());
+    EXPECT_TRUE(map.find(std::u8string_view(overlong_slash, 2)) == map.end());
+    EXPECT_TRUE(map.find(std::u16string_view(lone_surrogate, 1)) == map.end());
+  }
+
+}
@@ -40,4 +40,35 @@ namespace ConstructingTests {
     EXPECT_EQ(moved.data(), previous_data);
   }
 
+  TEST(ConstructingTests, ShortStringIsInline) {
+    EString string = U"key";
+
+    const char* object_begin = reinterpret_cast<const char*>(&string);
+    const char* object_end = object_begin + sizeof(EString);
+    const char* data = reinterpret_cast<const char*>(string.data());
+
+    EXPECT_EQ(string.capacity(), EString::inline_capacity);
+    EXPECT_TRUE(data >= object_begin && data < object_end);
+    EXPECT_EQ(string.encode<char32_t>(), U"key");
+  }
+
+  TEST(ConstructingTests, MoveShortEString) {
+    EString string = U"key";
+    EString moved = std::move(string);
+
+    EXPECT_EQ(string.length(), 0);
+    EXPECT_EQ(string.c_str()[0], 0);
+    EXPECT_EQ(moved.encode<char32_t>(), U"key");
+  }
+
+  TEST(ConstructingTests, ShrinkToInline) {
+    EString string = U"Привет, мир!";
+
+    string.erase(3, string.length() - 3);
+    string.shrink_to_fit();
+
+    EXPECT_EQ(string.capacity(), EString::inline_capacity);
+    EXPECT_EQ(string.encode<char32_t>(), U"При");
+  }
+
 }
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <EStringInterner.h>
+
+namespace InternerTests {
+
+  TEST(InternerTests, EqualStringsGetEqualHandles) {
+    EStringInterner interner;
+
+    EStringInterner::Handle first = interner.intern(EString(U"identifier"));
+    EStringInterner::Handle second = interner.intern(U"identifier");
+    EStringInterner::Handle other = interner.intern(U"other");
+
+    EXPECT_TRUE(first == second);
+    EXPECT_TRUE(first != other);
+    EXPECT_EQ(first.hash(), second.hash());
+    EXPECT_EQ(interner.size(), 2);
+  }
+
+  TEST(InternerTests, EncodedInputs) {
+    EStringInterner interner;
+
+    EStringInterner::Handle handle = interner.intern(U"Привет");
+
+    EXPECT_TRUE(interner.intern(u8"Привет") == handle);
+    EXPECT_TRUE(interner.intern(u"Привет") == handle);
+    EXPECT_TRUE(interner.find(u8"Привет") == handle);
+    EXPECT_TRUE(handle.view() == U"Привет");
+    EXPECT_EQ(interner.size(), 1);
+  }
+
+  TEST(InternerTests, FindMissing) {
+    EStringInterner interner;
+
+    interner.intern(U"present");
+
+    EXPECT_FALSE(interner.find(U"missing").is_valid());
+    EXPECT_FALSE(interner.find(u8"presen").is_valid());
+    EXPECT_TRUE(interner.find(U"present").is_valid());
+
+    // Overlong utf8 '/' isn't '/'.
+    const char8_t overlong_slash[] = { 0xC0, 0xAF, 0 };
+    interner.intern(U"/");
+    EXPECT_FALSE(interner.find(overlong_slash).is_valid());
+  }
+
+  TEST(InternerTests, InvalidEncodedInputs) {
+    const char8_t overlong[] = { 0xC0, 0xAF, 0 };
+    const char8_t lone_continuation[] = { 0x80 };
+    const char8_t truncated[] = { 0xE2, 0x82 };
+
+    EStringInterner interner;
+    interner.intern(U"/");
+
+    EXPECT_FALSE(interner.find(overlong).is_valid());
+    EXPECT_FALSE(interner.find(lone_continuation, 1).is_valid());
+    EXPECT_FALSE(interner.find(truncated, 2).is_valid());
+    EXPECT_THROW(interner.intern(overlong), encoding_failed);
+    EXPECT_THROW(interner.intern(lone_continuation, 1), encoding_failed);
+    EXPECT_THROW(interner.intern(truncated, 2), encoding_failed);
+    EXPECT_EQ(interner.size(), 1);
+  }
+
+  TEST(InternerTests, StringsWithSurrogates) {
+    const char32_t characters[] = { U'a', 0xD800, U'b' };
+    EString string(characters, 3);
+
+    EStringInterner interner;
+    EStringInterner::Handle handle = interner.intern(string);
+
+    EXPECT_EQ(interner.intern(string), handle);
+    EXPECT_EQ(interner.intern(characters, 3), handle);
+    EXPECT_EQ(interner.find(string), handle);
+    EXPECT_EQ(interner.size(), 1);
+  }
+
+  TEST(InternerTests, HandlesInUnorderedSet) {
+    EStringInterner interner;
+    std::unordered_set<EStringInterner::Handle> set;
+
+    set.insert(interner.intern(U"a"));
+    set.insert(interner.intern(u8"a"));
+    set.insert(interner.intern(U"b"));
+
+    EXPECT_EQ(set.size(), 2);
+  }
+
+  TEST(InternerTests, ConcurrentInterning) {
+    EStringInterner interner;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<EStringInterner::Handle>> handles(4);
+
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&interner, &handles, i] {
+        for (int j = 0; j < 500; ++j) {
+          std::u8string key = u8"key_";
+          key += static_cast<char8_t>(u8'a' + j % 26);
+          key += static_cast<char8_t>(u8'a' + j / 26);
+
+          handles[i].push_back(interner.intern(key.c_str(), key.length()));
+        }
+      });
+    }
+
+    for (std::thread& thread : threads)
+      thread.join();
+
+    EXPECT_EQ(interner.size(), 500);
+
+    for (int i = 1; i < 4; ++i)
+      EXPECT_TRUE(handles[i] == handles[0]);
+  }
+
+}
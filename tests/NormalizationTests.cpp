@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <EString.h>
+
+namespace NormalizationTests {
+
+  TEST(NormalizationTests, ComposedAndDecomposedAreEqualAfterNormalization) {
+    EString composed_name = U"Zoë Åström";
+    EString decomposed_name = U"Zoë Åström";
+
+    EXPECT_FALSE(composed_name == decomposed_name);
+
+    EXPECT_TRUE(decomposed_name.normalized() == composed_name);
+    EXPECT_TRUE(composed_name.normalized(ENormalizationForm::nfd) == decomposed_name);
+  }
+
+  TEST(NormalizationTests, NormalizedStringIsNotChanged) {
+    EString string = U"Hello, мир! Zoë \U0001F600";
+    const char32_t* buffer = string.data();
+
+    string.normalize();
+
+    EXPECT_EQ(string.data(), buffer);
+    EXPECT_TRUE(string.is_normalized());
+    EXPECT_TRUE(string == U"Hello, мир! Zoë \U0001F600");
+  }
+
+  TEST(NormalizationTests, CanonicalOrder) {
+    // Dot below (class 220) goes before diaeresis (class 230).
+    EString string = U"ạ̈";
+
+    EXPECT_FALSE(string.is_normalized(ENormalizationForm::nfd));
+    EXPECT_TRUE(string.normalized(ENormalizationForm::nfd) == U"ạ̈");
+    EXPECT_TRUE(string.normalized() == U"ạ̈");
+  }
+
+  TEST(NormalizationTests, BlockedComposition) {
+    // Acute after another acute is blocked, and isn't composed.
+    EXPECT_TRUE(EString(U"é́").normalized() == U"é́");
+    // Singletons and excluded characters aren't composed back.
+    EXPECT_TRUE(EString(U"Å Ω").normalized() == U"Å Ω");
+    EXPECT_TRUE(EString(U"क़").normalized() == U"क़");
+  }
+
+  TEST(NormalizationTests, Hangul) {
+    EString syllables = U"한국어";
+    EString jamo = U"한국어";
+
+    EXPECT_TRUE(syllables.normalized(ENormalizationForm::nfd) == jamo);
+    EXPECT_TRUE(jamo.normalized() == syllables);
+    EXPECT_FALSE(jamo.is_normalized());
+  }
+
+  TEST(NormalizationTests, CompatibilityForms) {
+    EString string = U"ﬁ ² ① Ａ ẛ̣";
+
+    EXPECT_TRUE(string.normalized(ENormalizationForm::nfkc) == U"fi 2 1 A ṩ");
+    EXPECT_TRUE(string.normalized(ENormalizationForm::nfkd) == U"fi 2 1 A ṩ");
+    EXPECT_TRUE(string.normalized(ENormalizationForm::nfc) == U"ﬁ ² ① Ａ ẛ̣");
+    EXPECT_FALSE(string.is_normalized(ENormalizationForm::nfkc));
+  }
+
+  TEST(NormalizationTests, MaybeCharacters) {
+    // Combining acute is 'Maybe' in NFC: it's normalized only if it can't compose with previous character.
+    EXPECT_TRUE(EString(U"x́").is_normalized());
+    EXPECT_FALSE(EString(U"é").is_normalized());
+    EXPECT_TRUE(EString(U"́").is_normalized());
+    EXPECT_TRUE(EString().is_normalized());
+  }
+
+}
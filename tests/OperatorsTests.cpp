@@ -43,6 +43,45 @@ namespace ComparisonOperatorsTests {
     EXPECT_TRUE(first != second);
   }
 
+  TEST(ComparisonOperatorsTests, ComprasionWithLongUtf8String) {
+    // Longer than SIMD block, with ASCII and non-ASCII parts.
+    EString first = U"GET /index.html HTTP/1.1, Привет, мир! And some more ASCII text";
+
+    EXPECT_TRUE(first == u8"GET /index.html HTTP/1.1, Привет, мир! And some more ASCII text");
+    EXPECT_FALSE(first == u8"GET /index.html HTTP/1.1, Привет, мир! And some more ASCII tex");
+    EXPECT_FALSE(first == u8"GET /index.html HTTP/1.1, Привет, мир! And some more ASCII text!");
+    EXPECT_FALSE(first == u8"GET /index.htm! HTTP/1.1, Привет, мир! And some more ASCII text");
+    EXPECT_FALSE(first == u8"GET /index.html HTTP/1.1, Привет, мир! And some more ASCII texT");
+    EXPECT_FALSE(first == u"GET /index.html HTTP/1.1, Привет, мор! And some more ASCII text");
+  }
+
+  TEST(ComparisonOperatorsTests, ComprasionWithTruncatedUtf8String) {
+    EString first = U"Hello, м";
+    const char8_t truncated_string[] = { u8'H', u8'e', u8'l', u8'l', u8'o', u8',', u8' ', 0xD0, 0 };
+
+    EXPECT_FALSE(first == truncated_string);
+  }
+
+  TEST(ComparisonOperatorsTests, ComprasionWithInvalidString) {
+    // Overlong utf8 '/', utf8 encoded surrogate and lone utf16 surrogate.
+    const char8_t overlong_slash[] = { 0xC0, 0xAF, 0 };
+    const char8_t encoded_surrogate[] = { 0xED, 0xA0, 0x80, 0 };
+    const char16_t lone_surrogate[] = { 0xD800, 0 };
+
+    EXPECT_FALSE(EString(U"/") == overlong_slash);
+    EXPECT_FALSE(EString(U"\xD800") == encoded_surrogate);
+    EXPECT_FALSE(EString(U"\xD800") == lone_surrogate);
+  }
+
+  TEST(ComparisonOperatorsTests, ComprasionWithUtf32StringWithSurrogate) {
+    const char32_t characters[] = { U'a', 0xD800, U'b', 0x110000 };
+    EString string(characters, 4);
+
+    EXPECT_TRUE(string == string.data());
+    EXPECT_TRUE(string == std::u32string(characters, 4));
+    EXPECT_FALSE(string == std::u32string(characters, 3));
+  }
+
 }
 
 namespace ConcatenatingTests {
@@ -66,4 +105,102 @@ namespace ConcatenatingTests {
     EXPECT_STREQ((string + u8", world!").encode<char>().c_str(), "Hello, world!");
   }
 
+  TEST(ConcatenatingTests, ChainAllocatesExactLength) {
+    EString first = U"The quick brown fox ";
+    EString second = U"jumps over ";
+
+    EString string = first + second + U"the lazy " + u8"собака" + u"!";
+
+    EXPECT_TRUE(string == U"The quick brown fox jumps over the lazy собака!");
+    EXPECT_EQ(string.capacity(), string.length() + 1);
+  }
+
+  TEST(ConcatenatingTests, ReuseRvalueBuffer) {
+    EString string = U"A string longer than inline buffer";
+    string.reserve(100);
+
+    const char32_t* buffer = string.data();
+    EString other = U", extended";
+
+    EString result = std::move(string) + other + U"!";
+
+    EXPECT_EQ(result.data(), buffer);
+    EXPECT_TRUE(result == U"A string longer than inline buffer, extended!");
+  }
+
+  TEST(ConcatenatingTests, RvalueStringConcatenatedWithItself) {
+    EString string = U"abcdefghijklmnopqrstuvwxyz";
+
+    EString result = std::move(string) + string;
+    EXPECT_TRUE(result == U"abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+
+    EString long_string = U"A string longer than inline buffer";
+    EString long_result = std::move(long_string) + EStringView(long_string) + U"!";
+    EXPECT_TRUE(long_result == U"A string longer than inline bufferA string longer than inline buffer!");
+  }
+
+  TEST(ConcatenatingTests, StoreConcatenationOfRvalue) {
+    auto make = [](const char32_t* string) { return EString(string); };
+
+    auto joined = make(U"A string longer than inline buffer") + U"!";
+    auto short_joined = make(U"ab") + U"c" + make(U"d");
+
+    EString result = std::move(joined);
+    EXPECT_TRUE(result == U"A string longer than inline buffer!");
+    EXPECT_TRUE(EString(std::move(short_joined)) == U"abcd");
+  }
+
+  TEST(ConcatenatingTests, ConcatenateWithStlStrings) {
+    EString string = U"Hello";
+    std::u8string world = u8", мир";
+
+    EString result = string + world + std::u16string(u"!") + std::u32string_view(U"?");
+    EXPECT_TRUE(result == U"Hello, мир!?");
+
+    auto stored = string + std::u8string(u8" and a string longer than inline buffer");
+    EXPECT_TRUE(EString(std::move(stored)) == U"Hello and a string longer than inline buffer");
+  }
+
+  TEST(ConcatenatingTests, CompareConcatenation) {
+    EString string = U"Hello";
+    const char8_t overlong_slash[] = { 0xC0, 0xAF, 0 };
+
+    EXPECT_TRUE(string + u8", мир" == U"Hello, мир");
+    EXPECT_TRUE(string + U", мир" == u8"Hello, мир");
+    EXPECT_TRUE(string + u8", мир" == std::u16string(u"Hello, мир"));
+    EXPECT_TRUE(string + U"!" == EString(U"Hello!"));
+    EXPECT_TRUE(EString(U"Hello!") == string + U"!");
+    EXPECT_TRUE(string + U"!" == U"Hell" + EString(U"o!"));
+    EXPECT_FALSE(string + U"!" == U"Hello");
+    EXPECT_FALSE(string + U"!" == U"Hello!!");
+    EXPECT_TRUE(string + U"!" != EStringView(U"Hello?"));
+    EXPECT_FALSE(string + overlong_slash == U"Hello/");
+  }
+
+  TEST(ConcatenatingTests, StringOnTheRight) {
+    EString string = U"world";
+
+    EXPECT_TRUE(U"Hello, " + string == U"Hello, world");
+    EXPECT_TRUE(u8"Привет, " + string + U"!" == U"Привет, world!");
+  }
+
+  TEST(ConcatenatingTests, AppendConcatenation) {
+    EString string = U"a";
+    EString other = U"b";
+
+    string += other + U"c" + other;
+
+    EXPECT_TRUE(string == U"abcb");
+  }
+
+  TEST(ConcatenatingTests, AppendConcatenationOfItself) {
+    EString string = U"abcdefghij";
+
+    string += string + U"XYZ";
+    EXPECT_TRUE(string == U"abcdefghijabcdefghijXYZ");
+
+    string += U"<" + string;
+    EXPECT_TRUE(string == U"abcdefghijabcdefghijXYZ<abcdefghijabcdefghijXYZ");
+  }
+
 }
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <EStringPatternSet.h>
+
+namespace PatternSetTests {
+
+  using Match = EStringPatternSet::Match;
+
+  TEST(PatternSetTests, OverlappingPatterns) {
+    EStringPatternSet patterns = { U"he", U"she", U"his", U"hers" };
+
+    std::vector<Match> matches = patterns.find_all(U"ushers");
+
+    ASSERT_EQ(matches.size(), 3);
+    EXPECT_TRUE(matches[0] == (Match{ 1, 1, 3 }));
+    EXPECT_TRUE(matches[1] == (Match{ 0, 2, 2 }));
+    EXPECT_TRUE(matches[2] == (Match{ 3, 2, 4 }));
+  }
+
+  TEST(PatternSetTests, NonAsciiPatterns) {
+    EStringPatternSet patterns;
+    patterns.add(u8"привет");
+    patterns.add(u"мир");
+    patterns.add(U"\U0001F600");
+    patterns.compile();
+
+    EString string = U"Привет, мир! привет \U0001F600";
+    std::vector<Match> matches = patterns.find_all(string);
+
+    ASSERT_EQ(matches.size(), 3);
+    EXPECT_TRUE(matches[0] == (Match{ 1, 8, 3 }));
+    EXPECT_TRUE(matches[1] == (Match{ 0, 13, 6 }));
+    EXPECT_TRUE(matches[2] == (Match{ 2, 20, 1 }));
+  }
+
+  TEST(PatternSetTests, ContainsAny) {
+    EStringPatternSet patterns = { U"spam", U"scam" };
+
+    EXPECT_TRUE(patterns.contains_any(U"this is not a scam"));
+    EXPECT_FALSE(patterns.contains_any(U"hello, world"));
+    EXPECT_FALSE(patterns.contains_any(U""));
+  }
+
+  TEST(PatternSetTests, DuplicateAndEmptyPatterns) {
+    EStringPatternSet patterns = { U"ab", U"", U"ab" };
+
+    std::vector<Match> matches = patterns.find_all(U"xab");
+
+    ASSERT_EQ(matches.size(), 2);
+    EXPECT_TRUE(matches[0] == (Match{ 0, 1, 2 }));
+    EXPECT_TRUE(matches[1] == (Match{ 2, 1, 2 }));
+  }
+
+  TEST(PatternSetTests, StopScanning) {
+    EStringPatternSet patterns = { U"a" };
+    size_t count = 0;
+
+    patterns.scan(U"aaaa", [&count](Match const&) {
+      return ++count < 2;
+    });
+
+    EXPECT_EQ(count, 2);
+  }
+
+  TEST(PatternSetTests, RequiresCompile) {
+    EStringPatternSet patterns;
+    patterns.add(U"a");
+
+    EXPECT_FALSE(patterns.is_compiled());
+    EXPECT_THROW(patterns.find_all(U"a"), std::logic_error);
+
+    patterns.compile();
+
+    EXPECT_EQ(patterns.find_all(U"a").size(), 1);
+  }
+
+  TEST(PatternSetTests, MatchesBruteForce) {
+    // Small alphabet gives many overlapping matches, patterns are deeper than dense states.
+    const char32_t alphabet[] = { U'a', U'b', U'ä', U'\U0001F361' };
+
+    std::mt19937 random(777);
+
+    for (int iteration = 0; iteration < 200; ++iteration) {
+      EStringPatternSet patterns;
+      std::vector<std::u32string> pattern_strings;
+
+      for (int pattern_index = 0; pattern_index < 20; ++pattern_index) {
+        std::u32string pattern;
+
+        for (size_t length = 1 + random() % 6; length > 0; --length)
+          pattern.push_back(alphabet[random() % 4]);
+
+        patterns.add(EStringView(pattern.data(), pattern.length()));
+        pattern_strings.push_back(pattern);
+      }
+
+      patterns.compile();
+
+      std::u32string string;
+
+      for (size_t length = random() % 100; length > 0; --length)
+        string.push_back(alphabet[random() % 4]);
+
+      size_t expected_count = 0;
+
+      for (std::u32string const& pattern : pattern_strings)
+        for (size_t index = string.find(pattern); index != std::u32string::npos; index = string.find(pattern, index + 1))
+          ++expected_count;
+
+      std::vector<Match> matches = patterns.find_all(EStringView(string.data(), string.length()));
+
+      ASSERT_EQ(matches.size(), expected_count);
+
+      for (Match const& match : matches)
+        EXPECT_EQ(string.compare(match.index, match.length, pattern_strings[match.pattern_index]), 0);
+    }
+  }
+
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include <EStringRope.h>
+
+namespace RopeTests {
+
+  static EString make_text(size_t length) {
+    EString text;
+
+    for (size_t index = 0; index < length; ++index)
+      text.push_back(index % 7 == 0 ? U'ж' : static_cast<char32_t>(U'a' + index % 26));
+
+    return text;
+  }
+
+  TEST(RopeTests, FromAndToEString) {
+    EString text = make_text(5000);
+    ERope rope = text;
+
+    EXPECT_EQ(rope.length(), text.length());
+    EXPECT_TRUE(rope.to_estring() == text);
+    EXPECT_TRUE(rope == EStringView(text));
+    EXPECT_EQ(rope[4321], text[4321]);
+  }
+
+  TEST(RopeTests, InsertAndErase) {
+    ERope rope = U"Hello world";
+
+    rope.insert(5, U",");
+    rope.insert(rope.length(), U'!');
+    rope.insert(0, U"> ");
+
+    EXPECT_TRUE(rope == U"> Hello, world!");
+
+    rope.erase(0, 2);
+    rope.erase(5, 100);
+
+    EXPECT_TRUE(rope == U"Hello");
+  }
+
+  TEST(RopeTests, SplitAndAppend) {
+    EString text = make_text(3000);
+    ERope rope = text;
+
+    ERope tail = rope.split(1234);
+
+    EXPECT_TRUE(rope.to_estring() == text.substr(0, 1234));
+    EXPECT_TRUE(tail.to_estring() == text.substr(1234));
+
+    rope.append(std::move(tail));
+
+    EXPECT_TRUE(rope.to_estring() == text);
+    EXPECT_TRUE(tail.is_empty());
+  }
+
+  TEST(RopeTests, Encode) {
+    EString text = make_text(2500) + U"\U0001F600";
+    ERope rope = text;
+
+    EXPECT_TRUE(rope.encode<char8_t>() == text.encode<char8_t>());
+    EXPECT_EQ(rope.encode<char16_t>(), text.encode<char16_t>());
+  }
+
+  TEST(RopeTests, CompareRopesWithDifferentLeaves) {
+    EString text = make_text(6000);
+    ERope rope = text;
+
+    // Same text, split to leaves at other positions.
+    ERope edited = EStringView(text).substr(0, 1500);
+    edited.append(ERope(EStringView(text).substr(3333)));
+    edited.insert(1500, EStringView(text).substr(1500, 1833));
+
+    EXPECT_TRUE(rope == edited);
+    EXPECT_TRUE(edited == rope);
+
+    edited.erase(4000, 1);
+    edited.insert(4000, U'?');
+
+    EXPECT_TRUE(rope != edited);
+    EXPECT_TRUE(rope != ERope(EStringView(text).substr(1)));
+    EXPECT_TRUE(ERope() == ERope());
+    EXPECT_TRUE(ERope() == U"");
+  }
+
+  TEST(RopeTests, RandomEdits) {
+    std::mt19937 random(2024);
+    std::u32string model = make_text(10000).encode<char32_t>();
+    ERope rope = EStringView(model.data(), model.length());
+
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+      size_t index = random() % (model.length() + 1);
+
+      switch (random() % 3) {
+        case 0: {
+          std::u32string string(1 + random() % 2000, static_cast<char32_t>(U'A' + random() % 26));
+
+          model.insert(index, string);
+          rope.insert(index, EStringView(string.data(), string.length()));
+          break;
+        }
+        case 1: {
+          size_t count = random() % 1500;
+
+          model.erase(index, count);
+          rope.erase(index, count);
+          break;
+        }
+        default: {
+          ERope tail = rope.split(index);
+          rope.append(std::move(tail));
+          break;
+        }
+      }
+
+      ASSERT_EQ(rope.length(), model.length());
+    }
+
+    EXPECT_TRUE(rope == EStringView(model.data(), model.length()));
+    EXPECT_TRUE(rope == ERope(EStringView(model.data(), model.length())));
+
+    ERope copy = rope;
+    copy.insert(0, U'x');
+
+    EXPECT_TRUE(copy != rope);
+
+    EXPECT_EQ(copy.length(), rope.length() + 1);
+    EXPECT_EQ(copy[1], rope[0]);
+  }
+
+}
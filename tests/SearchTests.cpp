@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include <EString.h>
+
+namespace SearchTests {
+
+  TEST(SearchTests, ContainsAtTheEnd) {
+    EString string = U"Hello, world!";
+
+    EXPECT_TRUE(string.contains(U"world!"));
+    EXPECT_TRUE(string.contains(U"!"));
+    EXPECT_TRUE(string.contains(U'!'));
+    EXPECT_FALSE(string.contains(U"world?"));
+  }
+
+  TEST(SearchTests, FindShortNeedle) {
+    EString string = U"the quick brown fox jumps over the lazy dog";
+
+    EXPECT_EQ(string.find(U"the"), 0);
+    EXPECT_EQ(string.find(U"the", 1), 31);
+    EXPECT_EQ(string.find(U"dog"), 40);
+    EXPECT_EQ(string.find(U'z'), 37);
+    EXPECT_EQ(string.find(U"cat"), EString::npos);
+    EXPECT_EQ(string.find(U"", 5), 5);
+    EXPECT_EQ(string.rfind(U"the"), 31);
+    EXPECT_EQ(string.rfind(U"the", 30), 0);
+    EXPECT_EQ(string.rfind(U'o'), 41);
+  }
+
+  TEST(SearchTests, FindLongNeedle) {
+    EString needle = U"Съешь же ещё этих мягких французских булок";
+    EString string = EString(U"Начало. ") + needle + U" Середина. " + needle + U" Конец.";
+
+    EXPECT_EQ(string.find(needle), 8);
+    EXPECT_EQ(string.find(needle, 9), 8 + needle.length() + 11);
+    EXPECT_EQ(string.rfind(needle), 8 + needle.length() + 11);
+    EXPECT_EQ(string.rfind(needle, 60), 8);
+    EXPECT_EQ(string.find(U"Съешь же ещё этих мягких французских булочек"), EString::npos);
+  }
+
+  TEST(SearchTests, FindAllAndCount) {
+    EString string = U"abababab";
+
+    EXPECT_EQ(string.find_all(U"aba"), (std::vector<size_t>{ 0, 4 }));
+    EXPECT_EQ(string.count(U"ab"), 4);
+    EXPECT_EQ(string.count(U'b'), 4);
+    EXPECT_EQ(string.count(U"abc"), 0);
+    EXPECT_EQ(string.count(U""), 0);
+    EXPECT_TRUE(string.find_all(U"c").empty());
+  }
+
+  TEST(SearchTests, MatchesStdFind) {
+    // Small alphabet gives many partial matches, characters differing only above low byte
+    //  share shift table entries.
+    const char32_t alphabet[] = { U'a', U'b', U'š', U'\U0001F361' };
+
+    std::mt19937 random(12345);
+
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+      std::u32string haystack, needle;
+
+      size_t haystack_length = random() % 200;
+      size_t needle_length = 1 + random() % 40;
+
+      for (size_t index = 0; index < haystack_length; ++index)
+        haystack.push_back(alphabet[random() % 4]);
+
+      // Take needle from haystack most of the time, so it's found.
+      if (haystack_length >= needle_length && random() % 4 != 0)
+        needle = haystack.substr(random() % (haystack_length - needle_length + 1), needle_length);
+      else
+        for (size_t index = 0; index < needle_length; ++index)
+          needle.push_back(alphabet[random() % 4]);
+
+      EString string = haystack.c_str();
+      EStringView needle_view(needle.data(), needle.length());
+      size_t start = random() % (haystack_length + 1);
+
+      EXPECT_EQ(string.find(needle_view, start), haystack.find(needle, start));
+      EXPECT_EQ(string.rfind(needle_view, start), haystack.rfind(needle, start));
+      EXPECT_EQ(string.rfind(needle_view), haystack.rfind(needle));
+    }
+  }
+
+  TEST(SearchTests, ConstantEvaluated) {
+    constexpr EStringView string = U"constexpr search";
+
+    static_assert(string.find(U"search") == 10);
+    static_assert(string.rfind(U's') == 10);
+    static_assert(string.count(U"c") == 2);
+  }
+
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <vector>
+
+#include <EString.h>
+#include <EStringSegmentation.h>
+
+namespace SegmentationTests {
+
+  template <typename Segments>
+  std::vector<EString> segment_strings(EStringView string, Segments segments) {
+    std::vector<EString> strings;
+
+    for (ESegment segment : segments)
+      strings.push_back(EString(string.substr(segment.begin, segment.length())));
+
+    return strings;
+  }
+
+  TEST(SegmentationTests, Graphemes) {
+    // Combining mark, emoji ZWJ sequence with skin tone, flag, CR LF and Hangul jamo.
+    EString string = U"e\u0301\U0001F469\U0001F3FD\u200D\U0001F4BB\U0001F1FA\U0001F1F8\r\n\u1100\u1161\u11A8a";
+
+    std::vector<EString> expected_strings = {
+      U"e\u0301", U"\U0001F469\U0001F3FD\u200D\U0001F4BB", U"\U0001F1FA\U0001F1F8", U"\r\n", U"\u1100\u1161\u11A8", U"a"
+    };
+
+    EXPECT_TRUE(segment_strings(string, egraphemes(string)) == expected_strings);
+    EXPECT_EQ(egraphemes(string).count(), 6);
+  }
+
+  TEST(SegmentationTests, RegionalIndicatorPairs) {
+    // Three flags and one single regional indicator.
+    EString string = U"\U0001F1FA\U0001F1F8\U0001F1E9\U0001F1EA\U0001F1EF\U0001F1F5\U0001F1EB";
+
+    EXPECT_EQ(egraphemes(string).count(), 4);
+    EXPECT_EQ(ewords(string).count(), 4);
+  }
+
+  TEST(SegmentationTests, TruncateByGraphemes) {
+    EString string = U"Zoe\u0308 \U0001F44D\U0001F3FB!";
+
+    EXPECT_TRUE(egraphemes(string).prefix(3) == U"Zoe\u0308");
+    EXPECT_TRUE(egraphemes(string).prefix(5) == U"Zoe\u0308 \U0001F44D\U0001F3FB");
+    EXPECT_TRUE(egraphemes(string).prefix(100) == string);
+    EXPECT_TRUE(egraphemes(string).prefix(0).is_empty());
+  }
+
+  TEST(SegmentationTests, Words) {
+    EString string = U"Don't pay $1,000.50 for e.g. foo_bar א\"ב カタカナ!";
+
+    std::vector<EString> expected_strings = {
+      U"Don't", U" ", U"pay", U" ", U"$", U"1,000.50", U" ", U"for", U" ", U"e.g", U".", U" ", U"foo_bar",
+      U" ", U"א\"ב", U" ", U"カタカナ", U"!"
+    };
+
+    EXPECT_TRUE(segment_strings(string, ewords(string)) == expected_strings);
+  }
+
+  TEST(SegmentationTests, WordsIgnoreFormatAndExtend) {
+    // Soft hyphen and combining marks don't break words, spaces are joined.
+    EString string = U"co\u00ADope\u0301rate   now\r\n";
+
+    std::vector<EString> expected_strings = { U"co\u00ADope\u0301rate", U"   ", U"now", U"\r\n" };
+
+    EXPECT_TRUE(segment_strings(string, ewords(string)) == expected_strings);
+  }
+
+  TEST(SegmentationTests, Sentences) {
+    EString string = U"Mr. Smith paid 3.50 for it, i.e. a lot. \"Really?!\" he asked.\nU.S.A. is big. Yes";
+
+    std::vector<EString> expected_strings = {
+      U"Mr. ", U"Smith paid 3.50 for it, i.e. a lot. ", U"\"Really?!\" ", U"he asked.\n", U"U.S.A. is big. ", U"Yes"
+    };
+
+    EXPECT_TRUE(segment_strings(string, esentences(string)) == expected_strings);
+  }
+
+  TEST(SegmentationTests, EmptyString) {
+    EString string;
+
+    EXPECT_TRUE(egraphemes(string).begin() == egraphemes(string).end());
+    EXPECT_EQ(ewords(string).count(), 0);
+    EXPECT_EQ(esentences(string).count(), 0);
+  }
+
+  TEST(SegmentationTests, SegmentsCoverString) {
+    EString string = U"U\u0308ber \U0001F3F3\uFE0F\u200D\U0001F308 nai\u0308ve. Тест\u0301! क्षि 1.5";
+
+    for (auto segments : { egraphemes(string), egraphemes(EStringView(string).substr(3)) }) {
+      size_t end = 0;
+
+      for (ESegment segment : segments) {
+        EXPECT_EQ(segment.begin, end);
+        EXPECT_GT(segment.end, segment.begin);
+        end = segment.end;
+      }
+    }
+
+    auto words = ewords(string);
+    EXPECT_EQ(static_cast<size_t>(std::distance(words.begin(), words.end())), words.count());
+  }
+
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <EStringShared.h>
+
+namespace SharedStringTests {
+
+  TEST(SharedStringTests, MoveFromEStringKeepsBuffer) {
+    EString string = U"Привет, мир! Long enough to be on heap.";
+    const char32_t* previous_data = string.data();
+
+    ESharedString shared = std::move(string);
+
+    EXPECT_EQ(shared.data(), previous_data);
+    EXPECT_EQ(shared.use_count(), 1);
+  }
+
+  TEST(SharedStringTests, CopiesShareBuffer) {
+    ESharedString shared = U"Привет, мир!";
+
+    {
+      ESharedString copy = shared;
+
+      EXPECT_EQ(copy.data(), shared.data());
+      EXPECT_EQ(shared.use_count(), 2);
+    }
+
+    EXPECT_EQ(shared.use_count(), 1);
+  }
+
+  TEST(SharedStringTests, ReadApi) {
+    ESharedString shared = u8"Привет, мир!";
+
+    EXPECT_EQ(shared.length(), 12);
+    EXPECT_EQ(shared[0], U'П');
+    EXPECT_TRUE(shared.startswith(U"Привет"));
+    EXPECT_TRUE(shared.startswith(u8"Привет"));
+    EXPECT_TRUE(shared.endswith(U"мир!"));
+    EXPECT_TRUE(shared.contains(u8"мир"));
+    EXPECT_EQ(shared.encode<char16_t>(), u"Привет, мир!");
+    EXPECT_TRUE(shared == U"Привет, мир!");
+    EXPECT_TRUE(EString(U"Привет, мир!") == shared);
+  }
+
+  TEST(SharedStringTests, EmptyString) {
+    ESharedString shared;
+
+    EXPECT_TRUE(shared.is_empty());
+    EXPECT_EQ(shared.use_count(), 0);
+    EXPECT_EQ(shared.c_str()[0], 0);
+  }
+
+  TEST(SharedStringTests, ReadFromManyThreads) {
+    ESharedString shared = U"Payload shared between worker threads";
+    std::vector<std::thread> threads;
+    std::atomic<int> matches = 0;
+
+    for (int i = 0; i < 8; ++i) {
+      threads.emplace_back([shared, &matches] {
+        for (int j = 0; j < 1000; ++j) {
+          ESharedString copy = shared;
+
+          if (copy.contains(U"worker"))
+            ++matches;
+        }
+      });
+    }
+
+    for (std::thread& thread : threads)
+      thread.join();
+
+    EXPECT_EQ(matches, 8000);
+    EXPECT_EQ(shared.use_count(), 1);
+  }
+
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <EStringSort.h>
+
+namespace OrderingTests {
+
+  TEST(OrderingTests, CodePointOrder) {
+    EString first = U"apple";
+    EString second = U"apricot";
+
+    EXPECT_TRUE(first < second);
+    EXPECT_TRUE(second > first);
+    EXPECT_TRUE(first <= first);
+    EXPECT_TRUE((first <=> EString(U"apple")) == 0);
+
+    // Code point order, not alphabetical one.
+    EXPECT_TRUE(EString(U"Zebra") < EString(U"apple"));
+    EXPECT_TRUE(EString(U"яблоко") < EString(U"\U0001F600"));
+  }
+
+  TEST(OrderingTests, PrefixIsLess) {
+    EString string = U"Hello, world!";
+
+    EXPECT_TRUE(EString(U"Hello") < string);
+    EXPECT_TRUE(EString() < string);
+    EXPECT_TRUE(string > U"Hello, world");
+    EXPECT_TRUE(string < EStringView(U"Hello, world!!"));
+    EXPECT_EQ(string.compare(U"Hello, world!"), 0);
+    EXPECT_EQ(string.compare(U"Hello, world"), 1);
+    EXPECT_EQ(string.compare(U"Hello, worle"), -1);
+  }
+
+  TEST(OrderingTests, MismatchInLongStrings) {
+    std::u32string text(1000, U'x');
+
+    for (size_t index = 0; index < text.length(); index += 37) {
+      std::u32string greater_text = text;
+      greater_text[index] = U'y';
+
+      EString string = text.c_str();
+      EString greater_string = greater_text.c_str();
+
+      EXPECT_TRUE(string < greater_string);
+      EXPECT_TRUE(string != greater_string);
+      EXPECT_TRUE(EStringView(greater_string) > EStringView(string));
+    }
+  }
+
+  TEST(OrderingTests, MapKeys) {
+    std::map<EString, int> map;
+
+    map[U"banana"] = 2;
+    map[U"apple"] = 1;
+    map[U"cherry"] = 3;
+
+    int expected_value = 1;
+
+    for (auto const& [key, value] : map)
+      EXPECT_EQ(value, expected_value++);
+  }
+
+}
+
+namespace SortTests {
+
+  std::vector<EString> random_strings(size_t count, uint32_t seed) {
+    // Few short prefixes and small alphabet make many duplicates and long common prefixes.
+    const char32_t* prefixes[] = { U"", U"http://example.com/", U"http://example.com/path/", U"\U0001F600\U0001F600" };
+    const char32_t alphabet[] = { U'a', U'b', U'z', U'я', U'\U0001F600', U'\U0010FFFF', 0x7FFFFFFF, 0xFFFFFFFF };
+
+    std::mt19937 random(seed);
+    std::vector<EString> strings;
+
+    for (size_t index = 0; index < count; ++index) {
+      EString string = prefixes[random() % 4];
+      size_t length = random() % 12;
+
+      for (size_t character_index = 0; character_index < length; ++character_index)
+        string.append(alphabet[random() % (random() % 16 == 0 ? 8 : 4)]);
+
+      strings.push_back(std::move(string));
+    }
+
+    return strings;
+  }
+
+  TEST(SortTests, SortsLikeComparison) {
+    for (size_t count : { 0, 1, 2, 31, 100, 5000 }) {
+      std::vector<EString> strings = random_strings(count, static_cast<uint32_t>(count));
+      std::vector<EString> expected_strings = strings;
+
+      esort(strings);
+      std::sort(expected_strings.begin(), expected_strings.end());
+
+      EXPECT_TRUE(strings == expected_strings) << "count " << count;
+    }
+  }
+
+  TEST(SortTests, LongCommonPrefix) {
+    std::u32string prefix(3000, U'п');
+    std::vector<EString> strings;
+
+    for (int index = 99; index >= 0; --index)
+      strings.push_back(EString((prefix + static_cast<char32_t>(U'a' + index % 26) + std::u32string(index, U'b')).c_str()));
+
+    std::vector<EString> expected_strings = strings;
+
+    esort(strings);
+    std::sort(expected_strings.begin(), expected_strings.end());
+
+    EXPECT_TRUE(strings == expected_strings);
+  }
+
+  TEST(SortTests, PrefixChain) {
+    // Every string is prefix of the next one, so every radix pass splits off a single string.
+    std::vector<EString> strings;
+
+    for (size_t length = 1; length <= 3000; ++length)
+      strings.push_back(EString(std::u32string(length, U'a').c_str()));
+
+    std::shuffle(strings.begin(), strings.end(), std::mt19937(3000));
+
+    std::vector<EString> expected_strings = strings;
+
+    esort(strings);
+    std::sort(expected_strings.begin(), expected_strings.end());
+
+    EXPECT_TRUE(strings == expected_strings);
+  }
+
+  TEST(SortTests, SortViews) {
+    std::vector<EString> strings = random_strings(1000, 7);
+    std::vector<EStringView> views(strings.begin(), strings.end());
+
+    esort(views);
+
+    EXPECT_TRUE(std::is_sorted(views.begin(), views.end()));
+  }
+
+}
@@ -46,6 +46,14 @@ namespace InsertingTests {
       EXPECT_STREQ(ESTR(string), "Hello, world!");
     }
 
+    TEST(StringsInsertingTests, InsertingInvalidEncodedStringKeepsString) {
+      EString string = "Hello, world!";
+      const char8_t invalid_string[] = { u8'a', u8'b', 0xC3, u8'(', 0 };
+
+      EXPECT_THROW(string.insert(5, invalid_string), encoding_failed);
+      EXPECT_STREQ(ESTR(string), "Hello, world!");
+    }
+
   }
 
   namespace CharactersInsertingTests {
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <EString.h>
+
+namespace StringViewTests {
+
+  TEST(StringViewTests, ViewOfEString) {
+    EString string = U"Привет, мир!";
+    EStringView view = string;
+
+    EXPECT_EQ(view.data(), string.data());
+    EXPECT_EQ(view.length(), string.length());
+    EXPECT_TRUE(view == string);
+    EXPECT_TRUE(string == view);
+  }
+
+  TEST(StringViewTests, Substr) {
+    EString string = U"Hello, world!";
+    EStringView view = EStringView(string).substr(7, 5);
+
+    EXPECT_EQ(view.data(), string.data() + 7);
+    EXPECT_TRUE(view == U"world");
+    EXPECT_TRUE(EStringView(string).substr(7) == U"world!");
+    EXPECT_TRUE(EStringView(string).substr(20).is_empty());
+    EXPECT_TRUE(string.substr(0, 5) == U"Hello");
+  }
+
+  TEST(StringViewTests, Find) {
+    EStringView view = U"abcabcab";
+
+    EXPECT_EQ(view.find(U'c'), 2);
+    EXPECT_EQ(view.find(U"cab"), 2);
+    EXPECT_EQ(view.find(U"cab", 3), 5);
+    EXPECT_EQ(view.find(U"ab", 6), 6);
+    EXPECT_EQ(view.find(U"abd"), EStringView::npos);
+    EXPECT_EQ(view.rfind(U'c'), 5);
+    EXPECT_EQ(view.rfind(U"abc"), 3);
+  }
+
+  TEST(StringViewTests, StartsAndEndsWith) {
+    EString string = U"Hello, world!";
+    EStringView view = string;
+
+    EXPECT_TRUE(view.startswith(U"Hello"));
+    EXPECT_FALSE(view.startswith(U"world"));
+    EXPECT_TRUE(view.endswith(U"world!"));
+    EXPECT_TRUE(string.startswith(view.substr(0, 3)));
+    EXPECT_TRUE(string.contains(view.substr(3, 4)));
+  }
+
+  TEST(StringViewTests, Encode) {
+    EString string = U"Привет, мир!";
+
+    EXPECT_EQ(EStringView(string).substr(8, 3).encode<char16_t>(), u"мир");
+  }
+
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <EString.h>
+
+namespace TranscodeTests {
+
+  // Mix of ASCII runs longer than SIMD blocks and characters of every utf8 size.
+  static std::u8string mixed_utf8_string() {
+    std::u8string string;
+
+    for (int index = 0; index < 20; ++index) {
+      string += u8"The quick brown fox jumps over the lazy dog. ";
+      string += u8"Съешь же ещё этих мягких французских булок. ";
+      string += u8"日本語のテキスト \U0001F600\U0001F361 ";
+    }
+
+    return string;
+  }
+
+  TEST(TranscodeTests, Utf8ToUtf16) {
+    std::u8string utf8_string = mixed_utf8_string();
+    std::u16string expected_result = EString(utf8_string).encode<char16_t>();
+
+    EXPECT_TRUE(transcode<char16_t>(utf8_string) == expected_result);
+    EXPECT_EQ((transcoded_length<char8_t, char16_t>(utf8_string.data(), utf8_string.length())), expected_result.length());
+    EXPECT_GE((max_transcoded_length<char8_t, char16_t>(utf8_string.length())), expected_result.length());
+  }
+
+  TEST(TranscodeTests, Utf16ToUtf8) {
+    std::u8string utf8_string = mixed_utf8_string();
+    std::u16string utf16_string = EString(utf8_string).encode<char16_t>();
+
+    EXPECT_TRUE(transcode<char8_t>(utf16_string) == utf8_string);
+    EXPECT_EQ((transcoded_length<char16_t, char8_t>(utf16_string.data(), utf16_string.length())), utf8_string.length());
+    EXPECT_GE((max_transcoded_length<char16_t, char8_t>(utf16_string.length())), utf8_string.length());
+  }
+
+  TEST(TranscodeTests, Utf8AndWide) {
+    std::u8string utf8_string = mixed_utf8_string();
+    std::wstring wide_string = EString(utf8_string).encode<wchar_t>();
+
+    EXPECT_TRUE(transcode<wchar_t>(utf8_string) == wide_string);
+    EXPECT_TRUE(transcode<char8_t>(wide_string) == utf8_string);
+  }
+
+  TEST(TranscodeTests, Utf32AndOtherPairs) {
+    std::u8string utf8_string = mixed_utf8_string();
+    std::u32string utf32_string = EString(utf8_string).encode<char32_t>();
+    std::u16string utf16_string = EString(utf8_string).encode<char16_t>();
+
+    EXPECT_TRUE(transcode<char32_t>(utf8_string) == utf32_string);
+    EXPECT_TRUE(transcode<char8_t>(utf32_string) == utf8_string);
+    EXPECT_TRUE(transcode<char32_t>(utf16_string) == utf32_string);
+    EXPECT_TRUE(transcode<char16_t>(utf32_string) == utf16_string);
+    EXPECT_TRUE(transcode<char8_t>("plain ascii") == u8"plain ascii");
+  }
+
+  TEST(TranscodeTests, IntoBuffer) {
+    const char8_t utf8_string[] = u8"abc\U0001F600";
+    char16_t buffer[8] = {};
+
+    size_t length = transcode(utf8_string, 7, buffer);
+
+    EXPECT_EQ(length, 5);
+    EXPECT_TRUE(std::u16string(buffer, length) == u"abc\U0001F600");
+  }
+
+  TEST(TranscodeTests, ConstantEvaluated) {
+    constexpr size_t length = [] {
+      char16_t buffer[4] = {};
+      return transcode(u8"ы\U0001F600", 6, buffer);
+    }();
+
+    EXPECT_EQ(length, 3);
+  }
+
+  TEST(TranscodeTests, Errors) {
+    std::u8string truncated_utf8 = u8"abc\U0001F600";
+    truncated_utf8.pop_back();
+
+    std::u16string truncated_utf16 = u"abc\U0001F600";
+    truncated_utf16.pop_back();
+
+    EXPECT_THROW(transcode<char16_t>(truncated_utf8), encoding_failed);
+    EXPECT_THROW(transcode<char8_t>(truncated_utf16), encoding_failed);
+    EXPECT_THROW(transcode<char>(u"не ascii"), encoding_failed);
+  }
+
+  TEST(TranscodeTests, RejectsInvalidCharacters) {
+    const char8_t overlong_slash[] = { 0xC0, 0xAF, 0 };
+    const char8_t encoded_surrogate[] = { 0xED, 0xA0, 0x80, 0 };
+    const char16_t unpaired_surrogate[] = { u'a', 0xDC00, u'b', 0 };
+    const char32_t utf32_surrogates[] = { 0xD800, 0xD801, 0xD802, 0xD803, 0 };
+
+    EXPECT_THROW(transcode<char16_t>(overlong_slash), encoding_failed);
+    EXPECT_THROW(transcode<char32_t>(overlong_slash), encoding_failed);
+    EXPECT_THROW(transcode<char16_t>(encoded_surrogate), encoding_failed);
+    EXPECT_THROW(transcode<char8_t>(unpaired_surrogate), encoding_failed);
+    EXPECT_THROW(transcode<char32_t>(unpaired_surrogate), encoding_failed);
+    EXPECT_THROW(transcode<char8_t>(utf32_surrogates), encoding_failed);
+    EXPECT_THROW(transcode<char16_t>(utf32_surrogates), encoding_failed);
+
+    try {
+      transcode<char16_t>(overlong_slash);
+    }
+    catch (encoding_failed const& error) {
+      EXPECT_NE(std::string(error.what()).find("Overlong character encoding."), std::string::npos);
+    }
+  }
+
+}
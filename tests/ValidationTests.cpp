@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include <EString.h>
+
+namespace ValidationTests {
+
+  // Straightforward validator, that decodes code points and checks their ranges.
+  static size_t reference_error_offset(std::u8string const& string) {
+    size_t index = 0;
+
+    while (index < string.length()) {
+      char8_t lead_byte = string[index];
+      size_t length = lead_byte < 0x80 ? 1 : lead_byte < 0xC0 ? 0 : lead_byte < 0xE0 ? 2 : lead_byte < 0xF0 ? 3 : lead_byte < 0xF8 ? 4 : 0;
+
+      if (length == 0 || index + length > string.length())
+        return index;
+
+      char32_t code_point = length == 1 ? lead_byte : lead_byte & (0x7F >> length);
+
+      for (size_t byte_index = 1; byte_index < length; ++byte_index) {
+        if ((string[index + byte_index] & 0xC0) != 0x80)
+          return index;
+
+        code_point = (code_point << 6) | (string[index + byte_index] & 0x3F);
+      }
+
+      constexpr char32_t min_code_points[] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+      if (code_point < min_code_points[length] || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF))
+        return index;
+
+      index += length;
+    }
+
+    return string.length();
+  }
+
+  static std::u8string long_text() {
+    std::u8string string;
+
+    for (int index = 0; index < 10; ++index)
+      string += u8"ASCII text long enough for SIMD blocks, Кириллица, 日本語, \U0001F600\U0010FFFF. ";
+
+    return string;
+  }
+
+  TEST(ValidationTests, ValidUtf8) {
+    std::u8string string = long_text();
+    EValidationResult result = validate<char8_t>(string);
+
+    EXPECT_TRUE(result.is_valid);
+    EXPECT_EQ(result.error_offset, string.length());
+    EXPECT_EQ(result.error_kind, EEncodingError::none);
+  }
+
+  TEST(ValidationTests, Utf8ErrorKinds) {
+    struct Case {
+      std::u8string string;
+      size_t error_offset;
+      EEncodingError error_kind;
+    };
+
+    const Case cases[] = {
+      { u8"ab\x80", 2, EEncodingError::unexpected_continuation },
+      { u8"ab\xD0", 2, EEncodingError::truncated },
+      { u8"\xE2\x82", 0, EEncodingError::truncated },
+      { u8"a\xD0" "b", 1, EEncodingError::missing_continuation },
+      { u8"\xC0\xAF", 0, EEncodingError::overlong },
+      { u8"\xE0\x80\xAF", 0, EEncodingError::overlong },
+      { u8"\xF0\x80\x80\xAF", 0, EEncodingError::overlong },
+      { u8"x\xED\xA0\x80", 1, EEncodingError::surrogate },
+      { u8"\xF4\x90\x80\x80", 0, EEncodingError::too_large },
+      { u8"\xF8\x88\x80\x80\x80", 0, EEncodingError::too_large },
+    };
+
+    for (Case const& test_case : cases) {
+      EValidationResult result = validate<char8_t>(test_case.string);
+
+      EXPECT_FALSE(result.is_valid);
+      EXPECT_EQ(result.error_offset, test_case.error_offset);
+      EXPECT_EQ(result.error_kind, test_case.error_kind);
+    }
+  }
+
+  TEST(ValidationTests, Utf8ErrorInLongText) {
+    std::u8string valid_string = long_text();
+
+    // Error at every position of long text, so it's found both in SIMD blocks and in scalar tail.
+    for (size_t position = 0; position < valid_string.length(); position += 7) {
+      std::u8string string = valid_string;
+      string.insert(string.begin() + static_cast<std::ptrdiff_t>(position), { char8_t(0xE2), char8_t(0x28) });
+
+      EValidationResult result = validate<char8_t>(string);
+
+      EXPECT_FALSE(result.is_valid);
+      EXPECT_EQ(result.error_offset, reference_error_offset(string));
+    }
+  }
+
+  TEST(ValidationTests, Utf8RandomInput) {
+    std::mt19937 random(42);
+    std::u8string valid_string = long_text();
+
+    for (int iteration = 0; iteration < 3000; ++iteration) {
+      std::u8string string = valid_string.substr(random() % 64, 40 + random() % 200);
+
+      // Few random bytes, mostly from ranges near valid ones.
+      for (int count = random() % 3; count > 0; --count)
+        string[random() % string.length()] = static_cast<char8_t>(0x70 + random() % 0x90);
+
+      EValidationResult result = validate<char8_t>(string);
+      size_t expected_offset = reference_error_offset(string);
+
+      ASSERT_EQ(result.is_valid, expected_offset == string.length());
+      ASSERT_EQ(result.error_offset, expected_offset);
+    }
+  }
+
+  TEST(ValidationTests, Utf16) {
+    std::u16string string = u"Text with pair \U0001F600 and more text after it.";
+
+    EXPECT_TRUE(validate<char16_t>(string).is_valid);
+
+    std::u16string lone_low = string;
+    lone_low[15] = 0xDE00;
+
+    EValidationResult result = validate<char16_t>(lone_low);
+
+    EXPECT_FALSE(result.is_valid);
+    EXPECT_EQ(result.error_offset, 15);
+    EXPECT_EQ(result.error_kind, EEncodingError::unpaired_surrogate);
+
+    std::u16string truncated = u"abc\U0001F600";
+    truncated.pop_back();
+
+    result = validate<char16_t>(truncated);
+
+    EXPECT_EQ(result.error_offset, 3);
+    EXPECT_EQ(result.error_kind, EEncodingError::truncated);
+  }
+
+  TEST(ValidationTests, Utf32AndAscii) {
+    const char32_t utf32_string[] = { U'a', 0xD800, 0x110000 };
+
+    EXPECT_EQ(validate(utf32_string, 1).error_kind, EEncodingError::none);
+    EXPECT_EQ(validate(utf32_string, 2).error_kind, EEncodingError::surrogate);
+    EXPECT_EQ(validate(utf32_string + 2, 1).error_kind, EEncodingError::too_large);
+
+    EXPECT_TRUE(validate<char>("plain").is_valid);
+    EXPECT_EQ(validate<char>("ab\xC3\xA9").error_offset, 2);
+  }
+
+  TEST(ValidationTests, ConstantEvaluated) {
+    static_assert(validate<char8_t>(u8"ok \U0001F600").is_valid);
+    static_assert(validate<char8_t>(u8"\xED\xA0\x80").error_kind == EEncodingError::surrogate);
+  }
+
+  TEST(ValidationTests, DecodeRejectsInvalidInput) {
+    EString string;
+
+    EXPECT_THROW(string.decode<char8_t>(u8"\xED\xA0\x80"), encoding_failed);
+    EXPECT_THROW(string.decode<char8_t>(u8"\xC0\xAF"), encoding_failed);
+    EXPECT_THROW(string.decode<char16_t>(u"\xDE00"), encoding_failed);
+
+    string.decode<char8_t>(long_text());
+
+    EXPECT_TRUE(string.encode<char8_t>() == long_text());
+  }
+
+}
@@ -0,0 +1,478 @@
+"""
+Generate 'EStringUnicodeData.inl', tables of Unicode character properties, from Unicode Character Database.
+
+Usage: python3 generate_unicode_data.py <UCD directory> [output file]
+
+UCD directory is extracted 'UCD.zip' from https://www.unicode.org/Public/<version>/ucd/, with 'auxiliary' and 'emoji'
+ subdirectories for break properties.
+Output is written to 'EStringUnicodeData.inl' in the root of repository by default.
+
+Every property is stored in two-stage table (see 'EStringUnicode.h'): code points are split to blocks of
+ 128 characters, first stage maps block number to unique block of second stage, that maps character to record.
+"""
+
+import os
+import re
+import sys
+
+MAX_CODE_POINT = 0x10FFFF
+BLOCK_SHIFT = 7
+BLOCK_SIZE = 1 << BLOCK_SHIFT
+
+CASE_IS_CASED = 1
+CASE_IS_CASE_IGNORABLE = 2
+
+NORMALIZATION_NFD_NO = 1
+NORMALIZATION_NFC_NO = 2
+NORMALIZATION_NFC_MAYBE = 4
+NORMALIZATION_NFKD_NO = 8
+NORMALIZATION_NFKC_NO = 16
+NORMALIZATION_NFKC_MAYBE = 32
+
+# Values of break properties in order of '_EGraphemeBreak', '_EWordBreak' and '_ESentenceBreak' of 'EStringUnicode.h'.
+GRAPHEME_BREAK_VALUES = [
+    'Other', 'CR', 'LF', 'Control', 'Extend', 'ZWJ', 'Regional_Indicator', 'Prepend', 'SpacingMark', 'L', 'V', 'T', 'LV', 'LVT'
+]
+WORD_BREAK_VALUES = [
+    'Other', 'CR', 'LF', 'Newline', 'Extend', 'ZWJ', 'Regional_Indicator', 'Format', 'Katakana', 'Hebrew_Letter', 'ALetter',
+    'Single_Quote', 'Double_Quote', 'MidNumLet', 'MidLetter', 'MidNum', 'Numeric', 'ExtendNumLet', 'WSegSpace'
+]
+SENTENCE_BREAK_VALUES = [
+    'Other', 'CR', 'LF', 'Extend', 'Sep', 'Format', 'Sp', 'Lower', 'Upper', 'OLetter', 'Numeric', 'ATerm', 'SContinue', 'STerm', 'Close'
+]
+
+# Packing of break properties to value of table, same as in 'EStringUnicode.h'.
+WORD_BREAK_SHIFT = 4
+SENTENCE_BREAK_SHIFT = 9
+BREAK_IS_EXTENDED_PICTOGRAPHIC = 1 << 13
+
+HANGUL_SYLLABLE_BASE = 0xAC00
+HANGUL_SYLLABLES_COUNT = 11172
+HANGUL_L_BASE = 0x1100
+HANGUL_V_BASE = 0x1161
+HANGUL_T_BASE = 0x11A7
+HANGUL_V_COUNT = 21
+HANGUL_T_COUNT = 28
+
+
+def parse_code_points(field):
+    return [int(code_point, 16) for code_point in field.split()]
+
+
+def read_data_lines(path):
+    """Yield fields of every data line, without comments."""
+    with open(path, encoding='utf-8') as file:
+        for line in file:
+            line = line.split('#', 1)[0].strip()
+
+            if line:
+                yield [field.strip() for field in line.split(';')]
+
+
+def read_unicode_version(ucd_directory):
+    with open(os.path.join(ucd_directory, 'ReadMe.txt'), encoding='utf-8') as file:
+        match = re.search(r'Version (\d+\.\d+\.\d+)', file.read())
+
+    return match.group(1) if match else 'unknown'
+
+
+def read_unicode_data(ucd_directory):
+    """Get dictionary of code point to fields of 'UnicodeData.txt'. Ranges ('<..., First>') are expanded."""
+    characters = {}
+    range_first = None
+
+    for fields in read_data_lines(os.path.join(ucd_directory, 'UnicodeData.txt')):
+        code_point = int(fields[0], 16)
+
+        if fields[1].endswith(', First>'):
+            range_first = code_point
+            continue
+
+        if fields[1].endswith(', Last>'):
+            for range_code_point in range(range_first, code_point + 1):
+                characters[range_code_point] = fields
+
+            continue
+
+        characters[code_point] = fields
+
+    return characters
+
+
+def read_property_ranges(path, wanted_value=None):
+    """Get dictionary of code point to value of property in file of '<range> ; <value>' lines."""
+    values = {}
+
+    for fields in read_data_lines(path):
+        value = fields[1] if len(fields) == 2 else '; '.join(fields[1:])
+
+        if wanted_value is not None and value != wanted_value:
+            continue
+
+        first, _, last = fields[0].partition('..')
+        first = int(first, 16)
+        last = int(last, 16) if last else first
+
+        for code_point in range(first, last + 1):
+            values[code_point] = value
+
+    return values
+
+
+def build_case_records(ucd_directory, characters):
+    """Get list of case records and record index of every code point."""
+    lower = {}
+    upper = {}
+    fold = {}
+
+    for code_point, fields in characters.items():
+        if fields[12]:
+            upper[code_point] = [int(fields[12], 16)]
+
+        if fields[13]:
+            lower[code_point] = [int(fields[13], 16)]
+
+    # Full mappings replace simple ones. Conditional mappings (final sigma, languages) are handled by code.
+    for fields in read_data_lines(os.path.join(ucd_directory, 'SpecialCasing.txt')):
+        if len(fields) > 4 and fields[4]:
+            continue
+
+        code_point = int(fields[0], 16)
+        lower[code_point] = parse_code_points(fields[1])
+        upper[code_point] = parse_code_points(fields[3])
+
+    # Full case folding: common and full mappings.
+    for fields in read_data_lines(os.path.join(ucd_directory, 'CaseFolding.txt')):
+        if fields[1] in ('C', 'F'):
+            fold[int(fields[0], 16)] = parse_code_points(fields[2])
+
+    core_properties_path = os.path.join(ucd_directory, 'DerivedCoreProperties.txt')
+    cased = read_property_ranges(core_properties_path, 'Cased')
+    case_ignorable = read_property_ranges(core_properties_path, 'Case_Ignorable')
+
+    expansions = [0]
+    expansion_offsets = {}
+
+    def add_expansion(mapping):
+        key = tuple(mapping)
+
+        if key not in expansion_offsets:
+            expansion_offsets[key] = len(expansions)
+            expansions.append(len(mapping))
+            expansions.extend(mapping)
+
+        return expansion_offsets[key]
+
+    def mapping_fields(code_point, mappings):
+        mapping = mappings.get(code_point, [code_point])
+
+        if len(mapping) == 1:
+            return mapping[0] - code_point, 0
+
+        return 0, add_expansion(mapping)
+
+    records = [(0, 0, 0, 0, 0, 0, 0)]
+    record_indices = {records[0]: 0}
+    character_records = [0] * (MAX_CODE_POINT + 1)
+
+    for code_point in range(MAX_CODE_POINT + 1):
+        lower_delta, lower_expansion = mapping_fields(code_point, lower)
+        upper_delta, upper_expansion = mapping_fields(code_point, upper)
+        fold_delta, fold_expansion = mapping_fields(code_point, fold)
+
+        flags = 0
+
+        if code_point in cased:
+            flags |= CASE_IS_CASED
+
+        if code_point in case_ignorable:
+            flags |= CASE_IS_CASE_IGNORABLE
+
+        record = (lower_delta, upper_delta, fold_delta, lower_expansion, upper_expansion, fold_expansion, flags)
+
+        if record not in record_indices:
+            record_indices[record] = len(records)
+            records.append(record)
+
+        character_records[code_point] = record_indices[record]
+
+    assert len(expansions) < 0x10000
+
+    return records, character_records, expansions
+
+
+def decompose_hangul_syllable(code_point):
+    index = code_point - HANGUL_SYLLABLE_BASE
+    l_index, index = divmod(index, HANGUL_V_COUNT * HANGUL_T_COUNT)
+    v_index, t_index = divmod(index, HANGUL_T_COUNT)
+
+    decomposition = [HANGUL_L_BASE + l_index, HANGUL_V_BASE + v_index]
+
+    if t_index != 0:
+        decomposition.append(HANGUL_T_BASE + t_index)
+
+    return decomposition
+
+
+def build_normalization_records(ucd_directory, characters):
+    """Get list of normalization records, record index of every code point, decompositions and compositions."""
+    combining_classes = {}
+    raw_decompositions = {}
+    is_compatibility = {}
+
+    for code_point, fields in characters.items():
+        if fields[3] != '0':
+            combining_classes[code_point] = int(fields[3])
+
+        if fields[5]:
+            decomposition = fields[5].split()
+            is_compatibility[code_point] = decomposition[0].startswith('<')
+
+            if is_compatibility[code_point]:
+                decomposition = decomposition[1:]
+
+            raw_decompositions[code_point] = [int(code_point, 16) for code_point in decomposition]
+
+    def full_decomposition(code_point, is_compatibility_allowed):
+        if HANGUL_SYLLABLE_BASE <= code_point < HANGUL_SYLLABLE_BASE + HANGUL_SYLLABLES_COUNT:
+            return decompose_hangul_syllable(code_point)
+
+        if code_point not in raw_decompositions or (is_compatibility[code_point] and not is_compatibility_allowed):
+            return [code_point]
+
+        decomposition = []
+
+        for decomposed_code_point in raw_decompositions[code_point]:
+            decomposition.extend(full_decomposition(decomposed_code_point, is_compatibility_allowed))
+
+        return decomposition
+
+    normalization_properties_path = os.path.join(ucd_directory, 'DerivedNormalizationProps.txt')
+    composition_exclusions = read_property_ranges(normalization_properties_path, 'Full_Composition_Exclusion')
+
+    quick_check_flags = {}
+
+    for value, flag in (('NFD_QC; N', NORMALIZATION_NFD_NO), ('NFC_QC; N', NORMALIZATION_NFC_NO), ('NFC_QC; M', NORMALIZATION_NFC_MAYBE),
+                        ('NFKD_QC; N', NORMALIZATION_NFKD_NO), ('NFKC_QC; N', NORMALIZATION_NFKC_NO), ('NFKC_QC; M', NORMALIZATION_NFKC_MAYBE)):
+        for code_point in read_property_ranges(normalization_properties_path, value):
+            quick_check_flags[code_point] = quick_check_flags.get(code_point, 0) | flag
+
+    # Primary composites: canonical decompositions of two characters, that aren't excluded. Hangul is composed by code.
+    compositions = {}
+
+    for code_point, decomposition in raw_decompositions.items():
+        if not is_compatibility[code_point] and len(decomposition) == 2 and code_point not in composition_exclusions:
+            compositions.setdefault(decomposition[0], []).append((decomposition[1], code_point))
+
+    decompositions = [0]
+    decomposition_offsets = {}
+
+    def add_decomposition(decomposition):
+        key = tuple(decomposition)
+
+        if key not in decomposition_offsets:
+            decomposition_offsets[key] = len(decompositions)
+            decompositions.append(len(decomposition))
+            decompositions.extend(decomposition)
+
+        return decomposition_offsets[key]
+
+    composition_pairs = [0]
+    composition_offsets = {}
+
+    for first_code_point in sorted(compositions):
+        pairs = sorted(compositions[first_code_point])
+        composition_offsets[first_code_point] = len(composition_pairs)
+        composition_pairs.append(len(pairs))
+
+        for second_code_point, composite in pairs:
+            composition_pairs.extend((second_code_point, composite))
+
+    records = [(0, 0, 0, 0, 0)]
+    record_indices = {records[0]: 0}
+    character_records = [0] * (MAX_CODE_POINT + 1)
+
+    for code_point in range(MAX_CODE_POINT + 1):
+        canonical_offset = 0
+        compatibility_offset = 0
+
+        # Hangul syllables are decomposed by code.
+        if code_point in raw_decompositions:
+            canonical_decomposition = full_decomposition(code_point, False)
+            compatibility_decomposition = full_decomposition(code_point, True)
+
+            if canonical_decomposition != [code_point]:
+                canonical_offset = add_decomposition(canonical_decomposition)
+
+            if compatibility_decomposition != canonical_decomposition:
+                compatibility_offset = add_decomposition(compatibility_decomposition)
+            else:
+                compatibility_offset = canonical_offset
+
+        record = (
+            combining_classes.get(code_point, 0), quick_check_flags.get(code_point, 0),
+            canonical_offset, compatibility_offset, composition_offsets.get(code_point, 0)
+        )
+
+        if record not in record_indices:
+            record_indices[record] = len(records)
+            records.append(record)
+
+        character_records[code_point] = record_indices[record]
+
+    assert len(records) < 0x10000 and len(decompositions) < 0x10000 and len(composition_pairs) < 0x10000
+
+    # First code points, that can't be skipped by quick check of every form: they have combining class or aren't 'Yes'.
+    def quick_check_limit(flags):
+        return min(code_point for code_point in range(MAX_CODE_POINT + 1)
+                   if combining_classes.get(code_point, 0) != 0 or quick_check_flags.get(code_point, 0) & flags)
+
+    quick_check_limits = [
+        quick_check_limit(NORMALIZATION_NFC_NO | NORMALIZATION_NFC_MAYBE),
+        quick_check_limit(NORMALIZATION_NFD_NO),
+        quick_check_limit(NORMALIZATION_NFKC_NO | NORMALIZATION_NFKC_MAYBE),
+        quick_check_limit(NORMALIZATION_NFKD_NO),
+    ]
+
+    return records, character_records, decompositions, composition_pairs, quick_check_limits
+
+
+def build_break_properties(ucd_directory):
+    """Get packed grapheme, word and sentence break properties of every code point (see UAX #29)."""
+    auxiliary_directory = os.path.join(ucd_directory, 'auxiliary')
+
+    grapheme_breaks = read_property_ranges(os.path.join(auxiliary_directory, 'GraphemeBreakProperty.txt'))
+    word_breaks = read_property_ranges(os.path.join(auxiliary_directory, 'WordBreakProperty.txt'))
+    sentence_breaks = read_property_ranges(os.path.join(auxiliary_directory, 'SentenceBreakProperty.txt'))
+    extended_pictographic = read_property_ranges(os.path.join(ucd_directory, 'emoji', 'emoji-data.txt'), 'Extended_Pictographic')
+
+    properties = [0] * (MAX_CODE_POINT + 1)
+
+    for code_point in range(MAX_CODE_POINT + 1):
+        value = GRAPHEME_BREAK_VALUES.index(grapheme_breaks.get(code_point, 'Other'))
+        value |= WORD_BREAK_VALUES.index(word_breaks.get(code_point, 'Other')) << WORD_BREAK_SHIFT
+        value |= SENTENCE_BREAK_VALUES.index(sentence_breaks.get(code_point, 'Other')) << SENTENCE_BREAK_SHIFT
+
+        if code_point in extended_pictographic:
+            value |= BREAK_IS_EXTENDED_PICTOGRAPHIC
+
+        properties[code_point] = value
+
+    return properties
+
+
+def build_two_stage_table(values):
+    """Split values to blocks and store every unique block once.
+    First stage ends at the last block with non-zero values, characters after it have value 0."""
+    stage1 = []
+    stage2 = []
+    block_indices = {}
+
+    for block_start in range(0, MAX_CODE_POINT + 1, BLOCK_SIZE):
+        block = tuple(values[block_start:block_start + BLOCK_SIZE])
+
+        if block not in block_indices:
+            block_indices[block] = len(block_indices)
+            stage2.extend(block)
+
+        stage1.append(block_indices[block])
+
+    zero_block_index = block_indices.get((0,) * BLOCK_SIZE)
+
+    while stage1 and stage1[-1] == zero_block_index:
+        stage1.pop()
+
+    assert max(stage1) < 0x10000 and max(stage2) < 0x10000
+
+    return stage1, stage2
+
+
+def format_two_stage_table(name, values, comment):
+    stage1, stage2 = build_two_stage_table(values)
+
+    return '\n'.join([
+        '// ' + comment + ', ' + str(len(stage2) // BLOCK_SIZE) + ' unique blocks.',
+        '',
+        format_array('static const uint16_t ' + name + '_stage1[]', stage1),
+        '',
+        format_array('static const uint16_t ' + name + '_stage2[]', stage2),
+        '',
+        'const _EUnicodeTable ' + name + ' = { ' + name + '_stage1, ' + str(len(stage1)) + ', ' + name + '_stage2 };',
+    ])
+
+
+def format_array(declaration, values, format_value=str, per_line=16):
+    lines = [declaration + ' = {']
+
+    for index in range(0, len(values), per_line):
+        lines.append('  ' + ', '.join(format_value(value) for value in values[index:index + per_line]) + ',')
+
+    lines.append('};')
+
+    return '\n'.join(lines)
+
+
+def generate(ucd_directory):
+    version = read_unicode_version(ucd_directory)
+    characters = read_unicode_data(ucd_directory)
+
+    case_records, character_case_records, case_expansions = build_case_records(ucd_directory, characters)
+    normalization_records, character_normalization_records, decompositions, composition_pairs, quick_check_limits = \
+        build_normalization_records(ucd_directory, characters)
+    break_properties = build_break_properties(ucd_directory)
+
+    parts = [
+        '// Generated by \'tools/generate_unicode_data.py\' from Unicode Character Database ' + version + '. Do not edit.',
+        '// Included only by \'EString.cpp\', declarations are in \'EStringUnicode.h\'.',
+        '',
+        '#include "EStringUnicode.h"',
+        '',
+        'const char* const _unicode_version = "' + version + '";',
+        '',
+        format_two_stage_table('_unicode_case_table', character_case_records, 'Case mappings: ' + str(len(case_records)) + ' records'),
+        '',
+        format_array(
+            'const _EUnicodeCaseRecord _unicode_case_records[]', case_records,
+            lambda record: '{ ' + ', '.join(str(field) for field in record) + ' }', 4
+        ),
+        '',
+        format_array('const char32_t _unicode_case_expansions[]', case_expansions, lambda value: '0x%04X' % value, 12),
+        '',
+        format_two_stage_table(
+            '_unicode_normalization_table', character_normalization_records,
+            'Normalization properties: ' + str(len(normalization_records)) + ' records'
+        ),
+        '',
+        format_array(
+            'const _EUnicodeNormalizationRecord _unicode_normalization_records[]', normalization_records,
+            lambda record: '{ ' + ', '.join(str(field) for field in record) + ' }', 6
+        ),
+        '',
+        format_array('const char32_t _unicode_decompositions[]', decompositions, lambda value: '0x%04X' % value, 12),
+        '',
+        format_array('const char32_t _unicode_compositions[]', composition_pairs, lambda value: '0x%04X' % value, 12),
+        '',
+        format_array('const char32_t _unicode_quick_check_limits[]', quick_check_limits, lambda value: '0x%04X' % value),
+        '',
+        format_two_stage_table('_unicode_break_table', break_properties, 'Break properties: packed values'),
+        '',
+    ]
+
+    return '\n'.join(parts)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+
+    output_path = sys.argv[2] if len(sys.argv) > 2 else os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'EStringUnicodeData.inl')
+
+    with open(output_path, 'w', encoding='utf-8', newline='\r\n') as file:
+        file.write(generate(sys.argv[1]))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())